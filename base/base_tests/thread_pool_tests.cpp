@@ -128,3 +128,89 @@ UNIT_TEST(ThreadPool_EmptyTest)
   threads::Sleep(100);
   pool.Stop();
 }
+
+namespace
+{
+  class PriorityTestTask : public threads::IRoutine
+  {
+  public:
+    PriorityTestTask(int priority, std::mutex & mutex, std::vector<int> & order)
+      : m_priority(priority), m_mutex(mutex), m_order(order)
+    {
+    }
+
+    virtual void Do()
+    {
+      std::lock_guard lock(m_mutex);
+      m_order.push_back(m_priority);
+    }
+
+    int GetPriority() const { return m_priority; }
+
+  private:
+    int m_priority;
+    std::mutex & m_mutex;
+    std::vector<int> & m_order;
+  };
+
+  class BlockingTask : public threads::IRoutine
+  {
+  public:
+    explicit BlockingTask(Condition & cond) : m_cond(cond) {}
+
+    virtual void Do()
+    {
+      std::unique_lock lock(m_cond.m);
+      m_cond.cv.wait(lock, [this]() { return m_released; });
+    }
+
+    void Release()
+    {
+      {
+        std::lock_guard lock(m_cond.m);
+        m_released = true;
+      }
+      m_cond.cv.notify_all();
+    }
+
+  private:
+    Condition & m_cond;
+    bool m_released = false;
+  };
+}
+
+UNIT_TEST(ThreadPool_PriorityTest)
+{
+  std::mutex orderMutex;
+  std::vector<int> order;
+
+  int finishCounter = 0;
+  Condition cond;
+  Condition blockCond;
+  base::thread_pool::routine::ThreadPool pool(1, std::bind(&JoinFinishFunction, std::placeholders::_1,
+                                        std::ref(finishCounter), std::ref(cond)),
+                                        [](threads::IRoutine * l, threads::IRoutine * r)
+  {
+    auto const lp = dynamic_cast<PriorityTestTask *>(l);
+    auto const rp = dynamic_cast<PriorityTestTask *>(r);
+    return lp != nullptr && rp != nullptr && lp->GetPriority() < rp->GetPriority();
+  });
+
+  // Occupy the only thread while the prioritized tasks are being queued.
+  auto blockingTask = new BlockingTask(blockCond);
+  pool.PushBack(blockingTask);
+  for (int priority : {5, 3, 9, 1, 7})
+    pool.PushBack(new PriorityTestTask(priority, orderMutex, order));
+  blockingTask->Release();
+
+  while(true)
+  {
+    std::unique_lock lock(cond.m);
+    if (finishCounter == 6)
+      break;
+    cond.cv.wait(lock);
+  }
+
+  std::lock_guard lock(orderMutex);
+  TEST_EQUAL(order, std::vector<int>({1, 3, 5, 7, 9}), ());
+}
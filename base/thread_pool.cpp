@@ -51,7 +51,8 @@ private:
 class ThreadPool::Impl
 {
 public:
-  Impl(size_t size, const TFinishRoutineFn & finishFn) : m_finishFn(finishFn), m_threads(size)
+  Impl(size_t size, const TFinishRoutineFn & finishFn, const TLessRoutineFn & lessFn)
+    : m_finishFn(finishFn), m_lessFn(lessFn), m_threads(size)
   {
     ASSERT_GREATER(size, 0, ());
     for (auto & thread : m_threads)
@@ -80,6 +81,8 @@ public:
 
   threads::IRoutine * PopFront()
   {
+    if (m_lessFn)
+      return m_tasks.PopMin(m_lessFn);
     return m_tasks.Front(true);
   }
 
@@ -107,12 +110,14 @@ public:
 private:
   ThreadedList<threads::IRoutine *> m_tasks;
   TFinishRoutineFn m_finishFn;
+  TLessRoutineFn m_lessFn;
 
   std::vector<std::unique_ptr<threads::Thread>> m_threads;
 };
 
-ThreadPool::ThreadPool(size_t size, const TFinishRoutineFn & finishFn)
-  : m_impl(new Impl(size, finishFn)) {}
+ThreadPool::ThreadPool(size_t size, const TFinishRoutineFn & finishFn,
+                       const TLessRoutineFn & lessFn)
+  : m_impl(new Impl(size, finishFn, lessFn)) {}
 
 ThreadPool::~ThreadPool()
 {
@@ -16,11 +16,14 @@ namespace base::thread_pool
 namespace routine
 {
 typedef std::function<void(threads::IRoutine *)> TFinishRoutineFn;
+typedef std::function<bool(threads::IRoutine *, threads::IRoutine *)> TLessRoutineFn;
 
 class ThreadPool
 {
 public:
-  ThreadPool(size_t size, const TFinishRoutineFn & finishFn);
+  // If lessFn is set, the minimal queued routine is executed first instead of the FIFO order.
+  // lessFn is called under the queue lock, so it must be fast and must not lock the pool.
+  ThreadPool(size_t size, const TFinishRoutineFn & finishFn, const TLessRoutineFn & lessFn = {});
   ~ThreadPool();
 
   // ThreadPool will not delete routine. You can delete it in finish_routine_fn if need
@@ -2,6 +2,7 @@
 
 #include "base/threaded_container.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <list>
 
@@ -92,6 +93,25 @@ public:
     return res;
   }
 
+  /// Waits for the list to be non-empty and pops the minimal element according to |less|.
+  /// Equal elements are popped in the FIFO order.
+  template <typename Less>
+  T const PopMin(Less const & less)
+  {
+    std::unique_lock<std::mutex> lock(m_condLock);
+
+    if (WaitNonEmpty(lock))
+      return T();
+
+    auto const it = std::min_element(m_list.begin(), m_list.end(), less);
+    T res = *it;
+    m_list.erase(it);
+
+    m_isEmpty = m_list.empty();
+
+    return res;
+  }
+
   T const Back(bool doPop)
   {
     std::unique_lock<std::mutex> lock(m_condLock);
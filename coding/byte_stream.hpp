@@ -43,7 +43,11 @@ public:
   {
     // assume input buffer as buffer of bytes
     uint8_t const * pp = static_cast<uint8_t const *>(p);
-    m_Storage.insert(m_Storage.end(), pp, pp + size);
+    // Var ints are written byte by byte, range insert is much slower for a single byte.
+    if (size == 1)
+      m_Storage.push_back(*pp);
+    else
+      m_Storage.insert(m_Storage.end(), pp, pp + size);
   }
 
   size_t Pos() const
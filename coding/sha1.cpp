@@ -11,6 +11,7 @@
 #include "3party/liboauthcpp/src/base64.h"
 
 #include <algorithm>
+#include <limits>
 #include <vector>
 
 namespace coding
@@ -24,7 +25,7 @@ SHA1::Hash SHA1::Calculate(std::string const & filePath)
     base::FileData file(filePath, base::FileData::OP_READ);
     uint64_t const fileSize = file.Size();
 
-    CSHA1 sha1;
+    Streaming sha1;
     uint64_t currSize = 0;
     unsigned char buffer[kFileBufferSize];
     while (currSize < fileSize)
@@ -34,12 +35,7 @@ SHA1::Hash SHA1::Calculate(std::string const & filePath)
       sha1.Update(buffer, toRead);
       currSize += toRead;
     }
-    sha1.Final();
-
-    Hash result;
-    ASSERT_EQUAL(result.size(), ARRAY_SIZE(sha1.m_digest), ());
-    std::copy(std::begin(sha1.m_digest), std::end(sha1.m_digest), std::begin(result));
-    return result;
+    return sha1.Finalize();
   }
   catch (Reader::Exception const & ex)
   {
@@ -51,8 +47,7 @@ SHA1::Hash SHA1::Calculate(std::string const & filePath)
 // static
 std::string SHA1::CalculateBase64(std::string const & filePath)
 {
-  auto const sha1 = Calculate(filePath);
-  return base64_encode(sha1.data(), sha1.size());
+  return ToBase64(Calculate(filePath));
 }
 
 // static
@@ -84,7 +79,39 @@ std::string SHA1::CalculateForStringFormatted(std::string const & str)
 // static
 std::string SHA1::CalculateBase64ForString(std::string const & str)
 {
-  auto const sha1 = CalculateForString(str);
-  return base64_encode(sha1.data(), sha1.size());
+  return ToBase64(CalculateForString(str));
+}
+
+// static
+std::string SHA1::ToBase64(Hash const & hash)
+{
+  return base64_encode(hash.data(), hash.size());
+}
+
+SHA1::Streaming::Streaming() : m_impl(std::make_unique<CSHA1>()) {}
+
+SHA1::Streaming::~Streaming() = default;
+
+void SHA1::Streaming::Update(void const * data, size_t size)
+{
+  // CSHA1 takes non-const data but doesn't modify it.
+  auto * bytes = const_cast<unsigned char *>(static_cast<unsigned char const *>(data));
+  while (size > 0)
+  {
+    auto const part = static_cast<uint32_t>(std::min<size_t>(size, std::numeric_limits<uint32_t>::max()));
+    m_impl->Update(bytes, part);
+    bytes += part;
+    size -= part;
+  }
+}
+
+SHA1::Hash SHA1::Streaming::Finalize()
+{
+  m_impl->Final();
+
+  Hash result;
+  ASSERT_EQUAL(result.size(), ARRAY_SIZE(m_impl->m_digest), ());
+  std::copy(std::begin(m_impl->m_digest), std::end(m_impl->m_digest), std::begin(result));
+  return result;
 }
 }  // coding
@@ -1,9 +1,13 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 
+class CSHA1;
+
 namespace coding
 {
 class SHA1
@@ -19,5 +23,22 @@ public:
   // String representation of 40-number hex digit.
   static std::string CalculateForStringFormatted(std::string const & str);
   static std::string CalculateBase64ForString(std::string const & str);
+
+  static std::string ToBase64(Hash const & hash);
+
+  // Calculates the hash of data which comes in parts.
+  class Streaming
+  {
+  public:
+    Streaming();
+    ~Streaming();
+
+    void Update(void const * data, size_t size);
+    // No updates are allowed after this call.
+    Hash Finalize();
+
+  private:
+    std::unique_ptr<CSHA1> m_impl;
+  };
 };
 }  // coding
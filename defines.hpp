@@ -55,6 +55,7 @@
 #define CITY_ROADS_FILE_TAG "city_roads"
 #define DESCRIPTIONS_FILE_TAG "descriptions"
 #define MAXSPEEDS_FILE_TAG "maxspeeds"
+#define SPEED_PROFILES_FILE_TAG "speed_profiles"
 #define ROUTING_WORLD_FILE_TAG "routing_world"
 
 #define READY_FILE_EXTENSION ".ready"
@@ -6,6 +6,12 @@
 
 #include "platform/platform.hpp"
 
+#include "coding/internal/file_data.hpp"
+
+#include "base/logging.hpp"
+#include "base/scope_guard.hpp"
+#include "base/timer.hpp"
+
 #include <QtGui/QPainter>
 
 #include "qt_tstfrm/test_main_loop.hpp"
@@ -16,6 +22,7 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <vector>
 
 using namespace std::placeholders;
@@ -83,6 +90,41 @@ public:
 private:
   std::unique_ptr<dp::GlyphManager> m_mng;
 };
+
+dp::GlyphManager::Params GetGlyphsCacheParams(std::string const & cachePath)
+{
+  dp::GlyphManager::Params args;
+  args.m_uniBlocks = "unicode_blocks.txt";
+  args.m_whitelist = "fonts_whitelist.txt";
+  args.m_blacklist = "fonts_blacklist.txt";
+  args.m_glyphsCachePath = cachePath;
+  GetPlatform().GetFontNames(args.m_fonts);
+  return args;
+}
+
+// Generates glyphs of the label as the glyph generator does and returns time in milliseconds.
+double GenerateLabel(dp::GlyphManager & mng, strings::UniString const & text,
+                     std::vector<std::vector<uint8_t>> & images)
+{
+  images.clear();
+  base::Timer timer;
+  for (auto const c : text)
+  {
+    dp::GlyphManager::Glyph g = mng.GetGlyph(c, dp::GlyphManager::kDynamicGlyphSize);
+    dp::GlyphManager::Glyph generated = dp::GlyphManager::GenerateGlyph(g, mng.GetSdfScale());
+    g.m_image.Destroy();
+    mng.CacheGlyph(generated);
+
+    auto & image = images.emplace_back();
+    if (generated.m_image.m_data != nullptr)
+    {
+      auto const begin = generated.m_image.m_data->begin();
+      image.assign(begin, begin + generated.m_image.m_width * generated.m_image.m_height);
+    }
+    generated.m_image.Destroy();
+  }
+  return timer.ElapsedSeconds() * 1000.0;
+}
 }  // namespace
 
 UNIT_TEST(GlyphLoadingTest)
@@ -104,3 +146,28 @@ UNIT_TEST(GlyphLoadingTest)
   RunTestLoop("Test4", std::bind(&GlyphRenderer::RenderGlyphs, &renderer, _1));
 #endif
 }
+
+UNIT_TEST(GlyphsCache_TimeToFirstLabel)
+{
+  std::string const cachePath = GetPlatform().TmpPathForFile("glyphs_cache_test.bin");
+  base::DeleteFileX(cachePath);
+  SCOPE_GUARD(deleteCache, [&cachePath]() { base::DeleteFileX(cachePath); });
+
+  auto const text = strings::MakeUniString("Hauptbahnhof Санкт-Петербург Λεωφόρος Αλεξάνδρας");
+
+  std::vector<std::vector<uint8_t>> generatedImages;
+  double generationTime = 0.0;
+  {
+    dp::GlyphManager mng(GetGlyphsCacheParams(cachePath));
+    generationTime = GenerateLabel(mng, text, generatedImages);
+  }
+
+  // Glyphs are loaded from the cache of the previous session.
+  std::vector<std::vector<uint8_t>> cachedImages;
+  dp::GlyphManager mng(GetGlyphsCacheParams(cachePath));
+  double const cachedTime = GenerateLabel(mng, text, cachedImages);
+
+  TEST_EQUAL(generatedImages, cachedImages, ());
+  LOG(LINFO, ("Time to first label, generated glyphs:", generationTime, "ms, cached glyphs:",
+              cachedTime, "ms"));
+}
@@ -0,0 +1,192 @@
+#include "testing/testing.hpp"
+
+#include "drape/overlay_handle.hpp"
+#include "drape/overlay_tree.hpp"
+
+#include "geometry/any_rect2d.hpp"
+#include "geometry/screenbase.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace overlay_tree_tests
+{
+using Handles = std::vector<std::unique_ptr<dp::OverlayHandle>>;
+
+double constexpr kVisualScale = 2.0;
+uint8_t constexpr kZoomLevel = 17;
+
+ScreenBase MakeScreen()
+{
+  ScreenBase screen;
+  screen.OnSize(0, 0, 1080, 1920);
+  screen.SetFromRect(m2::AnyRectD(m2::RectD(0.0, 0.0, 0.01, 0.0178)));
+  return screen;
+}
+
+// Dense city scene: icons with the captions bound to them on the area larger than the screen.
+Handles MakeCityScene(ScreenBase const & screen, size_t poisCount)
+{
+  std::mt19937 rng(42);
+  m2::RectD rect = screen.ClipRect();
+  rect.Scale(2.0);
+  std::uniform_real_distribution<double> x(rect.minX(), rect.maxX());
+  std::uniform_real_distribution<double> y(rect.minY(), rect.maxY());
+  std::uniform_real_distribution<double> size(20.0, 60.0);
+  std::uniform_int_distribution<uint64_t> priority(0, dp::kPriorityMaskAll);
+
+  Handles handles;
+  for (size_t i = 0; i < poisCount; ++i)
+  {
+    dp::OverlayID const id(FeatureID(), i + 1, {-1, -1}, 0);
+    m2::PointD const pivot(x(rng), y(rng));
+    uint64_t const poiPriority = priority(rng);
+    double const iconSize = size(rng);
+
+    handles.push_back(std::make_unique<dp::SquareHandle>(
+        id, dp::Center, pivot, m2::PointD(iconSize, iconSize), m2::PointD::Zero(), poiPriority,
+        false /* isBound */, 0 /* minVisibleScale */, false /* isBillboard */));
+
+    auto caption = std::make_unique<dp::SquareHandle>(
+        id, dp::Top, pivot, m2::PointD(4.0 * size(rng), 0.5 * iconSize),
+        m2::PointD(0.0, iconSize / 2.0), poiPriority, true /* isBound */,
+        0 /* minVisibleScale */, false /* isBillboard */);
+    caption->SetOverlayRank(dp::OverlayRank1);
+    handles.push_back(std::move(caption));
+  }
+  return handles;
+}
+
+void Place(dp::OverlayTree & tree, ScreenBase const & screen, Handles const & handles)
+{
+  tree.InvalidateOnNextFrame();
+  TEST(tree.Frame(), ());
+  tree.StartOverlayPlacing(screen, kZoomLevel);
+  for (auto const & handle : handles)
+    tree.Add(make_ref(handle));
+  tree.EndOverlayPlacing();
+}
+
+std::vector<bool> GetDisplayFlags(Handles const & handles)
+{
+  std::vector<bool> flags;
+  flags.reserve(handles.size());
+  for (auto const & handle : handles)
+    flags.push_back(handle->GetDisplayFlag());
+  return flags;
+}
+
+void SetDisplayFlags(Handles const & handles, std::vector<bool> const & flags)
+{
+  for (size_t i = 0; i < handles.size(); ++i)
+    handles[i]->SetDisplayFlag(flags[i]);
+}
+
+void TestNoIntersections(ScreenBase const & screen, Handles const & handles)
+{
+  for (size_t i = 0; i < handles.size(); ++i)
+  {
+    if (!handles[i]->IsVisible())
+      continue;
+
+    for (size_t j = i + 1; j < handles.size(); ++j)
+    {
+      if (!handles[j]->IsVisible() || handles[i]->GetOverlayID() == handles[j]->GetOverlayID())
+        continue;
+      TEST(!handles[i]->IsIntersect(screen, make_ref(handles[j])), (i, j));
+    }
+  }
+}
+
+// Places |handles| on |screen| in |tree| and in |fullTree| with the incremental placement disabled
+// and checks that the results are the same. Display flags of the last placement affect the result,
+// so both placements start from the same flags.
+void PlaceAndCompare(dp::OverlayTree & tree, dp::OverlayTree & fullTree, ScreenBase const & screen,
+                     Handles const & handles)
+{
+  auto const lastFlags = GetDisplayFlags(handles);
+  Place(fullTree, screen, handles);
+  TEST(!fullTree.GetPlacementStatistic().m_isIncremental, ());
+  auto const fullFlags = GetDisplayFlags(handles);
+
+  SetDisplayFlags(handles, lastFlags);
+  Place(tree, screen, handles);
+  auto const flags = GetDisplayFlags(handles);
+
+  for (size_t i = 0; i < handles.size(); ++i)
+    TEST_EQUAL(flags[i], fullFlags[i], (i));
+}
+
+UNIT_TEST(OverlayTree_IncrementalPlacement)
+{
+  ScreenBase screen = MakeScreen();
+  auto const handles = MakeCityScene(screen, 500);
+
+  dp::OverlayTree tree(kVisualScale);
+  dp::OverlayTree fullTree(kVisualScale);
+  fullTree.SetIncrementalPlacementEnabled(false);
+  PlaceAndCompare(tree, fullTree, screen, handles);
+  TEST(!tree.GetPlacementStatistic().m_isIncremental, ());
+
+  // Handles with the changed display flags are placed again.
+  PlaceAndCompare(tree, fullTree, screen, handles);
+  auto const flags = GetDisplayFlags(handles);
+
+  // Nothing is changed.
+  PlaceAndCompare(tree, fullTree, screen, handles);
+  auto const & statistic = tree.GetPlacementStatistic();
+  TEST(statistic.m_isIncremental, ());
+  TEST_EQUAL(statistic.m_evaluatedCount, 0, ());
+  TEST_EQUAL(GetDisplayFlags(handles), flags, ());
+
+  for (int i = 0; i < 10; ++i)
+  {
+    screen.Move(15.0, 10.0);
+    PlaceAndCompare(tree, fullTree, screen, handles);
+    TEST(statistic.m_isIncremental, ());
+    TEST_LESS(statistic.m_evaluatedCount, statistic.m_handlesCount, ());
+    TestNoIntersections(screen, handles);
+  }
+
+  // Scaled screen is placed from scratch.
+  screen.Scale(0.8);
+  Place(tree, screen, handles);
+  TEST(!statistic.m_isIncremental, ());
+  TestNoIntersections(screen, handles);
+}
+
+// Compares the full and incremental placement times. The scene is kept small to not slow down
+// the unit tests, increase the counts for the real measurements.
+UNIT_TEST(OverlayTree_PlacementBenchmark)
+{
+  size_t constexpr kPoisCount = 500;
+  size_t constexpr kFramesCount = 10;
+
+  for (bool const isIncremental : {false, true})
+  {
+    ScreenBase screen = MakeScreen();
+    auto const handles = MakeCityScene(screen, kPoisCount);
+
+    dp::OverlayTree tree(kVisualScale);
+    tree.SetIncrementalPlacementEnabled(isIncremental);
+    Place(tree, screen, handles);
+
+    size_t evaluatedCount = 0;
+    base::Timer timer;
+    for (size_t i = 0; i < kFramesCount; ++i)
+    {
+      screen.Move(4.0, -3.0);
+      Place(tree, screen, handles);
+      evaluatedCount += tree.GetPlacementStatistic().m_evaluatedCount;
+    }
+
+    LOG(LINFO, ("Incremental:", isIncremental, "placement time:",
+                timer.ElapsedSeconds() * 1000.0 / kFramesCount, "ms, evaluated handles:",
+                evaluatedCount / kFramesCount, "of", tree.GetPlacementStatistic().m_handlesCount));
+  }
+}
+}  // namespace overlay_tree_tests
@@ -213,6 +213,9 @@ size_t GlyphIndex::GetPendingNodesCount()
 
 void GlyphIndex::OnCompleteGlyphGeneration(GlyphGenerator::GlyphGenerationDataArray && glyphs)
 {
+  for (auto const & g : glyphs)
+    m_mng->CacheGlyph(g.m_glyph);
+
   std::lock_guard<std::mutex> lock(m_mutex);
   for (auto & g : glyphs)
     m_pendingNodes.emplace_back(g.m_rect, g.m_glyph);
@@ -1,5 +1,6 @@
 #include "drape/glyph_generator.hpp"
 
+#include <algorithm>
 #include <iterator>
 
 namespace dp
@@ -76,18 +77,37 @@ void GlyphGenerator::GenerateGlyphs(ref_ptr<Listener> listener,
   std::swap(m_queue, queue);
   m_glyphsCounter += queue.size();
 
-  // Generate glyphs on the separate thread.
-  auto generateTask = std::make_shared<GenerateGlyphTask>(std::move(queue));
-  auto result = DrapeRoutine::Run([this, listener, generateTask]() mutable
+  // Generate glyphs on the separate threads. Big batches (e.g. the labels of a new language)
+  // are split, so SDF is generated in parallel and the first glyphs are uploaded earlier.
+  size_t constexpr kMaxGlyphsInTask = 16;
+  std::vector<GlyphGenerationDataArray> batches;
+  for (size_t i = 0; i < queue.size(); i += kMaxGlyphsInTask)
   {
-    generateTask->Run(m_sdfScale);
-    OnTaskFinished(listener, generateTask);
-  });
+    batches.emplace_back(queue.begin() + i,
+                         queue.begin() + std::min(i + kMaxGlyphsInTask, queue.size()));
+  }
+  queue.clear();
 
-  if (result)
-    m_activeTasks.Add(std::move(generateTask), std::move(result));
-  else
-    generateTask->DestroyAllGlyphs();
+  for (auto & batch : batches)
+  {
+    auto const glyphsCount = batch.size();
+    auto generateTask = std::make_shared<GenerateGlyphTask>(std::move(batch));
+    auto result = DrapeRoutine::Run([this, listener, generateTask]() mutable
+    {
+      generateTask->Run(m_sdfScale);
+      OnTaskFinished(listener, generateTask);
+    });
+
+    if (result)
+    {
+      m_activeTasks.Add(std::move(generateTask), std::move(result));
+    }
+    else
+    {
+      m_glyphsCounter -= glyphsCount;
+      generateTask->DestroyAllGlyphs();
+    }
+  }
 }
 
 void GlyphGenerator::OnTaskFinished(ref_ptr<Listener> listener,
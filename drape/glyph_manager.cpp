@@ -2,7 +2,13 @@
 
 #include "platform/platform.hpp"
 
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/read_write_utils.hpp"
 #include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
 
 #include "base/string_utils.hpp"
 #include "base/logging.hpp"
@@ -11,12 +17,16 @@
 
 #include "3party/sdf_image/sdf_image.h"
 
+#include <algorithm>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <ft2build.h>
 #include FT_TYPES_H
@@ -286,6 +296,7 @@ public:
   }
 
   std::string GetName() const { return std::string(m_fontFace->family_name) + ':' + m_fontFace->style_name; }
+  uint64_t GetFileSize() const { return m_fontReader.Size(); }
 
 private:
   ReaderPtr<Reader> m_fontReader;
@@ -342,6 +353,202 @@ struct UnicodeBlock
   }
 };
 
+// Persistent cache of the generated SDF glyphs. Generation of SDF is the most expensive part of
+// the text rendering, so the glyphs generated in the previous sessions are not generated again.
+// The cache is valid for the same fonts, base glyph height and SDF scale only.
+class SdfGlyphsCache
+{
+public:
+  SdfGlyphsCache(std::string const & path, std::string const & context)
+    : m_path(path), m_context(context)
+  {
+    Load();
+  }
+
+  ~SdfGlyphsCache()
+  {
+    if (m_unsavedGlyphsCount != 0)
+      Save();
+  }
+
+  bool GetGlyph(strings::UniChar code, int fontIndex, GlyphManager::Glyph & glyph) const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto const it = m_glyphs.find(code);
+    if (it == m_glyphs.end() || it->second.m_fontIndex != fontIndex)
+      return false;
+
+    auto const & cached = it->second;
+    auto data = SharedBufferManager::instance().reserveSharedBuffer(
+        base::NextPowOf2(cached.m_width * cached.m_height));
+    std::copy(cached.m_image.begin(), cached.m_image.end(), data->begin());
+
+    // Zero bitmap size means that the image is generated already.
+    glyph.m_image = GlyphManager::GlyphImage{cached.m_width, cached.m_height, 0, 0, data};
+    glyph.m_metrics = cached.m_metrics;
+    glyph.m_fontIndex = fontIndex;
+    glyph.m_code = code;
+    glyph.m_fixedSize = GlyphManager::kDynamicGlyphSize;
+    return true;
+  }
+
+  void AddGlyph(GlyphManager::Glyph const & glyph)
+  {
+    auto const size = glyph.m_image.m_width * glyph.m_image.m_height;
+    ASSERT_LESS_OR_EQUAL(size, glyph.m_image.m_data->size(), ());
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_glyphs.size() >= kMaxGlyphsCount || m_glyphs.count(glyph.m_code) != 0)
+        return;
+
+      auto & cached = m_glyphs[glyph.m_code];
+      cached.m_metrics = glyph.m_metrics;
+      cached.m_fontIndex = glyph.m_fontIndex;
+      cached.m_width = glyph.m_image.m_width;
+      cached.m_height = glyph.m_image.m_height;
+      cached.m_image.assign(glyph.m_image.m_data->begin(), glyph.m_image.m_data->begin() + size);
+
+      if (++m_unsavedGlyphsCount < kSaveThreshold)
+        return;
+    }
+
+    // The cache is saved periodically, because the application may be killed without teardown.
+    Save();
+  }
+
+private:
+  struct CachedGlyph
+  {
+    GlyphManager::GlyphMetrics m_metrics;
+    int m_fontIndex;
+    uint32_t m_width;
+    uint32_t m_height;
+    std::vector<uint8_t> m_image;
+  };
+
+  static uint32_t constexpr kVersion = 1;
+  static size_t constexpr kMaxGlyphsCount = 2048;
+  static size_t constexpr kSaveThreshold = 256;
+  static uint32_t constexpr kMaxGlyphSide = 512;
+
+  // The cache is local for the device, so floats are stored as is.
+  template <typename Sink>
+  static void WriteFloat(Sink & sink, float v)
+  {
+    sink.Write(&v, sizeof(v));
+  }
+
+  template <typename Source>
+  static float ReadFloat(Source & src)
+  {
+    float v;
+    src.Read(&v, sizeof(v));
+    return v;
+  }
+
+  void Load()
+  {
+    if (!Platform::IsFileExistsByFullPath(m_path))
+      return;
+
+    try
+    {
+      FileReader reader(m_path);
+      ReaderSource<FileReader> src(reader);
+      if (ReadPrimitiveFromSource<uint32_t>(src) != kVersion)
+        return;
+
+      std::string context;
+      rw::Read(src, context);
+      if (context != m_context)
+      {
+        LOG(LINFO, ("Glyphs cache is out of date"));
+        return;
+      }
+
+      auto const count = ReadPrimitiveFromSource<uint32_t>(src);
+      for (uint32_t i = 0; i < count && i < kMaxGlyphsCount; ++i)
+      {
+        auto const code = ReadPrimitiveFromSource<strings::UniChar>(src);
+        CachedGlyph cached;
+        cached.m_fontIndex = ReadPrimitiveFromSource<int32_t>(src);
+        cached.m_metrics.m_xAdvance = ReadFloat(src);
+        cached.m_metrics.m_yAdvance = ReadFloat(src);
+        cached.m_metrics.m_xOffset = ReadFloat(src);
+        cached.m_metrics.m_yOffset = ReadFloat(src);
+        cached.m_metrics.m_isValid = true;
+        cached.m_width = ReadPrimitiveFromSource<uint32_t>(src);
+        cached.m_height = ReadPrimitiveFromSource<uint32_t>(src);
+        if (cached.m_width > kMaxGlyphSide || cached.m_height > kMaxGlyphSide)
+          MYTHROW(Reader::ReadException, ("Invalid glyph size", cached.m_width, cached.m_height));
+        cached.m_image.resize(cached.m_width * cached.m_height);
+        src.Read(cached.m_image.data(), cached.m_image.size());
+        m_glyphs.emplace(code, std::move(cached));
+      }
+    }
+    catch (RootException const & e)
+    {
+      LOG(LWARNING, ("Can't read glyphs cache", m_path, e.Msg()));
+      m_glyphs.clear();
+      return;
+    }
+
+    LOG(LINFO, ("Loaded", m_glyphs.size(), "glyphs from the cache"));
+  }
+
+  void Save()
+  {
+    // Glyphs are serialized under the lock, the file is written without it.
+    std::vector<uint8_t> data;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      MemWriter<std::vector<uint8_t>> writer(data);
+      WriteToSink(writer, kVersion);
+      rw::Write(writer, m_context);
+      WriteToSink(writer, static_cast<uint32_t>(m_glyphs.size()));
+      for (auto const & [code, cached] : m_glyphs)
+      {
+        WriteToSink(writer, code);
+        WriteToSink(writer, static_cast<int32_t>(cached.m_fontIndex));
+        WriteFloat(writer, cached.m_metrics.m_xAdvance);
+        WriteFloat(writer, cached.m_metrics.m_yAdvance);
+        WriteFloat(writer, cached.m_metrics.m_xOffset);
+        WriteFloat(writer, cached.m_metrics.m_yOffset);
+        WriteToSink(writer, cached.m_width);
+        WriteToSink(writer, cached.m_height);
+        writer.Write(cached.m_image.data(), cached.m_image.size());
+      }
+      m_unsavedGlyphsCount = 0;
+    }
+
+    std::lock_guard<std::mutex> lock(m_saveMutex);
+    std::string const tmpPath = m_path + ".tmp";
+    try
+    {
+      FileWriter writer(tmpPath);
+      writer.Write(data.data(), data.size());
+    }
+    catch (RootException const & e)
+    {
+      LOG(LWARNING, ("Can't write glyphs cache", tmpPath, e.Msg()));
+      base::DeleteFileX(tmpPath);
+      return;
+    }
+
+    if (!base::RenameFileX(tmpPath, m_path))
+      base::DeleteFileX(tmpPath);
+  }
+
+  std::string const m_path;
+  std::string const m_context;
+
+  mutable std::mutex m_mutex;
+  std::unordered_map<strings::UniChar, CachedGlyph> m_glyphs;
+  size_t m_unsavedGlyphsCount = 0;
+
+  std::mutex m_saveMutex;
+};
+
 using TUniBlocks = std::vector<UnicodeBlock>;
 using TUniBlockIter = TUniBlocks::const_iterator;
 
@@ -356,6 +563,8 @@ struct GlyphManager::Impl
 
   uint32_t m_baseGlyphHeight;
   uint32_t m_sdfScale;
+
+  std::unique_ptr<SdfGlyphsCache> m_glyphsCache;
 };
 
 GlyphManager::GlyphManager(GlyphManager::Params const & params)
@@ -507,10 +716,21 @@ GlyphManager::GlyphManager(GlyphManager::Params const & params)
       LOG_SHORT(LDEBUG, (b.m_name, "is in", params.m_fonts[ind]));
     }
   }
+
+  if (!params.m_glyphsCachePath.empty())
+  {
+    std::ostringstream context;
+    context << m_impl->m_baseGlyphHeight << ' ' << m_impl->m_sdfScale;
+    for (auto const & f : m_impl->m_fonts)
+      context << ' ' << f->GetName() << ' ' << f->GetFileSize();
+    m_impl->m_glyphsCache = std::make_unique<SdfGlyphsCache>(params.m_glyphsCachePath, context.str());
+  }
 }
 
 GlyphManager::~GlyphManager()
 {
+  m_impl->m_glyphsCache.reset();
+
   for (auto const & f : m_impl->m_fonts)
     f->DestroyFont();
 
@@ -593,7 +813,14 @@ GlyphManager::Glyph GlyphManager::GetGlyph(strings::UniChar unicodePoint, int fi
 
   auto const & f = m_impl->m_fonts[fontIndex];
   bool const isSdf = fixedHeight < 0;
-  Glyph glyph = f->GetGlyph(unicodePoint, isSdf ? m_impl->m_baseGlyphHeight : fixedHeight, isSdf);
+  Glyph glyph;
+  if (isSdf && m_impl->m_glyphsCache != nullptr &&
+      m_impl->m_glyphsCache->GetGlyph(unicodePoint, fontIndex, glyph))
+  {
+    return glyph;
+  }
+
+  glyph = f->GetGlyph(unicodePoint, isSdf ? m_impl->m_baseGlyphHeight : fixedHeight, isSdf);
   glyph.m_fontIndex = fontIndex;
   return glyph;
 }
@@ -609,7 +836,8 @@ GlyphManager::Glyph GlyphManager::GenerateGlyph(Glyph const & glyph, uint32_t sd
     resultGlyph.m_code = glyph.m_code;
     resultGlyph.m_fixedSize = glyph.m_fixedSize;
 
-    if (glyph.m_fixedSize < 0)
+    // Glyphs from the persistent cache have no bitmap, they are generated already.
+    if (glyph.m_fixedSize < 0 && glyph.m_image.m_bitmapRows != 0)
     {
       sdf_image::SdfImage img(glyph.m_image.m_bitmapRows, glyph.m_image.m_bitmapPitch,
                               glyph.m_image.m_data->data(), sdfScale * kSdfBorder);
@@ -648,6 +876,17 @@ void GlyphManager::MarkGlyphReady(Glyph const & glyph)
   m_impl->m_fonts[glyph.m_fontIndex]->MarkGlyphReady(glyph.m_code, glyph.m_fixedSize);
 }
 
+void GlyphManager::CacheGlyph(Glyph const & glyph)
+{
+  if (m_impl->m_glyphsCache == nullptr || glyph.m_fixedSize >= 0 || !glyph.m_metrics.m_isValid ||
+      glyph.m_image.m_data == nullptr)
+  {
+    return;
+  }
+
+  m_impl->m_glyphsCache->AddGlyph(glyph);
+}
+
 bool GlyphManager::AreGlyphsReady(strings::UniString const & str, int fixedSize) const
 {
   for (auto const & code : str)
@@ -28,6 +28,9 @@ public:
 
     uint32_t m_baseGlyphHeight = 22;
     uint32_t m_sdfScale = 4;
+
+    // File of the persistent cache of the generated SDF glyphs, empty if the cache is disabled.
+    std::string m_glyphsCachePath;
   };
 
   struct GlyphMetrics
@@ -79,6 +82,8 @@ public:
   Glyph GetGlyph(strings::UniChar unicodePoints, int fixedHeight);
 
   void MarkGlyphReady(Glyph const & glyph);
+  // Stores the generated glyph to the persistent cache, it can be called from any thread.
+  void CacheGlyph(Glyph const & glyph);
   bool AreGlyphsReady(strings::UniString const & str, int fixedSize) const;
 
   Glyph GetInvalidGlyph(int fixedSize) const;
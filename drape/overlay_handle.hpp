@@ -17,6 +17,8 @@
 
 #include "base/buffer_vector.hpp"
 
+#include "std/boost_container_hash.hpp"
+
 #include <set>
 #include <string>
 #include <utility>
@@ -65,10 +67,18 @@ struct OverlayID
     return m_featureId.IsValid() || m_markId != kml::kInvalidMarkId;
   }
 
-  static OverlayID GetLowerKey(FeatureID const & featureID)
+  struct Hash
   {
-    return {featureID, 0, {-1, -1}, 0};
-  }
+    size_t operator()(OverlayID const & overlayId) const
+    {
+      size_t seed = std::hash<FeatureID>()(overlayId.m_featureId);
+      boost::hash_combine(seed, overlayId.m_markId);
+      boost::hash_combine(seed, overlayId.m_tileCoords.x);
+      boost::hash_combine(seed, overlayId.m_tileCoords.y);
+      boost::hash_combine(seed, overlayId.m_index);
+      return seed;
+    }
+  };
 
   auto AsTupleOfRefs() const
   {
@@ -3,7 +3,10 @@
 #include "drape/constants.hpp"
 #include "drape/debug_renderer.hpp"
 
+#include "base/math.hpp"
+
 #include <algorithm>
+#include <numeric>
 
 namespace dp
 {
@@ -81,6 +84,106 @@ public:
 private:
   bool m_enableMask;
 };
+
+struct OverlayIdPtrHash
+{
+  size_t operator()(OverlayID const * overlayId) const { return OverlayID::Hash()(*overlayId); }
+};
+
+struct OverlayIdPtrEqual
+{
+  bool operator()(OverlayID const * l, OverlayID const * r) const { return *l == *r; }
+};
+
+// Keys are the ids of the handles, so they are not copied.
+template <typename Value>
+using OverlayIdPtrMap = ska::flat_hash_map<OverlayID const *, Value, OverlayIdPtrHash, OverlayIdPtrEqual>;
+
+// Pixel rects are calculated from the global coordinates, so they are moved with an error.
+double constexpr kMovingEps = 1e-3;
+
+bool IsMovedBy(m2::RectD const & from, m2::RectD const & to, m2::PointD const & offset)
+{
+  return base::AlmostEqualAbs(from.minX() + offset.x, to.minX(), kMovingEps) &&
+         base::AlmostEqualAbs(from.minY() + offset.y, to.minY(), kMovingEps) &&
+         base::AlmostEqualAbs(from.maxX() + offset.x, to.maxX(), kMovingEps) &&
+         base::AlmostEqualAbs(from.maxY() + offset.y, to.maxY(), kMovingEps);
+}
+
+bool IsMovedBy(OverlayHandle::Rects const & from, OverlayHandle::Rects const & to,
+               m2::PointD const & offset)
+{
+  if (from.size() != to.size())
+    return false;
+
+  for (size_t i = 0; i < from.size(); ++i)
+  {
+    if (!IsMovedBy(m2::RectD(from[i]), m2::RectD(to[i]), offset))
+      return false;
+  }
+  return true;
+}
+
+// Uniform grid of the rects to find the intersecting ones. Rects out of the grid are
+// accounted in the border cells.
+class RectsGrid
+{
+public:
+  RectsGrid(m2::RectD const & gridRect, std::vector<m2::RectD> const & rects)
+    : m_gridRect(gridRect)
+    , m_cellSizeX(std::max(gridRect.SizeX() / kSize, 1.0))
+    , m_cellSizeY(std::max(gridRect.SizeY() / kSize, 1.0))
+    , m_offsets(kSize * kSize + 1, 0)
+  {
+    for (auto const & rect : rects)
+      ForEachCell(rect, [this](size_t cell) { ++m_offsets[cell + 1]; });
+    std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+
+    m_indices.resize(m_offsets.back());
+    std::vector<uint32_t> positions(m_offsets.begin(), m_offsets.end() - 1);
+    for (uint32_t i = 0; i < rects.size(); ++i)
+      ForEachCell(rects[i], [&](size_t cell) { m_indices[positions[cell]++] = i; });
+  }
+
+  // |toDo| may be called several times for the same rect.
+  template <typename ToDo>
+  void ForEachInRect(m2::RectD const & rect, ToDo && toDo) const
+  {
+    ForEachCell(rect, [&](size_t cell)
+    {
+      for (uint32_t i = m_offsets[cell]; i < m_offsets[cell + 1]; ++i)
+        toDo(m_indices[i]);
+    });
+  }
+
+private:
+  static uint32_t constexpr kSize = 32;
+
+  template <typename ToDo>
+  void ForEachCell(m2::RectD const & rect, ToDo && toDo) const
+  {
+    size_t const minX = GetCell(rect.minX() - m_gridRect.minX(), m_cellSizeX);
+    size_t const maxX = GetCell(rect.maxX() - m_gridRect.minX(), m_cellSizeX);
+    size_t const minY = GetCell(rect.minY() - m_gridRect.minY(), m_cellSizeY);
+    size_t const maxY = GetCell(rect.maxY() - m_gridRect.minY(), m_cellSizeY);
+    for (size_t y = minY; y <= maxY; ++y)
+    {
+      for (size_t x = minX; x <= maxX; ++x)
+        toDo(y * kSize + x);
+    }
+  }
+
+  static size_t GetCell(double coord, double cellSize)
+  {
+    return static_cast<size_t>(base::Clamp(coord / cellSize, 0.0, kSize - 1.0));
+  }
+
+  m2::RectD const m_gridRect;
+  double const m_cellSizeX;
+  double const m_cellSizeY;
+  std::vector<uint32_t> m_offsets;
+  std::vector<uint32_t> m_indices;
+};
 }  // namespace
 
 OverlayTree::OverlayTree(double visualScale)
@@ -96,6 +199,7 @@ OverlayTree::OverlayTree(double visualScale)
 void OverlayTree::SetVisualScale(double visualScale)
 {
   m_traits.SetVisualScale(visualScale);
+  ResetPlacementInfo();
   InvalidateOnNextFrame();
 }
 
@@ -108,6 +212,7 @@ void OverlayTree::Clear()
   for (auto & handles : m_handles)
     handles.clear();
   m_displacers.clear();
+  ResetPlacementInfo();
 }
 
 bool OverlayTree::Frame()
@@ -147,6 +252,13 @@ void OverlayTree::InvalidateOnNextFrame()
 void OverlayTree::StartOverlayPlacing(ScreenBase const & screen, uint8_t zoomLevel)
 {
   ASSERT(IsNeedUpdate(), ());
+  m_isIncrementalPlacement = CanPlaceIncrementally(screen, zoomLevel);
+  if (m_isIncrementalPlacement)
+  {
+    m2::PointD const & org = GetModelView().GetOrg();
+    m_placementOffset = screen.GtoP(org) - GetModelView().GtoP(org);
+  }
+
   TBase::Clear();
   m_handlesCache.clear();
   m_overlayIdCache.clear();
@@ -161,6 +273,8 @@ bool OverlayTree::Remove(ref_ptr<OverlayHandle> handle)
   {
     if (!IsEmpty())
       Clear();
+    else
+      ResetPlacementInfo();
     return true;
   }
 
@@ -169,6 +283,8 @@ bool OverlayTree::Remove(ref_ptr<OverlayHandle> handle)
     Clear();
     return true;
   }
+
+  m_placementInfos.erase(handle.get());
   return false;
 }
 
@@ -274,6 +390,7 @@ void OverlayTree::InsertHandle(ref_ptr<OverlayHandle> handle, int currentRank,
     // If input element "handle" has more priority than all "Intersected elements",
     // then we remove all "Intersected elements" and insert input element "handle".
     // But if some of already inserted elements have more priority, then we don't insert "handle".
+    bool isRejected = false;
     for (auto const & rivalHandle : rivals)
     {
       bool reject = m_selectedFeatureID.IsValid() && rivalHandle->GetOverlayID().m_featureId == m_selectedFeatureID;
@@ -296,18 +413,25 @@ void OverlayTree::InsertHandle(ref_ptr<OverlayHandle> handle, int currentRank,
         }
       }
 
+      // All the rivals which reject the handle are stored as the displacers, so the result doesn't
+      // depend on the order of the rivals in the tree.
       if (reject)
       {
-        // Handle is displaced and bound to its parent, parent will be displaced too.
-        if (boundToParent)
-        {
-          DeleteHandleWithParents(parentOverlay, currentRank - 1);
-          StoreDisplacementInfo(0 /* case index */, handle, parentOverlay);
-        }
         StoreDisplacementInfo(1 /* case index */, rivalHandle, handle);
-        return;
+        isRejected = true;
       }
     }
+
+    if (isRejected)
+    {
+      // Handle is displaced and bound to its parent, parent will be displaced too.
+      if (boundToParent)
+      {
+        DeleteHandleWithParents(parentOverlay, currentRank - 1);
+        StoreDisplacementInfo(0 /* case index */, handle, parentOverlay);
+      }
+      return;
+    }
   }
 
   // Current overlay displaces other overlay, delete them.
@@ -337,46 +461,66 @@ void OverlayTree::InsertHandle(ref_ptr<OverlayHandle> handle, int currentRank,
   m_handlesCache.insert(handle);
   m_overlayIdCache[handle->GetOverlayID()].push_back(handle);
   TBase::Add(handle, pixelRect);
+  if (m_isIncrementalPlacementEnabled)
+    m_insertedHandles.insert(handle);
 }
 
 void OverlayTree::EndOverlayPlacing()
 {
   ASSERT(IsNeedUpdate(), ());
 
-  m_displacers.clear();
-
 #ifdef DEBUG_OVERLAYS_OUTPUT
   LOG(LINFO, ("- BEGIN OVERLAYS PLACING"));
 #endif
 
-  HandleComparator comparator(false /* enableMask */);
+  ++m_placementIndex;
+  m_placementStatistic = {};
+  for (auto const & handles : m_handles)
+    m_placementStatistic.m_handlesCount += handles.size();
 
-  for (int rank = 0; rank < dp::OverlayRanksCount; rank++)
+  if (!m_isIncrementalPlacement || !PlaceIncrementally())
   {
-    std::sort(m_handles[rank].begin(), m_handles[rank].end(), comparator);
+    m_displacers.clear();
+
+    HandleComparator comparator(false /* enableMask */);
 
-    for (auto const & handle : m_handles[rank])
+    for (int rank = 0; rank < dp::OverlayRanksCount; rank++)
     {
-      ref_ptr<OverlayHandle> parentOverlay;
-      if (CheckHandle(handle, rank, parentOverlay))
-        InsertHandle(handle, rank, parentOverlay);
+      std::sort(m_handles[rank].begin(), m_handles[rank].end(), comparator);
+
+      for (auto const & handle : m_handles[rank])
+      {
+        ref_ptr<OverlayHandle> parentOverlay;
+        if (CheckHandle(handle, rank, parentOverlay))
+          InsertHandle(handle, rank, parentOverlay);
+      }
     }
+    m_placementStatistic.m_evaluatedCount = m_placementStatistic.m_handlesCount;
   }
 
-  for (int rank = 0; rank < dp::OverlayRanksCount; rank++)
+  // Rects of the handles are still cached and display flags are not changed here.
+  StorePlacementInfo();
+  m_insertedHandles.clear();
+  m_allDisplacers.clear();
+
+  for (auto const & handles : m_handles)
   {
-    for (auto const & handle : m_handles[rank])
+    for (auto const & handle : handles)
       handle->SetDisplayFlag(false);
-    m_handles[rank].clear();
   }
 
   for (auto const & handle : m_handlesCache)
   {
     handle->SetDisplayFlag(true);
     handle->SetIsVisible(true);
-    handle->EnableCaching(false);
   }
 
+  for (auto & handles : m_handles)
+    handles.clear();
+
+  for (auto const & handle : m_handlesCache)
+    handle->EnableCaching(false);
+
   m_frameCounter = 0;
 
 #ifdef DEBUG_OVERLAYS_OUTPUT
@@ -459,14 +603,10 @@ bool OverlayTree::GetSelectedFeatureRect(ScreenBase const & screen, m2::RectD &
     return false;
 
   auto resultRect = m2::RectD::GetEmptyRect();
-  for (auto it = m_overlayIdCache.lower_bound(OverlayID::GetLowerKey(m_selectedFeatureID));
-       it != m_overlayIdCache.end() && it->first.m_featureId == m_selectedFeatureID; ++it)
+  for (auto const & handle : m_handlesCache)
   {
-    for (auto const & handle : it->second)
-    {
-      if (handle->IsVisible())
-        resultRect.Add(handle->GetPixelRect(screen, screen.isPerspective()));
-    }
+    if (handle->IsVisible() && handle->GetOverlayID().m_featureId == m_selectedFeatureID)
+      resultRect.Add(handle->GetPixelRect(screen, screen.isPerspective()));
   }
 
   if (resultRect.IsValid())
@@ -524,11 +664,15 @@ void OverlayTree::SetDisplacementEnabled(bool enabled)
   if (m_isDisplacementEnabled == enabled)
     return;
   m_isDisplacementEnabled = enabled;
+  ResetPlacementInfo();
   InvalidateOnNextFrame();
 }
 
 void OverlayTree::SetSelectedFeature(FeatureID const & featureID)
 {
+  // Selected feature displaces any other, so the last placement can't be reused.
+  if (m_selectedFeatureID != featureID)
+    ResetPlacementInfo();
   m_selectedFeatureID = featureID;
 }
 
@@ -542,6 +686,12 @@ void OverlayTree::SetDebugRectRenderer(ref_ptr<DebugRenderer> debugRectRenderer)
   m_debugRectRenderer = debugRectRenderer;
 }
 
+void OverlayTree::SetIncrementalPlacementEnabled(bool enabled)
+{
+  m_isIncrementalPlacementEnabled = enabled;
+  ResetPlacementInfo();
+}
+
 void OverlayTree::StoreDisplacementInfo(int caseIndex, ref_ptr<OverlayHandle> displacerHandle,
                                         ref_ptr<OverlayHandle> displacedHandle)
 {
@@ -549,6 +699,8 @@ void OverlayTree::StoreDisplacementInfo(int caseIndex, ref_ptr<OverlayHandle> di
   m2::RectD const pixelRect = displacerHandle->GetExtendedPixelRect(modelView);
   if (!m_traits.GetDisplacersFreeRect().IsRectInside(pixelRect))
     m_displacers.insert(displacerHandle);
+  if (m_isIncrementalPlacementEnabled)
+    m_allDisplacers.insert(displacerHandle);
 
 #ifdef DEBUG_OVERLAYS_OUTPUT
     LOG(LINFO, ("Displace (", caseIndex, "):", displacerHandle->GetOverlayDebugInfo(),
@@ -570,6 +722,237 @@ bool OverlayTree::IsInCache(ref_ptr<OverlayHandle> const & handle) const
   return (m_handlesCache.find(handle) != m_handlesCache.end());
 }
 
+bool OverlayTree::CanPlaceIncrementally(ScreenBase const & screen, uint8_t zoomLevel) const
+{
+  if (!m_isIncrementalPlacementEnabled || !m_isDisplacementEnabled || m_placementInfos.empty() ||
+      zoomLevel != m_zoomLevel)
+  {
+    return false;
+  }
+
+  // Displacement info for the debug rendering is collected on the full placement.
+  if (m_debugRectRenderer && m_debugRectRenderer->IsEnabled())
+    return false;
+
+  // Handles keep the relative positions if the screen is only moved.
+  ScreenBase const & prevScreen = GetModelView();
+  return !screen.isPerspective() && !prevScreen.isPerspective() &&
+         screen.PixelRect() == prevScreen.PixelRect() &&
+         base::AlmostEqualRel(screen.GetScale(), prevScreen.GetScale(), 1e-9) &&
+         base::AlmostEqualAbs(screen.GetAngle(), prevScreen.GetAngle(), 1e-9);
+}
+
+// The handles which are not changed since the last placement and don't interact with the changed
+// ones keep their places. The others are placed as usual, so the result is the same as the one of
+// the full placement. A handle interacts only with the handles of the same OverlayID and the
+// intersected handles which are inserted to the tree, even if they are displaced later. The
+// inserted handles become displacers when they reject the intersected ones. So the
+// following handles are affected:
+// - new handles and handles with changed priority, rank, shape, display flag or OverlayID group;
+// - handles intersected with the ones which were inserted last time and are affected or removed;
+// - handles which were inserted last time and are intersected with the affected or removed ones,
+//   the last place of the affected handle is accounted too;
+// - handles with the same OverlayID as the affected ones.
+bool OverlayTree::PlaceIncrementally()
+{
+  ScreenBase const & modelView = GetModelView();
+
+  std::vector<ref_ptr<OverlayHandle>> handles;
+  handles.reserve(m_placementStatistic.m_handlesCount);
+  for (auto const & rankHandles : m_handles)
+    handles.insert(handles.end(), rankHandles.begin(), rankHandles.end());
+  auto const count = static_cast<uint32_t>(handles.size());
+
+  std::vector<m2::RectD> rects(count);
+  std::vector<PlacementInfo const *> infos(count, nullptr);
+  OverlayIdPtrMap<buffer_vector<uint32_t, 4>> overlayIds;
+  overlayIds.reserve(count);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    rects[i] = handles[i]->GetExtendedPixelRect(modelView);
+    overlayIds[&handles[i]->GetOverlayID()].push_back(i);
+
+    auto const it = m_placementInfos.find(handles[i].get());
+    if (it != m_placementInfos.end())
+    {
+      it->second.m_placementIndex = m_placementIndex;
+      infos[i] = &it->second;
+    }
+  }
+
+  RectsGrid const grid(m_traits.GetExtendedScreenRect(), rects);
+  std::vector<bool> affected(count, false);
+  std::vector<uint32_t> queue;
+
+  auto const markAffected = [&](uint32_t i)
+  {
+    if (!affected[i])
+    {
+      affected[i] = true;
+      queue.push_back(i);
+    }
+  };
+
+  auto const wasInserted = [&](uint32_t i) { return infos[i] != nullptr && infos[i]->m_isInserted; };
+
+  auto const markIntersected = [&](m2::RectD const & rect, bool insertedOnly)
+  {
+    grid.ForEachInRect(rect, [&](uint32_t i)
+    {
+      if (!affected[i] && (!insertedOnly || wasInserted(i)) && rects[i].IsIntersect(rect))
+        markAffected(i);
+    });
+  };
+
+  auto const getMovedRect = [this](PlacementInfo const & info)
+  {
+    m2::RectD rect = info.m_rect;
+    rect.Offset(m_placementOffset);
+    return rect;
+  };
+
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    auto const & handle = handles[i];
+    auto const * info = infos[i];
+    bool isChanged = info == nullptr || info->m_priority != handle->GetPriority() ||
+                     info->m_rank != handle->GetOverlayRank() ||
+                     info->m_isDisplayed != handle->GetDisplayFlag() ||
+                     info->m_overlayIdCount != overlayIds[&handle->GetOverlayID()].size() ||
+                     !IsMovedBy(info->m_rect, rects[i], m_placementOffset);
+    if (!isChanged && handle->HasLinearFeatureShape())
+      isChanged = !IsMovedBy(info->m_shape, handle->GetExtendedPixelShape(modelView), m_placementOffset);
+
+    if (isChanged)
+    {
+      markAffected(i);
+      // The handle releases its last place.
+      if (info != nullptr)
+        markIntersected(getMovedRect(*info), !info->m_isInserted /* insertedOnly */);
+    }
+  }
+
+  for (auto const & info : m_placementInfos)
+  {
+    if (info.second.m_placementIndex != m_placementIndex)
+      markIntersected(getMovedRect(info.second), !info.second.m_isInserted /* insertedOnly */);
+  }
+
+  // Full placement is cheaper if most of the handles are affected.
+  auto const maxAffectedCount = count / 2;
+  for (size_t k = 0; k < queue.size() && queue.size() <= maxAffectedCount; ++k)
+  {
+    uint32_t const i = queue[k];
+    auto const & handle = handles[i];
+    for (uint32_t const j : overlayIds[&handle->GetOverlayID()])
+      markAffected(j);
+
+    markIntersected(rects[i], !wasInserted(i) /* insertedOnly */);
+  }
+  if (queue.size() > maxAffectedCount)
+    return false;
+
+  m_displacers.clear();
+  m2::RectD const & displacersFreeRect = m_traits.GetDisplacersFreeRect();
+  std::array<std::vector<ref_ptr<OverlayHandle>>, dp::OverlayRanksCount> affectedHandles;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    auto const & handle = handles[i];
+    if (affected[i])
+    {
+      affectedHandles[handle->GetOverlayRank()].push_back(handle);
+      continue;
+    }
+
+    if (infos[i]->m_isDisplacer)
+    {
+      m_allDisplacers.insert(handle);
+      if (!displacersFreeRect.IsRectInside(rects[i]))
+        m_displacers.insert(handle);
+    }
+
+    if (infos[i]->m_isInserted)
+      m_insertedHandles.insert(handle);
+
+    if (infos[i]->m_isAccepted)
+    {
+      m_handlesCache.insert(handle);
+      m_overlayIdCache[handle->GetOverlayID()].push_back(handle);
+      TBase::Add(handle, rects[i]);
+    }
+  }
+
+  HandleComparator comparator(false /* enableMask */);
+  for (int rank = 0; rank < dp::OverlayRanksCount; rank++)
+  {
+    std::sort(affectedHandles[rank].begin(), affectedHandles[rank].end(), comparator);
+
+    for (auto const & handle : affectedHandles[rank])
+    {
+      ref_ptr<OverlayHandle> parentOverlay;
+      if (CheckHandle(handle, rank, parentOverlay))
+        InsertHandle(handle, rank, parentOverlay);
+    }
+  }
+
+  m_placementStatistic.m_isIncremental = true;
+  m_placementStatistic.m_evaluatedCount = queue.size();
+  return true;
+}
+
+void OverlayTree::StorePlacementInfo()
+{
+  ScreenBase const & modelView = GetModelView();
+  if (!m_isIncrementalPlacementEnabled || !m_isDisplacementEnabled || modelView.isPerspective())
+  {
+    ResetPlacementInfo();
+    return;
+  }
+
+  OverlayIdPtrMap<uint32_t> overlayIdCounts;
+  overlayIdCounts.reserve(m_placementStatistic.m_handlesCount);
+  for (auto const & handles : m_handles)
+  {
+    for (auto const & handle : handles)
+      ++overlayIdCounts[&handle->GetOverlayID()];
+  }
+
+  for (auto const & handles : m_handles)
+  {
+    for (auto const & handle : handles)
+    {
+      auto & info = m_placementInfos[handle.get()];
+      info.m_rect = handle->GetExtendedPixelRect(modelView);
+      if (handle->HasLinearFeatureShape())
+        info.m_shape = handle->GetExtendedPixelShape(modelView);
+      else
+        info.m_shape.clear();
+      info.m_priority = handle->GetPriority();
+      info.m_placementIndex = m_placementIndex;
+      info.m_overlayIdCount = overlayIdCounts[&handle->GetOverlayID()];
+      info.m_rank = handle->GetOverlayRank();
+      info.m_isDisplayed = handle->GetDisplayFlag();
+      info.m_isInserted = m_insertedHandles.find(handle) != m_insertedHandles.end();
+      info.m_isAccepted = IsInCache(handle);
+      info.m_isDisplacer = m_allDisplacers.find(handle) != m_allDisplacers.end();
+    }
+  }
+
+  // Forget the handles which were not placed.
+  for (auto it = m_placementInfos.begin(); it != m_placementInfos.end();)
+  {
+    if (it->second.m_placementIndex != m_placementIndex)
+      it = m_placementInfos.erase(it);
+    else
+      ++it;
+  }
+}
+
+void OverlayTree::ResetPlacementInfo()
+{
+  m_placementInfos.clear();
+}
+
 void detail::OverlayTraits::SetVisualScale(double visualScale)
 {
   m_visualScale = visualScale;
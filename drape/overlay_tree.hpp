@@ -8,6 +8,8 @@
 
 #include "base/buffer_vector.hpp"
 
+#include "3party/skarupke/flat_hash_map.hpp"
+
 #include <array>
 #include <memory>
 #include <unordered_set>
@@ -100,7 +102,39 @@ public:
 
   void SetDebugRectRenderer(ref_ptr<DebugRenderer> debugRectRenderer);
 
+  // If the screen is only moved since the last placement, the decisions are kept for the handles
+  // which are not affected by the changes, i.e. new, removed and moved relative to the map handles.
+  void SetIncrementalPlacementEnabled(bool enabled);
+
+  struct PlacementStatistic
+  {
+    bool m_isIncremental = false;
+    size_t m_handlesCount = 0;
+    // Handles which were compared with the rivals, all of them in case of full placement.
+    size_t m_evaluatedCount = 0;
+  };
+  PlacementStatistic const & GetPlacementStatistic() const { return m_placementStatistic; }
+
 private:
+  // Result of the last placement for the handle.
+  struct PlacementInfo
+  {
+    m2::RectD m_rect;
+    // Only for the handles with linear feature shape, shape of the others is moved with the rect.
+    OverlayHandle::Rects m_shape;
+    uint64_t m_priority = 0;
+    uint32_t m_placementIndex = 0;
+    uint32_t m_overlayIdCount = 0;
+    uint8_t m_rank = 0;
+    // Display flag before the placement, it is used to compare the handle with the rivals.
+    bool m_isDisplayed = false;
+    // The handle was inserted to the tree, it may be displaced later.
+    bool m_isInserted = false;
+    bool m_isAccepted = false;
+    // The handle displaced the others, wherever it is on the screen.
+    bool m_isDisplacer = false;
+  };
+
   ScreenBase const & GetModelView() const { return m_traits.GetModelView(); }
   void InsertHandle(ref_ptr<OverlayHandle> handle, int currentRank,
                     ref_ptr<OverlayHandle> const & parentOverlay);
@@ -117,17 +151,17 @@ private:
 
   bool IsInCache(ref_ptr<OverlayHandle> const & handle) const;
 
+  bool CanPlaceIncrementally(ScreenBase const & screen, uint8_t zoomLevel) const;
+  bool PlaceIncrementally();
+  void StorePlacementInfo();
+  void ResetPlacementInfo();
+
   int m_frameCounter;
   std::array<std::vector<ref_ptr<OverlayHandle>>, dp::OverlayRanksCount> m_handles;
 
   HandlesCache m_handlesCache;
-  /// @todo By VNG: Additional cache by OverlayID for fast FindParent(OverlayHandle).
-  /// I did profiling here in perspective-navigation mode.
-  /// The best solution is to store parent in OverlayHandle, but I didn't realize
-  /// how to implement it in a reasonable time, except "rewrite all".
-  /// Probably, another good solution is to combine m_handlesCache and m_overlayIdCache and make
-  /// one container like unordered_map<{FeatureID, kml::MarkId}, buffer_vector<OverlayHandle>>.
-  std::map<OverlayID, buffer_vector<ref_ptr<OverlayHandle>, 4>> m_overlayIdCache;
+  // Handles by OverlayID for fast FindParent(OverlayHandle).
+  ska::flat_hash_map<OverlayID, buffer_vector<ref_ptr<OverlayHandle>, 4>, OverlayID::Hash> m_overlayIdCache;
 
   bool m_isDisplacementEnabled;
 
@@ -139,5 +173,17 @@ private:
   HandlesCache m_displacers;
   uint32_t m_frameUpdatePeriod;
   uint8_t m_zoomLevel = 1;
+
+  bool m_isIncrementalPlacementEnabled = true;
+  bool m_isIncrementalPlacement = false;
+  // Offset of the pixel coordinates since the last placement.
+  m2::PointD m_placementOffset;
+  uint32_t m_placementIndex = 0;
+  // Handles are used as keys only, some of them may be destroyed since the last placement.
+  ska::flat_hash_map<OverlayHandle const *, PlacementInfo> m_placementInfos;
+  // Handles inserted to the tree and all the displacers of the current placement.
+  HandlesCache m_insertedHandles;
+  HandlesCache m_allDisplacers;
+  PlacementStatistic m_placementStatistic;
 };
 }  // namespace dp
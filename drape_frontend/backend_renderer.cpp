@@ -35,7 +35,8 @@ BackendRenderer::BackendRenderer(Params && params)
   , m_model(params.m_model)
   , m_readManager(make_unique_dp<ReadManager>(params.m_commutator, m_model,
                                               params.m_allow3dBuildings, params.m_trafficEnabled,
-                                              params.m_isolinesEnabled))
+                                              params.m_isolinesEnabled,
+                                              params.m_tileShapesCacheDir))
   , m_transitBuilder(make_unique_dp<TransitSchemeBuilder>(
         std::bind(&BackendRenderer::FlushTransitRenderData, this, _1)))
   , m_trafficGenerator(make_unique_dp<TrafficGenerator>(
@@ -45,6 +46,7 @@ BackendRenderer::BackendRenderer(Params && params)
   , m_requestedTiles(params.m_requestedTiles)
   , m_updateCurrentCountryFn(params.m_updateCurrentCountryFn)
   , m_metalineManager(make_unique_dp<MetalineManager>(params.m_commutator, m_model))
+  , m_glyphsCachePath(params.m_glyphsCachePath)
 {
 #ifdef DEBUG
   m_isTeardowned = false;
@@ -716,6 +718,7 @@ void BackendRenderer::InitContextDependentResources()
   params.m_glyphMngParams.m_blacklist = "fonts_blacklist.txt";
   params.m_glyphMngParams.m_sdfScale = VisualParams::Instance().GetGlyphSdfScale();
   params.m_glyphMngParams.m_baseGlyphHeight = VisualParams::Instance().GetGlyphBaseSize();
+  params.m_glyphMngParams.m_glyphsCachePath = m_glyphsCachePath;
   GetPlatform().GetFontNames(params.m_glyphMngParams.m_fonts);
 
   CHECK(m_context != nullptr, ());
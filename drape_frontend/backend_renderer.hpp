@@ -17,6 +17,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 
 namespace dp
 {
@@ -61,6 +62,8 @@ public:
     bool m_trafficEnabled;
     bool m_isolinesEnabled;
     bool m_simplifiedTrafficColors;
+    std::string m_tileShapesCacheDir;
+    std::string m_glyphsCachePath;
   };
 
   explicit BackendRenderer(Params && params);
@@ -129,6 +132,8 @@ private:
 
   gui::TWidgetsInitInfo m_lastWidgetsInfo;
 
+  std::string const m_glyphsCachePath;
+
 #ifdef DEBUG
   bool m_isTeardowned;
 #endif
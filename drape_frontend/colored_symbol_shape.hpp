@@ -21,6 +21,8 @@ public:
   MapShapeType GetType() const override { return MapShapeType::OverlayType; }
 
 private:
+  friend class TileShapesWriter;
+
   uint64_t GetOverlayPriority() const;
 
   m2::PointD const m_point;
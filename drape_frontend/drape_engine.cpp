@@ -104,6 +104,8 @@ DrapeEngine::DrapeEngine(Params && params)
                                    params.m_isolinesEnabled,
                                    params.m_simplifiedTrafficColors,
                                    params.m_onGraphicsContextInitialized);
+  brParams.m_tileShapesCacheDir = params.m_tileShapesCacheDir;
+  brParams.m_glyphsCachePath = params.m_glyphsCachePath;
 
   m_backend = make_unique_dp<BackendRenderer>(std::move(brParams));
   m_frontend = make_unique_dp<FrontendRenderer>(std::move(frParams));
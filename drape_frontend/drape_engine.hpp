@@ -32,6 +32,7 @@
 #include <atomic>
 #include <functional>
 #include <map>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -114,6 +115,10 @@ public:
     bool m_simplifiedTrafficColors;
     OverlaysShowStatsCallback m_overlaysShowStatsCallback;
     OnGraphicsContextInitialized m_onGraphicsContextInitialized;
+    // Directory of the persistent cache of the tiles shapes, empty if the cache is disabled.
+    std::string m_tileShapesCacheDir;
+    // File of the persistent cache of the generated glyphs, empty if the cache is disabled.
+    std::string m_glyphsCachePath;
   };
 
   DrapeEngine(Params && params);
@@ -0,0 +1,50 @@
+#include "testing/testing.hpp"
+
+#include "drape_frontend/drape_measurer.hpp"
+
+#include <chrono>
+
+using Histogram = df::DrapeMeasurer::Histogram;
+
+UNIT_TEST(DrapeMeasurer_HistogramEmpty)
+{
+  Histogram h;
+  TEST_EQUAL(h.GetCount(), 0, ());
+  TEST_EQUAL(h.GetPercentile(50.0), 0, ());
+  TEST_EQUAL(h.GetMax(), 0, ());
+  TEST_EQUAL(h.ToJSON(), R"({"count":0,"p50":0,"p90":0,"p99":0,"max":0})", ());
+}
+
+UNIT_TEST(DrapeMeasurer_HistogramPercentiles)
+{
+  Histogram h;
+  for (int i = 1; i <= 100; ++i)
+    h.Add(std::chrono::milliseconds(i));
+
+  TEST_EQUAL(h.GetCount(), 100, ());
+  TEST_EQUAL(h.GetPercentile(50.0), 50, ());
+  TEST_EQUAL(h.GetPercentile(90.0), 90, ());
+  TEST_EQUAL(h.GetPercentile(99.0), 99, ());
+  TEST_EQUAL(h.GetPercentile(100.0), 100, ());
+  TEST_EQUAL(h.GetMax(), 100, ());
+  TEST_EQUAL(h.ToJSON(), R"({"count":100,"p50":50,"p90":90,"p99":99,"max":100})", ());
+}
+
+UNIT_TEST(DrapeMeasurer_HistogramOverflowAndMerge)
+{
+  Histogram h1;
+  h1.Add(std::chrono::milliseconds(10));
+  h1.Add(std::chrono::seconds(5));
+
+  Histogram h2;
+  h2.Add(std::chrono::milliseconds(20));
+  h2.Add(std::chrono::milliseconds(30));
+
+  h1.Merge(h2);
+  TEST_EQUAL(h1.GetCount(), 4, ());
+  TEST_EQUAL(h1.GetPercentile(50.0), 20, ());
+  TEST_EQUAL(h1.GetPercentile(75.0), 30, ());
+  // Values above kMaxValueMs fall into the last bucket, but the exact maximum is kept.
+  TEST_EQUAL(h1.GetPercentile(100.0), Histogram::kMaxValueMs, ());
+  TEST_EQUAL(h1.GetMax(), 5000, ());
+}
@@ -0,0 +1,128 @@
+#include "testing/testing.hpp"
+
+#include "drape_frontend/rule_drawer.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace rule_drawer_tests
+{
+size_t constexpr kChunkSize = 256;
+
+// Styled feature as RuleDrawer keeps it until flush: the shapes are generated while styling,
+// the caption depends on the features flushed before (as the metalines deduplication does).
+struct StyledFeature
+{
+  uint32_t m_id = 0;
+  std::vector<uint32_t> m_shapes;
+  uint32_t m_metalineId = 0;
+};
+
+struct Output
+{
+  std::vector<uint32_t> m_shapes;
+  std::vector<uint32_t> m_captions;
+};
+
+StyledFeature Style(uint32_t id)
+{
+  StyledFeature f;
+  f.m_id = id;
+  for (uint32_t i = 0; i < id % 3 + 1; ++i)
+    f.m_shapes.push_back(id * 10 + i);
+  f.m_metalineId = id % 97;
+  return f;
+}
+
+class Flusher
+{
+public:
+  void Flush(std::vector<StyledFeature> & features)
+  {
+    for (auto const & f : features)
+    {
+      m_output.m_shapes.insert(m_output.m_shapes.end(), f.m_shapes.begin(), f.m_shapes.end());
+      if (m_usedMetalines.insert(f.m_metalineId).second)
+        m_output.m_captions.push_back(f.m_id);
+    }
+    features.clear();
+  }
+
+  Output const & GetOutput() const { return m_output; }
+
+private:
+  std::set<uint32_t> m_usedMetalines;
+  Output m_output;
+};
+
+Output StyleSequentially(size_t count)
+{
+  Flusher flusher;
+  for (uint32_t id = 0; id < count; ++id)
+  {
+    std::vector<StyledFeature> features = {Style(id)};
+    flusher.Flush(features);
+  }
+  return flusher.GetOutput();
+}
+
+Output StyleInParallel(size_t count, size_t threadsCount)
+{
+  base::thread_pool::computational::ThreadPool pool(threadsCount);
+  std::vector<std::vector<StyledFeature>> chunks((count + kChunkSize - 1) / kChunkSize);
+  Flusher flusher;
+  df::ProcessChunksInOrder(pool, count, kChunkSize, [&](size_t begin, size_t end, size_t index)
+  {
+    std::mt19937 rng(static_cast<uint32_t>(index));
+    // Chunks are finished in random order.
+    std::this_thread::sleep_for(std::chrono::microseconds(rng() % 2000));
+    for (size_t id = begin; id < end; ++id)
+      chunks[index].push_back(Style(static_cast<uint32_t>(id)));
+  }, [&](size_t index)
+  {
+    flusher.Flush(chunks[index]);
+    return true;
+  });
+  return flusher.GetOutput();
+}
+
+UNIT_TEST(RuleDrawer_ParallelChunksMatchSequential)
+{
+  for (size_t const count : {1, 255, 256, 257, 1000, 5000})
+  {
+    auto const expected = StyleSequentially(count);
+    for (size_t const threadsCount : {1, 2, 4, 8})
+    {
+      auto const output = StyleInParallel(count, threadsCount);
+      TEST_EQUAL(output.m_shapes, expected.m_shapes, (count, threadsCount));
+      TEST_EQUAL(output.m_captions, expected.m_captions, (count, threadsCount));
+    }
+  }
+}
+
+UNIT_TEST(RuleDrawer_ParallelChunksCancelled)
+{
+  size_t constexpr kCount = 10 * kChunkSize;
+  base::thread_pool::computational::ThreadPool pool(4);
+  std::vector<int> processed(kCount / kChunkSize, 0);
+  std::vector<size_t> flushed;
+  df::ProcessChunksInOrder(pool, kCount, kChunkSize, [&](size_t, size_t, size_t index)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ++processed[index];
+  }, [&](size_t index)
+  {
+    flushed.push_back(index);
+    return index < 2;
+  });
+
+  // Flushing is stopped, but all the submitted chunks are finished before return.
+  TEST_EQUAL(flushed, std::vector<size_t>({0, 1, 2}), ());
+  for (auto const p : processed)
+    TEST_EQUAL(p, 1, ());
+}
+}  // namespace rule_drawer_tests
@@ -0,0 +1,211 @@
+#include "testing/testing.hpp"
+
+#include "drape_frontend/area_shape.hpp"
+#include "drape_frontend/poi_symbol_shape.hpp"
+#include "drape_frontend/shape_view_params.hpp"
+#include "drape_frontend/tile_shapes_cache.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_reader.hpp"
+
+#include "base/file_name_utils.hpp"
+#include "base/string_utils.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tile_shapes_cache_tests
+{
+using namespace df;
+
+std::string const kContext = "clear|en|1.0";
+
+// Shapes which don't need the textures to be prepared.
+TMapShapes MakeShapes(TileKey const & tileKey, double shift)
+{
+  TMapShapes shapes;
+
+  AreaViewParams areaParams;
+  areaParams.m_depth = 1.0f;
+  areaParams.m_color = dp::Color(10, 20, 30, 255);
+  areaParams.m_tileCenter = m2::PointD(shift, shift);
+  std::vector<m2::PointD> triangles = {{shift, 0.0}, {shift + 1.0, 0.0}, {shift, 1.0}};
+  shapes.push_back(make_unique_dp<AreaShape>(std::move(triangles), BuildingOutline(), areaParams));
+
+  PoiSymbolViewParams poiParams;
+  poiParams.m_symbolName = "cafe-m";
+  poiParams.m_rank = 5;
+  poiParams.m_offset = m2::PointF(1.0f, 2.0f);
+  shapes.push_back(make_unique_dp<PoiSymbolShape>(m2::PointD(shift, shift), poiParams, tileKey,
+                                                  3 /* textIndex */));
+  return shapes;
+}
+
+TrafficSegmentsGeometry MakeTrafficGeometry()
+{
+  TrafficSegmentsGeometry geometry;
+  geometry[MwmSet::MwmId()].emplace_back(
+      traffic::TrafficInfo::RoadSegmentId(7 /* fid */, 1 /* idx */, 0 /* dir */),
+      TrafficSegmentGeometry(m2::PolylineD({{0.0, 0.0}, {1.0, 1.0}}), RoadClass::Class0));
+  return geometry;
+}
+
+class CacheTest
+{
+public:
+  CacheTest() : m_dir(base::JoinPath(GetPlatform().WritableDir(), "tile_shapes_cache_tests"))
+  {
+    Platform::RmDirRecursively(m_dir);
+  }
+
+  ~CacheTest() { Platform::RmDirRecursively(m_dir); }
+
+  std::string const & GetDir() const { return m_dir; }
+
+  std::string GetTilePath(TileKey const & tileKey) const
+  {
+    return base::JoinPath(m_dir, strings::to_string(tileKey.m_zoomLevel) + "_" +
+                                     strings::to_string(tileKey.m_x) + "_" +
+                                     strings::to_string(tileKey.m_y) + ".shapes");
+  }
+
+  std::string ReadTile(TileKey const & tileKey) const
+  {
+    std::string data;
+    FileReader(GetTilePath(tileKey)).ReadAsString(data);
+    return data;
+  }
+
+private:
+  std::string const m_dir;
+};
+
+std::vector<FeatureID> MakeFeatures(std::vector<uint32_t> const & indices)
+{
+  std::vector<FeatureID> features;
+  for (auto const index : indices)
+    features.emplace_back(MwmSet::MwmId(), index);
+  return features;
+}
+
+void Save(TileShapesCache & cache, TileKey const & tileKey, std::string const & context,
+          std::vector<FeatureID> const & features)
+{
+  TileShapesCache::Recorder recorder(features);
+  recorder.AddShapes(MakeShapes(tileKey, tileKey.m_x));
+  recorder.AddTrafficGeometry(MakeTrafficGeometry());
+  cache.Save(tileKey, context, features, recorder, cache.GetGeneration());
+}
+
+bool Load(TileShapesCache & cache, TileKey const & tileKey, std::string const & context,
+          std::vector<FeatureID> const & features)
+{
+  CachedTileShapes shapes;
+  return cache.Load(tileKey, context, features, nullptr /* texMng */, shapes);
+}
+
+UNIT_TEST(TileShapesCache_RoundTrip)
+{
+  CacheTest test;
+  TileShapesCache cache(test.GetDir(), 10 /* maxTilesCount */);
+  auto const features = MakeFeatures({1, 5, 6});
+  TileKey const tileKey(3, 4, 15);
+
+  TEST(!Load(cache, tileKey, kContext, features), ());
+  Save(cache, tileKey, kContext, features);
+
+  CachedTileShapes shapes;
+  TEST(cache.Load(tileKey, kContext, features, nullptr /* texMng */, shapes), ());
+  TEST_EQUAL(shapes.m_geometryShapes.size(), 1, ());
+  TEST_EQUAL(shapes.m_overlayShapes.size(), 1, ());
+  TEST(dynamic_cast<AreaShape const *>(shapes.m_geometryShapes[0].get()) != nullptr, ());
+  TEST(dynamic_cast<PoiSymbolShape const *>(shapes.m_overlayShapes[0].get()) != nullptr, ());
+
+  auto const & segments = shapes.m_trafficGeometry[MwmSet::MwmId()];
+  TEST_EQUAL(segments.size(), 1, ());
+  TEST_EQUAL(segments[0].first, traffic::TrafficInfo::RoadSegmentId(7, 1, 0), ());
+  TEST_EQUAL(segments[0].second.m_polyline.GetPoints(),
+             std::vector<m2::PointD>({{0.0, 0.0}, {1.0, 1.0}}), ());
+  TEST(segments[0].second.m_roadClass == RoadClass::Class0, ());
+
+  // Loaded shapes are recorded to the same bytes as the original ones.
+  TileKey const otherTileKey(30, 40, 15);
+  TileShapesCache::Recorder recorder(features);
+  recorder.AddShapes(shapes.m_geometryShapes);
+  recorder.AddShapes(shapes.m_overlayShapes);
+  recorder.AddTrafficGeometry(shapes.m_trafficGeometry);
+  cache.Save(otherTileKey, kContext, features, recorder, cache.GetGeneration());
+  TEST_EQUAL(test.ReadTile(otherTileKey), test.ReadTile(tileKey), ());
+
+  // Tiles are kept after restart.
+  TileShapesCache restarted(test.GetDir(), 10 /* maxTilesCount */);
+  TEST(Load(restarted, tileKey, kContext, features), ());
+  TEST(Load(restarted, otherTileKey, kContext, features), ());
+}
+
+UNIT_TEST(TileShapesCache_Eviction)
+{
+  CacheTest test;
+  TileShapesCache cache(test.GetDir(), 2 /* maxTilesCount */);
+  auto const features = MakeFeatures({1});
+  TileKey const a(1, 1, 10);
+  TileKey const b(2, 2, 10);
+  TileKey const c(3, 3, 10);
+
+  Save(cache, a, kContext, features);
+  Save(cache, b, kContext, features);
+  // |a| is used after |b|, so |b| is the least recently used one.
+  TEST(Load(cache, a, kContext, features), ());
+  Save(cache, c, kContext, features);
+
+  TEST(Load(cache, a, kContext, features), ());
+  TEST(!Load(cache, b, kContext, features), ());
+  TEST(!Platform::IsFileExistsByFullPath(test.GetTilePath(b)), ());
+  TEST(Load(cache, c, kContext, features), ());
+
+  // The limit is applied to the tiles found on start too.
+  TileShapesCache smaller(test.GetDir(), 1 /* maxTilesCount */);
+  Platform::FilesList files;
+  Platform::GetFilesByExt(test.GetDir(), ".shapes", files);
+  TEST_EQUAL(files.size(), 1, ());
+}
+
+UNIT_TEST(TileShapesCache_Invalidation)
+{
+  CacheTest test;
+  TileShapesCache cache(test.GetDir(), 10 /* maxTilesCount */);
+  auto const features = MakeFeatures({1, 2});
+  TileKey const tileKey(5, 6, 12);
+
+  Save(cache, tileKey, kContext, features);
+  TEST(Load(cache, tileKey, kContext, features), ());
+
+  // Another style or language.
+  TEST(!Load(cache, tileKey, "dark|en|1.0", features), ());
+  TEST(!Load(cache, tileKey, "clear|de|1.0", features), ());
+  // Features of the tile are changed.
+  TEST(!Load(cache, tileKey, kContext, MakeFeatures({1, 3})), ());
+  TEST(!Load(cache, tileKey, kContext, MakeFeatures({1})), ());
+
+  // Shapes generated before Clear() are not saved.
+  auto const generation = cache.GetGeneration();
+  cache.Clear();
+  TEST_NOT_EQUAL(cache.GetGeneration(), generation, ());
+  TEST(!Load(cache, tileKey, kContext, features), ());
+
+  TileKey const otherTileKey(7, 8, 12);
+  TileShapesCache::Recorder recorder(features);
+  recorder.AddShapes(MakeShapes(otherTileKey, 0.0));
+  cache.Save(otherTileKey, kContext, features, recorder, generation);
+  TEST(!Load(cache, otherTileKey, kContext, features), ());
+
+  // The generation is kept after restart.
+  Save(cache, tileKey, kContext, features);
+  TEST(Load(cache, tileKey, kContext, features), ());
+  TileShapesCache restarted(test.GetDir(), 10 /* maxTilesCount */);
+  TEST_EQUAL(restarted.GetGeneration(), cache.GetGeneration(), ());
+  TEST(Load(restarted, tileKey, kContext, features), ());
+}
+}  // namespace tile_shapes_cache_tests
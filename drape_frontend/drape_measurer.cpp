@@ -5,10 +5,80 @@
 #include "geometry/mercator.hpp"
 
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
+#include <sstream>
 
 namespace df
 {
+namespace
+{
+std::string EscapeJSONString(std::string const & str)
+{
+  std::ostringstream ss;
+  for (char const c : str)
+  {
+    if (c == '"' || c == '\\')
+      ss << '\\' << c;
+    else if (static_cast<unsigned char>(c) < 0x20)
+      ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+    else
+      ss << c;
+  }
+  return ss.str();
+}
+}  // namespace
+
+void DrapeMeasurer::Histogram::Add(std::chrono::nanoseconds const & value)
+{
+  auto const valueMs = static_cast<uint32_t>(std::max<int64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(value).count(), 0));
+  if (m_buckets.empty())
+    m_buckets.resize(kMaxValueMs + 1, 0);
+  ++m_buckets[std::min(valueMs, kMaxValueMs)];
+  ++m_count;
+  m_maxMs = std::max(m_maxMs, valueMs);
+}
+
+void DrapeMeasurer::Histogram::Merge(Histogram const & histogram)
+{
+  if (histogram.m_buckets.empty())
+    return;
+  if (m_buckets.empty())
+    m_buckets.resize(kMaxValueMs + 1, 0);
+  for (size_t i = 0; i < m_buckets.size(); ++i)
+    m_buckets[i] += histogram.m_buckets[i];
+  m_count += histogram.m_count;
+  m_maxMs = std::max(m_maxMs, histogram.m_maxMs);
+}
+
+uint32_t DrapeMeasurer::Histogram::GetPercentile(double percentile) const
+{
+  if (m_count == 0)
+    return 0;
+
+  auto const rank = std::max<uint64_t>(
+      static_cast<uint64_t>(std::ceil(percentile / 100.0 * m_count)), 1);
+  uint64_t accumulated = 0;
+  for (uint32_t i = 0; i < m_buckets.size(); ++i)
+  {
+    accumulated += m_buckets[i];
+    if (accumulated >= rank)
+      return std::min(i, m_maxMs);
+  }
+  return m_maxMs;
+}
+
+std::string DrapeMeasurer::Histogram::ToJSON() const
+{
+  std::ostringstream ss;
+  ss << "{\"count\":" << m_count << ",\"p50\":" << GetPercentile(50.0)
+     << ",\"p90\":" << GetPercentile(90.0) << ",\"p99\":" << GetPercentile(99.0)
+     << ",\"max\":" << GetMax() << "}";
+  return ss.str();
+}
+
 DrapeMeasurer & DrapeMeasurer::Instance()
 {
   static DrapeMeasurer s_inst;
@@ -28,6 +98,7 @@ void DrapeMeasurer::Start()
 #ifdef GENERATING_STATISTIC
   m_startScenePreparingTime = currentTime;
   m_maxScenePreparingTime = steady_clock::duration::zero();
+  m_scenePreparingTime = {};
 
   m_startShapesGenTime = currentTime;
   m_totalShapesGenTime = steady_clock::duration::zero();
@@ -61,6 +132,7 @@ void DrapeMeasurer::Start()
 
   m_totalFrameRenderTime = steady_clock::duration::zero();
   m_totalFramesCount = 0;
+  m_frameRenderTime = {};
 #endif
 
   m_startFrameRenderTime = currentTime;
@@ -127,8 +199,9 @@ void DrapeMeasurer::EndScenePreparing()
   if (!m_isEnabled)
     return;
 
-  m_maxScenePreparingTime = max(m_maxScenePreparingTime,
-                                std::chrono::steady_clock::now() - m_startScenePreparingTime);
+  auto const preparingTime = std::chrono::steady_clock::now() - m_startScenePreparingTime;
+  m_maxScenePreparingTime = max(m_maxScenePreparingTime, preparingTime);
+  m_scenePreparingTime.Add(preparingTime);
 }
 
 void DrapeMeasurer::StartShapesGeneration()
@@ -169,6 +242,16 @@ std::string DrapeMeasurer::GeneratingStatistic::ToString() const
   return ss.str();
 }
 
+std::string DrapeMeasurer::GeneratingStatistic::ToJSON() const
+{
+  std::ostringstream ss;
+  ss << "{\"scenePreparingTime\":" << m_scenePreparingTime.ToJSON()
+     << ",\"shapesCount\":" << m_shapesCount << ",\"shapesGenerationTime\":" << m_shapeGenTimeInMs
+     << ",\"overlayShapesCount\":" << m_overlayShapesCount
+     << ",\"overlayShapesGenerationTime\":" << m_overlayShapeGenTimeInMs << "}";
+  return ss.str();
+}
+
 DrapeMeasurer::GeneratingStatistic DrapeMeasurer::GetGeneratingStatistic()
 {
   using namespace std::chrono;
@@ -184,6 +267,7 @@ DrapeMeasurer::GeneratingStatistic DrapeMeasurer::GetGeneratingStatistic()
 
   statistic.m_maxScenePreparingTimeInMs =
       static_cast<uint32_t>(duration_cast<milliseconds>(m_maxScenePreparingTime).count());
+  statistic.m_scenePreparingTime = m_scenePreparingTime;
 
   return statistic;
 }
@@ -213,6 +297,16 @@ std::string DrapeMeasurer::RenderStatistic::ToString() const
   return ss.str();
 }
 
+std::string DrapeMeasurer::RenderStatistic::ToJSON() const
+{
+  std::ostringstream ss;
+  ss << "{\"fps\":" << m_FPS << ",\"minFps\":" << m_minFPS
+     << ",\"immediateRenderingFps\":" << m_immediateRenderingFPS
+     << ",\"immediateRenderingMinFps\":" << m_immediateRenderingMinFPS
+     << ",\"frameRenderTime\":" << m_frameRenderTime.ToJSON() << "}";
+  return ss.str();
+}
+
 DrapeMeasurer::RenderStatistic DrapeMeasurer::GetRenderStatistic()
 {
   using namespace std::chrono;
@@ -234,6 +328,7 @@ DrapeMeasurer::RenderStatistic DrapeMeasurer::GetRenderStatistic()
   }
 
   statistic.m_immediateRenderingMinFPS = m_immediateRenderingMinFps;
+  statistic.m_frameRenderTime = m_frameRenderTime;
   if (m_immediateRenderingFramesCount > 0)
   {
     auto const timeSumMs = duration_cast<milliseconds>(m_immediateRenderingTimeSum).count();
@@ -276,6 +371,10 @@ void DrapeMeasurer::AfterRenderFrame(bool isActiveFrame, m2::PointD const & view
     ++m_realtimeTotalFramesCount;
   }
 
+#ifdef RENDER_STATISTIC
+  m_frameRenderTime.Add(frameTime);
+#endif
+
 #if defined(RENDER_STATISTIC) || defined(TRACK_GPU_MEM)
   ++m_totalFramesCount;
   m_totalFrameRenderTime += frameTime;
@@ -341,11 +440,40 @@ std::string DrapeMeasurer::TileStatistic::ToString() const
   ss << " ----- Tiles read statistic report ----- \n";
   ss << " Tile read time, ms = " << m_tileReadTimeInMs << "\n";
   ss << " Tiles count = " << m_totalTilesCount << "\n";
+  ss << " Cancelled tiles count = " << m_cancelledTilesCount << "\n";
+  ss << " Cancelled tiles read time, ms = " << m_cancelledTilesReadTimeInMs << "\n";
+  ss << " Parallel styled tiles count = " << m_parallelTilesCount << "\n";
+  ss << " Parallel styling speedup = " << m_stylingSpeedup << "\n";
+  ss << " Shapes cache hits = " << m_shapesCacheHits << "\n";
+  ss << " Shapes cache misses = " << m_shapesCacheMisses << "\n";
   ss << " ----- Tiles read statistic report ----- \n";
 
   return ss.str();
 }
 
+std::string DrapeMeasurer::TileStatistic::ToJSON() const
+{
+  std::ostringstream ss;
+  ss << "{\"tilesCount\":" << m_totalTilesCount << ",\"tileReadTime\":" << m_tileReadTime.ToJSON()
+     << ",\"cancelledTilesCount\":" << m_cancelledTilesCount
+     << ",\"cancelledTilesReadTime\":" << m_cancelledTilesReadTimeInMs
+     << ",\"parallelTilesCount\":" << m_parallelTilesCount
+     << ",\"stylingSpeedup\":" << m_stylingSpeedup
+     << ",\"shapesCacheHits\":" << m_shapesCacheHits
+     << ",\"shapesCacheMisses\":" << m_shapesCacheMisses << "}";
+  return ss.str();
+}
+
+std::shared_ptr<DrapeMeasurer::TileReadInfo> DrapeMeasurer::GetCurrentTileReadInfo()
+{
+  threads::ThreadID tid = threads::GetCurrentThreadID();
+  std::lock_guard<std::mutex> lock(m_tilesMutex);
+  auto const it = m_tilesReadInfo.find(tid);
+  if (it != m_tilesReadInfo.end())
+    return it->second;
+  return nullptr;
+}
+
 void DrapeMeasurer::StartTileReading()
 {
   if (!m_isEnabled)
@@ -378,26 +506,68 @@ void DrapeMeasurer::EndTileReading()
 
   auto const currentTime = std::chrono::steady_clock::now();
 
-  threads::ThreadID tid = threads::GetCurrentThreadID();
-  std::shared_ptr<TileReadInfo> tileInfo;
-  {
-    std::lock_guard<std::mutex> lock(m_tilesMutex);
-    auto const it = m_tilesReadInfo.find(tid);
-    if (it != m_tilesReadInfo.end())
-      tileInfo = it->second;
-    else
-      return;
-  }
+  auto tileInfo = GetCurrentTileReadInfo();
+  if (tileInfo == nullptr)
+    return;
 
   auto passedTime = currentTime - tileInfo->m_startTileReadTime;
   tileInfo->m_totalTileReadTime += passedTime;
   ++tileInfo->m_totalTilesCount;
+  tileInfo->m_tileReadTime.Add(passedTime);
+}
+
+void DrapeMeasurer::CancelTileReading()
+{
+  if (!m_isEnabled)
+    return;
+
+  auto const currentTime = std::chrono::steady_clock::now();
+
+  auto tileInfo = GetCurrentTileReadInfo();
+  if (tileInfo == nullptr)
+    return;
+
+  auto passedTime = currentTime - tileInfo->m_startTileReadTime;
+  tileInfo->m_cancelledTilesReadTime += passedTime;
+  ++tileInfo->m_cancelledTilesCount;
+}
+
+void DrapeMeasurer::AddParallelTileStyling(std::chrono::nanoseconds stylingTime,
+                                           std::chrono::nanoseconds chunksTime)
+{
+  if (!m_isEnabled)
+    return;
+
+  auto tileInfo = GetCurrentTileReadInfo();
+  if (tileInfo == nullptr)
+    return;
+
+  ++tileInfo->m_parallelTilesCount;
+  tileInfo->m_parallelStylingTime += stylingTime;
+  tileInfo->m_chunksStylingTime += chunksTime;
+}
+
+void DrapeMeasurer::AddTileShapesCacheRequest(bool isHit)
+{
+  if (!m_isEnabled)
+    return;
+
+  auto tileInfo = GetCurrentTileReadInfo();
+  if (tileInfo == nullptr)
+    return;
+
+  if (isHit)
+    ++tileInfo->m_shapesCacheHits;
+  else
+    ++tileInfo->m_shapesCacheMisses;
 }
 
 DrapeMeasurer::TileStatistic DrapeMeasurer::GetTileStatistic()
 {
   using namespace std::chrono;
   TileStatistic statistic;
+  nanoseconds parallelStylingTime(0);
+  nanoseconds chunksStylingTime(0);
   {
     std::lock_guard<std::mutex> lock(m_tilesMutex);
     for (auto const & it : m_tilesReadInfo)
@@ -405,10 +575,24 @@ DrapeMeasurer::TileStatistic DrapeMeasurer::GetTileStatistic()
       statistic.m_tileReadTimeInMs +=
           static_cast<uint32_t>(duration_cast<milliseconds>(it.second->m_totalTileReadTime).count());
       statistic.m_totalTilesCount += it.second->m_totalTilesCount;
+      statistic.m_cancelledTilesReadTimeInMs +=
+          static_cast<uint32_t>(duration_cast<milliseconds>(it.second->m_cancelledTilesReadTime).count());
+      statistic.m_cancelledTilesCount += it.second->m_cancelledTilesCount;
+      statistic.m_tileReadTime.Merge(it.second->m_tileReadTime);
+      statistic.m_parallelTilesCount += it.second->m_parallelTilesCount;
+      parallelStylingTime += it.second->m_parallelStylingTime;
+      chunksStylingTime += it.second->m_chunksStylingTime;
+      statistic.m_shapesCacheHits += it.second->m_shapesCacheHits;
+      statistic.m_shapesCacheMisses += it.second->m_shapesCacheMisses;
     }
   }
   if (statistic.m_totalTilesCount > 0)
     statistic.m_tileReadTimeInMs /= statistic.m_totalTilesCount;
+  if (parallelStylingTime.count() > 0)
+  {
+    statistic.m_stylingSpeedup = static_cast<double>(chunksStylingTime.count()) /
+                                 parallelStylingTime.count();
+  }
 
   return statistic;
 }
@@ -517,9 +701,30 @@ std::string DrapeMeasurer::DrapeStatistic::ToString() const
   return ss.str();
 }
 
+std::string DrapeMeasurer::DrapeStatistic::ToJSON() const
+{
+  std::ostringstream ss;
+  ss << "{\"gpu\":\"" << EscapeJSONString(m_gpuName) << "\",\"api\":\"" << DebugPrint(m_apiVersion)
+     << "\",\"resolution\":[" << m_resolution.x << "," << m_resolution.y << "]";
+#ifdef RENDER_STATISTIC
+  ss << ",\"render\":" << m_renderStatistic.ToJSON();
+#endif
+#ifdef TILES_STATISTIC
+  ss << ",\"tiles\":" << m_tileStatistic.ToJSON();
+#endif
+#ifdef GENERATING_STATISTIC
+  ss << ",\"generating\":" << m_generatingStatistic.ToJSON();
+#endif
+  ss << "}";
+  return ss.str();
+}
+
 DrapeMeasurer::DrapeStatistic DrapeMeasurer::GetDrapeStatistic()
 {
   DrapeStatistic statistic;
+  statistic.m_gpuName = m_gpuName;
+  statistic.m_apiVersion = m_apiVersion;
+  statistic.m_resolution = m_resolution;
 #ifdef RENDER_STATISTIC
   statistic.m_renderStatistic = GetRenderStatistic();
 #endif
@@ -14,6 +14,7 @@
 #include <memory>
 #include <mutex>
 #include <numeric>
+#include <string>
 #include <vector>
 #include <unordered_map>
 #include <drape/drape_global.hpp>
@@ -32,10 +33,35 @@ public:
   void SetApiVersion(dp::ApiVersion apiVersion);
   void SetResolution(m2::PointU const & resolution);
 
+  // Distribution of a time metric with 1 ms resolution. Values longer than kMaxValueMs
+  // are accounted in the last bucket.
+  class Histogram
+  {
+  public:
+    static uint32_t constexpr kMaxValueMs = 2000;
+
+    void Add(std::chrono::nanoseconds const & value);
+    void Merge(Histogram const & histogram);
+
+    uint32_t GetCount() const { return m_count; }
+    // Returns the value in ms which is not exceeded by |percentile| percents of the values.
+    uint32_t GetPercentile(double percentile) const;
+    uint32_t GetMax() const { return m_maxMs; }
+
+    // Writes {"count":..,"p50":..,"p90":..,"p99":..,"max":..}, values are in ms.
+    std::string ToJSON() const;
+
+  private:
+    std::vector<uint32_t> m_buckets;
+    uint32_t m_count = 0;
+    uint32_t m_maxMs = 0;
+  };
+
 #ifdef RENDER_STATISTIC
   struct RenderStatistic
   {
     std::string ToString() const;
+    std::string ToJSON() const;
 
     uint32_t m_FPS = 0;
     uint32_t m_minFPS = 0;
@@ -43,6 +69,7 @@ public:
     std::map<uint32_t, float> m_fpsDistribution;
     uint32_t m_immediateRenderingFPS = 0;
     uint32_t m_immediateRenderingMinFPS = 0;
+    Histogram m_frameRenderTime;
   };
 
   RenderStatistic GetRenderStatistic();
@@ -52,13 +79,29 @@ public:
   struct TileStatistic
   {
     std::string ToString() const;
+    std::string ToJSON() const;
 
     uint32_t m_totalTilesCount = 0;
     uint32_t m_tileReadTimeInMs = 0;
+    uint32_t m_cancelledTilesCount = 0;
+    uint32_t m_cancelledTilesReadTimeInMs = 0;
+    Histogram m_tileReadTime;
+    uint32_t m_parallelTilesCount = 0;
+    // Ratio of the features styling time in the chunks to the time of parallel styling.
+    double m_stylingSpeedup = 0.0;
+    uint32_t m_shapesCacheHits = 0;
+    uint32_t m_shapesCacheMisses = 0;
   };
 
   void StartTileReading();
   void EndTileReading();
+  // Tile reading was interrupted because the tile is not needed anymore.
+  void CancelTileReading();
+  // Features of the tile were styled in parallel by chunks.
+  void AddParallelTileStyling(std::chrono::nanoseconds stylingTime,
+                              std::chrono::nanoseconds chunksTime);
+  // Shapes of the tile were looked up in the persistent cache.
+  void AddTileShapesCacheRequest(bool isHit);
 
   TileStatistic GetTileStatistic();
 #endif
@@ -67,6 +110,7 @@ public:
   struct GeneratingStatistic
   {
     std::string ToString() const;
+    std::string ToJSON() const;
 
     uint32_t m_maxScenePreparingTimeInMs = 0;
 
@@ -75,6 +119,8 @@ public:
 
     uint32_t m_overlayShapesCount = 0;
     uint32_t m_overlayShapeGenTimeInMs = 0;
+
+    Histogram m_scenePreparingTime;
   };
 
   void StartScenePreparing();
@@ -112,6 +158,12 @@ public:
   struct DrapeStatistic
   {
     std::string ToString() const;
+    // Single line JSON object with the enabled statistics.
+    std::string ToJSON() const;
+
+    std::string m_gpuName;
+    dp::ApiVersion m_apiVersion = dp::ApiVersion::Invalid;
+    m2::PointU m_resolution;
 
 #ifdef RENDER_STATISTIC
     RenderStatistic m_renderStatistic;
@@ -143,6 +195,7 @@ private:
 #ifdef GENERATING_STATISTIC
   std::chrono::time_point<std::chrono::steady_clock> m_startScenePreparingTime;
   std::chrono::nanoseconds m_maxScenePreparingTime;
+  Histogram m_scenePreparingTime;
 
   std::chrono::time_point<std::chrono::steady_clock> m_startShapesGenTime;
   std::chrono::nanoseconds m_totalShapesGenTime;
@@ -159,7 +212,16 @@ private:
     std::chrono::time_point<std::chrono::steady_clock> m_startTileReadTime;
     std::chrono::nanoseconds m_totalTileReadTime;
     uint32_t m_totalTilesCount = 0;
+    std::chrono::nanoseconds m_cancelledTilesReadTime;
+    uint32_t m_cancelledTilesCount = 0;
+    Histogram m_tileReadTime;
+    uint32_t m_parallelTilesCount = 0;
+    std::chrono::nanoseconds m_parallelStylingTime = std::chrono::nanoseconds::zero();
+    std::chrono::nanoseconds m_chunksStylingTime = std::chrono::nanoseconds::zero();
+    uint32_t m_shapesCacheHits = 0;
+    uint32_t m_shapesCacheMisses = 0;
   };
+  std::shared_ptr<TileReadInfo> GetCurrentTileReadInfo();
   std::map<threads::ThreadID, std::shared_ptr<TileReadInfo>> m_tilesReadInfo;
   std::mutex m_tilesMutex;
 #endif
@@ -184,6 +246,7 @@ private:
   double m_totalFPS = 0.0;
   uint32_t m_totalFPSCount = 0;
   std::unordered_map<uint32_t, uint32_t> m_fpsDistribution;
+  Histogram m_frameRenderTime;
 
   std::chrono::time_point<std::chrono::steady_clock> m_startImmediateRenderingTime;
   uint32_t m_immediateRenderingMinFps = std::numeric_limits<uint32_t>::max();
@@ -42,6 +42,8 @@ public:
             ref_ptr<dp::TextureManager> textures) const override;
 
 private:
+  friend class TileShapesWriter;
+
   glsl::vec2 ToShapeVertex2(m2::PointD const & vertex) const
   {
     return glsl::ToVec2(ConvertToLocal(vertex, m_params.m_tileCenter, kShapeCoordScalar));
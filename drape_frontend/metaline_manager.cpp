@@ -56,12 +56,27 @@ m2::SharedSpline MetalineManager::GetMetaline(FeatureID const & fid) const
   return metalineIt->second;
 }
 
+bool MetalineManager::AreMetalinesLoaded(std::set<MwmSet::MwmId> const & mwms) const
+{
+  std::lock_guard<std::mutex> lock(m_metalineCacheMutex);
+  for (auto const & mwm : mwms)
+  {
+    if (mwm.IsAlive() && mwm.GetInfo()->GetType() == MwmInfo::MwmTypeT::COUNTRY &&
+        m_loadedMwms.count(mwm) == 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 void MetalineManager::OnTaskFinished(std::shared_ptr<ReadMetalineTask> const & task)
 {
   if (task->IsCancelled())
     return;
 
   std::lock_guard<std::mutex> lock(m_metalineCacheMutex);
+  m_loadedMwms.insert(task->GetMwmId());
 
   if (task->UpdateCache(m_metalineCache))
   {
@@ -28,6 +28,9 @@ public:
 
   m2::SharedSpline GetMetaline(FeatureID const & fid) const;
 
+  // Returns true if the metalines of all the country mwms are read.
+  bool AreMetalinesLoaded(std::set<MwmSet::MwmId> const & mwms) const;
+
 private:
   void OnTaskFinished(std::shared_ptr<ReadMetalineTask> const & task);
 
@@ -37,6 +40,7 @@ private:
   dp::ActiveTasks<ReadMetalineTask> m_activeTasks;
 
   MetalineCache m_metalineCache;
+  std::set<MwmSet::MwmId> m_loadedMwms;
   mutable std::mutex m_metalineCacheMutex;
 
   std::set<MwmSet::MwmId> m_mwms;
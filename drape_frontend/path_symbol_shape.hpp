@@ -15,6 +15,8 @@ public:
             ref_ptr<dp::TextureManager> textures) const override;
 
 private:
+  friend class TileShapesWriter;
+
   PathSymbolViewParams m_params;
   m2::SharedSpline m_spline;
 };
@@ -31,6 +31,8 @@ public:
   MapShapeType GetType() const override { return MapShapeType::OverlayType; }
 
 private:
+  friend class TileShapesWriter;
+
   uint64_t GetOverlayPriority(uint32_t textIndex, size_t textLength) const;
 
   void DrawPathTextPlain(ref_ptr<dp::GraphicsContext> context,
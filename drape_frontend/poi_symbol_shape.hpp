@@ -23,6 +23,8 @@ public:
   MapShapeType GetType() const override { return MapShapeType::OverlayType; }
 
 private:
+  friend class TileShapesWriter;
+
   uint64_t GetOverlayPriority() const;
   drape_ptr<dp::OverlayHandle> CreateOverlayHandle(m2::RectD const & pixelRect) const;
 
@@ -7,7 +7,9 @@
 #include "base/stl_helpers.hpp"
 
 #include <algorithm>
+#include <cstdlib>
 #include <functional>
+#include <thread>
 
 namespace df
 {
@@ -33,6 +35,29 @@ struct LessCoverageCell
     return l->GetTileKey() < r->GetTileKey();
   }
 };
+
+// About 100 MB of the cached shapes for the dense tiles.
+size_t constexpr kMaxCachedTilesCount = 2000;
+
+// Tiles of another zoom level are read after all tiles of the current one.
+double constexpr kZoomLevelPriorityStep = 1000.0;
+
+// Lower value means more urgent tile. Tiles of the current zoom level are read in order of
+// the distance (in tiles) from the viewport centre.
+double CalculateTilePriority(TileKey const & tileKey, ScreenBase const & screen)
+{
+  int const zoomDiff = std::abs(static_cast<int>(tileKey.m_zoomLevel) - df::GetDrawTileScale(screen));
+  m2::RectD const rect = tileKey.GetGlobalRect(false /* clipByDataMaxZoom */);
+  ASSERT_GREATER(rect.SizeX(), 0.0, ());
+  return zoomDiff * kZoomLevelPriorityStep + rect.Center().Length(screen.GetOrg()) / rect.SizeX();
+}
+
+bool LessByTaskPriority(threads::IRoutine * l, threads::IRoutine * r)
+{
+  ASSERT(dynamic_cast<ReadMWMTask *>(l) != nullptr, ());
+  ASSERT(dynamic_cast<ReadMWMTask *>(r) != nullptr, ());
+  return static_cast<ReadMWMTask *>(l)->GetPriority() < static_cast<ReadMWMTask *>(r)->GetPriority();
+}
 }  // namespace
 
 bool ReadManager::LessByTileInfo::operator()(std::shared_ptr<TileInfo> const & l,
@@ -42,7 +67,8 @@ bool ReadManager::LessByTileInfo::operator()(std::shared_ptr<TileInfo> const & l
 }
 
 ReadManager::ReadManager(ref_ptr<ThreadsCommutator> commutator, MapDataProvider & model,
-                         bool allow3dBuildings, bool trafficEnabled, bool isolinesEnabled)
+                         bool allow3dBuildings, bool trafficEnabled, bool isolinesEnabled,
+                         std::string const & tileShapesCacheDir)
   : m_commutator(commutator)
   , m_model(model)
   , m_have3dBuildings(false)
@@ -55,6 +81,9 @@ ReadManager::ReadManager(ref_ptr<ThreadsCommutator> commutator, MapDataProvider
   , m_generationCounter(0)
   , m_userMarksGenerationCounter(0)
 {
+  if (!tileShapesCacheDir.empty())
+    m_shapesCache = make_unique_dp<TileShapesCache>(tileShapesCacheDir, kMaxCachedTilesCount);
+
   Start();
 }
 
@@ -66,7 +95,13 @@ void ReadManager::Start()
   ASSERT_EQUAL(m_counter, 0, ());
 
   m_pool = make_unique_dp<base::thread_pool::routine::ThreadPool>(kReadingThreadsCount,
-                              std::bind(&ReadManager::OnTaskFinished, this, std::placeholders::_1));
+                              std::bind(&ReadManager::OnTaskFinished, this, std::placeholders::_1),
+                              &LessByTaskPriority);
+
+  // Reading threads wait for the styling of their tiles, so one core is left for rendering only.
+  unsigned const coresCount = std::thread::hardware_concurrency();
+  if (coresCount > kReadingThreadsCount)
+    m_stylingPool = make_unique_dp<RuleDrawer::StylingPool>(coresCount - 1);
 }
 
 void ReadManager::Stop()
@@ -75,6 +110,8 @@ void ReadManager::Stop()
   if (m_pool != nullptr)
     m_pool->Stop();
   m_pool.reset();
+  // Styling tasks are finished by the reading threads.
+  m_stylingPool.reset();
 }
 
 void ReadManager::Restart()
@@ -146,7 +183,7 @@ void ReadManager::UpdateCoverage(ScreenBase const & screen, bool have3dBuildings
     ++m_userMarksGenerationCounter;
 
     for (auto const & tileKey : tiles)
-      PushTaskBackForTileKey(tileKey, texMng, metalineMng);
+      PushTaskBackForTileKey(tileKey, screen, texMng, metalineMng);
   }
   else
   {
@@ -177,8 +214,11 @@ void ReadManager::UpdateCoverage(ScreenBase const & screen, bool have3dBuildings
       ++m_userMarksGenerationCounter;
     CheckFinishedTiles(readyTiles, forceUpdateUserMarks);
 
+    // Tiles which are still being read should be ordered according to the new viewport.
+    UpdateTilesPriorities(screen);
+
     for (auto const & tileKey : newTiles)
-      PushTaskBackForTileKey(tileKey, texMng, metalineMng);
+      PushTaskBackForTileKey(tileKey, screen, texMng, metalineMng);
   }
 
   m_currentViewport = screen;
@@ -186,6 +226,11 @@ void ReadManager::UpdateCoverage(ScreenBase const & screen, bool have3dBuildings
 
 void ReadManager::Invalidate(TTilesCollection const & keyStorage)
 {
+  // Tiles are invalidated when the features are changed, e.g. edited or downloaded,
+  // it's not known which of the cached tiles contain them.
+  if (m_shapesCache != nullptr)
+    m_shapesCache->Clear();
+
   TTileSet tilesToErase;
   for (auto const & info : m_tileInfos)
   {
@@ -226,7 +271,13 @@ bool ReadManager::MustDropAllTiles(ScreenBase const & screen) const
   return (oldScale != newScale) || !m_currentViewport.GlobalRect().IsIntersect(screen.GlobalRect());
 }
 
-void ReadManager::PushTaskBackForTileKey(TileKey const & tileKey,
+void ReadManager::UpdateTilesPriorities(ScreenBase const & screen)
+{
+  for (auto const & info : m_tileInfos)
+    info->SetPriority(CalculateTilePriority(info->GetTileKey(), screen));
+}
+
+void ReadManager::PushTaskBackForTileKey(TileKey const & tileKey, ScreenBase const & screen,
                                          ref_ptr<dp::TextureManager> texMng,
                                          ref_ptr<MetalineManager> metalineMng)
 {
@@ -237,7 +288,10 @@ void ReadManager::PushTaskBackForTileKey(TileKey const & tileKey,
                                                m_customFeaturesContext,
                                                m_have3dBuildings && m_allow3dBuildings,
                                                m_trafficEnabled, m_isolinesEnabled);
-  std::shared_ptr<TileInfo> tileInfo = std::make_shared<TileInfo>(std::move(context));
+  std::shared_ptr<TileInfo> tileInfo =
+      std::make_shared<TileInfo>(std::move(context), make_ref(m_stylingPool),
+                                 make_ref(m_shapesCache));
+  tileInfo->SetPriority(CalculateTilePriority(tileKey, screen));
   m_tileInfos.insert(tileInfo);
 
   /// @todo Do we really need ReadMWMTask pool? Avoid "new" with hand-written bicycle? ;)
@@ -2,7 +2,9 @@
 
 #include "drape_frontend/engine_context.hpp"
 #include "drape_frontend/read_mwm_task.hpp"
+#include "drape_frontend/rule_drawer.hpp"
 #include "drape_frontend/tile_info.hpp"
+#include "drape_frontend/tile_shapes_cache.hpp"
 #include "drape_frontend/tile_utils.hpp"
 
 #include "geometry/screenbase.hpp"
@@ -15,6 +17,7 @@
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
 #include <vector>
 
 namespace dp
@@ -32,8 +35,11 @@ uint8_t constexpr kReadingThreadsCount = 2;
 class ReadManager
 {
 public:
+  /// @param tileShapesCacheDir - directory of the persistent cache of the tiles shapes,
+  /// the cache is disabled if it's empty.
   ReadManager(ref_ptr<ThreadsCommutator> commutator, MapDataProvider & model,
-              bool allow3dBuildings, bool trafficEnabled, bool isolinesEnabled);
+              bool allow3dBuildings, bool trafficEnabled, bool isolinesEnabled,
+              std::string const & tileShapesCacheDir);
 
   void Start();
   void Stop();
@@ -67,14 +73,18 @@ private:
   void OnTaskFinished(threads::IRoutine * task);
   bool MustDropAllTiles(ScreenBase const & screen) const;
 
-  void PushTaskBackForTileKey(TileKey const & tileKey, ref_ptr<dp::TextureManager> texMng,
+  void PushTaskBackForTileKey(TileKey const & tileKey, ScreenBase const & screen,
+                              ref_ptr<dp::TextureManager> texMng,
                               ref_ptr<MetalineManager> metalineMng);
+  void UpdateTilesPriorities(ScreenBase const & screen);
 
   ref_ptr<ThreadsCommutator> m_commutator;
 
   MapDataProvider & m_model;
 
   drape_ptr<base::thread_pool::routine::ThreadPool> m_pool;
+  drape_ptr<RuleDrawer::StylingPool> m_stylingPool;
+  drape_ptr<TileShapesCache> m_shapesCache;
 
   ScreenBase m_currentViewport;
   bool m_have3dBuildings;
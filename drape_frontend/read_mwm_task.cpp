@@ -1,4 +1,7 @@
 #include "drape_frontend/read_mwm_task.hpp"
+#include "drape_frontend/drape_measurer.hpp"
+
+#include <limits>
 
 namespace df
 {
@@ -37,6 +40,14 @@ bool ReadMWMTask::IsCancelled() const
   return tile->IsCancelled() || IRoutine::IsCancelled();
 }
 
+double ReadMWMTask::GetPriority() const
+{
+  std::shared_ptr<TileInfo> tile = m_tileInfo.lock();
+  if (tile == nullptr || tile->IsCancelled())
+    return std::numeric_limits<double>::lowest();
+  return tile->GetPriority();
+}
+
 void ReadMWMTask::Do()
 {
 #ifdef DEBUG
@@ -52,6 +63,9 @@ void ReadMWMTask::Do()
   }
   catch (TileInfo::ReadCanceledException &)
   {
+#if defined(DRAPE_MEASURER_BENCHMARK) && defined(TILES_STATISTIC)
+    DrapeMeasurer::Instance().CancelTileReading();
+#endif
     return;
   }
 }
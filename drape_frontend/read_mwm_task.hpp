@@ -19,6 +19,8 @@ public:
   void Reset() override;
   bool IsCancelled() const override;
   TileKey const & GetTileKey() const { return m_tileKey; }
+  // Cancelled tasks have the highest priority to be dropped from the queue without reading.
+  double GetPriority() const;
 
 private:
   std::weak_ptr<TileInfo> m_tileInfo;
@@ -1,8 +1,10 @@
 #include "drape_frontend/rule_drawer.hpp"
 
 #include "drape_frontend/apply_feature_functors.hpp"
+#include "drape_frontend/drape_measurer.hpp"
 #include "drape_frontend/engine_context.hpp"
 #include "drape_frontend/line_shape.hpp"
+#include "drape_frontend/map_data_provider.hpp"
 #include "drape_frontend/stylist.hpp"
 #include "drape_frontend/traffic_renderer.hpp"
 #include "drape_frontend/visual_params.hpp"
@@ -29,8 +31,11 @@
 #include "base/string_utils.hpp"
 #endif
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <functional>
+#include <iterator>
 #include <vector>
 
 namespace df
@@ -49,6 +54,10 @@ std::array<size_t, 10> const kAverageSegmentsCount =
 
 double constexpr kMetersPerLevel = 3.0;
 
+// Features of the tile are styled in parallel by chunks of this size. Chunks don't depend
+// on the number of threads, so the shapes are the same for any pool.
+size_t constexpr kFeaturesChunkSize = 256;
+
 double GetBuildingHeightInMeters(FeatureType & f)
 {
   double constexpr kDefaultHeightInMeters = 3.0;
@@ -162,11 +171,13 @@ void ExtractTrafficGeometry(FeatureType const & f, df::RoadClass const & roadCla
 RuleDrawer::RuleDrawer(TDrawerCallback const & drawerFn,
                        TCheckCancelledCallback const & checkCancelled,
                        TIsCountryLoadedByNameFn const & isLoadedFn,
-                       ref_ptr<EngineContext> engineContext)
+                       ref_ptr<EngineContext> engineContext,
+                       ref_ptr<TileShapesCache::Recorder> shapesRecorder)
   : m_callback(drawerFn)
   , m_checkCancelled(checkCancelled)
   , m_isLoadedFn(isLoadedFn)
   , m_context(engineContext)
+  , m_shapesRecorder(shapesRecorder)
   , m_customFeaturesContext(engineContext->GetCustomFeaturesContext().lock())
   , m_wasCancelled(false)
 {
@@ -191,7 +202,7 @@ RuleDrawer::RuleDrawer(TDrawerCallback const & drawerFn,
   m_trafficScalePtoG = geometryConvertor.GetScale();
 
   int const kAverageOverlaysCount = 200;
-  m_mapShapes[df::OverlayType].reserve(kAverageOverlaysCount);
+  m_overlayShapes.reserve(kAverageOverlaysCount);
 }
 
 RuleDrawer::~RuleDrawer()
@@ -199,16 +210,17 @@ RuleDrawer::~RuleDrawer()
   if (m_wasCancelled)
     return;
 
-  for (auto const & shape : m_mapShapes[df::OverlayType])
-    shape->Prepare(m_context->GetTextureManager());
-
-  if (!m_mapShapes[df::OverlayType].empty())
+  if (!m_overlayShapes.empty())
   {
     TMapShapes overlayShapes;
-    overlayShapes.swap(m_mapShapes[df::OverlayType]);
+    overlayShapes.swap(m_overlayShapes);
+    if (m_shapesRecorder != nullptr)
+      m_shapesRecorder->AddShapes(overlayShapes);
     m_context->FlushOverlays(std::move(overlayShapes));
   }
 
+  if (m_shapesRecorder != nullptr)
+    m_shapesRecorder->AddTrafficGeometry(m_trafficGeometry);
   m_context->FlushTrafficGeometry(std::move(m_trafficGeometry));
 }
 
@@ -321,7 +333,8 @@ void RuleDrawer::ProcessAreaStyle(FeatureType & f, Stylist const & s,
 }
 
 void RuleDrawer::ProcessLineStyle(FeatureType & f, Stylist const & s,
-                                  TInsertShapeFn const & insertShape, int & minVisibleScale)
+                                  TInsertShapeFn const & insertShape, FeatureShapes & shapes,
+                                  int & minVisibleScale)
 {
   int const zoomLevel = m_context->GetTileKey().m_zoomLevel;
   bool const smooth = ftypes::IsIsolineChecker::Instance()(f);
@@ -338,37 +351,20 @@ void RuleDrawer::ProcessLineStyle(FeatureType & f, Stylist const & s,
     s.ForEachRule(std::bind(&ApplyLineFeatureGeometry::ProcessLineRule, &applyGeom, _1));
   applyGeom.Finish();
 
-  std::vector<m2::SharedSpline> clippedSplines;
-  bool needAdditional;
-  auto const metalineSpline = m_context->GetMetalineManager()->GetMetaline(f.GetID());
-  if (metalineSpline.IsNull())
+  auto metalineSpline = m_context->GetMetalineManager()->GetMetaline(f.GetID());
+  if (!metalineSpline.IsNull() || !applyGeom.GetClippedSplines().empty())
   {
-    // There is no metaline for this feature.
-    needAdditional = true;
-    clippedSplines = applyGeom.GetClippedSplines();
-  }
-  else if (m_usedMetalines.find(metalineSpline.Get()) != m_usedMetalines.end())
-  {
-    // Metaline has been used already, skip additional generation.
-    needAdditional = false;
-  }
-  else
-  {
-    // Generate additional by metaline, mark metaline spline as used.
-    needAdditional = true;
-    clippedSplines = m2::ClipSplineByRect(m_context->GetTileKey().GetGlobalRect(),
-                                          metalineSpline);
-    m_usedMetalines.insert(metalineSpline.Get());
-  }
-
-  if (needAdditional && !clippedSplines.empty())
-  {
-    ApplyLineFeatureAdditional applyAdditional(m_context->GetTileKey(), insertShape, f.GetID(),
-                                               m_currentScaleGtoP, minVisibleScale, f.GetRank(),
-                                               s.GetCaptionDescription(), clippedSplines);
-    s.ForEachRule(std::bind(&ApplyLineFeatureAdditional::ProcessLineRule, &applyAdditional, _1));
-    applyAdditional.Finish(m_context->GetTextureManager(), ftypes::GetRoadShields(f),
-                           m_generatedRoadShields);
+    LineAdditional line;
+    line.m_id = f.GetID();
+    line.m_stylist = s;
+    line.m_rank = f.GetRank();
+    line.m_minVisibleScale = minVisibleScale;
+    if (metalineSpline.IsNull())
+      line.m_clippedSplines = applyGeom.GetClippedSplines();
+    else
+      line.m_metaline = std::move(metalineSpline);
+    line.m_roadShields = ftypes::GetRoadShields(f);
+    shapes.m_lineAdditionals.push_back(std::move(line));
   }
 
   if (m_context->IsTrafficEnabled() && zoomLevel >= kRoadClass0ZoomLevel)
@@ -402,13 +398,55 @@ void RuleDrawer::ProcessLineStyle(FeatureType & f, Stylist const & s,
         assign_range(points, f.GetPoints(FeatureType::BEST_GEOMETRY));
 
         ExtractTrafficGeometry(f, checkers[i].m_roadClass, m2::PolylineD(std::move(points)), oneWay,
-                               zoomLevel, m_trafficScalePtoG, m_trafficGeometry);
+                               zoomLevel, m_trafficScalePtoG, shapes.m_trafficGeometry);
         break;
       }
     }
   }
 }
 
+void RuleDrawer::ProcessLineAdditional(LineAdditional const & line, FeatureShapes & shapes)
+{
+  std::vector<m2::SharedSpline> clippedSplines;
+  if (line.m_metaline.IsNull())
+  {
+    // There is no metaline for this feature.
+    clippedSplines = line.m_clippedSplines;
+  }
+  else if (!m_usedMetalines.insert(line.m_metaline.Get()).second)
+  {
+    // Metaline has been used already, skip additional generation.
+    return;
+  }
+  else
+  {
+    // Generate additional by metaline.
+    clippedSplines = m2::ClipSplineByRect(m_context->GetTileKey().GetGlobalRect(), line.m_metaline);
+  }
+
+  if (clippedSplines.empty())
+    return;
+
+  auto insertShape = [this, &shapes, &line](drape_ptr<MapShape> && shape)
+  {
+    size_t const index = shape->GetType();
+    ASSERT_LESS(index, shapes.m_mapShapes.size(), ());
+
+    shape->SetFeatureMinZoom(line.m_minVisibleScale);
+    shape->Prepare(m_context->GetTextureManager());
+    shapes.m_mapShapes[index].push_back(std::move(shape));
+  };
+
+  ApplyLineFeatureAdditional applyAdditional(m_context->GetTileKey(), insertShape, line.m_id,
+                                             m_currentScaleGtoP, line.m_minVisibleScale,
+                                             line.m_rank, line.m_stylist.GetCaptionDescription(),
+                                             clippedSplines);
+  line.m_stylist.ForEachRule(
+      std::bind(&ApplyLineFeatureAdditional::ProcessLineRule, &applyAdditional, _1));
+  applyAdditional.Finish(m_context->GetTextureManager(), line.m_roadShields,
+                         m_generatedRoadShields);
+}
+
 void RuleDrawer::ProcessPointStyle(FeatureType & f, Stylist const & s,
                                    TInsertShapeFn const & insertShape, int & minVisibleScale)
 {
@@ -436,7 +474,7 @@ void RuleDrawer::ProcessPointStyle(FeatureType & f, Stylist const & s,
   apply.Finish(m_context->GetTextureManager());
 }
 
-void RuleDrawer::operator()(FeatureType & f)
+void RuleDrawer::ProcessFeature(FeatureType & f, FeatureShapes & shapes)
 {
   if (CheckCancelled())
     return;
@@ -473,13 +511,15 @@ void RuleDrawer::operator()(FeatureType & f)
 
   /// @todo Call feature::GetMinDrawableScale() here.
   int minVisibleScale = 0;
-  auto insertShape = [this, &minVisibleScale](drape_ptr<MapShape> && shape)
+  auto insertShape = [this, &shapes, &minVisibleScale](drape_ptr<MapShape> && shape)
   {
     size_t const index = shape->GetType();
-    ASSERT_LESS(index, m_mapShapes.size(), ());
+    ASSERT_LESS(index, shapes.m_mapShapes.size(), ());
 
     shape->SetFeatureMinZoom(minVisibleScale);
-    m_mapShapes[index].push_back(std::move(shape));
+    // Shapes are prepared by the thread which styles the feature.
+    shape->Prepare(m_context->GetTextureManager());
+    shapes.m_mapShapes[index].push_back(std::move(shape));
   };
 
   if (s.m_areaStyleExists)
@@ -488,28 +528,106 @@ void RuleDrawer::operator()(FeatureType & f)
   }
   else if (s.m_lineStyleExists)
   {
-    ProcessLineStyle(f, s, insertShape, minVisibleScale);
+    ProcessLineStyle(f, s, insertShape, shapes, minVisibleScale);
   }
   else
   {
     ASSERT(s.m_pointStyleExists, ());
     ProcessPointStyle(f, s, insertShape, minVisibleScale);
   }
+}
 
-  if (CheckCancelled())
-    return;
+void RuleDrawer::FlushShapes(FeatureShapes & shapes)
+{
+  for (auto const & line : shapes.m_lineAdditionals)
+    ProcessLineAdditional(line, shapes);
+  shapes.m_lineAdditionals.clear();
 
-  for (auto const & shape : m_mapShapes[df::GeometryType])
-    shape->Prepare(m_context->GetTextureManager());
+  // Vectors are cleared but not removed to keep the reserved memory.
+  for (auto & [mwmId, segments] : shapes.m_trafficGeometry)
+  {
+    auto & tileSegments = m_trafficGeometry[mwmId];
+    tileSegments.insert(tileSegments.end(), std::make_move_iterator(segments.begin()),
+                        std::make_move_iterator(segments.end()));
+    segments.clear();
+  }
+
+  auto & overlayShapes = shapes.m_mapShapes[df::OverlayType];
+  m_overlayShapes.insert(m_overlayShapes.end(), std::make_move_iterator(overlayShapes.begin()),
+                         std::make_move_iterator(overlayShapes.end()));
+  overlayShapes.clear();
 
-  if (!m_mapShapes[df::GeometryType].empty())
+  if (!shapes.m_mapShapes[df::GeometryType].empty())
   {
     TMapShapes geomShapes;
-    geomShapes.swap(m_mapShapes[df::GeometryType]);
+    geomShapes.swap(shapes.m_mapShapes[df::GeometryType]);
+    if (m_shapesRecorder != nullptr)
+      m_shapesRecorder->AddShapes(geomShapes);
     m_context->Flush(std::move(geomShapes));
   }
 }
 
+void RuleDrawer::operator()(FeatureType & f)
+{
+  ProcessFeature(f, m_featureShapes);
+
+  if (CheckCancelled())
+    return;
+
+  FlushShapes(m_featureShapes);
+}
+
+void RuleDrawer::ReadFeatures(MapDataProvider const & model, std::vector<FeatureID> const & ids,
+                              ref_ptr<StylingPool> pool)
+{
+  size_t const chunksCount = (ids.size() + kFeaturesChunkSize - 1) / kFeaturesChunkSize;
+  if (pool == nullptr || chunksCount < 2)
+  {
+    model.ReadFeatures(std::bind<void>(std::ref(*this), _1), ids);
+    return;
+  }
+
+#if defined(DRAPE_MEASURER_BENCHMARK) && defined(TILES_STATISTIC)
+  auto const startTime = std::chrono::steady_clock::now();
+  std::vector<std::chrono::nanoseconds> chunksTime(chunksCount);
+#endif
+
+  std::vector<FeatureShapes> chunks(chunksCount);
+  ProcessChunksInOrder(*pool.get(), ids.size(), kFeaturesChunkSize,
+                       [&](size_t begin, size_t end, size_t chunkIndex)
+  {
+#if defined(DRAPE_MEASURER_BENCHMARK) && defined(TILES_STATISTIC)
+    auto const chunkStartTime = std::chrono::steady_clock::now();
+#endif
+    std::vector<FeatureID> const chunkIds(ids.begin() + begin, ids.begin() + end);
+    model.ReadFeatures([this, &chunk = chunks[chunkIndex]](FeatureType & f)
+    {
+      ProcessFeature(f, chunk);
+    }, chunkIds);
+#if defined(DRAPE_MEASURER_BENCHMARK) && defined(TILES_STATISTIC)
+    chunksTime[chunkIndex] = std::chrono::steady_clock::now() - chunkStartTime;
+#endif
+  }, [&](size_t chunkIndex)
+  {
+    if (CheckCancelled())
+      return false;
+
+    FlushShapes(chunks[chunkIndex]);
+    return true;
+  });
+
+  if (CheckCancelled())
+    return;
+
+#if defined(DRAPE_MEASURER_BENCHMARK) && defined(TILES_STATISTIC)
+  std::chrono::nanoseconds chunksTotalTime(0);
+  for (auto const & time : chunksTime)
+    chunksTotalTime += time;
+  DrapeMeasurer::Instance().AddParallelTileStyling(std::chrono::steady_clock::now() - startTime,
+                                                   chunksTotalTime);
+#endif
+}
+
 #ifdef DRAW_TILE_NET
 void RuleDrawer::DrawTileNet()
 {
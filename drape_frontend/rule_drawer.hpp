@@ -3,28 +3,81 @@
 #include "drape_frontend/custom_features_context.hpp"
 #include "drape_frontend/map_shape.hpp"
 #include "drape_frontend/metaline_manager.hpp"
+#include "drape_frontend/stylist.hpp"
 #include "drape_frontend/tile_key.hpp"
+#include "drape_frontend/tile_shapes_cache.hpp"
 #include "drape_frontend/traffic_generator.hpp"
 
 #include "drape/pointers.hpp"
 
+#include "indexer/feature_decl.hpp"
 #include "indexer/road_shields_parser.hpp"
 
 #include "geometry/rect2d.hpp"
 #include "geometry/screenbase.hpp"
+#include "geometry/spline.hpp"
 
+#include "base/scope_guard.hpp"
+#include "base/thread_pool_computational.hpp"
+
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <functional>
+#include <future>
 #include <map>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 class FeatureType;
 
 namespace df
 {
 class EngineContext;
-class Stylist;
+class MapDataProvider;
+
+/// Processes |count| items by chunks of |chunkSize|. |processFn(begin, end, chunkIndex)| is called
+/// for the chunks on the |pool| threads, |flushFn(chunkIndex)| is called on the calling thread in
+/// the order of the chunks as soon as the chunk is processed. Chunks don't depend on the number of
+/// threads, so the result is the same as for the sequential processing.
+/// |flushFn| returns false to stop flushing, the submitted chunks are waited anyway.
+template <typename ProcessFn, typename FlushFn>
+void ProcessChunksInOrder(base::thread_pool::computational::ThreadPool & pool, size_t count,
+                          size_t chunkSize, ProcessFn && processFn, FlushFn && flushFn)
+{
+  size_t const chunksCount = (count + chunkSize - 1) / chunkSize;
+  std::vector<std::future<void>> results;
+  results.reserve(chunksCount);
+  // The chunks refer to the caller's data, they must be finished even if one of them throws.
+  SCOPE_GUARD(waitChunks, [&results]()
+  {
+    for (auto & result : results)
+    {
+      if (result.valid())
+        result.wait();
+    }
+  });
+
+  for (size_t i = 0; i < chunksCount; ++i)
+  {
+    size_t const begin = i * chunkSize;
+    size_t const end = std::min(begin + chunkSize, count);
+    results.push_back(pool.Submit([&processFn, begin, end, i]() { processFn(begin, end, i); }));
+  }
+
+  for (size_t i = 0; i < chunksCount; ++i)
+  {
+    // The stopped pool ignores the tasks, such chunks are processed here.
+    if (results[i].valid())
+      results[i].get();
+    else
+      processFn(i * chunkSize, std::min((i + 1) * chunkSize, count), i);
+
+    if (!flushFn(i))
+      return;
+  }
+}
 
 class RuleDrawer
 {
@@ -33,24 +86,56 @@ public:
   using TCheckCancelledCallback = std::function<bool()>;
   using TIsCountryLoadedByNameFn = std::function<bool(std::string_view)>;
   using TInsertShapeFn = std::function<void(drape_ptr<MapShape> && shape)>;
+  using StylingPool = base::thread_pool::computational::ThreadPool;
 
   RuleDrawer(TDrawerCallback const & drawerFn,
              TCheckCancelledCallback const & checkCancelled,
              TIsCountryLoadedByNameFn const & isLoadedFn,
-             ref_ptr<EngineContext> engineContext);
+             ref_ptr<EngineContext> engineContext,
+             ref_ptr<TileShapesCache::Recorder> shapesRecorder);
   ~RuleDrawer();
 
   void operator()(FeatureType & f);
 
+  /// Reads and draws the features. If |pool| is not null the features are styled by chunks
+  /// in parallel, the shapes are flushed in the order of |ids| anyway.
+  void ReadFeatures(MapDataProvider const & model, std::vector<FeatureID> const & ids,
+                    ref_ptr<StylingPool> pool);
+
 #ifdef DRAW_TILE_NET
   void DrawTileNet();
 #endif
 
 private:
+  // Captions and road shields of a line feature. They depend on the previous features
+  // (metalines and shields nearby), so they are generated when the shapes are flushed.
+  struct LineAdditional
+  {
+    FeatureID m_id;
+    Stylist m_stylist;
+    uint8_t m_rank = 0;
+    int m_minVisibleScale = 0;
+    m2::SharedSpline m_metaline;
+    std::vector<m2::SharedSpline> m_clippedSplines;
+    ftypes::RoadShieldsSetT m_roadShields;
+  };
+
+  // Shapes of the features which are not flushed yet.
+  struct FeatureShapes
+  {
+    std::array<TMapShapes, df::MapShapeTypeCount> m_mapShapes;
+    TrafficSegmentsGeometry m_trafficGeometry;
+    std::vector<LineAdditional> m_lineAdditionals;
+  };
+
+  void ProcessFeature(FeatureType & f, FeatureShapes & shapes);
+  void FlushShapes(FeatureShapes & shapes);
+
   void ProcessAreaStyle(FeatureType & f, Stylist const & s, TInsertShapeFn const & insertShape,
                         int & minVisibleScale);
   void ProcessLineStyle(FeatureType & f, Stylist const & s, TInsertShapeFn const & insertShape,
-                        int & minVisibleScale);
+                        FeatureShapes & shapes, int & minVisibleScale);
+  void ProcessLineAdditional(LineAdditional const & line, FeatureShapes & shapes);
   void ProcessPointStyle(FeatureType & f, Stylist const & s, TInsertShapeFn const & insertShape,
                          int & minVisibleScale);
 
@@ -65,6 +150,8 @@ private:
   TIsCountryLoadedByNameFn m_isLoadedFn;
 
   ref_ptr<EngineContext> m_context;
+  // Collects the flushed shapes to cache them, may be null.
+  ref_ptr<TileShapesCache::Recorder> m_shapesRecorder;
   CustomFeaturesContextPtr m_customFeaturesContext;
   std::unordered_set<m2::Spline const *> m_usedMetalines;
 
@@ -74,8 +161,9 @@ private:
 
   TrafficSegmentsGeometry m_trafficGeometry;
 
-  std::array<TMapShapes, df::MapShapeTypeCount> m_mapShapes;
-  bool m_wasCancelled;
+  FeatureShapes m_featureShapes;
+  TMapShapes m_overlayShapes;
+  std::atomic<bool> m_wasCancelled;
 
   GeneratedRoadShields m_generatedRoadShields;
 };
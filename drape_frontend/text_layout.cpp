@@ -358,6 +358,14 @@ StraightTextLayout::StraightTextLayout(strings::UniString const & text, float fo
   CalculateOffsets(anchor, m_textSizeRatio, m_metrics, delimIndexes, m_offsets, m_pixelSize, m_rowsCount);
 }
 
+// static
+void StraightTextLayout::PrefetchGlyphs(strings::UniString const & text, float fontSize,
+                                        bool isSdf, ref_ptr<dp::TextureManager> textures)
+{
+  TextLayout layout;
+  layout.Init(bidi::log2vis(text), fontSize, isSdf, textures);
+}
+
 m2::PointF StraightTextLayout::GetSymbolBasedTextOffset(m2::PointF const & symbolSize, dp::Anchor textAnchor,
                                                         dp::Anchor symbolAnchor)
 {
@@ -73,6 +73,10 @@ public:
                                              dp::Anchor textAnchor,
                                              dp::Anchor symbolAnchor);
 
+  // Maps glyphs of the text to the texture without layout, so they are generated in advance.
+  static void PrefetchGlyphs(strings::UniString const & text, float fontSize, bool isSdf,
+                             ref_ptr<dp::TextureManager> textures);
+
   glsl::vec2 GetTextOffset(m2::PointF const & symbolSize, dp::Anchor textAnchor, dp::Anchor symbolAnchor) const;
 
 private:
@@ -232,6 +232,22 @@ void CalculateTextOffsets(dp::TitleDecl const titleDecl, m2::PointF const & prim
   }
 }
 
+void TextShape::Prepare(ref_ptr<dp::TextureManager> textures) const
+{
+  // Glyphs are requested by the reader thread, so SDF is generated while the tile is being read
+  // and the text is drawn with the ready glyphs.
+  auto const & titleDecl = m_params.m_titleDecl;
+  StraightTextLayout::PrefetchGlyphs(strings::MakeUniString(titleDecl.m_primaryText),
+                                     titleDecl.m_primaryTextFont.m_size,
+                                     titleDecl.m_primaryTextFont.m_isSdf, textures);
+  if (!titleDecl.m_secondaryText.empty())
+  {
+    StraightTextLayout::PrefetchGlyphs(strings::MakeUniString(titleDecl.m_secondaryText),
+                                       titleDecl.m_secondaryTextFont.m_size,
+                                       titleDecl.m_secondaryTextFont.m_isSdf, textures);
+  }
+}
+
 void TextShape::Draw(ref_ptr<dp::GraphicsContext> context, ref_ptr<dp::Batcher> batcher,
                      ref_ptr<dp::TextureManager> textures) const
 {
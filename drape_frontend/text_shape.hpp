@@ -25,6 +25,7 @@ public:
             TileKey const & tileKey, std::vector<m2::PointF> const & symbolSizes,
             m2::PointF const & symbolOffset, dp::Anchor symbolAnchor, uint32_t textIndex);
 
+  void Prepare(ref_ptr<dp::TextureManager> textures) const override;
   void Draw(ref_ptr<dp::GraphicsContext> context, ref_ptr<dp::Batcher> batcher,
             ref_ptr<dp::TextureManager> textures) const override;
   MapShapeType GetType() const override { return MapShapeType::OverlayType; }
@@ -33,6 +34,8 @@ public:
   void DisableDisplacing() { m_disableDisplacing = true; }
 
 private:
+  friend class TileShapesWriter;
+
   void DrawSubString(ref_ptr<dp::GraphicsContext> context, StraightTextLayout & layout,
                      dp::FontDecl const & font, glsl::vec2 const & baseOffset,
                      ref_ptr<dp::Batcher> batcher, ref_ptr<dp::TextureManager> textures,
@@ -5,24 +5,36 @@
 #include "drape_frontend/metaline_manager.hpp"
 #include "drape_frontend/rule_drawer.hpp"
 #include "drape_frontend/stylist.hpp"
+#include "drape_frontend/visual_params.hpp"
 
+#include "indexer/map_style_reader.hpp"
 #include "indexer/scales.hpp"
 
+#include "platform/platform.hpp"
 #include "platform/preferred_languages.hpp"
 
 #include "base/scope_guard.hpp"
 #include "base/logging.hpp"
+#include "base/string_utils.hpp"
 
 #include <algorithm>
 #include <functional>
+#include <optional>
+#include <string>
+#include <vector>
 
 using namespace std::placeholders;
 
 namespace df
 {
-TileInfo::TileInfo(drape_ptr<EngineContext> && engineContext)
+TileInfo::TileInfo(drape_ptr<EngineContext> && engineContext,
+                   ref_ptr<RuleDrawer::StylingPool> stylingPool,
+                   ref_ptr<TileShapesCache> shapesCache)
   : m_context(std::move(engineContext))
+  , m_stylingPool(stylingPool)
+  , m_shapesCache(shapesCache)
   , m_isCanceled(false)
+  , m_priority(0.0)
 {}
 
 m2::RectD TileInfo::GetGlobalRect() const
@@ -43,6 +55,8 @@ void TileInfo::ReadFeatureIndex(MapDataProvider const & model)
   MwmSet::MwmId lastMwm;
   model.ReadFeaturesID([this, &lastMwm](FeatureID const & id)
   {
+    // Stop index reading as soon as the tile is cancelled, so it doesn't hold the reading thread.
+    CheckCanceled();
     if (m_mwms.empty() || lastMwm != id.m_mwmId)
     {
       auto result = m_mwms.insert(id.m_mwmId);
@@ -72,13 +86,50 @@ void TileInfo::ReadFeatures(MapDataProvider const & model)
   {
     std::sort(m_featureInfo.begin(), m_featureInfo.end());
     auto const deviceLang = StringUtf8Multilang::GetLangIndex(languages::GetCurrentNorm());
-    RuleDrawer drawer(std::bind(&TileInfo::InitStylist, this, deviceLang, _1, _2),
-                      std::bind(&TileInfo::IsCancelled, this), model.m_isCountryLoadedByName,
-                      make_ref(m_context));
-    model.ReadFeatures(std::bind<void>(std::ref(drawer), _1), m_featureInfo);
+
+    std::string cacheContext;
+    uint64_t cacheGeneration = 0;
+    bool isCached = false;
+    std::optional<TileShapesCache::Recorder> recorder;
+    if (CanUseShapesCache())
+    {
+      cacheContext = GetShapesCacheContext(deviceLang);
+      cacheGeneration = m_shapesCache->GetGeneration();
+
+      CachedTileShapes shapes;
+      isCached = m_shapesCache->Load(GetTileKey(), cacheContext, m_featureInfo,
+                                     m_context->GetTextureManager(), shapes);
+#if defined(DRAPE_MEASURER_BENCHMARK) && defined(TILES_STATISTIC)
+      DrapeMeasurer::Instance().AddTileShapesCacheRequest(isCached);
+#endif
+      if (isCached)
+      {
+        CheckCanceled();
+        FlushCachedShapes(std::move(shapes));
+      }
+      else if (m_context->GetMetalineManager()->AreMetalinesLoaded(m_mwms))
+      {
+        // Captions of the lines depend on the metalines, so the tile is cached when they are read.
+        recorder.emplace(m_featureInfo);
+      }
+    }
+
+    if (!isCached)
+    {
+      {
+        RuleDrawer drawer(std::bind(&TileInfo::InitStylist, this, deviceLang, _1, _2),
+                          std::bind(&TileInfo::IsCancelled, this), model.m_isCountryLoadedByName,
+                          make_ref(m_context),
+                          recorder ? make_ref(&*recorder) : ref_ptr<TileShapesCache::Recorder>());
+        drawer.ReadFeatures(model, m_featureInfo, m_stylingPool);
 #ifdef DRAW_TILE_NET
-    drawer.DrawTileNet();
+        drawer.DrawTileNet();
 #endif
+      }
+
+      if (recorder && !IsCancelled())
+        m_shapesCache->Save(GetTileKey(), cacheContext, m_featureInfo, *recorder, cacheGeneration);
+    }
   }
 #if defined(DRAPE_MEASURER_BENCHMARK) && defined(TILES_STATISTIC)
   DrapeMeasurer::Instance().EndTileReading();
@@ -102,6 +153,42 @@ void TileInfo::InitStylist(int8_t deviceLang, FeatureType & f, Stylist & s)
                   m_context->Is3dBuildingsEnabled(), s);
 }
 
+bool TileInfo::CanUseShapesCache() const
+{
+  if (m_shapesCache == nullptr)
+    return false;
+
+  // Custom features are shown for a while only, such tiles are not cached.
+  auto const customFeatures = m_context->GetCustomFeaturesContext().lock();
+  return customFeatures == nullptr || customFeatures->m_features.empty();
+}
+
+std::string TileInfo::GetShapesCacheContext(int8_t deviceLang) const
+{
+  auto const & vparams = VisualParams::Instance();
+  auto const & styleReader = GetStyleReader();
+  return strings::JoinStrings(std::vector<std::string>{
+      GetPlatform().Version(),
+      DebugPrint(styleReader.GetCurrentStyle()),
+      strings::to_string(styleReader.IsCarNavigationStyle()),
+      strings::to_string(static_cast<int>(deviceLang)),
+      strings::to_string_dac(vparams.GetVisualScale(), 4),
+      strings::to_string(vparams.GetTileSize()),
+      strings::to_string_dac(vparams.GetFontScale(), 4),
+      strings::to_string(m_context->Is3dBuildingsEnabled()),
+      strings::to_string(m_context->IsTrafficEnabled()),
+      strings::to_string(m_context->IsolinesEnabled())}, ";");
+}
+
+void TileInfo::FlushCachedShapes(CachedTileShapes && shapes)
+{
+  if (!shapes.m_geometryShapes.empty())
+    m_context->Flush(std::move(shapes.m_geometryShapes));
+  if (!shapes.m_overlayShapes.empty())
+    m_context->FlushOverlays(std::move(shapes.m_overlayShapes));
+  m_context->FlushTrafficGeometry(std::move(shapes.m_trafficGeometry));
+}
+
 bool TileInfo::DoNeedReadIndex() const
 {
   return m_featureInfo.empty();
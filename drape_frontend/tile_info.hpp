@@ -2,7 +2,9 @@
 
 #include "drape_frontend/custom_features_context.hpp"
 #include "drape_frontend/engine_context.hpp"
+#include "drape_frontend/rule_drawer.hpp"
 #include "drape_frontend/tile_key.hpp"
+#include "drape_frontend/tile_shapes_cache.hpp"
 
 #include "indexer/feature_decl.hpp"
 
@@ -11,6 +13,7 @@
 
 #include <atomic>
 #include <set>
+#include <string>
 #include <vector>
 
 class FeatureType;
@@ -25,12 +28,17 @@ class TileInfo
 public:
   DECLARE_EXCEPTION(ReadCanceledException, RootException);
 
-  TileInfo(drape_ptr<EngineContext> && engineContext);
+  TileInfo(drape_ptr<EngineContext> && engineContext, ref_ptr<RuleDrawer::StylingPool> stylingPool,
+           ref_ptr<TileShapesCache> shapesCache);
 
   void ReadFeatures(MapDataProvider const & model);
   void Cancel();
   bool IsCancelled() const;
 
+  // Lower value means that the tile should be read earlier.
+  void SetPriority(double priority) { m_priority = priority; }
+  double GetPriority() const { return m_priority; }
+
   m2::RectD GetGlobalRect() const;
   TileKey const & GetTileKey() const { return m_context->GetTileKey(); }
   bool operator <(TileInfo const & other) const { return GetTileKey() < other.GetTileKey(); }
@@ -38,6 +46,9 @@ public:
 private:
   void ReadFeatureIndex(MapDataProvider const & model);
   void InitStylist(int8_t deviceLang, FeatureType & f, Stylist & s);
+  bool CanUseShapesCache() const;
+  std::string GetShapesCacheContext(int8_t deviceLang) const;
+  void FlushCachedShapes(CachedTileShapes && shapes);
   void CheckCanceled() const;
   bool DoNeedReadIndex() const;
 
@@ -45,8 +56,13 @@ private:
 
 private:
   drape_ptr<EngineContext> m_context;
+  // Styles the features of the dense tiles in parallel, may be null.
+  ref_ptr<RuleDrawer::StylingPool> m_stylingPool;
+  // Persistent cache of the generated shapes, may be null.
+  ref_ptr<TileShapesCache> m_shapesCache;
   std::vector<FeatureID> m_featureInfo;
   std::atomic<bool> m_isCanceled;
+  std::atomic<double> m_priority;
   std::set<MwmSet::MwmId> m_mwms;
 
   DISALLOW_COPY_AND_MOVE(TileInfo);
@@ -0,0 +1,961 @@
+#include "drape_frontend/tile_shapes_cache.hpp"
+
+#include "drape_frontend/area_shape.hpp"
+#include "drape_frontend/colored_symbol_shape.hpp"
+#include "drape_frontend/line_shape.hpp"
+#include "drape_frontend/path_symbol_shape.hpp"
+#include "drape_frontend/path_text_shape.hpp"
+#include "drape_frontend/poi_symbol_shape.hpp"
+#include "drape_frontend/shape_view_params.hpp"
+#include "drape_frontend/text_shape.hpp"
+
+#include "drape/texture_manager.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/byte_stream.hpp"
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/read_write_utils.hpp"
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/zlib.hpp"
+
+#include "base/assert.hpp"
+#include "base/file_name_utils.hpp"
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace df
+{
+namespace
+{
+// Increase it on any change of the shapes or their params.
+uint32_t constexpr kFileVersion = 1;
+std::string const kTileFileExtension = ".shapes";
+std::string const kTmpFileExtension = ".tmp";
+std::string const kGenerationFileName = "generation";
+
+enum class ShapeKind : uint8_t
+{
+  Area,
+  ColoredSymbol,
+  Line,
+  PathSymbol,
+  PathText,
+  PoiSymbol,
+  Text,
+};
+
+using Buffer = std::vector<uint8_t>;
+using Sink = PushBackByteSink<Buffer>;
+using Source = ReaderSource<MemReaderWithExceptions>;
+
+// Key of a tile: version, generation of the cache, context and features of the tile.
+// Cached shapes follow the key in the file.
+Buffer MakeKey(uint64_t generation, std::string const & context,
+               std::vector<FeatureID> const & features)
+{
+  Buffer key;
+  Sink sink(key);
+  WriteToSink(sink, kFileVersion);
+  WriteToSink(sink, generation);
+  rw::Write(sink, context);
+
+  // Features are sorted, so the features of an mwm are together.
+  for (auto it = features.begin(); it != features.end();)
+  {
+    auto const & mwmId = it->m_mwmId;
+    auto const next = std::find_if(it, features.end(), [&mwmId](FeatureID const & id)
+    {
+      return id.m_mwmId != mwmId;
+    });
+
+    rw::Write(sink, mwmId.IsAlive() ? mwmId.GetInfo()->GetCountryName() : std::string());
+    WriteVarInt(sink, mwmId.IsAlive() ? mwmId.GetInfo()->GetVersion() : int64_t{0});
+    WriteVarUint(sink, static_cast<uint32_t>(std::distance(it, next)));
+    uint32_t prevIndex = 0;
+    for (; it != next; ++it)
+    {
+      WriteVarUint(sink, it->m_index - prevIndex);
+      prevIndex = it->m_index;
+    }
+  }
+  return key;
+}
+
+std::vector<MwmSet::MwmId> GetMwms(std::vector<FeatureID> const & features)
+{
+  std::vector<MwmSet::MwmId> mwms;
+  for (auto const & id : features)
+  {
+    if (mwms.empty() || mwms.back() != id.m_mwmId)
+      mwms.push_back(id.m_mwmId);
+  }
+  return mwms;
+}
+
+template <typename T>
+void WriteFloat(Sink & sink, T value)
+{
+  static_assert(std::is_floating_point<T>::value, "");
+  using Bits = std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t>;
+  static_assert(sizeof(Bits) == sizeof(T), "");
+  Bits bits;
+  memcpy(&bits, &value, sizeof(bits));
+  WriteToSink(sink, bits);
+}
+
+template <typename T>
+T ReadFloat(Source & src)
+{
+  using Bits = std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t>;
+  Bits const bits = ReadPrimitiveFromSource<Bits>(src);
+  T value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+template <typename T>
+void WriteEnum(Sink & sink, T value)
+{
+  WriteVarUint(sink, static_cast<uint32_t>(value));
+}
+
+template <typename T>
+T ReadEnum(Source & src)
+{
+  return static_cast<T>(ReadVarUint<uint32_t>(src));
+}
+
+void WriteBool(Sink & sink, bool value) { WriteToSink(sink, static_cast<uint8_t>(value ? 1 : 0)); }
+
+bool ReadBool(Source & src) { return ReadPrimitiveFromSource<uint8_t>(src) != 0; }
+
+void WritePoint(Sink & sink, m2::PointD const & pt)
+{
+  WriteFloat(sink, pt.x);
+  WriteFloat(sink, pt.y);
+}
+
+m2::PointD ReadPointD(Source & src)
+{
+  double const x = ReadFloat<double>(src);
+  return {x, ReadFloat<double>(src)};
+}
+
+void WritePoint(Sink & sink, m2::PointF const & pt)
+{
+  WriteFloat(sink, pt.x);
+  WriteFloat(sink, pt.y);
+}
+
+m2::PointF ReadPointF(Source & src)
+{
+  float const x = ReadFloat<float>(src);
+  return {x, ReadFloat<float>(src)};
+}
+
+template <typename Points>
+void WritePoints(Sink & sink, Points const & points)
+{
+  WriteVarUint(sink, static_cast<uint32_t>(points.size()));
+  for (auto const & pt : points)
+    WritePoint(sink, pt);
+}
+
+template <typename Points, typename ReadFn>
+void ReadPoints(Source & src, Points & points, ReadFn && readFn)
+{
+  uint32_t const count = ReadVarUint<uint32_t>(src);
+  points.clear();
+  points.reserve(count);
+  for (uint32_t i = 0; i < count; ++i)
+    points.push_back(readFn(src));
+}
+
+void WriteColor(Sink & sink, dp::Color const & color)
+{
+  WriteToSink(sink, color.GetRed());
+  WriteToSink(sink, color.GetGreen());
+  WriteToSink(sink, color.GetBlue());
+  WriteToSink(sink, color.GetAlpha());
+}
+
+dp::Color ReadColor(Source & src)
+{
+  uint8_t const r = ReadPrimitiveFromSource<uint8_t>(src);
+  uint8_t const g = ReadPrimitiveFromSource<uint8_t>(src);
+  uint8_t const b = ReadPrimitiveFromSource<uint8_t>(src);
+  return dp::Color(r, g, b, ReadPrimitiveFromSource<uint8_t>(src));
+}
+
+void WriteFont(Sink & sink, dp::FontDecl const & font)
+{
+  WriteColor(sink, font.m_color);
+  WriteColor(sink, font.m_outlineColor);
+  WriteFloat(sink, font.m_size);
+  WriteBool(sink, font.m_isSdf);
+}
+
+dp::FontDecl ReadFont(Source & src)
+{
+  dp::FontDecl font;
+  font.m_color = ReadColor(src);
+  font.m_outlineColor = ReadColor(src);
+  font.m_size = ReadFloat<float>(src);
+  font.m_isSdf = ReadBool(src);
+  return font;
+}
+
+std::string ReadString(Source & src)
+{
+  std::string s;
+  rw::Read(src, s);
+  return s;
+}
+
+void WriteCommonParams(Sink & sink, CommonViewParams const & params)
+{
+  WriteEnum(sink, params.m_depthLayer);
+  WriteFloat(sink, params.m_depth);
+  WriteBool(sink, params.m_depthTestEnabled);
+  WriteVarInt(sink, params.m_minVisibleScale);
+  WriteToSink(sink, params.m_rank);
+  WritePoint(sink, params.m_tileCenter);
+}
+
+void ReadCommonParams(Source & src, CommonViewParams & params)
+{
+  params.m_depthLayer = ReadEnum<DepthLayer>(src);
+  params.m_depth = ReadFloat<float>(src);
+  params.m_depthTestEnabled = ReadBool(src);
+  params.m_minVisibleScale = ReadVarInt<int32_t>(src);
+  params.m_rank = ReadPrimitiveFromSource<uint8_t>(src);
+  params.m_tileCenter = ReadPointD(src);
+}
+
+// Features of the cached shapes are stored as indices in the mwms of the tile.
+class FeatureIdReader
+{
+public:
+  explicit FeatureIdReader(std::vector<MwmSet::MwmId> const & mwms) : m_mwms(mwms) {}
+
+  FeatureID operator()(Source & src) const
+  {
+    uint32_t const mwm = ReadVarUint<uint32_t>(src);
+    if (mwm == 0)
+      return {};
+    return {GetMwm(mwm), ReadVarUint<uint32_t>(src)};
+  }
+
+  MwmSet::MwmId ReadMwm(Source & src) const
+  {
+    uint32_t const mwm = ReadVarUint<uint32_t>(src);
+    return mwm == 0 ? MwmSet::MwmId() : GetMwm(mwm);
+  }
+
+private:
+  MwmSet::MwmId const & GetMwm(uint32_t mwm) const
+  {
+    if (mwm > m_mwms.size())
+      MYTHROW(Reader::ReadException, ("Unknown mwm", mwm));
+    return m_mwms[mwm - 1];
+  }
+
+  std::vector<MwmSet::MwmId> const & m_mwms;
+};
+
+void ReadOverlayParams(Source & src, FeatureIdReader const & readId,
+                       CommonOverlayViewParams & params)
+{
+  ReadCommonParams(src, params);
+  params.m_specialDisplacement = ReadEnum<SpecialDisplacement>(src);
+  params.m_specialPriority = ReadPrimitiveFromSource<uint16_t>(src);
+  params.m_startOverlayRank = ReadPrimitiveFromSource<uint8_t>(src);
+  params.m_featureId = readId(src);
+  params.m_markId = ReadPrimitiveFromSource<kml::MarkId>(src);
+}
+
+m2::SharedSpline ReadSpline(Source & src)
+{
+  std::vector<m2::PointD> path;
+  ReadPoints(src, path, &ReadPointD);
+  return m2::SharedSpline(std::move(path));
+}
+
+drape_ptr<MapShape> ReadShape(Source & src, TileKey const & tileKey,
+                              FeatureIdReader const & readId, ref_ptr<dp::TextureManager> texMng)
+{
+  auto const kind = ReadEnum<ShapeKind>(src);
+  int const minZoom = ReadVarInt<int32_t>(src);
+
+  drape_ptr<MapShape> shape;
+  switch (kind)
+  {
+  case ShapeKind::Area:
+    {
+      std::vector<m2::PointD> vertices;
+      ReadPoints(src, vertices, &ReadPointD);
+      BuildingOutline outline;
+      ReadPoints(src, outline.m_vertices, &ReadPointD);
+      ReadPoints(src, outline.m_indices, [](Source & s) { return ReadVarInt<int32_t>(s); });
+      ReadPoints(src, outline.m_normals, &ReadPointD);
+      outline.m_generateOutline = ReadBool(src);
+
+      AreaViewParams params;
+      ReadCommonParams(src, params);
+      params.m_color = ReadColor(src);
+      params.m_outlineColor = ReadColor(src);
+      params.m_minPosZ = ReadFloat<float>(src);
+      params.m_posZ = ReadFloat<float>(src);
+      params.m_is3D = ReadBool(src);
+      params.m_hatching = ReadBool(src);
+      params.m_baseGtoPScale = ReadFloat<float>(src);
+      shape = make_unique_dp<AreaShape>(std::move(vertices), std::move(outline), params);
+      break;
+    }
+  case ShapeKind::ColoredSymbol:
+    {
+      m2::PointD const point = ReadPointD(src);
+      ColoredSymbolViewParams params;
+      ReadOverlayParams(src, readId, params);
+      params.m_shape = ReadEnum<ColoredSymbolViewParams::Shape>(src);
+      params.m_anchor = ReadEnum<dp::Anchor>(src);
+      params.m_color = ReadColor(src);
+      params.m_outlineColor = ReadColor(src);
+      params.m_radiusInPixels = ReadFloat<float>(src);
+      params.m_sizeInPixels = ReadPointF(src);
+      params.m_outlineWidth = ReadFloat<float>(src);
+      params.m_offset = ReadPointF(src);
+      uint32_t const textIndex = ReadVarUint<uint32_t>(src);
+      bool const needOverlay = ReadBool(src);
+      std::vector<m2::PointF> overlaySizes;
+      ReadPoints(src, overlaySizes, &ReadPointF);
+      if (overlaySizes.empty())
+      {
+        shape = make_unique_dp<ColoredSymbolShape>(point, params, tileKey, textIndex, needOverlay);
+      }
+      else
+      {
+        shape = make_unique_dp<ColoredSymbolShape>(point, params, tileKey, textIndex,
+                                                   overlaySizes);
+      }
+      break;
+    }
+  case ShapeKind::Line:
+    {
+      auto const spline = ReadSpline(src);
+      LineViewParams params;
+      ReadCommonParams(src, params);
+      params.m_color = ReadColor(src);
+      params.m_width = ReadFloat<float>(src);
+      params.m_cap = ReadEnum<dp::LineCap>(src);
+      params.m_join = ReadEnum<dp::LineJoin>(src);
+      ReadPoints(src, params.m_pattern, [](Source & s)
+      {
+        return static_cast<uint16_t>(ReadVarUint<uint32_t>(s));
+      });
+      params.m_baseGtoPScale = ReadFloat<float>(src);
+      params.m_zoomLevel = ReadVarInt<int32_t>(src);
+      shape = make_unique_dp<LineShape>(spline, params);
+      break;
+    }
+  case ShapeKind::PathSymbol:
+    {
+      auto const spline = ReadSpline(src);
+      PathSymbolViewParams params;
+      ReadCommonParams(src, params);
+      params.m_featureID = readId(src);
+      params.m_symbolName = ReadString(src);
+      params.m_offset = ReadFloat<float>(src);
+      params.m_step = ReadFloat<float>(src);
+      params.m_baseGtoPScale = ReadFloat<float>(src);
+      shape = make_unique_dp<PathSymbolShape>(spline, params);
+      break;
+    }
+  case ShapeKind::PathText:
+    {
+      auto const spline = ReadSpline(src);
+      PathTextViewParams params;
+      ReadOverlayParams(src, readId, params);
+      params.m_textFont = ReadFont(src);
+      params.m_mainText = ReadString(src);
+      params.m_auxText = ReadString(src);
+      params.m_baseGtoPScale = ReadFloat<float>(src);
+      uint32_t const baseTextIndex = ReadVarUint<uint32_t>(src);
+      auto pathText = make_unique_dp<PathTextShape>(spline, params, tileKey, baseTextIndex);
+      // The shape is skipped as it's skipped by the styling.
+      if (pathText->CalculateLayout(texMng))
+        shape = std::move(pathText);
+      break;
+    }
+  case ShapeKind::PoiSymbol:
+    {
+      m2::PointD const point = ReadPointD(src);
+      PoiSymbolViewParams params;
+      ReadOverlayParams(src, readId, params);
+      params.m_symbolName = ReadString(src);
+      params.m_extendingSize = ReadVarUint<uint32_t>(src);
+      params.m_posZ = ReadFloat<float>(src);
+      params.m_hasArea = ReadBool(src);
+      params.m_prioritized = ReadBool(src);
+      params.m_maskColor = ReadString(src);
+      params.m_anchor = ReadEnum<dp::Anchor>(src);
+      params.m_offset = ReadPointF(src);
+      params.m_pixelWidth = ReadFloat<float>(src);
+      uint32_t const textIndex = ReadVarUint<uint32_t>(src);
+      shape = make_unique_dp<PoiSymbolShape>(point, params, tileKey, textIndex);
+      break;
+    }
+  case ShapeKind::Text:
+    {
+      m2::PointD const basePoint = ReadPointD(src);
+      TextViewParams params;
+      ReadOverlayParams(src, readId, params);
+      auto & title = params.m_titleDecl;
+      title.m_primaryTextFont = ReadFont(src);
+      title.m_primaryText = ReadString(src);
+      title.m_secondaryTextFont = ReadFont(src);
+      title.m_secondaryText = ReadString(src);
+      title.m_anchor = ReadEnum<dp::Anchor>(src);
+      title.m_forceNoWrap = ReadBool(src);
+      title.m_primaryOffset = ReadPointF(src);
+      title.m_secondaryOffset = ReadPointF(src);
+      title.m_primaryOptional = ReadBool(src);
+      title.m_secondaryOptional = ReadBool(src);
+      params.m_hasArea = ReadBool(src);
+      params.m_createdByEditor = ReadBool(src);
+      params.m_extendingSize = ReadVarUint<uint32_t>(src);
+      params.m_posZ = ReadFloat<float>(src);
+      params.m_limitedText = ReadBool(src);
+      params.m_limits = ReadPointF(src);
+      std::vector<m2::PointF> symbolSizes;
+      ReadPoints(src, symbolSizes, &ReadPointF);
+      if (symbolSizes.empty())
+        MYTHROW(Reader::ReadException, ("Text without symbol sizes"));
+      auto const symbolAnchor = ReadEnum<dp::Anchor>(src);
+      m2::PointF const symbolOffset = ReadPointF(src);
+      uint32_t const textIndex = ReadVarUint<uint32_t>(src);
+      shape = make_unique_dp<TextShape>(basePoint, params, tileKey, symbolSizes, symbolOffset,
+                                        symbolAnchor, textIndex);
+      break;
+    }
+  default:
+    MYTHROW(Reader::ReadException, ("Unknown shape", static_cast<uint32_t>(kind)));
+  }
+
+  if (shape != nullptr)
+  {
+    shape->SetFeatureMinZoom(minZoom);
+    shape->Prepare(texMng);
+  }
+  return shape;
+}
+}  // namespace
+
+// Shapes don't expose their construction params, so the writer is their friend.
+class TileShapesWriter
+{
+public:
+  TileShapesWriter(std::map<MwmSet::MwmId, uint32_t> const & mwmIndices, Buffer & buffer)
+    : m_mwmIndices(mwmIndices), m_sink(buffer)
+  {}
+
+  // Returns false if the shape can't be cached.
+  bool Write(MapShape const & shape)
+  {
+    if (auto const * area = dynamic_cast<AreaShape const *>(&shape))
+      Write(*area);
+    else if (auto const * coloredSymbol = dynamic_cast<ColoredSymbolShape const *>(&shape))
+      Write(*coloredSymbol);
+    else if (auto const * line = dynamic_cast<LineShape const *>(&shape))
+      Write(*line);
+    else if (auto const * pathSymbol = dynamic_cast<PathSymbolShape const *>(&shape))
+      Write(*pathSymbol);
+    else if (auto const * pathText = dynamic_cast<PathTextShape const *>(&shape))
+      Write(*pathText);
+    else if (auto const * poiSymbol = dynamic_cast<PoiSymbolShape const *>(&shape))
+      Write(*poiSymbol);
+    else if (auto const * text = dynamic_cast<TextShape const *>(&shape))
+      Write(*text);
+    else
+      return false;
+    return m_isValid;
+  }
+
+  bool Write(MwmSet::MwmId const & mwmId, traffic::TrafficInfo::RoadSegmentId const & segmentId,
+             TrafficSegmentGeometry const & segment)
+  {
+    WriteMwm(mwmId);
+    WriteVarUint(m_sink, segmentId.GetFid());
+    WriteToSink(m_sink, segmentId.GetIdx());
+    WriteToSink(m_sink, segmentId.GetDir());
+    WritePoints(m_sink, segment.m_polyline.GetPoints());
+    WriteEnum(m_sink, segment.m_roadClass);
+    return m_isValid;
+  }
+
+private:
+  void WriteHeader(ShapeKind kind, MapShape const & shape)
+  {
+    WriteEnum(m_sink, kind);
+    WriteVarInt(m_sink, shape.GetFeatureMinZoom());
+  }
+
+  void WriteMwm(MwmSet::MwmId const & mwmId)
+  {
+    auto const it = m_mwmIndices.find(mwmId);
+    if (it == m_mwmIndices.cend())
+    {
+      m_isValid = false;
+      return;
+    }
+    WriteVarUint(m_sink, it->second + 1);
+  }
+
+  void WriteFeatureId(FeatureID const & id)
+  {
+    if (!id.IsValid())
+    {
+      WriteVarUint(m_sink, 0U);
+      return;
+    }
+    WriteMwm(id.m_mwmId);
+    WriteVarUint(m_sink, id.m_index);
+  }
+
+  void WriteOverlayParams(CommonOverlayViewParams const & params)
+  {
+    WriteCommonParams(m_sink, params);
+    WriteEnum(m_sink, params.m_specialDisplacement);
+    WriteToSink(m_sink, params.m_specialPriority);
+    WriteToSink(m_sink, params.m_startOverlayRank);
+    WriteFeatureId(params.m_featureId);
+    WriteToSink(m_sink, params.m_markId);
+  }
+
+  void WriteSpline(m2::SharedSpline const & spline) { WritePoints(m_sink, spline->GetPath()); }
+
+  void Write(AreaShape const & shape)
+  {
+    WriteHeader(ShapeKind::Area, shape);
+    WritePoints(m_sink, shape.m_vertexes);
+    auto const & outline = shape.m_buildingOutline;
+    WritePoints(m_sink, outline.m_vertices);
+    WriteVarUint(m_sink, static_cast<uint32_t>(outline.m_indices.size()));
+    for (int index : outline.m_indices)
+      WriteVarInt(m_sink, index);
+    WritePoints(m_sink, outline.m_normals);
+    WriteBool(m_sink, outline.m_generateOutline);
+
+    auto const & params = shape.m_params;
+    WriteCommonParams(m_sink, params);
+    WriteColor(m_sink, params.m_color);
+    WriteColor(m_sink, params.m_outlineColor);
+    WriteFloat(m_sink, params.m_minPosZ);
+    WriteFloat(m_sink, params.m_posZ);
+    WriteBool(m_sink, params.m_is3D);
+    WriteBool(m_sink, params.m_hatching);
+    WriteFloat(m_sink, params.m_baseGtoPScale);
+  }
+
+  void Write(ColoredSymbolShape const & shape)
+  {
+    WriteHeader(ShapeKind::ColoredSymbol, shape);
+    WritePoint(m_sink, shape.m_point);
+    auto const & params = shape.m_params;
+    WriteOverlayParams(params);
+    WriteEnum(m_sink, params.m_shape);
+    WriteEnum(m_sink, params.m_anchor);
+    WriteColor(m_sink, params.m_color);
+    WriteColor(m_sink, params.m_outlineColor);
+    WriteFloat(m_sink, params.m_radiusInPixels);
+    WritePoint(m_sink, params.m_sizeInPixels);
+    WriteFloat(m_sink, params.m_outlineWidth);
+    WritePoint(m_sink, params.m_offset);
+    WriteVarUint(m_sink, shape.m_textIndex);
+    WriteBool(m_sink, shape.m_needOverlay);
+    WritePoints(m_sink, shape.m_overlaySizes);
+  }
+
+  void Write(LineShape const & shape)
+  {
+    WriteHeader(ShapeKind::Line, shape);
+    WriteSpline(shape.m_spline);
+    auto const & params = shape.m_params;
+    WriteCommonParams(m_sink, params);
+    WriteColor(m_sink, params.m_color);
+    WriteFloat(m_sink, params.m_width);
+    WriteEnum(m_sink, params.m_cap);
+    WriteEnum(m_sink, params.m_join);
+    WriteVarUint(m_sink, static_cast<uint32_t>(params.m_pattern.size()));
+    for (uint16_t dash : params.m_pattern)
+      WriteVarUint(m_sink, static_cast<uint32_t>(dash));
+    WriteFloat(m_sink, params.m_baseGtoPScale);
+    WriteVarInt(m_sink, params.m_zoomLevel);
+  }
+
+  void Write(PathSymbolShape const & shape)
+  {
+    WriteHeader(ShapeKind::PathSymbol, shape);
+    WriteSpline(shape.m_spline);
+    auto const & params = shape.m_params;
+    WriteCommonParams(m_sink, params);
+    WriteFeatureId(params.m_featureID);
+    rw::Write(m_sink, params.m_symbolName);
+    WriteFloat(m_sink, params.m_offset);
+    WriteFloat(m_sink, params.m_step);
+    WriteFloat(m_sink, params.m_baseGtoPScale);
+  }
+
+  void Write(PathTextShape const & shape)
+  {
+    WriteHeader(ShapeKind::PathText, shape);
+    WriteSpline(shape.m_spline);
+    auto const & params = shape.m_params;
+    WriteOverlayParams(params);
+    WriteFont(m_sink, params.m_textFont);
+    rw::Write(m_sink, params.m_mainText);
+    rw::Write(m_sink, params.m_auxText);
+    WriteFloat(m_sink, params.m_baseGtoPScale);
+    WriteVarUint(m_sink, shape.m_baseTextIndex);
+  }
+
+  void Write(PoiSymbolShape const & shape)
+  {
+    WriteHeader(ShapeKind::PoiSymbol, shape);
+    WritePoint(m_sink, shape.m_pt);
+    auto const & params = shape.m_params;
+    WriteOverlayParams(params);
+    rw::Write(m_sink, params.m_symbolName);
+    WriteVarUint(m_sink, params.m_extendingSize);
+    WriteFloat(m_sink, params.m_posZ);
+    WriteBool(m_sink, params.m_hasArea);
+    WriteBool(m_sink, params.m_prioritized);
+    rw::Write(m_sink, params.m_maskColor);
+    WriteEnum(m_sink, params.m_anchor);
+    WritePoint(m_sink, params.m_offset);
+    WriteFloat(m_sink, params.m_pixelWidth);
+    WriteVarUint(m_sink, shape.m_textIndex);
+  }
+
+  void Write(TextShape const & shape)
+  {
+    // Such shapes are generated for the tests only.
+    if (shape.m_disableDisplacing)
+    {
+      m_isValid = false;
+      return;
+    }
+
+    WriteHeader(ShapeKind::Text, shape);
+    WritePoint(m_sink, shape.m_basePoint);
+    auto const & params = shape.m_params;
+    WriteOverlayParams(params);
+    auto const & title = params.m_titleDecl;
+    WriteFont(m_sink, title.m_primaryTextFont);
+    rw::Write(m_sink, title.m_primaryText);
+    WriteFont(m_sink, title.m_secondaryTextFont);
+    rw::Write(m_sink, title.m_secondaryText);
+    WriteEnum(m_sink, title.m_anchor);
+    WriteBool(m_sink, title.m_forceNoWrap);
+    WritePoint(m_sink, title.m_primaryOffset);
+    WritePoint(m_sink, title.m_secondaryOffset);
+    WriteBool(m_sink, title.m_primaryOptional);
+    WriteBool(m_sink, title.m_secondaryOptional);
+    WriteBool(m_sink, params.m_hasArea);
+    WriteBool(m_sink, params.m_createdByEditor);
+    WriteVarUint(m_sink, params.m_extendingSize);
+    WriteFloat(m_sink, params.m_posZ);
+    WriteBool(m_sink, params.m_limitedText);
+    WritePoint(m_sink, params.m_limits);
+    WritePoints(m_sink, shape.m_symbolSizes);
+    WriteEnum(m_sink, shape.m_symbolAnchor);
+    WritePoint(m_sink, shape.m_symbolOffset);
+    WriteVarUint(m_sink, shape.m_textIndex);
+  }
+
+  std::map<MwmSet::MwmId, uint32_t> const & m_mwmIndices;
+  Sink m_sink;
+  bool m_isValid = true;
+};
+
+// TileShapesCache::Recorder -----------------------------------------------------------------------
+TileShapesCache::Recorder::Recorder(std::vector<FeatureID> const & features)
+{
+  auto const mwms = GetMwms(features);
+  for (uint32_t i = 0; i < mwms.size(); ++i)
+    m_mwmIndices.emplace(mwms[i], i);
+}
+
+void TileShapesCache::Recorder::AddShapes(TMapShapes const & shapes)
+{
+  if (!m_isValid)
+    return;
+
+  TileShapesWriter writer(m_mwmIndices, m_shapes);
+  for (auto const & shape : shapes)
+  {
+    if (!writer.Write(*shape))
+    {
+      m_isValid = false;
+      return;
+    }
+    ++m_shapesCount;
+  }
+}
+
+void TileShapesCache::Recorder::AddTrafficGeometry(TrafficSegmentsGeometry const & geometry)
+{
+  if (!m_isValid)
+    return;
+
+  TileShapesWriter writer(m_mwmIndices, m_trafficGeometry);
+  for (auto const & [mwmId, segments] : geometry)
+  {
+    for (auto const & [segmentId, segment] : segments)
+    {
+      if (!writer.Write(mwmId, segmentId, segment))
+      {
+        m_isValid = false;
+        return;
+      }
+      ++m_segmentsCount;
+    }
+  }
+}
+
+// TileShapesCache ---------------------------------------------------------------------------------
+TileShapesCache::TileShapesCache(std::string const & dir, size_t maxTilesCount)
+  : m_dir(dir), m_maxTilesCount(maxTilesCount)
+{
+  ASSERT_GREATER(m_maxTilesCount, 0, ());
+  if (!Platform::MkDirChecked(m_dir))
+  {
+    LOG(LWARNING, ("Can't create tile shapes cache directory", m_dir));
+    return;
+  }
+
+  // Files of the interrupted saving.
+  Platform::FilesList files;
+  Platform::GetFilesByExt(m_dir, kTmpFileExtension, files);
+  for (auto const & file : files)
+    base::DeleteFileX(base::JoinPath(m_dir, file));
+
+  try
+  {
+    std::string const generationPath = base::JoinPath(m_dir, kGenerationFileName);
+    if (Platform::IsFileExistsByFullPath(generationPath))
+    {
+      FileReader reader(generationPath);
+      ReaderSource<FileReader> src(reader);
+      m_generation = ReadPrimitiveFromSource<uint64_t>(src);
+    }
+  }
+  catch (RootException const & e)
+  {
+    LOG(LWARNING, ("Can't read tile shapes cache generation", e.Msg()));
+  }
+
+  // Access time is unknown, the tiles are evicted in the order of the listing.
+  files.clear();
+  Platform::GetFilesByExt(m_dir, kTileFileExtension, files);
+  for (auto const & file : files)
+    Touch(base::JoinPath(m_dir, file));
+}
+
+std::string TileShapesCache::GetTilePath(TileKey const & tileKey) const
+{
+  return base::JoinPath(m_dir, strings::to_string(tileKey.m_zoomLevel) + "_" +
+                                   strings::to_string(tileKey.m_x) + "_" +
+                                   strings::to_string(tileKey.m_y) + kTileFileExtension);
+}
+
+void TileShapesCache::Touch(std::string const & path)
+{
+  auto const it = m_tilesIndex.find(path);
+  if (it != m_tilesIndex.end())
+  {
+    m_tiles.splice(m_tiles.end(), m_tiles, it->second);
+    return;
+  }
+
+  m_tilesIndex.emplace(path, m_tiles.insert(m_tiles.end(), path));
+  while (m_tiles.size() > m_maxTilesCount)
+  {
+    base::DeleteFileX(m_tiles.front());
+    m_tilesIndex.erase(m_tiles.front());
+    m_tiles.pop_front();
+  }
+}
+
+bool TileShapesCache::Load(TileKey const & tileKey, std::string const & context,
+                           std::vector<FeatureID> const & features,
+                           ref_ptr<dp::TextureManager> texMng, CachedTileShapes & shapes)
+{
+  std::string const path = GetTilePath(tileKey);
+  uint64_t generation;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_tilesIndex.find(path) == m_tilesIndex.end())
+      return false;
+    generation = m_generation;
+  }
+
+  auto const key = MakeKey(generation, context, features);
+  Buffer data;
+  try
+  {
+    FileReader reader(path);
+    if (reader.Size() <= key.size())
+      return false;
+    data.resize(static_cast<size_t>(reader.Size()));
+    reader.Read(0, data.data(), data.size());
+  }
+  catch (RootException const & e)
+  {
+    LOG(LDEBUG, ("Can't read cached tile", path, e.Msg()));
+    return false;
+  }
+
+  if (!std::equal(key.begin(), key.end(), data.begin()))
+    return false;
+
+  Buffer body;
+  coding::ZLib::Inflate inflate(coding::ZLib::Inflate::Format::ZLib);
+  if (!inflate(data.data() + key.size(), data.size() - key.size(), std::back_inserter(body)))
+    return false;
+
+  try
+  {
+    auto const mwms = GetMwms(features);
+    FeatureIdReader const readId(mwms);
+    Source src(MemReaderWithExceptions(body.data(), body.size()));
+
+    uint32_t const shapesCount = ReadVarUint<uint32_t>(src);
+    for (uint32_t i = 0; i < shapesCount; ++i)
+    {
+      auto shape = ReadShape(src, tileKey, readId, texMng);
+      if (shape == nullptr)
+        continue;
+      auto & dst = shape->GetType() == MapShapeType::OverlayType ? shapes.m_overlayShapes
+                                                                  : shapes.m_geometryShapes;
+      dst.push_back(std::move(shape));
+    }
+
+    uint32_t const segmentsCount = ReadVarUint<uint32_t>(src);
+    for (uint32_t i = 0; i < segmentsCount; ++i)
+    {
+      auto const mwmId = readId.ReadMwm(src);
+      uint32_t const fid = ReadVarUint<uint32_t>(src);
+      uint16_t const idx = ReadPrimitiveFromSource<uint16_t>(src);
+      uint8_t const dir = ReadPrimitiveFromSource<uint8_t>(src);
+      std::vector<m2::PointD> points;
+      ReadPoints(src, points, &ReadPointD);
+      auto const roadClass = ReadEnum<RoadClass>(src);
+      shapes.m_trafficGeometry[mwmId].emplace_back(
+          traffic::TrafficInfo::RoadSegmentId(fid, idx, dir),
+          TrafficSegmentGeometry(m2::PolylineD(std::move(points)), roadClass));
+    }
+  }
+  catch (RootException const & e)
+  {
+    LOG(LWARNING, ("Broken cached tile", path, e.Msg()));
+    shapes = {};
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_tilesIndex.find(path) != m_tilesIndex.end())
+    Touch(path);
+  return true;
+}
+
+void TileShapesCache::Save(TileKey const & tileKey, std::string const & context,
+                           std::vector<FeatureID> const & features, Recorder const & recorder,
+                           uint64_t generation)
+{
+  if (!recorder.m_isValid)
+    return;
+
+  Buffer body;
+  {
+    Sink sink(body);
+    WriteVarUint(sink, recorder.m_shapesCount);
+    sink.Write(recorder.m_shapes.data(), recorder.m_shapes.size());
+    WriteVarUint(sink, recorder.m_segmentsCount);
+    sink.Write(recorder.m_trafficGeometry.data(), recorder.m_trafficGeometry.size());
+  }
+
+  auto data = MakeKey(generation, context, features);
+  coding::ZLib::Deflate deflate(coding::ZLib::Deflate::Format::ZLib,
+                                coding::ZLib::Deflate::Level::BestSpeed);
+  if (!deflate(body.data(), body.size(), std::back_inserter(data)))
+    return;
+
+  std::string const path = GetTilePath(tileKey);
+  std::string tmpPath;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (generation != m_generation)
+      return;
+    tmpPath = path + "." + strings::to_string(m_tmpFilesCounter++) + kTmpFileExtension;
+  }
+
+  try
+  {
+    FileWriter writer(tmpPath);
+    writer.Write(data.data(), data.size());
+  }
+  catch (RootException const & e)
+  {
+    LOG(LWARNING, ("Can't write cached tile", tmpPath, e.Msg()));
+    base::DeleteFileX(tmpPath);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (generation != m_generation || !base::RenameFileX(tmpPath, path))
+  {
+    base::DeleteFileX(tmpPath);
+    return;
+  }
+  Touch(path);
+}
+
+uint64_t TileShapesCache::GetGeneration() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_generation;
+}
+
+void TileShapesCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_generation;
+  try
+  {
+    FileWriter writer(base::JoinPath(m_dir, kGenerationFileName));
+    WriteToSink(writer, m_generation);
+  }
+  catch (RootException const & e)
+  {
+    // Cached tiles may be out of date after restart, so they are removed.
+    LOG(LWARNING, ("Can't write tile shapes cache generation", e.Msg()));
+    for (auto const & path : m_tiles)
+      base::DeleteFileX(path);
+    m_tiles.clear();
+    m_tilesIndex.clear();
+  }
+}
+}  // namespace df
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "drape_frontend/map_shape.hpp"
+#include "drape_frontend/tile_key.hpp"
+#include "drape_frontend/traffic_generator.hpp"
+
+#include "drape/pointers.hpp"
+
+#include "indexer/feature_decl.hpp"
+#include "indexer/mwm_set.hpp"
+
+#include "base/macros.hpp"
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dp
+{
+class TextureManager;
+}  // namespace dp
+
+namespace df
+{
+struct CachedTileShapes
+{
+  TMapShapes m_geometryShapes;
+  TMapShapes m_overlayShapes;
+  TrafficSegmentsGeometry m_trafficGeometry;
+};
+
+// Persistent cache of the shapes generated for the tiles. Shapes are stored as the view params
+// they are constructed from, the vertices are generated on loading. So cached shapes don't depend
+// on the textures and fonts of the session, but the features are not read and styled again.
+// A tile is taken from the cache if it has the same features of the same mwm versions and it was
+// generated in the same context (style, language, visual scale, etc.).
+class TileShapesCache
+{
+public:
+  // Collects the shapes of the tile being generated.
+  class Recorder
+  {
+  public:
+    // |features| must be sorted.
+    explicit Recorder(std::vector<FeatureID> const & features);
+
+    void AddShapes(TMapShapes const & shapes);
+    void AddTrafficGeometry(TrafficSegmentsGeometry const & geometry);
+
+  private:
+    friend class TileShapesCache;
+
+    std::map<MwmSet::MwmId, uint32_t> m_mwmIndices;
+    std::vector<uint8_t> m_shapes;
+    uint32_t m_shapesCount = 0;
+    std::vector<uint8_t> m_trafficGeometry;
+    uint32_t m_segmentsCount = 0;
+    // False if the tile has a shape which can't be cached.
+    bool m_isValid = true;
+  };
+
+  TileShapesCache(std::string const & dir, size_t maxTilesCount);
+
+  /// @param context - everything but the features which the shapes depend on.
+  /// @param features - sorted features of the tile.
+  /// @returns false if the tile is not cached or the cached one is out of date.
+  bool Load(TileKey const & tileKey, std::string const & context,
+            std::vector<FeatureID> const & features, ref_ptr<dp::TextureManager> texMng,
+            CachedTileShapes & shapes);
+
+  /// Stores the tile if the cache was not cleared since |generation| was taken.
+  void Save(TileKey const & tileKey, std::string const & context,
+            std::vector<FeatureID> const & features, Recorder const & recorder,
+            uint64_t generation);
+
+  uint64_t GetGeneration() const;
+
+  /// Makes all the cached tiles out of date, e.g. when the features are edited.
+  /// Files of the tiles are overwritten or evicted later, so it's cheap to call.
+  void Clear();
+
+private:
+  DISALLOW_COPY_AND_MOVE(TileShapesCache);
+
+  std::string GetTilePath(TileKey const & tileKey) const;
+  // Must be called under the lock.
+  void Touch(std::string const & path);
+
+  std::string const m_dir;
+  size_t const m_maxTilesCount;
+
+  mutable std::mutex m_mutex;
+  // Persistent counter of the Clear() calls, it's a part of the key of the tiles.
+  uint64_t m_generation = 0;
+  uint64_t m_tmpFilesCounter = 0;
+  // Paths of the cached tiles, the least recently used ones are in the front.
+  std::list<std::string> m_tiles;
+  std::unordered_map<std::string, std::list<std::string>::iterator> m_tilesIndex;
+};
+}  // namespace df
@@ -17,6 +17,17 @@ std::unique_ptr<FeatureType> EditableFeatureSource::GetModifiedFeature(uint32_t
   return {};
 }
 
+bool EditableFeatureSource::GetModifiedFeature(uint32_t index, FeatureType & ft) const
+{
+  osm::Editor & editor = osm::Editor::Instance();
+  auto const emo = editor.GetEditedFeature(FeatureID(m_handle.GetId(), index));
+  if (!emo)
+    return false;
+
+  ft.ResetFromMapObject(*emo);
+  return true;
+}
+
 void EditableFeatureSource::ForEachAdditionalFeature(m2::RectD const & rect, int scale,
                                                      std::function<void(uint32_t)> const & fn) const
 {
@@ -2,19 +2,47 @@
 
 #include "platform/platform.hpp"
 
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
 #include "coding/internal/file_data.hpp"
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/writer.hpp"
 
 #include "base/logging.hpp"
 
+#include <sstream>
 #include <string>
+#include <vector>
 
 using namespace pugi;
 
 namespace
 {
 char const * kEditorXMLFileName = "edits.xml";
+char const * kEditorJournalFileName = "edits.journal";
 
 std::string GetEditorFilePath() { return GetPlatform().WritablePathForFile(kEditorXMLFileName); }
+std::string GetJournalFilePath() { return GetPlatform().WritablePathForFile(kEditorJournalFileName); }
+
+std::string SerializeRecord(xml_document const & record)
+{
+  std::ostringstream out;
+  record.save(out, "" /* indent */, format_raw | format_no_declaration);
+  return out.str();
+}
+
+void TruncateFile(std::string const & path, uint64_t size)
+{
+  try
+  {
+    base::FileData(path, base::FileData::OP_WRITE_EXISTING).Truncate(size);
+  }
+  catch (RootException const & ex)
+  {
+    LOG(LERROR, ("Can't truncate", path, ex.Msg()));
+  }
+}
 }  // namespace
 
 namespace editor
@@ -26,9 +54,17 @@ bool LocalStorage::Save(xml_document const & doc)
 
   std::lock_guard<std::mutex> guard(m_mutex);
 
-  return base::WriteToTempAndRenameToFile(editorFilePath, [&doc](std::string const & fileName) {
+  auto const saved = base::WriteToTempAndRenameToFile(editorFilePath, [&doc](std::string const & fileName) {
     return doc.save_file(fileName.data(), "  " /* indent */);
   });
+  if (!saved)
+    return false;
+
+  // The journal is already a part of the saved snapshot.
+  base::DeleteFileX(GetJournalFilePath());
+  m_position = {m_position.m_generation + 1, 0 /* recordsCount */, 0 /* size */};
+  m_isPositionKnown = true;
+  return true;
 }
 
 bool LocalStorage::Load(xml_document & doc)
@@ -49,28 +85,254 @@ bool LocalStorage::Load(xml_document & doc)
 }
 
 bool LocalStorage::Reset()
+{
+  auto const editorFilePath = GetEditorFilePath();
+  auto const journalFilePath = GetJournalFilePath();
+
+  std::lock_guard<std::mutex> guard(m_mutex);
+
+  m_position = {m_position.m_generation + 1, 0 /* recordsCount */, 0 /* size */};
+  m_isPositionKnown = true;
+
+  // Edits may be stored in the journal only, so a missing snapshot is ok.
+  auto const & platform = GetPlatform();
+  bool const journalDeleted =
+      !platform.IsFileExistsByFullPath(journalFilePath) || base::DeleteFileX(journalFilePath);
+  return journalDeleted &&
+         (!platform.IsFileExistsByFullPath(editorFilePath) || base::DeleteFileX(editorFilePath));
+}
+
+bool LocalStorage::AppendToJournal(xml_document const & record)
+{
+  auto const data = SerializeRecord(record);
+  std::vector<uint8_t> buffer;
+  {
+    MemWriter<std::vector<uint8_t>> writer(buffer);
+    WriteVarUint(writer, data.size());
+    writer.Write(data.data(), data.size());
+  }
+  auto const journalFilePath = GetJournalFilePath();
+
+  std::lock_guard<std::mutex> guard(m_mutex);
+
+  // Drops a broken tail left by an interrupted write.
+  if (!m_isPositionKnown && !ReadJournal(nullptr /* journal */))
+    return false;
+
+  try
+  {
+    FileWriter writer(journalFilePath, FileWriter::OP_APPEND);
+    writer.Write(buffer.data(), buffer.size());
+    writer.Flush();
+  }
+  catch (Writer::Exception const & ex)
+  {
+    LOG(LERROR, ("Can't append map edit to", journalFilePath, ex.Msg()));
+    TruncateFile(journalFilePath, m_position.m_size);
+    return false;
+  }
+
+  ++m_position.m_recordsCount;
+  m_position.m_size += buffer.size();
+  return true;
+}
+
+bool LocalStorage::LoadJournal(xml_document & journal)
+{
+  std::lock_guard<std::mutex> guard(m_mutex);
+
+  return ReadJournal(&journal);
+}
+
+StorageBase::JournalPosition LocalStorage::GetJournalPosition()
 {
   std::lock_guard<std::mutex> guard(m_mutex);
 
-  return base::DeleteFileX(GetEditorFilePath());
+  if (!m_isPositionKnown)
+    ReadJournal(nullptr /* journal */);
+
+  return m_position;
+}
+
+bool LocalStorage::Compact(xml_document const & doc, JournalPosition const & position)
+{
+  auto const editorFilePath = GetEditorFilePath();
+  auto const journalFilePath = GetJournalFilePath();
+  auto const snapshotTmpPath = editorFilePath + ".compact.tmp";
+  auto const journalTmpPath = journalFilePath + ".compact.tmp";
+
+  // The snapshot is the heavy part, so it is written without blocking the appends.
+  if (!doc.save_file(snapshotTmpPath.c_str(), "  " /* indent */))
+  {
+    base::DeleteFileX(snapshotTmpPath);
+    return false;
+  }
+
+  std::lock_guard<std::mutex> guard(m_mutex);
+
+  if (!m_isPositionKnown || m_position.m_generation != position.m_generation ||
+      m_position.m_size < position.m_size)
+  {
+    LOG(LINFO, ("Map edits journal has been reset during compaction."));
+    base::DeleteFileX(snapshotTmpPath);
+    return false;
+  }
+
+  uint64_t const tailSize = m_position.m_size - position.m_size;
+  try
+  {
+    std::vector<char> tail(static_cast<size_t>(tailSize));
+    if (tailSize != 0)
+      FileReader(journalFilePath).Read(position.m_size, tail.data(), tail.size());
+
+    FileWriter writer(journalTmpPath);
+    writer.Write(tail.data(), tail.size());
+  }
+  catch (RootException const & ex)
+  {
+    LOG(LERROR, ("Can't compact map edits journal", ex.Msg()));
+    base::DeleteFileX(snapshotTmpPath);
+    base::DeleteFileX(journalTmpPath);
+    return false;
+  }
+
+  // Replaying of the records which are already in the snapshot is harmless,
+  // so the snapshot is replaced first.
+  if (!base::RenameFileX(snapshotTmpPath, editorFilePath) ||
+      !base::RenameFileX(journalTmpPath, journalFilePath))
+  {
+    base::DeleteFileX(snapshotTmpPath);
+    base::DeleteFileX(journalTmpPath);
+    return false;
+  }
+
+  m_position.m_recordsCount -= position.m_recordsCount;
+  m_position.m_size = tailSize;
+  return true;
+}
+
+bool LocalStorage::ReadJournal(xml_document * journal)
+{
+  auto const journalFilePath = GetJournalFilePath();
+
+  m_position.m_recordsCount = 0;
+  m_position.m_size = 0;
+  m_isPositionKnown = true;
+
+  if (!GetPlatform().IsFileExistsByFullPath(journalFilePath))
+    return true;
+
+  uint64_t fileSize = 0;
+  try
+  {
+    FileReader reader(journalFilePath);
+    fileSize = reader.Size();
+    ReaderSource<FileReader> src(reader);
+    std::string data;
+    while (src.Size() > 0)
+    {
+      auto const size = ReadVarUint<uint64_t>(src);
+      if (size > src.Size())
+        break;
+
+      data.resize(static_cast<size_t>(size));
+      src.Read(data.data(), data.size());
+
+      if (journal)
+      {
+        xml_document record;
+        if (record.load_buffer(data.data(), data.size()).status != status_ok)
+          break;
+        journal->append_copy(record.document_element());
+      }
+
+      m_position.m_size = src.Pos();
+      ++m_position.m_recordsCount;
+    }
+  }
+  catch (Reader::Exception const & ex)
+  {
+    LOG(LWARNING, ("Map edits journal is truncated:", ex.Msg()));
+  }
+
+  if (m_position.m_size != fileSize)
+  {
+    LOG(LWARNING, ("Dropping broken tail of map edits journal", journalFilePath));
+    TruncateFile(journalFilePath, m_position.m_size);
+  }
+
+  return true;
 }
 
 // StorageMemory -----------------------------------------------------------------------------------
 bool InMemoryStorage::Save(xml_document const & doc)
 {
+  std::lock_guard<std::mutex> guard(m_mutex);
+
   m_doc.reset(doc);
+  m_journal.reset();
+  m_position = {m_position.m_generation + 1, 0 /* recordsCount */, 0 /* size */};
   return true;
 }
 
 bool InMemoryStorage::Load(xml_document & doc)
 {
+  std::lock_guard<std::mutex> guard(m_mutex);
+
   doc.reset(m_doc);
   return true;
 }
 
 bool InMemoryStorage::Reset()
 {
+  std::lock_guard<std::mutex> guard(m_mutex);
+
   m_doc.reset();
+  m_journal.reset();
+  m_position = {m_position.m_generation + 1, 0 /* recordsCount */, 0 /* size */};
+  return true;
+}
+
+bool InMemoryStorage::AppendToJournal(xml_document const & record)
+{
+  auto const size = SerializeRecord(record).size();
+
+  std::lock_guard<std::mutex> guard(m_mutex);
+
+  m_journal.append_copy(record.document_element());
+  ++m_position.m_recordsCount;
+  m_position.m_size += size;
+  return true;
+}
+
+bool InMemoryStorage::LoadJournal(xml_document & journal)
+{
+  std::lock_guard<std::mutex> guard(m_mutex);
+
+  journal.reset(m_journal);
+  return true;
+}
+
+StorageBase::JournalPosition InMemoryStorage::GetJournalPosition()
+{
+  std::lock_guard<std::mutex> guard(m_mutex);
+
+  return m_position;
+}
+
+bool InMemoryStorage::Compact(xml_document const & doc, JournalPosition const & position)
+{
+  std::lock_guard<std::mutex> guard(m_mutex);
+
+  if (m_position.m_generation != position.m_generation)
+    return false;
+
+  m_doc.reset(doc);
+  for (size_t i = 0; i < position.m_recordsCount; ++i)
+    m_journal.remove_child(m_journal.first_child());
+
+  m_position.m_recordsCount -= position.m_recordsCount;
+  m_position.m_size -= position.m_size;
   return true;
 }
 }  // namespace editor
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
 
 #include <pugixml.hpp>
@@ -7,14 +9,35 @@
 namespace editor
 {
 // Editor storage interface.
+// Edits are kept as a snapshot document plus a journal of records appended after it.
+// Every journal record is a document with changes of a single feature, records are applied
+// on top of the snapshot in the order they were appended.
 class StorageBase
 {
 public:
+  struct JournalPosition
+  {
+    // Is changed by every Save() and Reset(), so an outdated compaction can be detected.
+    uint64_t m_generation = 0;
+    size_t m_recordsCount = 0;
+    uint64_t m_size = 0;
+  };
+
   virtual ~StorageBase() = default;
 
+  // Saves snapshot and clears the journal.
   virtual bool Save(pugi::xml_document const & doc) = 0;
   virtual bool Load(pugi::xml_document & doc) = 0;
   virtual bool Reset() = 0;
+
+  virtual bool AppendToJournal(pugi::xml_document const & record) = 0;
+  // Loads journal records as top level children of |journal|.
+  virtual bool LoadJournal(pugi::xml_document & journal) = 0;
+  virtual JournalPosition GetJournalPosition() = 0;
+  // Replaces snapshot with |doc| which already contains all the journal records up to |position|
+  // and removes these records from the journal. Records appended after |position| are kept.
+  // Returns false and keeps the storage intact when the journal was reset after |position|.
+  virtual bool Compact(pugi::xml_document const & doc, JournalPosition const & position) = 0;
 };
 
 // Class which saves/loads edits to/from local file.
@@ -26,13 +49,22 @@ public:
   bool Save(pugi::xml_document const & doc) override;
   bool Load(pugi::xml_document & doc) override;
   bool Reset() override;
+  bool AppendToJournal(pugi::xml_document const & record) override;
+  bool LoadJournal(pugi::xml_document & journal) override;
+  JournalPosition GetJournalPosition() override;
+  bool Compact(pugi::xml_document const & doc, JournalPosition const & position) override;
 
 private:
+  // Reads journal records and updates |m_position|. Must be called under |m_mutex|.
+  bool ReadJournal(pugi::xml_document * journal);
+
   std::mutex m_mutex;
+  JournalPosition m_position;
+  bool m_isPositionKnown = false;
 };
 
 // Class which saves/loads edits to/from xml_document class instance.
-// Note: this class is NOT thread-safe.
+// Note: this class IS thread-safe.
 class InMemoryStorage : public StorageBase
 {
 public:
@@ -40,8 +72,15 @@ public:
   bool Save(pugi::xml_document const & doc) override;
   bool Load(pugi::xml_document & doc) override;
   bool Reset() override;
+  bool AppendToJournal(pugi::xml_document const & record) override;
+  bool LoadJournal(pugi::xml_document & journal) override;
+  JournalPosition GetJournalPosition() override;
+  bool Compact(pugi::xml_document const & doc, JournalPosition const & position) override;
 
 private:
+  std::mutex m_mutex;
   pugi::xml_document m_doc;
+  pugi::xml_document m_journal;
+  JournalPosition m_position;
 };
 }  // namespace editor
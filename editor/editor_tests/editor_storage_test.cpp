@@ -0,0 +1,188 @@
+#include "testing/testing.hpp"
+
+#include "editor/editor_storage.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_writer.hpp"
+
+#include "base/logging.hpp"
+#include "base/scope_guard.hpp"
+#include "base/timer.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace editor_storage_test
+{
+using namespace editor;
+using namespace pugi;
+
+void AppendFeature(xml_node mwm, uint32_t index)
+{
+  auto node = mwm.child("modify");
+  if (!node)
+    node = mwm.append_child("modify");
+  node = node.append_child("node");
+  node.append_attribute("lat") = 54.0446163;
+  node.append_attribute("lon") = 27.6597626;
+  node.append_attribute("mwm_file_index") = index;
+  node.append_attribute("timestamp") = "2022-12-09T18:58:28Z";
+
+  auto tag = node.append_child("tag");
+  tag.append_attribute("k") = "amenity";
+  tag.append_attribute("v") = "cafe";
+  tag = node.append_child("tag");
+  tag.append_attribute("k") = "name";
+  tag.append_attribute("v") = ("Cafe " + std::to_string(index)).c_str();
+}
+
+void MakeRecord(uint32_t index, xml_document & record)
+{
+  record.reset();
+  auto mwm = record.append_child("omaps").append_child("mwm");
+  mwm.append_attribute("name") = "TestCountry";
+  AppendFeature(mwm, index);
+}
+
+std::vector<uint32_t> LoadJournalIndexes(StorageBase & storage)
+{
+  xml_document journal;
+  TEST(storage.LoadJournal(journal), ());
+
+  std::vector<uint32_t> indexes;
+  for (auto const & record : journal.children("omaps"))
+  {
+    auto const node = record.child("mwm").child("modify").child("node");
+    indexes.push_back(node.attribute("mwm_file_index").as_uint());
+  }
+  return indexes;
+}
+
+void TestJournal(StorageBase & storage)
+{
+  TEST(storage.Reset(), ());
+  SCOPE_GUARD(resetGuard, [&storage] { storage.Reset(); });
+
+  xml_document record;
+  for (uint32_t i = 0; i < 3; ++i)
+  {
+    MakeRecord(i, record);
+    TEST(storage.AppendToJournal(record), ());
+  }
+  TEST_EQUAL(LoadJournalIndexes(storage), std::vector<uint32_t>({0, 1, 2}), ());
+
+  auto const position = storage.GetJournalPosition();
+  TEST_EQUAL(position.m_recordsCount, 3, ());
+
+  // A record appended during compaction stays in the journal.
+  MakeRecord(3, record);
+  TEST(storage.AppendToJournal(record), ());
+
+  xml_document snapshot;
+  snapshot.append_child("omaps").append_attribute("compacted") = true;
+  TEST(storage.Compact(snapshot, position), ());
+  TEST_EQUAL(LoadJournalIndexes(storage), std::vector<uint32_t>({3}), ());
+  TEST_EQUAL(storage.GetJournalPosition().m_recordsCount, 1, ());
+
+  xml_document loaded;
+  TEST(storage.Load(loaded), ());
+  TEST(loaded.child("omaps").attribute("compacted").as_bool(), ());
+
+  // Compaction of a journal which was reset by a full save is skipped.
+  auto const outdated = storage.GetJournalPosition();
+  xml_document saved;
+  saved.append_child("omaps").append_attribute("saved") = true;
+  TEST(storage.Save(saved), ());
+  TEST(LoadJournalIndexes(storage).empty(), ());
+  TEST(!storage.Compact(snapshot, outdated), ());
+
+  TEST(storage.Load(loaded), ());
+  TEST(loaded.child("omaps").attribute("saved").as_bool(), ());
+}
+
+UNIT_TEST(EditorStorage_InMemoryJournal)
+{
+  InMemoryStorage storage;
+  TestJournal(storage);
+}
+
+UNIT_TEST(EditorStorage_LocalJournal)
+{
+  LocalStorage storage;
+  TestJournal(storage);
+}
+
+UNIT_TEST(EditorStorage_LocalJournalBrokenTail)
+{
+  {
+    LocalStorage storage;
+    TEST(storage.Reset(), ());
+  }
+  SCOPE_GUARD(resetGuard, [] { LocalStorage().Reset(); });
+
+  xml_document record;
+  {
+    LocalStorage storage;
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+      MakeRecord(i, record);
+      TEST(storage.AppendToJournal(record), ());
+    }
+  }
+
+  // Emulate a write interrupted in the middle of a record.
+  {
+    FileWriter writer(GetPlatform().WritablePathForFile("edits.journal"), FileWriter::OP_APPEND);
+    std::string const partial = "\x20<omaps";
+    writer.Write(partial.data(), partial.size());
+  }
+
+  {
+    LocalStorage storage;
+    TEST_EQUAL(LoadJournalIndexes(storage), std::vector<uint32_t>({0, 1}), ());
+    MakeRecord(2, record);
+    TEST(storage.AppendToJournal(record), ());
+  }
+
+  LocalStorage storage;
+  TEST_EQUAL(LoadJournalIndexes(storage), std::vector<uint32_t>({0, 1, 2}), ());
+}
+
+// Compares the latency of saving one more edit by rewriting the whole edits file
+// with appending it to the journal, depending on the number of already stored edits.
+UNIT_TEST(EditorStorage_SaveLatencyBenchmark)
+{
+  LocalStorage storage;
+  TEST(storage.Reset(), ());
+  SCOPE_GUARD(resetGuard, [&storage] { storage.Reset(); });
+
+  size_t constexpr kSavesCount = 10;
+  xml_document record;
+  for (uint32_t const editsCount : {100, 1000, 10000})
+  {
+    xml_document doc;
+    auto mwm = doc.append_child("omaps").append_child("mwm");
+    mwm.append_attribute("name") = "TestCountry";
+    for (uint32_t i = 0; i < editsCount; ++i)
+      AppendFeature(mwm, i);
+
+    base::Timer timer;
+    for (size_t i = 0; i < kSavesCount; ++i)
+      TEST(storage.Save(doc), ());
+    double const fullSaveMs = timer.ElapsedSeconds() * 1000.0 / kSavesCount;
+
+    timer.Reset();
+    for (size_t i = 0; i < kSavesCount; ++i)
+    {
+      MakeRecord(editsCount + static_cast<uint32_t>(i), record);
+      TEST(storage.AppendToJournal(record), ());
+    }
+    double const appendMs = timer.ElapsedSeconds() * 1000.0 / kSavesCount;
+
+    LOG(LINFO, ("Stored edits:", editsCount, "full save:", fullSaveMs, "ms, journal append:",
+                appendMs, "ms"));
+  }
+}
+}  // namespace editor_storage_test
@@ -85,6 +85,14 @@ public:
     return InMemoryStorage::Reset();
   }
 
+  bool AppendToJournal(pugi::xml_document const & record) override
+  {
+    if (!m_allowSave)
+      return false;
+
+    return InMemoryStorage::AppendToJournal(record);
+  }
+
 private:
   bool m_allowSave = true;
 };
@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <array>
 #include <sstream>
+#include <unordered_map>
 
 #include "3party/opening_hours/opening_hours.hpp"
 #include <pugixml.hpp>
@@ -47,6 +48,11 @@ constexpr char const * kDeleteSection = "delete";
 constexpr char const * kModifySection = "modify";
 constexpr char const * kCreateSection = "create";
 constexpr char const * kObsoleteSection = "obsolete";
+/// Journal records use this section for features whose edits were removed.
+constexpr char const * kRemoveSection = "remove";
+constexpr char const * kFeatureIndexAttr = "mwm_file_index";
+/// Journal is compacted into the snapshot when it has more records.
+size_t constexpr kMaxJournalRecords = 256;
 /// We store edited streets in OSM-compatible way.
 constexpr char const * kAddrStreetTag = "addr:street";
 
@@ -71,6 +77,105 @@ std::array<XmlSection, 4> const kXmlSections = {{{FeatureStatus::Deleted, kDelet
                                                  {FeatureStatus::Obsolete, kObsoleteSection},
                                                  {FeatureStatus::Created, kCreateSection}}};
 
+char const * GetSectionName(FeatureStatus status)
+{
+  for (auto const & section : kXmlSections)
+  {
+    if (section.m_status == status)
+      return section.m_sectionName.c_str();
+  }
+  CHECK(false, ("Not edited features shouldn't be here."));
+  return nullptr;
+}
+
+xml_node GetOrCreateRootNode(xml_document & doc)
+{
+  auto root = doc.child(kXmlRootNode);
+  // Migrate clients with an old root node.
+  if (!root)
+    root = doc.child("mapsme");
+  if (!root)
+  {
+    root = doc.append_child(kXmlRootNode);
+    // Use format_version for possible future format changes.
+    root.append_attribute("format_version") = 1;
+  }
+  return root;
+}
+
+// Applies journal records on top of the edits snapshot. Every record contains the last state of
+// a single feature, so replaying replaces or removes the feature node with the same index.
+void ApplyJournal(xml_document & doc, xml_document const & journal)
+{
+  if (!journal.first_child())
+    return;
+
+  struct MwmNode
+  {
+    xml_node m_node;
+    std::unordered_map<uint32_t, xml_node> m_features;
+  };
+
+  auto root = GetOrCreateRootNode(doc);
+  std::map<string, MwmNode> mwms;
+  auto const getMwmNode = [&root, &mwms](string const & name) -> MwmNode &
+  {
+    auto it = mwms.find(name);
+    if (it != mwms.end())
+      return it->second;
+
+    auto & mwm = mwms[name];
+    mwm.m_node = root.find_child_by_attribute(kXmlMwmNode, "name", name.c_str());
+    if (!mwm.m_node)
+    {
+      mwm.m_node = root.append_child(kXmlMwmNode);
+      mwm.m_node.append_attribute("name") = name.c_str();
+    }
+
+    for (auto const & section : kXmlSections)
+    {
+      for (auto const & feature : mwm.m_node.child(section.m_sectionName.c_str()).children())
+        mwm.m_features[feature.attribute(kFeatureIndexAttr).as_uint()] = feature;
+    }
+    return mwm;
+  };
+
+  for (auto const & record : journal.children(kXmlRootNode))
+  {
+    for (auto const & recordMwm : record.children(kXmlMwmNode))
+    {
+      auto & mwm = getMwmNode(recordMwm.attribute("name").as_string(""));
+
+      auto version = mwm.m_node.attribute("version");
+      if (!version)
+        version = mwm.m_node.append_attribute("version");
+      version = recordMwm.attribute("version").as_llong(0);
+
+      for (auto const & section : recordMwm.children())
+      {
+        for (auto const & feature : section.children())
+        {
+          auto const index = feature.attribute(kFeatureIndexAttr).as_uint();
+          auto const it = mwm.m_features.find(index);
+          if (it != mwm.m_features.end())
+          {
+            it->second.parent().remove_child(it->second);
+            mwm.m_features.erase(it);
+          }
+
+          if (string(section.name()) == kRemoveSection)
+            continue;
+
+          auto target = mwm.m_node.child(section.name());
+          if (!target)
+            target = mwm.m_node.append_child(section.name());
+          mwm.m_features.emplace(index, target.append_copy(feature));
+        }
+      }
+    }
+  }
+}
+
 struct LogHelper
 {
   explicit LogHelper(MwmSet::MwmId const & mwmId) : m_mwmId(mwmId) {}
@@ -138,6 +243,7 @@ Editor::Editor()
   : m_configLoader(m_config)
   , m_notes(editor::Notes::MakeNotes())
   , m_isUploadingNow(false)
+  , m_isCompactingNow(false)
 {
   SetDefaultStorage();
 }
@@ -160,11 +266,14 @@ void Editor::LoadEdits()
   }
 
   xml_document doc;
+  xml_document journal;
   bool needRewriteEdits = false;
 
-  if (!m_storage->Load(doc))
+  if (!m_storage->Load(doc) || !m_storage->LoadJournal(journal))
     return;
 
+  ApplyJournal(doc, journal);
+
   m_features.Set(make_shared<FeaturesContainer>());
   auto loadedFeatures = make_shared<FeaturesContainer>();
 
@@ -206,9 +315,14 @@ bool Editor::Save(FeaturesContainer const & features) const
     return m_storage->Reset();
 
   xml_document doc;
-  xml_node root = doc.append_child(kXmlRootNode);
-  // Use format_version for possible future format changes.
-  root.append_attribute("format_version") = 1;
+  ToXml(features, doc);
+  return m_storage->Save(doc);
+}
+
+// static
+void Editor::ToXml(FeaturesContainer const & features, xml_document & doc)
+{
+  xml_node root = GetOrCreateRootNode(doc);
   for (auto const & mwm : features)
   {
     if (!mwm.first.IsAlive())
@@ -224,23 +338,7 @@ bool Editor::Save(FeaturesContainer const & features) const
     for (auto & index : mwm.second)
     {
       FeatureTypeInfo const & fti = index.second;
-      // TODO: Do we really need to serialize deleted features in full details? Looks like mwm ID
-      // and meta fields are enough.
-      XMLFeature xf =
-          editor::ToXML(fti.m_object, true /* type serializing helps during migration */);
-      xf.SetMWMFeatureIndex(index.first);
-      if (!fti.m_street.empty())
-        xf.SetTagValue(kAddrStreetTag, fti.m_street);
-      ASSERT_NOT_EQUAL(0, fti.m_modificationTimestamp, ());
-      xf.SetModificationTime(fti.m_modificationTimestamp);
-      if (fti.m_uploadAttemptTimestamp != base::INVALID_TIME_STAMP)
-      {
-        xf.SetUploadTime(fti.m_uploadAttemptTimestamp);
-        ASSERT(!fti.m_uploadStatus.empty(), ("Upload status updates with upload timestamp."));
-        xf.SetUploadStatus(fti.m_uploadStatus);
-        if (!fti.m_uploadError.empty())
-          xf.SetUploadError(fti.m_uploadError);
-      }
+      XMLFeature const xf = ToXMLFeature(index.first, fti);
       switch (fti.m_status)
       {
       case FeatureStatus::Deleted: VERIFY(xf.AttachToParentNode(deleted), ()); break;
@@ -251,8 +349,58 @@ bool Editor::Save(FeaturesContainer const & features) const
       }
     }
   }
+}
 
-  return m_storage->Save(doc);
+// static
+bool Editor::ToJournalRecord(FeaturesContainer const & features, FeatureID const & fid,
+                             xml_document & record)
+{
+  if (!fid.m_mwmId.IsAlive())
+    return false;
+
+  xml_node mwmNode = GetOrCreateRootNode(record).append_child(kXmlMwmNode);
+  mwmNode.append_attribute("name") = fid.m_mwmId.GetInfo()->GetCountryName().c_str();
+  mwmNode.append_attribute("version") = static_cast<long long>(fid.m_mwmId.GetInfo()->GetVersion());
+
+  auto const mwm = features.find(fid.m_mwmId);
+  if (mwm != features.cend())
+  {
+    auto const index = mwm->second.find(fid.m_index);
+    if (index != mwm->second.cend())
+    {
+      auto const & fti = index->second;
+      VERIFY(ToXMLFeature(fid.m_index, fti).AttachToParentNode(
+                 mwmNode.append_child(GetSectionName(fti.m_status))), ());
+      return true;
+    }
+  }
+
+  // Edits of the feature were removed.
+  mwmNode.append_child(kRemoveSection).append_child("node").append_attribute(kFeatureIndexAttr) =
+      fid.m_index;
+  return true;
+}
+
+// static
+XMLFeature Editor::ToXMLFeature(uint32_t index, FeatureTypeInfo const & fti)
+{
+  // TODO: Do we really need to serialize deleted features in full details? Looks like mwm ID
+  // and meta fields are enough.
+  XMLFeature xf = editor::ToXML(fti.m_object, true /* type serializing helps during migration */);
+  xf.SetMWMFeatureIndex(index);
+  if (!fti.m_street.empty())
+    xf.SetTagValue(kAddrStreetTag, fti.m_street);
+  ASSERT_NOT_EQUAL(0, fti.m_modificationTimestamp, ());
+  xf.SetModificationTime(fti.m_modificationTimestamp);
+  if (fti.m_uploadAttemptTimestamp != base::INVALID_TIME_STAMP)
+  {
+    xf.SetUploadTime(fti.m_uploadAttemptTimestamp);
+    ASSERT(!fti.m_uploadStatus.empty(), ("Upload status updates with upload timestamp."));
+    xf.SetUploadStatus(fti.m_uploadStatus);
+    if (!fti.m_uploadError.empty())
+      xf.SetUploadError(fti.m_uploadError);
+  }
+  return xf;
 }
 
 bool Editor::SaveTransaction(std::shared_ptr<FeaturesContainer> const & features)
@@ -264,6 +412,40 @@ bool Editor::SaveTransaction(std::shared_ptr<FeaturesContainer> const & features
   return true;
 }
 
+bool Editor::SaveTransaction(std::shared_ptr<FeaturesContainer> const & features,
+                             FeatureID const & fid)
+{
+  xml_document record;
+  if (features->empty() || !ToJournalRecord(*features, fid, record))
+    return SaveTransaction(features);
+
+  if (!m_storage->AppendToJournal(record))
+    return false;
+
+  m_features.Set(features);
+  CompactJournalIfNeeded(features);
+  return true;
+}
+
+void Editor::CompactJournalIfNeeded(std::shared_ptr<FeaturesContainer const> const & features)
+{
+  // Journal position must match |features|, so it is taken on the main thread.
+  auto const position = m_storage->GetJournalPosition();
+  if (position.m_recordsCount < kMaxJournalRecords || m_isCompactingNow)
+    return;
+
+  m_isCompactingNow = true;
+  GetPlatform().RunTask(Platform::Thread::File, [this, storage = m_storage, features, position]()
+  {
+    xml_document doc;
+    ToXml(*features, doc);
+    if (!storage->Compact(doc, position))
+      LOG(LWARNING, ("Map edits journal was not compacted."));
+
+    m_isCompactingNow = false;
+  });
+}
+
 void Editor::ClearAllLocalEdits()
 {
   CHECK_THREAD_CHECKER(MainThreadChecker, (""));
@@ -312,13 +494,13 @@ void Editor::DeleteFeature(FeatureID const & fid)
     if (f != mwm->second.end() && f->second.m_status == FeatureStatus::Created)
     {
       mwm->second.erase(f);
-      SaveTransaction(editableFeatures);
+      SaveTransaction(editableFeatures, fid);
       return;
     }
   }
 
   MarkFeatureWithStatus(*editableFeatures, fid, FeatureStatus::Deleted);
-  SaveTransaction(editableFeatures);
+  SaveTransaction(editableFeatures, fid);
   Invalidate();
 }
 
@@ -427,7 +609,7 @@ Editor::SaveResult Editor::SaveEditedFeature(EditableMapObject const & emo)
   auto editableFeatures = make_shared<FeaturesContainer>(*features);
   (*editableFeatures)[fid.m_mwmId][fid.m_index] = std::move(fti);
 
-  bool const savedSuccessfully = SaveTransaction(editableFeatures);
+  bool const savedSuccessfully = SaveTransaction(editableFeatures, fid);
 
   Invalidate();
   return savedSuccessfully ? SaveResult::SavedSuccessfully : SaveResult::NoFreeSpaceError;
@@ -806,7 +988,7 @@ void Editor::SaveUploadedInformation(FeatureID const & fid, UploadInfo const & u
   fti.m_uploadStatus = uploadInfo.m_uploadStatus;
   fti.m_uploadError = uploadInfo.m_uploadError;
 
-  SaveTransaction(editableFeatures);
+  SaveTransaction(editableFeatures, fid);
 }
 
 bool Editor::FillFeatureInfo(FeatureStatus status, XMLFeature const & xml, FeatureID const & fid,
@@ -876,7 +1058,7 @@ bool Editor::RemoveFeatureIfExists(FeatureID const & fid)
   if (matchedMwm->second.empty())
     editableFeatures->erase(matchedMwm);
 
-  return SaveTransaction(editableFeatures);
+  return SaveTransaction(editableFeatures, fid);
 }
 
 void Editor::Invalidate()
@@ -900,7 +1082,7 @@ bool Editor::MarkFeatureAsObsolete(FeatureID const & fid)
   }
 
   MarkFeatureWithStatus(*editableFeatures, fid, FeatureStatus::Obsolete);
-  auto const result = SaveTransaction(editableFeatures);
+  auto const result = SaveTransaction(editableFeatures, fid);
   Invalidate();
 
   return result;
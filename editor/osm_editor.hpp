@@ -208,6 +208,15 @@ private:
   /// @returns false if fails.
   bool Save(FeaturesContainer const & features) const;
   bool SaveTransaction(std::shared_ptr<FeaturesContainer> const & features);
+  /// Saves only the changes of |fid| by appending them to the edits journal.
+  bool SaveTransaction(std::shared_ptr<FeaturesContainer> const & features, FeatureID const & fid);
+  /// Rewrites the edits snapshot in background when the journal becomes too long.
+  void CompactJournalIfNeeded(std::shared_ptr<FeaturesContainer const> const & features);
+  static void ToXml(FeaturesContainer const & features, pugi::xml_document & doc);
+  /// @returns false if |fid| changes can't be saved as a single journal record.
+  static bool ToJournalRecord(FeaturesContainer const & features, FeatureID const & fid,
+                              pugi::xml_document & record);
+  static editor::XMLFeature ToXMLFeature(uint32_t index, FeatureTypeInfo const & fti);
   bool RemoveFeatureIfExists(FeatureID const & fid);
   /// Notify framework that something has changed and should be redisplayed.
   void Invalidate();
@@ -264,9 +273,10 @@ private:
   /// Notes to be sent to osm.
   std::shared_ptr<editor::Notes> m_notes;
 
-  std::unique_ptr<editor::StorageBase> m_storage;
+  std::shared_ptr<editor::StorageBase> m_storage;
 
   std::atomic<bool> m_isUploadingNow;
+  std::atomic<bool> m_isCompactingNow;
 
   DECLARE_THREAD_CHECKER(MainThreadChecker);
 };  // class Editor
@@ -25,14 +25,19 @@
 #include "coding/internal/file_data.hpp"
 #include "coding/point_coding.hpp"
 #include "coding/succinct_mapper.hpp"
+#include "coding/writer.hpp"
 
 #include "base/assert.hpp"
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
 #include "base/string_utils.hpp"
+#include "base/thread_pool_computational.hpp"
+#include "base/timer.hpp"
 
 #include "defines.hpp"
 
+#include <algorithm>
+#include <future>
 #include <limits>
 #include <list>
 #include <memory>
@@ -46,7 +51,7 @@ public:
   static uint32_t constexpr kInvalidFeatureId = std::numeric_limits<uint32_t>::max();
 
   FeaturesCollector2(std::string const & name, feature::GenerateInfo const & info, DataHeader const & header,
-                     RegionData const & regionData, uint32_t versionDate)
+                     RegionData const & regionData, uint32_t versionDate, size_t threadsCount)
     : FeaturesCollector(info.GetTargetFileName(name, FEATURES_FILE_TAG))
     , m_filename(info.GetTargetFileName(name))
     , m_boundaryPostcodesEnricher(info.GetIntermediateFileName(BOUNDARY_POSTCODE_TMP_FILENAME))
@@ -62,6 +67,9 @@ public:
     }
 
     m_addrFile = std::make_unique<FileWriter>(info.GetIntermediateFileName(name + DATA_FILE_EXTENSION, TEMP_ADDR_FILENAME));
+
+    if (threadsCount > 1)
+      m_threadPool = std::make_unique<base::thread_pool::computational::ThreadPool>(threadsCount);
   }
 
   void Finish() override
@@ -146,10 +154,93 @@ public:
 
   void SetBounds(m2::RectD bounds) { m_bounds = bounds; }
 
+  /// Processes |fbs| preserving their order. Geometry of the features is simplified and
+  /// tesselated in parallel, the results are written into sections sequentially.
+  void operator()(std::vector<FeatureBuilder> & fbs)
+  {
+    base::Timer timer;
+    std::vector<FeatureGeometry> geometries(fbs.size());
+    if (m_threadPool)
+    {
+      std::vector<std::future<void>> results;
+      for (size_t begin = 0; begin < fbs.size(); begin += kChunkSize)
+      {
+        size_t const end = std::min(begin + kChunkSize, fbs.size());
+        results.emplace_back(m_threadPool->Submit([&, begin, end]() {
+          for (size_t i = begin; i < end; ++i)
+            geometries[i] = MakeGeometry(fbs[i]);
+        }));
+      }
+      // Rethrows exceptions from the workers.
+      for (auto & result : results)
+        result.get();
+    }
+    else
+    {
+      for (size_t i = 0; i < fbs.size(); ++i)
+        geometries[i] = MakeGeometry(fbs[i]);
+    }
+    m_geometryTime += timer.ElapsedSeconds();
+
+    timer.Reset();
+    for (size_t i = 0; i < fbs.size(); ++i)
+      WriteFeature(fbs[i], geometries[i]);
+    m_writeTime += timer.ElapsedSeconds();
+  }
+
   uint32_t operator()(FeatureBuilder & fb)
   {
-    GeometryHolder holder([this](int i) -> FileWriter & { return *m_geoFile[i]; },
-                          [this](int i) -> FileWriter & { return *m_trgFile[i]; }, fb, m_header);
+    auto geometry = MakeGeometry(fb);
+    return WriteFeature(fb, geometry);
+  }
+
+  double GetGeometryTime() const { return m_geometryTime; }
+  double GetWriteTime() const { return m_writeTime; }
+
+private:
+  using Points = std::vector<m2::PointD>;
+  using Polygons = std::list<Points>;
+
+  class TmpFile : public FileWriter
+  {
+  public:
+    explicit TmpFile(std::string const & filePath) : FileWriter(filePath) {}
+    ~TmpFile() override { DeleteFileX(GetName()); }
+  };
+
+  using TmpFiles = std::vector<std::unique_ptr<TmpFile>>;
+  using Buffers = std::vector<FeatureBuilder::Buffer>;
+
+  // Size of the features portion processed by one thread pool task.
+  static size_t constexpr kChunkSize = 64;
+
+  // Geometry of a feature serialized into memory: outer points and triangles for every scale.
+  struct FeatureGeometry
+  {
+    FeatureBuilder::SupportingData m_data;
+    Buffers m_geo;
+    Buffers m_trg;
+  };
+
+  // Simplifies and tesselates |fb| geometry for all scales. Does not touch collector state,
+  // so it is safe to call it concurrently.
+  FeatureGeometry MakeGeometry(FeatureBuilder & fb) const
+  {
+    FeatureGeometry geometry;
+    geometry.m_geo.resize(m_header.GetScalesCount());
+    geometry.m_trg.resize(m_header.GetScalesCount());
+
+    std::vector<MemWriter<FeatureBuilder::Buffer>> geoWriters, trgWriters;
+    geoWriters.reserve(m_header.GetScalesCount());
+    trgWriters.reserve(m_header.GetScalesCount());
+    for (size_t i = 0; i < m_header.GetScalesCount(); ++i)
+    {
+      geoWriters.emplace_back(geometry.m_geo[i]);
+      trgWriters.emplace_back(geometry.m_trg[i]);
+    }
+
+    GeometryHolder holder([&geoWriters](int i) -> Writer & { return geoWriters[i]; },
+                          [&trgWriters](int i) -> Writer & { return trgWriters[i]; }, fb, m_header);
 
     bool const isLine = fb.IsLine();
     bool const isArea = fb.IsArea();
@@ -224,8 +315,17 @@ public:
       }
     }
 
+    geometry.m_data = std::move(holder.GetBuffer());
+    return geometry;
+  }
+
+  uint32_t WriteFeature(FeatureBuilder & fb, FeatureGeometry & geometry)
+  {
+    auto & buffer = geometry.m_data;
+    AppendGeometry(geometry.m_geo, buffer.m_ptsMask, buffer.m_ptsOffset, m_geoFile);
+    AppendGeometry(geometry.m_trg, buffer.m_trgMask, buffer.m_trgOffset, m_trgFile);
+
     uint32_t featureId = kInvalidFeatureId;
-    auto & buffer = holder.GetBuffer();
     if (fb.PreSerializeAndRemoveUselessNamesForMwm(buffer))
     {
       fb.SerializeForMwm(buffer, m_header.GetDefGeometryCodingParams());
@@ -246,18 +346,25 @@ public:
     return featureId;
   }
 
-private:
-  using Points = std::vector<m2::PointD>;
-  using Polygons = std::list<Points>;
-
-  class TmpFile : public FileWriter
+  // Appends in-memory geometry of a feature to the temporary section files and converts
+  // |offsets| from the in-memory positions to the positions in the files.
+  static void AppendGeometry(Buffers const & buffers, uint8_t mask, FeatureBuilder::Offsets & offsets,
+                             TmpFiles & files)
   {
-  public:
-    explicit TmpFile(std::string const & filePath) : FileWriter(filePath) {}
-    ~TmpFile() override { DeleteFileX(GetName()); }
-  };
+    // Offsets are added in the order of scales processing, from the upper scale to the lower one.
+    size_t offsetIndex = 0;
+    for (int i = static_cast<int>(buffers.size()) - 1; i >= 0; --i)
+    {
+      if ((mask & (1 << i)) == 0)
+        continue;
 
-  using TmpFiles = std::vector<std::unique_ptr<TmpFile>>;
+      CHECK_LESS(offsetIndex, offsets.size(), ());
+      CHECK_EQUAL(offsets[offsetIndex], 0, ("Only one geometry block per scale is expected."));
+      offsets[offsetIndex++] = CheckedFilePosCast(*files[i]);
+      files[i]->Write(buffers[i].data(), buffers[i].size());
+    }
+    CHECK_EQUAL(offsetIndex, offsets.size(), ());
+  }
 
   static bool IsGoodArea(Points const & poly, int level)
   {
@@ -304,15 +411,21 @@ private:
 
   generator::OsmID2FeatureID m_osm2ft;
 
+  std::unique_ptr<base::thread_pool::computational::ThreadPool> m_threadPool;
+  double m_geometryTime = 0.0;
+  double m_writeTime = 0.0;
+
   DISALLOW_COPY_AND_MOVE(FeaturesCollector2);
 };
 
 bool GenerateFinalFeatures(feature::GenerateInfo const & info, std::string const & name,
-                           feature::DataHeader::MapType mapType)
+                           feature::DataHeader::MapType mapType, size_t threadsCount)
 {
   std::string const srcFilePath = info.GetTmpFileName(name);
   std::string const dataFilePath = info.GetTargetFileName(name);
 
+  base::Timer timer;
+
   // Store cellIds for middle points.
   CalculateMidPoints midPoints;
   ForEachFeatureRawFormat(srcFilePath, [&midPoints](FeatureBuilder const & fb, uint64_t pos) {
@@ -321,6 +434,7 @@ bool GenerateFinalFeatures(feature::GenerateInfo const & info, std::string const
 
   // Sort features by their middle point.
   midPoints.Sort();
+  double const sortTime = timer.ElapsedSeconds();
 
   // Store sorted features.
   {
@@ -350,15 +464,30 @@ bool GenerateFinalFeatures(feature::GenerateInfo const & info, std::string const
       // FeaturesCollector2 will create temporary file `dataFilePath + FEATURES_FILE_TAG`.
       // We cannot remove it in ~FeaturesCollector2(), we need to remove it in SCOPE_GUARD.
       SCOPE_GUARD(_, [&]() { Platform::RemoveFileIfExists(info.GetTargetFileName(name, FEATURES_FILE_TAG)); });
-      FeaturesCollector2 collector(name, info, header, regionData, info.m_versionDate);
-      for (auto const & point : midPoints.GetVector())
+      FeaturesCollector2 collector(name, info, header, regionData, info.m_versionDate, threadsCount);
+
+      // Features are read and processed by batches to keep memory usage bounded.
+      size_t constexpr kBatchSize = 4096;
+      std::vector<FeatureBuilder> batch;
+      batch.reserve(kBatchSize);
+
+      double readTime = 0.0;
+      auto const & points = midPoints.GetVector();
+      for (size_t begin = 0; begin < points.size(); begin += kBatchSize)
       {
-        ReaderSource<FileReader> src(reader);
-        src.Skip(point.second);
+        timer.Reset();
+        size_t const end = std::min(begin + kBatchSize, points.size());
+        batch.clear();
+        for (size_t i = begin; i < end; ++i)
+        {
+          ReaderSource<FileReader> src(reader);
+          src.Skip(points[i].second);
 
-        FeatureBuilder fb;
-        ReadFromSourceRawFormat(src, fb);
-        collector(fb);
+          ReadFromSourceRawFormat(src, batch.emplace_back());
+        }
+        readTime += timer.ElapsedSeconds();
+
+        collector(batch);
       }
 
       // Update bounds with the limit rect corresponding to region borders.
@@ -369,7 +498,13 @@ bool GenerateFinalFeatures(feature::GenerateInfo const & info, std::string const
       if (borders::GetBordersRect(info.m_targetDir, name, bordersRect))
         collector.SetBounds(bordersRect);
 
+      timer.Reset();
       collector.Finish();
+
+      LOG(LINFO, ("Final features for", name, "with", threadsCount, "threads. Sorting:", sortTime,
+                  "s, reading:", readTime, "s, geometry simplification and tesselation:",
+                  collector.GetGeometryTime(), "s, serialization:", collector.GetWriteTime(),
+                  "s, sections finalization:", timer.ElapsedSeconds(), "s."));
     }
     catch (RootException const & ex)
     {
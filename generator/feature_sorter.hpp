@@ -11,6 +11,8 @@ namespace feature
 /// Final generation of data from input feature-file.
 /// @param path - path to folder with countries;
 /// @param name - name of generated country;
+/// @param threadsCount - number of threads used for geometry simplification and tesselation,
+/// output doesn't depend on it;
 bool GenerateFinalFeatures(feature::GenerateInfo const & info, std::string const & name,
-                           feature::DataHeader::MapType mapType);
+                           feature::DataHeader::MapType mapType, size_t threadsCount = 1);
 }  // namespace feature
@@ -71,6 +71,8 @@ struct GenerateInfo
   bool m_failOnCoasts = false;
   bool m_preloadCache = false;
   bool m_verbose = false;
+  // Write the search index as a flat trie (search::SearchIndexHeader::Version::V3).
+  bool m_flatSearchIndex = false;
 
   GenerateInfo() = default;
 
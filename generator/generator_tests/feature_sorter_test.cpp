@@ -0,0 +1,158 @@
+#include "testing/testing.hpp"
+
+#include "generator/feature_builder.hpp"
+#include "generator/generator_tests_support/test_mwm_builder.hpp"
+
+#include "indexer/classificator.hpp"
+#include "indexer/classificator_loader.hpp"
+#include "indexer/data_header.hpp"
+
+#include "platform/country_file.hpp"
+#include "platform/local_country_file.hpp"
+#include "platform/platform.hpp"
+#include "platform/platform_tests_support/scoped_dir.hpp"
+#include "platform/platform_tests_support/scoped_file.hpp"
+
+#include "coding/files_container.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "base/file_name_utils.hpp"
+#include "base/math.hpp"
+#include "base/string_utils.hpp"
+
+#include "defines.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace feature_sorter_test
+{
+using namespace feature;
+using namespace platform::tests_support;
+using namespace platform;
+using std::map, std::string, std::vector;
+
+// Temporary mwm name for testing.
+string const kTestMwm = "test";
+uint32_t constexpr kVersion = 220101;
+
+// More features than the generator reads in one batch.
+size_t constexpr kFeaturesCount = 5000;
+
+// Parks and roads of different sizes with noisy geometry: they are simplified differently for
+// every scale and the parks are tesselated.
+vector<FeatureBuilder> MakeFeatures()
+{
+  auto const & c = classif();
+  uint32_t const parkType = c.GetTypeByPath({"leisure", "park"});
+  uint32_t const roadType = c.GetTypeByPath({"highway", "primary"});
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> coord(0.0, 10.0);
+  std::uniform_real_distribution<double> radius(0.001, 0.2);
+  std::uniform_real_distribution<double> noise(0.5, 1.0);
+  std::uniform_int_distribution<size_t> pointsCount(10, 100);
+
+  vector<FeatureBuilder> features(kFeaturesCount);
+  for (size_t i = 0; i < features.size(); ++i)
+  {
+    auto & fb = features[i];
+    m2::PointD const center(coord(rng), coord(rng));
+    double const r = radius(rng);
+    size_t const count = pointsCount(rng);
+    if (i % 2 == 0)
+    {
+      // Star-shaped polygon.
+      for (size_t j = 0; j < count; ++j)
+      {
+        double const angle = 2.0 * math::pi * j / count;
+        double const len = r * noise(rng);
+        fb.AddPoint(center + m2::PointD(len * std::cos(angle), len * std::sin(angle)));
+      }
+      fb.AddPoint(fb.GetOuterGeometry().front());
+      fb.SetArea();
+      fb.AddType(parkType);
+    }
+    else
+    {
+      for (size_t j = 0; j < count; ++j)
+      {
+        double const x = r * j / count;
+        fb.AddPoint(center + m2::PointD(x, r * 0.1 * (noise(rng) - 0.75)));
+      }
+      fb.SetLinear(false /* reverseGeometry */);
+      fb.AddType(roadType);
+    }
+  }
+  return features;
+}
+
+// Builds mwm from |features| and returns its features, geometry and triangles sections.
+map<string, string> BuildSections(vector<FeatureBuilder> const & features, size_t threadsCount)
+{
+  string const dir = "feature_sorter_test_" + strings::to_string(threadsCount);
+  ScopedDir const scopedDir(dir);
+  LocalCountryFile country(base::JoinPath(GetPlatform().WritableDir(), dir), CountryFile(kTestMwm),
+                           0 /* version */);
+  ScopedFile const scopedMwm(base::JoinPath(dir, kTestMwm + DATA_FILE_EXTENSION),
+                             ScopedFile::Mode::Create);
+  {
+    generator::tests_support::TestMwmBuilder builder(country, DataHeader::MapType::Country,
+                                                     kVersion);
+    builder.SetThreadsCount(threadsCount);
+    for (auto fb : features)
+      builder.Add(fb);
+  }
+
+  map<string, string> sections;
+  FilesContainerR const cont(scopedMwm.GetFullPath());
+  cont.ForEachTag([&](FilesContainerR::Tag const & tag)
+  {
+    if (tag == FEATURES_FILE_TAG || tag.find(GEOMETRY_FILE_TAG) == 0 ||
+        tag.find(TRIANGLE_FILE_TAG) == 0)
+    {
+      cont.GetReader(tag).ReadAsString(sections[tag]);
+    }
+  });
+  return sections;
+}
+
+UNIT_TEST(FeatureSorter_ThreadsCountDoesNotChangeMwm)
+{
+  classificator::Load();
+
+  auto const features = MakeFeatures();
+  auto const expected = BuildSections(features, 1 /* threadsCount */);
+
+  size_t geometrySize = 0;
+  size_t trianglesSize = 0;
+  for (auto const & [tag, data] : expected)
+  {
+    if (tag.find(GEOMETRY_FILE_TAG) == 0)
+      geometrySize += data.size();
+    else if (tag.find(TRIANGLE_FILE_TAG) == 0)
+      trianglesSize += data.size();
+  }
+  TEST(expected.count(FEATURES_FILE_TAG) != 0, ());
+  TEST_GREATER(geometrySize, 0, ());
+  TEST_GREATER(trianglesSize, 0, ());
+
+  for (size_t const threadsCount : {2, 4, 8})
+  {
+    auto const sections = BuildSections(features, threadsCount);
+    TEST_EQUAL(sections.size(), expected.size(), (threadsCount));
+    for (auto const & [tag, data] : expected)
+    {
+      auto const it = sections.find(tag);
+      TEST(it != sections.end(), (tag, threadsCount));
+      // Don't print the sections, they are too large.
+      TEST(it->second == data, (tag, threadsCount));
+    }
+  }
+}
+}  // namespace feature_sorter_test
@@ -44,6 +44,8 @@ public:
   void SetUKPostcodesData(std::string const & postcodesPath,
                           std::shared_ptr<storage::CountryInfoGetter> const & countryInfoGetter);
   void SetMwmLanguages(std::vector<std::string> const & languages);
+  // Number of threads used for geometry simplification and tesselation of the features.
+  void SetThreadsCount(size_t threadsCount) { m_threadsCount = threadsCount; }
 
   void Finish();
 
@@ -56,6 +58,7 @@ private:
   std::shared_ptr<storage::CountryInfoGetter> m_postcodesCountryInfoGetter;
   std::string m_ukPostcodesPath;
   uint32_t m_version = 0;
+  size_t m_threadsCount = 1;
 };
 }  // namespace tests_support
 }  // namespace generator
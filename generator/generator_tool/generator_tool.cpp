@@ -25,6 +25,7 @@
 #include "generator/routing_index_generator.hpp"
 #include "generator/routing_world_roads_generator.hpp"
 #include "generator/search_index_builder.hpp"
+#include "generator/speed_profiles_builder.hpp"
 #include "generator/statistics.hpp"
 #include "generator/traffic_generator.hpp"
 #include "generator/transit_generator.hpp"
@@ -106,6 +107,8 @@ DEFINE_bool(generate_geometry, false,
             "3rd pass - split and simplify geometry and triangles for features.");
 DEFINE_bool(generate_index, false, "4rd pass - generate index.");
 DEFINE_bool(generate_search_index, false, "5th pass - generate search index.");
+DEFINE_bool(flat_search_index, false,
+            "Write the search index as a flat trie: faster search, larger index.");
 DEFINE_bool(dump_cities_boundaries, false, "Dump cities boundaries to a file");
 DEFINE_bool(generate_cities_boundaries, false, "Generate the cities boundaries section");
 DEFINE_string(cities_boundaries_data, "", "File with cities boundaries");
@@ -150,6 +153,9 @@ DEFINE_bool(
     make_city_roads, false,
     "Calculates which roads lie inside cities and makes a section with ids of these roads.");
 DEFINE_bool(generate_maxspeed, false, "Generate section with maxspeed of road features.");
+DEFINE_string(speed_profiles_path, "",
+              "Path to csv with typical speeds of roads by time of day. If set, generates a "
+              "section with speed profiles of road features.");
 
 // Sponsored-related.
 DEFINE_string(complex_hierarchy_data, "", "Path to complex hierarchy in csv format.");
@@ -252,6 +258,7 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
   genInfo.m_osmFileName = FLAGS_osm_file_name;
   genInfo.m_failOnCoasts = FLAGS_fail_on_coasts;
   genInfo.m_preloadCache = FLAGS_preload_cache;
+  genInfo.m_flatSearchIndex = FLAGS_flat_search_index;
   genInfo.m_popularPlacesFilename = FLAGS_popular_places_data;
   genInfo.m_brandsFilename = FLAGS_brands_data;
   genInfo.m_brandsTranslationsFilename = FLAGS_brands_translations_data;
@@ -351,7 +358,7 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
       // On error move to the next bucket without index generation.
 
       LOG(LINFO, ("Generating result features for", country));
-      if (!feature::GenerateFinalFeatures(genInfo, country, mapType))
+      if (!feature::GenerateFinalFeatures(genInfo, country, mapType, threadsCount))
         continue;
 
       LOG(LINFO, ("Generating offsets table for", dataFile));
@@ -515,6 +522,13 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
         LOG(LINFO, ("Generating maxspeeds section for", dataFile, "using", maxspeedsFilename));
         BuildMaxspeedsSection(routingGraph.get(), dataFile, osmToFeatureFilename, maxspeedsFilename);
       }
+
+      if (!FLAGS_speed_profiles_path.empty())
+      {
+        LOG(LINFO, ("Generating speed profiles section for", dataFile, "using",
+                    FLAGS_speed_profiles_path));
+        BuildSpeedProfilesSection(dataFile, osmToFeatureFilename, FLAGS_speed_profiles_path);
+      }
     }
 
     if (FLAGS_make_city_roads)
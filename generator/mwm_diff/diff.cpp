@@ -2,8 +2,10 @@
 
 #include "coding/buffered_file_writer.hpp"
 #include "coding/file_reader.hpp"
+#include "coding/files_container.hpp"
 #include "coding/file_writer.hpp"
 #include "coding/reader.hpp"
+#include "coding/varint.hpp"
 #include "coding/write_to_sink.hpp"
 #include "coding/writer.hpp"
 #include "coding/zlib.hpp"
@@ -11,10 +13,18 @@
 #include "base/assert.hpp"
 #include "base/cancellable.hpp"
 #include "base/checked_cast.hpp"
+#include "base/exception.hpp"
 #include "base/logging.hpp"
+#include "base/thread_pool_computational.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <deque>
+#include <future>
 #include <iterator>
+#include <optional>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "3party/bsdiff-courgette/bsdiff/bsdiff.h"
@@ -25,9 +35,187 @@ enum Version
 {
   // Format Version 0: bsdiff+gzip.
   VERSION_V0 = 0,
-  VERSION_LATEST = VERSION_V0
+  // Format Version 1: the new mwm is split by the sections of its files container,
+  // every part is copied from the old mwm, patched with bsdiff+gzip or stored with gzip.
+  VERSION_V1 = 1,
 };
 
+DECLARE_EXCEPTION(CorruptedDiffException, RootException);
+
+// Operations of the format version 1.
+enum class Operation : uint8_t
+{
+  // Copy a range of the old mwm.
+  Copy = 0,
+  // Apply the bsdiff patch to a range of the old mwm.
+  Patch = 1,
+  // Write the stored bytes.
+  Raw = 2,
+};
+
+// A part of the new mwm and the part of the old mwm it is made from.
+struct Range
+{
+  uint64_t m_newOffset = 0;
+  uint64_t m_newSize = 0;
+  bool m_hasOld = false;
+  uint64_t m_oldOffset = 0;
+  uint64_t m_oldSize = 0;
+};
+
+// Size of the copy buffer, the copied parts of the old mwm are never read to memory as a whole.
+size_t constexpr kCopyBufferSize = 1 << 20;
+
+std::vector<uint8_t> Deflate(std::vector<uint8_t> const & data)
+{
+  using Deflate = coding::ZLib::Deflate;
+  Deflate deflate(Deflate::Format::ZLib, Deflate::Level::BestCompression);
+
+  std::vector<uint8_t> deflated;
+  deflate(data.data(), data.size(), back_inserter(deflated));
+  return deflated;
+}
+
+std::vector<uint8_t> Inflate(std::vector<uint8_t> const & data)
+{
+  using Inflate = coding::ZLib::Inflate;
+  Inflate inflate(Inflate::Format::ZLib);
+
+  std::vector<uint8_t> inflated;
+  if (!inflate(data.data(), data.size(), back_inserter(inflated)))
+    MYTHROW(CorruptedDiffException, ("Could not inflate diff data"));
+  return inflated;
+}
+
+std::vector<uint8_t> ReadRange(FileReader const & reader, uint64_t offset, uint64_t size)
+{
+  std::vector<uint8_t> data(base::checked_cast<size_t>(size));
+  reader.Read(offset, data.data(), data.size());
+  return data;
+}
+
+// Returns the sections of the files container at |path| sorted by offset or nothing
+// if the file is not a files container.
+std::optional<std::vector<FilesContainerBase::TagInfo>> ReadSections(std::string const & path)
+{
+  std::vector<FilesContainerBase::TagInfo> sections;
+  uint64_t fileSize = 0;
+  try
+  {
+    FilesContainerR container(path);
+    fileSize = container.GetFileSize();
+    container.ForEachTagInfo([&sections](auto const & info) { sections.push_back(info); });
+  }
+  catch (std::exception const & e)
+  {
+    LOG(LINFO, ("Could not read sections of", path, e.what()));
+    return {};
+  }
+
+  std::sort(sections.begin(), sections.end(), [](auto const & lhs, auto const & rhs) {
+    return std::make_pair(lhs.m_offset, lhs.m_size) < std::make_pair(rhs.m_offset, rhs.m_size);
+  });
+
+  // The container starts with the offset of its table of contents.
+  uint64_t pos = sizeof(uint64_t);
+  for (auto const & section : sections)
+  {
+    if (section.m_offset < pos || section.m_offset + section.m_size > fileSize)
+      return {};
+    pos = section.m_offset + section.m_size;
+  }
+  return sections;
+}
+
+// Splits the new mwm into the sections and the gaps between them (the header,
+// paddings and the table of contents). If any of the files is not a files container,
+// the whole new mwm is made from the whole old mwm.
+std::vector<Range> MakeRanges(std::string const & oldMwmPath, uint64_t oldSize,
+                              std::string const & newMwmPath, uint64_t newSize)
+{
+  auto const oldSections = ReadSections(oldMwmPath);
+  auto const newSections = ReadSections(newMwmPath);
+  if (!oldSections || !newSections)
+    return {{0 /* newOffset */, newSize, true /* hasOld */, 0 /* oldOffset */, oldSize}};
+
+  std::unordered_map<std::string, FilesContainerBase::TagInfo const *> oldByTag;
+  for (auto const & section : *oldSections)
+    oldByTag.emplace(section.m_tag, &section);
+
+  std::vector<Range> ranges;
+  uint64_t pos = 0;
+  auto const addGap = [&ranges, &pos](uint64_t end) {
+    if (end > pos)
+      ranges.push_back({pos, end - pos});
+  };
+
+  for (auto const & section : *newSections)
+  {
+    addGap(section.m_offset);
+    pos = section.m_offset + section.m_size;
+    if (section.m_size == 0)
+      continue;
+
+    Range range{section.m_offset, section.m_size};
+    auto const it = oldByTag.find(section.m_tag);
+    if (it != oldByTag.end() && it->second->m_size != 0)
+    {
+      range.m_hasOld = true;
+      range.m_oldOffset = it->second->m_offset;
+      range.m_oldSize = it->second->m_size;
+    }
+    ranges.push_back(range);
+  }
+  addGap(newSize);
+  return ranges;
+}
+
+// Runs the tasks made by |makeTask| for the indices [0, count) on |threadsCount| threads
+// and passes their results to |consume| in the order of indices. |makeTask| and |consume|
+// are called on the calling thread. To bound the memory usage only a few tasks are in flight.
+// Stops and returns false as soon as |consume| returns false.
+template <typename MakeTask, typename Consume>
+bool RunInOrder(size_t count, size_t threadsCount, MakeTask && makeTask, Consume && consume)
+{
+  if (threadsCount <= 1)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      if (!consume(makeTask(i)()))
+        return false;
+    }
+    return true;
+  }
+
+  using Result = decltype(makeTask(0)());
+  base::thread_pool::computational::ThreadPool pool(threadsCount);
+  std::deque<std::future<Result>> inFlight;
+  size_t next = 0;
+  try
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      // One extra task keeps the threads busy while the calling thread consumes a result.
+      for (; next < count && inFlight.size() <= threadsCount; ++next)
+        inFlight.push_back(pool.Submit(makeTask(next)));
+
+      auto result = inFlight.front().get();
+      inFlight.pop_front();
+      if (!consume(std::move(result)))
+      {
+        pool.Stop();
+        return false;
+      }
+    }
+  }
+  catch (...)
+  {
+    pool.Stop();
+    throw;
+  }
+  return true;
+}
+
 bool MakeDiffVersion0(FileReader & oldReader, FileReader & newReader, FileWriter & diffFileWriter)
 {
   std::vector<uint8_t> diffBuf;
@@ -91,13 +279,246 @@ generator::mwm_diff::DiffApplicationResult ApplyDiffVersion0(
   LOG(LERROR, ("Could not apply patch with bsdiff:", status));
   return DiffApplicationResult::Failed;
 }
+
+bool MakeDiffVersion1(std::string const & oldMwmPath, std::string const & newMwmPath,
+                      FileReader const & oldReader, FileReader const & newReader,
+                      FileWriter & diffFileWriter, size_t threadsCount)
+{
+  auto const ranges = MakeRanges(oldMwmPath, oldReader.Size(), newMwmPath, newReader.Size());
+
+  WriteToSink(diffFileWriter, static_cast<uint32_t>(VERSION_V1));
+  WriteVarUint(diffFileWriter, static_cast<uint64_t>(ranges.size()));
+
+  size_t copiedCount = 0;
+  size_t patchedCount = 0;
+  auto const makeTask = [&](size_t i) {
+    auto const & range = ranges[i];
+    auto newData = ReadRange(newReader, range.m_newOffset, range.m_newSize);
+    std::vector<uint8_t> oldData;
+    if (range.m_hasOld)
+      oldData = ReadRange(oldReader, range.m_oldOffset, range.m_oldSize);
+
+    return [range, oldData = std::move(oldData), newData = std::move(newData)]() {
+      std::vector<uint8_t> buf;
+      MemWriter<std::vector<uint8_t>> writer(buf);
+      if (range.m_hasOld && oldData == newData)
+      {
+        WriteToSink(writer, static_cast<uint8_t>(Operation::Copy));
+        WriteVarUint(writer, range.m_oldOffset);
+        WriteVarUint(writer, range.m_newSize);
+        return buf;
+      }
+
+      std::vector<uint8_t> data;
+      if (range.m_hasOld)
+      {
+        MemReader oldMemReader(oldData.data(), oldData.size());
+        MemReader newMemReader(newData.data(), newData.size());
+        MemWriter<std::vector<uint8_t>> patchWriter(data);
+        auto const status = bsdiff::CreateBinaryPatch(oldMemReader, newMemReader, patchWriter);
+        if (status != bsdiff::BSDiffStatus::OK)
+        {
+          LOG(LERROR, ("Could not create patch with bsdiff:", status));
+          return std::vector<uint8_t>();
+        }
+
+        WriteToSink(writer, static_cast<uint8_t>(Operation::Patch));
+        WriteVarUint(writer, range.m_oldOffset);
+        WriteVarUint(writer, range.m_oldSize);
+        data = Deflate(data);
+      }
+      else
+      {
+        WriteToSink(writer, static_cast<uint8_t>(Operation::Raw));
+        data = Deflate(newData);
+      }
+
+      WriteVarUint(writer, range.m_newSize);
+      WriteVarUint(writer, static_cast<uint64_t>(data.size()));
+      writer.Write(data.data(), data.size());
+      return buf;
+    };
+  };
+
+  auto const consume = [&](std::vector<uint8_t> && buf) {
+    if (buf.empty())
+      return false;
+
+    switch (static_cast<Operation>(buf.front()))
+    {
+    case Operation::Copy: ++copiedCount; break;
+    case Operation::Patch: ++patchedCount; break;
+    case Operation::Raw: break;
+    }
+    diffFileWriter.Write(buf.data(), buf.size());
+    return true;
+  };
+
+  if (!RunInOrder(ranges.size(), threadsCount, makeTask, consume))
+    return false;
+
+  LOG(LINFO, ("Diff parts:", ranges.size(), "copied:", copiedCount, "patched:", patchedCount));
+  return true;
+}
+
+// The result of a format version 1 operation.
+struct OperationResult
+{
+  Operation m_operation = Operation::Copy;
+  // The copied range of the old mwm.
+  uint64_t m_oldOffset = 0;
+  uint64_t m_size = 0;
+  // The patched or stored bytes.
+  std::vector<uint8_t> m_data;
+  bsdiff::BSDiffStatus m_status = bsdiff::BSDiffStatus::OK;
+};
+
+generator::mwm_diff::DiffApplicationResult ApplyDiffVersion1(
+    FileReader const & oldReader, Writer & newWriter, ReaderSource<FileReader> & diffFileSource,
+    base::Cancellable const & cancellable, size_t threadsCount)
+{
+  using generator::mwm_diff::DiffApplicationResult;
+
+  auto const checkOldRange = [&oldReader](uint64_t offset, uint64_t size) {
+    if (offset > oldReader.Size() || size > oldReader.Size() - offset)
+      MYTHROW(CorruptedDiffException, ("Range", offset, size, "is out of the old mwm"));
+  };
+
+  auto const readData = [&diffFileSource]() {
+    auto const size = ReadVarUint<uint64_t>(diffFileSource);
+    if (size > diffFileSource.Size())
+      MYTHROW(CorruptedDiffException, ("Data size", size, "exceeds the diff size"));
+
+    std::vector<uint8_t> data(base::checked_cast<size_t>(size));
+    diffFileSource.Read(data.data(), data.size());
+    return data;
+  };
+
+  // Reads the next operation from the diff on the calling thread and returns the task
+  // which makes its result.
+  auto const makeTask = [&](size_t) -> std::function<OperationResult()> {
+    auto const operation = static_cast<Operation>(ReadPrimitiveFromSource<uint8_t>(diffFileSource));
+    switch (operation)
+    {
+    case Operation::Copy:
+    {
+      OperationResult result;
+      result.m_oldOffset = ReadVarUint<uint64_t>(diffFileSource);
+      result.m_size = ReadVarUint<uint64_t>(diffFileSource);
+      checkOldRange(result.m_oldOffset, result.m_size);
+      return [result = std::move(result)]() { return result; };
+    }
+    case Operation::Patch:
+    {
+      auto const oldOffset = ReadVarUint<uint64_t>(diffFileSource);
+      auto const oldSize = ReadVarUint<uint64_t>(diffFileSource);
+      checkOldRange(oldOffset, oldSize);
+      auto const newSize = ReadVarUint<uint64_t>(diffFileSource);
+      auto deflatedDiff = readData();
+      auto oldData = ReadRange(oldReader, oldOffset, oldSize);
+      return [&cancellable, newSize, deflatedDiff = std::move(deflatedDiff),
+              oldData = std::move(oldData)]() {
+        auto const diffBuf = Inflate(deflatedDiff);
+        // See the comment in ApplyDiffVersion0 about MemReaderWithExceptions.
+        MemReaderWithExceptions diffMemReader(diffBuf.data(), diffBuf.size());
+        MemReader oldMemReader(oldData.data(), oldData.size());
+
+        OperationResult result;
+        result.m_operation = Operation::Patch;
+        MemWriter<std::vector<uint8_t>> writer(result.m_data);
+        result.m_status =
+            bsdiff::ApplyBinaryPatch(oldMemReader, writer, diffMemReader, cancellable);
+        if (result.m_status == bsdiff::BSDiffStatus::OK && result.m_data.size() != newSize)
+          MYTHROW(CorruptedDiffException, ("Unexpected size of the patched part", newSize));
+        return result;
+      };
+    }
+    case Operation::Raw:
+    {
+      auto const newSize = ReadVarUint<uint64_t>(diffFileSource);
+      auto deflatedData = readData();
+      return [newSize, deflatedData = std::move(deflatedData)]() {
+        OperationResult result;
+        result.m_operation = Operation::Raw;
+        result.m_data = Inflate(deflatedData);
+        if (result.m_data.size() != newSize)
+          MYTHROW(CorruptedDiffException, ("Unexpected size of the stored part", newSize));
+        return result;
+      };
+    }
+    }
+    MYTHROW(CorruptedDiffException, ("Unknown operation", static_cast<uint32_t>(operation)));
+  };
+
+  auto status = bsdiff::BSDiffStatus::OK;
+  std::vector<uint8_t> copyBuf;
+  auto const consume = [&](OperationResult && result) {
+    if (cancellable.IsCancelled())
+    {
+      status = bsdiff::BSDiffStatus::CANCELLED;
+      return false;
+    }
+
+    if (result.m_operation != Operation::Copy)
+    {
+      status = result.m_status;
+      if (status != bsdiff::BSDiffStatus::OK)
+        return false;
+      newWriter.Write(result.m_data.data(), result.m_data.size());
+      return true;
+    }
+
+    copyBuf.resize(kCopyBufferSize);
+    for (uint64_t pos = 0; pos < result.m_size;)
+    {
+      if (cancellable.IsCancelled())
+      {
+        status = bsdiff::BSDiffStatus::CANCELLED;
+        return false;
+      }
+      auto const size = static_cast<size_t>(std::min<uint64_t>(kCopyBufferSize, result.m_size - pos));
+      oldReader.Read(result.m_oldOffset + pos, copyBuf.data(), size);
+      newWriter.Write(copyBuf.data(), size);
+      pos += size;
+    }
+    return true;
+  };
+
+  try
+  {
+    auto const count = ReadVarUint<uint64_t>(diffFileSource);
+    // Every operation takes at least two bytes.
+    if (count > diffFileSource.Size())
+      MYTHROW(CorruptedDiffException, ("Too many operations:", count));
+
+    RunInOrder(base::checked_cast<size_t>(count), threadsCount, makeTask, consume);
+  }
+  catch (CorruptedDiffException const & e)
+  {
+    LOG(LERROR, ("Could not apply patch:", e.Msg()));
+    return DiffApplicationResult::Failed;
+  }
+
+  if (status == bsdiff::BSDiffStatus::CANCELLED)
+  {
+    LOG(LDEBUG, ("Diff application has been cancelled"));
+    return DiffApplicationResult::Cancelled;
+  }
+
+  if (status == bsdiff::BSDiffStatus::OK)
+    return DiffApplicationResult::Ok;
+
+  LOG(LERROR, ("Could not apply patch with bsdiff:", status));
+  return DiffApplicationResult::Failed;
+}
 }  // namespace
 
 namespace generator
 {
 namespace mwm_diff
 {
-bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath, std::string const & diffPath)
+bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
+              std::string const & diffPath, DiffFormat format, size_t threadsCount)
 {
   try
   {
@@ -105,12 +526,12 @@ bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath, st
     FileReader newReader(newMwmPath);
     FileWriter diffFileWriter(diffPath);
 
-    switch (VERSION_LATEST)
+    switch (format)
     {
-    case VERSION_V0: return MakeDiffVersion0(oldReader, newReader, diffFileWriter);
-    default:
-      LOG(LERROR,
-          ("Making mwm diffs with diff format version", VERSION_LATEST, "is not implemented"));
+    case DiffFormat::Whole: return MakeDiffVersion0(oldReader, newReader, diffFileWriter);
+    case DiffFormat::Sectioned:
+      return MakeDiffVersion1(oldMwmPath, newMwmPath, oldReader, newReader, diffFileWriter,
+                              threadsCount);
     }
   }
   catch (Reader::Exception const & e)
@@ -128,7 +549,8 @@ bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath, st
 }
 
 DiffApplicationResult ApplyDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
-                                std::string const & diffPath, base::Cancellable const & cancellable)
+                                std::string const & diffPath, base::Cancellable const & cancellable,
+                                size_t threadsCount)
 {
   try
   {
@@ -143,6 +565,8 @@ DiffApplicationResult ApplyDiff(std::string const & oldMwmPath, std::string cons
     {
     case VERSION_V0:
       return ApplyDiffVersion0(oldReader, newWriter, diffFileSource, cancellable);
+    case VERSION_V1:
+      return ApplyDiffVersion1(oldReader, newWriter, diffFileSource, cancellable, threadsCount);
     default:
       LOG(LERROR, ("Unknown version format of mwm diff:", version));
       return DiffApplicationResult::Failed;
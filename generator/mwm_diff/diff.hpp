@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 namespace base
@@ -18,12 +19,24 @@ enum class DiffApplicationResult
   Cancelled,
 };
 
+enum class DiffFormat
+{
+  // The whole mwm is patched with a single bsdiff patch.
+  Whole,
+  // Every section of the mwm is patched independently, unchanged sections
+  // are copied from the old mwm. Needs much less memory to apply and may be
+  // made and applied in parallel. Not supported by the apps released before it.
+  Sectioned,
+};
+
 // Makes a diff that, when applied to the mwm at |oldMwmPath|, will
 // result in the mwm at |newMwmPath|. The diff is stored at |diffPath|.
 // It is assumed that the files at |oldMwmPath| and |newMwmPath| are valid mwms.
+// |threadsCount| is used only by the DiffFormat::Sectioned format.
 // Returns true on success and false on failure.
 bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
-              std::string const & diffPath);
+              std::string const & diffPath, DiffFormat format = DiffFormat::Whole,
+              size_t threadsCount = 1);
 
 // Applies the diff at |diffPath| to the mwm at |oldMwmPath|. The resulting
 // mwm is stored at |newMwmPath|.
@@ -31,9 +44,10 @@ bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
 // at |diffPath| is a valid mwmdiff.
 // The application process can be stopped via |cancellable| in which case
 // it is up to the caller to clean the partially written file at |diffPath|.
+// Sections of DiffFormat::Sectioned diffs are patched on |threadsCount| threads.
 DiffApplicationResult ApplyDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
                                 std::string const & diffPath,
-                                base::Cancellable const & cancellable);
+                                base::Cancellable const & cancellable, size_t threadsCount = 1);
 
 std::string DebugPrint(DiffApplicationResult const & result);
 }  // namespace mwm_diff
@@ -18,7 +18,7 @@ namespace generator::diff_tests
 using namespace mwm_diff;
 using std::string, std::vector;
 
-UNIT_TEST(IncrementalUpdates_Smoke)
+void TestDiff(DiffFormat format, size_t threadsCount)
 {
   base::ScopedLogAbortLevelChanger ignoreLogError(base::LogLevel::LCRITICAL);
 
@@ -39,9 +39,17 @@ UNIT_TEST(IncrementalUpdates_Smoke)
   }
 
   base::Cancellable cancellable;
-  TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath), ());
-  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable), DiffApplicationResult::Ok,
-             ());
+  TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath, format, threadsCount), ());
+  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable, threadsCount),
+             DiffApplicationResult::Ok, ());
+  TEST(base::IsEqualFiles(newMwmPath1, newMwmPath2), ());
+
+  // Unchanged mwm.
+  TEST(base::CopyFileX(oldMwmPath, newMwmPath1), ());
+  TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath, format, threadsCount), ());
+  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable, threadsCount),
+             DiffApplicationResult::Ok, ());
+  TEST(base::IsEqualFiles(newMwmPath1, newMwmPath2), ());
 
   {
     // Alter the old mwm slightly.
@@ -54,14 +62,14 @@ UNIT_TEST(IncrementalUpdates_Smoke)
     writer.Write(oldMwmContents.data(), oldMwmContents.size());
   }
 
-  TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath), ());
-  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable), DiffApplicationResult::Ok,
-             ());
+  TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath, format, threadsCount), ());
+  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable, threadsCount),
+             DiffApplicationResult::Ok, ());
 
   TEST(base::IsEqualFiles(newMwmPath1, newMwmPath2), ());
 
   cancellable.Cancel();
-  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
+  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable, threadsCount),
              DiffApplicationResult::Cancelled, ());
   cancellable.Reset();
 
@@ -77,7 +85,7 @@ UNIT_TEST(IncrementalUpdates_Smoke)
     writer.Write(diffContents.data(), diffContents.size());
   }
 
-  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
+  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable, threadsCount),
              DiffApplicationResult::Failed, ());
 
   {
@@ -85,7 +93,18 @@ UNIT_TEST(IncrementalUpdates_Smoke)
     FileWriter writer(diffPath);
   }
 
-  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
+  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable, threadsCount),
              DiffApplicationResult::Failed, ());
 }
+
+UNIT_TEST(IncrementalUpdates_Smoke)
+{
+  TestDiff(DiffFormat::Whole, 1 /* threadsCount */);
+}
+
+UNIT_TEST(IncrementalUpdates_Sectioned)
+{
+  TestDiff(DiffFormat::Sectioned, 1 /* threadsCount */);
+  TestDiff(DiffFormat::Sectioned, 4 /* threadsCount */);
+}
 }  // namespace generator::diff_tests
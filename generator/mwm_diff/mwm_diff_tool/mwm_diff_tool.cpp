@@ -1,30 +1,74 @@
 #include "generator/mwm_diff/diff.hpp"
 
 #include "base/cancellable.hpp"
+#include "base/timer.hpp"
 
+#include "std/target_os.hpp"
+
+#include <algorithm>
 #include <iostream>
 #include <cstring>
+#include <thread>
+
+#include <sys/resource.h>
+
+namespace
+{
+// Peak resident set size of the process in megabytes.
+double GetPeakMemoryMb()
+{
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0.0;
+#ifdef OMIM_OS_MAC
+  return usage.ru_maxrss / (1024.0 * 1024.0);  // Bytes.
+#else
+  return usage.ru_maxrss / 1024.0;  // Kilobytes.
+#endif
+}
+}  // namespace
 
 int main(int argc, char ** argv)
 {
   if (argc < 5)
   {
     std::cout <<
-        "Usage: " << argv[0] << " make|apply olderMWMDir newerMWMDir diffDir\n"
+        "Usage: " << argv[0] << " make|apply olderMWMDir newerMWMDir diffDir [whole|sectioned]\n"
         "make\n"
         "  Creates the diff between newer and older MWM versions at `diffDir`\n"
+        "  in the given format (whole by default).\n"
         "apply\n"
         "  Applies the diff at `diffDir` to the mwm at `olderMWMDir` and stores result at `newerMWMDir`.\n"
+        "Time and peak memory usage are reported to compare the formats.\n"
         "WARNING: THERE IS NO MWM VALIDITY CHECK!\n";
     return -1;
   }
   char const * olderMWMDir{argv[2]}, * newerMWMDir{argv[3]}, * diffDir{argv[4]};
+  size_t const threadsCount = std::max(std::thread::hardware_concurrency(), 1U);
+
+  auto const report = [](char const * action, base::Timer const & timer) {
+    std::cout << action << " in " << timer.ElapsedSeconds() << " s, peak memory "
+              << GetPeakMemoryMb() << " MB\n";
+  };
+
+  base::Timer timer;
   if (0 == std::strcmp(argv[1], "make"))
-    return generator::mwm_diff::MakeDiff(olderMWMDir, newerMWMDir, diffDir);
+  {
+    auto format = generator::mwm_diff::DiffFormat::Whole;
+    if (argc > 5 && 0 == std::strcmp(argv[5], "sectioned"))
+      format = generator::mwm_diff::DiffFormat::Sectioned;
+
+    auto const res = generator::mwm_diff::MakeDiff(olderMWMDir, newerMWMDir, diffDir, format,
+                                                   threadsCount);
+    report("Made", timer);
+    return res;
+  }
 
   // apply
   base::Cancellable cancellable;
-  auto const res = generator::mwm_diff::ApplyDiff(olderMWMDir, newerMWMDir, diffDir, cancellable);
+  auto const res = generator::mwm_diff::ApplyDiff(olderMWMDir, newerMWMDir, diffDir, cancellable,
+                                                  threadsCount);
+  report("Applied", timer);
   if (res == generator::mwm_diff::DiffApplicationResult::Ok)
     return 0;
 
@@ -21,11 +21,13 @@
 #include "indexer/road_shields_parser.hpp"
 #include "indexer/scales_patch.hpp"
 #include "indexer/search_string_utils.hpp"
+#include "indexer/flat_trie_builder.hpp"
 #include "indexer/trie_builder.hpp"
 
 #include "platform/platform.hpp"
 
 #include "coding/map_uint32_to_val.hpp"
+#include "coding/read_write_utils.hpp"
 #include "coding/reader_writer_ops.hpp"
 #include "coding/succinct_mapper.hpp"
 #include "coding/writer.hpp"
@@ -507,7 +509,7 @@ void BuildAddressTable(FilesContainerR & container, std::string const & addressD
 
 namespace indexer
 {
-void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter);
+void BuildSearchIndex(FilesContainerR & container, bool flat, Writer & indexWriter);
 
 bool BuildSearchIndexFromDataFile(std::string const & country, feature::GenerateInfo const & info,
                                   bool forceRebuild, uint32_t threadsCount)
@@ -528,7 +530,7 @@ bool BuildSearchIndexFromDataFile(std::string const & country, feature::Generate
   {
     {
       FileWriter writer(indexFilePath);
-      BuildSearchIndex(readContainer, writer);
+      BuildSearchIndex(readContainer, info.m_flatSearchIndex, writer);
       LOG(LINFO, ("Search index size =", writer.Size()));
     }
     if (filename != WORLD_FILE_NAME && filename != WORLD_COASTS_FILE_NAME)
@@ -547,13 +549,25 @@ bool BuildSearchIndexFromDataFile(std::string const & country, feature::Generate
         CHECK(coding::IsAlign8(startOffset), ());
 
         search::SearchIndexHeader header;
+        if (info.m_flatSearchIndex)
+          header.m_version = search::SearchIndexHeader::Version::V3;
         header.Serialize(*writer);
 
         uint64_t bytesWritten = writer->Pos();
         coding::WritePadding(*writer, bytesWritten);
 
         header.m_indexOffset = base::asserted_cast<uint32_t>(writer->Pos() - startOffset);
-        rw_ops::Reverse(FileReader(indexFilePath), *writer);
+        if (info.m_flatSearchIndex)
+        {
+          // The flat trie is built in the final order.
+          FileReader indexReader(indexFilePath);
+          ReaderSource<FileReader> indexSource(indexReader);
+          rw::ReadAndWrite(indexSource, *writer);
+        }
+        else
+        {
+          rw_ops::Reverse(FileReader(indexFilePath), *writer);
+        }
         header.m_indexSize =
             base::asserted_cast<uint32_t>(writer->Pos() - header.m_indexOffset - startOffset);
 
@@ -583,7 +597,7 @@ bool BuildSearchIndexFromDataFile(std::string const & country, feature::Generate
   return true;
 }
 
-void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter)
+void BuildSearchIndex(FilesContainerR & container, bool flat, Writer & indexWriter)
 {
   using Key = strings::UniString;
   using Value = Uint64IndexValue;
@@ -602,8 +616,16 @@ void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter)
   std::sort(searchIndexKeyValuePairs.begin(), searchIndexKeyValuePairs.end());
   LOG(LINFO, ("End sorting strings:", timer.ElapsedSeconds()));
 
-  trie::Build<Writer, Key, ValueList<Value>, SingleValueSerializer<Value>>(
-      indexWriter, serializer, searchIndexKeyValuePairs);
+  if (flat)
+  {
+    trie::BuildFlat<Writer, Key, ValueList<Value>, SingleValueSerializer<Value>>(
+        indexWriter, serializer, searchIndexKeyValuePairs);
+  }
+  else
+  {
+    trie::Build<Writer, Key, ValueList<Value>, SingleValueSerializer<Value>>(
+        indexWriter, serializer, searchIndexKeyValuePairs);
+  }
 
   LOG(LINFO, ("End building search index, elapsed seconds:", timer.ElapsedSeconds()));
 }
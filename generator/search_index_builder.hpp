@@ -6,7 +6,8 @@
 
 namespace indexer
 {
-// Builds the latest version of the search index section and writes it to the mwm file.
+// Builds the latest version of the search index section (or the flat trie one if
+// |info.m_flatSearchIndex| is set) and writes it to the mwm file.
 // An attempt to rewrite the search index of an old mwm may result in a future crash
 // when using search because this function does not update mwm's version. This results
 // in version mismatch when trying to read the index.
@@ -0,0 +1,114 @@
+#include "generator/speed_profiles_builder.hpp"
+
+#include "generator/routing_helpers.hpp"
+
+#include "routing/speed_profiles_serialization.hpp"
+
+#include "coding/file_writer.hpp"
+#include "coding/files_container.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+
+#include "defines.hpp"
+
+namespace routing_builder
+{
+using namespace routing;
+using std::string;
+
+namespace
+{
+char constexpr kDelim[] = ", \t\r\n";
+}  // namespace
+
+bool ParseSpeedProfiles(string const & filePath, OsmWayToSpeedProfile & osmWayToProfile)
+{
+  osmWayToProfile.clear();
+
+  std::ifstream stream(filePath);
+  if (!stream)
+    return false;
+
+  string line;
+  while (std::getline(stream, line))
+  {
+    strings::SimpleTokenizer iter(line, kDelim);
+    if (!iter)  // empty line
+      continue;
+
+    uint64_t osmId = 0;
+    if (!strings::to_uint(*iter, osmId))
+      return false;
+    ++iter;
+
+    uint32_t isForward = 0;
+    if (!iter || !strings::to_uint(*iter, isForward) || isForward > 1)
+      return false;
+    ++iter;
+
+    SpeedProfiles::Profile profile;
+    for (auto & bucketSpeed : profile)
+    {
+      double speed = 0.0;
+      if (!iter || !strings::to_double(*iter, speed) || speed < 0.0)
+        return false;
+      ++iter;
+
+      bucketSpeed = speed == 0.0 ? SpeedProfiles::kNoSpeed
+                                 : static_cast<uint8_t>(std::clamp(std::lround(speed), 1L, 255L));
+    }
+
+    if (iter)
+      return false;
+
+    auto const res = osmWayToProfile.emplace(
+        std::make_pair(base::MakeOsmWay(osmId), isForward == 1), profile);
+    if (!res.second)
+      return false;
+  }
+  return true;
+}
+
+void BuildSpeedProfilesSection(string const & dataPath, string const & osmToFeaturePath,
+                               string const & speedProfilesPath)
+{
+  OsmWayToSpeedProfile osmWayToProfile;
+  if (!ParseSpeedProfiles(speedProfilesPath, osmWayToProfile))
+  {
+    LOG(LERROR, ("An error happened while parsing speed profiles from", speedProfilesPath));
+    return;
+  }
+
+  OsmIdToFeatureIds osmIdToFeatureIds;
+  CHECK(ParseWaysOsmIdToFeatureIdMapping(osmToFeaturePath, osmIdToFeatureIds), ());
+
+  SpeedProfilesSerializer::KeyToProfile keyToProfile;
+  for (auto const & [way, profile] : osmWayToProfile)
+  {
+    auto const it = osmIdToFeatureIds.find(way.first);
+    if (it == osmIdToFeatureIds.cend())
+      continue;
+
+    for (auto const featureId : it->second)
+      keyToProfile.emplace(SpeedProfiles::MakeKey(featureId, way.second), profile);
+  }
+
+  if (keyToProfile.empty())
+    return;
+
+  FilesContainerW cont(dataPath, FileWriter::OP_WRITE_EXISTING);
+  auto writer = cont.GetWriter(SPEED_PROFILES_FILE_TAG);
+  auto const startPos = writer->Pos();
+  SpeedProfilesSerializer::Serialize(keyToProfile, *writer);
+
+  LOG(LINFO, ("Serialized", keyToProfile.size(), "speed profiles of", osmWayToProfile.size(),
+              "ways for", dataPath, "size:", writer->Pos() - startPos, "bytes"));
+}
+}  // namespace routing_builder
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "routing/speed_profiles.hpp"
+
+#include "base/geo_object_id.hpp"
+
+#include <map>
+#include <string>
+#include <utility>
+
+namespace routing_builder
+{
+using OsmWayToSpeedProfile =
+    std::map<std::pair<base::GeoObjectId, bool /* isForward */>, routing::SpeedProfiles::Profile>;
+
+/// \brief Parses csv file with |filePath| and stores the result in |osmWayToProfile|.
+/// Every line of the file is
+/// <osm way id>, <1 for forward, 0 for backward direction>, <speed of bucket 0>, ...,
+/// <speed of bucket routing::SpeedProfiles::kBucketsCount - 1>
+/// where speeds are typical speeds in km/h at 15 minutes of local time of day and 0 means
+/// there's no data for the bucket.
+bool ParseSpeedProfiles(std::string const & filePath, OsmWayToSpeedProfile & osmWayToProfile);
+
+/// \brief Builds speed profiles section in mwm with |dataPath| with profiles of
+/// |speedProfilesPath| csv file. The profile of a way is used for all its features.
+void BuildSpeedProfilesSection(std::string const & dataPath, std::string const & osmToFeaturePath,
+                               std::string const & speedProfilesPath);
+}  // namespace routing_builder
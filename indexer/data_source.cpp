@@ -1,4 +1,5 @@
 #include "indexer/data_source.hpp"
+#include "indexer/features_offsets_table.hpp"
 #include "indexer/scale_index.hpp"
 #include "indexer/unique_index.hpp"
 
@@ -19,7 +20,6 @@ public:
 
   ReadMWMFunctor(FeatureSourceFactory const & factory, Fn const & fn) : m_factory(factory), m_fn(fn)
   {
-    m_stop = []() { return false; };
   }
 
   ReadMWMFunctor(FeatureSourceFactory const & factory, Fn const & fn,
@@ -42,7 +42,11 @@ public:
       // feature ids from it, gets untouched features by ids from |src| and applies |m_fn| by
       // ProcessElement.
       feature::DataHeader const & header = mwmValue->GetHeader();
-      CheckUniqueIndexes checkUnique;
+      CheckUniqueIndexes checkUnique(mwmValue->m_table ? mwmValue->m_table->size() : 0);
+      auto const processValue = [&](uint64_t /* key */, uint32_t value) {
+        if (checkUnique(value))
+          m_fn(value, *src);
+      };
 
       // In case of WorldCoasts we should pass correct scale in ForEachInIntervalAndScale.
       auto const lastScale = header.GetLastScale();
@@ -53,16 +57,20 @@ public:
       covering::Intervals const & intervals = cov.Get<RectId::DEPTH_LEVELS>(lastScale);
       ScaleIndex<ModelReaderPtr> index(mwmValue->m_cont.GetReader(INDEX_FILE_TAG), mwmValue->m_factory);
 
-      // iterate through intervals
-      for (auto const & i : intervals)
+      if (m_stop)
       {
-        index.ForEachInIntervalAndScale(i.first, i.second, scale, [&](uint64_t /* key */, uint32_t value)
+        // Intervals are ordered by distance, so they are read one by one to stop as soon as
+        // possible.
+        for (auto const & i : intervals)
         {
-          if (checkUnique(value))
-            m_fn(value, *src);
-        });
-        if (m_stop())
-          break;
+          index.ForEachInIntervalAndScale(i.first, i.second, scale, processValue);
+          if (m_stop())
+            break;
+        }
+      }
+      else
+      {
+        index.ForEachInIntervalsAndScale(intervals, scale, processValue);
       }
     }
 
@@ -79,9 +87,10 @@ private:
   DataSource::StopSearchCallback m_stop;
 };
 
-void ReadFeatureType(std::function<void(FeatureType &)> const & fn, FeatureSource & src, uint32_t index)
+// Loads the feature into |ft| which is reused for all the features of one reading call.
+void ReadFeatureType(std::function<void(FeatureType &)> const & fn, FeatureSource & src,
+                     uint32_t index, FeatureType & ft)
 {
-  std::unique_ptr<FeatureType> ft;
   switch (src.GetFeatureStatus(index))
   {
   case FeatureStatus::Deleted:
@@ -89,17 +98,16 @@ void ReadFeatureType(std::function<void(FeatureType &)> const & fn, FeatureSourc
   case FeatureStatus::Created:
   case FeatureStatus::Modified:
   {
-    ft = src.GetModifiedFeature(index);
+    CHECK(src.GetModifiedFeature(index, ft), ());
     break;
   }
   case FeatureStatus::Untouched:
   {
-    ft = src.GetOriginalFeature(index);
+    src.GetOriginalFeature(index, ft);
     break;
   }
   }
-  CHECK(ft, ());
-  fn(*ft);
+  fn(ft);
 }
 }  //  namespace
 
@@ -145,6 +153,19 @@ std::unique_ptr<FeatureType> FeaturesLoaderGuard::GetFeatureByIndex(uint32_t ind
   return GetOriginalFeatureByIndex(index);
 }
 
+bool FeaturesLoaderGuard::GetFeatureByIndex(uint32_t index, FeatureType & ft) const
+{
+  if (!m_handle.IsAlive())
+    return false;
+
+  ASSERT_NOT_EQUAL(FeatureStatus::Deleted, m_source->GetFeatureStatus(index),
+                   ("Deleted feature was cached. It should not be here. Please review your code."));
+
+  if (!m_source->GetModifiedFeature(index, ft))
+    m_source->GetOriginalFeature(index, ft);
+  return true;
+}
+
 std::unique_ptr<FeatureType> FeaturesLoaderGuard::GetOriginalFeatureByIndex(uint32_t index) const
 {
   return m_handle.IsAlive() ? m_source->GetOriginalFeature(index) : nullptr;
@@ -235,8 +256,9 @@ void DataSource::ForEachFeatureIDInRect(FeatureIdCallback const & f, m2::RectD c
 
 void DataSource::ForEachInRect(FeatureCallback const & f, m2::RectD const & rect, int scale) const
 {
-  auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-    ReadFeatureType(f, src, index);
+  FeatureType ft;
+  auto readFeatureType = [&f, &ft](uint32_t index, FeatureSource & src) {
+    ReadFeatureType(f, src, index, ft);
   };
 
   ReadMWMFunctor readFunctor(*m_factory, readFeatureType);
@@ -248,8 +270,9 @@ void DataSource::ForClosestToPoint(FeatureCallback const & f, StopSearchCallback
 {
   auto const rect = mercator::RectByCenterXYAndSizeInMeters(center, sizeM);
 
-  auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-    ReadFeatureType(f, src, index);
+  FeatureType ft;
+  auto readFeatureType = [&f, &ft](uint32_t index, FeatureSource & src) {
+    ReadFeatureType(f, src, index, ft);
   };
   ReadMWMFunctor readFunctor(*m_factory, readFeatureType, stop);
   ForEachInIntervals(readFunctor, covering::CoveringMode::Spiral, rect, scale);
@@ -257,8 +280,9 @@ void DataSource::ForClosestToPoint(FeatureCallback const & f, StopSearchCallback
 
 void DataSource::ForEachInScale(FeatureCallback const & f, int scale) const
 {
-  auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-    ReadFeatureType(f, src, index);
+  FeatureType ft;
+  auto readFeatureType = [&f, &ft](uint32_t index, FeatureSource & src) {
+    ReadFeatureType(f, src, index, ft);
   };
 
   ReadMWMFunctor readFunctor(*m_factory, readFeatureType);
@@ -272,8 +296,9 @@ void DataSource::ForEachInRectForMWM(FeatureCallback const & f, m2::RectD const
   if (handle.IsAlive())
   {
     covering::CoveringGetter cov(rect, covering::ViewportWithLowLevels);
-    auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-      ReadFeatureType(f, src, index);
+    FeatureType ft;
+    auto readFeatureType = [&f, &ft](uint32_t index, FeatureSource & src) {
+      ReadFeatureType(f, src, index, ft);
     };
 
     ReadMWMFunctor readFunctor(*m_factory, readFeatureType);
@@ -285,6 +310,8 @@ void DataSource::ReadFeatures(FeatureCallback const & fn, std::vector<FeatureID>
 {
   ASSERT(is_sorted(features.begin(), features.end()), ());
 
+  // One feature object is reused for all the features to avoid allocations for every feature.
+  FeatureType ft;
   auto fidIter = features.begin();
   auto const endIter = features.end();
   while (fidIter != endIter)
@@ -301,14 +328,12 @@ void DataSource::ReadFeatures(FeatureCallback const & fn, std::vector<FeatureID>
         ASSERT_NOT_EQUAL(
             FeatureStatus::Deleted, fts,
             ("Deleted feature was cached. It should not be here. Please review your code."));
-        std::unique_ptr<FeatureType> ft;
         if (fts == FeatureStatus::Modified || fts == FeatureStatus::Created)
-          ft = src->GetModifiedFeature(fidIter->m_index);
+          CHECK(src->GetModifiedFeature(fidIter->m_index, ft), ());
         else
-          ft = src->GetOriginalFeature(fidIter->m_index);
+          src->GetOriginalFeature(fidIter->m_index, ft);
 
-        CHECK(ft, ());
-        fn(*ft);
+        fn(ft);
       } while (++fidIter != endIter && id == fidIter->m_mwmId);
     }
     else
@@ -98,6 +98,10 @@ public:
   std::unique_ptr<FeatureType> GetOriginalOrEditedFeatureByIndex(uint32_t index) const;
   /// Everyone, except Editor core, should use this method.
   std::unique_ptr<FeatureType> GetFeatureByIndex(uint32_t index) const;
+  /// Same as above but loads the feature into |ft| reusing its buffers. Prefer it when many
+  /// features are loaded one after another.
+  /// \returns false if the mwm is not alive, |ft| is left in unspecified state then.
+  bool GetFeatureByIndex(uint32_t index, FeatureType & ft) const;
   size_t GetNumFeatures() const { return m_source->GetNumFeatures(); }
 
 private:
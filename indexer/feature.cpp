@@ -178,21 +178,24 @@ uint8_t ReadByte(TSource & src)
 
 FeatureType::FeatureType(SharedLoadInfo const * loadInfo, vector<uint8_t> && buffer,
                          indexer::MetadataDeserializer * metadataDeserializer)
-  : m_loadInfo(loadInfo)
-  , m_data(std::move(buffer))
-  , m_metadataDeserializer(metadataDeserializer)
+  : m_data(std::move(buffer))
 {
-  CHECK(m_loadInfo, ());
-
-  m_header = Header(m_data);
+  Init(loadInfo, metadataDeserializer);
 }
 
 std::unique_ptr<FeatureType> FeatureType::CreateFromMapObject(osm::MapObject const & emo)
 {
-  auto ft = std::unique_ptr<FeatureType>(new FeatureType());
+  auto ft = std::make_unique<FeatureType>();
+  ft->ResetFromMapObject(emo);
+  return ft;
+}
+
+void FeatureType::ResetFromMapObject(osm::MapObject const & emo)
+{
+  Clear();
 
   HeaderGeomType headerGeomType = HeaderGeomType::Point;
-  ft->m_limitRect.MakeEmpty();
+  m_limitRect.MakeEmpty();
 
   switch (emo.GetGeomType())
   {
@@ -201,46 +204,76 @@ std::unique_ptr<FeatureType> FeatureType::CreateFromMapObject(osm::MapObject con
     UNREACHABLE();
   case feature::GeomType::Point:
     headerGeomType = HeaderGeomType::Point;
-    ft->m_center = emo.GetMercator();
-    ft->m_limitRect.Add(ft->m_center);
+    m_center = emo.GetMercator();
+    m_limitRect.Add(m_center);
     break;
   case feature::GeomType::Line:
     headerGeomType = HeaderGeomType::Line;
-    assign_range(ft->m_points, emo.GetPoints());
-    for (auto const & p : ft->m_points)
-      ft->m_limitRect.Add(p);
+    assign_range(m_points, emo.GetPoints());
+    for (auto const & p : m_points)
+      m_limitRect.Add(p);
     break;
   case feature::GeomType::Area:
     headerGeomType = HeaderGeomType::Area;
-    assign_range(ft->m_triangles, emo.GetTriangesAsPoints());
-    for (auto const & p : ft->m_triangles)
-      ft->m_limitRect.Add(p);
+    assign_range(m_triangles, emo.GetTriangesAsPoints());
+    for (auto const & p : m_triangles)
+      m_limitRect.Add(p);
     break;
   }
 
-  ft->m_parsed.m_points = ft->m_parsed.m_triangles = true;
+  m_parsed.m_points = m_parsed.m_triangles = true;
 
-  ft->m_params.name = emo.GetNameMultilang();
+  m_params.name = emo.GetNameMultilang();
   string const & house = emo.GetHouseNumber();
   if (house.empty())
-    ft->m_params.house.Clear();
+    m_params.house.Clear();
   else
-    ft->m_params.house.Set(house);
-  ft->m_parsed.m_common = true;
+    m_params.house.Set(house);
+  m_parsed.m_common = true;
 
-  emo.AssignMetadata(ft->m_metadata);
-  ft->m_parsed.m_metadata = true;
-  ft->m_parsed.m_metaIds = true;
+  emo.AssignMetadata(m_metadata);
+  m_parsed.m_metadata = true;
+  m_parsed.m_metaIds = true;
 
   CHECK_LESS_OR_EQUAL(emo.GetTypes().Size(), feature::kMaxTypesCount, ());
-  copy(emo.GetTypes().begin(), emo.GetTypes().end(), ft->m_types.begin());
+  copy(emo.GetTypes().begin(), emo.GetTypes().end(), m_types.begin());
+
+  m_parsed.m_types = true;
+  m_header = CalculateHeader(emo.GetTypes().Size(), headerGeomType, m_params);
+  m_parsed.m_header2 = true;
 
-  ft->m_parsed.m_types = true;
-  ft->m_header = CalculateHeader(emo.GetTypes().Size(), headerGeomType, ft->m_params);
-  ft->m_parsed.m_header2 = true;
+  m_id = emo.GetID();
+}
 
-  ft->m_id = emo.GetID();
-  return ft;
+void FeatureType::Clear()
+{
+  m_header = 0;
+  m_types = {};
+  m_id = {};
+  m_params.MakeZero();
+  m_center = {};
+  m_limitRect = {};
+  m_points.clear();
+  m_triangles.clear();
+  m_metadata = {};
+  m_metaIds.clear();
+  m_loadInfo = nullptr;
+  m_data.clear();
+  m_metadataDeserializer = nullptr;
+  m_parsed.Reset();
+  m_offsets.Reset();
+  m_ptsSimpMask = 0;
+  m_innerStats = {};
+}
+
+void FeatureType::Init(SharedLoadInfo const * loadInfo,
+                       indexer::MetadataDeserializer * metadataDeserializer)
+{
+  m_loadInfo = loadInfo;
+  m_metadataDeserializer = metadataDeserializer;
+  CHECK(m_loadInfo, ());
+
+  m_header = Header(m_data);
 }
 
 feature::GeomType FeatureType::GetGeomType() const
@@ -27,15 +27,20 @@ class MapObject;
 // Lazy feature loader. Loads needed data and caches it.
 class FeatureType
 {
-  FeatureType() = default;
-
 public:
   using GeometryOffsets = buffer_vector<uint32_t, feature::DataHeader::kMaxScalesCount>;
 
+  /// Empty feature to be used as a reusable slot, see FeaturesLoaderGuard::GetFeatureByIndex().
+  /// Buffers of the slot are retained between loads, so loading of many features into the same
+  /// slot doesn't allocate for every feature.
+  FeatureType() = default;
+
   FeatureType(feature::SharedLoadInfo const * loadInfo, std::vector<uint8_t> && buffer,
               indexer::MetadataDeserializer * metadataDeserializer);
 
   static std::unique_ptr<FeatureType> CreateFromMapObject(osm::MapObject const & emo);
+  /// Same as CreateFromMapObject() but reuses this object.
+  void ResetFromMapObject(osm::MapObject const & emo);
 
   feature::GeomType GetGeomType() const;
 
@@ -218,6 +223,14 @@ private:
     }
   };
 
+  friend class FeaturesVector;
+
+  // Resets all the fields but keeps the capacity of the buffers.
+  void Clear();
+  // Sets the shared data and parses the header of m_data.
+  void Init(feature::SharedLoadInfo const * loadInfo,
+            indexer::MetadataDeserializer * metadataDeserializer);
+
   void ParseTypes();
   void ParseCommon();
   void ParseMetadata();
@@ -106,6 +106,8 @@ public:
 
   m2::RectD const & GetRect() const { return m_rect; }
 
+  /// Intervals are sorted and don't overlap in all the modes except Spiral, where they go
+  /// in the order of distance from the rect center.
   template <int DEPTH_LEVELS>
   Intervals const & Get(int scale)
   {
@@ -125,19 +127,13 @@ public:
         m2::CellId<DEPTH_LEVELS> id = GetRectIdAsIs<DEPTH_LEVELS>(m_rect);
         while (id.Level() >= cellDepth)
           id = id.Parent();
-        AppendLowerLevels<DEPTH_LEVELS>(id, cellDepth, [this, ind](Interval const & interval) {
-          m_res[ind].push_back(interval);
+        Intervals intervals;
+        AppendLowerLevels<DEPTH_LEVELS>(id, cellDepth, [&intervals](Interval const & interval) {
+          intervals.push_back(interval);
         });
 
-        // Check for optimal result intervals.
-#if 0
-        size_t oldSize = m_res[ind].size();
-        Intervals res;
-        SortAndMergeIntervals(m_res[ind], res);
-        if (res.size() != oldSize)
-          LOG(LINFO, ("Old =", oldSize, "; New =", res.size()));
-        res.swap(m_res[ind]);
-#endif
+        // Sorted intervals are read from the index in one pass, see ScaleIndex.
+        SortAndMergeIntervals(std::move(intervals), m_res[ind]);
         break;
       }
 
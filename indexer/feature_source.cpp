@@ -41,6 +41,14 @@ std::unique_ptr<FeatureType> FeatureSource::GetOriginalFeature(uint32_t index) c
   return ft;
 }
 
+void FeatureSource::GetOriginalFeature(uint32_t index, FeatureType & ft) const
+{
+  ASSERT(m_handle.IsAlive(), ());
+  ASSERT(m_vector, ());
+  m_vector->GetByIndex(index, ft);
+  ft.SetID({ GetMwmId(), index });
+}
+
 FeatureStatus FeatureSource::GetFeatureStatus(uint32_t index) const
 {
   return FeatureStatus::Untouched;
@@ -48,6 +56,8 @@ FeatureStatus FeatureSource::GetFeatureStatus(uint32_t index) const
 
 std::unique_ptr<FeatureType> FeatureSource::GetModifiedFeature(uint32_t index) const { return {}; }
 
+bool FeatureSource::GetModifiedFeature(uint32_t index, FeatureType & ft) const { return false; }
+
 void FeatureSource::ForEachAdditionalFeature(m2::RectD const & rect, int scale,
                                              std::function<void(uint32_t)> const & fn) const
 {
@@ -34,12 +34,15 @@ public:
   size_t GetNumFeatures() const;
 
   std::unique_ptr<FeatureType> GetOriginalFeature(uint32_t index) const;
+  void GetOriginalFeature(uint32_t index, FeatureType & ft) const;
 
   MwmSet::MwmId const & GetMwmId() const { return m_handle.GetId(); }
 
   virtual FeatureStatus GetFeatureStatus(uint32_t index) const;
 
   virtual std::unique_ptr<FeatureType> GetModifiedFeature(uint32_t index) const;
+  // Loads the modified feature into |ft|. Returns false if there is no modified feature.
+  virtual bool GetModifiedFeature(uint32_t index, FeatureType & ft) const;
 
   // Runs |fn| for each feature, that is not present in the mwm.
   virtual void ForEachAdditionalFeature(m2::RectD const & rect, int scale,
@@ -27,9 +27,18 @@ void FeaturesVector::InitRecordsReader()
 }
 
 std::unique_ptr<FeatureType> FeaturesVector::GetByIndex(uint32_t index) const
+{
+  auto ft = std::make_unique<FeatureType>();
+  GetByIndex(index, *ft);
+  return ft;
+}
+
+void FeaturesVector::GetByIndex(uint32_t index, FeatureType & ft) const
 {
   auto const ftOffset = m_table ? m_table->GetFeatureOffset(index) : index;
-  return std::make_unique<FeatureType>(&m_loadInfo, m_recordReader->ReadRecord(ftOffset), m_metaDeserializer);
+  ft.Clear();
+  m_recordReader->ReadRecord(ftOffset, ft.m_data);
+  ft.Init(&m_loadInfo, m_metaDeserializer);
 }
 
 size_t FeaturesVector::GetNumFeatures() const
@@ -24,6 +24,8 @@ public:
                  indexer::MetadataDeserializer * metaDeserializer);
 
   std::unique_ptr<FeatureType> GetByIndex(uint32_t index) const;
+  /// Loads the feature into |ft| reusing its buffers.
+  void GetByIndex(uint32_t index, FeatureType & ft) const;
 
   size_t GetNumFeatures() const;
 
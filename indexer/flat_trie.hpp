@@ -0,0 +1,187 @@
+#pragma once
+
+#include "indexer/trie.hpp"
+
+#include "coding/endianness.hpp"
+#include "coding/reader.hpp"
+
+#include "base/assert.hpp"
+#include "base/buffer_vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Flat trie format:
+// [1: label width in bytes]
+// [4: nodes count] [4: edges count] [4: labels count] [4: values size]
+// [4: edges begin] x (nodes count + 1)
+// [4: label begin] x (edges count + 1)
+// [label width: label char] x labels count
+// [4: values begin] x (nodes count + 1)
+// [values]
+//
+// Nodes are numbered in the level order starting from the root, so edges of every node are
+// consecutive and the edge number i leads to the node number i + 1. Edges of the node v are
+// [edges begin[v], edges begin[v + 1]), chars of the edge e are
+// [label begin[e], label begin[e + 1]), serialized value list of the node v occupies
+// [values begin[v], values begin[v + 1]) bytes of [values].
+//
+// All fields are fixed size, so a node is traversed with three reads and without any parsing.
+// Chains of nodes without values and with a single child are merged into one edge as
+// in the trie_builder.hpp format.
+
+namespace trie
+{
+template <typename Reader, typename ValueList, typename Serializer>
+class FlatTrie
+{
+public:
+  using Value = typename ValueList::Value;
+
+  // A node of the trie. It is just an index, so it may be freely copied and stored.
+  class Cursor
+  {
+  public:
+    Cursor() = default;
+
+    bool operator==(Cursor const & rhs) const { return m_node == rhs.m_node; }
+    bool operator!=(Cursor const & rhs) const { return !(*this == rhs); }
+
+  private:
+    friend class FlatTrie;
+
+    explicit Cursor(uint32_t node) : m_node(node) {}
+
+    uint32_t m_node = 0;
+  };
+
+  FlatTrie(Reader const & reader, Serializer const & serializer)
+    : m_reader(reader), m_serializer(serializer)
+  {
+    ReaderSource<Reader> source(m_reader);
+    m_labelWidth = ReadPrimitiveFromSource<uint8_t>(source);
+    m_nodesCount = ReadPrimitiveFromSource<uint32_t>(source);
+    m_edgesCount = ReadPrimitiveFromSource<uint32_t>(source);
+    uint32_t const labelsCount = ReadPrimitiveFromSource<uint32_t>(source);
+    uint32_t const valuesSize = ReadPrimitiveFromSource<uint32_t>(source);
+    CHECK(m_labelWidth >= 1 && m_labelWidth <= sizeof(TrieChar), (m_labelWidth));
+    CHECK_GREATER(m_nodesCount, 0, ());
+    CHECK_EQUAL(m_edgesCount + 1, m_nodesCount, ());
+
+    m_edgesBeginOffset = source.Pos();
+    m_labelBeginOffset = m_edgesBeginOffset + (uint64_t{m_nodesCount} + 1) * sizeof(uint32_t);
+    m_labelsOffset = m_labelBeginOffset + (uint64_t{m_edgesCount} + 1) * sizeof(uint32_t);
+    m_valuesBeginOffset = m_labelsOffset + uint64_t{labelsCount} * m_labelWidth;
+    m_valuesOffset = m_valuesBeginOffset + (uint64_t{m_nodesCount} + 1) * sizeof(uint32_t);
+    CHECK_EQUAL(m_valuesOffset + valuesSize, m_reader.Size(), ());
+  }
+
+  Cursor GetRoot() const { return Cursor(0); }
+
+  uint32_t GetEdgesCount(Cursor const & cursor) const
+  {
+    auto const range = ReadRange(m_edgesBeginOffset, cursor.m_node);
+    return range.second - range.first;
+  }
+
+  // Calls |fn| with the label begin, the label end and the child cursor for every edge
+  // of |cursor| in order. Labels are valid during the call only. Nothing is allocated
+  // unless the node has too many edges or too long labels.
+  template <typename Fn>
+  void ForEachEdge(Cursor const & cursor, Fn && fn) const
+  {
+    auto const edges = ReadRange(m_edgesBeginOffset, cursor.m_node);
+    if (edges.first == edges.second)
+      return;
+    ASSERT_LESS_OR_EQUAL(edges.second, m_edgesCount, ());
+
+    uint32_t const edgesCount = edges.second - edges.first;
+    buffer_vector<uint32_t, 16> labelBegin(edgesCount + 1);
+    ReadUints(m_labelBeginOffset, edges.first, labelBegin.data(), labelBegin.size());
+
+    uint32_t const labelsCount = labelBegin.back() - labelBegin.front();
+    buffer_vector<uint8_t, 128> raw(size_t{labelsCount} * m_labelWidth);
+    m_reader.Read(m_labelsOffset + uint64_t{labelBegin.front()} * m_labelWidth, raw.data(),
+                  raw.size());
+
+    buffer_vector<TrieChar, 64> labels(labelsCount);
+    for (size_t i = 0; i < labels.size(); ++i)
+    {
+      TrieChar c = 0;
+      for (uint8_t b = 0; b < m_labelWidth; ++b)
+        c |= static_cast<TrieChar>(raw[i * m_labelWidth + b]) << (8 * b);
+      labels[i] = c;
+    }
+
+    for (uint32_t i = 0; i < edgesCount; ++i)
+    {
+      TrieChar const * const begin = labels.data() + (labelBegin[i] - labelBegin.front());
+      TrieChar const * const end = labels.data() + (labelBegin[i + 1] - labelBegin.front());
+      fn(begin, end, Cursor(edges.first + i + 1));
+    }
+  }
+
+  bool HasValues(Cursor const & cursor) const
+  {
+    auto const range = ReadRange(m_valuesBeginOffset, cursor.m_node);
+    return range.first != range.second;
+  }
+
+  // Deserializes the value list of |cursor| and calls |toDo| for every value.
+  template <typename ToDo>
+  void ForEachValue(Cursor const & cursor, ToDo && toDo) const
+  {
+    auto const range = ReadRange(m_valuesBeginOffset, cursor.m_node);
+    if (range.first == range.second)
+      return;
+
+    ReaderSource<Reader> source(m_reader.SubReader(m_valuesOffset + range.first,
+                                                   range.second - range.first));
+    ValueList values;
+    values.Deserialize(source, m_serializer);
+    values.ForEach(toDo);
+  }
+
+private:
+  std::pair<uint32_t, uint32_t> ReadRange(uint64_t arrayOffset, uint32_t index) const
+  {
+    ASSERT_LESS(index, m_nodesCount, ());
+    uint32_t range[2];
+    ReadUints(arrayOffset, index, range, 2);
+    return {range[0], range[1]};
+  }
+
+  void ReadUints(uint64_t arrayOffset, uint32_t index, uint32_t * dst, size_t count) const
+  {
+    m_reader.Read(arrayOffset + uint64_t{index} * sizeof(uint32_t), dst, count * sizeof(uint32_t));
+    for (size_t i = 0; i < count; ++i)
+      dst[i] = SwapIfBigEndianMacroBased(dst[i]);
+  }
+
+  Reader m_reader;
+  Serializer m_serializer;
+
+  uint8_t m_labelWidth = 0;
+  uint32_t m_nodesCount = 0;
+  uint32_t m_edgesCount = 0;
+  uint64_t m_edgesBeginOffset = 0;
+  uint64_t m_labelBeginOffset = 0;
+  uint64_t m_labelsOffset = 0;
+  uint64_t m_valuesBeginOffset = 0;
+  uint64_t m_valuesOffset = 0;
+};
+
+template <typename Reader, typename ValueList, typename Serializer, typename ToDo, typename String>
+void ForEachRef(FlatTrie<Reader, ValueList, Serializer> const & trie,
+                typename FlatTrie<Reader, ValueList, Serializer>::Cursor const & cursor,
+                ToDo && toDo, String const & s)
+{
+  trie.ForEachValue(cursor, [&toDo, &s](auto const & value) { toDo(s, value); });
+  trie.ForEachEdge(cursor, [&](TrieChar const * begin, TrieChar const * end, auto const & child) {
+    String s1(s);
+    s1.insert(s1.end(), begin, end);
+    ForEachRef(trie, child, toDo, s1);
+  });
+}
+}  // namespace trie
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "indexer/trie.hpp"
+
+#include "coding/byte_stream.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// See indexer/flat_trie.hpp for the format description.
+
+namespace trie
+{
+namespace flat_trie_builder
+{
+// Keys [m_begin, m_end) of the sorted data with a common prefix of length m_depth.
+struct Range
+{
+  size_t m_begin = 0;
+  size_t m_end = 0;
+  size_t m_depth = 0;
+};
+
+inline uint8_t GetLabelWidth(std::vector<TrieChar> const & labels)
+{
+  TrieChar const maxChar = labels.empty() ? 0 : *std::max_element(labels.begin(), labels.end());
+  uint8_t width = 1;
+  while (width < sizeof(TrieChar) && (maxChar >> (8 * width)) != 0)
+    ++width;
+  return width;
+}
+
+template <typename Sink>
+void WriteUints(Sink & sink, std::vector<uint32_t> const & values)
+{
+  for (auto const v : values)
+    WriteToSink(sink, v);
+}
+}  // namespace flat_trie_builder
+
+// Builds the flat trie from the sorted |data|. Unlike trie::Build(), the output is written
+// in the final order and doesn't need to be reversed.
+template <typename Sink, typename Key, typename ValueList, typename Serializer>
+void BuildFlat(Sink & sink, Serializer const & serializer,
+               std::vector<std::pair<Key, typename ValueList::Value>> const & data)
+{
+  using Value = typename ValueList::Value;
+  using flat_trie_builder::Range;
+
+  CHECK(std::is_sorted(data.begin(), data.end()), ());
+
+  std::vector<uint32_t> edgesBegin;
+  std::vector<uint32_t> labelBegin;
+  std::vector<TrieChar> labels;
+  std::vector<uint32_t> valuesBegin;
+  std::vector<uint8_t> values;
+  PushBackByteSink<std::vector<uint8_t>> valuesSink(values);
+
+  // Nodes are visited in the level order, the queue holds the nodes whose edges are not
+  // written yet.
+  std::queue<Range> nodes;
+  nodes.push({0, data.size(), 0});
+  std::vector<Value> nodeValues;
+  while (!nodes.empty())
+  {
+    auto const node = nodes.front();
+    nodes.pop();
+
+    edgesBegin.push_back(base::asserted_cast<uint32_t>(labelBegin.size()));
+    valuesBegin.push_back(base::asserted_cast<uint32_t>(values.size()));
+
+    // Keys which end at the node go first in the sorted order.
+    size_t i = node.m_begin;
+    nodeValues.clear();
+    for (; i < node.m_end && data[i].first.size() == node.m_depth; ++i)
+    {
+      if (nodeValues.empty() || !(nodeValues.back() == data[i].second))
+        nodeValues.push_back(data[i].second);
+    }
+    if (!nodeValues.empty())
+    {
+      ValueList valueList;
+      valueList.Init(nodeValues);
+      valueList.Serialize(valuesSink, serializer);
+    }
+
+    while (i < node.m_end)
+    {
+      auto const & first = data[i].first;
+      auto const c = first[node.m_depth];
+      size_t j = i + 1;
+      while (j < node.m_end && data[j].first[node.m_depth] == c)
+        ++j;
+
+      // All the keys of the child share the common prefix of the first and the last ones.
+      // A node with values or with several children ends the edge.
+      auto const & last = data[j - 1].first;
+      size_t depth = node.m_depth + 1;
+      while (depth < first.size() && depth < last.size() && first[depth] == last[depth])
+        ++depth;
+
+      labelBegin.push_back(base::asserted_cast<uint32_t>(labels.size()));
+      labels.insert(labels.end(), first.begin() + node.m_depth, first.begin() + depth);
+      nodes.push({i, j, depth});
+      i = j;
+    }
+  }
+
+  edgesBegin.push_back(base::asserted_cast<uint32_t>(labelBegin.size()));
+  labelBegin.push_back(base::asserted_cast<uint32_t>(labels.size()));
+  valuesBegin.push_back(base::asserted_cast<uint32_t>(values.size()));
+
+  uint8_t const labelWidth = flat_trie_builder::GetLabelWidth(labels);
+  WriteToSink(sink, labelWidth);
+  WriteToSink(sink, base::asserted_cast<uint32_t>(edgesBegin.size() - 1));
+  WriteToSink(sink, base::asserted_cast<uint32_t>(labelBegin.size() - 1));
+  WriteToSink(sink, base::asserted_cast<uint32_t>(labels.size()));
+  WriteToSink(sink, base::asserted_cast<uint32_t>(values.size()));
+
+  flat_trie_builder::WriteUints(sink, edgesBegin);
+  flat_trie_builder::WriteUints(sink, labelBegin);
+  for (auto const c : labels)
+  {
+    uint8_t bytes[sizeof(TrieChar)];
+    for (uint8_t b = 0; b < labelWidth; ++b)
+      bytes[b] = static_cast<uint8_t>(c >> (8 * b));
+    sink.Write(bytes, labelWidth);
+  }
+  flat_trie_builder::WriteUints(sink, valuesBegin);
+  sink.Write(values.data(), values.size());
+}
+}  // namespace trie
@@ -76,4 +76,36 @@ UNIT_TEST(FeaturesVectorTest_ParseMetadata)
   });
   TEST_EQUAL(expected, actual, ());
 }
+
+UNIT_TEST(FeaturesVectorTest_LoadIntoSlot)
+{
+  LocalCountryFile localFile = LocalCountryFile::MakeForTesting("minsk-pass");
+
+  FrozenDataSource dataSource;
+  auto result = dataSource.RegisterMap(localFile);
+  TEST_EQUAL(result.second, MwmSet::RegResult::Success, ());
+
+  FeaturesLoaderGuard const guard(dataSource, result.first);
+  TEST_GREATER(guard.GetNumFeatures(), 0, ());
+
+  // Features of different geometry types go one after another, so every field of the slot
+  // must be reset between loads.
+  FeatureType slot;
+  for (uint32_t i = 0; i < guard.GetNumFeatures(); ++i)
+  {
+    auto ft = guard.GetFeatureByIndex(i);
+    TEST(ft, (i));
+    TEST(guard.GetFeatureByIndex(i, slot), (i));
+
+    TEST_EQUAL(ft->GetID(), slot.GetID(), ());
+    TEST(feature::TypesHolder(*ft).Equals(feature::TypesHolder(slot)), (i));
+    TEST_EQUAL(ft->GetGeomType(), slot.GetGeomType(), (i));
+    TEST_EQUAL(ft->GetNames(), slot.GetNames(), (i));
+    TEST_EQUAL(ft->GetHouseNumber(), slot.GetHouseNumber(), (i));
+    TEST_EQUAL(ft->GetMetadata(feature::Metadata::FMD_POSTCODE),
+               slot.GetMetadata(feature::Metadata::FMD_POSTCODE), (i));
+    TEST_EQUAL(ft->GetLimitRect(FeatureType::BEST_GEOMETRY),
+               slot.GetLimitRect(FeatureType::BEST_GEOMETRY), (i));
+  }
+}
 } // namespace features_vector_test
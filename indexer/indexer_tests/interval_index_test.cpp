@@ -9,6 +9,8 @@
 #include "base/macros.hpp"
 #include "base/stl_helpers.hpp"
 
+#include <algorithm>
+#include <random>
 #include <utility>
 #include <vector>
 
@@ -291,3 +293,56 @@ UNIT_TEST(IntervalIndex_Simple5)
     TEST_EQUAL(values, vector<uint32_t>(expected, expected + ARRAY_SIZE(expected)), ());
   }
 }
+
+UNIT_TEST(IntervalIndex_ForEachInIntervals)
+{
+  uint32_t const kKeyBits = 24;
+  mt19937 rng(0);
+
+  for (uint32_t const bitsPerLevel : {4, 5, 8})
+  {
+    vector<CellIdFeaturePairForTest> data;
+    for (uint32_t i = 0; i < 5000; ++i)
+    {
+      // Keys are grouped to get both bitmap and list nodes.
+      uint64_t const group = rng() % 64;
+      data.emplace_back((group << 18) + rng() % (1 << 12), i);
+    }
+    sort(data.begin(), data.end(), [](auto const & lhs, auto const & rhs) {
+      return make_pair(lhs.GetCell(), lhs.GetValue()) < make_pair(rhs.GetCell(), rhs.GetValue());
+    });
+
+    vector<char> serialIndex;
+    MemWriter<vector<char>> writer(serialIndex);
+    IntervalIndexBuilder(kKeyBits, 1, bitsPerLevel).BuildIndex(writer, data.begin(), data.end());
+    MemReader reader(&serialIndex[0], serialIndex.size());
+    IntervalIndex<MemReader, uint32_t> index(reader);
+
+    for (size_t test = 0; test < 100; ++test)
+    {
+      // Sorted non-overlapping intervals, the last one may end after KeyEnd().
+      vector<uint64_t> bounds(2 * (1 + rng() % 20));
+      for (auto & b : bounds)
+        b = rng() % (index.KeyEnd() + 1000);
+      sort(bounds.begin(), bounds.end());
+      bounds.erase(unique(bounds.begin(), bounds.end()), bounds.end());
+      if (bounds.size() % 2 != 0)
+        bounds.pop_back();
+
+      vector<pair<uint64_t, uint64_t>> intervals;
+      vector<uint32_t> expected;
+      for (size_t i = 0; i < bounds.size(); i += 2)
+      {
+        intervals.emplace_back(bounds[i], bounds[i + 1]);
+        index.ForEach(IndexValueInserter(expected), bounds[i], bounds[i + 1]);
+      }
+
+      vector<uint32_t> values;
+      index.ForEachInIntervals(IndexValueInserter(values), intervals);
+
+      sort(expected.begin(), expected.end());
+      sort(values.begin(), values.end());
+      TEST_EQUAL(values, expected, (bitsPerLevel, intervals));
+    }
+  }
+}
@@ -56,6 +56,15 @@ public:
           [&](uint64_t /* key */, uint32_t value) { indices.push_back(value); });
     }
 
+    vector<uint32_t> batchedIndices;
+    index.ForEachInIntervalsAndScale(
+        covering.Get<RectId::DEPTH_LEVELS>(scaleForIntervals), scaleForZoomLevels,
+        [&](uint64_t /* key */, uint32_t value) { batchedIndices.push_back(value); });
+    sort(batchedIndices.begin(), batchedIndices.end());
+    auto sortedIndices = indices;
+    sort(sortedIndices.begin(), sortedIndices.end());
+    TEST_EQUAL(sortedIndices, batchedIndices, ());
+
     FeaturesLoaderGuard loader(m_dataSource, id);
 
     Names names;
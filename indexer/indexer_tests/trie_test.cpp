@@ -1,5 +1,7 @@
 #include "testing/testing.hpp"
 
+#include "indexer/flat_trie.hpp"
+#include "indexer/flat_trie_builder.hpp"
 #include "indexer/trie.hpp"
 #include "indexer/trie_builder.hpp"
 #include "indexer/trie_reader.hpp"
@@ -219,7 +221,75 @@ UNIT_TEST(TrieBuilder_Build)
         trie::ForEachRef(*root, addKeyValuePair, Key{});
         sort(res.begin(), res.end());
         TEST_EQUAL(v, res, ());
+
+        vector<uint8_t> flatBuf;
+        PushBackByteSink<vector<uint8_t>> flatSink(flatBuf);
+        trie::BuildFlat<PushBackByteSink<vector<uint8_t>>, Key, ValueList<uint32_t>>(
+            flatSink, serializer, v);
+
+        trie::FlatTrie<MemReader, ValueList<uint32_t>, SingleValueSerializer<uint32_t>> const
+            flatTrie(MemReader(flatBuf.data(), flatBuf.size()), serializer);
+        res.clear();
+        trie::ForEachRef(flatTrie, flatTrie.GetRoot(), addKeyValuePair, Key{});
+        sort(res.begin(), res.end());
+        TEST_EQUAL(v, res, ());
       }
     }
   }
 }
+
+UNIT_TEST(FlatTrie_Edges)
+{
+  using Key = buffer_vector<trie::TrieChar, 8>;
+  using Trie = trie::FlatTrie<MemReader, ValueList<uint32_t>, SingleValueSerializer<uint32_t>>;
+
+  // Chars above 0xFFFF need three bytes per label char.
+  trie::TrieChar const kWide = 0x1F600;
+  vector<pair<Key, uint32_t>> const data = {{Key{'a', 'b', 'c'}, 1},
+                                            {Key{'a', 'b', 'c'}, 2},
+                                            {Key{'a', 'b', 'c', 'd', 'e'}, 3},
+                                            {Key{'a', 'b', 'x', 'y'}, 4},
+                                            {Key{'z', kWide}, 5}};
+
+  vector<uint8_t> buf;
+  PushBackByteSink<vector<uint8_t>> sink(buf);
+  SingleValueSerializer<uint32_t> serializer;
+  trie::BuildFlat<PushBackByteSink<vector<uint8_t>>, Key, ValueList<uint32_t>>(sink, serializer,
+                                                                               data);
+  TEST_EQUAL(buf[0], 3, ());
+
+  Trie const trie(MemReader(buf.data(), buf.size()), serializer);
+
+  auto const getEdges = [&trie](Trie::Cursor const & cursor) {
+    vector<pair<Key, Trie::Cursor>> edges;
+    trie.ForEachEdge(cursor, [&edges](auto begin, auto end, Trie::Cursor const & child) {
+      edges.emplace_back(Key(begin, end), child);
+    });
+    return edges;
+  };
+  auto const getValues = [&trie](Trie::Cursor const & cursor) {
+    vector<uint32_t> values;
+    trie.ForEachValue(cursor, [&values](uint32_t v) { values.push_back(v); });
+    return values;
+  };
+
+  auto const root = getEdges(trie.GetRoot());
+  TEST_EQUAL(root.size(), 2, ());
+  TEST_EQUAL(root[0].first, Key({'a', 'b'}), ());
+  TEST_EQUAL(root[1].first, Key({'z', kWide}), ());
+  TEST(!trie.HasValues(trie.GetRoot()), ());
+  TEST_EQUAL(getValues(root[1].second), vector<uint32_t>({5}), ());
+
+  auto const ab = getEdges(root[0].second);
+  TEST_EQUAL(ab.size(), 2, ());
+  TEST_EQUAL(ab[0].first, Key({'c'}), ());
+  TEST_EQUAL(ab[1].first, Key({'x', 'y'}), ());
+  TEST_EQUAL(getValues(ab[0].second), vector<uint32_t>({1, 2}), ());
+  TEST_EQUAL(getValues(ab[1].second), vector<uint32_t>({4}), ());
+
+  auto const abc = getEdges(ab[0].second);
+  TEST_EQUAL(abc.size(), 1, ());
+  TEST_EQUAL(abc[0].first, Key({'d', 'e'}), ());
+  TEST_EQUAL(trie.GetEdgesCount(abc[0].second), 0, ());
+  TEST_EQUAL(getValues(abc[0].second), vector<uint32_t>({3}), ());
+}
@@ -7,7 +7,10 @@
 #include "base/assert.hpp"
 #include "base/buffer_vector.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 class IntervalIndexBase
 {
@@ -71,7 +74,196 @@ public:
     }
   }
 
+  // Same as ForEach() for every [beg, end) interval of |intervals|, but the tree is walked once:
+  // every node is read at most once and the children of a node needed by the intervals are read
+  // with a few coalesced reads. |intervals| must be sorted and must not overlap,
+  // see covering::SortAndMergeIntervals().
+  template <typename F, typename Intervals>
+  void ForEachInIntervals(F const & f, Intervals const & intervals) const
+  {
+    if (m_Header.m_Levels == 0)
+      return;
+
+    KeyRanges ranges;
+    for (auto const & interval : intervals)
+    {
+      uint64_t const beg = std::min(static_cast<uint64_t>(interval.first), KeyEnd());
+      uint64_t const end = std::min(static_cast<uint64_t>(interval.second), KeyEnd());
+      if (beg >= end)
+        continue;
+      ASSERT(ranges.empty() || ranges.back().second < beg, ("Intervals are not sorted or overlap."));
+      ranges.emplace_back(beg, end - 1);  // end is inclusive in ranges.
+    }
+    if (ranges.empty())
+      return;
+
+    // Nodes of the same level are processed one after another, so buffers are reused for all
+    // the nodes of a level.
+    std::vector<LevelBuffers> buffers(m_Header.m_Levels + 1);
+    auto & root = buffers[m_Header.m_Levels].m_data;
+    root.resize(m_LevelOffsets[m_Header.m_Levels + 1] - m_LevelOffsets[m_Header.m_Levels]);
+    m_Reader.Read(m_LevelOffsets[m_Header.m_Levels], root.data(), root.size());
+
+    ForEachNodeInRanges(f, ranges.data(), ranges.data() + ranges.size(), m_Header.m_Levels,
+                        root.data(), static_cast<uint32_t>(root.size()), 0 /* keyBase */, buffers);
+  }
+
 private:
+  // Inclusive [beg, end] key ranges.
+  using KeyRange = std::pair<uint64_t, uint64_t>;
+  using KeyRanges = buffer_vector<KeyRange, 64>;
+
+  // Children of a node are stored one after another, so the children needed by a query are read
+  // with one read if the gaps between them are small.
+  static uint32_t constexpr kMaxReadGap = 1024;
+  static uint32_t constexpr kMaxReadSize = 64 * 1024;
+
+  struct ChildToVisit
+  {
+    uint32_t m_offset;
+    uint32_t m_size;
+    uint64_t m_keyBase;
+    KeyRange const * m_rangesBeg;
+    KeyRange const * m_rangesEnd;
+  };
+
+  struct LevelBuffers
+  {
+    // Coalesced data of the nodes of the level.
+    std::vector<uint8_t> m_data;
+    // Children of the current node of the level to visit.
+    std::vector<ChildToVisit> m_children;
+  };
+
+  template <typename F>
+  void ForEachLeafInRanges(F const & f, KeyRange const * rangesBeg, KeyRange const * rangesEnd,
+                           uint8_t const * data, uint32_t size, uint64_t keyBase) const
+  {
+    ArrayByteSource src(data);
+
+    void const * pEnd = data + size;
+    Value value = 0;
+    while (src.Ptr() < pEnd)
+    {
+      uint32_t key = 0;
+      src.Read(&key, m_Header.m_LeafBytes);
+      key = SwapIfBigEndianMacroBased(key);
+      uint64_t const fullKey = keyBase + key;
+      while (fullKey > rangesBeg->second)
+      {
+        if (++rangesBeg == rangesEnd)
+          return;
+      }
+      value += ReadVarInt<int64_t>(src);
+      if (fullKey >= rangesBeg->first)
+        f(fullKey, value);
+    }
+  }
+
+  // |data| is the serialized node, |rangesBeg|..|rangesEnd| are the ranges which intersect
+  // the node.
+  template <typename F>
+  void ForEachNodeInRanges(F const & f, KeyRange const * rangesBeg, KeyRange const * rangesEnd,
+                           int level, uint8_t const * data, uint32_t size, uint64_t keyBase,
+                           std::vector<LevelBuffers> & buffers) const
+  {
+    ASSERT(size > 0, ());
+    ASSERT(rangesBeg != rangesEnd, ());
+
+    if (level == 0)
+    {
+      ForEachLeafInRanges(f, rangesBeg, rangesEnd, data, size, keyBase);
+      return;
+    }
+
+    uint8_t const skipBits = (m_Header.m_LeafBytes << 3) + (level - 1) * m_Header.m_BitsPerLevel;
+    uint64_t const levelBytesFF = (1ULL << skipBits) - 1;
+    uint64_t const lastKey = (rangesEnd - 1)->second;
+
+    auto & children = buffers[level].m_children;
+    children.clear();
+    // Adds the child if it intersects the ranges.
+    auto const addChild = [&](uint32_t i, uint32_t childOffset, uint32_t childSize) {
+      uint64_t const childBeg = keyBase + (uint64_t{i} << skipBits);
+      uint64_t const childEnd = childBeg + levelBytesFF;
+      while (rangesBeg->second < childBeg)
+        ++rangesBeg;
+      if (rangesBeg->first > childEnd)
+        return;
+
+      auto childRangesEnd = rangesBeg + 1;
+      while (childRangesEnd != rangesEnd && childRangesEnd->first <= childEnd)
+        ++childRangesEnd;
+      children.push_back({childOffset, childSize, childBeg, rangesBeg, childRangesEnd});
+    };
+    auto const isAfterRanges = [&](uint32_t i) {
+      return keyBase + (uint64_t{i} << skipBits) > lastKey;
+    };
+
+    ArrayByteSource src(data);
+    uint32_t const offsetAndFlag = ReadVarUint<uint32_t>(src);
+    uint32_t childOffset = offsetAndFlag >> 1;
+    if (offsetAndFlag & 1)
+    {
+      // Reading bitmap.
+      uint8_t const * pBitmap = static_cast<uint8_t const *>(src.Ptr());
+      src.Advance(BitmapSize(m_Header.m_BitsPerLevel));
+      uint32_t const childrenCount = 1U << m_Header.m_BitsPerLevel;
+      for (uint32_t i = 0; i < childrenCount && !isAfterRanges(i); ++i)
+      {
+        if (bits::GetBit(pBitmap, i))
+        {
+          uint32_t const childSize = ReadVarUint<uint32_t>(src);
+          addChild(i, childOffset, childSize);
+          childOffset += childSize;
+        }
+      }
+    }
+    else
+    {
+      void const * pEnd = data + size;
+      while (src.Ptr() < pEnd)
+      {
+        uint8_t const i = src.ReadByte();
+        if (isAfterRanges(i))
+          break;
+        uint32_t const childSize = ReadVarUint<uint32_t>(src);
+        addChild(i, childOffset, childSize);
+        childOffset += childSize;
+      }
+    }
+
+    auto & buffer = buffers[level - 1].m_data;
+    uint32_t const levelOffset = m_LevelOffsets[level - 1];
+    for (size_t first = 0; first < children.size();)
+    {
+      uint32_t const readBeg = children[first].m_offset;
+      uint32_t readEnd = readBeg + children[first].m_size;
+      size_t last = first + 1;
+      for (; last < children.size(); ++last)
+      {
+        auto const & child = children[last];
+        uint32_t const childEnd = child.m_offset + child.m_size;
+        if (child.m_offset - readEnd > kMaxReadGap || childEnd - readBeg > kMaxReadSize)
+          break;
+        readEnd = childEnd;
+      }
+
+      // The buffer only grows to avoid filling it on every resize.
+      if (buffer.size() < readEnd - readBeg)
+        buffer.resize(readEnd - readBeg);
+      m_Reader.Read(levelOffset + readBeg, buffer.data(), readEnd - readBeg);
+      for (size_t i = first; i < last; ++i)
+      {
+        auto const & child = children[i];
+        ForEachNodeInRanges(f, child.m_rangesBeg, child.m_rangesEnd, level - 1,
+                            buffer.data() + (child.m_offset - readBeg), child.m_size,
+                            child.m_keyBase, buffers);
+      }
+      first = last;
+    }
+  }
+
   template <typename F>
   void ForEachLeaf(F const & f, uint64_t const beg, uint64_t const end,
       uint32_t const offset, uint32_t const size,
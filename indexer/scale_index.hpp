@@ -63,6 +63,20 @@ public:
     }
   }
 
+  /// Same as ForEachInIntervalAndScale() for every interval of |intervals|, but every index tree
+  /// is walked only once. |intervals| must be sorted and must not overlap.
+  template <typename Intervals>
+  void ForEachInIntervalsAndScale(Intervals const & intervals, int scale,
+                                  std::function<void(uint64_t, uint32_t)> const & fn) const
+  {
+    auto const scaleBucket = BucketByScale(scale);
+    if (scaleBucket < m_IndexForScale.size())
+    {
+      for (size_t i = 0; i <= scaleBucket; ++i)
+        m_IndexForScale[i]->ForEachInIntervals(fn, intervals);
+    }
+  }
+
 private:
   std::vector<std::unique_ptr<IntervalIndex<Reader, uint32_t>>> m_IndexForScale;
 };
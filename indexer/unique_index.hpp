@@ -8,6 +8,11 @@
 class CheckUniqueIndexes
 {
 public:
+  CheckUniqueIndexes() = default;
+  /// @param[in] indexesCount Upper bound of indexes, e.g. features count of mwm. Memory is reserved
+  /// at once, so the bitset doesn't reallocate when it grows.
+  explicit CheckUniqueIndexes(size_t indexesCount) { m_v.reserve(indexesCount); }
+
   bool operator()(uint32_t index) { return Add(index); }
 
 private:
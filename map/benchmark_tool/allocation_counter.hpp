@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+namespace bench
+{
+/// @return Number of allocations with global operator new made by the process so far.
+/// @note Global operator new is replaced in allocation_counter.cpp, so it works in
+/// benchmark_tool only.
+uint64_t GetAllocationsCount();
+}  // namespace bench
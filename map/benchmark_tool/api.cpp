@@ -53,4 +53,36 @@ void AllResult::Print()
             " summ:" << m_all << " ]" << endl;
   }
 }
+
+void LoadingAllocsResult::Print()
+{
+  if (m_count == 0)
+  {
+    cout << "No features" << endl;
+    return;
+  }
+
+  cout << fixed << setprecision(3);
+  cout << "FEATURES: " << m_count << endl;
+  cout << "OBJECT[ allocs:" << m_objectAllocs
+       << " per feature:" << static_cast<double>(m_objectAllocs) / m_count
+       << " time:" << m_objectTime << " ]" << endl;
+  cout << "SLOT[ allocs:" << m_slotAllocs
+       << " per feature:" << static_cast<double>(m_slotAllocs) / m_count
+       << " time:" << m_slotTime << " ]" << endl;
+}
+
+void FeatureIdsResult::Print()
+{
+  if (m_rects == 0)
+  {
+    cout << "No rects" << endl;
+    return;
+  }
+
+  cout << fixed << setprecision(6);
+  cout << "RECTS: " << m_rects << " IDS: " << m_ids << endl;
+  cout << "INTERVALS[ time:" << m_intervalsTime << " ]" << endl;
+  cout << "BATCHED[ time:" << m_batchedTime << " ]" << endl;
+}
 }  // namespace bench
@@ -43,6 +43,44 @@ namespace bench
     double m_all = 0.0;
   };
 
+  class LoadingAllocsResult
+  {
+  public:
+    void Print();
+
+    size_t m_count = 0;
+
+    // Loading of every feature into a new FeatureType object.
+    uint64_t m_objectAllocs = 0;
+    double m_objectTime = 0.0;
+
+    // Loading of every feature into the same reused FeatureType slot.
+    uint64_t m_slotAllocs = 0;
+    double m_slotTime = 0.0;
+  };
+
+  class FeatureIdsResult
+  {
+  public:
+    void Print();
+
+    size_t m_rects = 0;
+    size_t m_ids = 0;
+
+    // Reading of the index interval by interval.
+    double m_intervalsTime = 0.0;
+    // Reading of all the intervals at once.
+    double m_batchedTime = 0.0;
+  };
+
   /// @param[in] count number of times to run benchmark
   void RunFeaturesLoadingBenchmark(std::string filePath, std::pair<int, int> scaleR, AllResult & res);
+
+  /// Loads all the features of the mwm with FeaturesLoaderGuard into new objects and into
+  /// a reused slot and counts allocations of both ways.
+  void RunFeaturesLoadingAllocsBenchmark(std::string filePath, LoadingAllocsResult & res);
+
+  /// Collects feature ids for the tiles of the scales range as the renderer does and compares
+  /// reading of the scale index interval by interval and all the intervals at once.
+  void RunFeatureIdsBenchmark(std::string filePath, std::pair<int, int> scaleR, FeatureIdsResult & res);
 }  // namespace bench
@@ -1,16 +1,26 @@
+#include "map/benchmark_tool/allocation_counter.hpp"
 #include "map/benchmark_tool/api.hpp"
 
 #include "map/features_fetcher.hpp"
 
+#include "indexer/cell_id.hpp"
+#include "indexer/data_source.hpp"
+#include "indexer/feature_covering.hpp"
 #include "indexer/feature_visibility.hpp"
+#include "indexer/features_offsets_table.hpp"
+#include "indexer/scale_index.hpp"
 #include "indexer/scales.hpp"
+#include "indexer/unique_index.hpp"
 
 #include "platform/platform.hpp"
 
+#include "defines.hpp"
+
 #include "base/file_name_utils.hpp"
 #include "base/macros.hpp"
 #include "base/timer.hpp"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -97,6 +107,71 @@ namespace
       }
     }
   }
+
+  class FeatureIdsReader
+  {
+  public:
+    explicit FeatureIdsReader(MwmValue const & value)
+      : m_index(value.m_cont.GetReader(INDEX_FILE_TAG), value.m_factory)
+      , m_lastScale(value.GetHeader().GetLastScale())
+      , m_featuresCount(value.m_table ? value.m_table->size() : 0)
+    {
+    }
+
+    // Reads ids of the features of |rect| the same way as DataSource::ForEachFeatureIDInRect().
+    size_t Read(m2::RectD const & rect, int scale, bool batched, double & time) const
+    {
+      base::Timer timer;
+
+      covering::CoveringGetter cov(rect, covering::LowLevelsOnly);
+      auto const & intervals = cov.Get<RectId::DEPTH_LEVELS>(m_lastScale);
+      scale = std::min(scale, m_lastScale);
+
+      size_t count = 0;
+      CheckUniqueIndexes checkUnique(batched ? m_featuresCount : 0);
+      auto const fn = [&](uint64_t /* key */, uint32_t value) {
+        if (checkUnique(value))
+          ++count;
+      };
+
+      if (batched)
+      {
+        m_index.ForEachInIntervalsAndScale(intervals, scale, fn);
+      }
+      else
+      {
+        for (auto const & i : intervals)
+          m_index.ForEachInIntervalAndScale(i.first, i.second, scale, fn);
+      }
+
+      time += timer.ElapsedSeconds();
+      return count;
+    }
+
+  private:
+    ScaleIndex<ModelReaderPtr> m_index;
+    int m_lastScale;
+    size_t m_featuresCount;
+  };
+
+  // Parses the feature as the renderer does.
+  void ParseFeature(FeatureType & ft)
+  {
+    UNUSED_VALUE(feature::TypesHolder(ft));
+    UNUSED_VALUE(ft.GetNames());
+    UNUSED_VALUE(ft.IsEmptyGeometry(FeatureType::BEST_GEOMETRY));
+  }
+
+  template <typename Load>
+  void MeasureLoading(uint32_t count, Load && load, uint64_t & allocs, double & time)
+  {
+    uint64_t const allocsBefore = GetAllocationsCount();
+    base::Timer timer;
+    for (uint32_t i = 0; i < count; ++i)
+      load(i);
+    time = timer.ElapsedSeconds();
+    allocs = GetAllocationsCount() - allocsBefore;
+  }
 }
 
 void RunFeaturesLoadingBenchmark(string fileName, pair<int, int> scaleRange, AllResult & res)
@@ -121,4 +196,81 @@ void RunFeaturesLoadingBenchmark(string fileName, pair<int, int> scaleRange, All
 
   RunBenchmark(src, r.first.GetInfo()->m_bordersRect, scaleRange, res);
 }
+
+void RunFeatureIdsBenchmark(string fileName, pair<int, int> scaleRange, FeatureIdsResult & res)
+{
+  base::GetNameFromFullPath(fileName);
+  base::GetNameWithoutExt(fileName);
+
+  FeaturesFetcher src;
+  auto const r = src.RegisterMap(platform::LocalCountryFile::MakeForTesting(std::move(fileName)));
+  if (r.second != MwmSet::RegResult::Success)
+    return;
+
+  auto const handle = src.GetDataSource().GetMwmHandleById(r.first);
+  CHECK(handle.IsAlive(), ());
+  FeatureIdsReader const reader(*handle.GetValue());
+
+  vector<m2::RectD> rects = {r.first.GetInfo()->m_bordersRect};
+  while (!rects.empty())
+  {
+    m2::RectD const rect = rects.back();
+    rects.pop_back();
+
+    int const scale = scales::GetScaleLevel(rect);
+    size_t count = 1;
+    if (scale >= scaleRange.first)
+    {
+      // The first reading warms up the reader caches for both ways.
+      double warmUpTime = 0.0;
+      count = reader.Read(rect, scale, false /* batched */, warmUpTime);
+      CHECK_EQUAL(count, reader.Read(rect, scale, false /* batched */, res.m_intervalsTime), ());
+      CHECK_EQUAL(count, reader.Read(rect, scale, true /* batched */, res.m_batchedTime), ());
+
+      ++res.m_rects;
+      res.m_ids += count;
+    }
+
+    if (count != 0 && scale < scaleRange.second)
+    {
+      m2::RectD r1, r2;
+      rect.DivideByGreaterSize(r1, r2);
+      rects.push_back(r1);
+      rects.push_back(r2);
+    }
+  }
+}
+
+void RunFeaturesLoadingAllocsBenchmark(string fileName, LoadingAllocsResult & res)
+{
+  base::GetNameFromFullPath(fileName);
+  base::GetNameWithoutExt(fileName);
+
+  FeaturesFetcher src;
+  auto const r = src.RegisterMap(platform::LocalCountryFile::MakeForTesting(std::move(fileName)));
+  if (r.second != MwmSet::RegResult::Success)
+    return;
+
+  FeaturesLoaderGuard const guard(src.GetDataSource(), r.first);
+  auto const count = static_cast<uint32_t>(guard.GetNumFeatures());
+  res.m_count = count;
+
+  auto const loadObject = [&guard](uint32_t index) {
+    auto ft = guard.GetFeatureByIndex(index);
+    CHECK(ft, (index));
+    ParseFeature(*ft);
+  };
+
+  // Warm up the reader caches, so both ways are measured in the same conditions.
+  for (uint32_t i = 0; i < count; ++i)
+    loadObject(i);
+
+  MeasureLoading(count, loadObject, res.m_objectAllocs, res.m_objectTime);
+
+  FeatureType slot;
+  MeasureLoading(count, [&guard, &slot](uint32_t index) {
+    CHECK(guard.GetFeatureByIndex(index, slot), (index));
+    ParseFeature(slot);
+  }, res.m_slotAllocs, res.m_slotTime);
+}
 }  // namespace bench
@@ -13,6 +13,10 @@ DEFINE_string(input, "", "MWM file name in the data directory");
 DEFINE_int32(lowS, 10, "Low processing scale");
 DEFINE_int32(highS, 17, "High processing scale");
 DEFINE_bool(print_scales, false, "Print geometry scales for MWM and exit");
+DEFINE_bool(allocs, false, "Count allocations of loading all the features of MWM into new objects "
+                           "and into a reused one, print them and exit");
+DEFINE_bool(feature_ids, false, "Measure collecting of feature ids for tiles of scales from lowS "
+                                "to highS, print results and exit");
 
 int main(int argc, char ** argv)
 {
@@ -37,6 +41,22 @@ int main(int argc, char ** argv)
     return 0;
   }
 
+  if (FLAGS_feature_ids)
+  {
+    bench::FeatureIdsResult res;
+    bench::RunFeatureIdsBenchmark(FLAGS_input, make_pair(FLAGS_lowS, FLAGS_highS), res);
+    res.Print();
+    return 0;
+  }
+
+  if (FLAGS_allocs)
+  {
+    bench::LoadingAllocsResult res;
+    bench::RunFeaturesLoadingAllocsBenchmark(FLAGS_input, res);
+    res.Print();
+    return 0;
+  }
+
   if (!FLAGS_input.empty())
   {
     using namespace bench;
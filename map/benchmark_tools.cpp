@@ -10,11 +10,13 @@
 #include "platform/http_client.hpp"
 #include "platform/platform.hpp"
 
+#include "coding/file_writer.hpp"
 #include "coding/reader.hpp"
 
 #include "geometry/mercator.hpp"
 
 #include "base/file_name_utils.hpp"
+#include "base/timer.hpp"
 
 #include <algorithm>
 #include <atomic>
@@ -39,6 +41,37 @@ struct BenchmarkHandle
 #endif
 };
 
+#ifdef DRAPE_MEASURER_BENCHMARK
+// Appends one JSON object per scenario to the results file, so the results of different
+// runs (app versions) can be compared by scripts.
+void SaveStatistic(std::vector<std::pair<std::string, df::DrapeMeasurer::DrapeStatistic>> const & statistic)
+{
+  auto const fn = base::JoinPath(GetPlatform().WritableDir(), "graphics_benchmark_results.jsonl");
+  try
+  {
+    FileWriter writer(fn, FileWriter::OP_APPEND);
+    auto const timestamp = base::SecondsSinceEpoch();
+    for (auto const & it : statistic)
+    {
+      auto root = base::NewJSONObject();
+      ToJSONObject(*root, "scenario", base::NewJSONString(it.first));
+      ToJSONObject(*root, "version", base::NewJSONString(GetPlatform().Version()));
+      ToJSONObject(*root, "timestamp", timestamp);
+      ToJSONObject(*root, "statistic", base::LoadFromString(it.second.ToJSON()));
+
+      auto const line = base::DumpToString(root, JSON_COMPACT) + "\n";
+      writer.Write(line.data(), line.size());
+    }
+  }
+  catch (RootException const & e)
+  {
+    LOG(LERROR, ("Error writing benchmark results to", fn, e.Msg()));
+    return;
+  }
+  LOG(LINFO, ("Benchmark results are saved to", fn));
+}
+#endif
+
 void RunScenario(Framework * framework, std::shared_ptr<BenchmarkHandle> handle)
 {
   if (handle->m_currentScenario >= handle->m_scenariosToRun.size())
@@ -51,6 +84,7 @@ void RunScenario(Framework * framework, std::shared_ptr<BenchmarkHandle> handle)
                   "\n ***** Report for scenario", it.first, "*****\n"));
 
     }
+    SaveStatistic(handle->m_drapeStatistic);
 #endif
     return;
   }
@@ -19,7 +19,10 @@
 
 #include "base/file_name_utils.hpp"
 #include "base/string_utils.hpp"
+#include "base/thread_pool_computational.hpp"
 
+#include <algorithm>
+#include <future>
 #include <map>
 #include <sstream>
 
@@ -288,6 +291,37 @@ std::unique_ptr<kml::FileData> LoadKmlFile(std::string const & file, KmlFileType
   return kmlData;
 }
 
+std::vector<std::unique_ptr<kml::FileData>> LoadKmlFiles(std::vector<std::string> const & files,
+                                                         KmlFileType fileType, size_t threadsCount,
+                                                         std::function<bool()> const & needCancel)
+{
+  std::vector<std::unique_ptr<kml::FileData>> result(files.size());
+  auto const loadFile = [&](size_t i)
+  {
+    if (needCancel && needCancel())
+      return;
+    result[i] = LoadKmlFile(files[i], fileType);
+  };
+
+  threadsCount = std::min(threadsCount, files.size());
+  if (threadsCount <= 1)
+  {
+    for (size_t i = 0; i < files.size(); ++i)
+      loadFile(i);
+    return result;
+  }
+
+  // Files are loaded independently, every task writes only its own slot of |result|.
+  base::thread_pool::computational::ThreadPool pool(threadsCount);
+  std::vector<std::future<void>> tasks;
+  tasks.reserve(files.size());
+  for (size_t i = 0; i < files.size(); ++i)
+    tasks.emplace_back(pool.Submit(loadFile, i));
+  for (auto & task : tasks)
+    task.wait();
+  return result;
+}
+
 std::string GetKMLPath(std::string const & filePath)
 {
   std::string const fileExt = GetFileExt(filePath);
@@ -6,8 +6,10 @@
 
 #include "geometry/rect2d.hpp"
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 struct BookmarkInfo
 {
@@ -99,6 +101,12 @@ std::string GenerateValidAndUniqueFilePathForKML(std::string const & fileName);
 std::unique_ptr<kml::FileData> LoadKmlFile(std::string const & file, KmlFileType fileType);
 std::unique_ptr<kml::FileData> LoadKmlData(Reader const & reader, KmlFileType fileType);
 
+/// Loads |files| using up to |threadsCount| threads. The result is in the same order as |files|,
+/// files which failed to load (or were not loaded because of |needCancel|) are nullptr.
+std::vector<std::unique_ptr<kml::FileData>> LoadKmlFiles(std::vector<std::string> const & files,
+                                                         KmlFileType fileType, size_t threadsCount,
+                                                         std::function<bool()> const & needCancel = {});
+
 std::string GetKMLPath(std::string const & filePath);
 
 bool SaveKmlFileSafe(kml::FileData & kmlData, std::string const & file, KmlFileType fileType);
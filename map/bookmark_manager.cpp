@@ -1804,19 +1804,26 @@ BookmarkManager::KMLDataCollectionPtr BookmarkManager::LoadBookmarks(
   Platform::FilesList files;
   Platform::GetFilesByExt(dir, ext, files);
 
+  std::vector<std::string> filePaths;
+  filePaths.reserve(files.size());
+  for (auto const & file : files)
+    filePaths.push_back(base::JoinPath(dir, file));
+
+  auto kmlFiles = LoadKmlFiles(filePaths, fileType, GetPlatform().CpuCores(),
+                               [this]() { return static_cast<bool>(m_needTeardown); });
+
   auto collection = std::make_shared<KMLDataCollection>();
   collection->reserve(files.size());
-  for (auto const & file : files)
+  for (size_t i = 0; i < kmlFiles.size(); ++i)
   {
-    auto const filePath = base::JoinPath(dir, file);
-    auto kmlData = LoadKmlFile(filePath, fileType);
+    if (m_needTeardown)
+      break;
+    auto & kmlData = kmlFiles[i];
     if (kmlData == nullptr)
       continue;
     if (checker && !checker(*kmlData))
       continue;
-    if (m_needTeardown)
-      break;
-    collection->emplace_back(filePath, std::move(kmlData));
+    collection->emplace_back(filePaths[i], std::move(kmlData));
   }
   return collection;
 }
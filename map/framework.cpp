@@ -66,6 +66,7 @@
 #include "geometry/rect2d.hpp"
 #include "geometry/triangle2d.hpp"
 
+#include "base/file_name_utils.hpp"
 #include "base/logging.hpp"
 #include "base/math.hpp"
 #include "base/stl_helpers.hpp"
@@ -105,6 +106,7 @@ char const kTrafficEnabledKey[] = "TrafficEnabled";
 char const kTransitSchemeEnabledKey[] = "TransitSchemeEnabled";
 char const kIsolinesEnabledKey[] = "IsolinesEnabled";
 char const kTrafficSimplifiedColorsKey[] = "TrafficSimplifiedColors";
+char const kTileShapesCacheKey[] = "TileShapesCache";
 char const kLargeFontsSize[] = "LargeFontsSize";
 char const kTranslitMode[] = "TransliterationMode";
 char const kPreferredGraphicsAPI[] = "PreferredGraphicsAPI";
@@ -112,6 +114,8 @@ char const kShowDebugInfo[] = "DebugInfo";
 
 auto constexpr kLargeFontsScaleFactor = 1.6;
 size_t constexpr kMaxTrafficCacheSizeBytes = 64 /* Mb */ * 1024 * 1024;
+char const kTileShapesCacheDir[] = "tile_shapes_cache";
+char const kGlyphsCacheFile[] = "glyphs_cache.bin";
 
 // TODO!
 // To adjust GpsTrackFilter was added secret command "?gpstrackaccuracy:xxx;"
@@ -1494,6 +1498,9 @@ void Framework::CreateDrapeEngine(ref_ptr<dp::GraphicsContextFactory> contextFac
       m_routingManager.IsRoutingActive() && m_routingManager.IsRoutingFollowing(),
       isAutozoomEnabled, simplifiedTrafficColors, std::move(overlaysShowStatsFn),
       std::move(onGraphicsContextInitialized));
+  if (LoadTileShapesCacheEnabled())
+    p.m_tileShapesCacheDir = base::JoinPath(GetPlatform().WritableDir(), kTileShapesCacheDir);
+  p.m_glyphsCachePath = base::JoinPath(GetPlatform().WritableDir(), kGlyphsCacheFile);
 
   m_drapeEngine = make_unique_dp<df::DrapeEngine>(std::move(p));
   m_drapeEngine->SetModelViewListener([this](ScreenBase const & screen)
@@ -2535,6 +2542,19 @@ void Framework::SaveIsolinesEnabled(bool enabled)
   settings::Set(kIsolinesEnabledKey, enabled);
 }
 
+bool Framework::LoadTileShapesCacheEnabled()
+{
+  bool enabled;
+  if (!settings::Get(kTileShapesCacheKey, enabled))
+    enabled = false;
+  return enabled;
+}
+
+void Framework::SaveTileShapesCacheEnabled(bool enabled)
+{
+  settings::Set(kTileShapesCacheKey, enabled);
+}
+
 void Framework::EnableChoosePositionMode(bool enable, bool enableBounds, bool applyPosition,
                                          m2::PointD const & position)
 {
@@ -2655,6 +2675,17 @@ bool Framework::ParseDrapeDebugCommand(string const & query)
     m_drapeEngine->EnableDebugRectRendering(false /* shown */);
     return true;
   }
+  // The tile shapes cache is created with the drape engine, so it's switched after restart.
+  if (query == "?tile-cache")
+  {
+    SaveTileShapesCacheEnabled(true /* enabled */);
+    return true;
+  }
+  if (query == "?no-tile-cache")
+  {
+    SaveTileShapesCacheEnabled(false /* enabled */);
+    return true;
+  }
 #if defined(OMIM_METAL_AVAILABLE)
   if (query == "?metal")
   {
@@ -682,6 +682,10 @@ public:
   bool LoadIsolinesEnabled();
   void SaveIsolinesEnabled(bool enabled);
 
+  /// Persistent cache of the tiles shapes, the setting is applied when the drape engine is created.
+  bool LoadTileShapesCacheEnabled();
+  void SaveTileShapesCacheEnabled(bool enabled);
+
   dp::ApiVersion LoadPreferredGraphicsAPI();
   void SavePreferredGraphicsAPI(dp::ApiVersion apiVersion);
 
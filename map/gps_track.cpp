@@ -4,6 +4,7 @@
 #include "base/logging.hpp"
 
 #include <algorithm>
+#include <limits>
 
 using namespace std;
 using namespace std::chrono;
@@ -183,7 +184,14 @@ void GpsTrack::InitCollection(hours duration)
     vector<location::GpsInfo> originPoints;
     originPoints.reserve(gps_track::kItemBlockSize);
 
-    m_storage->ForEach([this, &originPoints](location::GpsInfo const & originPoint)->bool
+    // Points older than the duration are evicted from the collection anyway,
+    // so they are not read from the storage.
+    double from = numeric_limits<double>::lowest();
+    if (auto const lastTimestamp = m_storage->GetLastTimestamp())
+      from = *lastTimestamp - duration_cast<seconds>(duration).count();
+
+    m_storage->ForEachInTimeRange(from, numeric_limits<double>::max(),
+                                  [this, &originPoints](location::GpsInfo const & originPoint)->bool
     {
       originPoints.emplace_back(originPoint);
       if (originPoints.size() == originPoints.capacity())
@@ -1,21 +1,36 @@
 #include "map/gps_track_storage.hpp"
 
+#include "indexer/scales.hpp"
+
+#include "coding/byte_stream.hpp"
 #include "coding/endianness.hpp"
 #include "coding/internal/file_data.hpp"
+#include "coding/varint.hpp"
+
+#include "geometry/mercator.hpp"
+#include "geometry/parametrized_segment.hpp"
+#include "geometry/simplification.hpp"
 
 #include "base/assert.hpp"
 #include "base/logging.hpp"
+#include "base/math.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <limits>
+#include <utility>
 
 using namespace std;
 
 namespace
 {
 
+// Version 1 stores plain items, version 2 stores chunks of delta coded items.
+uint32_t constexpr kVersion1 = 1;
+
 // Current file format version
-uint32_t constexpr kCurrentVersion = 1;
+uint32_t constexpr kCurrentVersion = 2;
 
 // Header size in bytes, header consists of uint32_t 'version' only
 uint32_t constexpr kHeaderSize = sizeof(uint32_t);
@@ -23,12 +38,51 @@ uint32_t constexpr kHeaderSize = sizeof(uint32_t);
 // Number of items for batch processing
 size_t constexpr kItemBlockSize = 1000;
 
-// TODO
-// Now GpsInfo written as plain values, but values can be compressed.
-
-// Size of point in bytes to write in file of read from file
+// Size of plain point in bytes, version 1 file and raw chunks consist of such points
 size_t constexpr kPointSize = 8 * sizeof(double) + sizeof(uint8_t);
 
+// Chunk header consists of uint32_t size of the items, uint32_t number of items, uint32_t flags
+// and int64_t min and max encoded timestamps of the items.
+size_t constexpr kChunkHeaderSize = 3 * sizeof(uint32_t) + 2 * sizeof(int64_t);
+
+// Items which can't be stored as fixed point numbers are stored in raw chunks as plain points.
+uint32_t constexpr kRawChunkFlag = 1;
+
+// 1024 items are 17 minutes of 1 Hz track.
+size_t constexpr kMaxChunkItemCount = 1024;
+
+// Block size for copying of the chunks
+size_t constexpr kCopyBlockSize = 64 * 1024;
+
+// Items fields are stored as fixed point numbers, every value is coded as a varint
+// of the difference with the same value of the previous item in the chunk.
+enum Field
+{
+  kTimestamp,
+  kLatitude,
+  kLongitude,
+  kAltitude,
+  kSpeed,
+  kBearing,
+  kHorizontalAccuracy,
+  kVerticalAccuracy,
+  kSource,
+  kFieldCount
+};
+
+using EncodedItem = array<int64_t, kFieldCount>;
+
+// Milliseconds, 1 cm for coordinates, centimeters, centimeters per second and
+// hundredths of degree for the rest.
+double constexpr kScales[kFieldCount] = {1e3, 1e7, 1e7, 1e2, 1e2, 1e2, 1e2, 1e2, 1.0};
+
+// Values of the items stored in the delta coded chunks, differences of them fit int64_t.
+double constexpr kMaxFixedValue = 1e15;
+
+// Encoded items are read without bounds checks from the buffers padded with zeroes,
+// so a broken varint ends in the padding.
+size_t constexpr kMaxEncodedItemSize = kFieldCount * 10;
+
 // Writes value in memory in LittleEndian
 template <typename T>
 void MemWrite(void * ptr, T value)
@@ -46,8 +100,8 @@ T MemRead(void const * ptr)
   return SwapIfBigEndianMacroBased(value);
 }
 
-void Pack(char * p, location::GpsInfo const & info)
-{  
+void Pack(uint8_t * p, location::GpsInfo const & info)
+{
   MemWrite<double>(p + 0 * sizeof(double), info.m_timestamp);
   MemWrite<double>(p + 1 * sizeof(double), info.m_latitude);
   MemWrite<double>(p + 2 * sizeof(double), info.m_longitude);
@@ -61,7 +115,7 @@ void Pack(char * p, location::GpsInfo const & info)
   MemWrite<uint8_t>(p + 8 * sizeof(double), source);
 }
 
-void Unpack(char const * p, location::GpsInfo & info)
+void Unpack(uint8_t const * p, location::GpsInfo & info)
 {
   info.m_timestamp = MemRead<double>(p + 0 * sizeof(double));
   info.m_latitude = MemRead<double>(p + 1 * sizeof(double));
@@ -75,15 +129,120 @@ void Unpack(char const * p, location::GpsInfo & info)
   info.m_source = static_cast<location::TLocationSource>(source);
 }
 
-inline size_t GetItemOffset(size_t itemIndex)
+bool IsFixed(double value, Field field)
 {
-  return kHeaderSize + itemIndex * kPointSize;
+  return isfinite(value) && fabs(value * kScales[field]) <= kMaxFixedValue;
 }
 
-inline size_t GetItemCount(size_t fileSize)
+// @returns true if the item can be stored in a delta coded chunk.
+bool CanEncode(location::GpsInfo const & info)
 {
-  ASSERT_GREATER_OR_EQUAL(fileSize, kHeaderSize, ());
-  return (fileSize - kHeaderSize) / kPointSize;
+  return IsFixed(info.m_timestamp, kTimestamp) && IsFixed(info.m_latitude, kLatitude) &&
+         IsFixed(info.m_longitude, kLongitude) && IsFixed(info.m_altitude, kAltitude) &&
+         IsFixed(info.m_speedMpS, kSpeed) && IsFixed(info.m_bearing, kBearing) &&
+         IsFixed(info.m_horizontalAccuracy, kHorizontalAccuracy) &&
+         IsFixed(info.m_verticalAccuracy, kVerticalAccuracy);
+}
+
+int64_t ToFixed(double value, Field field)
+{
+  ASSERT(IsFixed(value, field), (value, field));
+  return llround(value * kScales[field]);
+}
+
+double FromFixed(int64_t value, Field field)
+{
+  return static_cast<double>(value) / kScales[field];
+}
+
+EncodedItem Encode(location::GpsInfo const & info)
+{
+  EncodedItem item;
+  item[kTimestamp] = ToFixed(info.m_timestamp, kTimestamp);
+  item[kLatitude] = ToFixed(info.m_latitude, kLatitude);
+  item[kLongitude] = ToFixed(info.m_longitude, kLongitude);
+  item[kAltitude] = ToFixed(info.m_altitude, kAltitude);
+  item[kSpeed] = ToFixed(info.m_speedMpS, kSpeed);
+  item[kBearing] = ToFixed(info.m_bearing, kBearing);
+  item[kHorizontalAccuracy] = ToFixed(info.m_horizontalAccuracy, kHorizontalAccuracy);
+  item[kVerticalAccuracy] = ToFixed(info.m_verticalAccuracy, kVerticalAccuracy);
+  ASSERT_LESS_OR_EQUAL(static_cast<int>(info.m_source), 255, ());
+  item[kSource] = static_cast<uint8_t>(info.m_source);
+  return item;
+}
+
+location::GpsInfo Decode(EncodedItem const & item)
+{
+  location::GpsInfo info;
+  info.m_timestamp = FromFixed(item[kTimestamp], kTimestamp);
+  info.m_latitude = FromFixed(item[kLatitude], kLatitude);
+  info.m_longitude = FromFixed(item[kLongitude], kLongitude);
+  info.m_altitude = FromFixed(item[kAltitude], kAltitude);
+  info.m_speedMpS = FromFixed(item[kSpeed], kSpeed);
+  info.m_bearing = FromFixed(item[kBearing], kBearing);
+  info.m_horizontalAccuracy = FromFixed(item[kHorizontalAccuracy], kHorizontalAccuracy);
+  info.m_verticalAccuracy = FromFixed(item[kVerticalAccuracy], kVerticalAccuracy);
+  info.m_source = static_cast<location::TLocationSource>(item[kSource]);
+  return info;
+}
+
+void WriteItem(EncodedItem const & item, EncodedItem const & prev, vector<uint8_t> & buffer)
+{
+  PushBackByteSink<vector<uint8_t>> sink(buffer);
+  for (size_t i = 0; i < item.size(); ++i)
+    WriteVarInt(sink, item[i] - prev[i]);
+}
+
+// Calls |fn| for the items of the chunk until it returns false.
+// @returns false if |fn| has returned false.
+template <typename Fn>
+bool ForEachEncodedItem(string const & filePath, vector<uint8_t> const & buffer, size_t size,
+                        uint32_t count, Fn && fn)
+{
+  ASSERT_GREATER_OR_EQUAL(buffer.size(), size + kMaxEncodedItemSize, ());
+  ArrayByteSource src(buffer.data());
+  uint8_t const * end = buffer.data() + size;
+
+  EncodedItem item = {};
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    for (auto & value : item)
+      value += ReadVarInt<int64_t>(src);
+
+    if (src.PtrUint8() > end)
+      MYTHROW(GpsTrackStorage::ReadException, ("Broken chunk. File:", filePath));
+
+    if (!fn(item))
+      return false;
+  }
+
+  if (src.PtrUint8() != end)
+    MYTHROW(GpsTrackStorage::ReadException, ("Broken chunk. File:", filePath));
+  return true;
+}
+
+// Same as ForEachEncodedItem for the decoded items of raw and delta coded chunks.
+template <typename Fn>
+bool ForEachItem(string const & filePath, bool isRaw, vector<uint8_t> const & buffer, size_t size,
+                 uint32_t count, Fn && fn)
+{
+  if (!isRaw)
+  {
+    return ForEachEncodedItem(filePath, buffer, size, count,
+                              [&fn](EncodedItem const & item) { return fn(Decode(item)); });
+  }
+
+  if (size != count * kPointSize)
+    MYTHROW(GpsTrackStorage::ReadException, ("Broken chunk. File:", filePath));
+
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    location::GpsInfo item;
+    Unpack(buffer.data() + i * kPointSize, item);
+    if (!fn(item))
+      return false;
+  }
+  return true;
 }
 
 inline bool WriteVersion(fstream & f, uint32_t version)
@@ -107,7 +266,12 @@ inline bool ReadVersion(fstream & f, uint32_t & version)
 GpsTrackStorage::GpsTrackStorage(string const & filePath, size_t maxItemCount)
   : m_filePath(filePath)
   , m_maxItemCount(maxItemCount)
+  // Chunks are small comparing to the file, see NOTE in declaration.
+  , m_chunkItemCount(clamp(maxItemCount / 8, size_t{1}, kMaxChunkItemCount))
   , m_itemCount(0)
+  , m_fileSize(kHeaderSize)
+  , m_lastItem()
+  , m_lastTimestamp(0)
 {
   ASSERT_GREATER(m_maxItemCount, 0, ());
 
@@ -122,41 +286,23 @@ GpsTrackStorage::GpsTrackStorage(string const & filePath, size_t maxItemCount)
 
     if (version == kCurrentVersion)
     {
-      // Seek to end to get file size
-      m_stream.seekp(0, ios::end);
-      if (!m_stream.good())
-        MYTHROW(OpenException, ("Seek to the end error.", m_filePath));
-
-      auto const fileSize = static_cast<size_t>(m_stream.tellp());
-
-      m_itemCount = GetItemCount(fileSize);
-
-      // Set write position after last item position
-      size_t const offset = GetItemOffset(m_itemCount);
-      m_stream.seekp(offset, ios::beg);
-      if (!m_stream.good())
-        MYTHROW(OpenException, ("Seek to the offset error:", offset, m_filePath));
+      ReadIndex();
+    }
+    else if (version == kVersion1)
+    {
+      MigrateFromVersion1();
     }
     else
     {
+      LOG(LWARNING, ("Unknown track storage version", version, m_filePath));
       m_stream.close();
-      // TODO: migration for file m_filePath from version 'version' to version 'kCurrentVersion'
-      // TODO: For now we support only one version, but in future migration may be needed.
     }
   }
 
-  if (!m_stream)
+  if (!m_stream.is_open())
   {
     // Create new file
-    m_stream.open(m_filePath, ios::in | ios::out | ios::binary | ios::trunc);
-
-    if (!m_stream)
-      MYTHROW(OpenException, ("Open file error.", m_filePath));
-
-    if (!WriteVersion(m_stream, kCurrentVersion))
-      MYTHROW(OpenException, ("Write version error.", m_filePath));
-
-    m_itemCount = 0;
+    CreateFile();
   }
 }
 
@@ -172,22 +318,66 @@ void GpsTrackStorage::Append(vector<TItem> const & items)
   if (needTrunc)
     TruncFile();
 
-  // Write position must be after last item position
-  ASSERT_EQUAL(m_stream.tellp(), static_cast<typename fstream::pos_type>(
-                   GetItemOffset(m_itemCount)), ());
-
-  vector<char> buff(min(kItemBlockSize, items.size()) * kPointSize);
+  vector<uint8_t> buff;
   for (size_t i = 0; i < items.size();)
   {
-    size_t const n = min(items.size() - i, kItemBlockSize);
+    bool const isRaw = !CanEncode(items[i]);
+    if (m_chunks.empty() || m_chunks.back().m_count >= m_chunkItemCount ||
+        m_chunks.back().m_isRaw != isRaw)
+    {
+      Chunk chunk;
+      chunk.m_offset = m_fileSize;
+      chunk.m_isRaw = isRaw;
+      // Timestamps of raw items may be not representable, raw chunks are always read.
+      if (isRaw)
+      {
+        chunk.m_minTimestamp = numeric_limits<int64_t>::min();
+        chunk.m_maxTimestamp = numeric_limits<int64_t>::max();
+      }
+      m_chunks.push_back(chunk);
+      m_lastItem = {};
+    }
 
-    for (size_t j = 0; j < n; ++j)
-      Pack(&buff[0] + j * kPointSize, items[i + j]);
+    Chunk & chunk = m_chunks.back();
+    size_t const maxCount = min(items.size() - i, m_chunkItemCount - chunk.m_count);
+
+    buff.clear();
+    size_t n = 0;
+    for (; n < maxCount && CanEncode(items[i + n]) != isRaw; ++n)
+    {
+      if (isRaw)
+      {
+        buff.resize(buff.size() + kPointSize);
+        Pack(buff.data() + buff.size() - kPointSize, items[i + n]);
+        continue;
+      }
+
+      EncodedItem const item = Encode(items[i + n]);
+      WriteItem(item, m_lastItem, buff);
+      m_lastItem = item;
+
+      if (chunk.m_count == 0 && n == 0)
+      {
+        chunk.m_minTimestamp = chunk.m_maxTimestamp = item[kTimestamp];
+      }
+      else
+      {
+        chunk.m_minTimestamp = min(chunk.m_minTimestamp, item[kTimestamp]);
+        chunk.m_maxTimestamp = max(chunk.m_maxTimestamp, item[kTimestamp]);
+      }
+    }
 
-    m_stream.write(&buff[0], n * kPointSize);
+    // Items are written before the header, so the header never refers to unwritten items.
+    m_stream.seekp(chunk.m_offset + kChunkHeaderSize + chunk.m_size, ios::beg);
+    m_stream.write(reinterpret_cast<char const *>(buff.data()), buff.size());
     if (!m_stream.good())
       MYTHROW(WriteException, ("File:", m_filePath));
 
+    chunk.m_size += static_cast<uint32_t>(buff.size());
+    chunk.m_count += static_cast<uint32_t>(n);
+    WriteChunkHeader(chunk);
+
+    m_fileSize = chunk.m_offset + kChunkHeaderSize + chunk.m_size;
     i += n;
   }
 
@@ -196,59 +386,259 @@ void GpsTrackStorage::Append(vector<TItem> const & items)
     MYTHROW(WriteException, ("File:", m_filePath));
 
   m_itemCount += items.size();
+  m_lastTimestamp = items.back().m_timestamp;
 }
 
 void GpsTrackStorage::Clear()
 {
   ASSERT(m_stream.is_open(), ());
 
-  m_itemCount = 0;
-
   m_stream.close();
 
+  CreateFile();
+}
+
+void GpsTrackStorage::ForEach(std::function<bool(TItem const & item)> const & fn)
+{
+  ASSERT(m_stream.is_open(), ());
+
+  ForEachInChunks(numeric_limits<double>::lowest(), numeric_limits<double>::max(), fn);
+}
+
+void GpsTrackStorage::ForEachInTimeRange(double from, double to,
+                                         std::function<bool(TItem const & item)> const & fn)
+{
+  ASSERT(m_stream.is_open(), ());
+
+  ForEachInChunks(from, to, fn);
+}
+
+void GpsTrackStorage::ForEachSimplified(double from, double to, int zoomLevel,
+                                        std::function<bool(TItem const & item)> const & fn)
+{
+  ASSERT(m_stream.is_open(), ());
+
+  vector<TItem> items;
+  ForEachInChunks(from, to, [&items](TItem const & item)
+  {
+    items.push_back(item);
+    return true;
+  });
+
+  if (items.size() < 3)
+  {
+    for (auto const & item : items)
+    {
+      if (!fn(item))
+        return;
+    }
+    return;
+  }
+
+  vector<m2::PointD> points;
+  points.reserve(items.size());
+  for (auto const & item : items)
+    points.push_back(mercator::FromLatLon(item.m_latitude, item.m_longitude));
+
+  // Douglas-Peucker with the explicit stack, recursion depth of SimplifyDP() is not limited
+  // for long tracks.
+  double const epsilon = base::Pow2(scales::GetEpsilonForSimplify(zoomLevel));
+  m2::SquaredDistanceFromSegmentToPoint distFn;
+  vector<bool> keep(points.size(), false);
+  keep.front() = keep.back() = true;
+  vector<pair<size_t, size_t>> segments = {{0, points.size() - 1}};
+  while (!segments.empty())
+  {
+    auto const [first, last] = segments.back();
+    segments.pop_back();
+    if (last - first < 2)
+      continue;
+
+    auto const maxDist = simpl::MaxDistance(points.begin() + first, points.begin() + last, distFn);
+    if (maxDist.first < epsilon)
+      continue;
+
+    size_t const middle = static_cast<size_t>(maxDist.second - points.begin());
+    keep[middle] = true;
+    segments.emplace_back(first, middle);
+    segments.emplace_back(middle, last);
+  }
+
+  for (size_t i = 0; i < items.size(); ++i)
+  {
+    if (keep[i] && !fn(items[i]))
+      return;
+  }
+}
+
+optional<double> GpsTrackStorage::GetLastTimestamp() const
+{
+  if (m_itemCount == 0)
+    return {};
+  return m_lastTimestamp;
+}
+
+void GpsTrackStorage::CreateFile()
+{
   m_stream.open(m_filePath, ios::in | ios::out | ios::binary | ios::trunc);
 
   if (!m_stream)
-    MYTHROW(WriteException, ("File:", m_filePath));
+    MYTHROW(OpenException, ("Open file error.", m_filePath));
 
   if (!WriteVersion(m_stream, kCurrentVersion))
-    MYTHROW(WriteException, ("File:", m_filePath));
+    MYTHROW(OpenException, ("Write version error.", m_filePath));
 
-  // Write position is set to the first item in the file
-  ASSERT_EQUAL(m_stream.tellp(), static_cast<typename fstream::pos_type>(
-                   GetItemOffset(0)), ());
+  m_itemCount = 0;
+  m_fileSize = kHeaderSize;
+  m_chunks.clear();
+  m_lastItem = {};
+  m_lastTimestamp = 0;
+
+  // Write position is set to the first chunk in the file
+  ASSERT_EQUAL(m_stream.tellp(), static_cast<typename fstream::pos_type>(m_fileSize), ());
 }
 
-void GpsTrackStorage::ForEach(std::function<bool(TItem const & item)> const & fn)
+void GpsTrackStorage::ReadIndex()
 {
-  ASSERT(m_stream.is_open(), ());
+  m_stream.seekg(0, ios::end);
+  if (!m_stream.good())
+    MYTHROW(OpenException, ("Seek to the end error.", m_filePath));
 
-  size_t i = GetFirstItemIndex();
+  auto const fileSize = static_cast<uint64_t>(m_stream.tellg());
 
-  // Set read position to the first item
-  m_stream.seekg(GetItemOffset(i), ios::beg);
+  uint64_t offset = kHeaderSize;
+  char header[kChunkHeaderSize];
+  while (offset + kChunkHeaderSize <= fileSize)
+  {
+    m_stream.seekg(offset, ios::beg);
+    m_stream.read(header, kChunkHeaderSize);
+    if (!m_stream.good())
+      MYTHROW(OpenException, ("Read chunk header error:", offset, m_filePath));
+
+    Chunk chunk;
+    chunk.m_offset = offset;
+    chunk.m_size = MemRead<uint32_t>(header);
+    chunk.m_count = MemRead<uint32_t>(header + sizeof(uint32_t));
+    chunk.m_isRaw = (MemRead<uint32_t>(header + 2 * sizeof(uint32_t)) & kRawChunkFlag) != 0;
+    chunk.m_minTimestamp = MemRead<int64_t>(header + 3 * sizeof(uint32_t));
+    chunk.m_maxTimestamp = MemRead<int64_t>(header + 3 * sizeof(uint32_t) + sizeof(int64_t));
+
+    uint64_t const end = offset + kChunkHeaderSize + chunk.m_size;
+    if (chunk.m_count == 0 || chunk.m_count > kMaxChunkItemCount || end > fileSize)
+      break;
+
+    m_chunks.push_back(chunk);
+    m_itemCount += chunk.m_count;
+    offset = end;
+  }
+
+  // The last chunk is decoded to continue it, broken chunks are removed.
+  while (!m_chunks.empty())
+  {
+    Chunk const & last = m_chunks.back();
+    try
+    {
+      vector<uint8_t> buff;
+      ReadChunk(last, buff);
+      if (last.m_isRaw)
+      {
+        ForEachItem(m_filePath, true /* isRaw */, buff, last.m_size, last.m_count,
+                    [this](TItem const & item)
+        {
+          m_lastTimestamp = item.m_timestamp;
+          return true;
+        });
+      }
+      else
+      {
+        ForEachEncodedItem(m_filePath, buff, last.m_size, last.m_count,
+                           [this](EncodedItem const & item)
+        {
+          m_lastItem = item;
+          return true;
+        });
+        m_lastTimestamp = FromFixed(m_lastItem[kTimestamp], kTimestamp);
+      }
+      break;
+    }
+    catch (ReadException const & e)
+    {
+      LOG(LWARNING, ("Track storage last chunk is broken:", e.Msg()));
+      offset = last.m_offset;
+      m_itemCount -= last.m_count;
+      m_chunks.pop_back();
+      m_lastItem = {};
+    }
+  }
+
+  if (offset != fileSize)
+  {
+    // The file was not completely written, the unfinished chunk is removed.
+    LOG(LWARNING, ("Track storage is truncated from", fileSize, "to", offset, m_filePath));
+    m_stream.close();
+    try
+    {
+      base::FileData file(m_filePath, base::FileData::OP_WRITE_EXISTING);
+      file.Truncate(offset);
+    }
+    catch (RootException const & e)
+    {
+      MYTHROW(OpenException, ("Truncate error.", m_filePath, e.Msg()));
+    }
+
+    m_stream.open(m_filePath, ios::in | ios::out | ios::binary);
+    if (!m_stream)
+      MYTHROW(OpenException, ("Open file error.", m_filePath));
+  }
+
+  m_fileSize = offset;
+
+  // Set write position after last chunk
+  m_stream.seekp(m_fileSize, ios::beg);
   if (!m_stream.good())
-    MYTHROW(ReadException, ("File:", m_filePath));
+    MYTHROW(OpenException, ("Seek to the offset error:", m_fileSize, m_filePath));
+}
 
-  vector<char> buff(min(kItemBlockSize, m_itemCount) * kPointSize);
-  for (; i < m_itemCount;)
+void GpsTrackStorage::MigrateFromVersion1()
+{
+  m_stream.seekg(0, ios::end);
+  if (!m_stream.good())
+    MYTHROW(OpenException, ("Seek to the end error.", m_filePath));
+
+  auto const fileSize = static_cast<size_t>(m_stream.tellg());
+  size_t const itemCount = (fileSize - kHeaderSize) / kPointSize;
+  size_t i = itemCount > m_maxItemCount ? itemCount - m_maxItemCount : 0;
+
+  m_stream.seekg(kHeaderSize + i * kPointSize, ios::beg);
+  if (!m_stream.good())
+    MYTHROW(OpenException, ("File:", m_filePath));
+
+  vector<TItem> items;
+  items.reserve(itemCount - i);
+  vector<uint8_t> buff(kItemBlockSize * kPointSize);
+  for (; i < itemCount;)
   {
-    size_t const n = min(m_itemCount - i, kItemBlockSize);
+    size_t const n = min(itemCount - i, kItemBlockSize);
 
-    m_stream.read(&buff[0], n * kPointSize);
+    m_stream.read(reinterpret_cast<char *>(buff.data()), n * kPointSize);
     if (!m_stream.good())
-      MYTHROW(ReadException, ("File:", m_filePath));
+      MYTHROW(OpenException, ("File:", m_filePath));
 
     for (size_t j = 0; j < n; ++j)
-    {      
+    {
       TItem item;
-      Unpack(&buff[0] + j * kPointSize, item);
-      if (!fn(item))
-        return;
+      Unpack(buff.data() + j * kPointSize, item);
+      items.push_back(item);
     }
 
     i += n;
   }
+
+  m_stream.close();
+  CreateFile();
+  Append(items);
+
+  LOG(LINFO, ("Track storage is converted to version", kCurrentVersion, "items:", items.size()));
 }
 
 void GpsTrackStorage::TruncFile()
@@ -264,31 +654,39 @@ void GpsTrackStorage::TruncFile()
   if (!WriteVersion(tmp, kCurrentVersion))
     MYTHROW(WriteException, ("File:", tmpFilePath));
 
-  size_t i = GetFirstItemIndex();
+  // Whole chunks are copied starting from the chunk with the first item.
+  size_t const firstIndex = GetFirstItemIndex();
+  size_t removedCount = 0;
+  auto firstChunk = m_chunks.begin();
+  while (firstChunk != m_chunks.end() && removedCount + firstChunk->m_count <= firstIndex)
+  {
+    removedCount += firstChunk->m_count;
+    ++firstChunk;
+  }
+
+  vector<Chunk> chunks(firstChunk, m_chunks.end());
+  uint64_t const begin = chunks.empty() ? m_fileSize : chunks.front().m_offset;
 
-  // Set read position to the first item
-  m_stream.seekg(GetItemOffset(i), ios::beg);
+  // Set read position to the first chunk
+  m_stream.seekg(begin, ios::beg);
   if (!m_stream.good())
     MYTHROW(ReadException, ("File:", m_filePath));
 
-  size_t newItemCount = 0;
-
-  // Copy items
-  vector<char> buff(min(kItemBlockSize, m_itemCount) * kPointSize);
-  for (; i < m_itemCount;)
+  // Copy chunks
+  vector<char> buff(kCopyBlockSize);
+  for (uint64_t pos = begin; pos < m_fileSize;)
   {
-    size_t const n = min(m_itemCount - i, kItemBlockSize);
+    size_t const n = static_cast<size_t>(min<uint64_t>(m_fileSize - pos, kCopyBlockSize));
 
-    m_stream.read(&buff[0], n * kPointSize);
+    m_stream.read(buff.data(), n);
     if (!m_stream.good())
       MYTHROW(ReadException, ("File:", m_filePath));
 
-    tmp.write(&buff[0], n * kPointSize);
+    tmp.write(buff.data(), n);
     if (!tmp.good())
       MYTHROW(WriteException, ("File:", tmpFilePath));
 
-    i += n;
-    newItemCount += n;
+    pos += n;
   }
   buff.clear();
   buff.shrink_to_fit();
@@ -309,14 +707,84 @@ void GpsTrackStorage::TruncFile()
   if (!m_stream)
     MYTHROW(WriteException, ("File:", m_filePath));
 
-  m_itemCount = newItemCount;
+  for (auto & chunk : chunks)
+    chunk.m_offset = chunk.m_offset - begin + kHeaderSize;
 
-  // Write position must be after last item position (end of file)
-  ASSERT_EQUAL(m_stream.tellp(), static_cast<typename fstream::pos_type>(
-                   GetItemOffset(m_itemCount)), ());
+  m_chunks = move(chunks);
+  m_itemCount -= removedCount;
+  m_fileSize = m_fileSize - begin + kHeaderSize;
+  if (m_chunks.empty())
+    m_lastItem = {};
+
+  // Write position must be after last chunk (end of file)
+  ASSERT_EQUAL(m_stream.tellp(), static_cast<typename fstream::pos_type>(m_fileSize), ());
 }
 
 size_t GpsTrackStorage::GetFirstItemIndex() const
 {
   return (m_itemCount > m_maxItemCount) ? (m_itemCount - m_maxItemCount) : 0; // see NOTE in declaration
 }
+
+void GpsTrackStorage::WriteChunkHeader(Chunk const & chunk)
+{
+  char header[kChunkHeaderSize];
+  MemWrite<uint32_t>(header, chunk.m_size);
+  MemWrite<uint32_t>(header + sizeof(uint32_t), chunk.m_count);
+  MemWrite<uint32_t>(header + 2 * sizeof(uint32_t), chunk.m_isRaw ? kRawChunkFlag : 0);
+  MemWrite<int64_t>(header + 3 * sizeof(uint32_t), chunk.m_minTimestamp);
+  MemWrite<int64_t>(header + 3 * sizeof(uint32_t) + sizeof(int64_t), chunk.m_maxTimestamp);
+
+  m_stream.seekp(chunk.m_offset, ios::beg);
+  m_stream.write(header, kChunkHeaderSize);
+  if (!m_stream.good())
+    MYTHROW(WriteException, ("File:", m_filePath));
+}
+
+void GpsTrackStorage::ReadChunk(Chunk const & chunk, vector<uint8_t> & buffer)
+{
+  buffer.assign(chunk.m_size + kMaxEncodedItemSize, 0);
+
+  m_stream.seekg(chunk.m_offset + kChunkHeaderSize, ios::beg);
+  m_stream.read(reinterpret_cast<char *>(buffer.data()), chunk.m_size);
+  if (!m_stream.good())
+    MYTHROW(ReadException, ("File:", m_filePath));
+}
+
+void GpsTrackStorage::ForEachInChunks(double from, double to,
+                                      std::function<bool(TItem const & item)> const & fn)
+{
+  size_t const firstIndex = GetFirstItemIndex();
+
+  vector<uint8_t> buff;
+  size_t index = 0;
+  for (auto const & chunk : m_chunks)
+  {
+    size_t const chunkIndex = index;
+    index += chunk.m_count;
+
+    if (index <= firstIndex ||
+        (!chunk.m_isRaw && (FromFixed(chunk.m_maxTimestamp, kTimestamp) < from ||
+                            FromFixed(chunk.m_minTimestamp, kTimestamp) > to)))
+    {
+      continue;
+    }
+
+    ReadChunk(chunk, buff);
+
+    size_t i = chunkIndex;
+    bool const isContinued = ForEachItem(m_filePath, chunk.m_isRaw, buff, chunk.m_size,
+                                         chunk.m_count, [&](TItem const & item)
+    {
+      if (i++ < firstIndex)
+        return true;
+
+      if (item.m_timestamp < from || item.m_timestamp > to)
+        return true;
+
+      return fn(item);
+    });
+
+    if (!isContinued)
+      return;
+  }
+}
@@ -5,8 +5,11 @@
 #include "base/exception.hpp"
 #include "base/macros.hpp"
 
+#include <array>
+#include <cstdint>
 #include <fstream>
 #include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -39,16 +42,59 @@ public:
   /// @exceptions ReadException if read fails.
   void ForEach(std::function<bool(TItem const & item)> const & fn);
 
+  /// Calls functor for each item with timestamp in [from, to]. Only the chunks
+  /// which intersect the range are read from the file.
+  /// @exceptions ReadException if read fails.
+  void ForEachInTimeRange(double from, double to,
+                          std::function<bool(TItem const & item)> const & fn);
+
+  /// Same as ForEachInTimeRange but skips the items which don't change the track drawn
+  /// at |zoomLevel|. The track is simplified with the same precision as the map features.
+  /// @exceptions ReadException if read fails.
+  void ForEachSimplified(double from, double to, int zoomLevel,
+                         std::function<bool(TItem const & item)> const & fn);
+
+  /// @returns timestamp of the last appended item.
+  std::optional<double> GetLastTimestamp() const;
+
 private:
   DISALLOW_COPY_AND_MOVE(GpsTrackStorage);
 
+  // Fixed point values of the item fields.
+  using EncodedItem = std::array<int64_t, 9>;
+
+  // Items are stored in chunks of delta coded items. Headers of the chunks are
+  // the time index of the storage, they are kept in memory. Items with values which
+  // don't fit fixed point numbers are stored in raw chunks without compression.
+  struct Chunk
+  {
+    uint64_t m_offset = 0;  // offset of the chunk header in the file
+    uint32_t m_size = 0;    // size of the encoded items
+    uint32_t m_count = 0;
+    bool m_isRaw = false;
+    int64_t m_minTimestamp = 0;
+    int64_t m_maxTimestamp = 0;
+  };
+
+  void CreateFile();
+  void ReadIndex();
+  void MigrateFromVersion1();
   void TruncFile();
   size_t GetFirstItemIndex() const;
+  void WriteChunkHeader(Chunk const & chunk);
+  void ReadChunk(Chunk const & chunk, std::vector<uint8_t> & buffer);
+  void ForEachInChunks(double from, double to, std::function<bool(TItem const & item)> const & fn);
 
   std::string const m_filePath;
   size_t const m_maxItemCount;
+  size_t const m_chunkItemCount;
   std::fstream m_stream;
   size_t m_itemCount; // current number of items in file, read note
+  uint64_t m_fileSize;
+  std::vector<Chunk> m_chunks;
+  // New items are delta coded against the last one of the last chunk.
+  EncodedItem m_lastItem;
+  double m_lastTimestamp;
 
   // NOTE
   // New items append to the end of file, when file become too big, it is truncated.
@@ -61,4 +107,6 @@ private:
   // exceed 2 x m_maxItemCount, then second half of file - m_maxItemCount items is copying to the tmp file,
   // which replaces origin file. That means that trunc will happens only then new m_maxItemCount items will be
   // added but not every time.
+  // Files are truncated by whole chunks, so a few items before the second half are kept too,
+  // chunks are small enough for that.
 };
@@ -11,11 +11,14 @@
 #include "platform/platform.hpp"
 #include "platform/preferred_languages.hpp"
 
+#include "coding/file_writer.hpp"
 #include "coding/internal/file_data.hpp"
 #include "coding/string_utf8_multilang.hpp"
 
 #include "base/file_name_utils.hpp"
 #include "base/scope_guard.hpp"
+#include "base/string_utils.hpp"
+#include "base/timer.hpp"
 
 #include <array>
 #include <cstring>    // strlen
@@ -1376,4 +1379,75 @@ UNIT_CLASS_TEST(Runner, Bookmarks_BrokenFile)
   auto kmlData = LoadKmlFile(fileName, KmlFileType::Binary);
   TEST(kmlData == nullptr, ());
 }
+
+UNIT_TEST(Bookmarks_LoadKmlFilesParallel)
+{
+  size_t constexpr kFilesCount = 32;
+  size_t constexpr kBookmarksCount = 200;
+  size_t constexpr kTrackPointsCount = 2000;
+
+  string const dir = base::JoinPath(GetPlatform().TmpDir(), "bookmarks_parallel_loading");
+  TEST_EQUAL(Platform::MkDir(dir), Platform::ERR_OK, ());
+  SCOPE_GUARD(dirDeleter, [&dir]() { UNUSED_VALUE(Platform::RmDirRecursively(dir)); });
+
+  vector<string> files;
+  for (size_t i = 0; i < kFilesCount; ++i)
+  {
+    kml::FileData data;
+    kml::SetDefaultStr(data.m_categoryData.m_name, "Category " + strings::to_string(i));
+    for (size_t j = 0; j < kBookmarksCount; ++j)
+    {
+      kml::BookmarkData bm;
+      kml::SetDefaultStr(bm.m_name, "Bookmark " + strings::to_string(j));
+      bm.m_point = m2::PointD(i, j * 0.001);
+      data.m_bookmarksData.push_back(std::move(bm));
+    }
+
+    kml::TrackData track;
+    kml::SetDefaultStr(track.m_name, "Track");
+    track.m_layers.emplace_back();
+    track.m_geometry.m_lines.emplace_back();
+    for (size_t j = 0; j < kTrackPointsCount; ++j)
+      track.m_geometry.m_lines.back().emplace_back(m2::PointD(i + j * 0.0001, j * 0.0001), 0);
+    data.m_tracksData.push_back(std::move(track));
+
+    files.push_back(base::JoinPath(dir, strings::to_string(i) + kKmlExtension));
+    TEST(SaveKmlFileByExt(data, files.back()), ());
+  }
+
+  // Broken file must not affect loading of the others.
+  files.push_back(base::JoinPath(dir, "broken" + string(kKmlExtension)));
+  {
+    FileWriter writer(files.back());
+    writer.Write("broken", 6);
+  }
+
+  base::Timer timer;
+  auto const serial = LoadKmlFiles(files, KmlFileType::Text, 1 /* threadsCount */);
+  auto const serialTime = timer.ElapsedSeconds();
+
+  timer.Reset();
+  auto const parallel = LoadKmlFiles(files, KmlFileType::Text, 4 /* threadsCount */);
+  LOG(LINFO, ("Loading of", files.size(), "files. Serial:", serialTime, "s, parallel:",
+              timer.ElapsedSeconds(), "s."));
+
+  TEST_EQUAL(serial.size(), files.size(), ());
+  TEST_EQUAL(parallel.size(), files.size(), ());
+  TEST(serial.back() == nullptr, ());
+  TEST(parallel.back() == nullptr, ());
+  for (size_t i = 0; i < kFilesCount; ++i)
+  {
+    TEST(serial[i] != nullptr, (files[i]));
+    TEST(parallel[i] != nullptr, (files[i]));
+    TEST_EQUAL(parallel[i]->m_bookmarksData.size(), kBookmarksCount, ());
+    TEST_EQUAL(kml::GetDefaultStr(parallel[i]->m_categoryData.m_name),
+               "Category " + strings::to_string(i), ());
+    TEST(*serial[i] == *parallel[i], (files[i]));
+  }
+
+  auto const cancelled = LoadKmlFiles(files, KmlFileType::Text, 4 /* threadsCount */,
+                                      []() { return true; });
+  for (auto const & data : cancelled)
+    TEST(data == nullptr, ());
+}
 } // namespace bookmarks_test
@@ -4,15 +4,20 @@
 
 #include "platform/platform.hpp"
 
+#include "coding/endianness.hpp"
 #include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
 
 #include "geometry/latlon.hpp"
 
 #include "base/file_name_utils.hpp"
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
+#include "base/timer.hpp"
 
 #include <chrono>
+#include <cmath>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -37,6 +42,48 @@ inline string GetGpsTrackFilePath()
   return base::JoinPath(GetPlatform().WritableDir(), "gpstrack_test.bin");
 }
 
+// A day long 1 Hz track, the points are not too close to each other for the simplification.
+vector<location::GpsInfo> MakeTrack(double timestamp, size_t count)
+{
+  vector<location::GpsInfo> points;
+  points.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    double const angle = i * 1e-3;
+    auto point = Make(timestamp + i, ms::LatLon(55.75 + 0.05 * sin(angle), 37.61 + 0.001 * i), 10.5);
+    point.m_altitude = 150.25;
+    point.m_bearing = 90.0;
+    point.m_horizontalAccuracy = 5.0;
+    points.push_back(point);
+  }
+  return points;
+}
+
+void TestEqualItems(location::GpsInfo const & actual, location::GpsInfo const & expected)
+{
+  TEST_EQUAL(actual.m_timestamp, expected.m_timestamp, ());
+  // Coordinates are stored as fixed point numbers.
+  TEST_ALMOST_EQUAL_ABS(actual.m_latitude, expected.m_latitude, 1e-7, ());
+  TEST_ALMOST_EQUAL_ABS(actual.m_longitude, expected.m_longitude, 1e-7, ());
+  TEST_EQUAL(actual.m_altitude, expected.m_altitude, ());
+  TEST_EQUAL(actual.m_speedMpS, expected.m_speedMpS, ());
+  TEST_EQUAL(actual.m_bearing, expected.m_bearing, ());
+  TEST_EQUAL(actual.m_horizontalAccuracy, expected.m_horizontalAccuracy, ());
+  TEST_EQUAL(actual.m_verticalAccuracy, expected.m_verticalAccuracy, ());
+  TEST_EQUAL(actual.m_source, expected.m_source, ());
+}
+
+vector<location::GpsInfo> ReadTimeRange(GpsTrackStorage & stg, double from, double to)
+{
+  vector<location::GpsInfo> points;
+  stg.ForEachInTimeRange(from, to, [&points](location::GpsInfo const & point)
+  {
+    points.push_back(point);
+    return true;
+  });
+  return points;
+}
+
 UNIT_TEST(GpsTrackStorage_WriteReadWithoutTrunc)
 {
   time_t const t = system_clock::to_time_t(system_clock::now());
@@ -186,4 +233,224 @@ UNIT_TEST(GpsTrackStorage_WriteReadWithTrunc)
     TEST_EQUAL(i, 0, ());
   }
 }
+UNIT_TEST(GpsTrackStorage_TimeRange)
+{
+  string const filePath = GetGpsTrackFilePath();
+  SCOPE_GUARD(gpsTestFileDeleter, bind(FileWriter::DeleteFileX, filePath));
+  FileWriter::DeleteFileX(filePath);
+
+  double const timestamp = 1573227904;
+  size_t const fileMaxItemCount = 10000;
+  auto const points = MakeTrack(timestamp, 5000);
+
+  {
+    GpsTrackStorage stg(filePath, fileMaxItemCount);
+    TEST(!stg.GetLastTimestamp(), ());
+
+    // Single points are appended to the open chunk.
+    stg.Append(vector<location::GpsInfo>(points.begin(), points.begin() + 3000));
+    for (size_t i = 3000; i < 3500; ++i)
+      stg.Append({points[i]});
+  }
+
+  {
+    GpsTrackStorage stg(filePath, fileMaxItemCount);
+    stg.Append(vector<location::GpsInfo>(points.begin() + 3500, points.end()));
+    auto const lastTimestamp = stg.GetLastTimestamp();
+    TEST(lastTimestamp, ());
+    TEST_EQUAL(*lastTimestamp, points.back().m_timestamp, ());
+  }
+
+  GpsTrackStorage stg(filePath, fileMaxItemCount);
+  auto const all = ReadTimeRange(stg, numeric_limits<double>::lowest(),
+                                 numeric_limits<double>::max());
+  TEST_EQUAL(all.size(), points.size(), ());
+  for (size_t i = 0; i < all.size(); ++i)
+    TestEqualItems(all[i], points[i]);
+
+  for (auto const & [first, last] : vector<pair<size_t, size_t>>{{0, 0}, {10, 20}, {1000, 3200}, {4990, 4999}})
+  {
+    auto const range = ReadTimeRange(stg, points[first].m_timestamp, points[last].m_timestamp);
+    TEST_EQUAL(range.size(), last - first + 1, (first, last));
+    for (size_t i = 0; i < range.size(); ++i)
+      TestEqualItems(range[i], points[first + i]);
+  }
+
+  TEST(ReadTimeRange(stg, timestamp - 100, timestamp - 1).empty(), ());
+  TEST(ReadTimeRange(stg, timestamp + 0.5, timestamp + 0.7).empty(), ());
+}
+
+UNIT_TEST(GpsTrackStorage_Simplified)
+{
+  string const filePath = GetGpsTrackFilePath();
+  SCOPE_GUARD(gpsTestFileDeleter, bind(FileWriter::DeleteFileX, filePath));
+  FileWriter::DeleteFileX(filePath);
+
+  double const timestamp = 1573227904;
+  auto const points = MakeTrack(timestamp, 10000);
+  GpsTrackStorage stg(filePath, points.size());
+  stg.Append(points);
+
+  size_t prevCount = 0;
+  for (int const zoomLevel : {5, 10, 15, 17})
+  {
+    vector<location::GpsInfo> simplified;
+    stg.ForEachSimplified(timestamp, timestamp + points.size(), zoomLevel,
+                          [&simplified](location::GpsInfo const & point)
+    {
+      simplified.push_back(point);
+      return true;
+    });
+
+    TEST_GREATER_OR_EQUAL(simplified.size(), 2, ());
+    TEST_LESS_OR_EQUAL(simplified.size(), points.size(), ());
+    TEST_GREATER_OR_EQUAL(simplified.size(), prevCount, (zoomLevel));
+    TestEqualItems(simplified.front(), points.front());
+    TestEqualItems(simplified.back(), points.back());
+    for (size_t i = 1; i < simplified.size(); ++i)
+      TEST_LESS(simplified[i - 1].m_timestamp, simplified[i].m_timestamp, ());
+    prevCount = simplified.size();
+  }
+  TEST_LESS(prevCount, points.size(), ());
+}
+
+UNIT_TEST(GpsTrackStorage_BrokenTail)
+{
+  string const filePath = GetGpsTrackFilePath();
+  SCOPE_GUARD(gpsTestFileDeleter, bind(FileWriter::DeleteFileX, filePath));
+  FileWriter::DeleteFileX(filePath);
+
+  double const timestamp = 1573227904;
+  auto const points = MakeTrack(timestamp, 2000);
+  {
+    GpsTrackStorage stg(filePath, points.size());
+    stg.Append(vector<location::GpsInfo>(points.begin(), points.begin() + 1000));
+  }
+
+  // Items written without the chunk header update.
+  {
+    FileWriter writer(filePath, FileWriter::OP_APPEND);
+    vector<uint8_t> const garbage(100, 0xAB);
+    writer.Write(garbage.data(), garbage.size());
+  }
+
+  {
+    GpsTrackStorage stg(filePath, points.size());
+    stg.Append(vector<location::GpsInfo>(points.begin() + 1000, points.end()));
+  }
+
+  GpsTrackStorage stg(filePath, points.size());
+  size_t i = 0;
+  stg.ForEach([&](location::GpsInfo const & point)->bool
+  {
+    TestEqualItems(point, points[i]);
+    ++i;
+    return true;
+  });
+  TEST_EQUAL(i, points.size(), ());
+}
+
+UNIT_TEST(GpsTrackStorage_MigrateFromVersion1)
+{
+  string const filePath = GetGpsTrackFilePath();
+  SCOPE_GUARD(gpsTestFileDeleter, bind(FileWriter::DeleteFileX, filePath));
+  FileWriter::DeleteFileX(filePath);
+
+  double const timestamp = 1573227904;
+  auto const points = MakeTrack(timestamp, 1500);
+  size_t const fileMaxItemCount = 1000;
+
+  {
+    FileWriter writer(filePath);
+    uint32_t const version = SwapIfBigEndianMacroBased(uint32_t{1});
+    writer.Write(&version, sizeof(version));
+    for (auto const & point : points)
+    {
+      for (double value : {point.m_timestamp, point.m_latitude, point.m_longitude,
+                           point.m_altitude, point.m_speedMpS, point.m_bearing,
+                           point.m_horizontalAccuracy, point.m_verticalAccuracy})
+      {
+        value = SwapIfBigEndianMacroBased(value);
+        writer.Write(&value, sizeof(value));
+      }
+      uint8_t const source = static_cast<uint8_t>(point.m_source);
+      writer.Write(&source, sizeof(source));
+    }
+  }
+
+  for (size_t run = 0; run < 2; ++run)
+  {
+    GpsTrackStorage stg(filePath, fileMaxItemCount);
+    size_t i = points.size() - fileMaxItemCount;
+    stg.ForEach([&](location::GpsInfo const & point)->bool
+    {
+      TestEqualItems(point, points[i]);
+      ++i;
+      return true;
+    });
+    TEST_EQUAL(i, points.size(), ());
+  }
+}
+
+UNIT_TEST(GpsTrackStorage_ThroughputBenchmark)
+{
+  string const filePath = GetGpsTrackFilePath();
+  SCOPE_GUARD(gpsTestFileDeleter, bind(FileWriter::DeleteFileX, filePath));
+  FileWriter::DeleteFileX(filePath);
+
+  // Three days of 1 Hz track.
+  size_t const pointsCount = 3 * 24 * 60 * 60;
+  size_t const singleAppendsCount = 1000;
+  double const timestamp = 1573227904;
+  auto const points = MakeTrack(timestamp, pointsCount + singleAppendsCount);
+
+  base::Timer timer;
+  {
+    GpsTrackStorage stg(filePath, pointsCount * 2);
+    stg.Append(vector<location::GpsInfo>(points.begin(), points.begin() + pointsCount));
+  }
+  double const appendSeconds = timer.ElapsedSeconds();
+
+  timer.Reset();
+  GpsTrackStorage stg(filePath, pointsCount * 2);
+  double const openSeconds = timer.ElapsedSeconds();
+
+  timer.Reset();
+  for (size_t i = pointsCount; i < points.size(); ++i)
+    stg.Append({points[i]});
+  double const singleAppendSeconds = timer.ElapsedSeconds() / singleAppendsCount;
+
+  timer.Reset();
+  size_t count = 0;
+  stg.ForEach([&count](location::GpsInfo const &) { ++count; return true; });
+  double const readSeconds = timer.ElapsedSeconds();
+  TEST_EQUAL(count, points.size(), ());
+
+  timer.Reset();
+  double const lastHour = points.back().m_timestamp - 60 * 60;
+  count = ReadTimeRange(stg, lastHour, points.back().m_timestamp).size();
+  double const rangeSeconds = timer.ElapsedSeconds();
+  TEST_EQUAL(count, 60 * 60 + 1, ());
+
+  timer.Reset();
+  size_t simplifiedCount = 0;
+  stg.ForEachSimplified(numeric_limits<double>::lowest(), numeric_limits<double>::max(),
+                        10 /* zoomLevel */, [&simplifiedCount](location::GpsInfo const &)
+  {
+    ++simplifiedCount;
+    return true;
+  });
+  double const simplifiedSeconds = timer.ElapsedSeconds();
+
+  uint64_t fileSize = 0;
+  TEST(base::GetFileSize(filePath, fileSize), ());
+
+  LOG(LINFO, ("Points:", points.size(), "bytes per point:", static_cast<double>(fileSize) / points.size()));
+  LOG(LINFO, ("Append:", pointsCount / appendSeconds, "points per second, single point append:",
+              singleAppendSeconds * 1000, "ms"));
+  LOG(LINFO, ("Open:", openSeconds * 1000, "ms, read:", points.size() / readSeconds,
+              "points per second"));
+  LOG(LINFO, ("Last hour read:", rangeSeconds * 1000, "ms, read simplified for zoom 10:",
+              simplifiedSeconds * 1000, "ms,", simplifiedCount, "points"));
+}
 } // namespace gps_track_storage_test
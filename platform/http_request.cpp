@@ -10,11 +10,13 @@
 
 #include "coding/internal/file_data.hpp"
 #include "coding/file_writer.hpp"
+#include "coding/sha1.hpp"
 
 #include "base/logging.hpp"
 #include "base/string_utils.hpp"
 
 #include <list>
+#include <map>
 #include <memory>
 
 #include "defines.hpp"
@@ -139,6 +141,88 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
   size_t m_goodChunksCount;
   bool m_doCleanProgressFiles;
 
+  /// SHA1 of the file is calculated while downloading, so the file need not be read again
+  /// to check it. Chunks may finish in any order, so the data of the chunks which can't be
+  /// hashed yet is kept in memory. Hashing is dropped if it can't be done on the fly.
+  struct ChunkData
+  {
+    vector<uint8_t> m_data;
+    bool m_finished = false;
+  };
+  unique_ptr<coding::SHA1::Streaming> m_sha1;
+  int64_t m_hashedSize = 0;
+  /// Key is the chunk's begin.
+  map<int64_t, ChunkData> m_chunksData;
+  size_t m_chunksDataSize = 0;
+  string m_sha1Base64;
+
+  static size_t constexpr kMaxChunksDataSize = 16 * 1024 * 1024;
+
+  void DropHashing()
+  {
+    if (!m_sha1)
+      return;
+
+    LOG(LDEBUG, ("SHA1 of", m_filePath, "will not be calculated while downloading"));
+    m_sha1.reset();
+    m_chunksData.clear();
+    m_chunksDataSize = 0;
+  }
+
+  void HashChunkData(int64_t offset, void const * buffer, size_t size)
+  {
+    if (!m_sha1)
+      return;
+
+    auto it = m_chunksData.upper_bound(offset);
+    if (it == m_chunksData.begin())
+      return DropHashing();
+    --it;
+
+    auto & chunk = it->second;
+    if (chunk.m_finished || it->first + static_cast<int64_t>(chunk.m_data.size()) != offset)
+      return DropHashing();
+
+    m_chunksDataSize += size;
+    if (m_chunksDataSize > kMaxChunksDataSize)
+      return DropHashing();
+
+    auto const * bytes = static_cast<uint8_t const *>(buffer);
+    chunk.m_data.insert(chunk.m_data.end(), bytes, bytes + size);
+  }
+
+  void OnChunkFinishedForHash(bool isChunkOk, int64_t begRange, int64_t endRange)
+  {
+    if (!m_sha1)
+      return;
+
+    auto const it = m_chunksData.find(begRange);
+    if (it == m_chunksData.end())
+      return DropHashing();
+
+    if (!isChunkOk)
+    {
+      m_chunksDataSize -= it->second.m_data.size();
+      m_chunksData.erase(it);
+      return;
+    }
+
+    if (static_cast<int64_t>(it->second.m_data.size()) != endRange - begRange + 1)
+      return DropHashing();
+    it->second.m_finished = true;
+
+    // Hash all the finished chunks which follow the hashed part of the file.
+    while (!m_chunksData.empty() && m_chunksData.begin()->first == m_hashedSize &&
+           m_chunksData.begin()->second.m_finished)
+    {
+      auto const & data = m_chunksData.begin()->second.m_data;
+      m_sha1->Update(data.data(), data.size());
+      m_hashedSize += data.size();
+      m_chunksDataSize -= data.size();
+      m_chunksData.erase(m_chunksData.begin());
+    }
+  }
+
   ChunksDownloadStrategy::ResultT StartThreads()
   {
     string url;
@@ -146,6 +230,13 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
     ChunksDownloadStrategy::ResultT result;
     while ((result = m_strategy.NextChunk(url, range)) == ChunksDownloadStrategy::ENextChunk)
     {
+      if (m_sha1)
+      {
+        auto & chunk = m_chunksData[range.first];
+        m_chunksDataSize -= chunk.m_data.size();
+        chunk = {};
+      }
+
       HttpThread * p = CreateNativeHttpThread(url, *this, range.first, range.second, m_progress.m_bytesTotal);
       ASSERT ( p, () );
       m_threads.push_back(make_pair(p, range.first));
@@ -189,6 +280,7 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
     {
       m_writer->Seek(offset);
       m_writer->Write(buffer, size);
+      HashChunkData(offset, buffer, size);
       return true;
     }
     catch (Writer::Exception const & e)
@@ -223,6 +315,7 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
 
     bool const isChunkOk = (httpOrErrorCode == 200);
     string const urlError = m_strategy.ChunkFinished(isChunkOk, make_pair(begRange, endRange));
+    OnChunkFinishedForHash(isChunkOk, begRange, endRange);
 
     // remove completed chunk from the list, beg is the key
     RemoveHttpThreadByKey(begRange);
@@ -267,6 +360,10 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
     // 3. Clean up resume file with chunks range on success
     if (m_status == DownloadStatus::Completed)
     {
+      if (m_sha1 && m_hashedSize == m_progress.m_bytesTotal)
+        m_sha1Base64 = coding::SHA1::ToBase64(m_sha1->Finalize());
+      DropHashing();
+
       Platform::RemoveFileIfExists(m_filePath + RESUME_FILE_EXTENSION);
 
       // Rename finished file to it's original name.
@@ -319,6 +416,10 @@ public:
         m_strategy.InitChunks(fileSize, chunkSize);
     }
 
+    // The already downloaded part of a resumed file is not in memory to be hashed.
+    if (openMode == FileWriter::OP_WRITE_TRUNCATE)
+      m_sha1 = make_unique<coding::SHA1::Streaming>();
+
     // Create file and reserve needed size.
     unique_ptr<FileWriter> writer(new FileWriter(filePath + DOWNLOADING_FILE_EXTENSION, openMode));
 
@@ -356,6 +457,11 @@ public:
   {
     return m_filePath;
   }
+
+  virtual string const & GetFileSha1Base64() const
+  {
+    return m_sha1Base64;
+  }
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -371,6 +477,12 @@ HttpRequest::~HttpRequest()
 {
 }
 
+string const & HttpRequest::GetFileSha1Base64() const
+{
+  static string const kEmpty;
+  return kEmpty;
+}
+
 HttpRequest * HttpRequest::Get(string const & url, Callback && onFinish, Callback && onProgress)
 {
   return new MemoryHttpRequest(url, std::move(onFinish), std::move(onProgress));
@@ -41,6 +41,9 @@ public:
   Progress const & GetProgress() const { return m_progress; }
   /// Either file path (for chunks) or downloaded data
   virtual std::string const & GetData() const = 0;
+  /// Base64 SHA1 of the downloaded file, calculated while downloading.
+  /// Empty if it could not be calculated on the fly (e.g. the download was resumed).
+  virtual std::string const & GetFileSha1Base64() const;
 
   /// Response saved to memory buffer and retrieved with Data()
   static HttpRequest * Get(std::string const & url,
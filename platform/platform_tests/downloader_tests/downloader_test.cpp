@@ -7,6 +7,7 @@
 #include "coding/file_reader.hpp"
 #include "coding/file_writer.hpp"
 #include "coding/internal/file_data.hpp"
+#include "coding/sha1.hpp"
 
 #include "base/logging.hpp"
 #include "base/std_serialization.hpp"
@@ -407,6 +408,7 @@ UNIT_TEST(DownloadChunks)
     observer.TestOk();
     TEST_EQUAL(request->GetData(), kFileName, ());
     TEST_EQUAL(ReadFileAsString(kFileName), "Test1", ());
+    TEST_EQUAL(request->GetFileSha1Base64(), coding::SHA1::CalculateBase64(kFileName), ());
     FinishDownloadSuccess(kFileName);
   }
 
@@ -427,10 +429,12 @@ UNIT_TEST(DownloadChunks)
   fileSize = kBigFileSize;
   {
     // 3 threads - succeeded
-    [[maybe_unused]] unique_ptr<HttpRequest> const request {MakeRequest(2048)};
+    unique_ptr<HttpRequest> const request {MakeRequest(2048)};
     // wait until download is finished
     QCoreApplication::exec();
     observer.TestOk();
+    // Chunks finish in arbitrary order but the hash is still calculated on the fly.
+    TEST_EQUAL(request->GetFileSha1Base64(), coding::SHA1::CalculateBase64(kFileName), ());
     FinishDownloadSuccess(kFileName);
   }
 
@@ -439,10 +443,12 @@ UNIT_TEST(DownloadChunks)
   fileSize = kBigFileSize;
   {
     // 3 threads with only one valid url - succeeded
-    [[maybe_unused]] unique_ptr<HttpRequest> const request {MakeRequest(2048)};
+    unique_ptr<HttpRequest> const request {MakeRequest(2048)};
     // wait until download is finished
     QCoreApplication::exec();
     observer.TestOk();
+    // Failed chunks are downloaded again and don't break the hash.
+    TEST_EQUAL(request->GetFileSha1Base64(), coding::SHA1::CalculateBase64(kFileName), ());
     FinishDownloadSuccess(kFileName);
   }
 
@@ -555,6 +561,8 @@ UNIT_TEST(DownloadResumeChunks)
                                                          bind(&ResumeChecker::OnProgress, &checker, _1)));
     QCoreApplication::exec();
 
+    // The part downloaded before resuming is not hashed on the fly.
+    TEST(request->GetFileSha1Base64().empty(), ());
     FinishDownloadSuccess(FILENAME);
   }
 }
@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <functional>
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <optional>
 #include <queue>
@@ -222,6 +223,17 @@ public:
     });
   }
 
+  /// Finds the best path like FindPathBidirectional() and up to |maxCount| - 1 alternatives to it.
+  /// The waves go on until they cover paths longer than the best one by |maxStretch|. Then
+  /// every vertex reached by both waves is used as a via vertex: start -> via vertex by the forward
+  /// wave, via vertex -> finish by the backward one. |results| are the best path and the
+  /// alternatives in order of their length. Alternatives may contain loops and share a lot with
+  /// the best path, it's up to the caller to filter them.
+  template <class P>
+  Result FindPathBidirectionalWithAlternatives(
+      P & params, double maxStretch, size_t maxCount,
+      std::vector<RoutingResult<Vertex, Weight>> & results) const;
+
   // Adjust route to the previous one.
   // Expects |params.m_checkLengthCallback| to check wave propagation limit.
   template <typename P>
@@ -383,6 +395,20 @@ private:
     Weight pS;
   };
 
+  // Path found by the bidirectional waves: forward.bestVertex -> backward.bestVertex.
+  struct BidirectionalBestPath
+  {
+    bool found = false;
+    Weight reducedLength = kZeroDistance;
+    Weight realLength = kZeroDistance;
+  };
+
+  // Settles the top state of |cur| queue and relaxes its edges. Updates |bestPath| if
+  // a shorter path through a vertex reached by both waves is found.
+  template <class P>
+  void StepBidirectional(P & params, BidirectionalStepContext & cur, BidirectionalStepContext & nxt,
+                         typename Graph::EdgeListT & adj, BidirectionalBestPath & bestPath) const;
+
   static void ReconstructPath(Vertex const & v,
                               typename BidirectionalStepContext::Parents const & parent,
                               std::vector<Vertex> & path);
@@ -581,12 +607,7 @@ AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalEx(P & params, Emitte
   BidirectionalStepContext forward(true /* forward */, startVertex, finalVertex, graph);
   BidirectionalStepContext backward(false /* forward */, startVertex, finalVertex, graph);
 
-  auto & forwardParents = forward.GetParents();
-  auto & backwardParents = backward.GetParents();
-
-  bool foundAnyPath = false;
-  Weight bestPathReducedLength = kZeroDistance;
-  Weight bestPathRealLength = kZeroDistance;
+  BidirectionalBestPath bestPath;
 
   forward.UpdateDistance(State(startVertex, kZeroDistance));
   forward.queue.push(State(startVertex, kZeroDistance, forward.ConsistentHeuristic(startVertex)));
@@ -601,18 +622,16 @@ AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalEx(P & params, Emitte
   BidirectionalStepContext * cur = &forward;
   BidirectionalStepContext * nxt = &backward;
 
-  auto const EmitResult = [cur, nxt, &bestPathRealLength, &emitter]()
+  auto const EmitResult = [&forward, &backward, &bestPath, &emitter]()
   {
     // No problem if length check fails, but we still emit the result.
     // Happens with "transit" route because of length, haven't seen with regular car route.
-    //ASSERT(params.m_checkLengthCallback(bestPathRealLength), ());
+    //ASSERT(params.m_checkLengthCallback(bestPath.realLength), ());
 
     RoutingResult<Vertex, Weight> result;
-    ReconstructPathBidirectional(cur->bestVertex, nxt->bestVertex, cur->parent, nxt->parent, result.m_path);
-    result.m_distance = bestPathRealLength;
-    if (!cur->forward)
-      reverse(result.m_path.begin(), result.m_path.end());
-
+    ReconstructPathBidirectional(forward.bestVertex, backward.bestVertex, forward.parent,
+                                 backward.parent, result.m_path);
+    result.m_distance = bestPath.realLength;
     return emitter(std::move(result));
   };
 
@@ -634,14 +653,14 @@ AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalEx(P & params, Emitte
     if (steps % kQueueSwitchPeriod == 0)
       std::swap(cur, nxt);
 
-    if (foundAnyPath)
+    if (bestPath.found)
     {
       auto const curTop = cur->TopDistance();
       auto const nxtTop = nxt->TopDistance();
 
       // The intuition behind this is that we cannot obtain a path shorter
       // than the left side of the inequality because that is how any path we find
-      // will look like (see comment for curPathReducedLength below).
+      // will look like (see comment for curPathReducedLength in StepBidirectional).
       // We do not yet have the proof that we will not miss a good path by doing so.
 
       // The shortest reduced path corresponds to the shortest real path
@@ -650,91 +669,235 @@ AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalEx(P & params, Emitte
       // several top states in a priority queue may have equal reduced path lengths and
       // different real path lengths.
 
-      if (curTop + nxtTop >= bestPathReducedLength - epsilon)
+      if (curTop + nxtTop >= bestPath.reducedLength - epsilon)
       {
         if (EmitResult())
           return Result::OK;
         else
-          foundAnyPath = false;
+          bestPath.found = false;
       }
     }
 
-    State const stateV = cur->queue.top();
-    cur->queue.pop();
+    StepBidirectional(params, *cur, *nxt, adj, bestPath);
+  }
 
-    if (cur->ExistsStateWithBetterDistance(stateV))
-      continue;
+  if (bestPath.found)
+  {
+    (void)EmitResult();
+    return Result::OK;
+  }
 
-    auto const endV = cur->forward ? cur->finalVertex : cur->startVertex;
-    params.m_onVisitedVertexCallback(std::make_pair(stateV, cur), endV);
+  return Result::NoPath;
+}
 
-    cur->GetAdjacencyList(stateV, adj);
-    auto const & pV = stateV.heuristic;
-    for (auto const & edge : adj)
-    {
-      State stateW(edge.GetTarget(), kZeroDistance);
+template <typename Vertex, typename Edge, typename Weight>
+template <class P>
+typename AStarAlgorithm<Vertex, Edge, Weight>::Result
+AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalWithAlternatives(
+    P & params, double maxStretch, size_t maxCount,
+    std::vector<RoutingResult<Vertex, Weight>> & results) const
+{
+  CHECK_GREATER_OR_EQUAL(maxStretch, 0.0, ());
+  CHECK_GREATER(maxCount, 0, ());
 
-      if (stateV.vertex == stateW.vertex)
-        continue;
+  results.clear();
 
-      auto const weight = edge.GetWeight();
-      auto const pW = cur->ConsistentHeuristic(stateW.vertex);
-      auto const reducedWeight = weight + pW - pV;
+  auto const epsilon = params.m_weightEpsilon;
+  auto & graph = params.m_graph;
+  auto const & finalVertex = params.m_finalVertex;
+  auto const & startVertex = params.m_startVertex;
 
-      if (reducedWeight < -epsilon && params.m_badReducedWeight(reducedWeight, std::max(pW, pV)))
-      {
-        // Break in Debug, log in Release and safe continue: std::max(reducedWeight, kZeroDistance).
-        LOG(LERROR, ("Invariant violated for:", "v =", stateV.vertex, "w =", stateW.vertex,
-                     "reduced weight =", reducedWeight));
-      }
+  BidirectionalStepContext forward(true /* forward */, startVertex, finalVertex, graph);
+  BidirectionalStepContext backward(false /* forward */, startVertex, finalVertex, graph);
 
-      stateW.distance = stateV.distance + std::max(reducedWeight, kZeroDistance);
+  BidirectionalBestPath bestPath;
 
-      auto const fullLength = weight + stateV.distance + cur->pS - pV;
-      if (!params.m_checkLengthCallback(fullLength))
-        continue;
+  forward.UpdateDistance(State(startVertex, kZeroDistance));
+  forward.queue.push(State(startVertex, kZeroDistance, forward.ConsistentHeuristic(startVertex)));
 
-      if (cur->ExistsStateWithBetterDistance(stateW, epsilon))
-        continue;
+  backward.UpdateDistance(State(finalVertex, kZeroDistance));
+  backward.queue.push(State(finalVertex, kZeroDistance, backward.ConsistentHeuristic(finalVertex)));
+
+  BidirectionalStepContext * cur = &forward;
+  BidirectionalStepContext * nxt = &backward;
 
-      stateW.heuristic = pW;
-      cur->UpdateDistance(stateW);
-      cur->UpdateParent(stateW.vertex, stateV.vertex);
+  typename Graph::EdgeListT adj;
+
+  uint32_t steps = 0;
+  PeriodicPollCancellable periodicCancellable(params.m_cancellable);
+
+  // The waves go on after the best path is found until they cover all the paths which are
+  // not longer than the best one by |maxStretch|. Reduced and real lengths of a path
+  // differ by a constant, so the stretch may be added to the reduced length.
+  // Unlike FindPathBidirectionalEx() an exhausted wave doesn't stop the other one because
+  // via vertices are looked for among the vertices reached by both waves.
+  while (!cur->queue.empty() || !nxt->queue.empty())
+  {
+    ++steps;
+
+    if (periodicCancellable.IsCancelled())
+      return Result::Cancelled;
+
+    // If one of the waves is exhausted before they meet there is no path.
+    if (!bestPath.found && (cur->queue.empty() || nxt->queue.empty()))
+      return Result::NoPath;
+
+    // The other wave may be exhausted already, it is not switched to then.
+    if ((steps % kQueueSwitchPeriod == 0 && !nxt->queue.empty()) || cur->queue.empty())
+      std::swap(cur, nxt);
 
-      if (auto op = nxt->GetDistance(stateW.vertex); op)
+    if (bestPath.found)
+    {
+      // Reduced distances are not negative, so the top of an exhausted wave is zero.
+      auto const nxtTop = nxt->queue.empty() ? kZeroDistance : nxt->TopDistance();
+      if (cur->TopDistance() + nxtTop >=
+          bestPath.reducedLength + maxStretch * bestPath.realLength - epsilon)
       {
-        auto const & distW = *op;
-        // Reduced length that the path we've just found has in the original graph:
-        // find the reduced length of the path's parts in the reduced forward and backward graphs.
-        auto const curPathReducedLength = stateW.distance + distW;
-        // No epsilon here: it is ok to overshoot slightly.
-        if ((!foundAnyPath || bestPathReducedLength > curPathReducedLength) &&
-            graph.AreWavesConnectible(forwardParents, stateW.vertex, backwardParents))
-        {
-          bestPathReducedLength = curPathReducedLength;
-
-          bestPathRealLength = stateV.distance + weight + distW;
-          bestPathRealLength += cur->pS - pV;
-          bestPathRealLength += nxt->pS - nxt->ConsistentHeuristic(stateW.vertex);
-
-          foundAnyPath = true;
-          cur->bestVertex = stateV.vertex;
-          nxt->bestVertex = stateW.vertex;
-        }
+        break;
       }
-
-      if (stateW.vertex != endV)
-        cur->queue.push(stateW);
     }
+
+    StepBidirectional(params, *cur, *nxt, adj, bestPath);
   }
 
-  if (foundAnyPath)
+  if (!bestPath.found)
+    return Result::NoPath;
+
+  auto & best = results.emplace_back();
+  ReconstructPathBidirectional(forward.bestVertex, backward.bestVertex, forward.parent,
+                               backward.parent, best.m_path);
+  best.m_distance = bestPath.realLength;
+
+  // Every vertex reached by both waves is a via vertex of a path: start -> via vertex by the
+  // parents of the forward wave and via vertex -> finish by the parents of the backward one.
+  // p_f(v) + p_r(v) == 0, so the real length of such a path is the sum of reduced distances
+  // plus the potentials of the start and the finish.
+  Weight const maxRealLength = bestPath.realLength + maxStretch * bestPath.realLength;
+  std::vector<std::pair<Weight, Vertex>> viaVertices;
+  for (auto const & [vertex, forwardDistance] : forward.bestDistance)
   {
-    (void)EmitResult();
-    return Result::OK;
+    auto const backwardDistance = backward.GetDistance(vertex);
+    if (!backwardDistance)
+      continue;
+
+    auto const realLength = forwardDistance + *backwardDistance + forward.pS + backward.pS;
+    if (realLength <= maxRealLength)
+      viaVertices.emplace_back(realLength, vertex);
   }
 
-  return Result::NoPath;
+  std::sort(viaVertices.begin(), viaVertices.end(),
+            [](auto const & lhs, auto const & rhs) { return lhs.first < rhs.first; });
+
+  // Via vertices of an emitted path lead to the same or a very similar path, they are skipped.
+  ska::bytell_hash_set<Vertex> covered(best.m_path.cbegin(), best.m_path.cend());
+  std::vector<Vertex> backwardPath;
+  for (auto const & [realLength, vertex] : viaVertices)
+  {
+    if (results.size() >= maxCount)
+      break;
+
+    if (covered.count(vertex) != 0)
+      continue;
+
+    if (!graph.AreWavesConnectible(forward.parent, vertex, backward.parent))
+      continue;
+
+    RoutingResult<Vertex, Weight> result;
+    ReconstructPath(vertex, forward.parent, result.m_path);
+    ReconstructPath(vertex, backward.parent, backwardPath);
+    CHECK(!backwardPath.empty(), ());
+    // |vertex| is the last vertex of the forward part and the last one of |backwardPath|.
+    result.m_path.insert(result.m_path.end(), std::next(backwardPath.rbegin()),
+                         backwardPath.rend());
+    result.m_distance = realLength;
+
+    covered.insert(result.m_path.cbegin(), result.m_path.cend());
+    results.push_back(std::move(result));
+  }
+
+  return Result::OK;
+}
+
+template <typename Vertex, typename Edge, typename Weight>
+template <class P>
+void AStarAlgorithm<Vertex, Edge, Weight>::StepBidirectional(P & params,
+                                                             BidirectionalStepContext & cur,
+                                                             BidirectionalStepContext & nxt,
+                                                             typename Graph::EdgeListT & adj,
+                                                             BidirectionalBestPath & bestPath) const
+{
+  auto const epsilon = params.m_weightEpsilon;
+  auto & graph = params.m_graph;
+  auto & forward = cur.forward ? cur : nxt;
+  auto & backward = cur.forward ? nxt : cur;
+
+  State const stateV = cur.queue.top();
+  cur.queue.pop();
+
+  if (cur.ExistsStateWithBetterDistance(stateV))
+    return;
+
+  auto const endV = cur.forward ? cur.finalVertex : cur.startVertex;
+  params.m_onVisitedVertexCallback(std::make_pair(stateV, &cur), endV);
+
+  cur.GetAdjacencyList(stateV, adj);
+  auto const & pV = stateV.heuristic;
+  for (auto const & edge : adj)
+  {
+    State stateW(edge.GetTarget(), kZeroDistance);
+
+    if (stateV.vertex == stateW.vertex)
+      continue;
+
+    auto const weight = edge.GetWeight();
+    auto const pW = cur.ConsistentHeuristic(stateW.vertex);
+    auto const reducedWeight = weight + pW - pV;
+
+    if (reducedWeight < -epsilon && params.m_badReducedWeight(reducedWeight, std::max(pW, pV)))
+    {
+      // Break in Debug, log in Release and safe continue: std::max(reducedWeight, kZeroDistance).
+      LOG(LERROR, ("Invariant violated for:", "v =", stateV.vertex, "w =", stateW.vertex,
+                   "reduced weight =", reducedWeight));
+    }
+
+    stateW.distance = stateV.distance + std::max(reducedWeight, kZeroDistance);
+
+    auto const fullLength = weight + stateV.distance + cur.pS - pV;
+    if (!params.m_checkLengthCallback(fullLength))
+      continue;
+
+    if (cur.ExistsStateWithBetterDistance(stateW, epsilon))
+      continue;
+
+    stateW.heuristic = pW;
+    cur.UpdateDistance(stateW);
+    cur.UpdateParent(stateW.vertex, stateV.vertex);
+
+    if (auto op = nxt.GetDistance(stateW.vertex); op)
+    {
+      auto const & distW = *op;
+      // Reduced length that the path we've just found has in the original graph:
+      // find the reduced length of the path's parts in the reduced forward and backward graphs.
+      auto const curPathReducedLength = stateW.distance + distW;
+      // No epsilon here: it is ok to overshoot slightly.
+      if ((!bestPath.found || bestPath.reducedLength > curPathReducedLength) &&
+          graph.AreWavesConnectible(forward.parent, stateW.vertex, backward.parent))
+      {
+        bestPath.reducedLength = curPathReducedLength;
+
+        bestPath.realLength = stateV.distance + weight + distW;
+        bestPath.realLength += cur.pS - pV;
+        bestPath.realLength += nxt.pS - nxt.ConsistentHeuristic(stateW.vertex);
+
+        bestPath.found = true;
+        cur.bestVertex = stateV.vertex;
+        nxt.bestVertex = stateW.vertex;
+      }
+    }
+
+    if (stateW.vertex != endV)
+      cur.queue.push(stateW);
+  }
 }
 
 template <typename Vertex, typename Edge, typename Weight>
@@ -2,6 +2,7 @@
 
 #include "routing/geometry.hpp"
 #include "routing/latlon_with_altitude.hpp"
+#include "routing/live_speeds.hpp"
 #include "routing/routing_helpers.hpp"
 #include "routing/traffic_stash.hpp"
 
@@ -13,6 +14,7 @@
 #include "base/assert.hpp"
 
 #include <algorithm>
+#include <optional>
 #include <unordered_map>
 
 namespace routing
@@ -257,6 +259,13 @@ double EdgeEstimator::CalcOffroad(ms::LatLon const & from, ms::LatLon const & to
   return TimeBetweenSec(from, to, KmphToMps(offroadSpeedKMpH));
 }
 
+double EdgeEstimator::CalcSegmentWeightBySpeed(Segment const & segment, RoadGeometry const & road,
+                                               double speedKMpH) const
+{
+  double const speedMpS = min(KmphToMps(speedKMpH), GetMaxWeightSpeedMpS());
+  return road.GetDistance(segment.GetSegmentIdx()) / speedMpS;
+}
+
 // PedestrianEstimator -----------------------------------------------------------------------------
 class PedestrianEstimator final : public EdgeEstimator
 {
@@ -359,10 +368,15 @@ public:
 
   // EdgeEstimator overrides:
   double CalcSegmentWeight(Segment const & segment, RoadGeometry const & road, Purpose purpose) const override;
+  double CalcSegmentWeightAtSpeed(Segment const & segment, RoadGeometry const & road,
+                                  Purpose purpose, double speedKMpH) const override;
   double GetUTurnPenalty(Purpose /* purpose */) const override;
   double GetFerryLandingPenalty(Purpose purpose) const override;
 
 private:
+  double CalcSegmentWeight(Segment const & segment, RoadGeometry const & road, Purpose purpose,
+                           std::optional<double> profileSpeedKMpH) const;
+
   shared_ptr<TrafficStash> m_trafficStash;
 };
 
@@ -395,7 +409,40 @@ double CarEstimator::GetFerryLandingPenalty(Purpose purpose) const
 
 double CarEstimator::CalcSegmentWeight(Segment const & segment, RoadGeometry const & road, Purpose purpose) const
 {
-  double result = road.GetDistance(segment.GetSegmentIdx()) / GetSpeedMpS(purpose, segment, road);
+  return CalcSegmentWeight(segment, road, purpose, std::nullopt /* profileSpeedKMpH */);
+}
+
+double CarEstimator::CalcSegmentWeightAtSpeed(Segment const & segment, RoadGeometry const & road,
+                                              Purpose purpose, double speedKMpH) const
+{
+  return CalcSegmentWeight(segment, road, purpose, speedKMpH);
+}
+
+double CarEstimator::CalcSegmentWeight(Segment const & segment, RoadGeometry const & road,
+                                       Purpose purpose, std::optional<double> profileSpeedKMpH) const
+{
+  if (auto const * liveSpeeds = GetLiveSpeeds())
+  {
+    if (auto const speedKMpH = liveSpeeds->GetSpeedKMpH(segment))
+      return CalcSegmentWeightBySpeed(segment, road, *speedKMpH);
+  }
+
+  double speedMpS = GetSpeedMpS(purpose, segment, road);
+  if (profileSpeedKMpH)
+  {
+    // A profile speed is a measured one, so it's taken as ETA speed. Weight speed is lowered
+    // in the same proportion as the weight speed of the vehicle model.
+    SpeedKMpH const & modelSpeed = road.GetSpeed(segment.IsForward());
+    speedMpS = KmphToMps(*profileSpeedKMpH);
+    if (purpose == Purpose::Weight)
+    {
+      speedMpS *= modelSpeed.m_weight / modelSpeed.m_eta;
+      // Speeds above the max weight speed would make the A* heuristic inadmissible.
+      speedMpS = min(speedMpS, GetMaxWeightSpeedMpS());
+    }
+  }
+
+  double result = road.GetDistance(segment.GetSegmentIdx()) / speedMpS;
 
   if (m_trafficStash)
   {
@@ -15,6 +15,7 @@ class DataSource;
 
 namespace routing
 {
+class LiveSpeeds;
 class RoadGeometry;
 class TrafficStash;
 
@@ -47,9 +48,21 @@ public:
 
   virtual double CalcSegmentWeight(Segment const & segment, RoadGeometry const & road,
                                    Purpose purpose) const = 0;
+  // Same as CalcSegmentWeight() but the typical speed |speedKMpH| of the time of day |segment| is
+  // reached is used instead of the speed of the vehicle model. Speed profiles are built for cars
+  // only, other estimators ignore the speed.
+  virtual double CalcSegmentWeightAtSpeed(Segment const & segment, RoadGeometry const & road,
+                                          Purpose purpose, double /* speedKMpH */) const
+  {
+    return CalcSegmentWeight(segment, road, purpose);
+  }
   virtual double GetUTurnPenalty(Purpose purpose) const = 0;
   virtual double GetFerryLandingPenalty(Purpose purpose) const = 0;
 
+  // Measured speeds used instead of the speeds of the vehicle model while the snapshot is set.
+  // The snapshot is expected to be kept for the whole route calculation.
+  void SetLiveSpeeds(std::shared_ptr<LiveSpeeds const> liveSpeeds) { m_liveSpeeds = std::move(liveSpeeds); }
+
   static std::shared_ptr<EdgeEstimator> Create(VehicleType vehicleType, double maxWeighSpeedKMpH,
                                                SpeedKMpH const & offroadSpeedKMpH,
                                                std::shared_ptr<TrafficStash> trafficStash,
@@ -62,9 +75,16 @@ public:
                                                DataSource * dataSourcePtr,
                                                std::shared_ptr<NumMwmIds> numMwmIds);
 
+protected:
+  LiveSpeeds const * GetLiveSpeeds() const { return m_liveSpeeds.get(); }
+  // Speeds above the max weight speed would make the A* heuristic inadmissible.
+  double CalcSegmentWeightBySpeed(Segment const & segment, RoadGeometry const & road,
+                                  double speedKMpH) const;
+
 private:
   double const m_maxWeightSpeedMpS;
   SpeedKMpH const m_offroadSpeedKMpH;
+  std::shared_ptr<LiveSpeeds const> m_liveSpeeds;
 
   //DataSource * m_dataSourcePtr;
   //std::shared_ptr<NumMwmIds> m_numMwmIds;
@@ -244,6 +244,11 @@ void IndexGraph::SetRoadAccess(RoadAccess && roadAccess)
   m_roadAccess.SetCurrentTimeGetter(m_currentTimeGetter);
 }
 
+void IndexGraph::SetSpeedProfiles(SpeedProfiles && speedProfiles)
+{
+  m_speedProfiles = std::move(speedProfiles);
+}
+
 void IndexGraph::GetNeighboringEdges(astar::VertexData<Segment, RouteWeight> const & fromVertexData,
                                      RoadPoint const & rp, bool isOutgoing, bool useRoutingOptions,
                                      SegmentEdgeListT & edges, Parents<Segment> const & parents,
@@ -553,12 +558,43 @@ RouteWeight IndexGraph::CalculateEdgeWeight(EdgeEstimator::Purpose purpose, bool
                                             Segment const & from, Segment const & to,
                                             std::optional<RouteWeight const> const & prevWeight) const
 {
-  auto const & segment = isOutgoing ? to : from;
-  auto const & road = GetRoadGeometry(segment.GetFeatureId());
-
-  auto const weight = RouteWeight(m_estimator->CalcSegmentWeight(segment, road, purpose));
+  // The time a segment is reached is known for the forward wave only, the backward one uses
+  // the typical speeds of the current time.
+  double const timeToSegment = isOutgoing && prevWeight ? prevWeight->GetWeight() : 0.0;
+  auto const weight =
+      RouteWeight(CalcSegmentWeight(purpose, isOutgoing ? to : from, timeToSegment));
   auto const penalties = GetPenalties(purpose, isOutgoing ? from : to, isOutgoing ? to : from, prevWeight);
 
   return weight + penalties;
 }
+
+double IndexGraph::CalculateETA(Segment const & from, Segment const & to, double timeToFrom) const
+{
+  auto const weight = RouteWeight(CalcSegmentWeight(EdgeEstimator::Purpose::ETA, to, timeToFrom));
+  auto const penalties = GetPenalties(EdgeEstimator::Purpose::ETA, from, to, std::nullopt /* prevWeight */);
+
+  return (weight + penalties).GetWeight();
+}
+
+double IndexGraph::CalcSegmentWeight(EdgeEstimator::Purpose purpose, Segment const & segment,
+                                     double timeToSegment) const
+{
+  auto const & road = GetRoadGeometry(segment.GetFeatureId());
+  if (m_speedProfiles.IsEmpty())
+    return m_estimator->CalcSegmentWeight(segment, road, purpose);
+
+  auto const currentTime = m_currentTimeGetter();
+  if (currentTime != m_cachedCurrentTime)
+  {
+    m_cachedCurrentTime = currentTime;
+    m_cachedTimeOfDay = SpeedProfiles::GetTimeOfDay(currentTime);
+  }
+  auto const timeOfDay = m_cachedTimeOfDay + static_cast<uint32_t>(timeToSegment);
+  auto const speedKMpH =
+      m_speedProfiles.GetSpeedKMpH(segment.GetFeatureId(), segment.IsForward(), timeOfDay);
+  if (!speedKMpH)
+    return m_estimator->CalcSegmentWeight(segment, road, purpose);
+
+  return m_estimator->CalcSegmentWeightAtSpeed(segment, road, purpose, *speedKMpH);
+}
 }  // namespace routing
@@ -14,6 +14,7 @@
 #include "routing/road_point.hpp"
 #include "routing/routing_options.hpp"
 #include "routing/segment.hpp"
+#include "routing/speed_profiles.hpp"
 
 #include "geometry/point2d.hpp"
 
@@ -93,6 +94,9 @@ public:
   void SetRestrictions(RestrictionVec && restrictions);
   void SetUTurnRestrictions(std::vector<RestrictionUTurn> && noUTurnRestrictions);
   void SetRoadAccess(RoadAccess && roadAccess);
+  /// \brief Makes weights of roads with speed profiles time-dependent: a segment is passed with
+  /// the typical speed of the time it's reached.
+  void SetSpeedProfiles(SpeedProfiles && speedProfiles);
 
   void PushFromSerializer(Joint::Id jointId, RoadPoint const & rp)
   {
@@ -140,6 +144,11 @@ public:
   RouteWeight CalculateEdgeWeight(EdgeEstimator::Purpose purpose, bool isOutgoing,
                                   Segment const & from, Segment const & to,
                                   std::optional<RouteWeight const> const & prevWeight = std::nullopt) const;
+  /// @param[in]  timeToFrom time in seconds since the route start when the end of |from| is reached.
+  /// It selects typical speeds of speed profiles only, access:conditional is checked for the
+  /// current time as for the other ETA calculations.
+  /// @return ETA of the transition from |from| to |to| and of |to| segment.
+  double CalculateETA(Segment const & from, Segment const & to, double timeToFrom) const;
 
   template <typename T>
   void SetCurrentTimeGetter(T && t) { m_currentTimeGetter = std::forward<T>(t); }
@@ -180,6 +189,10 @@ private:
   /// path until |u|.
   RouteWeight GetPenalties(EdgeEstimator::Purpose purpose, Segment const & u, Segment const & v,
                            std::optional<RouteWeight> const & prevWeight) const;
+  /// \brief Weight of |segment|. If speed profiles are set, the typical speed of the time
+  /// |timeToSegment| seconds later than the current time is used.
+  double CalcSegmentWeight(EdgeEstimator::Purpose purpose, Segment const & segment,
+                           double timeToSegment) const;
 
   void GetSegmentCandidateForRoadPoint(RoadPoint const & rp, NumMwmId numMwmId,
                                        bool isOutgoing, SegmentListT & children) const;
@@ -224,6 +237,12 @@ private:
   std::function<time_t()> m_currentTimeGetter = []() {
     return GetCurrentTimestamp();
   };
+
+  SpeedProfiles m_speedProfiles;
+  // Local time of day of the current time, it's cached because every time-dependent weight
+  // needs it.
+  mutable time_t m_cachedCurrentTime = -1;
+  mutable uint32_t m_cachedTimeOfDay = 0;
 };
 
 template <typename AccessPositionType>
@@ -9,6 +9,7 @@
 #include "routing/route.hpp"
 #include "routing/routing_exceptions.hpp"
 #include "routing/speed_camera_ser_des.hpp"
+#include "routing/speed_profiles.hpp"
 
 #include "platform/country_defines.hpp"
 
@@ -27,19 +28,38 @@ namespace
 using namespace routing;
 using namespace std;
 
+bool ReadSpeedProfilesFromMwm(MwmValue const & mwmValue, SpeedProfiles & speedProfiles)
+{
+  if (!mwmValue.m_cont.IsExist(SPEED_PROFILES_FILE_TAG))
+    return false;
+
+  try
+  {
+    speedProfiles.Load(mwmValue.m_cont.GetReader(SPEED_PROFILES_FILE_TAG));
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LERROR, ("Error while reading", SPEED_PROFILES_FILE_TAG, "section.", e.Msg()));
+    return false;
+  }
+  return true;
+}
+
 class IndexGraphLoaderImpl final : public IndexGraphLoader
 {
 public:
   IndexGraphLoaderImpl(VehicleType vehicleType, bool loadAltitudes,
                        shared_ptr<VehicleModelFactoryInterface> vehicleModelFactory,
                        shared_ptr<EdgeEstimator> estimator, MwmDataSource & dataSource,
-                       RoutingOptions routingOptions = RoutingOptions())
+                       RoutingOptions routingOptions = RoutingOptions(),
+                       bool timeDependentWeights = false)
     : m_vehicleType(vehicleType)
     , m_loadAltitudes(loadAltitudes)
     , m_dataSource(dataSource)
     , m_vehicleModelFactory(std::move(vehicleModelFactory))
     , m_estimator(std::move(estimator))
     , m_avoidRoutingOptions(routingOptions)
+    , m_timeDependentWeights(timeDependentWeights)
   {
     CHECK(m_vehicleModelFactory, ());
     CHECK(m_estimator, ());
@@ -76,6 +96,7 @@ private:
   CamerasMapT const & ReceiveSpeedCamsFromMwm(NumMwmId numMwmId);
 
   RoutingOptions m_avoidRoutingOptions;
+  bool m_timeDependentWeights;
   std::function<time_t()> m_currentTimeGetter = [time = GetCurrentTimestamp()]() {
     return time;
   };
@@ -176,6 +197,13 @@ IndexGraphLoaderImpl::GraphPtrT IndexGraphLoaderImpl::CreateIndexGraph(NumMwmId
   DeserializeIndexGraph(*value, m_vehicleType, *graph);
   LOG(LINFO, (ROUTING_FILE_TAG, "section for", value->GetCountryFileName(), "loaded in", timer.ElapsedSeconds(), "seconds"));
 
+  if (m_timeDependentWeights)
+  {
+    SpeedProfiles speedProfiles;
+    if (ReadSpeedProfilesFromMwm(*value, speedProfiles))
+      graph->SetSpeedProfiles(std::move(speedProfiles));
+  }
+
   return graph;
 }
 
@@ -220,10 +248,11 @@ unique_ptr<IndexGraphLoader> IndexGraphLoader::Create(
     VehicleType vehicleType, bool loadAltitudes,
     shared_ptr<VehicleModelFactoryInterface> vehicleModelFactory,
     shared_ptr<EdgeEstimator> estimator, MwmDataSource & dataSource,
-    RoutingOptions routingOptions)
+    RoutingOptions routingOptions, bool timeDependentWeights)
 {
   return make_unique<IndexGraphLoaderImpl>(vehicleType, loadAltitudes, vehicleModelFactory,
-                                           estimator, dataSource, routingOptions);
+                                           estimator, dataSource, routingOptions,
+                                           timeDependentWeights);
 }
 
 void DeserializeIndexGraph(MwmValue const & mwmValue, VehicleType vehicleType, IndexGraph & graph)
@@ -33,7 +33,7 @@ public:
       VehicleType vehicleType, bool loadAltitudes,
       std::shared_ptr<VehicleModelFactoryInterface> vehicleModelFactory,
       std::shared_ptr<EdgeEstimator> estimator, MwmDataSource & dataSource,
-      RoutingOptions routingOptions = RoutingOptions());
+      RoutingOptions routingOptions = RoutingOptions(), bool timeDependentWeights = false);
 };
 
 void DeserializeIndexGraph(MwmValue const & mwmValue, VehicleType vehicleType, IndexGraph & graph);
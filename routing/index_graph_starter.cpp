@@ -287,7 +287,8 @@ RouteWeight IndexGraphStarter::CalcSegmentWeight(Segment const & segment,
   return m_graph.CalcOffroadWeight(vertex.GetPointFrom(), vertex.GetPointTo(), purpose);
 }
 
-double IndexGraphStarter::CalculateETA(Segment const & from, Segment const & to) const
+double IndexGraphStarter::CalculateETA(Segment const & from, Segment const & to,
+                                       double timeToFrom) const
 {
   // We don't distinguish fake segment weight and fake segment transit time.
   if (IsFakeSegment(to))
@@ -318,7 +319,7 @@ double IndexGraphStarter::CalculateETA(Segment const & from, Segment const & to)
            m_regionsGraph->CalcSegmentWeight(to).GetWeight();
   }
 
-  return m_graph.CalculateETA(from, to);
+  return m_graph.CalculateETA(from, to, timeToFrom);
 }
 
 double IndexGraphStarter::CalculateETAWithoutPenalty(Segment const & segment) const
@@ -159,7 +159,7 @@ public:
   RouteWeight CalcSegmentWeight(Segment const & segment, EdgeEstimator::Purpose purpose) const;
   RouteWeight CalcGuidesSegmentWeight(Segment const & segment,
                                       EdgeEstimator::Purpose purpose) const;
-  double CalculateETA(Segment const & from, Segment const & to) const;
+  double CalculateETA(Segment const & from, Segment const & to, double timeToFrom) const;
   double CalculateETAWithoutPenalty(Segment const & segment) const;
 
   /// @name For compatibility with IndexGraphStarterJoints.
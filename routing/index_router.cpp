@@ -14,6 +14,7 @@
 #include "routing/leaps_postprocessor.hpp"
 #include "routing/mwm_hierarchy_handler.hpp"
 #include "routing/pedestrian_directions.hpp"
+#include "routing/road_access.hpp"
 #include "routing/route.hpp"
 #include "routing/routing_helpers.hpp"
 #include "routing/routing_options.hpp"
@@ -51,6 +52,7 @@
 #include <deque>
 #include <iterator>
 #include <map>
+#include <unordered_set>
 
 namespace routing
 {
@@ -191,6 +193,66 @@ bool IsDeadEndCached(Segment const & segment, bool isOutgoing, bool useRoutingOp
 
   return false;
 }
+
+// Returns segments of |candidates| (sorted by weight) which may be shown as alternatives
+// to |best|. An alternative shares no more than |params.m_maxSharing| of its length with |best|
+// and with the alternatives chosen before it.
+vector<vector<Segment>> SelectAlternatives(IndexGraphStarter const & starter,
+                                           vector<Segment> const & best,
+                                           vector<vector<Segment>> && candidates,
+                                           IndexRouter::AlternativesParams const & params)
+{
+  auto const getLengthM = [&starter](Segment const & segment) {
+    return ms::DistanceOnEarth(starter.GetPoint(segment, false /* front */),
+                               starter.GetPoint(segment, true /* front */));
+  };
+
+  vector<unordered_set<Segment>> chosen;
+  chosen.emplace_back(best.cbegin(), best.cend());
+
+  vector<vector<Segment>> alternatives;
+  for (auto & candidate : candidates)
+  {
+    if (alternatives.size() >= params.m_maxCount)
+      break;
+
+    if (candidate.size() < 3 || !IndexGraphStarter::IsFakeSegment(candidate.front()) ||
+        !IndexGraphStarter::IsFakeSegment(candidate.back()))
+    {
+      continue;
+    }
+
+    unordered_set<Segment> segments(candidate.cbegin(), candidate.cend());
+    // Paths of forward and backward waves which meet far from the best route may have loops.
+    if (segments.size() != candidate.size())
+      continue;
+
+    double lengthM = 0.0;
+    vector<double> sharedLengthsM(chosen.size(), 0.0);
+    for (auto const & segment : candidate)
+    {
+      auto const segmentLengthM = getLengthM(segment);
+      lengthM += segmentLengthM;
+      for (size_t i = 0; i < chosen.size(); ++i)
+      {
+        if (chosen[i].count(segment) != 0)
+          sharedLengthsM[i] += segmentLengthM;
+      }
+    }
+
+    bool const isDifferent =
+        all_of(sharedLengthsM.cbegin(), sharedLengthsM.cend(), [&](double sharedLengthM) {
+          return sharedLengthM <= params.m_maxSharing * lengthM;
+        });
+    if (!isDifferent)
+      continue;
+
+    chosen.push_back(std::move(segments));
+    alternatives.push_back(std::move(candidate));
+  }
+
+  return alternatives;
+}
 }  // namespace
 
 
@@ -328,6 +390,24 @@ bool IndexRouter::FindClosestProjectionToRoad(m2::PointD const & point,
 
 void IndexRouter::SetGuides(GuidesTracks && guides) { m_guides = GuidesConnections(guides); }
 
+void IndexRouter::SetLiveSpeedsSource(std::shared_ptr<LiveSpeedsSource> liveSpeedsSource)
+{
+  m_liveSpeedsSource = std::move(liveSpeedsSource);
+}
+
+IndexRouter::CalculationGuard::CalculationGuard(IndexRouter & router) : m_router(router)
+{
+  // Updates of speeds published during the calculation are used by the next one.
+  if (m_router.m_liveSpeedsSource && m_router.m_vehicleType == VehicleType::Car)
+    m_router.m_estimator->SetLiveSpeeds(m_router.m_liveSpeedsSource->GetSnapshot());
+}
+
+IndexRouter::CalculationGuard::~CalculationGuard()
+{
+  m_router.ClearState();
+  m_router.m_estimator->SetLiveSpeeds(nullptr);
+}
+
 RouterResultCode IndexRouter::CalculateRoute(Checkpoints const & checkpoints,
                                              m2::PointD const & startDirection,
                                              bool adjustToPrevRoute,
@@ -338,10 +418,7 @@ RouterResultCode IndexRouter::CalculateRoute(Checkpoints const & checkpoints,
 
   try
   {
-    SCOPE_GUARD(featureRoadGraphClear, [this]
-    {
-      ClearState();
-    });
+    CalculationGuard const calculationGuard(*this);
 
     if (adjustToPrevRoute && m_lastRoute && m_lastFakeEdges &&
         finalPoint == m_lastRoute->GetFinish())
@@ -369,6 +446,80 @@ RouterResultCode IndexRouter::CalculateRoute(Checkpoints const & checkpoints,
   }
 }
 
+RouterResultCode IndexRouter::CalculateRouteWithAlternatives(Checkpoints const & checkpoints,
+                                                             m2::PointD const & startDirection,
+                                                             AlternativesParams const & params,
+                                                             RouterDelegate const & delegate,
+                                                             Route & route,
+                                                             vector<Route> & alternatives)
+{
+  alternatives.clear();
+
+  auto const & startPoint = checkpoints.GetStart();
+  auto const & finalPoint = checkpoints.GetFinish();
+
+  try
+  {
+    CalculationGuard const calculationGuard(*this);
+
+    Alternatives routeAlternatives(params);
+    auto const code = DoCalculateRoute(checkpoints, startDirection, delegate, route,
+                                       &routeAlternatives);
+    if (code == RouterResultCode::NoError)
+      alternatives = std::move(routeAlternatives.m_routes);
+    return code;
+  }
+  catch (RootException const & e)
+  {
+    LOG(LERROR, ("Can't find path from", mercator::ToLatLon(startPoint), "to",
+                 mercator::ToLatLon(finalPoint), ":\n ", e.what()));
+    return RouterResultCode::InternalError;
+  }
+}
+
+RouterResultCode IndexRouter::CalculateIsochrone(m2::PointD const & start, double maxTimeS,
+                                                 bool buildOutline, RouterDelegate const & delegate,
+                                                 Isochrone & isochrone)
+{
+  isochrone.Clear();
+
+  try
+  {
+    CalculationGuard const calculationGuard(*this);
+
+    base::Timer timer;
+    TrafficStash::Guard guard(m_trafficStash);
+    auto graph = MakeWorldGraph();
+    graph->SetMode(WorldGraphMode::NoLeaps);
+
+    vector<Segment> startSegments;
+    bool bestSegmentIsAlmostCodirectional = false;
+    PointsOnEdgesSnapping snapping(*this, *graph);
+    if (!snapping.FindBestSegments(start, m2::PointD::Zero() /* direction */, true /* isOutgoing */,
+                                   startSegments, bestSegmentIsAlmostCodirectional))
+    {
+      return RouterResultCode::StartPointNotFound;
+    }
+
+    FakeEnding dummy{};
+    IndexGraphStarter starter(MakeFakeEnding(startSegments, start, *graph), dummy,
+                              0 /* fakeNumerationStart */, bestSegmentIsAlmostCodirectional,
+                              *graph);
+
+    auto const code = routing::CalculateIsochrone(starter, maxTimeS, buildOutline,
+                                                  delegate.GetCancellable(), isochrone);
+
+    LOG(LINFO, ("Isochrone of", maxTimeS, "seconds from", mercator::ToLatLon(start), "code:", code,
+                "segments:", isochrone.m_segments.size(), "elapsed:", timer.ElapsedSeconds()));
+    return code;
+  }
+  catch (RootException const & e)
+  {
+    LOG(LERROR, ("Can't calculate isochrone from", mercator::ToLatLon(start), ":\n ", e.what()));
+    return RouterResultCode::InternalError;
+  }
+}
+
 std::vector<Segment> IndexRouter::GetBestOutgoingSegments(m2::PointD const & checkpoint, WorldGraph & graph)
 {
   bool dummy = false;
@@ -512,7 +663,8 @@ void IndexRouter::AddGuidesOsmConnectionsToGraphStarter(size_t checkpointIdxFrom
 
 RouterResultCode IndexRouter::DoCalculateRoute(Checkpoints const & checkpoints,
                                                m2::PointD const & startDirection,
-                                               RouterDelegate const & delegate, Route & route)
+                                               RouterDelegate const & delegate, Route & route,
+                                               Alternatives * alternatives /* = nullptr */)
 {
   m_lastRoute.reset();
   // MwmId used for guides segments in RedressRoute().
@@ -568,6 +720,10 @@ RouterResultCode IndexRouter::DoCalculateRoute(Checkpoints const & checkpoints,
 
   PointsOnEdgesSnapping snapping(*this, *graph);
   size_t const subroutesCount = checkpoints.GetNumSubroutes();
+  // Alternatives of routes with intermediate points aren't looked for. Time-dependent weights
+  // are used with unidirectional search which doesn't provide alternatives.
+  if (subroutesCount != 1 || UseTimeDependentWeights())
+    alternatives = nullptr;
   for (size_t i = checkpoints.GetPassedIdx(); i < subroutesCount; ++i)
   {
     auto const & startCheckpoint = checkpoints.GetPoint(i);
@@ -618,7 +774,7 @@ RouterResultCode IndexRouter::DoCalculateRoute(Checkpoints const & checkpoints,
     SCOPE_GUARD(eraseProgress, [&progress]() { progress->PushAndDropLastSubProgress(); });
 
     auto const result = CalculateSubroute(checkpoints, i, delegate, progress, subrouteStarter,
-                                          subroute, m_guides.IsAttached());
+                                          subroute, m_guides.IsAttached(), alternatives);
 
     if (result != RouterResultCode::NoError)
       return result;
@@ -660,6 +816,27 @@ RouterResultCode IndexRouter::DoCalculateRoute(Checkpoints const & checkpoints,
   LOG(LINFO, ("Route length:", route.GetTotalDistanceMeters(), "meters. ETA:",
       route.GetTotalTimeSec(), "seconds."));
 
+  if (alternatives)
+  {
+    auto const & subroute = route.GetSubrouteAttrs(0 /* subrouteIdx */);
+    for (auto const & path : alternatives->m_paths)
+    {
+      Route alternative(route.GetRouterId(), 0 /* routeId */);
+      alternative.SetSubroteAttrs(vector<Route::SubrouteAttrs>(
+          {Route::SubrouteAttrs(subroute.GetStart(), subroute.GetFinish(), 0 /* beginSegmentIdx */,
+                                path.size())}));
+      if (RedressRoute(path, delegate.GetCancellable(), *starter, alternative) !=
+          RouterResultCode::NoError)
+      {
+        continue;
+      }
+
+      LOG(LINFO, ("Alternative route length:", alternative.GetTotalDistanceMeters(),
+                  "meters. ETA:", alternative.GetTotalTimeSec(), "seconds."));
+      alternatives->m_routes.push_back(std::move(alternative));
+    }
+  }
+
   m_lastRoute = make_unique<SegmentedRoute>(checkpoints.GetStart(), checkpoints.GetFinish(),
                                             route.GetSubroutes());
   for (Segment const & segment : segments)
@@ -702,7 +879,8 @@ RouterResultCode IndexRouter::CalculateSubroute(Checkpoints const & checkpoints,
                                                 shared_ptr<AStarProgress> const & progress,
                                                 IndexGraphStarter & starter,
                                                 vector<Segment> & subroute,
-                                                bool guidesActive /* = false */)
+                                                bool guidesActive /* = false */,
+                                                Alternatives * alternatives /* = nullptr */)
 {
   subroute.clear();
 
@@ -715,9 +893,9 @@ RouterResultCode IndexRouter::CalculateSubroute(Checkpoints const & checkpoints,
   switch (mode)
   {
   case WorldGraphMode::Joints:
-    return CalculateSubrouteJointsMode(starter, delegate, progress, subroute);
+    return CalculateSubrouteJointsMode(starter, delegate, progress, subroute, alternatives);
   case WorldGraphMode::NoLeaps:
-    return CalculateSubrouteNoLeapsMode(starter, delegate, progress, subroute);
+    return CalculateSubrouteNoLeapsMode(starter, delegate, progress, subroute, alternatives);
   case WorldGraphMode::LeapsOnly:
     return CalculateSubrouteLeapsOnlyMode(checkpoints, subrouteIdx, starter, delegate, progress,
                                           subroute);
@@ -728,7 +906,8 @@ RouterResultCode IndexRouter::CalculateSubroute(Checkpoints const & checkpoints,
 
 RouterResultCode IndexRouter::CalculateSubrouteJointsMode(
     IndexGraphStarter & starter, RouterDelegate const & delegate,
-    shared_ptr<AStarProgress> const & progress, vector<Segment> & subroute)
+    shared_ptr<AStarProgress> const & progress, vector<Segment> & subroute,
+    Alternatives * alternatives)
 {
   using JointsStarter = IndexGraphStarterJoints<IndexGraphStarter>;
   JointsStarter jointStarter(starter, starter.GetStartSegment(), starter.GetFinishSegment());
@@ -745,6 +924,27 @@ RouterResultCode IndexRouter::CalculateSubrouteJointsMode(
       delegate.GetCancellable(), std::move(visitor),
       AStarLengthChecker(starter));
 
+  if (alternatives)
+  {
+    vector<RoutingResult<Vertex, Weight>> routingResults;
+    RouterResultCode const result = FindPathWithAlternatives<Vertex, Edge, Weight>(
+        params, {} /* mwmIds */, alternatives->m_params, routingResults);
+
+    if (result != RouterResultCode::NoError)
+      return result;
+
+    LOG(LDEBUG, ("Result route weight:", routingResults.front().m_distance,
+                 "alternative candidates:", routingResults.size() - 1));
+    subroute = ProcessJoints(routingResults.front().m_path, jointStarter);
+
+    vector<vector<Segment>> candidates;
+    for (size_t i = 1; i < routingResults.size(); ++i)
+      candidates.push_back(ProcessJoints(routingResults[i].m_path, jointStarter));
+    alternatives->m_paths =
+        SelectAlternatives(starter, subroute, std::move(candidates), alternatives->m_params);
+    return result;
+  }
+
   RoutingResult<Vertex, Weight> routingResult;
   RouterResultCode const result = FindPath<Vertex, Edge, Weight>(params, {} /* mwmIds */, routingResult);
 
@@ -758,7 +958,8 @@ RouterResultCode IndexRouter::CalculateSubrouteJointsMode(
 
 RouterResultCode IndexRouter::CalculateSubrouteNoLeapsMode(
     IndexGraphStarter & starter, RouterDelegate const & delegate,
-    shared_ptr<AStarProgress> const & progress, vector<Segment> & subroute)
+    shared_ptr<AStarProgress> const & progress, vector<Segment> & subroute,
+    Alternatives * alternatives)
 {
   using Vertex = IndexGraphStarter::Vertex;
   using Edge = IndexGraphStarter::Edge;
@@ -771,8 +972,29 @@ RouterResultCode IndexRouter::CalculateSubrouteNoLeapsMode(
       starter, starter.GetStartSegment(), starter.GetFinishSegment(),
       delegate.GetCancellable(), std::move(visitor), AStarLengthChecker(starter));
 
-  RoutingResult<Vertex, Weight> routingResult;
   set<NumMwmId> const mwmIds = starter.GetMwms();
+  if (alternatives)
+  {
+    vector<RoutingResult<Vertex, Weight>> routingResults;
+    RouterResultCode const result = FindPathWithAlternatives<Vertex, Edge, Weight>(
+        params, mwmIds, alternatives->m_params, routingResults);
+
+    if (result != RouterResultCode::NoError)
+      return result;
+
+    LOG(LDEBUG, ("Result route weight:", routingResults.front().m_distance,
+                 "alternative candidates:", routingResults.size() - 1));
+    subroute = std::move(routingResults.front().m_path);
+
+    vector<vector<Segment>> candidates;
+    for (size_t i = 1; i < routingResults.size(); ++i)
+      candidates.push_back(std::move(routingResults[i].m_path));
+    alternatives->m_paths =
+        SelectAlternatives(starter, subroute, std::move(candidates), alternatives->m_params);
+    return result;
+  }
+
+  RoutingResult<Vertex, Weight> routingResult;
   RouterResultCode const result = FindPath<Vertex, Edge, Weight>(params, mwmIds, routingResult);
 
   if (result != RouterResultCode::NoError)
@@ -1103,7 +1325,8 @@ unique_ptr<WorldGraph> IndexRouter::MakeWorldGraph()
 
   auto indexGraphLoader = IndexGraphLoader::Create(
       m_vehicleType == VehicleType::Transit ? VehicleType::Pedestrian : m_vehicleType,
-      m_loadAltitudes, m_vehicleModelFactory, m_estimator, m_dataSource, routingOptions);
+      m_loadAltitudes, m_vehicleModelFactory, m_estimator, m_dataSource, routingOptions,
+      UseTimeDependentWeights());
 
   if (m_vehicleType != VehicleType::Transit)
   {
@@ -1114,7 +1337,9 @@ unique_ptr<WorldGraph> IndexRouter::MakeWorldGraph()
     return graph;
   }
 
-  auto transitGraphLoader = TransitGraphLoader::Create(m_dataSource, m_estimator);
+  // Waiting for public transport is estimated with the timetables at the start of the calculation.
+  auto transitGraphLoader =
+      TransitGraphLoader::Create(m_dataSource, m_estimator, GetCurrentTimestamp());
   return make_unique<TransitWorldGraph>(std::move(crossMwmGraph), std::move(indexGraphLoader),
                                         std::move(transitGraphLoader), m_estimator);
 }
@@ -1672,7 +1897,7 @@ RouterResultCode IndexRouter::RedressRoute(vector<Segment> const & segments,
 
   for (size_t i = 1; i < segments.size(); ++i)
   {
-    time += starter.CalculateETA(segments[i - 1], segments[i]);
+    time += starter.CalculateETA(segments[i - 1], segments[i], time);
     times.emplace_back(time);
   }
 
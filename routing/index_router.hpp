@@ -10,8 +10,11 @@
 #include "routing/fake_edges_container.hpp"
 #include "routing/features_road_graph.hpp"
 #include "routing/guides_connections.hpp"
+#include "routing/isochrone.hpp"
+#include "routing/live_speeds.hpp"
 #include "routing/nearest_edge_finder.hpp"
 #include "routing/regions_decl.hpp"
+#include "routing/route.hpp"
 #include "routing/router.hpp"
 #include "routing/routing_callbacks.hpp"
 #include "routing/segment.hpp"
@@ -25,6 +28,9 @@
 #include "geometry/point2d.hpp"
 #include "geometry/tree4d.hpp"
 
+#include "base/macros.hpp"
+
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <set>
@@ -65,6 +71,19 @@ public:
     m2::PointD const m_direction;
   };
 
+  struct AlternativesParams
+  {
+    // Max number of alternatives besides the best route.
+    size_t m_maxCount = 2;
+    // Max ratio by which weight of an alternative may exceed weight of the best route.
+    double m_maxStretch = 0.3;
+    // Max part of an alternative's length which may be shared with any of the routes chosen
+    // before it.
+    double m_maxSharing = 0.6;
+    // Max number of candidate paths which are taken from the search.
+    size_t m_maxCandidates = 32;
+  };
+
   IndexRouter(VehicleType vehicleType, bool loadAltitudes,
               CountryParentNameGetterFn const & countryParentNameGetterFn,
               TCountryFileFn const & countryFileFn, CountryRectFn const & countryRectFn,
@@ -82,6 +101,18 @@ public:
                                   m2::PointD const & startDirection, bool adjustToPrevRoute,
                                   RouterDelegate const & delegate, Route & route) override;
 
+  /// \brief Calculates the best route like CalculateRoute() and fills |alternatives| with up to
+  /// |params.m_maxCount| routes which are meaningfully different from it. Candidates are paths
+  /// through via vertices reached by both waves of the bidirectional search, so the search spaces
+  /// of the main query are reused.
+  /// \note Alternatives are looked for routes without intermediate points in Joints and NoLeaps
+  /// modes only. |alternatives| is empty otherwise.
+  RouterResultCode CalculateRouteWithAlternatives(Checkpoints const & checkpoints,
+                                                  m2::PointD const & startDirection,
+                                                  AlternativesParams const & params,
+                                                  RouterDelegate const & delegate, Route & route,
+                                                  std::vector<Route> & alternatives);
+
   bool FindClosestProjectionToRoad(m2::PointD const & point, m2::PointD const & direction,
                                    double radius, EdgeProj & proj) override;
 
@@ -89,15 +120,56 @@ public:
 
   VehicleType GetVehicleType() const { return m_vehicleType; }
 
+  /// \brief Sets source of measured segment speeds for car routing. Every route calculation uses
+  /// the snapshot of speeds which was current at its start.
+  void SetLiveSpeedsSource(std::shared_ptr<LiveSpeedsSource> liveSpeedsSource);
+
+  /// \brief Enables time-dependent weights for car routing. Roads with speed profiles in
+  /// SPEED_PROFILES_FILE_TAG section are passed with the typical speed of the time of day they
+  /// are reached at.
+  void SetTimeDependentWeights(bool enabled) { m_timeDependentWeights = enabled; }
+
+  /// \brief Fills |isochrone| with roads which are reachable from |start| in |maxTimeS| seconds.
+  /// Unlike CalculateRoute() it's a single one-to-all wave which crosses mwm borders.
+  /// \param buildOutline if true |isochrone.m_outline| is filled with a polygon around the roads.
+  RouterResultCode CalculateIsochrone(m2::PointD const & start, double maxTimeS, bool buildOutline,
+                                      RouterDelegate const & delegate, Isochrone & isochrone);
+
 private:
+  // Sets the live speeds snapshot for the calculation. The router state and the speeds are
+  // cleared when the calculation is finished.
+  class CalculationGuard
+  {
+  public:
+    explicit CalculationGuard(IndexRouter & router);
+    ~CalculationGuard();
+
+  private:
+    DISALLOW_COPY_AND_MOVE(CalculationGuard);
+
+    IndexRouter & m_router;
+  };
+
+  struct Alternatives
+  {
+    explicit Alternatives(AlternativesParams const & params) : m_params(params) {}
+
+    AlternativesParams const m_params;
+    // Paths of the chosen alternatives of the subroute.
+    std::vector<std::vector<Segment>> m_paths;
+    std::vector<Route> m_routes;
+  };
+
   RouterResultCode CalculateSubrouteJointsMode(IndexGraphStarter & starter,
                                                RouterDelegate const & delegate,
                                                std::shared_ptr<AStarProgress> const & progress,
-                                               std::vector<Segment> & subroute);
+                                               std::vector<Segment> & subroute,
+                                               Alternatives * alternatives);
   RouterResultCode CalculateSubrouteNoLeapsMode(IndexGraphStarter & starter,
                                                 RouterDelegate const & delegate,
                                                 std::shared_ptr<AStarProgress> const & progress,
-                                                std::vector<Segment> & subroute);
+                                                std::vector<Segment> & subroute,
+                                                Alternatives * alternatives);
   RouterResultCode CalculateSubrouteLeapsOnlyMode(Checkpoints const & checkpoints,
                                                   size_t subrouteIdx, IndexGraphStarter & starter,
                                                   RouterDelegate const & delegate,
@@ -106,12 +178,14 @@ private:
 
   RouterResultCode DoCalculateRoute(Checkpoints const & checkpoints,
                                     m2::PointD const & startDirection,
-                                    RouterDelegate const & delegate, Route & route);
+                                    RouterDelegate const & delegate, Route & route,
+                                    Alternatives * alternatives = nullptr);
   RouterResultCode CalculateSubroute(Checkpoints const & checkpoints, size_t subrouteIdx,
                                      RouterDelegate const & delegate,
                                      std::shared_ptr<AStarProgress> const & progress,
                                      IndexGraphStarter & graph, std::vector<Segment> & subroute,
-                                     bool guidesActive = false);
+                                     bool guidesActive = false,
+                                     Alternatives * alternatives = nullptr);
 
   RouterResultCode AdjustRoute(Checkpoints const & checkpoints,
                                m2::PointD const & startDirection,
@@ -250,11 +324,34 @@ private:
                             RoutingResult<Vertex, Weight> & routingResult)
   {
     AStarAlgorithm<Vertex, Edge, Weight> algorithm;
-    return ConvertTransitResult(
-        mwmIds, ConvertResult<Vertex, Edge, Weight>(algorithm.FindPathBidirectional(params, routingResult)));
+    // Arrival times which time-dependent weights depend on are known for the forward wave only.
+    auto const result = UseTimeDependentWeights() ? algorithm.FindPath(params, routingResult)
+                                                  : algorithm.FindPathBidirectional(params, routingResult);
+    return ConvertTransitResult(mwmIds, ConvertResult<Vertex, Edge, Weight>(result));
+  }
+
+  // Fills |routingResults| with the best path followed by up to
+  // |alternativesParams.m_maxCandidates| via vertex paths which are longer than the best one
+  // by |alternativesParams.m_maxStretch| at most.
+  template <typename Vertex, typename Edge, typename Weight, typename AStarParams>
+  RouterResultCode FindPathWithAlternatives(AStarParams & params, std::set<NumMwmId> const & mwmIds,
+                                            AlternativesParams const & alternativesParams,
+                                            std::vector<RoutingResult<Vertex, Weight>> & routingResults)
+  {
+    using Algorithm = AStarAlgorithm<Vertex, Edge, Weight>;
+
+    // One more result for the best path.
+    auto const result = Algorithm().FindPathBidirectionalWithAlternatives(
+        params, alternativesParams.m_maxStretch, alternativesParams.m_maxCandidates + 1,
+        routingResults);
+    return ConvertTransitResult(mwmIds, ConvertResult<Vertex, Edge, Weight>(result));
   }
 
   void SetupAlgorithmMode(IndexGraphStarter & starter, bool guidesActive = false) const;
+  bool UseTimeDependentWeights() const
+  {
+    return m_timeDependentWeights && m_vehicleType == VehicleType::Car;
+  }
   uint32_t ConnectTracksOnGuidesToOsm(std::vector<m2::PointD> const & checkpoints,
                                       WorldGraph & graph);
 
@@ -289,6 +386,8 @@ private:
 
   // If a ckeckpoint is near to the guide track we need to build route through this track.
   GuidesConnections m_guides;
+  std::shared_ptr<LiveSpeedsSource> m_liveSpeedsSource;
+  bool m_timeDependentWeights = false;
 
   CountryParentNameGetterFn m_countryParentNameGetterFn;
 };
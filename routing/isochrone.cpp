@@ -0,0 +1,139 @@
+#include "routing/isochrone.hpp"
+
+#include "routing/base/astar_algorithm.hpp"
+
+#include "routing/index_graph_starter.hpp"
+
+#include "geometry/angles.hpp"
+#include "geometry/mercator.hpp"
+
+#include "base/assert.hpp"
+#include "base/math.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+
+namespace routing
+{
+using namespace std;
+
+namespace
+{
+// Periodicity of checking whether the calculation is cancelled.
+uint32_t constexpr kCancelCheckPeriod = 128;
+// 5 degrees per sector.
+size_t constexpr kOutlineSectorsCount = 72;
+}  // namespace
+
+RouterResultCode CalculateIsochrone(IndexGraphStarter & starter, double maxTimeS,
+                                    bool buildOutline, base::Cancellable const & cancellable,
+                                    Isochrone & isochrone)
+{
+  CHECK_GREATER(maxTimeS, 0.0, ());
+
+  using Algorithm = AStarAlgorithm<IndexGraphStarter::Vertex, IndexGraphStarter::Edge,
+                                   IndexGraphStarter::Weight>;
+
+  isochrone.Clear();
+
+  Algorithm algorithm;
+  Algorithm::Context context(starter);
+
+  vector<m2::PointD> reachedPoints;
+  uint32_t visitCounter = 0;
+  bool cancelled = false;
+
+  auto const visitVertex = [&](Segment const & vertex) {
+    if (++visitCounter % kCancelCheckPeriod == 0 && cancellable.IsCancelled())
+    {
+      cancelled = true;
+      return false;
+    }
+
+    Segment real = vertex;
+    if (starter.ConvertToReal(real))
+      isochrone.m_segments.emplace_back(real, context.GetDistance(vertex).GetWeight());
+
+    if (buildOutline)
+      reachedPoints.push_back(mercator::FromLatLon(starter.GetPoint(vertex, true /* front */)));
+
+    return true;
+  };
+
+  auto const adjustEdgeWeight = [](Segment const & /* vertex */, SegmentEdge const & edge) {
+    return edge.GetWeight();
+  };
+  auto const filterStates = [maxTimeS](auto const & state) {
+    return state.distance.GetWeight() <= maxTimeS;
+  };
+  auto const reducedToRealLength = [](auto const & state) { return state.distance; };
+
+  algorithm.PropagateWave(starter, starter.GetStartSegment(), visitVertex, adjustEdgeWeight,
+                          filterStates, reducedToRealLength, context);
+
+  if (cancelled)
+  {
+    isochrone.Clear();
+    return RouterResultCode::Cancelled;
+  }
+
+  // Fake parts of real segments near the start are converted to the same real segments,
+  // only the earliest arrival is kept.
+  auto & segments = isochrone.m_segments;
+  sort(segments.begin(), segments.end(), [](auto const & lhs, auto const & rhs) {
+    if (lhs.m_segment != rhs.m_segment)
+      return lhs.m_segment < rhs.m_segment;
+    return lhs.m_arrivalTimeS < rhs.m_arrivalTimeS;
+  });
+  segments.erase(unique(segments.begin(), segments.end(),
+                        [](auto const & lhs, auto const & rhs) {
+                          return lhs.m_segment == rhs.m_segment;
+                        }),
+                 segments.end());
+
+  if (segments.empty())
+    return RouterResultCode::RouteNotFound;
+
+  if (buildOutline)
+  {
+    auto const center =
+        mercator::FromLatLon(starter.GetPoint(starter.GetStartSegment(), false /* front */));
+    isochrone.m_outline = MakeReachabilityOutline(center, reachedPoints, kOutlineSectorsCount);
+  }
+
+  return RouterResultCode::NoError;
+}
+
+vector<m2::PointD> MakeReachabilityOutline(m2::PointD const & center,
+                                           vector<m2::PointD> const & points, size_t sectorsCount)
+{
+  CHECK_GREATER(sectorsCount, 0, ());
+
+  double const sectorAngle = 2.0 * math::pi / static_cast<double>(sectorsCount);
+  vector<optional<m2::PointD>> farthest(sectorsCount);
+  for (auto const & point : points)
+  {
+    if (point == center)
+      continue;
+
+    auto const angle = ang::AngleIn2PI(ang::AngleTo(center, point));
+    auto const sector = min(static_cast<size_t>(angle / sectorAngle), sectorsCount - 1);
+    auto & sectorPoint = farthest[sector];
+    if (!sectorPoint || center.SquaredLength(point) > center.SquaredLength(*sectorPoint))
+      sectorPoint = point;
+  }
+
+  vector<m2::PointD> outline;
+  for (auto const & point : farthest)
+  {
+    if (point)
+      outline.push_back(*point);
+  }
+
+  if (outline.size() < 3)
+    outline.clear();
+
+  return outline;
+}
+}  // namespace routing
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "routing/routing_callbacks.hpp"
+#include "routing/segment.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "base/cancellable.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace routing
+{
+class IndexGraphStarter;
+
+struct Isochrone
+{
+  struct ReachedSegment
+  {
+    ReachedSegment(Segment const & segment, double arrivalTimeS)
+      : m_segment(segment), m_arrivalTimeS(arrivalTimeS)
+    {
+    }
+
+    Segment m_segment;
+    // Time in seconds to reach the end of |m_segment| from the start.
+    double m_arrivalTimeS = 0.0;
+  };
+
+  void Clear()
+  {
+    m_segments.clear();
+    m_outline.clear();
+  }
+
+  // Real segments sorted by Segment.
+  std::vector<ReachedSegment> m_segments;
+  // Mercator polygon around the reached area. It's empty if it was not requested.
+  std::vector<m2::PointD> m_outline;
+};
+
+/// \brief Propagates a one-to-all Dijkstra wave from the start of |starter| and fills |isochrone|
+/// with real segments which are reached in |maxTimeS| seconds. The wave is bounded by |maxTimeS|,
+/// so it doesn't visit anything beyond the reached area. Mwm borders are crossed if |starter|'s
+/// graph is in WorldGraphMode::NoLeaps mode.
+/// \note |starter| should be created with a dummy finish ending, the finish isn't used.
+RouterResultCode CalculateIsochrone(IndexGraphStarter & starter, double maxTimeS,
+                                    bool buildOutline, base::Cancellable const & cancellable,
+                                    Isochrone & isochrone);
+
+/// \returns a star-shaped polygon around |center| which consists of the farthest of |points| in
+/// each of |sectorsCount| equal angular sectors. Empty sectors are skipped. If there are less than
+/// three nonempty sectors returns an empty vector.
+std::vector<m2::PointD> MakeReachabilityOutline(m2::PointD const & center,
+                                                std::vector<m2::PointD> const & points,
+                                                size_t sectorsCount);
+}  // namespace routing
@@ -0,0 +1,205 @@
+#include "routing/live_speeds.hpp"
+
+#include "platform/country_file.hpp"
+#include "platform/platform.hpp"
+
+#include "base/assert.hpp"
+#include "base/file_name_utils.hpp"
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <utility>
+
+namespace routing
+{
+namespace
+{
+std::string const kSpeedsFileExt = ".speeds";
+
+// Returns false if the file can't be read. Malformed lines are skipped.
+bool LoadMwmSpeeds(std::string const & path, LiveSpeeds::MwmSpeeds & speeds)
+{
+  std::ifstream input(path);
+  if (!input)
+    return false;
+
+  std::vector<std::pair<uint64_t, uint8_t>> items;
+  size_t malformedCount = 0;
+  std::string line;
+  while (std::getline(input, line))
+  {
+    if (line.empty() || line.front() == '#')
+      continue;
+
+    std::istringstream fields(line);
+    uint32_t featureId = 0;
+    uint32_t segmentIdx = 0;
+    uint32_t isForward = 0;
+    double speedKMpH = 0.0;
+    if (!(fields >> featureId >> segmentIdx >> isForward >> speedKMpH) || isForward > 1 ||
+        speedKMpH <= 0.0)
+    {
+      ++malformedCount;
+      continue;
+    }
+
+    auto const speed = static_cast<uint8_t>(std::clamp(std::lround(speedKMpH), 1L, 255L));
+    items.emplace_back(LiveSpeeds::MakeKey(featureId, segmentIdx, isForward == 1), speed);
+  }
+
+  if (malformedCount != 0)
+    LOG(LWARNING, ("Malformed lines skipped:", malformedCount, "in", path));
+
+  // The last speed of a segment wins.
+  std::stable_sort(items.begin(), items.end(),
+                   [](auto const & lhs, auto const & rhs) { return lhs.first < rhs.first; });
+
+  speeds.m_keys.clear();
+  speeds.m_speedsKMpH.clear();
+  for (size_t i = 0; i < items.size(); ++i)
+  {
+    if (i + 1 < items.size() && items[i].first == items[i + 1].first)
+      continue;
+    speeds.m_keys.push_back(items[i].first);
+    speeds.m_speedsKMpH.push_back(items[i].second);
+  }
+  speeds.m_keys.shrink_to_fit();
+  speeds.m_speedsKMpH.shrink_to_fit();
+  return true;
+}
+}  // namespace
+
+// LiveSpeeds --------------------------------------------------------------------------------------
+size_t LiveSpeeds::MwmSpeeds::GetMemoryBytes() const
+{
+  return m_keys.capacity() * sizeof(uint64_t) + m_speedsKMpH.capacity() * sizeof(uint8_t);
+}
+
+// static
+uint64_t LiveSpeeds::MakeKey(uint32_t featureId, uint32_t segmentIdx, bool isForward)
+{
+  ASSERT_LESS(segmentIdx, 1U << 31, ());
+  return (static_cast<uint64_t>(featureId) << 32) | (static_cast<uint64_t>(segmentIdx) << 1) |
+         (isForward ? 1 : 0);
+}
+
+void LiveSpeeds::SetMwmSpeeds(NumMwmId mwmId, MwmSpeeds && speeds)
+{
+  CHECK_EQUAL(speeds.m_keys.size(), speeds.m_speedsKMpH.size(), ());
+  ASSERT(std::is_sorted(speeds.m_keys.cbegin(), speeds.m_keys.cend()), ());
+  m_mwmToSpeeds[mwmId] = std::move(speeds);
+}
+
+std::optional<double> LiveSpeeds::GetSpeedKMpH(Segment const & segment) const
+{
+  auto const itMwm = m_mwmToSpeeds.find(segment.GetMwmId());
+  if (itMwm == m_mwmToSpeeds.cend())
+    return {};
+
+  auto const & speeds = itMwm->second;
+  auto const key = MakeKey(segment.GetFeatureId(), segment.GetSegmentIdx(), segment.IsForward());
+  auto const it = std::lower_bound(speeds.m_keys.cbegin(), speeds.m_keys.cend(), key);
+  if (it == speeds.m_keys.cend() || *it != key)
+    return {};
+
+  return speeds.m_speedsKMpH[std::distance(speeds.m_keys.cbegin(), it)];
+}
+
+size_t LiveSpeeds::GetSegmentsCount() const
+{
+  return std::accumulate(m_mwmToSpeeds.cbegin(), m_mwmToSpeeds.cend(), size_t(0),
+                         [](size_t sum, auto const & item) { return sum + item.second.m_keys.size(); });
+}
+
+size_t LiveSpeeds::GetMemoryBytes() const
+{
+  return std::accumulate(m_mwmToSpeeds.cbegin(), m_mwmToSpeeds.cend(), size_t(0),
+                         [](size_t sum, auto const & item) { return sum + item.second.GetMemoryBytes(); });
+}
+
+// LiveSpeedsSource --------------------------------------------------------------------------------
+LiveSpeedsSource::LiveSpeedsSource(std::shared_ptr<NumMwmIds> numMwmIds)
+  : m_numMwmIds(std::move(numMwmIds))
+{
+  CHECK(m_numMwmIds, ());
+}
+
+LiveSpeedsSource::~LiveSpeedsSource()
+{
+  StopUpdating();
+}
+
+LiveSpeedsSource::UpdateStats LiveSpeedsSource::UpdateFromDirectory(std::string const & dir)
+{
+  std::lock_guard<std::mutex> guard(m_updateMutex);
+
+  base::Timer timer;
+  Platform::FilesList files;
+  Platform::GetFilesByExt(dir, kSpeedsFileExt, files);
+
+  auto speeds = std::make_shared<LiveSpeeds>();
+  UpdateStats stats;
+  for (auto const & file : files)
+  {
+    auto countryName = file;
+    base::GetNameWithoutExt(countryName);
+    platform::CountryFile const countryFile(countryName);
+    if (!m_numMwmIds->ContainsFile(countryFile))
+    {
+      LOG(LWARNING, ("Speeds for unknown mwm:", file));
+      continue;
+    }
+
+    LiveSpeeds::MwmSpeeds mwmSpeeds;
+    if (!LoadMwmSpeeds(base::JoinPath(dir, file), mwmSpeeds))
+    {
+      LOG(LWARNING, ("Can't read speeds file:", file));
+      continue;
+    }
+
+    speeds->SetMwmSpeeds(m_numMwmIds->GetId(countryFile), std::move(mwmSpeeds));
+    ++stats.m_mwmsCount;
+  }
+
+  stats.m_segmentsCount = speeds->GetSegmentsCount();
+  stats.m_memoryBytes = speeds->GetMemoryBytes();
+  stats.m_loadSeconds = timer.ElapsedSeconds();
+
+  timer.Reset();
+  m_snapshot.Set(std::move(speeds));
+  stats.m_publishSeconds = timer.ElapsedSeconds();
+
+  LOG(LINFO, ("Live speeds updated from", dir, "mwms:", stats.m_mwmsCount,
+              "segments:", stats.m_segmentsCount, "memory:", stats.m_memoryBytes,
+              "bytes, load:", stats.m_loadSeconds, "s, publish:", stats.m_publishSeconds, "s"));
+  return stats;
+}
+
+void LiveSpeedsSource::StartUpdating(std::string const & dir,
+                                     std::chrono::steady_clock::duration period)
+{
+  CHECK(!m_updater, ("Live speeds are already being updated."));
+  m_updater = std::make_unique<base::thread_pool::delayed::ThreadPool>();
+  m_updater->Push([this, dir, period] { UpdateAndSchedule(dir, period); });
+}
+
+void LiveSpeedsSource::StopUpdating()
+{
+  if (!m_updater)
+    return;
+
+  m_updater->ShutdownAndJoin();
+  m_updater.reset();
+}
+
+void LiveSpeedsSource::UpdateAndSchedule(std::string const & dir,
+                                         std::chrono::steady_clock::duration period)
+{
+  UpdateFromDirectory(dir);
+  m_updater->PushDelayed(period, [this, dir, period] { UpdateAndSchedule(dir, period); });
+}
+}  // namespace routing
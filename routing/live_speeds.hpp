@@ -0,0 +1,89 @@
+#pragma once
+
+#include "routing/segment.hpp"
+
+#include "routing_common/num_mwm_id.hpp"
+
+#include "base/atomic_shared_ptr.hpp"
+#include "base/thread_pool_delayed.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace routing
+{
+/// \brief Immutable snapshot of measured speeds of road segments.
+class LiveSpeeds final
+{
+public:
+  // Speeds of segments of a single mwm. Keys are made by MakeKey() and sorted.
+  struct MwmSpeeds
+  {
+    size_t GetMemoryBytes() const;
+
+    std::vector<uint64_t> m_keys;
+    std::vector<uint8_t> m_speedsKMpH;
+  };
+
+  static uint64_t MakeKey(uint32_t featureId, uint32_t segmentIdx, bool isForward);
+
+  void SetMwmSpeeds(NumMwmId mwmId, MwmSpeeds && speeds);
+  bool Has(NumMwmId mwmId) const { return m_mwmToSpeeds.count(mwmId) != 0; }
+
+  /// \returns std::nullopt if there is no measured speed for |segment|.
+  std::optional<double> GetSpeedKMpH(Segment const & segment) const;
+
+  size_t GetSegmentsCount() const;
+  size_t GetMemoryBytes() const;
+
+private:
+  std::unordered_map<NumMwmId, MwmSpeeds> m_mwmToSpeeds;
+};
+
+/// \brief Loads per segment speed files and publishes them as LiveSpeeds snapshots.
+/// Readers take the current snapshot with GetSnapshot() and keep using it while a new one is
+/// published, so routes which are being built now are neither blocked nor changed by updates.
+/// Speed file of an mwm is |dir|/<country file name>.speeds, every line of it is
+/// "<feature id> <segment index> <1 for forward, 0 for backward> <speed in km/h>".
+/// \note This class IS thread-safe.
+class LiveSpeedsSource final
+{
+public:
+  struct UpdateStats
+  {
+    size_t m_mwmsCount = 0;
+    size_t m_segmentsCount = 0;
+    size_t m_memoryBytes = 0;
+    double m_loadSeconds = 0.0;
+    double m_publishSeconds = 0.0;
+  };
+
+  explicit LiveSpeedsSource(std::shared_ptr<NumMwmIds> numMwmIds);
+  ~LiveSpeedsSource();
+
+  std::shared_ptr<LiveSpeeds const> GetSnapshot() const { return m_snapshot.Get(); }
+
+  /// \brief Loads all speed files from |dir| and replaces the current snapshot.
+  UpdateStats UpdateFromDirectory(std::string const & dir);
+
+  /// \brief Updates speeds from |dir| now and then every |period| on a background thread.
+  void StartUpdating(std::string const & dir, std::chrono::steady_clock::duration period);
+  void StopUpdating();
+
+private:
+  void UpdateAndSchedule(std::string const & dir, std::chrono::steady_clock::duration period);
+
+  std::shared_ptr<NumMwmIds> m_numMwmIds;
+  base::AtomicSharedPtr<LiveSpeeds> m_snapshot;
+  // Serializes updates, snapshot readers are never blocked by it.
+  std::mutex m_updateMutex;
+  std::unique_ptr<base::thread_pool::delayed::ThreadPool> m_updater;
+};
+}  // namespace routing
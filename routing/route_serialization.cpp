@@ -0,0 +1,647 @@
+#include "routing/route_serialization.hpp"
+
+#include "coding/byte_stream.hpp"
+#include "coding/endianness.hpp"
+#include "coding/point_coding.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
+
+#include "geometry/mercator.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+#include "base/math.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace routing
+{
+using namespace std;
+
+namespace
+{
+uint8_t constexpr kHasAltitudes = 1 << 0;
+
+// Flags of a segment record.
+uint8_t constexpr kForward = 1 << 0;
+uint8_t constexpr kHasTurn = 1 << 1;
+uint8_t constexpr kHasTurnIndex = 1 << 2;
+// Names differ from the ones of the previous segment.
+uint8_t constexpr kNamesChanged = 1 << 3;
+uint8_t constexpr kIsLink = 1 << 4;
+uint8_t constexpr kHasSpeedLimit = 1 << 5;
+uint8_t constexpr kHasSpeedCameras = 1 << 6;
+// Mwm id, traffic and road types are the same as the ones of the previous segment.
+uint8_t constexpr kSameAsPrevious = 1 << 7;
+
+size_t constexpr kNamesCount = 5;
+
+// Version, flags, 9 uint32 fields and 2 doubles written as uint64.
+uint32_t constexpr kHeaderSize = 2 * sizeof(uint8_t) + 9 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+// Position of the speed camera on the segment is quantized to uint16.
+double constexpr kCameraCoefFactor = numeric_limits<uint16_t>::max();
+double constexpr kMsInSec = 1000.0;
+
+// Strings are not copied, the table keeps views of the strings of the route being serialized.
+class StringsTable
+{
+public:
+  // Id of the empty string is 0.
+  StringsTable() { Add({}); }
+
+  uint32_t Add(string_view s)
+  {
+    auto const it = m_ids.emplace(s, base::asserted_cast<uint32_t>(m_strings.size()));
+    if (it.second)
+      m_strings.push_back(s);
+    return it.first->second;
+  }
+
+  template <typename Sink>
+  void Serialize(Sink & sink) const
+  {
+    uint32_t offset = 0;
+    for (auto const s : m_strings)
+    {
+      WriteToSink(sink, offset);
+      offset += base::asserted_cast<uint32_t>(s.size());
+    }
+    WriteToSink(sink, offset);
+
+    for (auto const s : m_strings)
+      sink.Write(s.data(), s.size());
+  }
+
+  uint32_t GetCount() const { return base::asserted_cast<uint32_t>(m_strings.size()); }
+
+private:
+  unordered_map<string_view, uint32_t> m_ids;
+  // Strings in order of their ids.
+  vector<string_view> m_strings;
+};
+
+bool HasTurn(turns::TurnItem const & turn)
+{
+  return turn.m_turn != turns::CarDirection::None ||
+         turn.m_pedestrianTurn != turns::PedestrianDirection::None || !turn.m_lanes.empty() ||
+         turn.m_exitNum != 0;
+}
+
+uint64_t ToMs(double seconds) { return static_cast<uint64_t>(llround(max(seconds, 0.0) * kMsInSec)); }
+
+// Totals are written with their bits to be restored exactly.
+uint64_t DoubleToBits(double d)
+{
+  static_assert(sizeof(uint64_t) == sizeof(double));
+  uint64_t bits;
+  memcpy(&bits, &d, sizeof(bits));
+  return bits;
+}
+
+double BitsToDouble(uint64_t bits)
+{
+  double d;
+  memcpy(&d, &bits, sizeof(d));
+  return d;
+}
+
+// Points are var int deltas of the coordinates quantized with kPointCoordBits to the previous
+// point |prev|.
+template <typename Sink>
+void SavePoint(Sink & sink, m2::PointD const & point, m2::PointU & prev)
+{
+  auto const p = PointDToPointU(point, kPointCoordBits);
+  WriteVarInt(sink, static_cast<int64_t>(p.x) - static_cast<int64_t>(prev.x));
+  WriteVarInt(sink, static_cast<int64_t>(p.y) - static_cast<int64_t>(prev.y));
+  prev = p;
+}
+
+template <typename Source>
+m2::PointD LoadPoint(Source & src, m2::PointU & prev)
+{
+  int64_t const x = static_cast<int64_t>(prev.x) + ReadVarInt<int64_t>(src);
+  int64_t const y = static_cast<int64_t>(prev.y) + ReadVarInt<int64_t>(src);
+  int64_t constexpr kMaxCoord = (int64_t{1} << kPointCoordBits) - 1;
+  if (x < 0 || x > kMaxCoord || y < 0 || y > kMaxCoord)
+    MYTHROW(CorruptedDataException, ("Wrong point:", x, y));
+
+  prev = m2::PointU(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+  return PointUToPointD(prev, kPointCoordBits);
+}
+
+array<string const *, kNamesCount> GetNames(RouteSegment::RoadNameInfo const & rni)
+{
+  return {&rni.m_name, &rni.m_ref, &rni.m_junction_ref, &rni.m_destination_ref, &rni.m_destination};
+}
+
+/// \param nameIds ids of the names of |routeSegment| in the strings table, 0 for empty names.
+/// \param namesChanged the names differ from the ones of |prevRouteSegment|.
+template <typename Sink>
+void SaveSegment(RouteSegment const & routeSegment, RouteSegment const * prevRouteSegment,
+                 uint32_t segmentIdx, uint64_t prevTimeMs,
+                 array<uint32_t, kNamesCount> const & nameIds, bool namesChanged, Sink & sink)
+{
+  auto const & segment = routeSegment.GetSegment();
+  auto const & turn = routeSegment.GetTurn();
+  auto const & rni = routeSegment.GetRoadNameInfo();
+  auto const & speedLimit = routeSegment.GetSpeedLimit();
+  auto const & speedCameras = routeSegment.GetSpeedCams();
+
+  bool const sameAsPrevious =
+      prevRouteSegment && prevRouteSegment->GetSegment().GetMwmId() == segment.GetMwmId() &&
+      prevRouteSegment->GetTraffic() == routeSegment.GetTraffic() &&
+      prevRouteSegment->GetRoadTypes().GetOptions() == routeSegment.GetRoadTypes().GetOptions();
+  // Most of the segments have no turn and default |m_index| or the index of the next point.
+  bool const hasTurnIndex = turn.m_index != numeric_limits<uint32_t>::max() &&
+                            turn.m_index != segmentIdx + 1;
+
+  uint8_t flags = 0;
+  if (segment.IsForward())
+    flags |= kForward;
+  if (HasTurn(turn))
+    flags |= kHasTurn;
+  if (hasTurnIndex)
+    flags |= kHasTurnIndex;
+  if (namesChanged)
+    flags |= kNamesChanged;
+  if (rni.m_isLink)
+    flags |= kIsLink;
+  if (speedLimit.IsValid())
+    flags |= kHasSpeedLimit;
+  if (!speedCameras.empty())
+    flags |= kHasSpeedCameras;
+  if (sameAsPrevious)
+    flags |= kSameAsPrevious;
+
+  WriteToSink(sink, flags);
+  if (!sameAsPrevious)
+  {
+    WriteVarUint(sink, static_cast<uint32_t>(segment.GetMwmId()));
+    WriteToSink(sink, static_cast<uint8_t>(routeSegment.GetTraffic()));
+    WriteToSink(sink, routeSegment.GetRoadTypes().GetOptions());
+  }
+
+  // Consecutive segments usually belong to the same feature.
+  int64_t const prevFeatureId = prevRouteSegment ? prevRouteSegment->GetSegment().GetFeatureId() : 0;
+  WriteVarInt(sink, static_cast<int64_t>(segment.GetFeatureId()) - prevFeatureId);
+  WriteVarUint(sink, segment.GetSegmentIdx());
+
+  // ETA is not decreasing along the route, so it's stored as deltas in milliseconds.
+  auto const timeMs = ToMs(routeSegment.GetTimeFromBeginningSec());
+  WriteVarUint(sink, timeMs - min(timeMs, prevTimeMs));
+
+  if (hasTurnIndex)
+    WriteVarUint(sink, turn.m_index);
+
+  if (flags & kHasTurn)
+  {
+    WriteToSink(sink, static_cast<uint8_t>(turn.m_turn));
+    WriteToSink(sink, static_cast<uint8_t>(turn.m_pedestrianTurn));
+    WriteVarUint(sink, turn.m_exitNum);
+    WriteVarUint(sink, base::asserted_cast<uint32_t>(turn.m_lanes.size()));
+    for (auto const & lane : turn.m_lanes)
+    {
+      WriteToSink(sink, static_cast<uint8_t>(lane.m_isRecommended ? 1 : 0));
+      WriteVarUint(sink, base::asserted_cast<uint32_t>(lane.m_lane.size()));
+      for (auto const way : lane.m_lane)
+        WriteToSink(sink, static_cast<uint8_t>(way));
+    }
+  }
+
+  if (namesChanged)
+  {
+    uint8_t namesMask = 0;
+    for (size_t i = 0; i < nameIds.size(); ++i)
+    {
+      if (nameIds[i] != 0)
+        namesMask |= 1 << i;
+    }
+    WriteToSink(sink, namesMask);
+    for (auto const id : nameIds)
+    {
+      if (id != 0)
+        WriteVarUint(sink, id);
+    }
+  }
+
+  if (flags & kHasSpeedLimit)
+  {
+    WriteVarUint(sink, static_cast<uint32_t>(speedLimit.GetSpeed()));
+    WriteToSink(sink, static_cast<uint8_t>(speedLimit.GetUnits()));
+  }
+
+  if (flags & kHasSpeedCameras)
+  {
+    WriteVarUint(sink, base::asserted_cast<uint32_t>(speedCameras.size()));
+    for (auto const & camera : speedCameras)
+    {
+      auto const coef = static_cast<uint16_t>(lround(base::Clamp(camera.m_coef, 0.0, 1.0) *
+                                                     kCameraCoefFactor));
+      WriteToSink(sink, coef);
+      WriteToSink(sink, camera.m_maxSpeedKmPH);
+    }
+  }
+}
+
+template <typename Source>
+uint8_t ReadEnum(Source & src, uint8_t count)
+{
+  auto const value = ReadPrimitiveFromSource<uint8_t>(src);
+  if (value >= count)
+    MYTHROW(CorruptedDataException, ("Wrong enum value:", value, "count:", count));
+  return value;
+}
+}  // namespace
+
+// RouteSerializer ---------------------------------------------------------------------------------
+
+// static
+void RouteSerializer::Serialize(Route const & route, vector<uint8_t> & buffer)
+{
+  auto const & segments = route.GetRouteSegments();
+  auto const & points = route.GetPoly().GetPoints();
+  CHECK(points.empty() || points.size() == segments.size() + 1,
+        ("Points:", points.size(), "segments:", segments.size()));
+
+  auto const & subroutes = route.GetSubroutes();
+  bool const hasAltitudes = route.HaveAltitudes() && !subroutes.empty();
+
+  StringsTable strings;
+  auto const routerIdString = strings.Add(route.GetRouterId());
+
+  // The sections are appended right after the header and the header is written when their
+  // offsets are known. The strings go last: they are collected while the segments are written.
+  buffer.assign(kHeaderSize, 0);
+  PushBackByteSink<vector<uint8_t>> sink(buffer);
+
+  uint32_t const pointsOffset = kHeaderSize;
+  {
+    auto prev = m2::PointU::Zero();
+    for (auto const & point : points)
+      SavePoint(sink, point, prev);
+
+    if (hasAltitudes)
+    {
+      geometry::Altitudes altitudes;
+      route.GetAltitudes(altitudes);
+      geometry::Altitude prevAltitude = 0;
+      for (auto const altitude : altitudes)
+      {
+        WriteVarInt(sink, static_cast<int32_t>(altitude) - static_cast<int32_t>(prevAltitude));
+        prevAltitude = altitude;
+      }
+    }
+  }
+
+  auto const segmentsOffset = base::asserted_cast<uint32_t>(sink.Pos());
+  {
+    RouteSegment::RoadNameInfo const noNames;
+    array<uint32_t, kNamesCount> nameIds = {};
+    uint64_t prevTimeMs = 0;
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+      // Consecutive segments usually belong to the same street, so the names are written and
+      // looked up in the strings table only when they change.
+      auto const names = GetNames(segments[i].GetRoadNameInfo());
+      auto const prevNames = GetNames(i == 0 ? noNames : segments[i - 1].GetRoadNameInfo());
+      bool namesChanged = false;
+      for (size_t j = 0; j < kNamesCount; ++j)
+      {
+        if (*names[j] != *prevNames[j])
+        {
+          nameIds[j] = strings.Add(*names[j]);
+          namesChanged = true;
+        }
+      }
+
+      SaveSegment(segments[i], i == 0 ? nullptr : &segments[i - 1], static_cast<uint32_t>(i),
+                  prevTimeMs, nameIds, namesChanged, sink);
+      prevTimeMs = max(prevTimeMs, ToMs(segments[i].GetTimeFromBeginningSec()));
+    }
+  }
+
+  auto const subroutesOffset = base::asserted_cast<uint32_t>(sink.Pos());
+  {
+    // Ends of the subroutes are coded as deltas too: a subroute starts where the previous one ends.
+    auto prev = m2::PointU::Zero();
+    for (auto const & subroute : subroutes)
+    {
+      WriteVarUint(sink, base::asserted_cast<uint32_t>(subroute.GetBeginSegmentIdx()));
+      WriteVarUint(sink, base::asserted_cast<uint32_t>(subroute.GetSize()));
+      for (auto const & point : {subroute.GetStart(), subroute.GetFinish()})
+      {
+        SavePoint(sink, point.GetPoint(), prev);
+        WriteVarInt(sink, static_cast<int32_t>(point.GetAltitude()));
+      }
+    }
+  }
+
+  auto const stringsOffset = base::asserted_cast<uint32_t>(sink.Pos());
+  strings.Serialize(sink);
+
+  MemWriter<vector<uint8_t>> writer(buffer);
+  WriteToSink(writer, kVersion);
+  WriteToSink(writer, hasAltitudes ? kHasAltitudes : uint8_t(0));
+  WriteToSink(writer, base::asserted_cast<uint32_t>(points.size()));
+  WriteToSink(writer, base::asserted_cast<uint32_t>(segments.size()));
+  WriteToSink(writer, base::asserted_cast<uint32_t>(subroutes.size()));
+  WriteToSink(writer, strings.GetCount());
+  WriteToSink(writer, routerIdString);
+  WriteToSink(writer, pointsOffset);
+  WriteToSink(writer, segmentsOffset);
+  WriteToSink(writer, subroutesOffset);
+  WriteToSink(writer, stringsOffset);
+  WriteToSink(writer, DoubleToBits(route.GetTotalDistanceMeters()));
+  WriteToSink(writer, DoubleToBits(route.GetTotalTimeSec()));
+  CHECK_EQUAL(writer.Pos(), kHeaderSize, ());
+}
+
+// SerializedRoute ---------------------------------------------------------------------------------
+
+SerializedRoute::SerializedRoute(void const * data, size_t size)
+  : m_data(static_cast<uint8_t const *>(data)), m_size(size)
+{
+  MemReaderWithExceptions reader(m_data, m_size);
+  ReaderSource<MemReaderWithExceptions> src(reader);
+
+  auto const version = ReadPrimitiveFromSource<uint8_t>(src);
+  if (version != RouteSerializer::kVersion)
+    MYTHROW(CorruptedDataException, ("Unknown route version:", version));
+
+  m_hasAltitudes = (ReadPrimitiveFromSource<uint8_t>(src) & kHasAltitudes) != 0;
+  m_pointsCount = ReadPrimitiveFromSource<uint32_t>(src);
+  m_segmentsCount = ReadPrimitiveFromSource<uint32_t>(src);
+  m_subroutesCount = ReadPrimitiveFromSource<uint32_t>(src);
+  m_stringsCount = ReadPrimitiveFromSource<uint32_t>(src);
+  m_routerIdString = ReadPrimitiveFromSource<uint32_t>(src);
+  m_pointsOffset = ReadPrimitiveFromSource<uint32_t>(src);
+  m_segmentsOffset = ReadPrimitiveFromSource<uint32_t>(src);
+  m_subroutesOffset = ReadPrimitiveFromSource<uint32_t>(src);
+  m_stringsOffset = ReadPrimitiveFromSource<uint32_t>(src);
+  m_totalDistanceM = BitsToDouble(ReadPrimitiveFromSource<uint64_t>(src));
+  m_totalTimeS = BitsToDouble(ReadPrimitiveFromSource<uint64_t>(src));
+
+  if (m_pointsOffset != kHeaderSize || m_pointsOffset > m_segmentsOffset ||
+      m_segmentsOffset > m_subroutesOffset || m_subroutesOffset > m_stringsOffset ||
+      m_stringsOffset > m_size)
+  {
+    MYTHROW(CorruptedDataException, ("Wrong route section offsets."));
+  }
+
+  if (m_stringsCount == 0 || m_routerIdString >= m_stringsCount ||
+      m_stringsOffset + (uint64_t{m_stringsCount} + 1) * sizeof(uint32_t) > m_size)
+  {
+    MYTHROW(CorruptedDataException, ("Wrong route strings table."));
+  }
+
+  if (m_pointsCount != 0 && m_pointsCount != m_segmentsCount + 1)
+    MYTHROW(CorruptedDataException, ("Points:", m_pointsCount, "segments:", m_segmentsCount));
+}
+
+string_view SerializedRoute::GetString(uint32_t id) const
+{
+  if (id >= m_stringsCount)
+    MYTHROW(CorruptedDataException, ("Wrong string id:", id, "strings:", m_stringsCount));
+
+  auto const readOffset = [this](uint32_t i) {
+    uint32_t offset;
+    memcpy(&offset, m_data + m_stringsOffset + i * sizeof(uint32_t), sizeof(offset));
+    return SwapIfBigEndianMacroBased(offset);
+  };
+
+  // Strings follow the table of |m_stringsCount| + 1 offsets.
+  size_t const begin = m_stringsOffset + (size_t{m_stringsCount} + 1) * sizeof(uint32_t);
+  auto const from = readOffset(id);
+  auto const to = readOffset(id + 1);
+  if (from > to || begin + to > m_size)
+    MYTHROW(CorruptedDataException, ("Wrong string offsets:", from, to));
+
+  return string_view(reinterpret_cast<char const *>(m_data + begin + from), to - from);
+}
+
+vector<geometry::PointWithAltitude> SerializedRoute::GetPoints() const
+{
+  vector<geometry::PointWithAltitude> result;
+  if (m_pointsCount == 0)
+    return result;
+
+  MemReaderWithExceptions reader(m_data, m_segmentsOffset);
+  ReaderSource<MemReaderWithExceptions> src(reader);
+  src.Skip(m_pointsOffset);
+
+  vector<m2::PointD> points;
+  points.reserve(m_pointsCount);
+  auto prev = m2::PointU::Zero();
+  for (uint32_t i = 0; i < m_pointsCount; ++i)
+    points.push_back(LoadPoint(src, prev));
+
+  result.reserve(points.size());
+  geometry::Altitude altitude = 0;
+  for (auto const & point : points)
+  {
+    if (m_hasAltitudes)
+    {
+      altitude = static_cast<geometry::Altitude>(altitude + ReadVarInt<int32_t>(src));
+      result.emplace_back(point, altitude);
+    }
+    else
+    {
+      result.emplace_back(point, geometry::kInvalidAltitude);
+    }
+  }
+
+  return result;
+}
+
+vector<Route::SubrouteAttrs> SerializedRoute::GetSubroutes() const
+{
+  vector<Route::SubrouteAttrs> subroutes;
+  if (m_subroutesCount == 0)
+    return subroutes;
+
+  MemReaderWithExceptions reader(m_data, m_stringsOffset);
+  ReaderSource<MemReaderWithExceptions> src(reader);
+  src.Skip(m_subroutesOffset);
+
+  auto prev = m2::PointU::Zero();
+  subroutes.reserve(m_subroutesCount);
+  for (uint32_t i = 0; i < m_subroutesCount; ++i)
+  {
+    auto const beginSegmentIdx = ReadVarUint<uint32_t>(src);
+    auto const size = ReadVarUint<uint32_t>(src);
+    if (uint64_t{beginSegmentIdx} + size > m_segmentsCount)
+      MYTHROW(CorruptedDataException, ("Wrong subroute:", beginSegmentIdx, size));
+
+    geometry::PointWithAltitude ends[2];
+    for (auto & end : ends)
+    {
+      auto const point = LoadPoint(src, prev);
+      end = geometry::PointWithAltitude(
+          point, static_cast<geometry::Altitude>(ReadVarInt<int32_t>(src)));
+    }
+    subroutes.emplace_back(ends[0], ends[1], beginSegmentIdx, beginSegmentIdx + size);
+  }
+
+  return subroutes;
+}
+
+void SerializedRoute::ToRoute(Route & route) const
+{
+  auto const points = GetPoints();
+  auto subroutes = GetSubroutes();
+
+  vector<RouteSegment> routeSegments;
+  routeSegments.reserve(m_segmentsCount);
+  double distFromBeginningMeters = 0.0;
+  double distFromBeginningMerc = 0.0;
+  ForEachSegment([&](SegmentInfo const & info) {
+    auto const i = routeSegments.size();
+    CHECK_LESS(i + 1, points.size(), ());
+
+    RouteSegment::RoadNameInfo rni;
+    rni.m_name = info.m_name;
+    rni.m_ref = info.m_ref;
+    rni.m_junction_ref = info.m_junctionRef;
+    rni.m_destination_ref = info.m_destinationRef;
+    rni.m_destination = info.m_destination;
+    rni.m_isLink = info.m_isLink;
+
+    auto & routeSegment = routeSegments.emplace_back(info.m_segment, info.m_turn, points[i + 1], rni);
+
+    // The same as FillSegmentInfo() does while building the route.
+    if (i > 0)
+    {
+      auto const & junction = points[i + 1].GetPoint();
+      auto const & prevJunction = points[i].GetPoint();
+      distFromBeginningMeters += mercator::DistanceOnEarth(junction, prevJunction);
+      distFromBeginningMerc += junction.Length(prevJunction);
+    }
+    routeSegment.SetDistancesAndTime(distFromBeginningMeters, distFromBeginningMerc,
+                                     info.m_timeFromBeginningS);
+    routeSegment.SetSpeedLimit(info.m_speedLimit);
+    routeSegment.SetTraffic(info.m_traffic);
+    routeSegment.SetRoadTypes(info.m_roadTypes);
+    if (!info.m_speedCameras.empty())
+      routeSegment.SetSpeedCameraInfo(vector<RouteSegment::SpeedCamera>(info.m_speedCameras));
+  });
+
+  route.SetRouteSegments(std::move(routeSegments));
+
+  vector<m2::PointD> geometry;
+  geometry.reserve(points.size());
+  for (auto const & point : points)
+    geometry.push_back(point.GetPoint());
+  route.SetGeometry(geometry.cbegin(), geometry.cend());
+
+  if (!subroutes.empty())
+    route.SetSubroteAttrs(std::move(subroutes));
+}
+
+void SerializedRoute::ReadSegment(ReaderSource<MemReaderWithExceptions> & src, uint32_t segmentIdx,
+                                  uint64_t & timeMs, SegmentInfo & info) const
+{
+  auto const flags = ReadPrimitiveFromSource<uint8_t>(src);
+
+  // |info| keeps the previous segment.
+  if (flags & kSameAsPrevious)
+  {
+    if (segmentIdx == 0)
+      MYTHROW(CorruptedDataException, ("The first segment refers to the previous one."));
+  }
+  else
+  {
+    auto const mwmId = ReadVarUint<uint32_t>(src);
+    if (mwmId > numeric_limits<NumMwmId>::max())
+      MYTHROW(CorruptedDataException, ("Wrong mwm id:", mwmId));
+    info.m_segment = Segment(static_cast<NumMwmId>(mwmId), info.m_segment.GetFeatureId(),
+                             info.m_segment.GetSegmentIdx(), info.m_segment.IsForward());
+    info.m_traffic = static_cast<traffic::SpeedGroup>(
+        ReadEnum(src, static_cast<uint8_t>(traffic::SpeedGroup::Count)));
+    info.m_roadTypes = RoutingOptions(ReadPrimitiveFromSource<RoutingOptions::RoadType>(src));
+  }
+
+  int64_t const prevFeatureId = segmentIdx == 0 ? 0 : info.m_segment.GetFeatureId();
+  int64_t const featureId = prevFeatureId + ReadVarInt<int64_t>(src);
+  if (featureId < 0 || featureId > numeric_limits<uint32_t>::max())
+    MYTHROW(CorruptedDataException, ("Wrong feature id:", featureId));
+  auto const segmentIdxOnFeature = ReadVarUint<uint32_t>(src);
+  info.m_segment = Segment(info.m_segment.GetMwmId(), static_cast<uint32_t>(featureId),
+                           segmentIdxOnFeature, (flags & kForward) != 0);
+
+  timeMs += ReadVarUint<uint64_t>(src);
+  info.m_timeFromBeginningS = static_cast<double>(timeMs) / kMsInSec;
+
+  info.m_turn = turns::TurnItem();
+  if (flags & kHasTurnIndex)
+    info.m_turn.m_index = ReadVarUint<uint32_t>(src);
+
+  if (flags & kHasTurn)
+  {
+    if (!(flags & kHasTurnIndex))
+      info.m_turn.m_index = segmentIdx + 1;
+
+    info.m_turn.m_turn = static_cast<turns::CarDirection>(
+        ReadEnum(src, static_cast<uint8_t>(turns::CarDirection::Count)));
+    info.m_turn.m_pedestrianTurn = static_cast<turns::PedestrianDirection>(
+        ReadEnum(src, static_cast<uint8_t>(turns::PedestrianDirection::Count)));
+    info.m_turn.m_exitNum = ReadVarUint<uint32_t>(src);
+
+    auto const lanesCount = ReadVarUint<uint32_t>(src);
+    for (uint32_t i = 0; i < lanesCount; ++i)
+    {
+      auto & lane = info.m_turn.m_lanes.emplace_back();
+      lane.m_isRecommended = ReadPrimitiveFromSource<uint8_t>(src) != 0;
+      auto const waysCount = ReadVarUint<uint32_t>(src);
+      for (uint32_t j = 0; j < waysCount; ++j)
+      {
+        lane.m_lane.push_back(static_cast<turns::LaneWay>(
+            ReadEnum(src, static_cast<uint8_t>(turns::LaneWay::Count))));
+      }
+    }
+  }
+
+  array<string_view *, kNamesCount> const names = {&info.m_name, &info.m_ref, &info.m_junctionRef,
+                                                   &info.m_destinationRef, &info.m_destination};
+  // |info| keeps the names of the previous segment, they are empty before the first one.
+  if (segmentIdx == 0)
+  {
+    for (auto * name : names)
+      *name = string_view();
+  }
+  if (flags & kNamesChanged)
+  {
+    auto const namesMask = ReadPrimitiveFromSource<uint8_t>(src);
+    for (size_t i = 0; i < names.size(); ++i)
+      *names[i] = (namesMask & (1 << i)) ? GetString(ReadVarUint<uint32_t>(src)) : string_view();
+  }
+  info.m_isLink = (flags & kIsLink) != 0;
+
+  info.m_speedLimit = SpeedInUnits();
+  if (flags & kHasSpeedLimit)
+  {
+    info.m_speedLimit.SetSpeed(base::asserted_cast<MaxspeedType>(ReadVarUint<uint32_t>(src)));
+    info.m_speedLimit.SetUnits(static_cast<measurement_utils::Units>(
+        ReadEnum(src, static_cast<uint8_t>(measurement_utils::Units::Imperial) + 1)));
+  }
+
+  info.m_speedCameras.clear();
+  if (flags & kHasSpeedCameras)
+  {
+    auto const camerasCount = ReadVarUint<uint32_t>(src);
+    for (uint32_t i = 0; i < camerasCount; ++i)
+    {
+      auto const coef = ReadPrimitiveFromSource<uint16_t>(src);
+      auto const maxSpeedKmPH = ReadPrimitiveFromSource<uint8_t>(src);
+      info.m_speedCameras.emplace_back(coef / kCameraCoefFactor, maxSpeedKmPH);
+    }
+  }
+}
+}  // namespace routing
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "routing/route.hpp"
+#include "routing/routing_exceptions.hpp"
+#include "routing/routing_options.hpp"
+#include "routing/segment.hpp"
+#include "routing/turns.hpp"
+
+#include "routing_common/maxspeed_conversion.hpp"
+
+#include "traffic/speed_groups.hpp"
+
+#include "coding/reader.hpp"
+
+#include "geometry/point_with_altitude.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace routing
+{
+/// \brief Compact binary representation of Route for server responses.
+///
+/// Layout:
+/// * Header of fixed size with counts, offsets of the sections and totals of the route.
+/// * Points. Coordinates of the route polyline are quantized with kPointCoordBits and stored
+///   as var int deltas to the previous point, altitudes follow as var int deltas if all points
+///   have them.
+/// * Segments. A record of var uints per segment. Feature ids are deltas to the previous segment,
+///   mwm id, traffic, road types and names are omitted if they are the same as the previous ones.
+///   Fields which are empty for most of the segments (turns, speed limits, speed cameras) are
+///   written only if they are set.
+/// * Subroutes.
+/// * Strings. Every distinct street name, ref, destination and router id is stored once.
+///   A table of fixed size offsets goes first, so a string is read from the buffer without
+///   copying by its index.
+///
+/// Distances from the beginning of the route are not stored, they are restored from the points
+/// the same way as the route builder calculates them. Transit info is not stored.
+class RouteSerializer
+{
+public:
+  static uint8_t constexpr kVersion = 0;
+
+  static void Serialize(Route const & route, std::vector<uint8_t> & buffer);
+};
+
+/// \brief Read only view of a route serialized by RouteSerializer. The view doesn't own
+/// the buffer and doesn't copy it: strings are returned as string views into the buffer and
+/// points and segments are decoded on demand.
+/// \note Every method throws CorruptedDataException or Reader::Exception if the buffer is
+/// corrupted.
+class SerializedRoute
+{
+public:
+  struct SegmentInfo
+  {
+    Segment m_segment;
+    turns::TurnItem m_turn;
+    // RouteSegment::RoadNameInfo fields.
+    std::string_view m_name;
+    std::string_view m_ref;
+    std::string_view m_junctionRef;
+    std::string_view m_destinationRef;
+    std::string_view m_destination;
+    bool m_isLink = false;
+    SpeedInUnits m_speedLimit;
+    double m_timeFromBeginningS = 0.0;
+    traffic::SpeedGroup m_traffic = traffic::SpeedGroup::Unknown;
+    RoutingOptions m_roadTypes;
+    std::vector<RouteSegment::SpeedCamera> m_speedCameras;
+  };
+
+  SerializedRoute(void const * data, size_t size);
+
+  uint32_t GetPointsCount() const { return m_pointsCount; }
+  uint32_t GetSegmentsCount() const { return m_segmentsCount; }
+  uint32_t GetSubroutesCount() const { return m_subroutesCount; }
+  uint32_t GetStringsCount() const { return m_stringsCount; }
+  bool HasAltitudes() const { return m_hasAltitudes; }
+  double GetTotalDistanceMeters() const { return m_totalDistanceM; }
+  double GetTotalTimeSec() const { return m_totalTimeS; }
+
+  std::string_view GetString(uint32_t id) const;
+  std::string_view GetRouterId() const { return GetString(m_routerIdString); }
+
+  /// \returns route polyline. Altitudes are geometry::kInvalidAltitude if the route has no ones.
+  std::vector<geometry::PointWithAltitude> GetPoints() const;
+  std::vector<Route::SubrouteAttrs> GetSubroutes() const;
+
+  /// \brief Calls |fn| for every segment in order. The same SegmentInfo is reused for all
+  /// the segments, so string views and vectors are valid during the call only.
+  template <typename Fn>
+  void ForEachSegment(Fn && fn) const
+  {
+    MemReaderWithExceptions reader(m_data, m_size);
+    ReaderSource<MemReaderWithExceptions> src(reader);
+    src.Skip(m_segmentsOffset);
+
+    SegmentInfo info;
+    uint64_t timeMs = 0;
+    for (uint32_t i = 0; i < m_segmentsCount; ++i)
+    {
+      ReadSegment(src, i, timeMs, info);
+      fn(static_cast<SegmentInfo const &>(info));
+    }
+  }
+
+  /// \brief Fills |route| with the geometry, the segments and the subroutes of the serialized
+  /// route. |route| is expected to be created with GetRouterId().
+  void ToRoute(Route & route) const;
+
+private:
+  void ReadSegment(ReaderSource<MemReaderWithExceptions> & src, uint32_t segmentIdx,
+                   uint64_t & timeMs, SegmentInfo & info) const;
+
+  uint8_t const * m_data = nullptr;
+  size_t m_size = 0;
+
+  bool m_hasAltitudes = false;
+  uint32_t m_pointsCount = 0;
+  uint32_t m_segmentsCount = 0;
+  uint32_t m_subroutesCount = 0;
+  uint32_t m_stringsCount = 0;
+  uint32_t m_routerIdString = 0;
+  uint32_t m_pointsOffset = 0;
+  uint32_t m_segmentsOffset = 0;
+  uint32_t m_subroutesOffset = 0;
+  uint32_t m_stringsOffset = 0;
+  double m_totalDistanceM = 0.0;
+  double m_totalTimeS = 0.0;
+};
+}  // namespace routing
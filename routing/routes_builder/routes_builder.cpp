@@ -130,15 +130,34 @@ RoutesBuilder::RoutesBuilder(size_t threadsNumber) : m_threadPool(threadsNumber)
     m_dataSourcesStorage.PushDataSource(std::move(dataSource));
 }
 
+RoutesBuilder::~RoutesBuilder()
+{
+  // Updates are stopped on the thread which started them.
+  m_liveSpeedsSource->StopUpdating();
+}
+
 RoutesBuilder::Result RoutesBuilder::ProcessTask(Params const & params)
 {
-  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig);
+  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig, m_liveSpeedsSource);
   return processor(params);
 }
 
 std::future<RoutesBuilder::Result> RoutesBuilder::ProcessTaskAsync(Params const & params)
 {
-  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig);
+  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig, m_liveSpeedsSource);
+  return m_threadPool.Submit(std::move(processor), params);
+}
+
+RoutesBuilder::IsochroneResult RoutesBuilder::ProcessIsochroneTask(IsochroneParams const & params)
+{
+  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig, m_liveSpeedsSource);
+  return processor(params);
+}
+
+std::future<RoutesBuilder::IsochroneResult>
+RoutesBuilder::ProcessIsochroneTaskAsync(IsochroneParams const & params)
+{
+  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig, m_liveSpeedsSource);
   return m_threadPool.Submit(std::move(processor), params);
 }
 
@@ -228,11 +247,13 @@ std::vector<ms::LatLon> RoutesBuilder::Route::GetWaypoints() const
 RoutesBuilder::Processor::Processor(std::shared_ptr<NumMwmIds> numMwmIds,
                                     DataSourceStorage & dataSourceStorage,
                                     std::weak_ptr<storage::CountryParentGetter> cpg,
-                                    std::weak_ptr<storage::CountryInfoGetter> cig)
+                                    std::weak_ptr<storage::CountryInfoGetter> cig,
+                                    std::shared_ptr<LiveSpeedsSource> liveSpeedsSource)
     : m_numMwmIds(std::move(numMwmIds))
     , m_dataSourceStorage(dataSourceStorage)
     , m_cpg(std::move(cpg))
     , m_cig(std::move(cig))
+    , m_liveSpeedsSource(std::move(liveSpeedsSource))
 {
 }
 
@@ -249,6 +270,7 @@ RoutesBuilder::Processor::Processor(Processor && rhs) noexcept
   m_cpg = std::move(rhs.m_cpg);
   m_cig = std::move(rhs.m_cig);
   m_dataSource = std::move(rhs.m_dataSource);
+  m_liveSpeedsSource = std::move(rhs.m_liveSpeedsSource);
 }
 
 void RoutesBuilder::Processor::InitRouter(VehicleType type)
@@ -280,6 +302,7 @@ void RoutesBuilder::Processor::InitRouter(VehicleType type)
                                            MakeNumMwmTree(*m_numMwmIds, *m_cig.lock()),
                                            *m_trafficCache,
                                            *m_dataSource);
+  m_router->SetLiveSpeedsSource(m_liveSpeedsSource);
 }
 
 RoutesBuilder::Result
@@ -326,5 +349,40 @@ RoutesBuilder::Processor::operator()(Params const & params)
 
   return result;
 }
+
+RoutesBuilder::IsochroneResult
+RoutesBuilder::Processor::operator()(IsochroneParams const & params)
+{
+  InitRouter(params.m_type);
+  SCOPE_GUARD(returnDataSource, [&]() {
+    m_dataSourceStorage.PushDataSource(std::move(m_dataSource));
+  });
+
+  LOG(LINFO, ("Start building isochrone, start:", mercator::ToLatLon(params.m_start),
+              "max time:", params.m_maxTimeS));
+
+  CHECK(m_dataSource, ());
+
+  IsochroneResult result;
+  result.m_params = params;
+
+  double timeSum = 0.0;
+  for (size_t i = 0; i < params.m_launchesNumber; ++i)
+  {
+    m_delegate->SetTimeout(params.m_timeoutSeconds);
+    base::Timer timer;
+    result.m_code = m_router->CalculateIsochrone(params.m_start, params.m_maxTimeS,
+                                                 true /* buildOutline */, *m_delegate,
+                                                 result.m_isochrone);
+
+    if (result.m_code != RouterResultCode::NoError)
+      break;
+
+    timeSum += timer.ElapsedSeconds();
+  }
+
+  result.m_buildTimeSeconds = timeSum / static_cast<double>(params.m_launchesNumber);
+  return result;
+}
 }  // namespace routes_builder
 }  // namespace routing
@@ -4,6 +4,8 @@
 
 #include "routing/checkpoints.hpp"
 #include "routing/index_router.hpp"
+#include "routing/isochrone.hpp"
+#include "routing/live_speeds.hpp"
 #include "routing/router_delegate.hpp"
 #include "routing/routing_callbacks.hpp"
 #include "routing/segment.hpp"
@@ -25,6 +27,7 @@
 #include "coding/reader.hpp"
 
 #include "geometry/latlon.hpp"
+#include "geometry/point2d.hpp"
 
 #include "base/macros.hpp"
 #include "base/thread_pool_computational.hpp"
@@ -45,6 +48,7 @@ class RoutesBuilder
 {
 public:
   explicit RoutesBuilder(size_t threadsNumber);
+  ~RoutesBuilder();
   DISALLOW_COPY(RoutesBuilder);
 
   static RoutesBuilder & GetSimpleRoutesBuilder();
@@ -95,9 +99,34 @@ public:
     double m_buildTimeSeconds = 0.0;
   };
 
+  struct IsochroneParams
+  {
+    VehicleType m_type = VehicleType::Car;
+    m2::PointD m_start;
+    double m_maxTimeS = 0.0;
+    uint32_t m_timeoutSeconds = RouterDelegate::kNoTimeout;
+    uint32_t m_launchesNumber = 1;
+  };
+
+  struct IsochroneResult
+  {
+    bool IsCodeOK() const { return m_code == RouterResultCode::NoError; }
+
+    RouterResultCode m_code = RouterResultCode::RouteNotFound;
+    IsochroneParams m_params;
+    Isochrone m_isochrone;
+    double m_buildTimeSeconds = 0.0;
+  };
+
   Result ProcessTask(Params const & params);
   std::future<Result> ProcessTaskAsync(Params const & params);
 
+  IsochroneResult ProcessIsochroneTask(IsochroneParams const & params);
+  std::future<IsochroneResult> ProcessIsochroneTaskAsync(IsochroneParams const & params);
+
+  // Car routes are built with the speeds published by this source.
+  LiveSpeedsSource & GetLiveSpeedsSource() { return *m_liveSpeedsSource; }
+
 private:
 
   class Processor
@@ -106,11 +135,13 @@ private:
     Processor(std::shared_ptr<NumMwmIds> numMwmIds,
               DataSourceStorage & dataSourceStorage,
               std::weak_ptr<storage::CountryParentGetter> cpg,
-              std::weak_ptr<storage::CountryInfoGetter> cig);
+              std::weak_ptr<storage::CountryInfoGetter> cig,
+              std::shared_ptr<LiveSpeedsSource> liveSpeedsSource);
 
     Processor(Processor && rhs) noexcept;
 
     Result operator()(Params const & params);
+    IsochroneResult operator()(IsochroneParams const & params);
 
   private:
     void InitRouter(VehicleType type);
@@ -127,6 +158,7 @@ private:
     std::weak_ptr<storage::CountryParentGetter> m_cpg;
     std::weak_ptr<storage::CountryInfoGetter> m_cig;
     std::unique_ptr<FrozenDataSource> m_dataSource;
+    std::shared_ptr<LiveSpeedsSource> m_liveSpeedsSource;
   };
 
   base::thread_pool::computational::ThreadPool m_threadPool;
@@ -138,6 +170,8 @@ private:
       storage::CountryInfoReader::CreateCountryInfoGetter(GetPlatform());
 
   std::shared_ptr<NumMwmIds> m_numMwmIds = std::make_shared<NumMwmIds>();
+  std::shared_ptr<LiveSpeedsSource> m_liveSpeedsSource =
+      std::make_shared<LiveSpeedsSource>(m_numMwmIds);
 
   DataSourceStorage m_dataSourcesStorage;
 };
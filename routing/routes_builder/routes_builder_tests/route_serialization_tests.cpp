@@ -0,0 +1,107 @@
+#include "testing/testing.hpp"
+
+#include "routing/routes_builder/routes_builder.hpp"
+
+#include "routing/route.hpp"
+#include "routing/route_serialization.hpp"
+#include "routing/routing_helpers.hpp"
+#include "routing/turns.hpp"
+
+#include "platform/platform.hpp"
+#include "platform/platform_tests_support/scoped_file.hpp"
+
+#include "coding/file_writer.hpp"
+
+#include "geometry/point2d.hpp"
+#include "geometry/point_with_altitude.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace route_serialization_tests
+{
+using namespace routing;
+using namespace std;
+
+// Route of |pointsCount| points along a few streets with a turn on every tenth segment.
+Route MakeRoute(size_t pointsCount)
+{
+  vector<string> const streets = {"Tverskaya street", "Garden Ring", "Leningradsky avenue"};
+
+  vector<m2::PointD> points;
+  for (size_t i = 0; i < pointsCount; ++i)
+    points.emplace_back(37.5 + 1e-4 * i, 67.4 + 3e-5 * (i % 7));
+
+  vector<RouteSegment> routeSegments;
+  vector<double> times;
+  for (size_t i = 0; i + 1 < pointsCount; ++i)
+  {
+    turns::TurnItem turn;
+    if (i % 10 == 9)
+      turn = turns::TurnItem(static_cast<uint32_t>(i + 1), turns::CarDirection::TurnLeft);
+
+    RouteSegment::RoadNameInfo rni;
+    rni.m_name = streets[(i / 10) % streets.size()];
+    routeSegments.emplace_back(
+        Segment(3 /* mwmId */, static_cast<uint32_t>(100 + i / 5), static_cast<uint32_t>(i % 5),
+                true /* forward */),
+        turn, geometry::PointWithAltitude(points[i + 1], geometry::kInvalidAltitude), rni);
+    times.push_back(1.5 * static_cast<double>(i + 1));
+  }
+  FillSegmentInfo(times, routeSegments);
+
+  Route route("test-router", 0 /* routeId */);
+  route.SetRouteSegments(std::move(routeSegments));
+  route.SetGeometry(points.cbegin(), points.cend());
+  return route;
+}
+
+// Compares RouteSerializer with the dump of routes_builder. The dump keeps the ETA, the distance
+// and the raw polyline only, the route segments are not dumped at all.
+UNIT_TEST(RouteSerialization_CompareWithRoutesBuilderDump)
+{
+  size_t constexpr kLaunchesNumber = 100;
+  platform::tests_support::ScopedFile const dumpFile(
+      "route_serialization_tests.dump", platform::tests_support::ScopedFile::Mode::DoNotCreate);
+
+  for (size_t const pointsCount : {100, 1000, 10000})
+  {
+    auto const route = MakeRoute(pointsCount);
+
+    routes_builder::RoutesBuilder::Route dumpRoute;
+    dumpRoute.m_eta = route.GetTotalTimeSec();
+    dumpRoute.m_distance = route.GetTotalDistanceMeters();
+    auto const & points = route.GetPoly().GetPoints();
+    FollowedPolyline polyline(points.begin(), points.end());
+    dumpRoute.m_followedPolyline.Swap(polyline);
+
+    base::Timer timer;
+    {
+      FileWriter writer(dumpFile.GetFullPath());
+      for (size_t i = 0; i < kLaunchesNumber; ++i)
+        routes_builder::RoutesBuilder::Route::Dump(dumpRoute, writer);
+    }
+    double const dumpTimeMs = timer.ElapsedSeconds() * 1000.0 / kLaunchesNumber;
+
+    uint64_t dumpFileSize = 0;
+    TEST(GetPlatform().GetFileSizeByFullPath(dumpFile.GetFullPath(), dumpFileSize), ());
+    uint64_t const dumpSize = dumpFileSize / kLaunchesNumber;
+
+    vector<uint8_t> buffer;
+    timer.Reset();
+    for (size_t i = 0; i < kLaunchesNumber; ++i)
+      RouteSerializer::Serialize(route, buffer);
+    double const serializeTimeMs = timer.ElapsedSeconds() * 1000.0 / kLaunchesNumber;
+
+    LOG(LINFO, ("Points:", pointsCount, "routes_builder dump:", dumpSize, "bytes,", dumpTimeMs,
+                "ms; RouteSerializer:", buffer.size(), "bytes,", serializeTimeMs, "ms"));
+
+    // The format keeps the segments too, but it's still smaller than the raw polyline.
+    TEST_LESS(buffer.size(), dumpSize, (pointsCount));
+  }
+}
+}  // namespace route_serialization_tests
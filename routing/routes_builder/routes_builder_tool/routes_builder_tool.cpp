@@ -22,6 +22,14 @@ DEFINE_string(routes_file, "", "Path to file with routes in format: \n\t"
                                "second_start_lat second_start_lon second_finish_lat second_finish_lon\n\t"
                                "...");
 
+DEFINE_string(isochrones_file, "", "Path to file with starts of isochrones in format: \n\t"
+                                   "first_start_lat first_start_lon\n\t"
+                                   "second_start_lat second_start_lon\n\t"
+                                   "...");
+
+DEFINE_double(isochrone_time, 15 * 60, "Travel time in seconds of isochrones of --isochrones_file "
+                                       "(default: 15 minutes).");
+
 DEFINE_string(dump_path, "", "Path where routes will be dumped after building."
                              "Useful for intermediate results, because routes building "
                              "is a long process.");
@@ -42,6 +50,11 @@ DEFINE_bool(verbose, false, "Verbose logging (default: false)");
 DEFINE_int32(launches_number, 1, "Number of launches of routes buildings. Needs for benchmarking (default: 1)");
 DEFINE_string(vehicle_type, "car", "Vehicle type: car|pedestrian|bicycle|transit. (Only for mapsme).");
 
+DEFINE_string(live_speeds_path, "", "Directory with <mwm name>.speeds files of measured segment speeds "
+                                    "for car routes (Only for mapsme).");
+DEFINE_uint64(live_speeds_update_period, 0, "Period in seconds of live speeds reloading while routes are "
+                                            "being built. 0 means to load them once (default: 0).");
+
 using namespace routing;
 using namespace routes_builder;
 using namespace routing_quality;
@@ -58,6 +71,11 @@ bool IsApiBuild()
   return !FLAGS_routes_file.empty() && !FLAGS_api_name.empty() && !FLAGS_api_token.empty();
 }
 
+bool IsIsochronesBuild()
+{
+  return !FLAGS_isochrones_file.empty() && FLAGS_api_name.empty() && FLAGS_api_token.empty();
+}
+
 void CheckDirExistence(std::string const & dir)
 {
   CHECK(Platform::IsDirectory(dir), ("Can not find directory:", dir));
@@ -71,8 +89,8 @@ int Main(int argc, char ** argv)
 
   CHECK_GREATER_OR_EQUAL(FLAGS_timeout, 0, ("Timeout should be greater than zero."));
 
-  CHECK(!FLAGS_routes_file.empty(),
-        ("\n\n\t--routes_file is required.",
+  CHECK(!FLAGS_routes_file.empty() || !FLAGS_isochrones_file.empty(),
+        ("\n\n\t--routes_file or --isochrones_file is required.",
          "\n\nType --help for usage."));
 
   if (!FLAGS_data_path.empty())
@@ -81,7 +99,7 @@ int Main(int argc, char ** argv)
   if (!FLAGS_resources_path.empty())
     GetPlatform().SetResourceDir(FLAGS_resources_path);
 
-  CHECK(IsLocalBuild() || IsApiBuild(),
+  CHECK(IsLocalBuild() || IsApiBuild() || IsIsochronesBuild(),
         ("\n\n\t--routes_file empty is:", FLAGS_routes_file.empty(),
          "\n\t--api_name empty is:", FLAGS_api_name.empty(),
          "\n\t--api_token empty is:", FLAGS_api_token.empty(),
@@ -108,7 +126,15 @@ int Main(int argc, char ** argv)
     }
 
     BuildRoutes(FLAGS_routes_file, FLAGS_dump_path, FLAGS_start_from, FLAGS_threads, FLAGS_timeout,
-                FLAGS_vehicle_type, FLAGS_verbose, launchesNumber);
+                FLAGS_vehicle_type, FLAGS_verbose, launchesNumber, FLAGS_live_speeds_path,
+                static_cast<uint32_t>(FLAGS_live_speeds_update_period));
+  }
+
+  if (IsIsochronesBuild())
+  {
+    BuildIsochrones(FLAGS_isochrones_file, FLAGS_dump_path, FLAGS_start_from, FLAGS_threads,
+                    FLAGS_timeout, FLAGS_vehicle_type, FLAGS_verbose,
+                    static_cast<uint32_t>(FLAGS_launches_number), FLAGS_isochrone_time);
   }
 
   if (IsApiBuild())
@@ -19,7 +19,9 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <fstream>
 #include <future>
+#include <iomanip>
 #include <iostream>
 #include <optional>
 #include <thread>
@@ -70,7 +72,9 @@ void BuildRoutes(std::string const & routesPath,
                  uint32_t timeoutPerRouteSeconds,
                  std::string const & vehicleTypeStr,
                  bool verbose,
-                 uint32_t launchesNumber)
+                 uint32_t launchesNumber,
+                 std::string const & liveSpeedsPath,
+                 uint32_t liveSpeedsUpdatePeriodSeconds)
 {
   CHECK(Platform::IsFileExistsByFullPath(routesPath), ("Can not find file:", routesPath));
   CHECK(!dumpPath.empty(), ("Empty dumpPath."));
@@ -85,6 +89,15 @@ void BuildRoutes(std::string const & routesPath,
   }
 
   RoutesBuilder routesBuilder(threadsNumber);
+  if (!liveSpeedsPath.empty())
+  {
+    CHECK(Platform::IsDirectory(liveSpeedsPath), ("Can not find directory:", liveSpeedsPath));
+    auto & liveSpeeds = routesBuilder.GetLiveSpeedsSource();
+    if (liveSpeedsUpdatePeriodSeconds == 0)
+      liveSpeeds.UpdateFromDirectory(liveSpeedsPath);
+    else
+      liveSpeeds.StartUpdating(liveSpeedsPath, std::chrono::seconds(liveSpeedsUpdatePeriodSeconds));
+  }
 
   std::vector<std::future<RoutesBuilder::Result>> tasks;
   double lastPercent = 0.0;
@@ -145,6 +158,85 @@ void BuildRoutes(std::string const & routesPath,
   }
 }
 
+void BuildIsochrones(std::string const & startsPath,
+                     std::string const & dumpPath,
+                     uint64_t startFrom,
+                     uint64_t threadsNumber,
+                     uint32_t timeoutPerIsochroneSeconds,
+                     std::string const & vehicleTypeStr,
+                     bool verbose,
+                     uint32_t launchesNumber,
+                     double maxTimeS)
+{
+  CHECK(Platform::IsFileExistsByFullPath(startsPath), ("Can not find file:", startsPath));
+  CHECK(!dumpPath.empty(), ("Empty dumpPath."));
+  CHECK_GREATER(maxTimeS, 0.0, ());
+
+  std::ifstream input(startsPath);
+  CHECK(input.good(), ("Error during opening:", startsPath));
+
+  if (!threadsNumber)
+  {
+    auto const hardwareConcurrency = std::thread::hardware_concurrency();
+    threadsNumber = hardwareConcurrency > 0 ? hardwareConcurrency : 2;
+  }
+
+  RoutesBuilder routesBuilder(threadsNumber);
+  std::vector<std::future<RoutesBuilder::IsochroneResult>> tasks;
+
+  RoutesBuilder::IsochroneParams params;
+  params.m_type = ConvertVehicleTypeFromString(vehicleTypeStr);
+  params.m_maxTimeS = maxTimeS;
+  params.m_timeoutSeconds = timeoutPerIsochroneSeconds;
+  params.m_launchesNumber = launchesNumber;
+
+  base::ScopedLogLevelChanger changer(verbose ? base::LogLevel::LINFO : base::LogLevel::LERROR);
+  ms::LatLon start;
+  size_t startFromCopy = startFrom;
+  while (input >> start.m_lat >> start.m_lon)
+  {
+    if (startFromCopy > 0)
+    {
+      --startFromCopy;
+      continue;
+    }
+
+    params.m_start = mercator::FromLatLon(start);
+    tasks.emplace_back(routesBuilder.ProcessIsochroneTaskAsync(params));
+  }
+
+  LOG_FORCE(LINFO, ("Created:", tasks.size(), "isochrone tasks, vehicle type:", params.m_type));
+  base::Timer timer;
+  double buildTimeSum = 0.0;
+  size_t okNumber = 0;
+  for (size_t i = 0; i < tasks.size(); ++i)
+  {
+    auto const result = tasks[i].get();
+    if (result.IsCodeOK())
+    {
+      ++okNumber;
+      buildTimeSum += result.m_buildTimeSeconds;
+    }
+
+    std::string const fullPath =
+        base::JoinPath(dumpPath, std::to_string(i + startFrom) + ".isochrone");
+    std::ofstream output(fullPath);
+    CHECK(output.good(), ("Error during opening:", fullPath));
+
+    output << std::setprecision(9) << static_cast<int>(result.m_code) << " "
+           << result.m_buildTimeSeconds << " " << result.m_isochrone.m_segments.size() << "\n";
+    for (auto const & point : result.m_isochrone.m_outline)
+    {
+      auto const latlon = mercator::ToLatLon(point);
+      output << latlon.m_lat << " " << latlon.m_lon << "\n";
+    }
+  }
+
+  LOG_FORCE(LINFO, ("BuildIsochrones() took:", timer.ElapsedSeconds(), "seconds. Built:", okNumber,
+                    "of", tasks.size(), "average build time:",
+                    okNumber == 0 ? 0.0 : buildTimeSum / okNumber, "seconds."));
+}
+
 std::optional<std::tuple<ms::LatLon, ms::LatLon, int32_t>> ParseApiLine(std::ifstream & input)
 {
   std::string line;
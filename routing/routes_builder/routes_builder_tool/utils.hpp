@@ -20,7 +20,23 @@ void BuildRoutes(std::string const & routesPath,
                  uint32_t timeoutPerRouteSeconds,
                  std::string const & vehicleType,
                  bool verbose,
-                 uint32_t launchesNumber);
+                 uint32_t launchesNumber,
+                 std::string const & liveSpeedsPath,
+                 uint32_t liveSpeedsUpdatePeriodSeconds);
+
+/// \brief Builds isochrones of |maxTimeS| seconds from starts of |startsPath| file with
+/// "lat lon" lines and saves every one to <line number>.isochrone text file in |dumpPath|.
+/// The first line of the file is "<result code> <build time in seconds> <number of segments>",
+/// the rest lines are "lat lon" points of the outline.
+void BuildIsochrones(std::string const & startsPath,
+                     std::string const & dumpPath,
+                     uint64_t startFrom,
+                     uint64_t threadsNumber,
+                     uint32_t timeoutPerIsochroneSeconds,
+                     std::string const & vehicleType,
+                     bool verbose,
+                     uint32_t launchesNumber,
+                     double maxTimeS);
 
 void BuildRoutesWithApi(std::unique_ptr<routing_quality::api::RoutingApi> routingApi,
                         std::string const & routesPath,
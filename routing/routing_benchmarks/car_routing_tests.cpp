@@ -3,16 +3,22 @@
 #include "routing/routing_benchmarks/helpers.hpp"
 
 #include "routing/car_directions.hpp"
+#include "routing/checkpoints.hpp"
 #include "routing/road_graph.hpp"
+#include "routing/router_delegate.hpp"
 
 #include "routing_common/car_model.hpp"
 
 #include "geometry/latlon.hpp"
 #include "geometry/mercator.hpp"
 
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace
 {
@@ -26,10 +32,12 @@ public:
   {
   }
 
-  void TestCarRouter(ms::LatLon const & start, ms::LatLon const & final, size_t reiterations)
+  void TestCarRouter(ms::LatLon const & start, ms::LatLon const & final, size_t reiterations,
+                     bool timeDependentWeights = false)
   {
     routing::Route routeFoundByAstarBidirectional("", 0 /* route id */);
     auto router = CreateRouter("test-astar-bidirectional");
+    router->SetTimeDependentWeights(timeDependentWeights);
 
     m2::PointD const startMerc = mercator::FromLatLon(start);
     m2::PointD const finalMerc = mercator::FromLatLon(final);
@@ -37,6 +45,32 @@ public:
       TestRouter(*router, startMerc, finalMerc, routeFoundByAstarBidirectional);
   }
 
+  void TestCarRouterWithAlternatives(ms::LatLon const & start, ms::LatLon const & final,
+                                     size_t reiterations)
+  {
+    auto router = CreateRouter("test-astar-bidirectional");
+    routing::Checkpoints const checkpoints(mercator::FromLatLon(start), mercator::FromLatLon(final));
+    routing::IndexRouter::AlternativesParams const params;
+    routing::RouterDelegate delegate;
+    for (size_t i = 0; i < reiterations; ++i)
+    {
+      routing::Route route("", 0 /* route id */);
+      std::vector<routing::Route> alternatives;
+      base::Timer timer;
+      auto const resultCode = router->CalculateRouteWithAlternatives(
+          checkpoints, m2::PointD::Zero() /* startDirection */, params, delegate, route,
+          alternatives);
+      double const elapsedSec = timer.ElapsedSeconds();
+      TEST_EQUAL(routing::RouterResultCode::NoError, resultCode, ());
+      TEST(route.IsValid(), ());
+      LOG(LINFO, ("Route distance, meters:", route.GetTotalDistanceMeters(),
+                  "alternatives:", alternatives.size()));
+      for (auto const & alternative : alternatives)
+        LOG(LINFO, ("Alternative distance, meters:", alternative.GetTotalDistanceMeters()));
+      LOG(LINFO, ("Elapsed, seconds:", elapsedSec));
+    }
+  }
+
 protected:
   std::unique_ptr<routing::VehicleModelFactoryInterface> CreateModelFactory() override
   {
@@ -64,4 +98,39 @@ UNIT_CLASS_TEST(CarTest, InAirport)
 {
   TestCarRouter(ms::LatLon(55.97285, 37.41275), ms::LatLon(55.96396, 37.41922), 30);
 }
+
+// Benchmarks below measure the extra cost of time-dependent weights: speed profiles are loaded
+// and roads are weighted at their arrival time by unidirectional A*. Compare them with the ones
+// above on an mwm with speed_profiles section.
+
+UNIT_CLASS_TEST(CarTest, InCityTimeDependent)
+{
+  TestCarRouter(ms::LatLon(55.75785, 37.58267), ms::LatLon(55.76082, 37.58492), 30,
+                true /* timeDependentWeights */);
+}
+
+UNIT_CLASS_TEST(CarTest, BigRoadTimeDependent)
+{
+  TestCarRouter(ms::LatLon(55.75826, 37.39476), ms::LatLon(55.7605, 37.39003), 30,
+                true /* timeDependentWeights */);
+}
+
+// The route crosses the city so most of its roads are weighted by profiles.
+UNIT_CLASS_TEST(CarTest, AcrossCity)
+{
+  TestCarRouter(ms::LatLon(55.84512, 37.39213), ms::LatLon(55.65437, 37.74932), 5);
+}
+
+UNIT_CLASS_TEST(CarTest, AcrossCityTimeDependent)
+{
+  TestCarRouter(ms::LatLon(55.84512, 37.39213), ms::LatLon(55.65437, 37.74932), 5,
+                true /* timeDependentWeights */);
+}
+
+// Compare with AcrossCity to get the extra cost of alternatives: the waves go on after
+// the best route is found and candidates are compared with each other.
+UNIT_CLASS_TEST(CarTest, AcrossCityAlternatives)
+{
+  TestCarRouterWithAlternatives(ms::LatLon(55.84512, 37.39213), ms::LatLon(55.65437, 37.74932), 5);
+}
 }  // namespace
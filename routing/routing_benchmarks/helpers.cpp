@@ -121,7 +121,7 @@ void RoutingTest::TestTwoPointsOnFeature(m2::PointD const & startPos, m2::PointD
   TestRouters(startPosOnFeature, finalPosOnFeature);
 }
 
-std::unique_ptr<routing::IRouter> RoutingTest::CreateRouter(std::string const & name)
+std::unique_ptr<routing::IndexRouter> RoutingTest::CreateRouter(std::string const & name)
 {
   std::vector<platform::LocalCountryFile> neededLocalFiles;
   neededLocalFiles.reserve(m_neededMaps.size());
@@ -131,9 +131,8 @@ std::unique_ptr<routing::IRouter> RoutingTest::CreateRouter(std::string const &
       neededLocalFiles.push_back(file);
   }
 
-  std::unique_ptr<routing::IRouter> router = integration::CreateVehicleRouter(
-      m_dataSource, *m_cig, m_trafficCache, neededLocalFiles, m_type);
-  return router;
+  return integration::CreateVehicleRouter(m_dataSource, *m_cig, m_trafficCache, neededLocalFiles,
+                                          m_type);
 }
 
 void RoutingTest::GetNearestEdges(m2::PointD const & pt,
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "routing/index_router.hpp"
 #include "routing/road_graph.hpp"
 #include "routing/route.hpp"
 #include "routing/router.hpp"
@@ -35,7 +36,7 @@ public:
 protected:
   virtual std::unique_ptr<routing::VehicleModelFactoryInterface> CreateModelFactory() = 0;
 
-  std::unique_ptr<routing::IRouter> CreateRouter(std::string const & name);
+  std::unique_ptr<routing::IndexRouter> CreateRouter(std::string const & name);
   void GetNearestEdges(m2::PointD const & pt,
                        std::vector<std::pair<routing::Edge, geometry::PointWithAltitude>> & edges);
 
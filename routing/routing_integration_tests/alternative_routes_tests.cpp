@@ -0,0 +1,155 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_integration_tests/routing_test_tools.hpp"
+
+#include "routing/checkpoints.hpp"
+#include "routing/index_router.hpp"
+#include "routing/route.hpp"
+#include "routing/router_delegate.hpp"
+#include "routing/routing_callbacks.hpp"
+#include "routing/segment.hpp"
+
+#include "geometry/mercator.hpp"
+
+#include <map>
+#include <vector>
+
+namespace alternative_routes_tests
+{
+using namespace routing;
+using namespace std;
+
+// Sharing and stretch are computed by the router with the weights and the lengths of the segments
+// before the route is redressed, so they are checked with some tolerance.
+double constexpr kTimeEpsSec = 1.0;
+double constexpr kLengthEpsM = 1.0;
+
+// A route across the center of Moscow, there are several ways with similar ETA.
+ms::LatLon const kStart(55.75100, 37.61790);
+ms::LatLon const kFinish(55.80212, 37.52769);
+
+struct AlternativesResult
+{
+  RouterResultCode m_code = RouterResultCode::InternalError;
+  Route m_route = Route("mapsme", 0 /* routeId */);
+  vector<Route> m_alternatives;
+};
+
+AlternativesResult CalculateRouteWithAlternatives(IndexRouter::AlternativesParams const & params)
+{
+  auto & router =
+      dynamic_cast<IndexRouter &>(integration::GetVehicleComponents(VehicleType::Car).GetRouter());
+  RouterDelegate delegate;
+  AlternativesResult result;
+  result.m_code = router.CalculateRouteWithAlternatives(
+      Checkpoints(mercator::FromLatLon(kStart), mercator::FromLatLon(kFinish)),
+      m2::PointD::Zero() /* startDirection */, params, delegate, result.m_route,
+      result.m_alternatives);
+  return result;
+}
+
+// Returns lengths of the segments of |route|.
+map<Segment, double> GetSegmentLengths(Route const & route)
+{
+  map<Segment, double> lengths;
+  double prevDistM = 0.0;
+  for (auto const & routeSegment : route.GetRouteSegments())
+  {
+    auto const distM = routeSegment.GetDistFromBeginningMeters();
+    lengths[routeSegment.GetSegment()] += distM - prevDistM;
+    prevDistM = distM;
+  }
+  return lengths;
+}
+
+// Returns length of |route| which is shared with |other|.
+double GetSharedLength(map<Segment, double> const & route, map<Segment, double> const & other)
+{
+  double sharedM = 0.0;
+  for (auto const & [segment, lengthM] : route)
+  {
+    if (other.count(segment) != 0)
+      sharedM += lengthM;
+  }
+  return sharedM;
+}
+
+void TestAlternatives(AlternativesResult const & result,
+                      IndexRouter::AlternativesParams const & params)
+{
+  TEST_EQUAL(result.m_code, RouterResultCode::NoError, ());
+  TEST(result.m_route.IsValid(), ());
+  TEST_LESS_OR_EQUAL(result.m_alternatives.size(), params.m_maxCount, ());
+
+  double const bestTimeSec = result.m_route.GetTotalTimeSec();
+  vector<map<Segment, double>> chosen = {GetSegmentLengths(result.m_route)};
+  double prevTimeSec = bestTimeSec;
+  for (size_t i = 0; i < result.m_alternatives.size(); ++i)
+  {
+    auto const & alternative = result.m_alternatives[i];
+    TEST(alternative.IsValid(), (i));
+
+    // Alternatives go from the best one and are not longer than the stretch allows.
+    double const timeSec = alternative.GetTotalTimeSec();
+    TEST_LESS_OR_EQUAL(prevTimeSec, timeSec + kTimeEpsSec, (i));
+    TEST_LESS_OR_EQUAL(timeSec, (1.0 + params.m_maxStretch) * bestTimeSec + kTimeEpsSec, (i));
+    prevTimeSec = timeSec;
+
+    // Every alternative is different from the best route and from the alternatives before it.
+    auto lengths = GetSegmentLengths(alternative);
+    double const lengthM = alternative.GetTotalDistanceMeters();
+    for (size_t j = 0; j < chosen.size(); ++j)
+    {
+      TEST_LESS_OR_EQUAL(GetSharedLength(lengths, chosen[j]),
+                         params.m_maxSharing * lengthM + kLengthEpsM, (i, j));
+    }
+    chosen.push_back(std::move(lengths));
+  }
+}
+
+UNIT_TEST(AlternativeRoutes_Moscow)
+{
+  IndexRouter::AlternativesParams const params;
+  auto const result = CalculateRouteWithAlternatives(params);
+  TestAlternatives(result, params);
+  TEST(!result.m_alternatives.empty(), ());
+
+  // The best route is the same as without alternatives.
+  integration::TestRouteTime(
+      result.m_route,
+      integration::CalculateRoute(integration::GetVehicleComponents(VehicleType::Car),
+                                  mercator::FromLatLon(kStart), m2::PointD::Zero(),
+                                  mercator::FromLatLon(kFinish))
+          .first->GetTotalTimeSec());
+}
+
+UNIT_TEST(AlternativeRoutes_Stretch)
+{
+  // Alternatives which are longer than the stretch allows are dropped.
+  for (double const maxStretch : {0.0, 0.05, 0.5})
+  {
+    IndexRouter::AlternativesParams params;
+    params.m_maxStretch = maxStretch;
+    params.m_maxCount = 5;
+    auto const result = CalculateRouteWithAlternatives(params);
+    TestAlternatives(result, params);
+  }
+}
+
+UNIT_TEST(AlternativeRoutes_Sharing)
+{
+  IndexRouter::AlternativesParams params;
+  params.m_maxSharing = 0.0;
+  auto const result = CalculateRouteWithAlternatives(params);
+  TestAlternatives(result, params);
+  // Every alternative shares the fake segments from the start and to the finish with the best
+  // route.
+  TEST(result.m_alternatives.empty(), ());
+
+  IndexRouter::AlternativesParams noAlternatives;
+  noAlternatives.m_maxCount = 0;
+  auto const single = CalculateRouteWithAlternatives(noAlternatives);
+  TestAlternatives(single, noAlternatives);
+  TEST(single.m_alternatives.empty(), ());
+}
+}  // namespace alternative_routes_tests
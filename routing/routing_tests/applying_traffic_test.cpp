@@ -8,6 +8,7 @@
 #include "routing/geometry.hpp"
 #include "routing/index_graph.hpp"
 #include "routing/index_graph_starter.hpp"
+#include "routing/live_speeds.hpp"
 #include "routing/routing_session.hpp"
 #include "routing/traffic_stash.hpp"
 
@@ -153,6 +154,28 @@ UNIT_CLASS_TEST(ApplyingTrafficTest, XXGraph_G0onF3)
   TestRouteGeometry(*starter, Algorithm::Result::OK, expectedGeom);
 }
 
+// Route through XX graph with measured speeds on F7, F8 and F4 which are faster than F3.
+UNIT_CLASS_TEST(ApplyingTrafficTest, XXGraph_LiveSpeedsOnF7andF8andF4)
+{
+  LiveSpeeds::MwmSpeeds speeds;
+  for (uint32_t const featureId : {4, 7, 8})
+  {
+    speeds.m_keys.push_back(LiveSpeeds::MakeKey(featureId, 0 /* segmentIdx */, true /* isForward */));
+    speeds.m_speedsKMpH.push_back(100);
+  }
+  auto liveSpeeds = make_shared<LiveSpeeds>();
+  liveSpeeds->SetMwmSpeeds(kTestNumMwmId, std::move(speeds));
+  GetEstimator()->SetLiveSpeeds(liveSpeeds);
+
+  unique_ptr<WorldGraph> graph = BuildXXGraph(GetEstimator());
+  auto const start =
+      MakeFakeEnding(9 /* featureId */, 0 /* segmentIdx */, m2::PointD(2.0, -1.0), *graph);
+  auto const finish = MakeFakeEnding(6, 0, m2::PointD(3.0, 3.0), *graph);
+  auto starter = MakeStarter(start, finish, *graph);
+  vector<m2::PointD> const expectedGeom = {{2 /* x */, -1 /* y */}, {2, 0}, {3, 0}, {3, 1}, {2, 2}, {3, 3}};
+  TestRouteGeometry(*starter, Algorithm::Result::OK, expectedGeom);
+}
+
 // Route through XX graph with SpeedGroup::TempBlock on F3.
 UNIT_CLASS_TEST(ApplyingTrafficTest, XXGraph_TempBlockonF3)
 {
@@ -80,6 +80,97 @@ UNIT_TEST(AStarAlgorithm_CheckLength)
   TEST_EQUAL(result, Algorithm::Result::NoPath, ());
 }
 
+UNIT_TEST(AStarAlgorithm_Alternatives)
+{
+  UndirectedGraph graph;
+
+  // Inserts edges in a format: <source, target, weight>.
+  graph.AddEdge(0, 1, 10);
+  graph.AddEdge(1, 4, 10);
+  graph.AddEdge(0, 2, 8);
+  graph.AddEdge(2, 3, 8);
+  graph.AddEdge(3, 4, 8);
+
+  Algorithm algo;
+  Algorithm::ParamsForTests<> params(graph, 0u /* startVertex */, 4u /* finishVertex */);
+
+  vector<RoutingResult<unsigned /* Vertex */, double /* Weight */>> results;
+  TEST_EQUAL(algo.FindPathBidirectionalWithAlternatives(params, 0.3 /* maxStretch */,
+                                                        3 /* maxCount */, results),
+             Algorithm::Result::OK, ());
+  TEST_EQUAL(results.size(), 2, ());
+  TEST_EQUAL(results[0].m_path, vector<unsigned>({0, 1, 4}), ());
+  TEST_ALMOST_EQUAL_ULPS(results[0].m_distance, 20.0, ());
+  TEST_EQUAL(results[1].m_path, vector<unsigned>({0, 2, 3, 4}), ());
+  TEST_ALMOST_EQUAL_ULPS(results[1].m_distance, 24.0, ());
+
+  // 0 -> 2 -> 3 -> 4 is 20% longer than the best path.
+  TEST_EQUAL(algo.FindPathBidirectionalWithAlternatives(params, 0.1 /* maxStretch */,
+                                                        3 /* maxCount */, results),
+             Algorithm::Result::OK, ());
+  TEST_EQUAL(results.size(), 1, ());
+  TEST_EQUAL(results[0].m_path, vector<unsigned>({0, 1, 4}), ());
+
+  Algorithm::ParamsForTests<> noPathParams(graph, 0u /* startVertex */, 5u /* finishVertex */);
+  TEST_EQUAL(algo.FindPathBidirectionalWithAlternatives(noPathParams, 0.3 /* maxStretch */,
+                                                        3 /* maxCount */, results),
+             Algorithm::Result::NoPath, ());
+  TEST(results.empty(), ());
+}
+
+// Directed graph: the forward wave goes by the outgoing edges and the backward one by the
+// ingoing edges, so the waves may cover different parts of the graph.
+class OneWayGraph : public AStarGraph<uint32_t, SimpleEdge, double>
+{
+public:
+  void AddEdge(Vertex from, Vertex to, Weight w) { m_graph.AddEdge(from, to, w); }
+
+  // AStarGraph overrides
+  // @{
+  void GetOutgoingEdgesList(astar::VertexData<Vertex, Weight> const & vertexData,
+                            EdgeListT & adj) override
+  {
+    m_graph.GetEdgesList(vertexData.m_vertex, true /* isOutgoing */, adj);
+  }
+
+  void GetIngoingEdgesList(astar::VertexData<Vertex, Weight> const & vertexData,
+                           EdgeListT & adj) override
+  {
+    m_graph.GetEdgesList(vertexData.m_vertex, false /* isOutgoing */, adj);
+  }
+
+  double HeuristicCostEstimate(Vertex const & /* from */, Vertex const & /* to */) override
+  {
+    return 0.0;
+  }
+  // @}
+
+private:
+  DirectedGraph m_graph;
+};
+
+UNIT_TEST(AStarAlgorithm_AlternativesOneWaveExhausted)
+{
+  OneWayGraph graph;
+  graph.AddEdge(0, 1, 1);
+  graph.AddEdge(1, 2, 1);
+  // Dead ends reachable from the start only. The backward wave is exhausted after 0 -> 1 -> 2,
+  // the forward one goes on for more than several queue switch periods within the stretch.
+  for (uint32_t v = 100; v < 1100; ++v)
+    graph.AddEdge(0, v, 1);
+
+  Algorithm algo;
+  Algorithm::ParamsForTests<> params(graph, 0u /* startVertex */, 2u /* finishVertex */);
+
+  vector<RoutingResult<unsigned /* Vertex */, double /* Weight */>> results;
+  TEST_EQUAL(algo.FindPathBidirectionalWithAlternatives(params, 1.0 /* maxStretch */,
+                                                        3 /* maxCount */, results),
+             Algorithm::Result::OK, ());
+  TEST_EQUAL(results.size(), 1, ());
+  TEST_EQUAL(results[0].m_path, vector<unsigned>({0, 1, 2}), ());
+  TEST_ALMOST_EQUAL_ULPS(results[0].m_distance, 2.0, ());
+}
+
 UNIT_TEST(AdjustRoute)
 {
   UndirectedGraph graph;
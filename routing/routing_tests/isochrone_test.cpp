@@ -0,0 +1,137 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_tests/index_graph_tools.hpp"
+
+#include "routing/fake_ending.hpp"
+#include "routing/index_graph_starter.hpp"
+#include "routing/isochrone.hpp"
+#include "routing/segment.hpp"
+
+#include "traffic/traffic_cache.hpp"
+
+#include "indexer/classificator_loader.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "base/cancellable.hpp"
+#include "base/math.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace isochrone_test
+{
+using namespace routing;
+using namespace routing_test;
+using namespace std;
+
+//               *
+//               |
+//               F2
+// Start         |
+// *--F0--*--F0--*--F0--*
+//        |
+//        F1
+//        |
+//        *
+unique_ptr<WorldGraph> BuildGraph()
+{
+  auto loader = make_unique<TestGeometryLoader>();
+  loader->AddRoad(0 /* featureId */, false /* oneWay */, 10.0 /* speed */,
+                  RoadGeometry::Points({{0.0, 0.0}, {0.01, 0.0}, {0.02, 0.0}, {0.03, 0.0}}));
+  loader->AddRoad(1 /* featureId */, false /* oneWay */, 10.0 /* speed */,
+                  RoadGeometry::Points({{0.01, 0.0}, {0.01, -0.01}}));
+  loader->AddRoad(2 /* featureId */, false /* oneWay */, 10.0 /* speed */,
+                  RoadGeometry::Points({{0.02, 0.0}, {0.02, 0.01}}));
+
+  vector<Joint> const joints = {
+      MakeJoint({{0 /* feature id */, 0 /* point id */}}), /* joint at point (0, 0) */
+      MakeJoint({{0, 1}, {1, 0}}),                         /* joint at point (0.01, 0) */
+      MakeJoint({{0, 2}, {2, 0}}),                         /* joint at point (0.02, 0) */
+      MakeJoint({{0, 3}}),                                 /* joint at point (0.03, 0) */
+      MakeJoint({{1, 1}}),                                 /* joint at point (0.01, -0.01) */
+      MakeJoint({{2, 1}}),                                 /* joint at point (0.02, 0.01) */
+  };
+
+  traffic::TrafficCache const trafficCache;
+  return BuildWorldGraph(std::move(loader), CreateEstimatorForCar(trafficCache), joints);
+}
+
+Isochrone CalcIsochrone(WorldGraph & graph, double maxTimeS)
+{
+  auto const start =
+      MakeFakeEnding(0 /* featureId */, 0 /* segmentIdx */, m2::PointD(0.0, 0.0), graph);
+  auto starter = MakeStarter(start, FakeEnding() /* finish */, graph);
+
+  base::Cancellable const cancellable;
+  Isochrone isochrone;
+  TEST_EQUAL(CalculateIsochrone(*starter, maxTimeS, true /* buildOutline */, cancellable, isochrone),
+             RouterResultCode::NoError, ());
+  return isochrone;
+}
+
+optional<double> GetArrivalTime(Isochrone const & isochrone, Segment const & segment)
+{
+  auto const it = find_if(isochrone.m_segments.cbegin(), isochrone.m_segments.cend(),
+                          [&segment](auto const & reached) { return reached.m_segment == segment; });
+  if (it == isochrone.m_segments.cend())
+    return {};
+  return it->m_arrivalTimeS;
+}
+
+UNIT_TEST(Isochrone_BoundedByTime)
+{
+  classificator::Load();
+  auto graph = BuildGraph();
+
+  Segment const first(kTestNumMwmId, 0 /* featureId */, 0 /* segmentIdx */, true /* forward */);
+  Segment const second(kTestNumMwmId, 0, 1, true);
+  Segment const third(kTestNumMwmId, 0, 2, true);
+  Segment const branch(kTestNumMwmId, 1, 0, true);
+
+  auto const all = CalcIsochrone(*graph, 1e9 /* maxTimeS */);
+  TEST(is_sorted(all.m_segments.cbegin(), all.m_segments.cend(),
+                 [](auto const & lhs, auto const & rhs) { return lhs.m_segment < rhs.m_segment; }),
+       ());
+
+  auto const firstTime = GetArrivalTime(all, first);
+  auto const secondTime = GetArrivalTime(all, second);
+  auto const thirdTime = GetArrivalTime(all, third);
+  auto const branchTime = GetArrivalTime(all, branch);
+  TEST(firstTime && secondTime && thirdTime && branchTime, ());
+  TEST_LESS(*firstTime, *secondTime, ());
+  TEST_LESS(*secondTime, *thirdTime, ());
+  TEST_LESS(*firstTime, *branchTime, ());
+  // The ends of F0, F1 and F2 are the farthest points in their directions from the start.
+  TEST_EQUAL(all.m_outline.size(), 3, ());
+
+  double const maxTimeS = (*secondTime + *thirdTime) / 2.0;
+  auto const bounded = CalcIsochrone(*graph, maxTimeS);
+  TEST(GetArrivalTime(bounded, second), ());
+  TEST(!GetArrivalTime(bounded, third), ());
+  TEST_LESS(bounded.m_segments.size(), all.m_segments.size(), ());
+  for (auto const & reached : bounded.m_segments)
+  {
+    TEST_LESS_OR_EQUAL(reached.m_arrivalTimeS, maxTimeS, ());
+    TEST(base::AlmostEqualAbs(reached.m_arrivalTimeS, *GetArrivalTime(all, reached.m_segment), 1e-6),
+         (reached.m_segment));
+  }
+}
+
+UNIT_TEST(Isochrone_Outline)
+{
+  m2::PointD const center(1.0, 1.0);
+  vector<m2::PointD> const points = {{2.0, 1.5}, {1.5, 1.1}, {0.5, 3.0}, {0.0, 0.5},
+                                     {1.2, 0.5}, {1.5, 0.0}, center};
+
+  TEST_EQUAL(MakeReachabilityOutline(center, points, 4 /* sectorsCount */),
+             vector<m2::PointD>({{2.0, 1.5}, {0.5, 3.0}, {0.0, 0.5}, {1.5, 0.0}}), ());
+
+  // Only two sectors are not empty.
+  TEST(MakeReachabilityOutline(center, {{2.0, 1.5}, {0.0, 0.5}, center}, 4 /* sectorsCount */)
+           .empty(),
+       ());
+}
+}  // namespace isochrone_test
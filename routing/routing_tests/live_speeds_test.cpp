@@ -0,0 +1,91 @@
+#include "testing/testing.hpp"
+
+#include "routing/live_speeds.hpp"
+
+#include "routing_common/num_mwm_id.hpp"
+
+#include "platform/country_file.hpp"
+#include "platform/platform_tests_support/scoped_dir.hpp"
+#include "platform/platform_tests_support/scoped_file.hpp"
+
+#include "base/file_name_utils.hpp"
+
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace live_speeds_test
+{
+using namespace platform::tests_support;
+using namespace routing;
+using namespace std;
+
+string const kSpeedsDir = "live_speeds_test";
+string const kCountry = "Country";
+
+shared_ptr<NumMwmIds> MakeNumMwmIds()
+{
+  auto numMwmIds = make_shared<NumMwmIds>();
+  numMwmIds->RegisterFile(platform::CountryFile(kCountry));
+  return numMwmIds;
+}
+
+string GetSpeedsFile(string const & country)
+{
+  return base::JoinPath(kSpeedsDir, country + ".speeds");
+}
+
+UNIT_TEST(LiveSpeeds_LoadFromDirectory)
+{
+  ScopedDir const dir(kSpeedsDir);
+  ScopedFile const speeds(GetSpeedsFile(kCountry), "# feature segment forward speed\n"
+                                                   "10 0 1 45.4\n"
+                                                   "10 0 0 30\n"
+                                                   "7 2 1 300\n"
+                                                   "broken line\n"
+                                                   "10 0 1 50\n");
+  ScopedFile const unknownMwm(GetSpeedsFile("Unknown"), "1 0 1 60\n");
+
+  auto const numMwmIds = MakeNumMwmIds();
+  auto const mwmId = numMwmIds->GetId(platform::CountryFile(kCountry));
+  LiveSpeedsSource source(numMwmIds);
+  TEST_EQUAL(source.GetSnapshot()->GetSegmentsCount(), 0, ());
+
+  auto const stats = source.UpdateFromDirectory(dir.GetFullPath());
+  TEST_EQUAL(stats.m_mwmsCount, 1, ());
+  TEST_EQUAL(stats.m_segmentsCount, 3, ());
+  TEST_EQUAL(stats.m_memoryBytes, 3 * (sizeof(uint64_t) + sizeof(uint8_t)), ());
+
+  auto const snapshot = source.GetSnapshot();
+  TEST(snapshot->Has(mwmId), ());
+  // The last speed of a segment is used.
+  TEST(snapshot->GetSpeedKMpH(Segment(mwmId, 10, 0, true /* forward */)) == 50.0, ());
+  TEST(snapshot->GetSpeedKMpH(Segment(mwmId, 10, 0, false /* forward */)) == 30.0, ());
+  TEST(snapshot->GetSpeedKMpH(Segment(mwmId, 7, 2, true /* forward */)) == 255.0, ());
+  TEST(!snapshot->GetSpeedKMpH(Segment(mwmId, 7, 1, true /* forward */)), ());
+  TEST(!snapshot->GetSpeedKMpH(Segment(mwmId + 1, 10, 0, true /* forward */)), ());
+}
+
+UNIT_TEST(LiveSpeeds_SnapshotSwap)
+{
+  ScopedDir const dir(kSpeedsDir);
+  auto const numMwmIds = MakeNumMwmIds();
+  auto const mwmId = numMwmIds->GetId(platform::CountryFile(kCountry));
+  Segment const segment(mwmId, 1 /* featureId */, 0 /* segmentIdx */, true /* forward */);
+  LiveSpeedsSource source(numMwmIds);
+
+  shared_ptr<LiveSpeeds const> oldSnapshot;
+  {
+    ScopedFile const speeds(GetSpeedsFile(kCountry), "1 0 1 20\n");
+    source.UpdateFromDirectory(dir.GetFullPath());
+    oldSnapshot = source.GetSnapshot();
+  }
+
+  ScopedFile const speeds(GetSpeedsFile(kCountry), "1 0 1 80\n");
+  source.UpdateFromDirectory(dir.GetFullPath());
+
+  // A route which is being built keeps its snapshot.
+  TEST(oldSnapshot->GetSpeedKMpH(segment) == 20.0, ());
+  TEST(source.GetSnapshot()->GetSpeedKMpH(segment) == 80.0, ());
+}
+}  // namespace live_speeds_test
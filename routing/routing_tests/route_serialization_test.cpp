@@ -0,0 +1,286 @@
+#include "testing/testing.hpp"
+
+#include "routing/fake_feature_ids.hpp"
+#include "routing/route.hpp"
+#include "routing/route_serialization.hpp"
+#include "routing/routing_helpers.hpp"
+#include "routing/turns.hpp"
+
+#include "routing_common/maxspeed_conversion.hpp"
+
+#include "traffic/speed_groups.hpp"
+
+#include "geometry/point2d.hpp"
+#include "geometry/point_with_altitude.hpp"
+
+#include "base/math.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace route_serialization_test
+{
+using namespace routing;
+using namespace std;
+
+double constexpr kPointEps = 1e-6;
+double constexpr kTimeEps = 1e-3;
+
+// Route of |pointsCount| points with two subroutes. Every tenth segment has a turn and
+// street names are repeated along the route.
+Route MakeRoute(size_t pointsCount)
+{
+  CHECK_GREATER(pointsCount, 3, ());
+  size_t const segmentsCount = pointsCount - 1;
+
+  vector<geometry::PointWithAltitude> junctions;
+  for (size_t i = 0; i < pointsCount; ++i)
+  {
+    junctions.emplace_back(m2::PointD(37.5 + 1e-4 * i, 67.4 + 3e-5 * (i % 7)),
+                           static_cast<geometry::Altitude>(150 + i % 11));
+  }
+
+  vector<string> const streets = {"Tverskaya street", "Garden Ring", "Leningradsky avenue"};
+
+  vector<RouteSegment> routeSegments;
+  vector<double> times;
+  for (size_t i = 0; i < segmentsCount; ++i)
+  {
+    bool const isFake = i == 0 || i + 1 == segmentsCount;
+    Segment const segment(isFake ? kFakeNumMwmId : 3,
+                          isFake ? FakeFeatureIds::kIndexGraphStarterId
+                                 : static_cast<uint32_t>(100 + i / 5),
+                          static_cast<uint32_t>(i % 5), i % 2 == 0);
+
+    turns::TurnItem turn;
+    if (i % 10 == 9)
+    {
+      turn = turns::TurnItem(static_cast<uint32_t>(i + 1), turns::CarDirection::TurnLeft);
+      turn.m_lanes = {{turns::LaneWay::Left}, {turns::LaneWay::Through, turns::LaneWay::Right}};
+      turn.m_lanes.front().m_isRecommended = true;
+    }
+    if (i + 1 == segmentsCount)
+      turn = turns::TurnItem(static_cast<uint32_t>(i + 1), turns::CarDirection::ReachedYourDestination);
+
+    RouteSegment::RoadNameInfo rni;
+    if (!isFake)
+      rni.m_name = streets[(i / 10) % streets.size()];
+    if (i == 5)
+    {
+      rni.m_ref = "M10";
+      rni.m_junction_ref = "398B";
+      rni.m_destination_ref = "CA 85";
+      rni.m_destination = "Cupertino";
+      rni.m_isLink = true;
+    }
+
+    auto & routeSegment = routeSegments.emplace_back(segment, turn, junctions[i + 1], rni);
+    if (i % 3 == 0)
+      routeSegment.SetSpeedLimit(SpeedInUnits(60, measurement_utils::Units::Metric));
+    if (i == 7)
+      routeSegment.SetSpeedCameraInfo({{0.25, 60}, {0.75, 40}});
+    routeSegment.SetTraffic(i / 20 == 1 ? traffic::SpeedGroup::G2 : traffic::SpeedGroup::Unknown);
+    routeSegment.SetRoadTypes(RoutingOptions(static_cast<RoutingOptions::RoadType>(
+        (i / 5) % 2 == 0 ? RoutingOptions::Road::Usual : RoutingOptions::Road::Toll)));
+
+    times.push_back(1.5 * static_cast<double>(i + 1));
+  }
+  FillSegmentInfo(times, routeSegments);
+
+  Route route("test-router", 0 /* routeId */);
+  route.SetRouteSegments(std::move(routeSegments));
+
+  vector<m2::PointD> points;
+  for (auto const & junction : junctions)
+    points.push_back(junction.GetPoint());
+  route.SetGeometry(points.cbegin(), points.cend());
+
+  size_t const middle = segmentsCount / 2;
+  route.SetSubroteAttrs(vector<Route::SubrouteAttrs>(
+      {Route::SubrouteAttrs(junctions.front(), junctions[middle], 0, middle),
+       Route::SubrouteAttrs(junctions[middle], junctions.back(), middle, segmentsCount)}));
+  return route;
+}
+
+void TestEqualPoints(geometry::PointWithAltitude const & lhs, geometry::PointWithAltitude const & rhs)
+{
+  TEST(base::AlmostEqualAbs(lhs.GetPoint(), rhs.GetPoint(), kPointEps), (lhs, rhs));
+  TEST_EQUAL(lhs.GetAltitude(), rhs.GetAltitude(), (lhs, rhs));
+}
+
+void TestEqualRoutes(Route const & expected, Route const & actual)
+{
+  auto const & expectedPoints = expected.GetPoly().GetPoints();
+  auto const & actualPoints = actual.GetPoly().GetPoints();
+  TEST_EQUAL(expectedPoints.size(), actualPoints.size(), ());
+  for (size_t i = 0; i < expectedPoints.size(); ++i)
+    TEST(base::AlmostEqualAbs(expectedPoints[i], actualPoints[i], kPointEps), (i));
+
+  TEST_EQUAL(expected.HaveAltitudes(), actual.HaveAltitudes(), ());
+  TEST(base::AlmostEqualAbs(expected.GetTotalDistanceMeters(), actual.GetTotalDistanceMeters(), 1.0),
+       ());
+  TEST(base::AlmostEqualAbs(expected.GetTotalTimeSec(), actual.GetTotalTimeSec(), kTimeEps), ());
+
+  auto const & expectedSegments = expected.GetRouteSegments();
+  auto const & actualSegments = actual.GetRouteSegments();
+  TEST_EQUAL(expectedSegments.size(), actualSegments.size(), ());
+  for (size_t i = 0; i < expectedSegments.size(); ++i)
+  {
+    auto const & lhs = expectedSegments[i];
+    auto const & rhs = actualSegments[i];
+    TEST_EQUAL(lhs.GetSegment(), rhs.GetSegment(), (i));
+    TEST_EQUAL(lhs.GetTurn(), rhs.GetTurn(), (i));
+    TestEqualPoints(lhs.GetJunction(), rhs.GetJunction());
+
+    auto const & lhsNames = lhs.GetRoadNameInfo();
+    auto const & rhsNames = rhs.GetRoadNameInfo();
+    TEST_EQUAL(lhsNames.m_name, rhsNames.m_name, (i));
+    TEST_EQUAL(lhsNames.m_ref, rhsNames.m_ref, (i));
+    TEST_EQUAL(lhsNames.m_junction_ref, rhsNames.m_junction_ref, (i));
+    TEST_EQUAL(lhsNames.m_destination_ref, rhsNames.m_destination_ref, (i));
+    TEST_EQUAL(lhsNames.m_destination, rhsNames.m_destination, (i));
+    TEST_EQUAL(lhsNames.m_isLink, rhsNames.m_isLink, (i));
+
+    TEST_EQUAL(lhs.GetSpeedLimit(), rhs.GetSpeedLimit(), (i));
+    TEST_EQUAL(lhs.GetTraffic(), rhs.GetTraffic(), (i));
+    TEST_EQUAL(lhs.GetRoadTypes().GetOptions(), rhs.GetRoadTypes().GetOptions(), (i));
+    TEST(base::AlmostEqualAbs(lhs.GetTimeFromBeginningSec(), rhs.GetTimeFromBeginningSec(), kTimeEps),
+         (i));
+    TEST(base::AlmostEqualAbs(lhs.GetDistFromBeginningMeters(), rhs.GetDistFromBeginningMeters(), 1.0),
+         (i));
+
+    TEST_EQUAL(lhs.GetSpeedCams().size(), rhs.GetSpeedCams().size(), (i));
+    for (size_t j = 0; j < lhs.GetSpeedCams().size(); ++j)
+    {
+      auto const & lhsCamera = lhs.GetSpeedCams()[j];
+      auto const & rhsCamera = rhs.GetSpeedCams()[j];
+      TEST(base::AlmostEqualAbs(lhsCamera.m_coef, rhsCamera.m_coef, 1e-4), (i, j));
+      TEST_EQUAL(lhsCamera.m_maxSpeedKmPH, rhsCamera.m_maxSpeedKmPH, (i, j));
+    }
+  }
+
+  auto const & expectedSubroutes = expected.GetSubroutes();
+  auto const & actualSubroutes = actual.GetSubroutes();
+  TEST_EQUAL(expectedSubroutes.size(), actualSubroutes.size(), ());
+  for (size_t i = 0; i < expectedSubroutes.size(); ++i)
+  {
+    TEST_EQUAL(expectedSubroutes[i].GetBeginSegmentIdx(), actualSubroutes[i].GetBeginSegmentIdx(), ());
+    TEST_EQUAL(expectedSubroutes[i].GetEndSegmentIdx(), actualSubroutes[i].GetEndSegmentIdx(), ());
+    TestEqualPoints(expectedSubroutes[i].GetStart(), actualSubroutes[i].GetStart());
+    TestEqualPoints(expectedSubroutes[i].GetFinish(), actualSubroutes[i].GetFinish());
+  }
+}
+
+UNIT_TEST(RouteSerialization_RoundTrip)
+{
+  auto const route = MakeRoute(100 /* pointsCount */);
+  TEST(route.HaveAltitudes(), ());
+
+  vector<uint8_t> buffer;
+  RouteSerializer::Serialize(route, buffer);
+
+  SerializedRoute const serialized(buffer.data(), buffer.size());
+  TEST_EQUAL(serialized.GetPointsCount(), 100, ());
+  TEST_EQUAL(serialized.GetSegmentsCount(), 99, ());
+  TEST_EQUAL(serialized.GetSubroutesCount(), 2, ());
+  TEST(serialized.HasAltitudes(), ());
+  TEST_EQUAL(serialized.GetRouterId(), "test-router", ());
+  TEST_EQUAL(serialized.GetTotalDistanceMeters(), route.GetTotalDistanceMeters(), ());
+  TEST_EQUAL(serialized.GetTotalTimeSec(), route.GetTotalTimeSec(), ());
+  // Empty string, router id, three streets and four strings of the link.
+  TEST_EQUAL(serialized.GetStringsCount(), 9, ());
+
+  Route actual(string(serialized.GetRouterId()), 0 /* routeId */);
+  serialized.ToRoute(actual);
+  TestEqualRoutes(route, actual);
+
+  // The whole route is at least twice smaller than the polyline and the times and the distances
+  // of the segments dumped as doubles.
+  size_t const rawSize = route.GetPoly().GetSize() * sizeof(m2::PointD) +
+                         route.GetRouteSegments().size() * 2 * sizeof(double);
+  TEST_LESS(buffer.size() * 2, rawSize, (buffer.size()));
+}
+
+UNIT_TEST(RouteSerialization_ForEachSegment)
+{
+  auto const route = MakeRoute(20 /* pointsCount */);
+
+  vector<uint8_t> buffer;
+  RouteSerializer::Serialize(route, buffer);
+  SerializedRoute const serialized(buffer.data(), buffer.size());
+
+  auto const & routeSegments = route.GetRouteSegments();
+  size_t i = 0;
+  serialized.ForEachSegment([&](SerializedRoute::SegmentInfo const & info) {
+    TEST_LESS(i, routeSegments.size(), ());
+    TEST_EQUAL(info.m_segment, routeSegments[i].GetSegment(), ());
+    TEST_EQUAL(info.m_name, routeSegments[i].GetRoadNameInfo().m_name, ());
+    // Names are not copied out of the buffer.
+    if (!info.m_name.empty())
+    {
+      auto const * data = reinterpret_cast<char const *>(buffer.data());
+      TEST(info.m_name.data() >= data && info.m_name.data() < data + buffer.size(), ());
+    }
+    ++i;
+  });
+  TEST_EQUAL(i, routeSegments.size(), ());
+}
+
+UNIT_TEST(RouteSerialization_NoAltitudes)
+{
+  Route route("test-router", 0 /* routeId */);
+  vector<m2::PointD> const points = {{0.0, 0.0}, {0.001, 0.0}, {0.001, 0.001}};
+  vector<RouteSegment> routeSegments;
+  for (size_t i = 1; i < points.size(); ++i)
+  {
+    routeSegments.emplace_back(Segment(0, 0, static_cast<uint32_t>(i - 1), true), turns::TurnItem(),
+                               geometry::PointWithAltitude(points[i], geometry::kInvalidAltitude),
+                               RouteSegment::RoadNameInfo());
+  }
+  FillSegmentInfo({10.0, 20.0}, routeSegments);
+  route.SetRouteSegments(std::move(routeSegments));
+  route.SetGeometry(points.cbegin(), points.cend());
+  TEST(!route.HaveAltitudes(), ());
+
+  vector<uint8_t> buffer;
+  RouteSerializer::Serialize(route, buffer);
+  SerializedRoute const serialized(buffer.data(), buffer.size());
+  TEST(!serialized.HasAltitudes(), ());
+  TEST_EQUAL(serialized.GetSubroutesCount(), 0, ());
+
+  Route actual(string(serialized.GetRouterId()), 0 /* routeId */);
+  serialized.ToRoute(actual);
+  TestEqualRoutes(route, actual);
+}
+
+bool IsCorrupted(vector<uint8_t> const & buffer, size_t size)
+{
+  try
+  {
+    SerializedRoute const serialized(buffer.data(), size);
+  }
+  catch (CorruptedDataException const &)
+  {
+    return true;
+  }
+  return false;
+}
+
+UNIT_TEST(RouteSerialization_Corrupted)
+{
+  auto const route = MakeRoute(10 /* pointsCount */);
+  vector<uint8_t> buffer;
+  RouteSerializer::Serialize(route, buffer);
+
+  auto wrongVersion = buffer;
+  wrongVersion[0] = RouteSerializer::kVersion + 1;
+  TEST(IsCorrupted(wrongVersion, wrongVersion.size()), ());
+
+  // Header is truncated.
+  TEST_ANY_THROW(SerializedRoute(buffer.data(), 10), ());
+
+  // Offsets of the sections point beyond the buffer.
+  TEST(IsCorrupted(buffer, buffer.size() / 2), ());
+}
+}  // namespace route_serialization_test
@@ -0,0 +1,236 @@
+#include "testing/testing.hpp"
+
+#include "generator/generator_tests_support/routing_helpers.hpp"
+
+#include "routing/routing_tests/index_graph_tools.hpp"
+
+#include "routing/base/astar_algorithm.hpp"
+#include "routing/fake_ending.hpp"
+#include "routing/index_graph.hpp"
+#include "routing/index_graph_starter.hpp"
+#include "routing/speed_profiles.hpp"
+#include "routing/speed_profiles_serialization.hpp"
+#include "routing/traffic_stash.hpp"
+
+#include "traffic/traffic_cache.hpp"
+
+#include "indexer/classificator_loader.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "platform/measurement_utils.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <optional>
+#include <set>
+#include <vector>
+
+namespace speed_profiles_test
+{
+using namespace routing;
+using namespace routing_test;
+using namespace std;
+
+uint32_t constexpr kHour = 60 * 60;
+
+SpeedProfiles::Profile MakeProfile(uint8_t daySpeed, uint8_t rushHourSpeed)
+{
+  SpeedProfiles::Profile profile;
+  profile.fill(daySpeed);
+  // Rush hour is 8:00 - 9:00.
+  for (size_t bucket = 8 * 4; bucket < 9 * 4; ++bucket)
+    profile[bucket] = rushHourSpeed;
+  return profile;
+}
+
+SpeedProfiles SerializeAndDeserialize(SpeedProfilesSerializer::KeyToProfile const & keyToProfile,
+                                      size_t & size)
+{
+  vector<uint8_t> buffer;
+  MemWriter<vector<uint8_t>> writer(buffer);
+  SpeedProfilesSerializer::Serialize(keyToProfile, writer);
+  size = buffer.size();
+
+  MemReader reader(buffer.data(), buffer.size());
+  ReaderSource<MemReader> src(reader);
+  SpeedProfiles speedProfiles;
+  SpeedProfilesSerializer::Deserialize(src, speedProfiles);
+  TEST_EQUAL(src.Size(), 0, ());
+  return speedProfiles;
+}
+
+UNIT_TEST(SpeedProfiles_Empty)
+{
+  size_t size = 0;
+  auto const speedProfiles = SerializeAndDeserialize({}, size);
+  TEST(speedProfiles.IsEmpty(), ());
+  TEST(!speedProfiles.GetSpeedKMpH(0 /* featureId */, true /* isForward */, 0 /* timeOfDay */), ());
+}
+
+UNIT_TEST(SpeedProfiles_SerDes)
+{
+  auto const city = MakeProfile(50 /* daySpeed */, 20 /* rushHourSpeed */);
+  auto highway = MakeProfile(110 /* daySpeed */, 60 /* rushHourSpeed */);
+  highway[0] = SpeedProfiles::kNoSpeed;
+
+  SpeedProfilesSerializer::KeyToProfile const keyToProfile = {
+      {SpeedProfiles::MakeKey(1 /* featureId */, true /* isForward */), city},
+      {SpeedProfiles::MakeKey(1 /* featureId */, false /* isForward */), city},
+      {SpeedProfiles::MakeKey(7 /* featureId */, true /* isForward */), highway},
+      {SpeedProfiles::MakeKey(100500 /* featureId */, true /* isForward */), city}};
+
+  size_t size = 0;
+  auto const speedProfiles = SerializeAndDeserialize(keyToProfile, size);
+  TEST_EQUAL(speedProfiles.GetRoadsCount(), 4, ());
+  // Equal profiles are stored once.
+  TEST_EQUAL(speedProfiles.GetProfilesCount(), 2, ());
+  // Runs of equal speeds are stored instead of every bucket.
+  TEST_LESS(size, SpeedProfiles::kBucketsCount, ());
+
+  TEST(speedProfiles.GetSpeedKMpH(1, true, 12 * kHour) == 50.0, ());
+  TEST(speedProfiles.GetSpeedKMpH(1, false, 8 * kHour) == 20.0, ());
+  TEST(speedProfiles.GetSpeedKMpH(1, false, 9 * kHour - 1) == 20.0, ());
+  TEST(speedProfiles.GetSpeedKMpH(1, false, 9 * kHour) == 50.0, ());
+  TEST(speedProfiles.GetSpeedKMpH(7, true, 8 * kHour + 30 * 60) == 60.0, ());
+  TEST(speedProfiles.GetSpeedKMpH(100500, true, 8 * kHour) == 20.0, ());
+  // Times after midnight of the next day.
+  TEST(speedProfiles.GetSpeedKMpH(100500, true, 32 * kHour) == 20.0, ());
+
+  // No data for the bucket, the direction or the feature.
+  TEST(!speedProfiles.GetSpeedKMpH(7, true, 10 * 60), ());
+  TEST(!speedProfiles.GetSpeedKMpH(7, false, 12 * kHour), ());
+  TEST(!speedProfiles.GetSpeedKMpH(2, true, 12 * kHour), ());
+}
+
+//       * (0.01, 0.01)
+//    F1/ \F2
+// F3   /   \   F4
+// *-->*-F0->*-->*
+// Start           Finish
+//
+// F1 and F2 have profiles with a fast speed from 0:00 till 6:00 only.
+unique_ptr<WorldGraph> BuildNightRoadGraph(shared_ptr<TrafficStash> trafficStash)
+{
+  auto loader = make_unique<TestGeometryLoader>();
+  loader->AddRoad(0 /* featureId */, true /* oneWay */, 10.0 /* speed */,
+                  RoadGeometry::Points({{0.0, 0.0}, {0.02, 0.0}}));
+  loader->AddRoad(1 /* featureId */, true /* oneWay */, 10.0 /* speed */,
+                  RoadGeometry::Points({{0.0, 0.0}, {0.01, 0.01}}));
+  loader->AddRoad(2 /* featureId */, true /* oneWay */, 10.0 /* speed */,
+                  RoadGeometry::Points({{0.01, 0.01}, {0.02, 0.0}}));
+  loader->AddRoad(3 /* featureId */, true /* oneWay */, 10.0 /* speed */,
+                  RoadGeometry::Points({{-0.01, 0.0}, {0.0, 0.0}}));
+  loader->AddRoad(4 /* featureId */, true /* oneWay */, 10.0 /* speed */,
+                  RoadGeometry::Points({{0.02, 0.0}, {0.03, 0.0}}));
+
+  vector<Joint> const joints = {
+      MakeJoint({{3 /* feature id */, 0 /* point id */}}), /* joint at point (-0.01, 0) */
+      MakeJoint({{3, 1}, {0, 0}, {1, 0}}),                 /* joint at point (0, 0) */
+      MakeJoint({{1, 1}, {2, 0}}),                         /* joint at point (0.01, 0.01) */
+      MakeJoint({{0, 1}, {2, 1}, {4, 0}}),                 /* joint at point (0.02, 0) */
+      MakeJoint({{4, 1}}),                                 /* joint at point (0.03, 0) */
+  };
+
+  auto graph = BuildWorldGraph(std::move(loader), CreateEstimatorForCar(trafficStash), joints);
+
+  SpeedProfiles::Profile nightProfile;
+  nightProfile.fill(SpeedProfiles::kNoSpeed);
+  fill_n(nightProfile.begin(), 6 * 60 * 60 / SpeedProfiles::kBucketSeconds, 100);
+
+  SpeedProfilesSerializer::KeyToProfile keyToProfile;
+  for (uint32_t const featureId : {1, 2})
+    keyToProfile[SpeedProfiles::MakeKey(featureId, true /* isForward */)] = nightProfile;
+
+  size_t size = 0;
+  graph->GetIndexGraph(kTestNumMwmId).SetSpeedProfiles(SerializeAndDeserialize(keyToProfile, size));
+  return graph;
+}
+
+// Returns ids of real features of the route found by unidirectional A* at |departureTime|.
+set<uint32_t> FindRouteFeatures(time_t departureTime,
+                                traffic::TrafficInfo::Coloring const & coloring = {})
+{
+  traffic::TrafficCache const trafficCache;
+  auto trafficStash = make_shared<TrafficStash>(trafficCache, make_shared<NumMwmIds>());
+  trafficStash->SetColoring(kTestNumMwmId,
+                            make_shared<traffic::TrafficInfo::Coloring const>(coloring));
+  auto graph = BuildNightRoadGraph(trafficStash);
+  graph->GetIndexGraph(kTestNumMwmId).SetCurrentTimeGetter([departureTime]() {
+    return departureTime;
+  });
+
+  auto const start = MakeFakeEnding(3 /* featureId */, 0 /* segmentIdx */,
+                                    m2::PointD(-0.01, 0.0), *graph);
+  auto const finish = MakeFakeEnding(4 /* featureId */, 0 /* segmentIdx */,
+                                     m2::PointD(0.03, 0.0), *graph);
+  auto starter = MakeStarter(start, finish, *graph);
+
+  AlgorithmForWorldGraph::ParamsForTests<> params(*starter, starter->GetStartSegment(),
+                                                  starter->GetFinishSegment());
+  RoutingResult<Segment, RouteWeight> result;
+  TEST_EQUAL(AlgorithmForWorldGraph().FindPath(params, result), AlgorithmForWorldGraph::Result::OK,
+             ());
+
+  set<uint32_t> features;
+  for (auto const & segment : result.m_path)
+  {
+    if (!IndexGraphStarter::IsFakeSegment(segment))
+      features.insert(segment.GetFeatureId());
+  }
+  return features;
+}
+
+UNIT_TEST(SpeedProfiles_TimeDependentRoute)
+{
+  classificator::Load();
+
+  TEST_EQUAL(FindRouteFeatures(GetUnixtimeByDate(2021, Month::Apr, 12, 3 /* hh */, 0 /* mm */)),
+             set<uint32_t>({1, 2}), ());
+  TEST_EQUAL(FindRouteFeatures(GetUnixtimeByDate(2021, Month::Apr, 12, 12 /* hh */, 0 /* mm */)),
+             set<uint32_t>({0}), ());
+  // F1 is reached after midnight.
+  TEST_EQUAL(FindRouteFeatures(GetUnixtimeByDate(2021, Month::Apr, 12, 23 /* hh */, 55 /* mm */)),
+             set<uint32_t>({1, 2}), ());
+}
+
+UNIT_TEST(SpeedProfiles_TrafficBlock)
+{
+  classificator::Load();
+
+  // Traffic is applied to the roads with profiles too: F1 is closed, so the night road isn't used.
+  traffic::TrafficInfo::Coloring const coloring = {
+      {{1 /* feature id */, 0 /* segment id */, traffic::TrafficInfo::RoadSegmentId::kForwardDirection},
+       traffic::SpeedGroup::TempBlock}};
+  TEST_EQUAL(FindRouteFeatures(GetUnixtimeByDate(2021, Month::Apr, 12, 3 /* hh */, 0 /* mm */),
+                               coloring),
+             set<uint32_t>({0}), ());
+}
+
+UNIT_TEST(SpeedProfiles_ETA)
+{
+  classificator::Load();
+
+  traffic::TrafficCache const trafficCache;
+  auto graph = BuildNightRoadGraph(make_shared<TrafficStash>(trafficCache, make_shared<NumMwmIds>()));
+  auto & indexGraph = graph->GetIndexGraph(kTestNumMwmId);
+  indexGraph.SetCurrentTimeGetter([]() {
+    return GetUnixtimeByDate(2021, Month::Apr, 12, 5 /* hh */, 50 /* mm */);
+  });
+
+  Segment const from(kTestNumMwmId, 1 /* featureId */, 0 /* segmentIdx */, true /* forward */);
+  Segment const to(kTestNumMwmId, 2 /* featureId */, 0 /* segmentIdx */, true /* forward */);
+  double const distanceM = indexGraph.GetRoadGeometry(2).GetDistance(0);
+
+  // F2 is reached before 6:00 with the profile speed and after 6:00 with the road speed.
+  TEST_ALMOST_EQUAL_ABS(indexGraph.CalculateETA(from, to, 0.0 /* timeToFrom */),
+                        distanceM / measurement_utils::KmphToMps(100.0), 1e-6, ());
+  TEST_ALMOST_EQUAL_ABS(indexGraph.CalculateETA(from, to, kHour /* timeToFrom */),
+                        distanceM / measurement_utils::KmphToMps(10.0), 1e-6, ());
+}
+}  // namespace speed_profiles_test
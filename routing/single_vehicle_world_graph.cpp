@@ -167,13 +167,14 @@ RouteWeight SingleVehicleWorldGraph::CalcOffroadWeight(ms::LatLon const & from,
   return RouteWeight(m_estimator->CalcOffroad(from, to, purpose));
 }
 
-double SingleVehicleWorldGraph::CalculateETA(Segment const & from, Segment const & to)
+double SingleVehicleWorldGraph::CalculateETA(Segment const & from, Segment const & to,
+                                             double timeToFrom)
 {
   if (from.GetMwmId() != to.GetMwmId())
     return CalculateETAWithoutPenalty(to);
 
   auto & indexGraph = m_loader->GetIndexGraph(from.GetMwmId());
-  return indexGraph.CalculateEdgeWeight(EdgeEstimator::Purpose::ETA, true /* isOutgoing */, from, to).GetWeight();
+  return indexGraph.CalculateETA(from, to, timeToFrom);
 }
 
 double SingleVehicleWorldGraph::CalculateETAWithoutPenalty(Segment const & segment)
@@ -0,0 +1,48 @@
+#include "routing/speed_profiles.hpp"
+#include "routing/speed_profiles_serialization.hpp"
+
+#include "base/assert.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace routing
+{
+// static
+uint32_t SpeedProfiles::MakeKey(uint32_t featureId, bool isForward)
+{
+  ASSERT_LESS(featureId, 1U << 31, ());
+  return (featureId << 1) | (isForward ? 1 : 0);
+}
+
+// static
+uint32_t SpeedProfiles::GetTimeOfDay(time_t time)
+{
+  std::tm local = {};
+  localtime_r(&time, &local);
+  return static_cast<uint32_t>(local.tm_hour * 60 * 60 + local.tm_min * 60 + local.tm_sec) %
+         kSecondsInDay;
+}
+
+std::optional<double> SpeedProfiles::GetSpeedKMpH(uint32_t featureId, bool isForward,
+                                                  uint32_t timeOfDay) const
+{
+  auto const key = MakeKey(featureId, isForward);
+  auto const it = std::lower_bound(m_keys.cbegin(), m_keys.cend(), key);
+  if (it == m_keys.cend() || *it != key)
+    return {};
+
+  auto const & profile = m_profiles[m_profileIds[std::distance(m_keys.cbegin(), it)]];
+  auto const speed = profile[(timeOfDay % kSecondsInDay) / kBucketSeconds];
+  if (speed == kNoSpeed)
+    return {};
+
+  return speed;
+}
+
+void SpeedProfiles::Load(ModelReaderPtr const & reader)
+{
+  ReaderSource<ModelReaderPtr> src(reader);
+  SpeedProfilesSerializer::Deserialize(src, *this);
+}
+}  // namespace routing
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "coding/reader.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <optional>
+#include <vector>
+
+namespace routing
+{
+class SpeedProfilesSerializer;
+
+/// \brief Typical speeds of roads of an mwm by time of day.
+/// A day is split into kBucketsCount buckets of kBucketSeconds each. A profile keeps the speed
+/// of every bucket, equal profiles of different roads are stored once.
+class SpeedProfiles
+{
+  friend class SpeedProfilesSerializer;
+
+public:
+  static uint32_t constexpr kBucketSeconds = 15 * 60;
+  static uint32_t constexpr kSecondsInDay = 24 * 60 * 60;
+  static size_t constexpr kBucketsCount = kSecondsInDay / kBucketSeconds;
+  // Bucket value for a time of day without data.
+  static uint8_t constexpr kNoSpeed = 0;
+
+  // Speeds in km/h by bucket.
+  using Profile = std::array<uint8_t, kBucketsCount>;
+
+  static uint32_t MakeKey(uint32_t featureId, bool isForward);
+  /// \returns seconds since the local midnight.
+  static uint32_t GetTimeOfDay(time_t time);
+
+  bool IsEmpty() const { return m_keys.empty(); }
+  size_t GetRoadsCount() const { return m_keys.size(); }
+  size_t GetProfilesCount() const { return m_profiles.size(); }
+
+  /// \returns typical speed of feature |featureId| in the direction at |timeOfDay| seconds since
+  /// the local midnight or std::nullopt if it's unknown.
+  std::optional<double> GetSpeedKMpH(uint32_t featureId, bool isForward, uint32_t timeOfDay) const;
+
+  void Load(ModelReaderPtr const & reader);
+
+private:
+  // Sorted keys made by MakeKey() and indexes of their profiles in |m_profiles|.
+  std::vector<uint32_t> m_keys;
+  std::vector<uint32_t> m_profileIds;
+  std::vector<Profile> m_profiles;
+};
+}  // namespace routing
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "routing/speed_profiles.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+
+#include "defines.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace routing
+{
+/// \brief
+/// Section name: SPEED_PROFILES_FILE_TAG.
+/// Description: typical speeds of roads by time of day, see SpeedProfiles.
+/// Section tables:
+/// * Version
+/// * Profiles: <varint(count)> and for every profile <varint(runs count)> and runs of equal
+///   speeds <varint(run length)><speed in km/h>
+/// * Roads: <varint(count)> and for every road <varint(delta(key))><varint(profile id)>
+///   where key is made by SpeedProfiles::MakeKey()
+class SpeedProfilesSerializer
+{
+  // 0 - start version
+  using VersionT = uint16_t;
+  static VersionT constexpr kVersion = 0;
+
+public:
+  using Profile = SpeedProfiles::Profile;
+  // Profiles by SpeedProfiles::MakeKey().
+  using KeyToProfile = std::map<uint32_t, Profile>;
+
+  SpeedProfilesSerializer() = delete;
+
+  template <class Sink>
+  static void Serialize(KeyToProfile const & keyToProfile, Sink & sink)
+  {
+    // Equal profiles are stored once.
+    std::map<Profile, uint32_t> profileToId;
+    std::vector<Profile const *> profiles;
+    for (auto const & item : keyToProfile)
+    {
+      auto const res = profileToId.emplace(item.second, base::asserted_cast<uint32_t>(profiles.size()));
+      if (res.second)
+        profiles.push_back(&item.second);
+    }
+
+    WriteToSink(sink, kVersion);
+
+    WriteVarUint(sink, base::asserted_cast<uint32_t>(profiles.size()));
+    for (auto const * profile : profiles)
+      SerializeProfile(*profile, sink);
+
+    WriteVarUint(sink, base::asserted_cast<uint32_t>(keyToProfile.size()));
+    uint32_t prevKey = 0;
+    for (auto const & [key, profile] : keyToProfile)
+    {
+      // Valid, because keys of std::map are sorted and unique.
+      WriteVarUint(sink, key - prevKey);
+      prevKey = key;
+      WriteVarUint(sink, profileToId[profile]);
+    }
+  }
+
+  template <class Source>
+  static void Deserialize(Source & src, SpeedProfiles & speedProfiles)
+  {
+    auto const version = ReadPrimitiveFromSource<VersionT>(src);
+    CHECK_EQUAL(version, kVersion, ("Unknown", SPEED_PROFILES_FILE_TAG, "section version."));
+
+    auto const profilesCount = ReadVarUint<uint32_t>(src);
+    speedProfiles.m_profiles.resize(profilesCount);
+    for (auto & profile : speedProfiles.m_profiles)
+      DeserializeProfile(src, profile);
+
+    auto const roadsCount = ReadVarUint<uint32_t>(src);
+    speedProfiles.m_keys.resize(roadsCount);
+    speedProfiles.m_profileIds.resize(roadsCount);
+    uint32_t key = 0;
+    for (uint32_t i = 0; i < roadsCount; ++i)
+    {
+      key += ReadVarUint<uint32_t>(src);
+      auto const profileId = ReadVarUint<uint32_t>(src);
+      CHECK_LESS(profileId, profilesCount, ());
+      speedProfiles.m_keys[i] = key;
+      speedProfiles.m_profileIds[i] = profileId;
+    }
+  }
+
+private:
+  template <class Sink>
+  static void SerializeProfile(Profile const & profile, Sink & sink)
+  {
+    std::vector<std::pair<uint32_t, uint8_t>> runs;
+    for (auto const speed : profile)
+    {
+      if (!runs.empty() && runs.back().second == speed)
+        ++runs.back().first;
+      else
+        runs.emplace_back(1 /* length */, speed);
+    }
+
+    WriteVarUint(sink, base::asserted_cast<uint32_t>(runs.size()));
+    for (auto const & [length, speed] : runs)
+    {
+      WriteVarUint(sink, length);
+      WriteToSink(sink, speed);
+    }
+  }
+
+  template <class Source>
+  static void DeserializeProfile(Source & src, Profile & profile)
+  {
+    size_t bucket = 0;
+    auto const runsCount = ReadVarUint<uint32_t>(src);
+    for (uint32_t i = 0; i < runsCount; ++i)
+    {
+      auto const length = ReadVarUint<uint32_t>(src);
+      auto const speed = ReadPrimitiveFromSource<uint8_t>(src);
+      CHECK_LESS_OR_EQUAL(bucket + length, profile.size(), ());
+      std::fill_n(profile.begin() + bucket, length, speed);
+      bucket += length;
+    }
+    CHECK_EQUAL(bucket, profile.size(), ());
+  }
+};
+}  // namespace routing
@@ -159,9 +159,17 @@ RouteWeight TransitGraph::GetTransferPenalty(Segment const & from, Segment const
     // 3. |from| is edge, |to| is edge from another line directly connected to |from|.
     auto const it = m_transferPenaltiesPT.find(lineIdTo);
     CHECK(it != m_transferPenaltiesPT.end(), ("Segment", to, "belongs to unknown line:", lineIdTo));
-    // TODO(o.khlopkova) If we know exact start time for trip we can extract more precise headway.
-    // We need to call GetFrequency(time).
-    size_t const headwayS = it->second.GetFrequency() / 2;
+    // Waiting time is estimated at the departure time of the route, not at the time of
+    // arrival to the stop. Without timetable or trips half of the default headway is used.
+    size_t headwayS = it->second.GetFrequency() / 2;
+    if (m_departureTime && !m_timetable.IsEmpty())
+    {
+      if (auto const waitingS = m_timetable.GetWaitingTime(lineIdTo, it->second,
+                                                           edgeTo.GetStop1Id(), *m_departureTime))
+      {
+        headwayS = *waitingS;
+      }
+    }
 
     return RouteWeight(static_cast<double>(headwayS) /* weight */, 0 /* nonPassThroughCross */,
                        0 /* numAccessChanges */, 0 /* numAccessConditionalPenalties */,
@@ -190,6 +198,11 @@ set<Segment> const & TransitGraph::GetFake(Segment const & real) const
   return m_fake.GetFake(real);
 }
 
+void TransitGraph::SetDepartureTime(std::optional<time_t> departureTime)
+{
+  m_departureTime = departureTime;
+}
+
 bool TransitGraph::FindReal(Segment const & fake, Segment & real) const
 {
   return m_fake.FindReal(fake, real);
@@ -202,6 +215,7 @@ void TransitGraph::Fill(::transit::experimental::TransitData const & transitData
 
   for (auto const & line : transitData.GetLines())
     m_transferPenaltiesPT[line.GetId()] = line.GetSchedule();
+  m_timetable = transitData.GetTimetable();
 
   map<transit::StopId, LatLonWithAltitude> stopCoords;
 
@@ -19,7 +19,9 @@
 
 #include <cstdint>
 #include <map>
+#include <ctime>
 #include <memory>
+#include <optional>
 #include <set>
 #include <vector>
 
@@ -55,6 +57,8 @@ public:
   void Fill(::transit::experimental::TransitData const & transitData, Endings const & stopEndings,
             Endings const & gateEndings);
   void Fill(transit::GraphData const & transitData, Endings const & gateEndings);
+  // Makes transfer penalties of public transport depend on the timetable at |departureTime|.
+  void SetDepartureTime(std::optional<time_t> departureTime);
 
   bool IsGate(Segment const & segment) const;
   bool IsEdge(Segment const & segment) const;
@@ -112,6 +116,8 @@ private:
   std::map<Segment, ::transit::experimental::Gate> m_segmentToGatePT;
   std::map<Segment, ::transit::experimental::Stop> m_segmentToStopPT;
   std::map<::transit::TransitId, ::transit::Schedule> m_transferPenaltiesPT;
+  ::transit::experimental::Timetable m_timetable;
+  std::optional<time_t> m_departureTime;
 };
 
 void MakeGateEndings(std::vector<transit::Gate> const & gates, NumMwmId mwmId,
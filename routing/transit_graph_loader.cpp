@@ -17,6 +17,7 @@
 #include "base/timer.hpp"
 
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -25,8 +26,9 @@ namespace routing
 class TransitGraphLoaderImpl : public TransitGraphLoader
 {
 public:
-  TransitGraphLoaderImpl(MwmDataSource & dataSource, std::shared_ptr<EdgeEstimator> estimator)
-    : m_dataSource(dataSource), m_estimator(estimator)
+  TransitGraphLoaderImpl(MwmDataSource & dataSource, std::shared_ptr<EdgeEstimator> estimator,
+                         std::optional<time_t> departureTime)
+    : m_dataSource(dataSource), m_estimator(estimator), m_departureTime(departureTime)
   {
   }
 
@@ -86,6 +88,7 @@ private:
         MakeStopEndings(transitData.GetStops(), numMwmId, indexGraph, stopEndings);
 
         graph->Fill(transitData, stopEndings, gateEndings);
+        graph->SetDepartureTime(m_departureTime);
       }
       else
         CHECK(false, (transitHeaderVersion));
@@ -106,13 +109,15 @@ private:
 
   MwmDataSource & m_dataSource;
   std::shared_ptr<EdgeEstimator> m_estimator;
+  std::optional<time_t> const m_departureTime;
   std::unordered_map<NumMwmId, std::unique_ptr<TransitGraph>> m_graphs;
 };
 
 // static
-std::unique_ptr<TransitGraphLoader> TransitGraphLoader::Create(MwmDataSource & dataSource, std::shared_ptr<EdgeEstimator> estimator)
+std::unique_ptr<TransitGraphLoader> TransitGraphLoader::Create(MwmDataSource & dataSource, std::shared_ptr<EdgeEstimator> estimator,
+                                                               std::optional<time_t> departureTime)
 {
-  return std::make_unique<TransitGraphLoaderImpl>(dataSource, estimator);
+  return std::make_unique<TransitGraphLoaderImpl>(dataSource, estimator, departureTime);
 }
 
 }  // namespace routing
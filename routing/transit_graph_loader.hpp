@@ -6,7 +6,9 @@
 
 #include "routing_common/num_mwm_id.hpp"
 
+#include <ctime>
 #include <memory>
+#include <optional>
 
 namespace routing
 {
@@ -20,6 +22,8 @@ public:
   virtual TransitGraph & GetTransitGraph(NumMwmId mwmId, IndexGraph & indexGraph) = 0;
   virtual void Clear() = 0;
 
-  static std::unique_ptr<TransitGraphLoader> Create(MwmDataSource & dataSource, std::shared_ptr<EdgeEstimator> estimator);
+  /// \param departureTime if set, waiting for public transport is estimated with the timetable.
+  static std::unique_ptr<TransitGraphLoader> Create(MwmDataSource & dataSource, std::shared_ptr<EdgeEstimator> estimator,
+                                                    std::optional<time_t> departureTime = {});
 };
 }  // namespace routing
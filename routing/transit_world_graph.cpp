@@ -141,7 +141,8 @@ RouteWeight TransitWorldGraph::CalcOffroadWeight(ms::LatLon const & from,
   return RouteWeight(m_estimator->CalcOffroad(from, to, purpose));
 }
 
-double TransitWorldGraph::CalculateETA(Segment const & from, Segment const & to)
+double TransitWorldGraph::CalculateETA(Segment const & from, Segment const & to,
+                                       double timeToFrom)
 {
   if (TransitGraph::IsTransitSegment(from))
     return CalcSegmentWeight(to, EdgeEstimator::Purpose::ETA).GetWeight();
@@ -156,9 +157,7 @@ double TransitWorldGraph::CalculateETA(Segment const & from, Segment const & to)
   }
 
   auto & indexGraph = m_indexLoader->GetIndexGraph(from.GetMwmId());
-  return indexGraph
-      .CalculateEdgeWeight(EdgeEstimator::Purpose::ETA, true /* isOutgoing */, from, to)
-      .GetWeight();
+  return indexGraph.CalculateETA(from, to, timeToFrom);
 }
 
 double TransitWorldGraph::CalculateETAWithoutPenalty(Segment const & segment)
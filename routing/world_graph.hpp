@@ -89,7 +89,8 @@ public:
   virtual RouteWeight CalcOffroadWeight(ms::LatLon const & from, ms::LatLon const & to,
                                         EdgeEstimator::Purpose purpose) const = 0;
 
-  virtual double CalculateETA(Segment const & from, Segment const & to) = 0;
+  // |timeToFrom| is the time in seconds it takes to reach the end of |from| since the route start.
+  virtual double CalculateETA(Segment const & from, Segment const & to, double timeToFrom) = 0;
   virtual double CalculateETAWithoutPenalty(Segment const & segment) = 0;
 
   using TransitionFnT = std::function<void(Segment const &)>;
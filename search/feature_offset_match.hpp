@@ -5,6 +5,7 @@
 #include "search/search_trie.hpp"
 #include "search/token_slice.hpp"
 
+#include "indexer/flat_trie.hpp"
 #include "indexer/trie.hpp"
 
 #include "base/assert.hpp"
@@ -95,6 +96,57 @@ bool MatchInTrie(trie::Iterator<ValueList> const & trieRoot, strings::UniChar co
   return found;
 }
 
+// Same as above for the flat trie. The queue holds cursors only, so nothing is allocated per
+// visited node.
+template <typename Reader, typename ValueList, typename Serializer, typename DFA, typename ToDo>
+bool MatchInTrie(trie::FlatTrie<Reader, ValueList, Serializer> const & flatTrie,
+                 typename trie::FlatTrie<Reader, ValueList, Serializer>::Cursor const & root,
+                 strings::UniChar const * rootPrefix, size_t rootPrefixSize, DFA const & dfa,
+                 ToDo && toDo)
+{
+  using Cursor = typename trie::FlatTrie<Reader, ValueList, Serializer>::Cursor;
+  using DFAIt = typename DFA::Iterator;
+  using State = std::pair<Cursor, DFAIt>;
+
+  std::queue<State> q;
+
+  {
+    auto it = dfa.Begin();
+    DFAMove(it, rootPrefix, rootPrefix + rootPrefixSize);
+    if (it.Rejects())
+      return false;
+    q.emplace(root, it);
+  }
+
+  bool found = false;
+
+  while (!q.empty())
+  {
+    auto const p = q.front();
+    q.pop();
+
+    auto const & cursor = p.first;
+    auto const & dfaIt = p.second;
+
+    if (dfaIt.Accepts())
+    {
+      flatTrie.ForEachValue(
+          cursor, [&dfaIt, &toDo](auto const & v) { toDo(v, dfaIt.ErrorsMade() == 0); });
+      found = true;
+    }
+
+    flatTrie.ForEachEdge(cursor, [&](trie::TrieChar const * begin, trie::TrieChar const * end,
+                                     Cursor const & child) {
+      auto curIt = dfaIt;
+      strings::DFAMove(curIt, begin, end);
+      if (!curIt.Rejects())
+        q.emplace(child, curIt);
+    });
+  }
+
+  return found;
+}
+
 template <typename Filter, typename Value>
 class OffsetIntersector
 {
@@ -169,6 +221,28 @@ struct TrieRootPrefix
   }
 };
 
+template <typename Trie>
+struct FlatTrieRootPrefix
+{
+  using Cursor = typename Trie::Cursor;
+
+  Trie const & m_trie;
+  Cursor m_root;
+  strings::UniChar const * m_prefix;
+  size_t m_prefixSize;
+
+  // The label must outlive the prefix.
+  FlatTrieRootPrefix(Trie const & flatTrie, Cursor const & root,
+                     trie::TrieChar const * labelBegin, trie::TrieChar const * labelEnd)
+    : m_trie(flatTrie)
+    , m_root(root)
+    , m_prefix(labelBegin + 1)
+    , m_prefixSize(static_cast<size_t>(labelEnd - labelBegin - 1))
+  {
+    ASSERT(labelBegin != labelEnd, ());
+  }
+};
+
 template <typename Filter, typename Value>
 class TrieValuesHolder
 {
@@ -237,26 +311,65 @@ void MatchInTrie(std::vector<DFA> const & dfas, TrieRootPrefix<ValueList> const
     impl::MatchInTrie(trieRoot.m_root, trieRoot.m_prefix, trieRoot.m_prefixSize, dfa, toDo);
 }
 
-// Calls |toDo| for each feature in categories branch matching to |request|.
-//
-// *NOTE* |toDo| may be called several times for the same feature.
-template <typename DFA, typename ValueList, typename ToDo>
-bool MatchCategoriesInTrie(SearchTrieRequest<DFA> const & request,
-                           trie::Iterator<ValueList> const & trieRoot, ToDo && toDo)
+template <typename DFA, typename Trie, typename ToDo>
+void MatchInTrie(std::vector<DFA> const & dfas, FlatTrieRootPrefix<Trie> const & trieRoot,
+                 ToDo && toDo)
+{
+  for (auto const & dfa : dfas)
+  {
+    impl::MatchInTrie(trieRoot.m_trie, trieRoot.m_root, trieRoot.m_prefix, trieRoot.m_prefixSize,
+                      dfa, toDo);
+  }
+}
+
+// Calls |toDo| with the root prefix of the |lang| branch of the trie.
+// Returns false if there is no such branch.
+template <typename ValueList, typename ToDo>
+bool WithLangRoot(trie::Iterator<ValueList> const & trieRoot, uint8_t lang, ToDo && toDo)
 {
   uint32_t langIx = 0;
-  if (!impl::FindLangIndex(trieRoot, search::kCategoriesLang, langIx))
+  if (!impl::FindLangIndex(trieRoot, lang, langIx))
     return false;
 
   auto const & edge = trieRoot.m_edges[langIx].m_label;
   ASSERT_GREATER_OR_EQUAL(edge.size(), 1, ());
 
-  auto const catRoot = trieRoot.GoToEdge(langIx);
-  MatchInTrie(request.m_categories, TrieRootPrefix<ValueList>(*catRoot, edge), toDo);
-
+  auto const langRoot = trieRoot.GoToEdge(langIx);
+  toDo(TrieRootPrefix<ValueList>(*langRoot, edge));
   return true;
 }
 
+template <typename Reader, typename ValueList, typename Serializer, typename ToDo>
+bool WithLangRoot(trie::FlatTrie<Reader, ValueList, Serializer> const & flatTrie, uint8_t lang,
+                  ToDo && toDo)
+{
+  using Trie = trie::FlatTrie<Reader, ValueList, Serializer>;
+
+  bool found = false;
+  auto const root = flatTrie.GetRoot();
+  flatTrie.ForEachEdge(root, [&](trie::TrieChar const * begin, trie::TrieChar const * end,
+                                 typename Trie::Cursor const & child) {
+    ASSERT(begin != end, ());
+    if (found || *begin != lang)
+      return;
+    found = true;
+    toDo(FlatTrieRootPrefix<Trie>(flatTrie, child, begin, end));
+  });
+  return found;
+}
+
+// Calls |toDo| for each feature in categories branch matching to |request|.
+//
+// *NOTE* |toDo| may be called several times for the same feature.
+template <typename DFA, typename TrieRoot, typename ToDo>
+bool MatchCategoriesInTrie(SearchTrieRequest<DFA> const & request, TrieRoot const & trieRoot,
+                           ToDo && toDo)
+{
+  return WithLangRoot(trieRoot, search::kCategoriesLang, [&](auto const & catRoot) {
+    MatchInTrie(request.m_categories, catRoot, toDo);
+  });
+}
+
 // Calls |toDo| with trie root prefix and language code on each
 // language allowed by |request|.
 template <typename DFA, typename ValueList, typename ToDo>
@@ -280,14 +393,33 @@ void ForEachLangPrefix(SearchTrieRequest<DFA> const & request,
   }
 }
 
+template <typename DFA, typename Reader, typename ValueList, typename Serializer, typename ToDo>
+void ForEachLangPrefix(SearchTrieRequest<DFA> const & request,
+                       trie::FlatTrie<Reader, ValueList, Serializer> const & flatTrie,
+                       ToDo && toDo)
+{
+  using Trie = trie::FlatTrie<Reader, ValueList, Serializer>;
+
+  auto const root = flatTrie.GetRoot();
+  flatTrie.ForEachEdge(root, [&](trie::TrieChar const * begin, trie::TrieChar const * end,
+                                 typename Trie::Cursor const & child) {
+    ASSERT(begin != end, ());
+    int8_t const lang = static_cast<int8_t>(*begin);
+    if (*begin < search::kCategoriesLang && request.HasLang(lang))
+    {
+      FlatTrieRootPrefix<Trie> langPrefix(flatTrie, child, begin, end);
+      toDo(langPrefix, lang);
+    }
+  });
+}
+
 // Calls |toDo| for each feature whose description matches to
 // |request|.  Each feature will be passed to |toDo| only once.
-template <typename DFA, typename ValueList, typename Filter, typename ToDo>
-void MatchFeaturesInTrie(SearchTrieRequest<DFA> const & request,
-                         trie::Iterator<ValueList> const & trieRoot, Filter const & filter,
-                         ToDo && toDo)
+template <typename DFA, typename TrieRoot, typename Filter, typename ToDo>
+void MatchFeaturesInTrie(SearchTrieRequest<DFA> const & request, TrieRoot const & trieRoot,
+                         Filter const & filter, ToDo && toDo)
 {
-  using Value = typename ValueList::Value;
+  using Value = typename TrieRoot::Value;
 
   TrieValuesHolder<Filter, Value> categoriesHolder(filter);
   bool const categoriesExist = MatchCategoriesInTrie(request, trieRoot, categoriesHolder);
@@ -297,7 +429,7 @@ void MatchFeaturesInTrie(SearchTrieRequest<DFA> const & request,
 
   ForEachLangPrefix(
       request, trieRoot,
-      [&request, &intersector](TrieRootPrefix<ValueList> & langRoot, int8_t /* lang */)
+      [&request, &intersector](auto & langRoot, int8_t /* lang */)
       {
         // Aggregate for all languages.
         MatchInTrie(request.m_names, langRoot, intersector);
@@ -313,33 +445,28 @@ void MatchFeaturesInTrie(SearchTrieRequest<DFA> const & request,
   intersector.ForEachResult(toDo);
 }
 
-template <typename ValueList, typename Filter, typename ToDo>
-void MatchPostcodesInTrie(TokenSlice const & slice, trie::Iterator<ValueList> const & trieRoot,
+template <typename TrieRoot, typename Filter, typename ToDo>
+void MatchPostcodesInTrie(TokenSlice const & slice, TrieRoot const & trieRoot,
                           Filter const & filter, ToDo && toDo)
 {
   using namespace strings;
-  using Value = typename ValueList::Value;
-
-  uint32_t langIx = 0;
-  if (!impl::FindLangIndex(trieRoot, search::kPostcodesLang, langIx))
-    return;
-
-  auto const & edge = trieRoot.m_edges[langIx].m_label;
-  auto const postcodesRoot = trieRoot.GoToEdge(langIx);
+  using Value = typename TrieRoot::Value;
 
   impl::OffsetIntersector<Filter, Value> intersector(filter);
-  for (size_t i = 0; i < slice.Size(); ++i)
-  {
-    // Full match required even for prefix token. Reasons:
-    // 1. For postcode every symbol is important, partial matching can lead to wrong results.
-    // 2. For prefix match query like "streetname 40" where |streetname| is located in 40xxx
-    // postcode zone will give all street vicinity as the result which is wrong.
-    std::vector<UniStringDFA> dfas;
-    slice.Get(i).ForOriginalAndSynonyms([&dfas](UniString const & s) { dfas.emplace_back(s); });
-    MatchInTrie(dfas, TrieRootPrefix<ValueList>(*postcodesRoot, edge), intersector);
-
-    intersector.NextStep();
-  }
+  WithLangRoot(trieRoot, search::kPostcodesLang, [&](auto const & postcodesRoot) {
+    for (size_t i = 0; i < slice.Size(); ++i)
+    {
+      // Full match required even for prefix token. Reasons:
+      // 1. For postcode every symbol is important, partial matching can lead to wrong results.
+      // 2. For prefix match query like "streetname 40" where |streetname| is located in 40xxx
+      // postcode zone will give all street vicinity as the result which is wrong.
+      std::vector<UniStringDFA> dfas;
+      slice.Get(i).ForOriginalAndSynonyms([&dfas](UniString const & s) { dfas.emplace_back(s); });
+      MatchInTrie(dfas, postcodesRoot, intersector);
+
+      intersector.NextStep();
+    }
+  });
 
   intersector.ForEachResult(toDo);
 }
@@ -119,14 +119,12 @@ private:
   template <class Fn>
   void ForEachIndexImpl(covering::Intervals const & intervals, uint32_t scale, Fn && fn) const
   {
-    CheckUniqueIndexes checkUnique;
-    for (auto const & i : intervals)
-      m_index.ForEachInIntervalAndScale(i.first, i.second, scale,
-          [&](uint64_t /* key */, uint32_t value)
-          {
-            if (checkUnique(value))
-              fn(value);
-          });
+    CheckUniqueIndexes checkUnique(m_vector.GetNumFeatures());
+    m_index.ForEachInIntervalsAndScale(intervals, scale, [&](uint64_t /* key */, uint32_t value)
+    {
+      if (checkUnique(value))
+        fn(value);
+    });
   }
 
   FeaturesVector m_vector;
@@ -860,6 +860,8 @@ void Processor::InitRanker(Geocoder::Params const & geocoderParams,
   params.m_viewportSearch = viewportSearch;
   params.m_viewport = GetViewport();
   params.m_categorialRequest = geocoderParams.IsCategorialRequest();
+  params.m_threadsCount = searchParams.m_rankerThreadsCount;
+  params.m_stats = searchParams.m_rankerStats;
 
   m_ranker.Init(params, geocoderParams);
 }
@@ -22,10 +22,13 @@
 #include "coding/string_utf8_multilang.hpp"
 
 #include "base/logging.hpp"
+#include "base/scope_guard.hpp"
 #include "base/string_utils.hpp"
 
 #include <algorithm>
+#include <future>
 #include <memory>
+#include <numeric>
 #include <optional>
 
 namespace search
@@ -335,14 +338,13 @@ public:
     string name;
     string country;
 
-    auto ft = LoadFeature(preResult.GetId(), center, name, country);
-    if (!ft)
+    if (!LoadFeature(preResult.GetId(), m_feature, center, name, country))
       return {};
 
-    RankerResult res(*ft, center, std::move(name), country);
+    RankerResult res(m_feature, center, std::move(name), country);
 
     RankingInfo info;
-    InitRankingInfo(*ft, center, preResult, info);
+    InitRankingInfo(m_feature, center, preResult, info);
 
     if (info.m_type == Model::TYPE_STREET)
     {
@@ -360,7 +362,7 @@ public:
     }
 
     info.m_rank = NormalizeRank(info.m_rank, info.m_type, center, country,
-                                m_capitalChecker(*ft), !info.m_allTokensUsed);
+                                m_capitalChecker(m_feature), !info.m_allTokensUsed);
 
     if (preResult.GetInfo().m_isCommonMatchOnly)
     {
@@ -395,22 +397,21 @@ private:
     return (m_loader && m_loader->GetId() == id.m_mwmId);
   }
 
-  unique_ptr<FeatureType> LoadFeature(FeatureID const & id)
+  bool LoadFeature(FeatureID const & id, FeatureType & ft)
   {
     if (!IsSameLoader(id))
       m_loader = make_unique<FeaturesLoaderGuard>(m_dataSource, id.m_mwmId);
-    return LoadFeatureImpl(id, *m_loader);
+    return LoadFeatureImpl(id, *m_loader, ft);
   }
 
-  static unique_ptr<FeatureType> LoadFeatureImpl(FeatureID const & id, FeaturesLoaderGuard & loader)
+  static bool LoadFeatureImpl(FeatureID const & id, FeaturesLoaderGuard & loader, FeatureType & ft)
   {
-    auto ft = loader.GetFeatureByIndex(id.m_index);
-    if (ft)
-    {
-      ASSERT(id.IsValid(), ());
-      ft->SetID(id);
-    }
-    return ft;
+    if (!loader.GetFeatureByIndex(id.m_index, ft))
+      return false;
+
+    ASSERT(id.IsValid(), ());
+    ft.SetID(id);
+    return true;
   }
 
   bool GetExactAddress(FeatureType & ft, m2::PointD const & center, ReverseGeocoder::Address & addr) const
@@ -423,12 +424,11 @@ private:
   }
 
   // For the best performance, incoming ids should be sorted by id.first (mwm file id).
-  unique_ptr<FeatureType> LoadFeature(FeatureID const & id, m2::PointD & center, string & name,
-                                      string & country)
+  bool LoadFeature(FeatureID const & id, FeatureType & ft, m2::PointD & center, string & name,
+                   string & country)
   {
-    auto ft = LoadFeature(id);
-    if (!ft)
-      return ft;
+    if (!LoadFeature(id, ft))
+      return false;
 
     // Country (region) name is a file name if feature isn't from World.mwm.
     ASSERT(m_loader && m_loader->GetId() == id.m_mwmId, ());
@@ -437,38 +437,38 @@ private:
     else
       country = m_loader->GetCountryFileName();
 
-    center = feature::GetCenter(*ft);
-    m_ranker.GetBestMatchName(*ft, name);
+    center = feature::GetCenter(ft);
+    m_ranker.GetBestMatchName(ft, name);
 
     // Insert exact address (street and house number) instead of empty result name.
     if (name.empty())
     {
       ReverseGeocoder::Address addr;
-      if (GetExactAddress(*ft, center, addr))
+      if (GetExactAddress(ft, center, addr))
       {
-        unique_ptr<FeatureType> streetFeature;
+        bool streetLoaded = false;
 
         // We can't change m_loader here, because of the following RankerResult. So do this trick:
         if (IsSameLoader(addr.m_street.m_id))
         {
-          streetFeature = LoadFeatureImpl(addr.m_street.m_id, *m_loader);
+          streetLoaded = LoadFeatureImpl(addr.m_street.m_id, *m_loader, m_auxFeature);
         }
         else
         {
           auto loader = make_unique<FeaturesLoaderGuard>(m_dataSource, addr.m_street.m_id.m_mwmId);
-          streetFeature = LoadFeatureImpl(addr.m_street.m_id, *loader);
+          streetLoaded = LoadFeatureImpl(addr.m_street.m_id, *loader, m_auxFeature);
         }
 
-        if (streetFeature)
+        if (streetLoaded)
         {
           string streetName;
-          m_ranker.GetBestMatchName(*streetFeature, streetName);
+          m_ranker.GetBestMatchName(m_auxFeature, streetName);
           name = streetName + ", " + addr.GetHouseNumber();
         }
       }
     }
 
-    return ft;
+    return true;
   }
 
   void InitRankingInfo(FeatureType & ft, m2::PointD const & center, PreRankerResult const & res, RankingInfo & info)
@@ -520,12 +520,11 @@ private:
           preInfo.m_geoParts.m_street != IntersectionResult::kInvalidId)
       {
         auto const & mwmId = ft.GetID().m_mwmId;
-        auto street = LoadFeature(FeatureID(mwmId, preInfo.m_geoParts.m_street));
-        if (street)
+        if (LoadFeature(FeatureID(mwmId, preInfo.m_geoParts.m_street), m_auxFeature))
         {
           auto const type = Model::TYPE_STREET;
           auto const & range = preInfo.m_tokenRanges[type];
-          auto const streetScores = GetNameScores(*street, m_params, range, type);
+          auto const streetScores = GetNameScores(m_auxFeature, m_params, range, type);
 
           nameScore = min(nameScore, streetScores.m_nameScore);
           errorsMade += streetScores.m_errorsMade;
@@ -539,15 +538,14 @@ private:
           preInfo.m_geoParts.m_suburb != IntersectionResult::kInvalidId)
       {
         auto const & mwmId = ft.GetID().m_mwmId;
-        auto suburb = LoadFeature(FeatureID(mwmId, preInfo.m_geoParts.m_suburb));
-        if (suburb)
+        if (LoadFeature(FeatureID(mwmId, preInfo.m_geoParts.m_suburb), m_auxFeature))
         {
           auto const type = Model::TYPE_SUBURB;
           auto const & range = preInfo.m_tokenRanges[type];
           ErrorsMade suburbErrors;
           size_t suburbMatchedLength = 0;
           bool suburbNameIsAltNameOrOldName = false;
-          MatchTokenRange(*suburb, m_params, range, type, suburbErrors, suburbMatchedLength,
+          MatchTokenRange(m_auxFeature, m_params, range, type, suburbErrors, suburbMatchedLength,
                           suburbNameIsAltNameOrOldName);
           errorsMade += suburbErrors;
           matchedLength += suburbMatchedLength;
@@ -558,15 +556,14 @@ private:
 
       if (!Model::IsLocalityType(info.m_type) && preInfo.m_cityId.IsValid())
       {
-        auto city = LoadFeature(preInfo.m_cityId);
-        if (city)
+        if (LoadFeature(preInfo.m_cityId, m_auxFeature))
         {
           auto const type = Model::TYPE_CITY;
           auto const & range = preInfo.m_tokenRanges[type];
           ErrorsMade cityErrors;
           size_t cityMatchedLength = 0;
           bool cityNameIsAltNameOrOldName = false;
-          MatchTokenRange(*city, m_params, range, type, cityErrors, cityMatchedLength,
+          MatchTokenRange(m_auxFeature, m_params, range, type, cityErrors, cityMatchedLength,
                           cityNameIsAltNameOrOldName);
           errorsMade += cityErrors;
           matchedLength += cityMatchedLength;
@@ -647,6 +644,11 @@ private:
   Geocoder::Params const & m_params;
 
   unique_ptr<FeaturesLoaderGuard> m_loader;
+
+  // Slots for the result feature and for the street, suburb and city features loaded for it.
+  // Buffers are reused for all the results.
+  FeatureType m_feature;
+  FeatureType m_auxFeature;
 };
 
 Ranker::Ranker(DataSource const & dataSource, CitiesBoundariesTable const & boundariesTable,
@@ -750,7 +752,20 @@ void Ranker::UpdateResults(bool lastUpdate)
   if (!lastUpdate)
     BailIfCancelled();
 
+  base::Timer timer;
   MakeRankerResults();
+  if (m_params.m_stats)
+  {
+    m_params.m_stats->m_rankingTime += timer.TimeElapsed();
+    timer.Reset();
+  }
+
+  SCOPE_GUARD(statsGuard, [&]()
+  {
+    if (m_params.m_stats)
+      m_params.m_stats->m_makingResultsTime += timer.TimeElapsed();
+  });
+
   RemoveDuplicatingLinear(m_tentativeResults);
   if (m_tentativeResults.empty())
     return;
@@ -840,19 +855,65 @@ void Ranker::MakeRankerResults()
 {
   bool const isViewportMode = m_geocoderParams.m_mode == Mode::Viewport;
 
-  RankerResultMaker maker(*this, m_dataSource, m_infoGetter, m_reverseGeocoder, m_geocoderParams);
-  for (auto const & r : m_preRankerResults)
+  // Features are loaded grouped by mwm and sorted by index to make the reads sequential.
+  vector<size_t> order(m_preRankerResults.size());
+  iota(order.begin(), order.end(), 0);
+  sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs)
   {
-    auto p = maker(r);
+    return m_preRankerResults[lhs].GetId() < m_preRankerResults[rhs].GetId();
+  });
+
+  vector<optional<RankerResult>> results(m_preRankerResults.size());
+  auto const makeResults = [&](size_t begin, size_t end)
+  {
+    RankerResultMaker maker(*this, m_dataSource, m_infoGetter, m_reverseGeocoder, m_geocoderParams);
+    for (size_t i = begin; i < end; ++i)
+      results[order[i]] = maker(m_preRankerResults[order[i]]);
+  };
+
+  // Don't bother the threads for tiny batches.
+  size_t constexpr kMinChunkSize = 16;
+  size_t const threadsCount = m_params.m_threadsCount;
+  if (threadsCount <= 1 || order.size() < 2 * kMinChunkSize)
+  {
+    makeResults(0, order.size());
+  }
+  else
+  {
+    if (!m_threadPool || m_threadPoolSize != threadsCount)
+    {
+      m_threadPool = make_unique<base::thread_pool::computational::ThreadPool>(threadsCount);
+      m_threadPoolSize = threadsCount;
+    }
+
+    size_t const chunkSize = max(kMinChunkSize, (order.size() + threadsCount - 1) / threadsCount);
+    vector<future<void>> futures;
+    for (size_t begin = 0; begin < order.size(); begin += chunkSize)
+      futures.push_back(m_threadPool->Submit(makeResults, begin, min(begin + chunkSize, order.size())));
+
+    // |results| must outlive all the tasks, so wait for all of them before rethrowing.
+    for (auto & f : futures)
+      f.wait();
+    for (auto & f : futures)
+      f.get();
+  }
+
+  // Duplicates are checked in the original order of results.
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    auto & p = results[i];
     if (!p)
       continue;
 
-    ASSERT(!isViewportMode || m_geocoderParams.m_pivot.IsPointInside(p->GetCenter()), (r));
+    ASSERT(!isViewportMode || m_geocoderParams.m_pivot.IsPointInside(p->GetCenter()), (m_preRankerResults[i]));
 
     /// @todo Is it ok to make duplication check for O(N) here? Especially when we make RemoveDuplicatingLinear later.
     if (isViewportMode || !ResultExists(*p, m_tentativeResults, m_params.m_minDistanceBetweenResultsM))
       m_tentativeResults.push_back(std::move(*p));
-  };
+  }
+
+  if (m_params.m_stats)
+    m_params.m_stats->m_rankedCount += m_preRankerResults.size();
 
   m_preRankerResults.clear();
 }
@@ -15,8 +15,11 @@
 #include "geometry/rect2d.hpp"
 
 #include "base/string_utils.hpp"
+#include "base/thread_pool_computational.hpp"
+#include "base/timer.hpp"
 
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -34,6 +37,16 @@ class CitiesBoundariesTable;
 class RankerResultMaker;
 class VillagesCache;
 
+// Wall time spent in the ranking stages of queries.
+struct RankerStats
+{
+  // Loading of the geocoder's features and calculation of their ranking info.
+  base::Timer::DurationT m_rankingTime{};
+  // Making of the final results including the address lookups.
+  base::Timer::DurationT m_makingResultsTime{};
+  size_t m_rankedCount = 0;
+};
+
 class Ranker
 {
 public:
@@ -66,6 +79,11 @@ public:
 
     // The maximum total number of results to be emitted in all batches.
     size_t m_limit = 0;
+
+    // Number of threads to make ranker results, see SearchParams::m_rankerThreadsCount.
+    size_t m_threadsCount = 1;
+
+    std::shared_ptr<RankerStats> m_stats;
   };
 
   Ranker(DataSource const & dataSource, CitiesBoundariesTable const & boundariesTable,
@@ -133,5 +151,9 @@ private:
 
   std::vector<PreRankerResult> m_preRankerResults;
   std::vector<RankerResult> m_tentativeResults;
+
+  // Created on the first request with Params::m_threadsCount > 1.
+  std::unique_ptr<base::thread_pool::computational::ThreadPool> m_threadPool;
+  size_t m_threadPoolSize = 0;
 };
 }  // namespace search
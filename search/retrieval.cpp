@@ -238,8 +238,8 @@ bool MatchFeatureByPostcode(EditableMapObject const & emo, TokenSlice const & sl
   return true;
 }
 
-template <typename Value, typename DFA>
-Retrieval::ExtendedFeatures RetrieveAddressFeaturesImpl(Retrieval::TrieRoot<Value> const & root,
+template <typename Value, typename TrieRoot, typename DFA>
+Retrieval::ExtendedFeatures RetrieveAddressFeaturesImpl(TrieRoot const & root,
                                                         MwmContext const & context,
                                                         base::Cancellable const & cancellable,
                                                         SearchTrieRequest<DFA> const & request)
@@ -269,8 +269,8 @@ Retrieval::ExtendedFeatures RetrieveAddressFeaturesImpl(Retrieval::TrieRoot<Valu
   return SortFeaturesAndBuildResult(std::move(features), std::move(exactlyMatchedFeatures));
 }
 
-template <typename Value>
-Retrieval::ExtendedFeatures RetrievePostcodeFeaturesImpl(Retrieval::TrieRoot<Value> const & root,
+template <typename Value, typename TrieRoot>
+Retrieval::ExtendedFeatures RetrievePostcodeFeaturesImpl(TrieRoot const & root,
                                                          MwmContext const & context,
                                                          base::Cancellable const & cancellable,
                                                          TokenSlice const & slice)
@@ -354,6 +354,7 @@ Retrieval::Retrieval(MwmContext const & context, base::Cancellable const & cance
 
   version::MwmTraits mwmTraits(value.GetMwmVersion());
   auto const format = mwmTraits.GetSearchIndexFormat();
+  bool isFlatTrie = false;
   if (format == version::MwmTraits::SearchIndexFormat::CompressedBitVector)
   {
     m_reader = context.m_value.m_cont.GetReader(SEARCH_INDEX_FILE_TAG);
@@ -364,7 +365,7 @@ Retrieval::Retrieval(MwmContext const & context, base::Cancellable const & cance
 
     SearchIndexHeader header;
     header.Read(*reader.GetPtr());
-    CHECK(header.m_version == SearchIndexHeader::Version::V2, (base::Underlying(header.m_version)));
+    isFlatTrie = header.m_version == SearchIndexHeader::Version::V3;
 
     m_reader = reader.SubReader(header.m_indexOffset, header.m_indexSize);
   }
@@ -372,7 +373,16 @@ Retrieval::Retrieval(MwmContext const & context, base::Cancellable const & cance
   {
     CHECK(false, ("Unsupported search index format", format));
   }
-  m_root = ReadTrie<Uint64IndexValue>(m_reader);
+
+  if (isFlatTrie)
+  {
+    m_flatTrie = make_unique<FlatTrie<Uint64IndexValue>>(
+        SubReaderWrapper<Reader>(m_reader.GetPtr()), SingleValueSerializer<Uint64IndexValue>());
+  }
+  else
+  {
+    m_root = ReadTrie<Uint64IndexValue>(m_reader);
+  }
 }
 
 Retrieval::ExtendedFeatures Retrieval::RetrieveAddressFeatures(
@@ -413,6 +423,9 @@ template <template <typename> class R, typename... Args>
 Retrieval::ExtendedFeatures Retrieval::Retrieve(Args &&... args) const
 {
   R<Uint64IndexValue> r;
+  if (m_flatTrie)
+    return r(*m_flatTrie, m_context, m_cancellable, std::forward<Args>(args)...);
+
   ASSERT(m_root, ());
   return r(*m_root, m_context, m_cancellable, std::forward<Args>(args)...);
 }
@@ -7,6 +7,7 @@
 #include "platform/mwm_traits.hpp"
 
 #include "coding/reader.hpp"
+#include "coding/reader_wrapper.hpp"
 
 #include "geometry/rect2d.hpp"
 
@@ -32,6 +33,9 @@ class Retrieval
 public:
   template<typename Value>
   using TrieRoot = trie::Iterator<ValueList<Value>>;
+  template <typename Value>
+  using FlatTrie =
+      trie::FlatTrie<SubReaderWrapper<Reader>, ValueList<Value>, SingleValueSerializer<Value>>;
   using Features = search::CBV;
 
   struct ExtendedFeatures
@@ -115,6 +119,8 @@ private:
   base::Cancellable const & m_cancellable;
   ModelReaderPtr m_reader;
 
+  // Only one of them is set depending on the search index version.
   std::unique_ptr<TrieRoot<Uint64IndexValue>> m_root;
+  std::unique_ptr<FlatTrie<Uint64IndexValue>> m_flatTrie;
 };
 }  // namespace search
@@ -10,13 +10,17 @@ public:
     V0 = 0,
     V1 = 1,
     V2 = 2,
+    // The index is a flat trie, see indexer/flat_trie.hpp. It is faster to traverse but
+    // larger than V2, so it is written only on demand (generator_tool --flat_search_index).
+    V3 = 3,
     Latest = V2
   };
 
   template <typename Sink>
   void Serialize(Sink & sink) const
   {
-    CHECK_EQUAL(static_cast<uint8_t>(m_version), static_cast<uint8_t>(Version::V2), ());
+    CHECK(m_version == Version::V2 || m_version == Version::V3,
+          (static_cast<uint8_t>(m_version)));
     WriteToSink(sink, static_cast<uint8_t>(m_version));
     WriteToSink(sink, m_indexOffset);
     WriteToSink(sink, m_indexSize);
@@ -26,7 +30,8 @@ public:
   {
     NonOwningReaderSource source(reader);
     m_version = static_cast<Version>(ReadPrimitiveFromSource<uint8_t>(source));
-    CHECK_EQUAL(static_cast<uint8_t>(m_version), static_cast<uint8_t>(Version::V2), ());
+    CHECK(m_version == Version::V2 || m_version == Version::V3,
+          (static_cast<uint8_t>(m_version)));
     m_indexOffset = ReadPrimitiveFromSource<uint32_t>(source);
     m_indexSize = ReadPrimitiveFromSource<uint32_t>(source);
   }
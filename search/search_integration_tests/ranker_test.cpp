@@ -1,11 +1,13 @@
 #include "testing/testing.hpp"
 
+#include "search/ranker.hpp"
 #include "search/search_tests_support/helpers.hpp"
 #include "search/search_tests_support/test_results_matching.hpp"
 
 #include "generator/generator_tests_support/test_feature.hpp"
 #include "generator/generator_tests_support/test_mwm_builder.hpp"
 
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -105,6 +107,49 @@ UNIT_CLASS_TEST(RankerTest, UniteSameResults)
   }
 }
 
+UNIT_CLASS_TEST(RankerTest, ParallelRanking)
+{
+  vector<TestCafe> cafes;
+  for (size_t i = 0; i < 10; ++i)
+  {
+    for (size_t j = 0; j < 10; ++j)
+      cafes.emplace_back(m2::PointD(0.01 * i, 0.01 * j), "Coffee " + strings::to_string(i * 10 + j), "en");
+  }
+
+  BuildCountry("Coffeeland", [&](TestMwmBuilder & builder) {
+    for (auto const & c : cafes)
+      builder.Add(c);
+  });
+
+  SetViewport(m2::RectD(m2::PointD(0.0, 0.0), m2::PointD(0.1, 0.1)));
+
+  auto const search = [&](size_t threadsCount) {
+    SearchParams params;
+    params.m_query = "coffee ";
+    params.m_inputLocale = "en";
+    params.m_viewport = m_viewport;
+    params.m_mode = Mode::Everywhere;
+    params.m_maxNumResults = cafes.size();
+    params.m_rankerThreadsCount = threadsCount;
+    params.m_rankerStats = make_shared<RankerStats>();
+
+    auto request = MakeRequest(params);
+    TEST_GREATER_OR_EQUAL(params.m_rankerStats->m_rankedCount, cafes.size(), ());
+    return request->Results();
+  };
+
+  auto const sequential = search(1 /* threadsCount */);
+  auto const parallel = search(4 /* threadsCount */);
+
+  TEST_EQUAL(sequential.size(), cafes.size(), ());
+  TEST_EQUAL(sequential.size(), parallel.size(), ());
+  for (size_t i = 0; i < sequential.size(); ++i)
+  {
+    TEST_EQUAL(sequential[i].GetFeatureID(), parallel[i].GetFeatureID(), (i));
+    TEST_EQUAL(sequential[i].GetString(), parallel[i].GetString(), (i));
+  }
+}
+
 /// @todo This test doesn't make sense because we don't have POIs in World.
 /*
 UNIT_CLASS_TEST(RankerTest, PreferCountry)
@@ -18,6 +18,7 @@ namespace search
 {
 class Results;
 class Tracer;
+struct RankerStats;
 
 struct SearchParams
 {
@@ -80,6 +81,13 @@ struct SearchParams
 
   std::shared_ptr<Tracer> m_tracer;
 
+  // Durations of the ranking stages are accumulated here if set.
+  std::shared_ptr<RankerStats> m_rankerStats;
+
+  // Number of threads that load and rank features found by the geocoder.
+  // The search thread does everything itself if it is 1.
+  size_t m_rankerThreadsCount = 1;
+
   Mode m_mode = Mode::Everywhere;
 
   // Needed to generate search suggests.
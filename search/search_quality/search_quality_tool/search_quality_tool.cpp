@@ -3,6 +3,7 @@
 #include "search/search_tests_support/test_search_engine.hpp"
 #include "search/search_tests_support/test_search_request.hpp"
 
+#include "search/ranker.hpp"
 #include "search/ranking_info.hpp"
 #include "search/result.hpp"
 #include "search/search_params.hpp"
@@ -58,6 +59,8 @@ DEFINE_int32(top, 1, "Number of top results to show for every query");
 DEFINE_string(viewport, "", "Viewport to use when searching (default, moscow, london, zurich)");
 DEFINE_string(check_completeness, "", "Path to the file with completeness data");
 DEFINE_string(ranking_csv_file, "", "File ranking info will be exported to");
+DEFINE_int32(ranker_threads, 1, "Number of threads to rank the results of every query");
+DEFINE_bool(stage_latency, false, "Report latency of the search stages");
 
 string const kDefaultQueriesPathSuffix =
     "/../search/search_quality/search_quality_tool/queries.txt";
@@ -289,8 +292,21 @@ void CheckCompleteness(string const & path, DataSource & dataSource, TestSearchE
        << expectedResultsTop1Percentage << "%)." << endl;
 }
 
+void PrintStatistics(string const & title, vector<double> const & times)
+{
+  double averageTime;
+  double maxTime;
+  double varianceTime;
+  double stdDevTime;
+  CalcStatistics(times, averageTime, maxTime, varianceTime, stdDevTime);
+
+  cout << title << ": average " << averageTime << "s (std. dev. " << stdDevTime << "s), maximum "
+       << maxTime << "s" << endl;
+}
+
 void RunRequests(TestSearchEngine & engine, m2::RectD const & viewport, string queriesPath,
-                 string const & locale, string const & rankingCSVFile, size_t top)
+                 string const & locale, string const & rankingCSVFile, size_t top,
+                 size_t rankerThreads, bool stageLatency)
 {
   vector<string> queries;
   {
@@ -305,6 +321,7 @@ void RunRequests(TestSearchEngine & engine, m2::RectD const & viewport, string q
     // todo(@m) Add a bool flag to search with prefixes?
     requests.emplace_back(make_unique<TestSearchRequest>(engine, MakePrefixFree(queries[i]), locale,
                                                          Mode::Everywhere, viewport));
+    requests.back()->SetRankerThreadsCount(rankerThreads);
   }
 
   ofstream csv;
@@ -324,12 +341,28 @@ void RunRequests(TestSearchEngine & engine, m2::RectD const & viewport, string q
     csv << endl;
   }
 
+  auto const toSeconds = [](auto const & duration) {
+    return static_cast<double>(duration_cast<milliseconds>(duration).count()) / 1000;
+  };
+
   vector<double> responseTimes(queries.size());
+  vector<double> geocodingTimes(queries.size());
+  vector<double> rankingTimes(queries.size());
+  vector<double> makingResultsTimes(queries.size());
+  size_t rankedCount = 0;
   for (size_t i = 0; i < queries.size(); ++i)
   {
+    auto const stats = make_shared<RankerStats>();
+    if (stageLatency)
+      requests[i]->SetRankerStats(stats);
+
     requests[i]->Run();
-    auto rt = duration_cast<milliseconds>(requests[i]->ResponseTime()).count();
-    responseTimes[i] = static_cast<double>(rt) / 1000;
+    responseTimes[i] = toSeconds(requests[i]->ResponseTime());
+    rankingTimes[i] = toSeconds(stats->m_rankingTime);
+    makingResultsTimes[i] = toSeconds(stats->m_makingResultsTime);
+    // Everything that is not ranking is mostly geocoding and pre-ranking.
+    geocodingTimes[i] = max(responseTimes[i] - rankingTimes[i] - makingResultsTimes[i], 0.0);
+    rankedCount += stats->m_rankedCount;
     PrintTopResults(MakePrefixFree(queries[i]), requests[i]->Results(), top, responseTimes[i]);
 
     if (dumpCSV)
@@ -353,6 +386,15 @@ void RunRequests(TestSearchEngine & engine, m2::RectD const & viewport, string q
   cout << "Maximum response time: " << maxTime << "s" << endl;
   cout << "Average response time: " << averageTime << "s"
        << " (std. dev. " << stdDevTime << "s)" << endl;
+
+  if (stageLatency)
+  {
+    cout << endl;
+    PrintStatistics("Geocoding and pre-ranking", geocodingTimes);
+    PrintStatistics("Loading and ranking of features", rankingTimes);
+    PrintStatistics("Making results and addresses", makingResultsTimes);
+    cout << "Ranked features: " << rankedCount << endl;
+  }
 }
 
 int main(int argc, char * argv[])
@@ -385,6 +427,7 @@ int main(int argc, char * argv[])
   }
 
   RunRequests(*engine, viewport, FLAGS_queries_path, FLAGS_locale, FLAGS_ranking_csv_file,
-              static_cast<size_t>(FLAGS_top));
+              static_cast<size_t>(FLAGS_top), static_cast<size_t>(max(FLAGS_ranker_threads, 1)),
+              FLAGS_stage_latency);
   return 0;
 }
@@ -1,15 +1,28 @@
 #include "testing/testing.hpp"
 
 #include "search/feature_offset_match.hpp"
+#include "search/search_index_values.hpp"
 
-#include "indexer/trie.hpp"
+#include "indexer/flat_trie.hpp"
+#include "indexer/flat_trie_builder.hpp"
 #include "indexer/search_string_utils.hpp"
+#include "indexer/trie.hpp"
+#include "indexer/trie_builder.hpp"
+#include "indexer/trie_reader.hpp"
+
+#include "coding/byte_stream.hpp"
+#include "coding/reader.hpp"
 
+#include "base/logging.hpp"
 #include "base/mem_trie.hpp"
 #include "base/string_utils.hpp"
+#include "base/timer.hpp"
 
+#include <algorithm>
 #include <map>
+#include <random>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace feature_offset_match_tests
@@ -99,4 +112,131 @@ UNIT_TEST(MatchPrefixInTrieTest)
     TEST(vals.at(1), (vals));
   }
 }
+
+UNIT_TEST(MatchInFlatTrieTest)
+{
+  using IndexValue = Uint64IndexValue;
+  using FlatTrie =
+      trie::FlatTrie<MemReader, ::ValueList<IndexValue>, SingleValueSerializer<IndexValue>>;
+
+  vector<pair<Key, IndexValue>> data = {{MakeUniString("hotel"), IndexValue(1)},
+                                        {MakeUniString("homel"), IndexValue(2)},
+                                        {MakeUniString("hotel"), IndexValue(3)}};
+  sort(data.begin(), data.end());
+
+  vector<uint8_t> buffer;
+  PushBackByteSink<vector<uint8_t>> sink(buffer);
+  SingleValueSerializer<IndexValue> serializer;
+  trie::BuildFlat<PushBackByteSink<vector<uint8_t>>, Key, ::ValueList<IndexValue>>(sink, serializer,
+                                                                                 data);
+  FlatTrie const flatTrie(MemReader(buffer.data(), buffer.size()), serializer);
+
+  map<uint64_t, bool> vals;
+  auto saveResult = [&vals](IndexValue const & v, bool exactMatch) {
+    vals[v.m_featureId] = exactMatch;
+  };
+
+  search::impl::MatchInTrie(flatTrie, flatTrie.GetRoot(), nullptr, 0 /* prefixSize */,
+                            DFA("hotel", 1 /* maxErrors */), saveResult);
+  TEST(vals.at(1), (vals));
+  TEST(vals.at(3), (vals));
+  TEST(!vals.at(2), (vals));
+
+  vals.clear();
+  search::impl::MatchInTrie(flatTrie, flatTrie.GetRoot(), nullptr, 0 /* prefixSize */,
+                            PrefixDFA(DFA("hom", 1 /* maxErrors */)), saveResult);
+  TEST_EQUAL(vals.size(), 3, (vals));
+  TEST(!vals.at(1), (vals));
+  TEST(vals.at(2), (vals));
+}
+
+// Compares fuzzy prefix query latency of the search index formats.
+UNIT_TEST(MatchInTrie_FuzzyPrefixBenchmark)
+{
+  using IndexValue = Uint64IndexValue;
+  using Serializer = SingleValueSerializer<IndexValue>;
+  using IndexValueList = ::ValueList<IndexValue>;
+
+  size_t const kWordsCount = 50000;
+  size_t const kQueriesCount = 300;
+
+  mt19937 rng(0 /* seed */);
+  // Frequent letters go first, so words share prefixes like in real names.
+  string const kLetters = "eaoinsrtlcdumphgbfywkvzxjq";
+  geometric_distribution<size_t> letterDist(0.15);
+  uniform_int_distribution<size_t> lengthDist(3, 12);
+
+  vector<pair<Key, IndexValue>> data;
+  for (size_t i = 0; i < kWordsCount; ++i)
+  {
+    string word(lengthDist(rng), ' ');
+    for (auto & c : word)
+      c = kLetters[min(letterDist(rng), kLetters.size() - 1)];
+    data.emplace_back(MakeUniString(word), IndexValue(i));
+  }
+  sort(data.begin(), data.end());
+
+  Serializer serializer;
+
+  vector<uint8_t> treeBuffer;
+  {
+    PushBackByteSink<vector<uint8_t>> sink(treeBuffer);
+    trie::Build<PushBackByteSink<vector<uint8_t>>, Key, IndexValueList, Serializer>(
+        sink, serializer, data);
+    reverse(treeBuffer.begin(), treeBuffer.end());
+  }
+  auto const treeRoot = trie::ReadTrie<MemReader, IndexValueList>(
+      MemReader(treeBuffer.data(), treeBuffer.size()), serializer);
+
+  vector<uint8_t> flatBuffer;
+  {
+    PushBackByteSink<vector<uint8_t>> sink(flatBuffer);
+    trie::BuildFlat<PushBackByteSink<vector<uint8_t>>, Key, IndexValueList>(sink, serializer,
+                                                                            data);
+  }
+  trie::FlatTrie<MemReader, IndexValueList, Serializer> const flatTrie(
+      MemReader(flatBuffer.data(), flatBuffer.size()), serializer);
+
+  // Misspelled prefixes of the indexed words.
+  vector<PrefixDFA> queries;
+  uniform_int_distribution<size_t> wordDist(0, data.size() - 1);
+  for (size_t i = 0; i < kQueriesCount; ++i)
+  {
+    auto prefix = data[wordDist(rng)].first;
+    prefix.resize(min<size_t>(prefix.size(), 7));
+    prefix[rng() % prefix.size()] = kLetters[rng() % kLetters.size()];
+    queries.emplace_back(search::BuildLevenshteinDFA(prefix));
+  }
+
+  vector<uint64_t> treeResults;
+  base::Timer timer;
+  for (auto const & query : queries)
+  {
+    search::impl::MatchInTrie(*treeRoot, nullptr, 0 /* prefixSize */, query,
+                              [&treeResults](IndexValue const & v, bool /* exactMatch */) {
+                                treeResults.push_back(v.m_featureId);
+                              });
+  }
+  auto const treeTime = timer.ElapsedSeconds();
+
+  vector<uint64_t> flatResults;
+  timer.Reset();
+  for (auto const & query : queries)
+  {
+    search::impl::MatchInTrie(flatTrie, flatTrie.GetRoot(), nullptr, 0 /* prefixSize */, query,
+                              [&flatResults](IndexValue const & v, bool /* exactMatch */) {
+                                flatResults.push_back(v.m_featureId);
+                              });
+  }
+  auto const flatTime = timer.ElapsedSeconds();
+
+  LOG(LINFO, ("Queries:", kQueriesCount, "results:", flatResults.size()));
+  LOG(LINFO, ("Trie size:", treeBuffer.size(), "query time, ms:", treeTime * 1000 / kQueriesCount));
+  LOG(LINFO, ("Flat trie size:", flatBuffer.size(),
+              "query time, ms:", flatTime * 1000 / kQueriesCount));
+
+  sort(treeResults.begin(), treeResults.end());
+  sort(flatResults.begin(), flatResults.end());
+  TEST_EQUAL(treeResults, flatResults, ());
+}
 } // namespace feature_offset_match_tests
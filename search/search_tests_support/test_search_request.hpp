@@ -9,6 +9,7 @@
 
 #include <chrono>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -30,6 +31,8 @@ public:
   TestSearchRequest(TestSearchEngine & engine, SearchParams const & params);
 
   void SetCategorial() { m_params.m_categorialRequest = true; }
+  void SetRankerThreadsCount(size_t count) { m_params.m_rankerThreadsCount = count; }
+  void SetRankerStats(std::shared_ptr<RankerStats> const & stats) { m_params.m_rankerStats = stats; }
 
   // Initiates the search and waits for it to finish.
   void Run();
@@ -126,7 +126,7 @@ void HttpMapFilesDownloader::OnMapFileDownloaded(QueuedCountry const & queuedCou
 
   m_queue.PopFront();
 
-  queuedCountry.OnDownloadFinished(request.GetStatus());
+  queuedCountry.OnDownloadFinished(request.GetStatus(), request.GetFileSha1Base64());
 
   m_request.reset();
 
@@ -707,7 +707,8 @@ void Storage::OnDownloadProgress(QueuedCountry const & queuedCountry, Progress c
   ReportProgressForHierarchy(queuedCountry.GetCountryId(), progress);
 }
 
-void Storage::OnDownloadFinished(QueuedCountry const & queuedCountry, DownloadStatus status)
+void Storage::OnDownloadFinished(QueuedCountry const & queuedCountry, DownloadStatus status,
+                                 string const & sha1Base64)
 {
   CHECK_THREAD_CHECKER(m_threadChecker, ());
 
@@ -721,7 +722,23 @@ void Storage::OnDownloadFinished(QueuedCountry const & queuedCountry, DownloadSt
     OnFinishDownloading();
   };
 
-  if (status == DownloadStatus::Completed && m_integrityValidationEnabled)
+  if (status == DownloadStatus::Completed && m_integrityValidationEnabled && !sha1Base64.empty())
+  {
+    // The downloader has already hashed the file while downloading it.
+    if (sha1Base64 != GetCountryFile(countryId).GetSha1())
+    {
+      auto const path = GetFileDownloadPath(countryId, fileType);
+      LOG(LERROR, ("SHA check error for", path));
+      base::DeleteFileX(path);
+      status = DownloadStatus::FailedSHA;
+    }
+    else
+    {
+      LOG(LDEBUG, ("Successful SHA check"));
+    }
+    finishFn(status);
+  }
+  else if (status == DownloadStatus::Completed && m_integrityValidationEnabled)
   {
     /// @todo Can/Should be combined with ApplyDiff routine when we will restore it.
     /// While this is simple and working solution, I think that Downloader component
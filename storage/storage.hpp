@@ -267,8 +267,8 @@ private:
   void OnStartDownloading(QueuedCountry const & queuedCountry) override;
   /// Called on the main thread by MapFilesDownloader when
   /// downloading of a map file succeeds/fails.
-  void OnDownloadFinished(QueuedCountry const & queuedCountry,
-                          downloader::DownloadStatus status) override;
+  void OnDownloadFinished(QueuedCountry const & queuedCountry, downloader::DownloadStatus status,
+                          std::string const & sha1Base64) override;
 
   /// Periodically called on the main thread by MapFilesDownloader
   /// during the downloading process.
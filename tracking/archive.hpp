@@ -93,6 +93,7 @@ public:
   size_t Size() const;
   bool ReadyToDump() const;
   std::vector<Pack> Extract() const;
+  void Clear();
 
 private:
   boost::circular_buffer<Pack> m_buffer;
@@ -254,6 +255,12 @@ std::vector<Pack> BasicArchive<Pack>::Extract() const
   return res;
 }
 
+template <typename Pack>
+void BasicArchive<Pack>::Clear()
+{
+  m_buffer.clear();
+}
+
 template <typename Pack>
 template <typename Writer>
 bool BasicArchive<Pack>::Write(Writer & dst)
@@ -0,0 +1,189 @@
+#include "tracking/archive_bulk_reader.hpp"
+
+#include "tracking/archive.hpp"
+
+#include "coding/mmap_reader.hpp"
+#include "coding/reader.hpp"
+#include "coding/zlib.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <iterator>
+
+namespace tracking
+{
+namespace
+{
+template <typename Pack>
+void AppendPack(Pack const & pack, TrackColumns & columns)
+{
+  columns.m_lat.push_back(pack.m_lat);
+  columns.m_lon.push_back(pack.m_lon);
+  columns.m_timestamp.push_back(pack.m_timestamp);
+  columns.m_speedGroup.push_back(static_cast<uint8_t>(TraitsPacket<Pack>::GetSpeedGroup(pack)));
+}
+
+// Same as BasicArchive::Read() without the intermediate buffers.
+template <typename Pack>
+void DecodePacks(std::vector<uint8_t> const & inflated, TrackColumns & columns)
+{
+  ReaderSource<MemReaderWithExceptions> src(
+      MemReaderWithExceptions(inflated.data(), inflated.size()));
+
+  Pack last = TraitsPacket<Pack>::Read(src, false /* isDelta */);
+  AppendPack(last, columns);
+  while (src.Size() > 0)
+  {
+    Pack const delta = TraitsPacket<Pack>::Read(src, true /* isDelta */);
+    last = TraitsPacket<Pack>::Combine(last, delta);
+    AppendPack(last, columns);
+  }
+}
+}  // namespace
+
+// TrackColumns ------------------------------------------------------------------------------------
+void TrackColumns::Clear()
+{
+  m_lat.clear();
+  m_lon.clear();
+  m_timestamp.clear();
+  m_speedGroup.clear();
+}
+
+void TrackColumns::Resize(size_t size)
+{
+  m_lat.resize(size);
+  m_lon.resize(size);
+  m_timestamp.resize(size);
+  m_speedGroup.resize(size);
+}
+
+// ArchiveBulkReader -------------------------------------------------------------------------------
+ArchiveBulkReader::ArchiveBulkReader(size_t threadsCount)
+  : m_threadsData(threadsCount), m_threadPool(threadsCount)
+{
+}
+
+std::vector<ArchiveBulkReader::FileRange> ArchiveBulkReader::Read(
+    std::vector<std::string> const & files, TrackColumns & columns)
+{
+  std::vector<FileRange> ranges(files.size());
+  std::atomic<size_t> nextFile{0};
+
+  std::vector<std::future<void>> results;
+  results.reserve(m_threadsData.size());
+  for (auto & data : m_threadsData)
+  {
+    results.push_back(m_threadPool.Submit(
+        [this, &data, &files, &nextFile, &ranges]() { DecodeFiles(data, files, nextFile, ranges); }));
+  }
+  for (auto & result : results)
+    result.get();
+
+  size_t size = 0;
+  for (auto & range : ranges)
+  {
+    range.m_offset = size;
+    size += range.m_size;
+  }
+
+  columns.Resize(size);
+  results.clear();
+  for (auto const & data : m_threadsData)
+  {
+    results.push_back(m_threadPool.Submit(
+        [this, &data, &ranges, &columns]() { Gather(data, ranges, columns); }));
+  }
+  for (auto & result : results)
+    result.get();
+
+  return ranges;
+}
+
+// static
+bool ArchiveBulkReader::Decode(uint8_t const * data, size_t size, bool isCar,
+                               std::vector<uint8_t> & inflated, TrackColumns & columns)
+{
+  inflated.clear();
+  coding::ZLib::Inflate inflate(coding::ZLib::Inflate::Format::ZLib);
+  if (!inflate(data, size, std::back_inserter(inflated)) || inflated.empty())
+    return false;
+
+  size_t const initialSize = columns.Size();
+  try
+  {
+    if (isCar)
+      DecodePacks<PacketCar>(inflated, columns);
+    else
+      DecodePacks<Packet>(inflated, columns);
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LWARNING, ("Error decoding archive", e.Msg()));
+    columns.Resize(initialSize);
+    return false;
+  }
+  return true;
+}
+
+// static
+bool ArchiveBulkReader::DecodeFile(std::string const & path, bool isCar,
+                                   std::vector<uint8_t> & inflated, TrackColumns & columns)
+{
+  try
+  {
+    MmapReader const reader(path, MmapReader::Advice::Sequential);
+    if (reader.Size() == 0)
+      return false;
+
+    return Decode(reader.Data(), static_cast<size_t>(reader.Size()), isCar, inflated, columns);
+  }
+  catch (std::exception const & e)
+  {
+    LOG(LWARNING, ("Error reading archive", path, e.what()));
+  }
+  return false;
+}
+
+void ArchiveBulkReader::DecodeFiles(ThreadData & data, std::vector<std::string> const & files,
+                                    std::atomic<size_t> & nextFile,
+                                    std::vector<FileRange> & ranges)
+{
+  data.m_columns.Clear();
+  data.m_files.clear();
+
+  // Files are taken one by one, so the threads are busy till the end even if the sizes differ.
+  for (size_t i = nextFile++; i < files.size(); i = nextFile++)
+  {
+    auto & range = ranges[i];
+    range.m_info = archival_file::ParseArchiveFilename(files[i]);
+    bool const isCar = range.m_info.m_trackType == routing::RouterType::Vehicle;
+
+    size_t const offset = data.m_columns.Size();
+    range.m_isOk = DecodeFile(files[i], isCar, data.m_inflated, data.m_columns);
+    range.m_size = data.m_columns.Size() - offset;
+    data.m_files.emplace_back(i, offset);
+  }
+}
+
+void ArchiveBulkReader::Gather(ThreadData const & data, std::vector<FileRange> const & ranges,
+                               TrackColumns & columns) const
+{
+  auto const & src = data.m_columns;
+  for (auto const & [file, offset] : data.m_files)
+  {
+    auto const & range = ranges[file];
+    CHECK_LESS_OR_EQUAL(offset + range.m_size, src.Size(), ());
+    std::copy_n(src.m_lat.begin() + offset, range.m_size, columns.m_lat.begin() + range.m_offset);
+    std::copy_n(src.m_lon.begin() + offset, range.m_size, columns.m_lon.begin() + range.m_offset);
+    std::copy_n(src.m_timestamp.begin() + offset, range.m_size,
+                columns.m_timestamp.begin() + range.m_offset);
+    std::copy_n(src.m_speedGroup.begin() + offset, range.m_size,
+                columns.m_speedGroup.begin() + range.m_offset);
+  }
+}
+}  // namespace tracking
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "tracking/archival_file.hpp"
+
+#include "base/thread_pool_computational.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tracking
+{
+// Points of many tracks stored column by column.
+struct TrackColumns
+{
+  size_t Size() const { return m_timestamp.size(); }
+  void Clear();
+  void Resize(size_t size);
+
+  std::vector<double> m_lat;
+  std::vector<double> m_lon;
+  std::vector<uint32_t> m_timestamp;
+  // traffic::SpeedGroup values, SpeedGroup::Unknown for the pedestrian and bicycle tracks.
+  std::vector<uint8_t> m_speedGroup;
+};
+
+// Decodes many files written by BasicArchive at once. Every file is memory mapped,
+// inflated and delta decoded by one of the threads, the results are gathered to the common
+// columns in the order of the files.
+class ArchiveBulkReader
+{
+public:
+  struct FileRange
+  {
+    archival_file::FileInfo m_info;
+    // Points of the file are [m_offset, m_offset + m_size) in the columns.
+    size_t m_offset = 0;
+    size_t m_size = 0;
+    bool m_isOk = false;
+  };
+
+  explicit ArchiveBulkReader(size_t threadsCount);
+
+  // Replaces |columns| with points of |files|. The type of the points is taken from the file
+  // names, see archival_file::GetArchiveFilename(). Broken files are skipped.
+  // \returns ranges of |files| in |columns|.
+  std::vector<FileRange> Read(std::vector<std::string> const & files, TrackColumns & columns);
+
+  // Appends points of the archive |data| to |columns|. |inflated| is a buffer reused between
+  // the calls. In case of an error |columns| stay unchanged and false is returned.
+  static bool Decode(uint8_t const * data, size_t size, bool isCar,
+                     std::vector<uint8_t> & inflated, TrackColumns & columns);
+
+  // Same as Decode() for the file |path|.
+  static bool DecodeFile(std::string const & path, bool isCar, std::vector<uint8_t> & inflated,
+                         TrackColumns & columns);
+
+private:
+  struct ThreadData
+  {
+    TrackColumns m_columns;
+    std::vector<uint8_t> m_inflated;
+    // Indexes of the decoded files and offsets of their points in |m_columns|.
+    std::vector<std::pair<size_t, size_t>> m_files;
+  };
+
+  void DecodeFiles(ThreadData & data, std::vector<std::string> const & files,
+                   std::atomic<size_t> & nextFile, std::vector<FileRange> & ranges);
+  void Gather(ThreadData const & data, std::vector<FileRange> const & ranges,
+              TrackColumns & columns) const;
+
+  std::vector<ThreadData> m_threadsData;
+  base::thread_pool::computational::ThreadPool m_threadPool;
+};
+}  // namespace tracking
@@ -0,0 +1,49 @@
+#include "tracking/packet_stream.hpp"
+
+#include <cstring>
+
+namespace tracking
+{
+PacketStream::PacketStream(size_t maxPayloadSize) : m_maxPayloadSize(maxPayloadSize)
+{
+  ASSERT_LESS_OR_EQUAL(m_maxPayloadSize, 0xFFFFFF, ("Only 24 bits are used for the size."));
+}
+
+uint8_t * PacketStream::Reserve(size_t size)
+{
+  if (m_buffer.size() < m_end + size)
+    m_buffer.resize(m_end + size);
+  return m_buffer.data() + m_end;
+}
+
+void PacketStream::Commit(size_t size)
+{
+  ASSERT_LESS_OR_EQUAL(m_end + size, m_buffer.size(), ());
+  m_end += size;
+}
+
+// static
+bool PacketStream::IsKnownType(Protocol::PacketType type)
+{
+  switch (type)
+  {
+  case Protocol::PacketType::AuthV0:
+  case Protocol::PacketType::DataV0:
+  case Protocol::PacketType::DataV1: return true;
+  case Protocol::PacketType::Error: return false;
+  }
+  return false;
+}
+
+void PacketStream::Compact()
+{
+  if (m_begin == 0)
+    return;
+
+  // Usually all the received packets are complete and nothing is moved.
+  if (m_begin != m_end)
+    std::memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+  m_end -= m_begin;
+  m_begin = 0;
+}
+}  // namespace tracking
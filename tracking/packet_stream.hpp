@@ -0,0 +1,65 @@
+#pragma once
+
+#include "tracking/protocol.hpp"
+
+#include "base/assert.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tracking
+{
+// Splits a stream of bytes received from a connection into protocol packets. Bytes are received
+// directly to the internal buffer and packets are passed to the caller without copying, so
+// a server doesn't allocate anything per packet after the buffer has grown to the size of
+// the largest packet.
+class PacketStream
+{
+public:
+  explicit PacketStream(size_t maxPayloadSize);
+
+  // Returns a buffer to receive at most |size| bytes of the stream to. Commit() must be called
+  // with the number of bytes actually received before the next call.
+  uint8_t * Reserve(size_t size);
+  void Commit(size_t size);
+
+  // Calls |fn| with the packet type, the payload and the payload size for every complete packet
+  // received so far and drops these packets from the buffer. The payload is valid during
+  // the call only. Returns false if the stream is corrupted: a packet type is unknown or
+  // a packet is too big. The stream can't be used after that.
+  template <typename Fn>
+  bool ForEachPacket(Fn && fn)
+  {
+    while (m_end - m_begin >= Protocol::kHeaderSize)
+    {
+      auto const header = Protocol::DecodeHeader(m_buffer.data() + m_begin, m_end - m_begin);
+      if (!IsKnownType(header.first) || header.second > m_maxPayloadSize)
+        return false;
+
+      size_t const packetSize = Protocol::kHeaderSize + header.second;
+      if (m_end - m_begin < packetSize)
+        break;
+
+      fn(header.first, m_buffer.data() + m_begin + Protocol::kHeaderSize, header.second);
+      m_begin += packetSize;
+    }
+
+    Compact();
+    return true;
+  }
+
+  // Size of the incomplete packet at the end of the stream.
+  size_t GetPendingSize() const { return m_end - m_begin; }
+
+private:
+  static bool IsKnownType(Protocol::PacketType type);
+
+  void Compact();
+
+  std::vector<uint8_t> m_buffer;
+  size_t m_begin = 0;
+  size_t m_end = 0;
+  size_t const m_maxPayloadSize;
+};
+}  // namespace tracking
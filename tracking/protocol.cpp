@@ -81,16 +81,22 @@ vector<uint8_t> Protocol::CreateDataPacket(DataElementsVec const & points, Packe
 //  static
 pair<Protocol::PacketType, size_t> Protocol::DecodeHeader(vector<uint8_t> const & data)
 {
-  if (data.size() < sizeof(uint32_t /* header */))
+  return DecodeHeader(data.data(), data.size());
+}
+
+//  static
+pair<Protocol::PacketType, size_t> Protocol::DecodeHeader(uint8_t const * data, size_t size)
+{
+  if (size < kHeaderSize)
   {
-    LOG(LWARNING, ("Header size is too small", data.size(), sizeof(uint32_t /* header */)));
-    return make_pair(PacketType::Error, data.size());
+    LOG(LWARNING, ("Header size is too small", size, kHeaderSize));
+    return make_pair(PacketType::Error, size);
   }
 
-  uint32_t size = (*reinterpret_cast<uint32_t const *>(data.data())) & 0xFFFFFF00;
-  if (!IsBigEndianMacroBased())
-    size = ReverseByteOrder(size);
-  return make_pair(PacketType(static_cast<uint8_t>(data[0])), size);
+  uint32_t const payloadSize = (static_cast<uint32_t>(data[1]) << 16) |
+                               (static_cast<uint32_t>(data[2]) << 8) |
+                               static_cast<uint32_t>(data[3]);
+  return make_pair(PacketType(data[0]), payloadSize);
 }
 
 //  static
@@ -112,29 +118,41 @@ string Protocol::DecodeAuthPacket(Protocol::PacketType type, vector<uint8_t> con
 Protocol::DataElementsVec Protocol::DecodeDataPacket(PacketType type, vector<uint8_t> const & data)
 {
   DataElementsVec points;
-  MemReaderWithExceptions memReader(data.data(), data.size());
+  DecodeDataPacket(type, data.data(), data.size(), points);
+  return points;
+}
+
+//  static
+bool Protocol::DecodeDataPacket(PacketType type, uint8_t const * data, size_t size,
+                                DataElementsVec & points)
+{
+  uint32_t version = 0;
+  switch (type)
+  {
+  case Protocol::PacketType::DataV0: version = 0; break;
+  case Protocol::PacketType::DataV1: version = 1; break;
+  case Protocol::PacketType::Error:
+  case Protocol::PacketType::AuthV0:
+    LOG(LERROR, ("Error decoding DATA packet. PacketType =", type));
+    return false;
+  default:
+    LOG(LWARNING, ("Unknown DATA packet. PacketType =", type));
+    return false;
+  }
+
+  size_t const initialSize = points.size();
+  MemReaderWithExceptions memReader(data, size);
   ReaderSource<MemReaderWithExceptions> src(memReader);
   try
   {
-    switch (type)
-    {
-    case Protocol::PacketType::DataV0:
-      Encoder::DeserializeDataPoints(0 /* version */, src, points);
-      break;
-    case Protocol::PacketType::DataV1:
-      Encoder::DeserializeDataPoints(1 /* version */, src, points);
-      break;
-    case Protocol::PacketType::Error:
-    case Protocol::PacketType::AuthV0:
-      LOG(LERROR, ("Error decoding DATA packet. PacketType =", type));
-      return {};
-    }
-    return points;
+    Encoder::DeserializeDataPoints(version, src, points);
+    return true;
   }
   catch (Reader::SizeException const & ex)
   {
     LOG(LWARNING, ("Wrong packet. SizeException. Msg:", ex.Msg(), ". What:", ex.what()));
-    return {};
+    points.erase(points.begin() + initialSize, points.end());
+    return false;
   }
 }
 
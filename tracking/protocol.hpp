@@ -28,6 +28,8 @@ public:
   static uint8_t const kOk[4];
   static uint8_t const kFail[4];
 
+  static size_t constexpr kHeaderSize = sizeof(uint32_t);
+
   enum class PacketType
   {
     Error = 0x0,
@@ -45,8 +47,14 @@ public:
   static std::vector<uint8_t> CreateDataPacket(DataElementsVec const & points, PacketType type);
 
   static std::pair<PacketType, size_t> DecodeHeader(std::vector<uint8_t> const & data);
+  static std::pair<PacketType, size_t> DecodeHeader(uint8_t const * data, size_t size);
   static std::string DecodeAuthPacket(PacketType type, std::vector<uint8_t> const & data);
   static DataElementsVec DecodeDataPacket(PacketType type, std::vector<uint8_t> const & data);
+  // Appends points of the packet payload to |points|, so a server may decode many packets
+  // into the same vector without allocations. |points| is left unchanged and false is returned
+  // if the payload is malformed.
+  static bool DecodeDataPacket(PacketType type, uint8_t const * data, size_t size,
+                               DataElementsVec & points);
 
 private:
   static void InitHeader(std::vector<uint8_t> & packet, PacketType type, uint32_t payloadSize);
@@ -0,0 +1,278 @@
+#include "tracking/archive_bulk_reader.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_writer.hpp"
+#include "coding/hex.hpp"
+#include "coding/traffic.hpp"
+#include "coding/writer.hpp"
+
+#include "geometry/latlon.hpp"
+
+#include "base/file_name_utils.hpp"
+#include "base/logging.hpp"
+#include "base/scope_guard.hpp"
+#include "base/string_utils.hpp"
+#include "base/thread_pool_computational.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "defines.hpp"
+
+DEFINE_string(input, "", "Archive file or directory with archives, scanned recursively.");
+
+DEFINE_string(output, "", "File to write the points to.");
+
+DEFINE_string(format, "csv",
+              "csv: lines \"file,timestamp,lat,lon,speed_group\"; log: one line of "
+              "track_analyzing log format per archive with the archive directory name as user id.");
+
+DEFINE_int32(threads, 0, "Threads to decode and format the archives. Number of cores by default.");
+
+DEFINE_int32(batch_size, 10000, "Archives decoded at once.");
+
+namespace
+{
+using tracking::ArchiveBulkReader;
+using tracking::TrackColumns;
+
+enum class Format
+{
+  Csv,
+  Log
+};
+
+// Formatted chunks are written while the next ones are formatted.
+size_t constexpr kChunksPerThread = 4;
+
+std::vector<std::string> CollectArchives(std::string const & input)
+{
+  if (!Platform::IsDirectory(input))
+    return {input};
+
+  Platform::FilesList files;
+  Platform::GetFilesRecursively(input, files);
+  files.erase(std::remove_if(files.begin(), files.end(),
+                             [](std::string const & file) {
+                               return !strings::EndsWith(file, ARCHIVE_TRACKS_FILE_EXTENSION);
+                             }),
+              files.end());
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+char * WriteUint(uint64_t value, char * out)
+{
+  char digits[20];
+  size_t size = 0;
+  do
+  {
+    digits[size++] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+
+  while (size != 0)
+    *out++ = digits[--size];
+  return out;
+}
+
+// Same as "%.7f", snprintf() of doubles takes most of the conversion time.
+char * WriteCoord(double value, char * out)
+{
+  uint64_t constexpr kScale = 10000000;
+  int64_t fixed = std::llround(value * kScale);
+  if (fixed < 0)
+  {
+    *out++ = '-';
+    fixed = -fixed;
+  }
+
+  out = WriteUint(static_cast<uint64_t>(fixed) / kScale, out);
+  *out++ = '.';
+  uint64_t const fraction = static_cast<uint64_t>(fixed) % kScale;
+  for (uint64_t divisor = kScale / 10; divisor != 0; divisor /= 10)
+    *out++ = static_cast<char>('0' + fraction / divisor % 10);
+  return out;
+}
+
+void FormatCsv(std::string const & file, TrackColumns const & columns,
+               ArchiveBulkReader::FileRange const & range, std::string & out)
+{
+  char buffer[64];
+  for (size_t i = range.m_offset; i < range.m_offset + range.m_size; ++i)
+  {
+    char * end = buffer;
+    *end++ = ',';
+    end = WriteUint(columns.m_timestamp[i], end);
+    *end++ = ',';
+    end = WriteCoord(columns.m_lat[i], end);
+    *end++ = ',';
+    end = WriteCoord(columns.m_lon[i], end);
+    *end++ = ',';
+    end = WriteUint(columns.m_speedGroup[i], end);
+    *end++ = '\n';
+
+    out += file;
+    out.append(buffer, static_cast<size_t>(end - buffer));
+  }
+}
+
+// Same lines as track_analyzing::LogParser expects.
+void FormatLog(std::string const & file, TrackColumns const & columns,
+               ArchiveBulkReader::FileRange const & range, std::string & out)
+{
+  if (range.m_size == 0)
+    return;
+
+  std::vector<coding::TrafficGPSEncoder::DataPoint> points;
+  points.reserve(range.m_size);
+  for (size_t i = range.m_offset; i < range.m_offset + range.m_size; ++i)
+  {
+    points.emplace_back(columns.m_timestamp[i], ms::LatLon(columns.m_lat[i], columns.m_lon[i]),
+                        columns.m_speedGroup[i]);
+  }
+
+  std::vector<uint8_t> buffer;
+  MemWriter<std::vector<uint8_t>> writer(buffer);
+  coding::TrafficGPSEncoder::SerializeDataPoints(coding::TrafficGPSEncoder::kLatestVersion, writer,
+                                                 points);
+
+  std::string userId = base::GetDirectory(file);
+  base::GetNameFromFullPath(userId);
+
+  out += "CurrentData aloha_id : ";
+  out += userId;
+  out += " |";
+  out += ToHex(buffer);
+  out += "|\n";
+}
+
+std::string FormatChunk(Format format, std::vector<std::string> const & files,
+                        TrackColumns const & columns,
+                        std::vector<ArchiveBulkReader::FileRange> const & ranges, size_t begin,
+                        size_t end)
+{
+  std::string out;
+  for (size_t i = begin; i < end; ++i)
+  {
+    if (format == Format::Csv)
+      FormatCsv(files[i], columns, ranges[i], out);
+    else
+      FormatLog(files[i], columns, ranges[i], out);
+  }
+  return out;
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  gflags::SetUsageMessage(
+      "Decodes the track archives written by tracking::BasicArchive in parallel and converts "
+      "them to CSV or track_analyzing input.\n\n"
+      "Usage example: "
+      "./track_archive_converter -input=/path/to/archives/ -output=points.csv -format=csv");
+
+  gflags::ParseCommandLineFlags(&argc, &argv, true /* remove_flags */);
+
+  if (FLAGS_input.empty() || FLAGS_output.empty() || FLAGS_batch_size <= 0)
+  {
+    LOG(LINFO, ("Input and output are required, batch size must be positive."));
+    gflags::ShowUsageWithFlags(argv[0]);
+    return 1;
+  }
+
+  Format format;
+  if (FLAGS_format == "csv")
+  {
+    format = Format::Csv;
+  }
+  else if (FLAGS_format == "log")
+  {
+    format = Format::Log;
+  }
+  else
+  {
+    LOG(LINFO, ("Unknown format", FLAGS_format));
+    return 1;
+  }
+
+  size_t const threadsCount = FLAGS_threads > 0
+                                  ? static_cast<size_t>(FLAGS_threads)
+                                  : std::max(1U, std::thread::hardware_concurrency());
+  size_t const batchSize = static_cast<size_t>(FLAGS_batch_size);
+
+  base::Timer timer;
+  auto const files = CollectArchives(FLAGS_input);
+  LOG(LINFO, ("Found", files.size(), "archives in", timer.ElapsedSeconds(), "seconds"));
+
+  ArchiveBulkReader reader(threadsCount);
+  base::thread_pool::computational::ThreadPool formatPool(threadsCount);
+  TrackColumns columns;
+  uint64_t pointsCount = 0;
+  size_t brokenCount = 0;
+
+  try
+  {
+    FileWriter writer(FLAGS_output);
+    if (format == Format::Csv)
+    {
+      std::string const header = "file,timestamp,lat,lon,speed_group\n";
+      writer.Write(header.data(), header.size());
+    }
+
+    for (size_t batchBegin = 0; batchBegin < files.size(); batchBegin += batchSize)
+    {
+      std::vector<std::string> const batch(
+          files.begin() + batchBegin, files.begin() + std::min(batchBegin + batchSize, files.size()));
+      auto const ranges = reader.Read(batch, columns);
+      pointsCount += columns.Size();
+      brokenCount += std::count_if(ranges.begin(), ranges.end(),
+                                   [](auto const & range) { return !range.m_isOk; });
+
+      size_t const chunkSize =
+          std::max<size_t>(1, batch.size() / (threadsCount * kChunksPerThread));
+      std::vector<std::future<std::string>> chunks;
+      // The chunks refer to the batch, they must be finished even if the writing fails.
+      SCOPE_GUARD(waitChunks, [&chunks]() {
+        for (auto & chunk : chunks)
+        {
+          if (chunk.valid())
+            chunk.wait();
+        }
+      });
+      for (size_t begin = 0; begin < batch.size(); begin += chunkSize)
+      {
+        size_t const end = std::min(begin + chunkSize, batch.size());
+        chunks.push_back(formatPool.Submit([&, begin, end]() {
+          return FormatChunk(format, batch, columns, ranges, begin, end);
+        }));
+      }
+      for (auto & chunk : chunks)
+      {
+        auto const out = chunk.get();
+        writer.Write(out.data(), out.size());
+      }
+    }
+  }
+  catch (std::exception const & e)
+  {
+    LOG(LWARNING, ("Can't write", FLAGS_output, e.what()));
+    return 1;
+  }
+
+  double const seconds = std::max(timer.ElapsedSeconds(), 1e-6);
+  LOG(LINFO, ("Archives:", files.size(), "broken:", brokenCount));
+  LOG(LINFO, ("Points:", pointsCount, "in", seconds, "seconds,",
+              static_cast<uint64_t>(pointsCount / seconds), "points per second"));
+  return 0;
+}
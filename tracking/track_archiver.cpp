@@ -0,0 +1,183 @@
+#include "tracking/track_archiver.hpp"
+
+#include "tracking/archival_file.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_writer.hpp"
+
+#include "base/file_name_utils.hpp"
+#include "base/logging.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+namespace tracking
+{
+namespace
+{
+uint64_t constexpr kSecondsInDay = 24 * 60 * 60;
+// Archive file names have the fixed length, see archival_file::GetArchiveFilename().
+uint64_t constexpr kMinTimestamp = 1000000000;
+uint64_t constexpr kMaxTimestamp = std::numeric_limits<uint32_t>::max();
+size_t constexpr kMaxClientIdLength = 64;
+
+std::string GetDirName(std::string const & clientId, uint64_t connectionId)
+{
+  std::string name;
+  for (auto const c : clientId)
+  {
+    if (name.size() == kMaxClientIdLength)
+      break;
+    bool const isSafe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                        (c >= '0' && c <= '9') || c == '-';
+    name.push_back(isSafe ? c : '-');
+  }
+  if (name.empty())
+    name = "unknown";
+  return name + "_" + std::to_string(connectionId);
+}
+
+traffic::SpeedGroup GetSpeedGroup(uint8_t traffic)
+{
+  if (traffic >= static_cast<uint8_t>(traffic::SpeedGroup::Count))
+    return traffic::SpeedGroup::Unknown;
+  return static_cast<traffic::SpeedGroup>(traffic);
+}
+}  // namespace
+
+TrackArchiver::TrackArchiver(std::string const & rootDir, size_t archiveSize,
+                             double minDelaySeconds, uint32_t protocolVersion)
+  : m_rootDir(rootDir)
+  , m_archiveSize(archiveSize)
+  , m_minDelaySeconds(minDelaySeconds)
+  , m_protocolVersion(protocolVersion)
+{
+  CHECK_GREATER(m_archiveSize, 0, ());
+}
+
+void TrackArchiver::SetClientId(uint64_t connectionId, std::string const & clientId)
+{
+  auto & track = GetTrack(connectionId);
+  if (track.m_archive.Size() > 0)
+    Dump(track);
+  track.m_dirName = GetDirName(clientId, connectionId);
+}
+
+void TrackArchiver::Add(uint64_t connectionId, Protocol::DataElementsVec const & points)
+{
+  auto & track = GetTrack(connectionId);
+  for (auto const & point : points)
+  {
+    auto const timestamp = point.m_timestamp;
+    bool const isOutOfOrder =
+        track.m_lastTimestamp != 0 && timestamp < track.m_lastTimestamp + m_minDelaySeconds;
+    if (timestamp < kMinTimestamp || timestamp > kMaxTimestamp || isOutOfOrder)
+    {
+      ++m_stats.m_droppedPoints;
+      continue;
+    }
+
+    uint64_t const day = timestamp / kSecondsInDay;
+    if (track.m_archive.Size() > 0 && day != track.m_day)
+      Dump(track);
+
+    if (track.m_archive.Size() == 0)
+    {
+      track.m_day = day;
+      track.m_firstTimestamp = timestamp;
+    }
+
+    track.m_archive.Add(point.m_latLon.m_lat, point.m_latLon.m_lon,
+                        static_cast<uint32_t>(timestamp), GetSpeedGroup(point.m_traffic));
+    track.m_lastTimestamp = timestamp;
+    ++m_stats.m_points;
+
+    if (track.m_archive.ReadyToDump())
+      Dump(track);
+  }
+}
+
+void TrackArchiver::Close(uint64_t connectionId)
+{
+  auto const it = m_tracks.find(connectionId);
+  if (it == m_tracks.end())
+    return;
+
+  if (it->second.m_archive.Size() > 0)
+    Dump(it->second);
+  m_tracks.erase(it);
+}
+
+void TrackArchiver::CloseAll()
+{
+  for (auto & item : m_tracks)
+  {
+    if (item.second.m_archive.Size() > 0)
+      Dump(item.second);
+  }
+  m_tracks.clear();
+}
+
+// static
+std::string TrackArchiver::DayToString(uint64_t day)
+{
+  // Conversion of days to the civil date, see
+  // http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+  uint64_t const z = day + 719468;
+  uint64_t const era = z / 146097;
+  uint64_t const dayOfEra = z - era * 146097;
+  uint64_t const yearOfEra =
+      (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  uint64_t const dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  uint64_t const shiftedMonth = (5 * dayOfYear + 2) / 153;
+  uint64_t const dayOfMonth = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+  uint64_t const month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+  uint64_t const year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%04u-%02u-%02u", static_cast<unsigned>(year),
+                static_cast<unsigned>(month), static_cast<unsigned>(dayOfMonth));
+  return buf;
+}
+
+TrackArchiver::Track & TrackArchiver::GetTrack(uint64_t connectionId)
+{
+  auto it = m_tracks.find(connectionId);
+  if (it == m_tracks.end())
+  {
+    it = m_tracks.emplace(connectionId, Track(m_archiveSize, m_minDelaySeconds)).first;
+    it->second.m_dirName = GetDirName({} /* clientId */, connectionId);
+  }
+  return it->second;
+}
+
+void TrackArchiver::Dump(Track & track)
+{
+  std::string const dir = base::JoinPath(m_rootDir, DayToString(track.m_day), track.m_dirName);
+  std::string const fileName = archival_file::GetArchiveFilename(
+      static_cast<uint8_t>(m_protocolVersion), std::chrono::seconds(track.m_firstTimestamp),
+      routing::RouterType::Vehicle);
+
+  if (!Platform::MkDirRecursively(dir))
+  {
+    LOG(LWARNING, ("Can't create directory", dir, "dropping", track.m_archive.Size(), "points"));
+    track.m_archive.Clear();
+    return;
+  }
+
+  try
+  {
+    FileWriter writer(base::JoinPath(dir, fileName));
+    if (track.m_archive.Write(writer))
+      ++m_stats.m_files;
+  }
+  catch (RootException const & e)
+  {
+    LOG(LWARNING, ("Can't write archive", fileName, "to", dir, e.Msg()));
+  }
+  // Write() keeps the points on failure, but there is no sense to retry.
+  track.m_archive.Clear();
+}
+}  // namespace tracking
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "tracking/archival_reporter.hpp"
+#include "tracking/protocol.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace tracking
+{
+// Server side of the tracks archiving. Points received from a connection are accumulated
+// in ArchiveCar and written to files compatible with BasicArchive::Read():
+// |rootDir|/YYYY-MM-DD/<client id>_<connection id>/<archival_file::GetArchiveFilename()>.
+// The date and the file timestamp are the ones of the first point of the file. A new file is
+// started when the archive is full or a point of the next day (UTC) comes.
+// Connection ids must be unique for |rootDir|, otherwise files of different connections may
+// overwrite each other. The class is not thread safe.
+class TrackArchiver
+{
+public:
+  struct Stats
+  {
+    uint64_t m_points = 0;
+    // Points which are out of order or too close in time to the previous ones.
+    uint64_t m_droppedPoints = 0;
+    uint64_t m_files = 0;
+  };
+
+  TrackArchiver(std::string const & rootDir, size_t archiveSize, double minDelaySeconds,
+                uint32_t protocolVersion);
+
+  void SetClientId(uint64_t connectionId, std::string const & clientId);
+  void Add(uint64_t connectionId, Protocol::DataElementsVec const & points);
+  // Writes the rest of the points of the connection and forgets it.
+  void Close(uint64_t connectionId);
+  void CloseAll();
+
+  Stats const & GetStats() const { return m_stats; }
+
+  // Returns the directory name of the |day| since epoch. gmtime() is not used since it is not
+  // thread safe.
+  static std::string DayToString(uint64_t day);
+
+private:
+  struct Track
+  {
+    Track(size_t archiveSize, double minDelaySeconds)
+      : m_archive(archiveSize, minDelaySeconds)
+    {
+    }
+
+    ArchiveCar m_archive;
+    std::string m_dirName;
+    uint64_t m_day = 0;
+    uint64_t m_firstTimestamp = 0;
+    uint64_t m_lastTimestamp = 0;
+  };
+
+  Track & GetTrack(uint64_t connectionId);
+  void Dump(Track & track);
+
+  std::string const m_rootDir;
+  size_t const m_archiveSize;
+  double const m_minDelaySeconds;
+  uint32_t const m_protocolVersion;
+
+  std::unordered_map<uint64_t, Track> m_tracks;
+  Stats m_stats;
+};
+}  // namespace tracking
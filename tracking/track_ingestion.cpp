@@ -0,0 +1,241 @@
+#include "tracking/track_ingestion.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include <utility>
+
+namespace tracking
+{
+// PacketsBatch ------------------------------------------------------------------------------------
+void PacketsBatch::AddPacket(uint64_t connectionId, Protocol::PacketType type,
+                             uint8_t const * data, size_t size)
+{
+  Event e;
+  e.m_eventType = EventType::Packet;
+  e.m_packetType = type;
+  e.m_connectionId = connectionId;
+  e.m_offset = m_data.size();
+  e.m_size = size;
+  m_events.push_back(e);
+  m_data.insert(m_data.end(), data, data + size);
+}
+
+void PacketsBatch::AddDisconnect(uint64_t connectionId)
+{
+  Event e;
+  e.m_eventType = EventType::Disconnect;
+  e.m_connectionId = connectionId;
+  e.m_offset = m_data.size();
+  m_events.push_back(e);
+}
+
+void PacketsBatch::Clear()
+{
+  m_events.clear();
+  m_data.clear();
+}
+
+// IngestionPipeline::Worker -----------------------------------------------------------------------
+IngestionPipeline::Worker::Worker(IngestionPipeline & pipeline,
+                                  IngestionSettings const & settings)
+  : m_pipeline(pipeline)
+  , m_archiver(settings.m_archivesDir, settings.m_archiveSize, settings.m_minDelaySeconds,
+               settings.m_protocolVersion)
+{
+  m_thread = std::thread(&Worker::Run, this);
+}
+
+void IngestionPipeline::Worker::Push(std::unique_ptr<PacketsBatch> batch,
+                                     size_t maxQueuedBatches)
+{
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [&] { return m_queue.size() < maxQueuedBatches; });
+    m_queue.push_back(std::move(batch));
+  }
+  m_cv.notify_all();
+}
+
+void IngestionPipeline::Worker::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopped = true;
+  }
+  m_cv.notify_all();
+}
+
+void IngestionPipeline::Worker::Join()
+{
+  if (m_thread.joinable())
+    m_thread.join();
+}
+
+void IngestionPipeline::Worker::Run()
+{
+  while (true)
+  {
+    std::unique_ptr<PacketsBatch> batch;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait(lock, [this] { return m_stopped || !m_queue.empty(); });
+      // Queued batches are handled even after Stop().
+      if (m_queue.empty())
+        break;
+      batch = std::move(m_queue.front());
+      m_queue.pop_front();
+    }
+    // Wakes the producer which may wait for the space in the queue.
+    m_cv.notify_all();
+
+    Handle(*batch);
+    m_pipeline.ReturnFreeBatch(std::move(batch));
+  }
+
+  m_archiver.CloseAll();
+  m_pipeline.m_files += m_archiver.GetStats().m_files - m_reportedStats.m_files;
+}
+
+void IngestionPipeline::Worker::Handle(PacketsBatch const & batch)
+{
+  uint64_t packets = 0;
+  uint64_t malformedPackets = 0;
+  batch.ForEachEvent([&](PacketsBatch::Event const & e, uint8_t const * data) {
+    if (e.m_eventType == PacketsBatch::EventType::Disconnect)
+    {
+      m_archiver.Close(e.m_connectionId);
+      return;
+    }
+
+    ++packets;
+    switch (e.m_packetType)
+    {
+    case Protocol::PacketType::AuthV0:
+      m_archiver.SetClientId(e.m_connectionId,
+                             std::string(reinterpret_cast<char const *>(data), e.m_size));
+      return;
+    case Protocol::PacketType::DataV0:
+    case Protocol::PacketType::DataV1:
+      m_points.clear();
+      if (Protocol::DecodeDataPacket(e.m_packetType, data, e.m_size, m_points))
+        m_archiver.Add(e.m_connectionId, m_points);
+      else
+        ++malformedPackets;
+      return;
+    case Protocol::PacketType::Error: break;
+    }
+    ++malformedPackets;
+  });
+
+  auto const & stats = m_archiver.GetStats();
+  m_pipeline.m_packets += packets;
+  m_pipeline.m_malformedPackets += malformedPackets;
+  m_pipeline.m_points += stats.m_points - m_reportedStats.m_points;
+  m_pipeline.m_droppedPoints += stats.m_droppedPoints - m_reportedStats.m_droppedPoints;
+  m_pipeline.m_files += stats.m_files - m_reportedStats.m_files;
+  m_reportedStats = stats;
+}
+
+// IngestionPipeline -------------------------------------------------------------------------------
+IngestionPipeline::IngestionPipeline(IngestionSettings const & settings) : m_settings(settings)
+{
+  CHECK_GREATER(m_settings.m_workersCount, 0, ());
+  CHECK_GREATER(m_settings.m_maxQueuedBatches, 0, ());
+
+  for (size_t i = 0; i < m_settings.m_workersCount; ++i)
+  {
+    m_workers.push_back(std::make_unique<Worker>(*this, m_settings));
+    m_batches.push_back(TakeFreeBatch());
+  }
+}
+
+IngestionPipeline::~IngestionPipeline() { Stop(); }
+
+void IngestionPipeline::AddPacket(uint64_t connectionId, Protocol::PacketType type,
+                                  uint8_t const * data, size_t size)
+{
+  CHECK(!m_stopped, ());
+  auto & batch = GetBatch(connectionId);
+  batch.AddPacket(connectionId, type, data, size);
+  if (batch.GetDataSize() >= m_settings.m_maxBatchSize)
+    FlushBatch(connectionId % m_workers.size());
+}
+
+void IngestionPipeline::AddDisconnect(uint64_t connectionId)
+{
+  CHECK(!m_stopped, ());
+  GetBatch(connectionId).AddDisconnect(connectionId);
+}
+
+void IngestionPipeline::Flush()
+{
+  for (size_t i = 0; i < m_batches.size(); ++i)
+  {
+    if (!m_batches[i]->IsEmpty())
+      FlushBatch(i);
+  }
+}
+
+void IngestionPipeline::Stop()
+{
+  if (m_stopped)
+    return;
+
+  Flush();
+  for (auto & worker : m_workers)
+    worker->Stop();
+  for (auto & worker : m_workers)
+    worker->Join();
+  m_stopped = true;
+
+  auto const stats = GetStats();
+  LOG(LINFO, ("Ingestion is stopped. Packets:", stats.m_packets, "malformed packets:",
+              stats.m_malformedPackets, "points:", stats.m_points, "dropped points:",
+              stats.m_droppedPoints, "files:", stats.m_files));
+}
+
+IngestionPipeline::Stats IngestionPipeline::GetStats() const
+{
+  Stats stats;
+  stats.m_packets = m_packets;
+  stats.m_malformedPackets = m_malformedPackets;
+  stats.m_points = m_points;
+  stats.m_droppedPoints = m_droppedPoints;
+  stats.m_files = m_files;
+  return stats;
+}
+
+PacketsBatch & IngestionPipeline::GetBatch(uint64_t connectionId)
+{
+  return *m_batches[connectionId % m_batches.size()];
+}
+
+void IngestionPipeline::FlushBatch(size_t workerIndex)
+{
+  auto batch = TakeFreeBatch();
+  std::swap(batch, m_batches[workerIndex]);
+  m_workers[workerIndex]->Push(std::move(batch), m_settings.m_maxQueuedBatches);
+}
+
+std::unique_ptr<PacketsBatch> IngestionPipeline::TakeFreeBatch()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_freeBatchesMutex);
+    if (!m_freeBatches.empty())
+    {
+      auto batch = std::move(m_freeBatches.back());
+      m_freeBatches.pop_back();
+      return batch;
+    }
+  }
+  return std::make_unique<PacketsBatch>();
+}
+
+void IngestionPipeline::ReturnFreeBatch(std::unique_ptr<PacketsBatch> batch)
+{
+  batch->Clear();
+  std::lock_guard<std::mutex> lock(m_freeBatchesMutex);
+  m_freeBatches.push_back(std::move(batch));
+}
+}  // namespace tracking
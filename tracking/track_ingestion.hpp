@@ -0,0 +1,159 @@
+#pragma once
+
+#include "tracking/archival_manager.hpp"
+#include "tracking/archival_reporter.hpp"
+#include "tracking/protocol.hpp"
+#include "tracking/track_archiver.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tracking
+{
+// Events of many connections collected by a network thread to be handled by a worker at once.
+// Payloads are stored in one buffer, so a batch doesn't allocate anything when it is reused.
+class PacketsBatch
+{
+public:
+  enum class EventType : uint8_t
+  {
+    Packet,
+    Disconnect
+  };
+
+  struct Event
+  {
+    EventType m_eventType = EventType::Packet;
+    Protocol::PacketType m_packetType = Protocol::PacketType::Error;
+    uint64_t m_connectionId = 0;
+    size_t m_offset = 0;
+    size_t m_size = 0;
+  };
+
+  void AddPacket(uint64_t connectionId, Protocol::PacketType type, uint8_t const * data,
+                 size_t size);
+  void AddDisconnect(uint64_t connectionId);
+  void Clear();
+
+  bool IsEmpty() const { return m_events.empty(); }
+  size_t GetEventsCount() const { return m_events.size(); }
+  size_t GetDataSize() const { return m_data.size(); }
+
+  // Calls |fn| with the event and its payload for every event in the order of addition.
+  template <typename Fn>
+  void ForEachEvent(Fn && fn) const
+  {
+    for (auto const & e : m_events)
+      fn(e, m_data.data() + e.m_offset);
+  }
+
+private:
+  std::vector<Event> m_events;
+  std::vector<uint8_t> m_data;
+};
+
+struct IngestionSettings
+{
+  std::string m_archivesDir;
+  size_t m_workersCount = 4;
+  size_t m_archiveSize = kItemsForDump;
+  double m_minDelaySeconds = kMinDelaySecondsCar;
+  uint32_t m_protocolVersion = ArchivingSettings().m_version;
+  // A batch is passed to a worker when it has this many bytes of payloads or when
+  // Flush() is called.
+  size_t m_maxBatchSize = 256 * 1024;
+  // The producer is blocked when a worker has this many batches in the queue, so a slow disk
+  // slows down receiving of the data instead of the unbounded memory growth.
+  size_t m_maxQueuedBatches = 16;
+};
+
+// Decodes data packets on worker threads and passes the points to TrackArchiver. All the events
+// of a connection are handled by the same worker, so points are archived in order and
+// the per-connection state is never shared between threads. Every worker decodes packets into
+// its own reused vector, so there are no allocations per packet or per point.
+// Events must be added from one thread only.
+class IngestionPipeline
+{
+public:
+  struct Stats
+  {
+    uint64_t m_packets = 0;
+    uint64_t m_malformedPackets = 0;
+    uint64_t m_points = 0;
+    uint64_t m_droppedPoints = 0;
+    uint64_t m_files = 0;
+  };
+
+  explicit IngestionPipeline(IngestionSettings const & settings);
+  ~IngestionPipeline();
+
+  void AddPacket(uint64_t connectionId, Protocol::PacketType type, uint8_t const * data,
+                 size_t size);
+  void AddDisconnect(uint64_t connectionId);
+  // Passes all the collected events to the workers.
+  void Flush();
+  // Handles all the passed events, writes all the archives and stops the workers.
+  void Stop();
+
+  // Stats of the handled batches.
+  Stats GetStats() const;
+
+private:
+  class Worker
+  {
+  public:
+    Worker(IngestionPipeline & pipeline, IngestionSettings const & settings);
+
+    void Push(std::unique_ptr<PacketsBatch> batch, size_t maxQueuedBatches);
+    void Stop();
+    void Join();
+
+  private:
+    void Run();
+    void Handle(PacketsBatch const & batch);
+
+    IngestionPipeline & m_pipeline;
+    TrackArchiver m_archiver;
+    Protocol::DataElementsVec m_points;
+    TrackArchiver::Stats m_reportedStats;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::unique_ptr<PacketsBatch>> m_queue;
+    bool m_stopped = false;
+
+    std::thread m_thread;
+  };
+
+  PacketsBatch & GetBatch(uint64_t connectionId);
+  void FlushBatch(size_t workerIndex);
+
+  std::unique_ptr<PacketsBatch> TakeFreeBatch();
+  void ReturnFreeBatch(std::unique_ptr<PacketsBatch> batch);
+
+  IngestionSettings const m_settings;
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  // Batches being filled, one per worker.
+  std::vector<std::unique_ptr<PacketsBatch>> m_batches;
+
+  std::mutex m_freeBatchesMutex;
+  std::vector<std::unique_ptr<PacketsBatch>> m_freeBatches;
+
+  std::atomic<uint64_t> m_packets{0};
+  std::atomic<uint64_t> m_malformedPackets{0};
+  std::atomic<uint64_t> m_points{0};
+  std::atomic<uint64_t> m_droppedPoints{0};
+  std::atomic<uint64_t> m_files{0};
+
+  bool m_stopped = false;
+};
+}  // namespace tracking
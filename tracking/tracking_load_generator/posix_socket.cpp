@@ -0,0 +1,125 @@
+#include "tracking/tracking_load_generator/posix_socket.hpp"
+
+#include "base/logging.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace tracking
+{
+PosixSocket::~PosixSocket() { Close(); }
+
+bool PosixSocket::Open(std::string const & host, uint16_t port)
+{
+  if (m_socket != -1)
+    return false;
+
+  addrinfo hints;
+  std::memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  addrinfo * addresses = nullptr;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0)
+  {
+    LOG(LWARNING, ("Can't resolve", host));
+    return false;
+  }
+
+  for (auto const * addr = addresses; addr; addr = addr->ai_next)
+  {
+    m_socket = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+    if (m_socket == -1)
+      continue;
+    if (connect(m_socket, addr->ai_addr, addr->ai_addrlen) == 0)
+      break;
+    close(m_socket);
+    m_socket = -1;
+  }
+  freeaddrinfo(addresses);
+
+  if (m_socket == -1)
+  {
+    LOG(LWARNING, ("Can't connect to", host, port, std::strerror(errno)));
+    return false;
+  }
+
+  int const noDelay = 1;
+  setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+#ifdef SO_NOSIGPIPE
+  int const noSigPipe = 1;
+  setsockopt(m_socket, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+  ApplyTimeout();
+  return true;
+}
+
+void PosixSocket::Close()
+{
+  if (m_socket == -1)
+    return;
+
+  close(m_socket);
+  m_socket = -1;
+}
+
+bool PosixSocket::Read(uint8_t * data, uint32_t count)
+{
+  while (count > 0)
+  {
+    ssize_t const received = recv(m_socket, data, count, 0 /* flags */);
+    if (received < 0 && errno == EINTR)
+      continue;
+    if (received <= 0)
+      return false;
+    data += received;
+    count -= static_cast<uint32_t>(received);
+  }
+  return true;
+}
+
+bool PosixSocket::Write(uint8_t const * data, uint32_t count)
+{
+#ifdef MSG_NOSIGNAL
+  int constexpr kFlags = MSG_NOSIGNAL;
+#else
+  int constexpr kFlags = 0;
+#endif
+  while (count > 0)
+  {
+    ssize_t const sent = send(m_socket, data, count, kFlags);
+    if (sent < 0 && errno == EINTR)
+      continue;
+    if (sent <= 0)
+      return false;
+    data += sent;
+    count -= static_cast<uint32_t>(sent);
+  }
+  return true;
+}
+
+void PosixSocket::SetTimeout(uint32_t milliseconds)
+{
+  m_timeoutMs = milliseconds;
+  ApplyTimeout();
+}
+
+void PosixSocket::ApplyTimeout()
+{
+  if (m_socket == -1)
+    return;
+
+  timeval tv;
+  tv.tv_sec = m_timeoutMs / 1000;
+  tv.tv_usec = (m_timeoutMs % 1000) * 1000;
+  setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  setsockopt(m_socket, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+}  // namespace tracking
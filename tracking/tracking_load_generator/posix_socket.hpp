@@ -0,0 +1,30 @@
+#pragma once
+
+#include "platform/socket.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace tracking
+{
+// Blocking TCP socket for desktop tools. platform::CreateSocket() returns a working socket
+// on mobile platforms only.
+class PosixSocket final : public platform::Socket
+{
+public:
+  ~PosixSocket() override;
+
+  // platform::Socket overrides:
+  bool Open(std::string const & host, uint16_t port) override;
+  void Close() override;
+  bool Read(uint8_t * data, uint32_t count) override;
+  bool Write(uint8_t const * data, uint32_t count) override;
+  void SetTimeout(uint32_t milliseconds) override;
+
+private:
+  void ApplyTimeout();
+
+  int m_socket = -1;
+  uint32_t m_timeoutMs = 0;
+};
+}  // namespace tracking
@@ -0,0 +1,158 @@
+#include "tracking/tracking_load_generator/posix_socket.hpp"
+
+#include "tracking/connection.hpp"
+#include "tracking/protocol.hpp"
+
+#include "geometry/latlon.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+DEFINE_string(host, "localhost", "Host of the tracking server.");
+
+DEFINE_int32(port, 0, "Port of the tracking server.");
+
+DEFINE_int32(connections, 100, "Number of simultaneous connections.");
+
+DEFINE_int32(threads, 4, "Threads sending the packets, connections are split between them.");
+
+DEFINE_int32(packets, 100, "Packets to send by every connection.");
+
+DEFINE_int32(points, 60, "Points in every packet.");
+
+namespace
+{
+using tracking::DataPoint;
+
+struct Client
+{
+  std::unique_ptr<tracking::Connection> m_connection;
+  uint64_t m_timestamp = 0;
+  ms::LatLon m_latLon;
+};
+
+struct Totals
+{
+  std::atomic<uint64_t> m_packets{0};
+  std::atomic<uint64_t> m_points{0};
+  std::atomic<uint64_t> m_failedConnections{0};
+  std::atomic<uint64_t> m_failedPackets{0};
+};
+
+void RunClients(size_t connectionsCount, uint64_t seed, Totals & totals)
+{
+  std::mt19937 rng(static_cast<std::mt19937::result_type>(seed));
+  std::uniform_real_distribution<double> startLat(-60.0, 60.0);
+  std::uniform_real_distribution<double> startLon(-170.0, 170.0);
+  std::uniform_real_distribution<double> step(-0.0005, 0.0005);
+  std::uniform_int_distribution<int> traffic(0, 7);
+
+  // Points of the last hours, so the archives go to the current day directories mostly.
+  uint64_t const startTimestamp = base::SecondsSinceEpoch() -
+                                  static_cast<uint64_t>(FLAGS_packets) * FLAGS_points;
+
+  std::vector<Client> clients(connectionsCount);
+  for (auto & client : clients)
+  {
+    client.m_connection = std::make_unique<tracking::Connection>(
+        std::make_unique<tracking::PosixSocket>(), FLAGS_host,
+        static_cast<uint16_t>(FLAGS_port), false /* isHistorical */);
+    if (!client.m_connection->Reconnect())
+    {
+      ++totals.m_failedConnections;
+      client.m_connection.reset();
+      continue;
+    }
+    client.m_timestamp = startTimestamp;
+    client.m_latLon = ms::LatLon(startLat(rng), startLon(rng));
+  }
+
+  boost::circular_buffer<DataPoint> points(static_cast<size_t>(FLAGS_points));
+  for (int32_t packet = 0; packet < FLAGS_packets; ++packet)
+  {
+    for (auto & client : clients)
+    {
+      if (!client.m_connection)
+        continue;
+
+      points.clear();
+      for (int32_t i = 0; i < FLAGS_points; ++i)
+      {
+        client.m_latLon.m_lat = std::clamp(client.m_latLon.m_lat + step(rng),
+                                           ms::LatLon::kMinLat, ms::LatLon::kMaxLat);
+        client.m_latLon.m_lon = std::clamp(client.m_latLon.m_lon + step(rng),
+                                           ms::LatLon::kMinLon, ms::LatLon::kMaxLon);
+        points.push_back(DataPoint(client.m_timestamp++, client.m_latLon,
+                                   static_cast<uint8_t>(traffic(rng))));
+      }
+
+      if (!client.m_connection->Send(points))
+      {
+        ++totals.m_failedPackets;
+        client.m_connection.reset();
+        continue;
+      }
+      ++totals.m_packets;
+      totals.m_points += points.size();
+    }
+  }
+
+  for (auto & client : clients)
+  {
+    if (client.m_connection)
+      client.m_connection->Shutdown();
+  }
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  gflags::SetUsageMessage(
+      "Sends tracks of many simultaneous tracking::Connection clients to a tracking server "
+      "and measures the throughput.\n\n"
+      "Usage example: "
+      "./tracking_load_generator -port=10000 -connections=1000 -threads=8");
+
+  gflags::ParseCommandLineFlags(&argc, &argv, true /* remove_flags */);
+
+  if (FLAGS_port <= 0 || FLAGS_port > 0xFFFF || FLAGS_connections <= 0 || FLAGS_threads <= 0 ||
+      FLAGS_packets <= 0 || FLAGS_points <= 0)
+  {
+    LOG(LINFO, ("Port is required, all the counts must be positive."));
+    gflags::ShowUsageWithFlags(argv[0]);
+    return 1;
+  }
+
+  size_t const threadsCount =
+      std::min(static_cast<size_t>(FLAGS_threads), static_cast<size_t>(FLAGS_connections));
+  Totals totals;
+  base::Timer timer;
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < threadsCount; ++i)
+  {
+    size_t const connectionsCount = static_cast<size_t>(FLAGS_connections) / threadsCount +
+                                    (i < static_cast<size_t>(FLAGS_connections) % threadsCount);
+    threads.emplace_back(RunClients, connectionsCount, i, std::ref(totals));
+  }
+  for (auto & thread : threads)
+    thread.join();
+
+  double const seconds = std::max(timer.ElapsedSeconds(), 1e-6);
+  LOG(LINFO, ("Connections:", FLAGS_connections, "failed:", totals.m_failedConnections.load()));
+  LOG(LINFO, ("Packets:", totals.m_packets.load(), "failed:", totals.m_failedPackets.load()));
+  LOG(LINFO, ("Points:", totals.m_points.load(), "in", seconds, "seconds,",
+              static_cast<uint64_t>(totals.m_points / seconds), "points per second"));
+  return totals.m_failedConnections == 0 && totals.m_failedPackets == 0 ? 0 : 1;
+}
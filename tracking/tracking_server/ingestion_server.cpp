@@ -0,0 +1,269 @@
+#include "tracking/tracking_server/ingestion_server.hpp"
+
+#include "tracking/protocol.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace tracking
+{
+namespace
+{
+int constexpr kPollTimeoutMs = 100;
+size_t constexpr kReceiveSize = 64 * 1024;
+// Limits the data received from one connection per poll() round, so a fast client doesn't
+// starve the others.
+size_t constexpr kMaxReceivesPerRound = 16;
+// A client which doesn't read the replies is disconnected.
+size_t constexpr kMaxPendingOutputSize = 64 * 1024;
+
+bool SetNonBlocking(int socket)
+{
+  int const flags = fcntl(socket, F_GETFL, 0);
+  return flags != -1 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+pollfd MakePollFd(int socket)
+{
+  pollfd fd;
+  fd.fd = socket;
+  fd.events = POLLIN;
+  fd.revents = 0;
+  return fd;
+}
+}  // namespace
+
+IngestionServer::IngestionServer(uint16_t port, size_t maxPayloadSize,
+                                 IngestionSettings const & settings)
+  : m_port(port), m_maxPayloadSize(maxPayloadSize), m_pipeline(settings)
+{
+  // Ids of the connections are the part of the archive paths, so they must not repeat
+  // after a restart of the server.
+  m_nextConnectionId = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+}
+
+IngestionServer::~IngestionServer()
+{
+  for (size_t i = m_connections.size(); i > 0; --i)
+    Close(i - 1);
+  if (m_listenSocket != -1)
+    close(m_listenSocket);
+}
+
+bool IngestionServer::Run()
+{
+  if (!Listen())
+    return false;
+
+  LOG(LINFO, ("Listening on port", m_port));
+  while (!m_stopped)
+  {
+    int const ready = poll(m_pollFds.data(), m_pollFds.size(), kPollTimeoutMs);
+    if (ready < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      LOG(LERROR, ("poll() failed:", std::strerror(errno)));
+      break;
+    }
+
+    if (ready > 0)
+    {
+      // Backward order since Close() moves the last connection to the place of the closed one.
+      for (size_t i = m_connections.size(); i > 0; --i)
+      {
+        auto const revents = m_pollFds[i].revents;
+        if (revents == 0)
+          continue;
+
+        auto & connection = *m_connections[i - 1];
+        bool isAlive = (revents & (POLLERR | POLLNVAL)) == 0;
+        if (isAlive && (revents & (POLLIN | POLLHUP)) != 0)
+          isAlive = Receive(connection);
+        if (isAlive)
+          isAlive = Send(connection);
+
+        if (!isAlive)
+        {
+          Close(i - 1);
+          continue;
+        }
+
+        // The rest of the replies is sent when the socket is writable again.
+        m_pollFds[i].events = connection.m_output.empty() ? POLLIN : (POLLIN | POLLOUT);
+      }
+
+      if (m_pollFds[0].revents & POLLIN)
+        Accept();
+    }
+
+    m_pipeline.Flush();
+  }
+
+  for (size_t i = m_connections.size(); i > 0; --i)
+    Close(i - 1);
+  m_pipeline.Stop();
+  return true;
+}
+
+bool IngestionServer::Listen()
+{
+  m_listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+  if (m_listenSocket == -1)
+  {
+    LOG(LERROR, ("socket() failed:", std::strerror(errno)));
+    return false;
+  }
+
+  int const reuse = 1;
+  setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(m_port);
+  if (bind(m_listenSocket, reinterpret_cast<sockaddr const *>(&addr), sizeof(addr)) == -1 ||
+      listen(m_listenSocket, SOMAXCONN) == -1 || !SetNonBlocking(m_listenSocket))
+  {
+    LOG(LERROR, ("Can't listen on port", m_port, std::strerror(errno)));
+    return false;
+  }
+
+  m_pollFds.push_back(MakePollFd(m_listenSocket));
+  return true;
+}
+
+void IngestionServer::Accept()
+{
+  while (true)
+  {
+    int const socket = accept(m_listenSocket, nullptr /* addr */, nullptr /* addrlen */);
+    if (socket == -1)
+    {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        LOG(LWARNING, ("accept() failed:", std::strerror(errno)));
+      return;
+    }
+
+    if (!SetNonBlocking(socket))
+    {
+      close(socket);
+      continue;
+    }
+
+    m_connections.push_back(
+        std::make_unique<ClientConnection>(socket, m_nextConnectionId++, m_maxPayloadSize));
+    m_pollFds.push_back(MakePollFd(socket));
+  }
+}
+
+bool IngestionServer::Receive(ClientConnection & connection)
+{
+  bool isClosed = false;
+  for (size_t i = 0; i < kMaxReceivesPerRound; ++i)
+  {
+    uint8_t * buffer = connection.m_stream.Reserve(kReceiveSize);
+    ssize_t const received = recv(connection.m_socket, buffer, kReceiveSize, 0 /* flags */);
+    if (received == 0)
+    {
+      isClosed = true;
+      break;
+    }
+    if (received < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      isClosed = errno != EAGAIN && errno != EWOULDBLOCK;
+      break;
+    }
+
+    connection.m_stream.Commit(static_cast<size_t>(received));
+    if (static_cast<size_t>(received) < kReceiveSize)
+      break;
+  }
+
+  bool isValid = true;
+  bool const isStreamValid = connection.m_stream.ForEachPacket(
+      [&](Protocol::PacketType type, uint8_t const * data, size_t size) {
+        if (!isValid)
+          return;
+
+        if (type == Protocol::PacketType::AuthV0)
+        {
+          auto & output = connection.m_output;
+          output.insert(output.end(), std::begin(Protocol::kOk), std::end(Protocol::kOk));
+          isValid = output.size() <= kMaxPendingOutputSize;
+          if (!isValid)
+            LOG(LWARNING, ("Replies are not read, connection", connection.m_id));
+          connection.m_isAuthorized = isValid;
+        }
+        else if (!connection.m_isAuthorized)
+        {
+          LOG(LWARNING, ("Data packet before authorization, connection", connection.m_id));
+          isValid = false;
+        }
+
+        if (isValid)
+          m_pipeline.AddPacket(connection.m_id, type, data, size);
+      });
+
+  if (!isStreamValid)
+    LOG(LWARNING, ("Corrupted stream, connection", connection.m_id));
+
+  return !isClosed && isValid && isStreamValid;
+}
+
+bool IngestionServer::Send(ClientConnection & connection)
+{
+  auto & output = connection.m_output;
+  size_t sentSize = 0;
+  while (sentSize < output.size())
+  {
+    ssize_t const sent = send(connection.m_socket, output.data() + sentSize,
+                              output.size() - sentSize, 0 /* flags */);
+    if (sent < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        break;
+
+      LOG(LWARNING, ("send() failed:", std::strerror(errno), "connection", connection.m_id));
+      return false;
+    }
+    sentSize += static_cast<size_t>(sent);
+  }
+
+  output.erase(output.begin(), output.begin() + sentSize);
+  return true;
+}
+
+void IngestionServer::Close(size_t index)
+{
+  ASSERT_LESS(index, m_connections.size(), ());
+  auto & connection = *m_connections[index];
+  m_pipeline.AddDisconnect(connection.m_id);
+  close(connection.m_socket);
+
+  std::swap(m_connections[index], m_connections.back());
+  m_connections.pop_back();
+  std::swap(m_pollFds[index + 1], m_pollFds.back());
+  m_pollFds.pop_back();
+}
+}  // namespace tracking
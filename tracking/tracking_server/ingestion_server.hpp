@@ -0,0 +1,70 @@
+#pragma once
+
+#include "tracking/packet_stream.hpp"
+#include "tracking/track_ingestion.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <poll.h>
+
+namespace tracking
+{
+// Receives packets of tracking::Connection clients and passes them to IngestionPipeline.
+// All the sockets are served by one thread with poll(): the thread only splits the streams
+// into packets and answers AUTH packets, data packets are decoded and archived by
+// the pipeline workers.
+class IngestionServer
+{
+public:
+  IngestionServer(uint16_t port, size_t maxPayloadSize, IngestionSettings const & settings);
+  ~IngestionServer();
+
+  // Serves the connections until Stop() is called. Returns false if the port can't be listened.
+  bool Run();
+  // May be called from any thread or from a signal handler.
+  void Stop() { m_stopped = true; }
+
+  size_t GetConnectionsCount() const { return m_connections.size(); }
+  IngestionPipeline::Stats GetStats() const { return m_pipeline.GetStats(); }
+
+private:
+  struct ClientConnection
+  {
+    ClientConnection(int socket, uint64_t id, size_t maxPayloadSize)
+      : m_socket(socket), m_id(id), m_stream(maxPayloadSize)
+    {
+    }
+
+    int m_socket = -1;
+    uint64_t m_id = 0;
+    bool m_isAuthorized = false;
+    PacketStream m_stream;
+    // Replies which are not sent yet because the socket buffer is full.
+    std::vector<uint8_t> m_output;
+  };
+
+  bool Listen();
+  void Accept();
+  // Returns false if the connection is closed by the client or must be closed because of
+  // an error.
+  bool Receive(ClientConnection & connection);
+  // Sends the pending replies as much as the socket accepts. Returns false on an error.
+  bool Send(ClientConnection & connection);
+  void Close(size_t index);
+
+  uint16_t const m_port;
+  size_t const m_maxPayloadSize;
+  IngestionPipeline m_pipeline;
+  std::atomic<bool> m_stopped{false};
+
+  int m_listenSocket = -1;
+  // The listening socket goes first, then the sockets of |m_connections| in the same order.
+  std::vector<pollfd> m_pollFds;
+  std::vector<std::unique_ptr<ClientConnection>> m_connections;
+  uint64_t m_nextConnectionId = 0;
+};
+}  // namespace tracking
@@ -0,0 +1,77 @@
+#include "tracking/tracking_server/ingestion_server.hpp"
+
+#include "tracking/track_ingestion.hpp"
+
+#include "base/logging.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <thread>
+
+#include <gflags/gflags.h>
+
+DEFINE_int32(port, 0, "Port to listen for tracking::Connection clients.");
+
+DEFINE_string(archives_dir, "", "Directory to write the track archives to.");
+
+DEFINE_int32(workers, 0, "Threads to decode and archive the packets. Number of cores by default.");
+
+DEFINE_int32(archive_size, 0, "Points in one archive file. Same as clients use by default.");
+
+DEFINE_int32(max_payload_size, 1024 * 1024,
+             "Connections sending packets with bigger payloads are closed, at most 16 Mb.");
+
+namespace
+{
+tracking::IngestionServer * g_server = nullptr;
+
+void OnSignal(int)
+{
+  if (g_server)
+    g_server->Stop();
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  gflags::SetUsageMessage(
+      "Receives tracks of tracking::Connection clients and writes them to the per day "
+      "archives compatible with tracking/archive.hpp.\n\n"
+      "Usage example: "
+      "./tracking_server -port=10000 -archives_dir=/path/to/archives/");
+
+  gflags::ParseCommandLineFlags(&argc, &argv, true /* remove_flags */);
+
+  if (FLAGS_port <= 0 || FLAGS_port > 0xFFFF || FLAGS_archives_dir.empty())
+  {
+    LOG(LINFO, ("Port and archives directory are required."));
+    gflags::ShowUsageWithFlags(argv[0]);
+    return 1;
+  }
+
+  if (FLAGS_max_payload_size <= 0 || FLAGS_max_payload_size > 0xFFFFFF)
+  {
+    LOG(LINFO, ("Wrong max payload size", FLAGS_max_payload_size));
+    return 1;
+  }
+
+  tracking::IngestionSettings settings;
+  settings.m_archivesDir = FLAGS_archives_dir;
+  settings.m_workersCount = FLAGS_workers > 0
+                                ? static_cast<size_t>(FLAGS_workers)
+                                : std::max(1U, std::thread::hardware_concurrency());
+  if (FLAGS_archive_size > 0)
+    settings.m_archiveSize = static_cast<size_t>(FLAGS_archive_size);
+
+  tracking::IngestionServer server(static_cast<uint16_t>(FLAGS_port),
+                                   static_cast<size_t>(FLAGS_max_payload_size), settings);
+  g_server = &server;
+  std::signal(SIGINT, OnSignal);
+  std::signal(SIGTERM, OnSignal);
+  // Writes to the closed connections must fail instead of killing the server.
+  std::signal(SIGPIPE, SIG_IGN);
+
+  bool const isOk = server.Run();
+  g_server = nullptr;
+  return isOk ? 0 : 1;
+}
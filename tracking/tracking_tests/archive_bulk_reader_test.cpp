@@ -0,0 +1,169 @@
+#include "testing/testing.hpp"
+
+#include "tracking/archival_file.hpp"
+#include "tracking/archive.hpp"
+#include "tracking/archive_bulk_reader.hpp"
+
+#include "platform/platform.hpp"
+#include "platform/platform_tests_support/scoped_dir.hpp"
+
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+
+#include "base/file_name_utils.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace archive_bulk_reader_test
+{
+using namespace std;
+using namespace tracking;
+
+uint32_t constexpr kStartTimestamp = 1573227904;
+
+template <typename Pack>
+vector<Pack> MakePacks(size_t count, uint32_t firstTimestamp);
+
+template <>
+vector<Packet> MakePacks(size_t count, uint32_t firstTimestamp)
+{
+  vector<Packet> packs;
+  for (size_t i = 0; i < count; ++i)
+    packs.emplace_back(-33.9 + i * 1e-4, 151.2 + i * 2e-4, firstTimestamp + 3 * i);
+  return packs;
+}
+
+template <>
+vector<PacketCar> MakePacks(size_t count, uint32_t firstTimestamp)
+{
+  vector<PacketCar> packs;
+  for (size_t i = 0; i < count; ++i)
+  {
+    packs.emplace_back(55.75 + i * 1e-4, 37.61 - i * 1e-4, firstTimestamp + 5 * i,
+                       static_cast<traffic::SpeedGroup>(i % 4));
+  }
+  return packs;
+}
+
+template <typename Pack>
+string WriteArchive(string const & dir, routing::RouterType type, vector<Pack> const & packs)
+{
+  string const path = base::JoinPath(
+      dir, archival_file::GetArchiveFilename(1 /* protocolVersion */,
+                                             chrono::seconds(packs.front().m_timestamp), type));
+  BasicArchive<Pack> archive(packs.size(), 1.0 /* minDelaySeconds */);
+  for (auto const & pack : packs)
+    TEST(archive.Add(pack), ());
+
+  FileWriter writer(path);
+  TEST(archive.Write(writer), ());
+  return path;
+}
+
+// The columns must be the same as BasicArchive reads.
+template <typename Pack>
+void TestEqualArchive(TrackColumns const & columns, ArchiveBulkReader::FileRange const & range,
+                      string const & path, size_t expectedSize)
+{
+  BasicArchive<Pack> archive(expectedSize, 1.0 /* minDelaySeconds */);
+  FileReader reader(path);
+  ReaderSource<FileReader> src(reader);
+  TEST(archive.Read(src), (path));
+  auto const packs = archive.Extract();
+
+  TEST(range.m_isOk, ());
+  TEST_EQUAL(range.m_size, expectedSize, ());
+  TEST_EQUAL(range.m_size, packs.size(), ());
+  for (size_t i = 0; i < packs.size(); ++i)
+  {
+    size_t const j = range.m_offset + i;
+    TEST_EQUAL(columns.m_timestamp[j], packs[i].m_timestamp, ());
+    TEST_EQUAL(columns.m_lat[j], packs[i].m_lat, ());
+    TEST_EQUAL(columns.m_lon[j], packs[i].m_lon, ());
+    TEST_EQUAL(static_cast<traffic::SpeedGroup>(columns.m_speedGroup[j]),
+               TraitsPacket<Pack>::GetSpeedGroup(packs[i]), ());
+  }
+}
+
+UNIT_TEST(ArchiveBulkReader_Smoke)
+{
+  platform::tests_support::ScopedDir dir("archive_bulk_reader_test");
+  string const & root = dir.GetFullPath();
+
+  vector<vector<PacketCar>> carTracks;
+  vector<vector<Packet>> pedestrianTracks;
+  vector<string> files;
+  for (uint32_t i = 0; i < 20; ++i)
+  {
+    uint32_t const timestamp = kStartTimestamp + i * 10000;
+    if (i % 3 == 0)
+    {
+      pedestrianTracks.push_back(MakePacks<Packet>(10 + i, timestamp));
+      files.push_back(WriteArchive(root, routing::RouterType::Pedestrian, pedestrianTracks.back()));
+    }
+    else
+    {
+      carTracks.push_back(MakePacks<PacketCar>(100 + i, timestamp));
+      files.push_back(WriteArchive(root, routing::RouterType::Vehicle, carTracks.back()));
+    }
+  }
+
+  string const broken = base::JoinPath(root, "broken.track");
+  {
+    FileWriter writer(broken);
+    string const garbage = "garbage";
+    writer.Write(garbage.data(), garbage.size());
+  }
+  files.insert(files.begin() + 5, broken);
+  files.push_back(base::JoinPath(root, "absent.track"));
+
+  TrackColumns columns;
+  for (size_t threadsCount : {size_t{1}, size_t{3}, size_t{8}})
+  {
+    ArchiveBulkReader reader(threadsCount);
+    // The reader is reused and the columns are replaced.
+    for (size_t run = 0; run < 2; ++run)
+    {
+      auto const ranges = reader.Read(files, columns);
+      TEST_EQUAL(ranges.size(), files.size(), ());
+
+      size_t carTrack = 0;
+      size_t pedestrianTrack = 0;
+      size_t offset = 0;
+      for (size_t i = 0; i < files.size(); ++i)
+      {
+        auto const & range = ranges[i];
+        TEST_EQUAL(range.m_offset, offset, ());
+        offset += range.m_size;
+
+        if (files[i] == broken || i + 1 == files.size())
+        {
+          TEST(!range.m_isOk, ());
+          TEST_EQUAL(range.m_size, 0, ());
+        }
+        else if (range.m_info.m_trackType == routing::RouterType::Vehicle)
+        {
+          TestEqualArchive<PacketCar>(columns, range, files[i], carTracks[carTrack++].size());
+        }
+        else
+        {
+          TEST_EQUAL(range.m_info.m_trackType, routing::RouterType::Pedestrian, ());
+          TestEqualArchive<Packet>(columns, range, files[i],
+                                   pedestrianTracks[pedestrianTrack++].size());
+        }
+      }
+      TEST_EQUAL(carTrack, carTracks.size(), ());
+      TEST_EQUAL(pedestrianTrack, pedestrianTracks.size(), ());
+      TEST_EQUAL(columns.Size(), offset, ());
+      TEST_EQUAL(columns.m_lat.size(), offset, ());
+      TEST_EQUAL(columns.m_speedGroup.size(), offset, ());
+    }
+  }
+
+  TEST(Platform::RmDirRecursively(root), ());
+  dir.Reset();
+}
+}  // namespace archive_bulk_reader_test
@@ -0,0 +1,275 @@
+#include "testing/testing.hpp"
+
+#include "tracking/archival_file.hpp"
+#include "tracking/archival_reporter.hpp"
+#include "tracking/packet_stream.hpp"
+#include "tracking/protocol.hpp"
+#include "tracking/track_archiver.hpp"
+#include "tracking/track_ingestion.hpp"
+
+#include "platform/platform.hpp"
+#include "platform/platform_tests_support/scoped_dir.hpp"
+
+#include "coding/file_reader.hpp"
+
+#include "geometry/latlon.hpp"
+
+#include "base/file_name_utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace track_ingestion_test
+{
+using namespace std;
+using namespace tracking;
+
+uint64_t constexpr kSecondsInDay = 24 * 60 * 60;
+
+Protocol::DataElementsVec MakePoints(uint64_t firstTimestamp, size_t count)
+{
+  Protocol::DataElementsVec points;
+  for (size_t i = 0; i < count; ++i)
+  {
+    points.emplace_back(firstTimestamp + i, ms::LatLon(55.75 + i * 1e-4, 37.61 - i * 1e-4),
+                        2 /* traffic */);
+  }
+  return points;
+}
+
+Protocol::DataElementsVec ReadArchive(string const & path)
+{
+  ArchiveCar archive(kItemsForDump, kMinDelaySecondsCar);
+  FileReader reader(path);
+  ReaderSource<FileReader> src(reader);
+  TEST(archive.Read(src), (path));
+
+  Protocol::DataElementsVec points;
+  for (auto const & packet : archive.Extract())
+  {
+    points.emplace_back(packet.m_timestamp, ms::LatLon(packet.m_lat, packet.m_lon),
+                        static_cast<uint8_t>(packet.m_speedGroup));
+  }
+  return points;
+}
+
+// Coordinates are stored with the limited precision.
+template <typename It>
+void TestEqualPoints(Protocol::DataElementsVec const & actual, It expectedBegin, It expectedEnd)
+{
+  TEST_EQUAL(actual.size(), static_cast<size_t>(distance(expectedBegin, expectedEnd)), ());
+  for (size_t i = 0; i < actual.size(); ++i, ++expectedBegin)
+  {
+    TEST_EQUAL(actual[i].m_timestamp, expectedBegin->m_timestamp, ());
+    TEST(actual[i].m_latLon.EqualDxDy(expectedBegin->m_latLon, 1e-5),
+         (actual[i].m_latLon, expectedBegin->m_latLon));
+    TEST_EQUAL(actual[i].m_traffic, expectedBegin->m_traffic, ());
+  }
+}
+
+UNIT_TEST(Protocol_DecodeDataPacketAppends)
+{
+  auto const points = MakePoints(1573227904, 10);
+  auto const packet = Protocol::CreateDataPacket(points, Protocol::PacketType::DataV1);
+  uint8_t const * payload = packet.data() + Protocol::kHeaderSize;
+  size_t const payloadSize = packet.size() - Protocol::kHeaderSize;
+
+  Protocol::DataElementsVec decoded;
+  TEST(Protocol::DecodeDataPacket(Protocol::PacketType::DataV1, payload, payloadSize, decoded),
+       ());
+  TEST(Protocol::DecodeDataPacket(Protocol::PacketType::DataV1, payload, payloadSize, decoded),
+       ());
+  TEST_EQUAL(decoded.size(), 2 * points.size(), ());
+  TestEqualPoints(Protocol::DataElementsVec(decoded.begin(), decoded.begin() + points.size()),
+                  points.begin(), points.end());
+  TestEqualPoints(Protocol::DataElementsVec(decoded.begin() + points.size(), decoded.end()),
+                  points.begin(), points.end());
+
+  // A truncated payload doesn't change the result.
+  TEST(!Protocol::DecodeDataPacket(Protocol::PacketType::DataV1, payload, payloadSize - 1,
+                                   decoded),
+       ());
+  TEST_EQUAL(decoded.size(), 2 * points.size(), ());
+}
+
+UNIT_TEST(PacketStream_Chunks)
+{
+  auto const points = MakePoints(1573227904, 20);
+  vector<uint8_t> stream = Protocol::CreateAuthPacket("ABC");
+  for (auto const type : {Protocol::PacketType::DataV0, Protocol::PacketType::DataV1})
+  {
+    auto const packet = Protocol::CreateDataPacket(points, type);
+    stream.insert(stream.end(), packet.begin(), packet.end());
+  }
+
+  for (size_t const chunkSize : {size_t{1}, size_t{3}, size_t{17}, stream.size()})
+  {
+    PacketStream packetStream(1024 /* maxPayloadSize */);
+    vector<Protocol::PacketType> types;
+    Protocol::DataElementsVec decoded;
+    for (size_t pos = 0; pos < stream.size(); pos += chunkSize)
+    {
+      size_t const size = min(chunkSize, stream.size() - pos);
+      copy_n(stream.data() + pos, size, packetStream.Reserve(size));
+      packetStream.Commit(size);
+      TEST(packetStream.ForEachPacket(
+               [&](Protocol::PacketType type, uint8_t const * data, size_t dataSize) {
+                 types.push_back(type);
+                 if (type == Protocol::PacketType::AuthV0)
+                   TEST_EQUAL(string(data, data + dataSize), "ABC", ());
+                 else
+                   TEST(Protocol::DecodeDataPacket(type, data, dataSize, decoded), ());
+               }),
+           ());
+    }
+
+    TEST_EQUAL(types, vector<Protocol::PacketType>({Protocol::PacketType::AuthV0,
+                                                    Protocol::PacketType::DataV0,
+                                                    Protocol::PacketType::DataV1}),
+               (chunkSize));
+    TEST_EQUAL(packetStream.GetPendingSize(), 0, ());
+    TEST_EQUAL(decoded.size(), 2 * points.size(), ());
+  }
+}
+
+UNIT_TEST(PacketStream_Corrupted)
+{
+  auto const noop = [](Protocol::PacketType, uint8_t const *, size_t) {};
+  {
+    PacketStream stream(1024 /* maxPayloadSize */);
+    auto const packet = Protocol::CreateDataPacket(MakePoints(1573227904, 1000),
+                                                   Protocol::PacketType::DataV1);
+    copy(packet.begin(), packet.end(), stream.Reserve(packet.size()));
+    stream.Commit(packet.size());
+    TEST(!stream.ForEachPacket(noop), ());
+  }
+  {
+    PacketStream stream(1024 /* maxPayloadSize */);
+    vector<uint8_t> const packet = {0x55, 0, 0, 1, 0};
+    copy(packet.begin(), packet.end(), stream.Reserve(packet.size()));
+    stream.Commit(packet.size());
+    TEST(!stream.ForEachPacket(noop), ());
+  }
+}
+
+UNIT_TEST(TrackArchiver_DayToString)
+{
+  TEST_EQUAL(TrackArchiver::DayToString(0), "1970-01-01", ());
+  TEST_EQUAL(TrackArchiver::DayToString(11016), "2000-02-29", ());
+  TEST_EQUAL(TrackArchiver::DayToString(18999), "2022-01-07", ());
+  TEST_EQUAL(TrackArchiver::DayToString(19000), "2022-01-08", ());
+}
+
+UNIT_TEST(TrackArchiver_DailyArchives)
+{
+  platform::tests_support::ScopedDir dir("track_archiver_test");
+  string const & root = dir.GetFullPath();
+
+  // The track crosses the midnight.
+  uint64_t const midnight = 19000 * kSecondsInDay;
+  auto const points = MakePoints(midnight - 30, 60);
+
+  {
+    TrackArchiver archiver(root, 1000 /* archiveSize */, kMinDelaySecondsCar,
+                           1 /* protocolVersion */);
+    archiver.SetClientId(7, "ABC");
+    archiver.Add(7, Protocol::DataElementsVec(points.begin(), points.begin() + 40));
+    // Points older than the last one are dropped.
+    archiver.Add(7, Protocol::DataElementsVec(points.begin() + 10, points.begin() + 20));
+    archiver.Add(7, Protocol::DataElementsVec(points.begin() + 40, points.end()));
+    archiver.CloseAll();
+
+    TEST_EQUAL(archiver.GetStats().m_points, points.size(), ());
+    TEST_EQUAL(archiver.GetStats().m_droppedPoints, 10, ());
+    TEST_EQUAL(archiver.GetStats().m_files, 2, ());
+  }
+
+  auto const fileName = [](uint64_t timestamp) {
+    return archival_file::GetArchiveFilename(1 /* protocolVersion */,
+                                             chrono::seconds(timestamp),
+                                             routing::RouterType::Vehicle);
+  };
+  string const first = base::JoinPath(root, "2022-01-07", "ABC_7", fileName(midnight - 30));
+  string const second = base::JoinPath(root, "2022-01-08", "ABC_7", fileName(midnight));
+
+  TestEqualPoints(ReadArchive(first), points.begin(), points.begin() + 30);
+  TestEqualPoints(ReadArchive(second), points.begin() + 30, points.end());
+
+  TEST(Platform::RmDirRecursively(root), ());
+  dir.Reset();
+}
+
+UNIT_TEST(IngestionPipeline_Smoke)
+{
+  platform::tests_support::ScopedDir dir("ingestion_pipeline_test");
+  string const & root = dir.GetFullPath();
+
+  size_t constexpr kConnections = 10;
+  size_t constexpr kPackets = 5;
+  size_t constexpr kPointsInPacket = 20;
+  uint64_t const start = 19000 * kSecondsInDay;
+
+  IngestionSettings settings;
+  settings.m_archivesDir = root;
+  settings.m_workersCount = 3;
+  settings.m_archiveSize = 30;
+  // Forces many small batches.
+  settings.m_maxBatchSize = 100;
+  settings.m_maxQueuedBatches = 2;
+
+  IngestionPipeline pipeline(settings);
+  for (uint64_t id = 0; id < kConnections; ++id)
+    pipeline.AddPacket(id, Protocol::PacketType::AuthV0, nullptr, 0);
+
+  auto const points = MakePoints(start, kPackets * kPointsInPacket);
+  for (size_t i = 0; i < kPackets; ++i)
+  {
+    Protocol::DataElementsVec const packetPoints(points.begin() + i * kPointsInPacket,
+                                                 points.begin() + (i + 1) * kPointsInPacket);
+    auto const packet = Protocol::CreateDataPacket(packetPoints, Protocol::PacketType::DataV1);
+    for (uint64_t id = 0; id < kConnections; ++id)
+    {
+      pipeline.AddPacket(id, Protocol::PacketType::DataV1, packet.data() + Protocol::kHeaderSize,
+                         packet.size() - Protocol::kHeaderSize);
+    }
+    pipeline.Flush();
+  }
+
+  vector<uint8_t> const garbage = {1, 2, 3};
+  pipeline.AddPacket(0, Protocol::PacketType::DataV1, garbage.data(), garbage.size());
+  for (uint64_t id = 0; id < kConnections; ++id)
+    pipeline.AddDisconnect(id);
+  pipeline.Stop();
+
+  auto const stats = pipeline.GetStats();
+  TEST_EQUAL(stats.m_packets, kConnections * (kPackets + 1) + 1, ());
+  TEST_EQUAL(stats.m_malformedPackets, 1, ());
+  TEST_EQUAL(stats.m_points, kConnections * points.size(), ());
+  TEST_EQUAL(stats.m_droppedPoints, 0, ());
+  // 100 points are written by 30 to 4 files per connection.
+  TEST_EQUAL(stats.m_files, kConnections * 4, ());
+
+  Platform::FilesList files;
+  Platform::GetFilesRecursively(root, files);
+  TEST_EQUAL(files.size(), stats.m_files, ());
+
+  string const connectionDir = base::JoinPath(root, "2022-01-08", "unknown_3");
+  Protocol::DataElementsVec track;
+  for (size_t i = 0; i < points.size(); i += settings.m_archiveSize)
+  {
+    auto const file = archival_file::GetArchiveFilename(
+        1 /* protocolVersion */, chrono::seconds(start + i), routing::RouterType::Vehicle);
+    auto const archived = ReadArchive(base::JoinPath(connectionDir, file));
+    track.insert(track.end(), archived.begin(), archived.end());
+  }
+  TestEqualPoints(track, points.begin(), points.end());
+
+  TEST(Platform::RmDirRecursively(root), ());
+  dir.Reset();
+}
+}  // namespace track_ingestion_test
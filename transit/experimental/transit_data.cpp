@@ -552,6 +552,11 @@ void TransitData::Serialize(Writer & writer)
 
   m_header.m_endOffset = base::checked_cast<uint32_t>(writer.Pos() - startOffset);
 
+  // The timetable is appended after the entities, so the header format is kept and old readers
+  // just ignore it.
+  m_timetable.Build(m_stops, m_edges, m_lines);
+  serializer(m_timetable);
+
   // Overwriting updated header.
   CHECK(m_header.IsValid(), (m_header));
   auto const endOffset = writer.Pos();
@@ -559,7 +564,8 @@ void TransitData::Serialize(Writer & writer)
   fixedSizeSerializer(m_header);
   writer.Seek(endOffset);
 
-  LOG(LINFO, (TRANSIT_FILE_TAG, "experimental section is ready. Header:", m_header));
+  LOG(LINFO, (TRANSIT_FILE_TAG, "experimental section is ready. Header:", m_header,
+              "timetable patterns:", m_timetable.GetPatternsCount()));
 }
 
 void TransitData::Deserialize(Reader & reader)
@@ -574,6 +580,7 @@ void TransitData::Deserialize(Reader & reader)
     ReadShapes(src);
     ReadRoutes(src);
     ReadNetworks(src);
+    ReadTimetable(src);
   });
 }
 
@@ -585,6 +592,8 @@ void TransitData::DeserializeForRouting(Reader & reader)
     ReadEdges(src);
     src.Skip(m_header.m_linesOffset - src.Pos());
     ReadLines(src);
+    src.Skip(m_header.m_endOffset - src.Pos());
+    ReadTimetable(src);
   });
 }
 
@@ -616,6 +625,7 @@ void TransitData::Clear()
 {
   ClearVisitor const visitor;
   Visit(visitor);
+  m_timetable.Clear();
 }
 
 void TransitData::CheckValid() const
@@ -716,5 +726,16 @@ void TransitData::ReadNetworks(NonOwningReaderSource & src)
 {
   ReadItems(m_header.m_networksOffset, m_header.m_endOffset, "networks", src, m_networks);
 }
+
+void TransitData::ReadTimetable(NonOwningReaderSource & src)
+{
+  CHECK_EQUAL(src.Pos(), m_header.m_endOffset, ("Wrong", TRANSIT_FILE_TAG, "section format."));
+  m_timetable.Clear();
+  if (src.Size() == 0)
+    return;
+
+  routing::transit::Deserializer<NonOwningReaderSource> deserializer(src);
+  deserializer(m_timetable);
+}
 }  // namespace experimental
 }  // namespace transit
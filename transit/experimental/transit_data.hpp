@@ -1,5 +1,6 @@
 #pragma once
 
+#include "transit/experimental/transit_timetable.hpp"
 #include "transit/experimental/transit_types_experimental.hpp"
 
 #include "coding/reader.hpp"
@@ -44,7 +45,8 @@ class TransitData
 {
 public:
   void DeserializeFromJson(std::string const & dirWithJsons, OsmIdToFeatureIdsMap const & mapping);
-  /// \note This method changes only |m_header| and fills it with correct offsets.
+  /// \note This method changes only |m_header| and |m_timetable| and fills |m_header| with correct
+  /// offsets. The timetable is built from the entities and is written after |m_endOffset|.
   void Serialize(Writer & writer);
   void Deserialize(Reader & reader);
   void DeserializeForRouting(Reader & reader);
@@ -71,6 +73,8 @@ public:
   std::vector<Network> const & GetNetworks() const { return m_networks; }
 
   EdgeIdToFeatureId const & GetEdgeIdToFeatureId() const { return m_edgeFeatureIds; }
+  /// \note Empty for sections generated before the timetable was added.
+  Timetable const & GetTimetable() const { return m_timetable; }
 
 private:
   DECLARE_VISITOR_AND_DEBUG_PRINT(TransitData, visitor(m_stops, "stops"), visitor(m_gates, "gates"),
@@ -90,6 +94,7 @@ private:
   void ReadShapes(NonOwningReaderSource & src);
   void ReadRoutes(NonOwningReaderSource & src);
   void ReadNetworks(NonOwningReaderSource & src);
+  void ReadTimetable(NonOwningReaderSource & src);
 
   template <typename Fn>
   void DeserializeWith(Reader & reader, Fn && fn)
@@ -111,6 +116,7 @@ private:
   std::vector<Shape> m_shapes;
 
   EdgeIdToFeatureId m_edgeFeatureIds;
+  Timetable m_timetable;
 };
 }  // namespace experimental
 }  // namespace transit
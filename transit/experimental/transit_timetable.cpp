@@ -0,0 +1,389 @@
+#include "transit/experimental/transit_timetable.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+#include "base/logging.hpp"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+namespace transit
+{
+namespace experimental
+{
+namespace
+{
+uint32_t constexpr kSecondsInDay = 24 * 60 * 60;
+uint32_t constexpr kInfinity = std::numeric_limits<uint32_t>::max();
+
+uint32_t ToSeconds(Time const & time)
+{
+  return time.m_hour * 60 * 60 + time.m_minute * 60 + time.m_second;
+}
+
+uint32_t GetSecondsOfDay(time_t time)
+{
+  std::tm tm;
+  localtime_r(&time, &tm);
+  return base::checked_cast<uint32_t>(tm.tm_hour * 60 * 60 + tm.tm_min * 60 + tm.tm_sec);
+}
+
+// Calls |fn| with start, end and headway of every service interval of the day containing |time|.
+template <typename Fn>
+void ForEachServiceInterval(Schedule const & schedule, time_t time, Fn && fn)
+{
+  auto const * frequencies = schedule.GetServiceDayFrequencies(time);
+  if (frequencies && !frequencies->GetFrequencies().empty())
+  {
+    for (auto const & [interval, headway] : frequencies->GetFrequencies())
+    {
+      auto const & [start, end] = interval.Extract();
+      fn(ToSeconds(start), ToSeconds(end), headway);
+    }
+    return;
+  }
+
+  // Lines without service days or time intervals run all day with the default headway.
+  bool const noServiceDays =
+      schedule.GetServiceIntervals().empty() && schedule.GetServiceExceptions().empty();
+  if ((frequencies || noServiceDays) && schedule.GetFrequency() != kDefaultFrequency)
+    fn(0 /* start */, kSecondsInDay, schedule.GetFrequency());
+}
+
+// Calls |fn| with the start time of every trip running in the interval.
+template <typename Fn>
+void ForEachTripStart(uint32_t start, uint32_t end, Frequency headway, Fn && fn)
+{
+  uint32_t tripStart = start;
+  do
+  {
+    fn(tripStart);
+    tripStart += headway;
+  } while (headway != kDefaultFrequency && tripStart < end);
+}
+}  // namespace
+
+// Timetable ---------------------------------------------------------------------------------------
+bool Timetable::operator==(Timetable const & rhs) const
+{
+  return std::tie(m_stopIds, m_lineIds, m_patternStarts, m_patternStops, m_arrivalOffsets,
+                  m_footpathStarts, m_footpaths) ==
+         std::tie(rhs.m_stopIds, rhs.m_lineIds, rhs.m_patternStarts, rhs.m_patternStops,
+                  rhs.m_arrivalOffsets, rhs.m_footpathStarts, rhs.m_footpaths);
+}
+
+void Timetable::Build(std::vector<Stop> const & stops, std::vector<Edge> const & edges,
+                      std::vector<Line> const & lines)
+{
+  Clear();
+
+  m_stopIds.reserve(stops.size());
+  for (auto const & stop : stops)
+    m_stopIds.push_back(stop.GetId());
+  std::sort(m_stopIds.begin(), m_stopIds.end());
+  m_stopIds.erase(std::unique(m_stopIds.begin(), m_stopIds.end()), m_stopIds.end());
+
+  // Ride times between consecutive stops by line, first stop and second stop.
+  std::map<std::tuple<TransitId, TransitId, TransitId>, EdgeWeight> rides;
+  std::vector<std::vector<Footpath>> footpaths(m_stopIds.size());
+  for (auto const & edge : edges)
+  {
+    if (!edge.IsTransfer())
+    {
+      rides.emplace(std::make_tuple(edge.GetLineId(), edge.GetStop1Id(), edge.GetStop2Id()),
+                    edge.GetWeight());
+      continue;
+    }
+
+    auto const from = GetStopIndex(edge.GetStop1Id());
+    auto const to = GetStopIndex(edge.GetStop2Id());
+    if (from != kInvalidIndex && to != kInvalidIndex)
+      footpaths[from].emplace_back(to, edge.GetWeight());
+  }
+
+  std::vector<Line const *> sortedLines;
+  sortedLines.reserve(lines.size());
+  for (auto const & line : lines)
+    sortedLines.push_back(&line);
+  std::sort(sortedLines.begin(), sortedLines.end(),
+            [](Line const * lhs, Line const * rhs) { return lhs->GetId() < rhs->GetId(); });
+
+  m_patternStarts.push_back(0);
+  size_t skippedLines = 0;
+  for (auto const * line : sortedLines)
+  {
+    auto const & stopIds = line->GetStopIds();
+    if (stopIds.size() < 2)
+      continue;
+
+    auto const patternStart = m_patternStops.size();
+    uint32_t offset = 0;
+    bool isValid = true;
+    for (size_t i = 0; i < stopIds.size() && isValid; ++i)
+    {
+      auto const stopIndex = GetStopIndex(stopIds[i]);
+      isValid = stopIndex != kInvalidIndex;
+      if (isValid && i != 0)
+      {
+        auto const it = rides.find(std::make_tuple(line->GetId(), stopIds[i - 1], stopIds[i]));
+        isValid = it != rides.cend();
+        if (isValid)
+          offset += it->second;
+      }
+
+      m_patternStops.push_back(stopIndex);
+      m_arrivalOffsets.push_back(offset);
+    }
+
+    if (!isValid)
+    {
+      m_patternStops.resize(patternStart);
+      m_arrivalOffsets.resize(patternStart);
+      ++skippedLines;
+      continue;
+    }
+
+    m_lineIds.push_back(line->GetId());
+    m_patternStarts.push_back(base::checked_cast<uint32_t>(m_patternStops.size()));
+  }
+
+  if (skippedLines != 0)
+    LOG(LINFO, ("Lines without stops or edges skipped in timetable:", skippedLines));
+
+  m_footpathStarts.reserve(footpaths.size() + 1);
+  m_footpathStarts.push_back(0);
+  for (auto & stopFootpaths : footpaths)
+  {
+    std::sort(stopFootpaths.begin(), stopFootpaths.end(),
+              [](Footpath const & lhs, Footpath const & rhs) { return lhs.m_stop < rhs.m_stop; });
+    m_footpaths.insert(m_footpaths.end(), stopFootpaths.begin(), stopFootpaths.end());
+    m_footpathStarts.push_back(base::checked_cast<uint32_t>(m_footpaths.size()));
+  }
+}
+
+void Timetable::Clear()
+{
+  m_stopIds.clear();
+  m_lineIds.clear();
+  m_patternStarts.clear();
+  m_patternStops.clear();
+  m_arrivalOffsets.clear();
+  m_footpathStarts.clear();
+  m_footpaths.clear();
+}
+
+uint32_t Timetable::GetStopIndex(TransitId stopId) const
+{
+  auto const it = std::lower_bound(m_stopIds.cbegin(), m_stopIds.cend(), stopId);
+  if (it == m_stopIds.cend() || *it != stopId)
+    return kInvalidIndex;
+
+  return static_cast<uint32_t>(std::distance(m_stopIds.cbegin(), it));
+}
+
+Timetable::Day Timetable::MakeDay(std::vector<Line> const & lines, time_t time) const
+{
+  Day day;
+  for (uint32_t pattern = 0; pattern < m_lineIds.size(); ++pattern)
+  {
+    auto const lineId = m_lineIds[pattern];
+    auto const line = std::lower_bound(
+        lines.cbegin(), lines.cend(), lineId,
+        [](Line const & line, TransitId id) { return line.GetId() < id; });
+    if (line == lines.cend() || line->GetId() != lineId)
+      continue;
+
+    auto const begin = m_patternStarts[pattern];
+    auto const end = m_patternStarts[pattern + 1];
+    ForEachServiceInterval(line->GetSchedule(), time, [&](uint32_t start, uint32_t finish,
+                                                          Frequency headway) {
+      ForEachTripStart(start, finish, headway, [&](uint32_t tripStart) {
+        auto const trip = base::checked_cast<uint32_t>(day.m_tripPatterns.size());
+        day.m_tripPatterns.push_back(pattern);
+        for (auto i = begin; i + 1 < end; ++i)
+        {
+          day.m_connections.push_back({m_patternStops[i], m_patternStops[i + 1],
+                                       tripStart + m_arrivalOffsets[i],
+                                       tripStart + m_arrivalOffsets[i + 1], trip});
+        }
+      });
+    });
+  }
+
+  // Connections of a trip with zero ride time keep their order.
+  std::stable_sort(day.m_connections.begin(), day.m_connections.end(),
+                   [](Connection const & lhs, Connection const & rhs) {
+                     return std::tie(lhs.m_departureTime, lhs.m_arrivalTime) <
+                            std::tie(rhs.m_departureTime, rhs.m_arrivalTime);
+                   });
+  return day;
+}
+
+std::optional<uint32_t> Timetable::GetWaitingTime(TransitId lineId, Schedule const & schedule,
+                                                  TransitId stopId, time_t time) const
+{
+  auto const stopIndex = GetStopIndex(stopId);
+  auto const pattern = std::lower_bound(m_lineIds.cbegin(), m_lineIds.cend(), lineId);
+  if (stopIndex == kInvalidIndex || pattern == m_lineIds.cend() || *pattern != lineId)
+    return {};
+
+  auto const patternIdx = std::distance(m_lineIds.cbegin(), pattern);
+  auto const begin = m_patternStops.cbegin() + m_patternStarts[patternIdx];
+  auto const end = m_patternStops.cbegin() + m_patternStarts[patternIdx + 1];
+  auto const stop = std::find(begin, end, stopIndex);
+  if (stop == end)
+    return {};
+
+  auto const offset = m_arrivalOffsets[std::distance(m_patternStops.cbegin(), stop)];
+  auto const now = GetSecondsOfDay(time);
+
+  std::optional<uint32_t> waitingTime;
+  ForEachServiceInterval(schedule, time, [&](uint32_t start, uint32_t end, Frequency headway) {
+    // Trips depart from the stop at |start| + |offset| + k * |headway|.
+    uint32_t tripStart = start;
+    if (now > start + offset)
+    {
+      if (headway == kDefaultFrequency)
+        return;
+      tripStart += (now - start - offset + headway - 1) / headway * headway;
+      if (tripStart >= end)
+        return;
+    }
+
+    auto const waiting = tripStart + offset - now;
+    if (!waitingTime || waiting < *waitingTime)
+      waitingTime = waiting;
+  });
+
+  return waitingTime;
+}
+
+// ConnectionScan ----------------------------------------------------------------------------------
+ConnectionScan::ConnectionScan(Timetable const & timetable, Timetable::Day const & day)
+  : m_timetable(timetable), m_day(day)
+{
+}
+
+std::optional<ConnectionScan::Journey> ConnectionScan::FindEarliestArrival(
+    std::vector<StopTime> const & sources, std::vector<StopTime> const & targets)
+{
+  auto const stopsCount = m_timetable.GetStopsCount();
+  m_earliestArrival.assign(stopsCount, kInfinity);
+  m_labels.assign(stopsCount, Label());
+  m_tripEnter.assign(m_day.m_tripPatterns.size(), Timetable::kInvalidIndex);
+  m_timeToDestination.assign(stopsCount, kInfinity);
+  m_bestArrival = kInfinity;
+  m_bestTarget = Timetable::kInvalidIndex;
+
+  for (auto const & target : targets)
+  {
+    CHECK_LESS(target.m_stop, stopsCount, ());
+    m_timeToDestination[target.m_stop] = std::min(m_timeToDestination[target.m_stop], target.m_time);
+  }
+
+  uint32_t startTime = kInfinity;
+  for (auto const & source : sources)
+  {
+    CHECK_LESS(source.m_stop, stopsCount, ());
+    if (source.m_time < m_earliestArrival[source.m_stop])
+      Reach(source.m_stop, source.m_time, Label());
+    startTime = std::min(startTime, source.m_time);
+  }
+
+  auto const & connections = m_day.m_connections;
+  auto const first = std::lower_bound(connections.cbegin(), connections.cend(), startTime,
+                                      [](Timetable::Connection const & c, uint32_t time) {
+                                        return c.m_departureTime < time;
+                                      });
+  for (auto it = first; it != connections.cend(); ++it)
+  {
+    auto const & c = *it;
+    if (c.m_departureTime >= m_bestArrival)
+      break;
+
+    auto & enter = m_tripEnter[c.m_trip];
+    if (enter == Timetable::kInvalidIndex)
+    {
+      if (m_earliestArrival[c.m_departureStop] > c.m_departureTime)
+        continue;
+      enter = static_cast<uint32_t>(std::distance(connections.cbegin(), it));
+    }
+
+    if (c.m_arrivalTime < m_earliestArrival[c.m_arrivalStop])
+    {
+      Label label;
+      label.m_enter = enter;
+      label.m_exit = static_cast<uint32_t>(std::distance(connections.cbegin(), it));
+      Reach(c.m_arrivalStop, c.m_arrivalTime, label);
+    }
+  }
+
+  if (m_bestTarget == Timetable::kInvalidIndex)
+    return {};
+
+  Journey journey;
+  journey.m_arrivalTime = m_bestArrival;
+  for (auto stop = m_bestTarget; journey.m_legs.size() <= stopsCount;)
+  {
+    auto const & label = m_labels[stop];
+    Leg leg;
+    leg.m_toStop = stop;
+    leg.m_arrivalTime = m_earliestArrival[stop];
+    if (label.m_exit != Timetable::kInvalidIndex)
+    {
+      auto const & enter = connections[label.m_enter];
+      auto const & exit = connections[label.m_exit];
+      leg.m_fromStop = enter.m_departureStop;
+      leg.m_departureTime = enter.m_departureTime;
+      leg.m_arrivalTime = exit.m_arrivalTime;
+      leg.m_lineId = m_timetable.GetLineId(m_day.m_tripPatterns[exit.m_trip]);
+    }
+    else if (label.m_footpathFrom != Timetable::kInvalidIndex)
+    {
+      leg.m_fromStop = label.m_footpathFrom;
+      leg.m_departureTime = m_earliestArrival[label.m_footpathFrom];
+    }
+    else
+    {
+      std::reverse(journey.m_legs.begin(), journey.m_legs.end());
+      return journey;
+    }
+
+    stop = leg.m_fromStop;
+    journey.m_legs.push_back(leg);
+  }
+
+  CHECK(false, ("Cycle in connection scan labels."));
+  return {};
+}
+
+void ConnectionScan::Reach(uint32_t stop, uint32_t time, Label const & label)
+{
+  auto const updateDestination = [this](uint32_t stop) {
+    auto const timeToDestination = m_timeToDestination[stop];
+    if (timeToDestination != kInfinity &&
+        m_earliestArrival[stop] + timeToDestination < m_bestArrival)
+    {
+      m_bestArrival = m_earliestArrival[stop] + timeToDestination;
+      m_bestTarget = stop;
+    }
+  };
+
+  m_earliestArrival[stop] = time;
+  m_labels[stop] = label;
+  updateDestination(stop);
+
+  m_timetable.ForEachFootpath(stop, [&](Timetable::Footpath const & footpath) {
+    auto const arrival = time + footpath.m_timeSeconds;
+    if (arrival >= m_earliestArrival[footpath.m_stop])
+      return;
+
+    m_earliestArrival[footpath.m_stop] = arrival;
+    m_labels[footpath.m_stop] = Label();
+    m_labels[footpath.m_stop].m_footpathFrom = stop;
+    updateDestination(footpath.m_stop);
+  });
+}
+}  // namespace experimental
+}  // namespace transit
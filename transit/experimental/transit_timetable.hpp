@@ -0,0 +1,195 @@
+#pragma once
+
+#include "transit/experimental/transit_types_experimental.hpp"
+#include "transit/transit_entities.hpp"
+#include "transit/transit_schedule.hpp"
+
+#include "base/visitor.hpp"
+
+#include <cstdint>
+#include <ctime>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace routing
+{
+namespace transit
+{
+template <class Sink>
+class Serializer;
+template <class Source>
+class Deserializer;
+}  // namespace transit
+}  // namespace routing
+
+namespace transit
+{
+namespace experimental
+{
+// Timetable for departure time aware public transport routing. Every line is stored as a pattern:
+// a sequence of stop indexes with arrival time offsets from the trip start. Trips running on some
+// day are expanded from patterns and line schedules into a flat array of connections sorted by
+// departure time which is suitable for the Connection Scan Algorithm.
+class Timetable
+{
+public:
+  static uint32_t constexpr kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+  // Ride of a trip between two consecutive stops.
+  struct Connection
+  {
+    uint32_t m_departureStop = kInvalidIndex;
+    uint32_t m_arrivalStop = kInvalidIndex;
+    // Seconds since the service day start.
+    uint32_t m_departureTime = 0;
+    uint32_t m_arrivalTime = 0;
+    uint32_t m_trip = kInvalidIndex;
+  };
+
+  struct Footpath
+  {
+    Footpath() = default;
+    Footpath(uint32_t stop, uint32_t timeSeconds) : m_stop(stop), m_timeSeconds(timeSeconds) {}
+
+    bool operator==(Footpath const & rhs) const
+    {
+      return m_stop == rhs.m_stop && m_timeSeconds == rhs.m_timeSeconds;
+    }
+
+    DECLARE_VISITOR_AND_DEBUG_PRINT(Footpath, visitor(m_stop, "stop"),
+                                    visitor(m_timeSeconds, "time_seconds"))
+
+    uint32_t m_stop = kInvalidIndex;
+    uint32_t m_timeSeconds = 0;
+  };
+
+  // Trips and connections of a single service day.
+  struct Day
+  {
+    // Trip index to pattern index.
+    std::vector<uint32_t> m_tripPatterns;
+    std::vector<Connection> m_connections;
+  };
+
+  bool operator==(Timetable const & rhs) const;
+
+  // Makes patterns from |lines| and their non-transfer |edges|, transfer edges become footpaths.
+  // Lines with stops or edges missing in the data are skipped.
+  void Build(std::vector<Stop> const & stops, std::vector<Edge> const & edges,
+             std::vector<Line> const & lines);
+  void Clear();
+  bool IsEmpty() const { return m_lineIds.empty(); }
+
+  size_t GetStopsCount() const { return m_stopIds.size(); }
+  size_t GetPatternsCount() const { return m_lineIds.size(); }
+  // Returns kInvalidIndex if there is no stop with |stopId| in the timetable.
+  uint32_t GetStopIndex(TransitId stopId) const;
+  TransitId GetStopId(uint32_t stopIndex) const { return m_stopIds[stopIndex]; }
+  TransitId GetLineId(uint32_t pattern) const { return m_lineIds[pattern]; }
+
+  template <typename Fn>
+  void ForEachFootpath(uint32_t stopIndex, Fn && fn) const
+  {
+    for (uint32_t i = m_footpathStarts[stopIndex]; i < m_footpathStarts[stopIndex + 1]; ++i)
+      fn(m_footpaths[i]);
+  }
+
+  // Expands trips running on the day which contains |time|. |lines| must be sorted by id.
+  Day MakeDay(std::vector<Line> const & lines, time_t time) const;
+
+  // Returns seconds to wait at |stopId| for the next trip of |lineId| after |time| or std::nullopt
+  // if the line has no more trips from the stop this day.
+  std::optional<uint32_t> GetWaitingTime(TransitId lineId, Schedule const & schedule,
+                                         TransitId stopId, time_t time) const;
+
+private:
+  template <class Sink>
+  friend class routing::transit::Serializer;
+  template <class Source>
+  friend class routing::transit::Deserializer;
+
+  DECLARE_VISITOR_AND_DEBUG_PRINT(Timetable, visitor(m_stopIds, "stop_ids"),
+                                  visitor(m_lineIds, "line_ids"),
+                                  visitor(m_patternStarts, "pattern_starts"),
+                                  visitor(m_patternStops, "pattern_stops"),
+                                  visitor(m_arrivalOffsets, "arrival_offsets"),
+                                  visitor(m_footpathStarts, "footpath_starts"),
+                                  visitor(m_footpaths, "footpaths"))
+
+  // Sorted ids of stops, position of a stop id is the stop index.
+  std::vector<TransitId> m_stopIds;
+  // Pattern index to line id, sorted.
+  std::vector<TransitId> m_lineIds;
+  // Pattern index to the first position in |m_patternStops| and |m_arrivalOffsets|.
+  std::vector<uint32_t> m_patternStarts;
+  std::vector<uint32_t> m_patternStops;
+  // Seconds from the trip start to arrival at the stop.
+  std::vector<uint32_t> m_arrivalOffsets;
+  // Stop index to the first footpath from the stop in |m_footpaths|.
+  std::vector<uint32_t> m_footpathStarts;
+  std::vector<Footpath> m_footpaths;
+};
+
+// Connection Scan Algorithm over one day of a timetable. The instance keeps buffers between
+// queries, so it should not be shared between threads.
+class ConnectionScan
+{
+public:
+  struct StopTime
+  {
+    StopTime() = default;
+    StopTime(uint32_t stop, uint32_t time) : m_stop(stop), m_time(time) {}
+
+    uint32_t m_stop = Timetable::kInvalidIndex;
+    // Seconds since the service day start for sources and seconds to the destination for targets.
+    uint32_t m_time = 0;
+  };
+
+  struct Leg
+  {
+    uint32_t m_fromStop = Timetable::kInvalidIndex;
+    uint32_t m_toStop = Timetable::kInvalidIndex;
+    uint32_t m_departureTime = 0;
+    uint32_t m_arrivalTime = 0;
+    // kInvalidTransitId for walking between stops.
+    TransitId m_lineId = kInvalidTransitId;
+  };
+
+  struct Journey
+  {
+    // Time of arrival to the destination, i.e. including time from the last stop.
+    uint32_t m_arrivalTime = 0;
+    std::vector<Leg> m_legs;
+  };
+
+  ConnectionScan(Timetable const & timetable, Timetable::Day const & day);
+
+  std::optional<Journey> FindEarliestArrival(std::vector<StopTime> const & sources,
+                                             std::vector<StopTime> const & targets);
+
+private:
+  // How a stop was reached: by a trip boarded at |m_enter| and left at |m_exit| connection or by
+  // walking from |m_footpathFrom| stop.
+  struct Label
+  {
+    uint32_t m_enter = Timetable::kInvalidIndex;
+    uint32_t m_exit = Timetable::kInvalidIndex;
+    uint32_t m_footpathFrom = Timetable::kInvalidIndex;
+  };
+
+  void Reach(uint32_t stop, uint32_t time, Label const & label);
+
+  Timetable const & m_timetable;
+  Timetable::Day const & m_day;
+
+  std::vector<uint32_t> m_earliestArrival;
+  std::vector<Label> m_labels;
+  // Trip index to the connection it was boarded at.
+  std::vector<uint32_t> m_tripEnter;
+  std::vector<uint32_t> m_timeToDestination;
+  uint32_t m_bestArrival = 0;
+  uint32_t m_bestTarget = Timetable::kInvalidIndex;
+};
+}  // namespace experimental
+}  // namespace transit
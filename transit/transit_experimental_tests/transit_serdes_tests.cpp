@@ -37,6 +37,7 @@ void TestEqual(TransitData const & actualTransit, TransitData const & expectedTr
     TestEqual(actualTransit.GetShapes(), expectedTransit.GetShapes());
     TestEqual(actualTransit.GetRoutes(), expectedTransit.GetRoutes());
     TestEqual(actualTransit.GetNetworks(), expectedTransit.GetNetworks());
+    TEST_EQUAL(actualTransit.GetTimetable(), expectedTransit.GetTimetable(), ());
     break;
 
   case TransitUseCase::Routing:
@@ -48,6 +49,7 @@ void TestEqual(TransitData const & actualTransit, TransitData const & expectedTr
     TEST(actualTransit.GetShapes().empty(), ());
     TEST(actualTransit.GetRoutes().empty(), ());
     TEST(actualTransit.GetNetworks().empty(), ());
+    TEST_EQUAL(actualTransit.GetTimetable(), expectedTransit.GetTimetable(), ());
     break;
 
   case TransitUseCase::Rendering:
@@ -0,0 +1,191 @@
+#include "testing/testing.hpp"
+
+#include "transit/experimental/transit_timetable.hpp"
+#include "transit/transit_serdes.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+namespace transit
+{
+namespace experimental
+{
+namespace
+{
+// Line 10 goes 1 -> 2 -> 3 every 10 minutes, line 20 goes 4 -> 5 every 15 minutes all day.
+// Stop 3 is connected with stop 4 by a transfer.
+void FillTestNetwork(std::vector<Stop> & stops, std::vector<Edge> & edges, std::vector<Line> & lines)
+{
+  stops = {Stop(1), Stop(2), Stop(3), Stop(4), Stop(5)};
+
+  edges = {Edge(1 /* stop1Id */, 2 /* stop2Id */, 300 /* weight */, 10 /* lineId */,
+                false /* transfer */, ShapeLink()),
+           Edge(2 /* stop1Id */, 3 /* stop2Id */, 300 /* weight */, 10 /* lineId */,
+                false /* transfer */, ShapeLink()),
+           Edge(4 /* stop1Id */, 5 /* stop2Id */, 200 /* weight */, 20 /* lineId */,
+                false /* transfer */, ShapeLink()),
+           Edge(3 /* stop1Id */, 4 /* stop2Id */, 120 /* weight */, kInvalidTransitId /* lineId */,
+                true /* transfer */, ShapeLink())};
+
+  Schedule schedule10;
+  schedule10.SetDefaultFrequency(600);
+  Schedule schedule20;
+  schedule20.SetDefaultFrequency(900);
+
+  lines = {Line(10 /* id */, 1 /* routeId */, ShapeLink(), "" /* title */, IdList{1, 2, 3},
+                schedule10),
+           Line(20 /* id */, 1 /* routeId */, ShapeLink(), "" /* title */, IdList{4, 5},
+                schedule20)};
+}
+
+time_t MakeLocalTime(int hour, int minute, int second)
+{
+  std::tm tm = {};
+  tm.tm_year = 2021 - 1900;
+  tm.tm_mon = 3;
+  tm.tm_mday = 12;
+  tm.tm_hour = hour;
+  tm.tm_min = minute;
+  tm.tm_sec = second;
+  tm.tm_isdst = -1;
+  return std::mktime(&tm);
+}
+}  // namespace
+
+UNIT_TEST(Timetable_Build)
+{
+  std::vector<Stop> stops;
+  std::vector<Edge> edges;
+  std::vector<Line> lines;
+  FillTestNetwork(stops, edges, lines);
+
+  Timetable timetable;
+  timetable.Build(stops, edges, lines);
+
+  TEST_EQUAL(timetable.GetStopsCount(), 5, ());
+  TEST_EQUAL(timetable.GetPatternsCount(), 2, ());
+  TEST_EQUAL(timetable.GetLineId(0), 10, ());
+  TEST_EQUAL(timetable.GetStopIndex(3), 2, ());
+  TEST_EQUAL(timetable.GetStopIndex(6), Timetable::kInvalidIndex, ());
+
+  std::vector<Timetable::Footpath> footpaths;
+  timetable.ForEachFootpath(timetable.GetStopIndex(3), [&](Timetable::Footpath const & footpath) {
+    footpaths.push_back(footpath);
+  });
+  TEST_EQUAL(footpaths, std::vector<Timetable::Footpath>({{timetable.GetStopIndex(4), 120}}), ());
+
+  // The line with a missing edge is skipped.
+  lines.emplace_back(30 /* id */, 1 /* routeId */, ShapeLink(), "" /* title */, IdList{5, 1},
+                     Schedule());
+  timetable.Build(stops, edges, lines);
+  TEST_EQUAL(timetable.GetPatternsCount(), 2, ());
+
+  auto const day = timetable.MakeDay(lines, MakeLocalTime(12, 0, 0));
+  // 144 trips of line 10 with 2 connections and 96 trips of line 20 with 1 connection.
+  TEST_EQUAL(day.m_tripPatterns.size(), 144 + 96, ());
+  TEST_EQUAL(day.m_connections.size(), 144 * 2 + 96, ());
+  for (size_t i = 1; i < day.m_connections.size(); ++i)
+  {
+    TEST_LESS_OR_EQUAL(day.m_connections[i - 1].m_departureTime,
+                       day.m_connections[i].m_departureTime, ());
+  }
+}
+
+UNIT_TEST(Timetable_WaitingTime)
+{
+  std::vector<Stop> stops;
+  std::vector<Edge> edges;
+  std::vector<Line> lines;
+  FillTestNetwork(stops, edges, lines);
+
+  Timetable timetable;
+  timetable.Build(stops, edges, lines);
+
+  auto const & schedule10 = lines[0].GetSchedule();
+  auto const & schedule20 = lines[1].GetSchedule();
+  auto const time = MakeLocalTime(0, 16, 40);
+
+  // Trips of line 10 pass stop 2 at 00:05, 00:15, 00:25.
+  TEST(timetable.GetWaitingTime(10 /* lineId */, schedule10, 2 /* stopId */, time) == 500u, ());
+  TEST(timetable.GetWaitingTime(20 /* lineId */, schedule20, 4 /* stopId */, time) == 800u, ());
+  TEST(timetable.GetWaitingTime(20 /* lineId */, schedule20, 4 /* stopId */,
+                                MakeLocalTime(0, 30, 0)) == 0u,
+       ());
+
+  // No trips after the last one of the day and no trips of a line through another line stops.
+  TEST(!timetable.GetWaitingTime(20 /* lineId */, schedule20, 4 /* stopId */,
+                                 MakeLocalTime(23, 50, 0)),
+       ());
+  TEST(!timetable.GetWaitingTime(20 /* lineId */, schedule20, 1 /* stopId */, time), ());
+}
+
+UNIT_TEST(ConnectionScan_Transfer)
+{
+  std::vector<Stop> stops;
+  std::vector<Edge> edges;
+  std::vector<Line> lines;
+  FillTestNetwork(stops, edges, lines);
+
+  Timetable timetable;
+  timetable.Build(stops, edges, lines);
+  auto const day = timetable.MakeDay(lines, MakeLocalTime(12, 0, 0));
+
+  ConnectionScan scan(timetable, day);
+  auto const journey = scan.FindEarliestArrival({{timetable.GetStopIndex(1), 1000}},
+                                                {{timetable.GetStopIndex(5), 60}});
+  TEST(journey, ());
+  TEST_EQUAL(journey->m_arrivalTime, 2960, ());
+
+  auto const & legs = journey->m_legs;
+  TEST_EQUAL(legs.size(), 3, ());
+
+  TEST_EQUAL(legs[0].m_lineId, 10, ());
+  TEST_EQUAL(timetable.GetStopId(legs[0].m_fromStop), 1, ());
+  TEST_EQUAL(timetable.GetStopId(legs[0].m_toStop), 3, ());
+  TEST_EQUAL(legs[0].m_departureTime, 1200, ());
+  TEST_EQUAL(legs[0].m_arrivalTime, 1800, ());
+
+  TEST_EQUAL(legs[1].m_lineId, kInvalidTransitId, ());
+  TEST_EQUAL(timetable.GetStopId(legs[1].m_toStop), 4, ());
+  TEST_EQUAL(legs[1].m_arrivalTime, 1920, ());
+
+  TEST_EQUAL(legs[2].m_lineId, 20, ());
+  TEST_EQUAL(legs[2].m_departureTime, 2700, ());
+  TEST_EQUAL(legs[2].m_arrivalTime, 2900, ());
+
+  // There is no way back.
+  TEST(!scan.FindEarliestArrival({{timetable.GetStopIndex(5), 1000}},
+                                 {{timetable.GetStopIndex(1), 0}}),
+       ());
+}
+
+UNIT_TEST(Timetable_SerDes)
+{
+  std::vector<Stop> stops;
+  std::vector<Edge> edges;
+  std::vector<Line> lines;
+  FillTestNetwork(stops, edges, lines);
+
+  Timetable expected;
+  expected.Build(stops, edges, lines);
+
+  std::vector<uint8_t> buffer;
+  MemWriter<decltype(buffer)> writer(buffer);
+  routing::transit::Serializer<decltype(writer)> serializer(writer);
+  serializer(expected);
+
+  MemReader reader(buffer.data(), buffer.size());
+  ReaderSource<MemReader> src(reader);
+  routing::transit::Deserializer<ReaderSource<MemReader>> deserializer(src);
+  Timetable actual;
+  deserializer(actual);
+
+  TEST_EQUAL(actual, expected, ());
+  TEST_EQUAL(src.Size(), 0, ());
+}
+}  // namespace experimental
+}  // namespace transit
@@ -395,6 +395,28 @@ Frequency Schedule::GetFrequency(time_t const & time) const
   return m_defaultFrequency;
 }
 
+FrequencyIntervals const * Schedule::GetServiceDayFrequencies(time_t const & time) const
+{
+  auto const & [date, wdIndex] = GetDateAndWeekIndex(time);
+
+  for (auto const & [dateException, freqInts] : m_serviceExceptions)
+  {
+    Status const status = dateException.GetExceptionStatus(date);
+    if (status == Status::Open)
+      return &freqInts;
+    if (status == Status::Closed)
+      return nullptr;
+  }
+
+  for (auto const & [datesInterval, freqInts] : m_serviceIntervals)
+  {
+    if (datesInterval.GetStatusInInterval(date, wdIndex) == Status::Open)
+      return &freqInts;
+  }
+
+  return nullptr;
+}
+
 std::pair<Date, uint8_t> Schedule::GetDateAndWeekIndex(time_t const & time) const
 {
   std::tm const tm = ToCalendarTime(time);
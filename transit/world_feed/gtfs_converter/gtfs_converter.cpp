@@ -9,8 +9,17 @@
 #include "base/assert.hpp"
 #include "base/file_name_utils.hpp"
 #include "base/logging.hpp"
+#include "base/thread_pool_computational.hpp"
 #include "base/timer.hpp"
 
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include <gflags/gflags.h>
 
 DEFINE_string(
@@ -25,6 +34,7 @@ DEFINE_string(path_json, "", "Output directory for dumping json files");
 DEFINE_string(path_resources, "", "OMaps resources directory");
 DEFINE_string(start_feed, "", "Optional. Feed directory from which the process continues");
 DEFINE_string(stop_feed, "", "Optional. Feed directory on which to stop the process");
+DEFINE_uint64(threads_count, 0, "Optional. Number of threads for reading feeds, all cores by default");
 
 // Finds subdirectories with feeds.
 Platform::FilesList GetGtfsFeedsInDirectory(std::string const & path)
@@ -99,13 +109,14 @@ enum class FeedStatus
   NO_SHAPES
 };
 
-FeedStatus ReadFeed(gtfs::Feed & feed)
+// Feeds are read concurrently, so every message names the feed it is about.
+FeedStatus ReadFeed(std::string const & feedPath, gtfs::Feed & feed)
 {
   // First we read shapes. If there are no shapes in feed we do not need to read all the required
   // files - agencies, stops, etc.
   if (auto res = feed.read_shapes(); res != gtfs::ResultCode::OK)
   {
-    LOG(LWARNING, ("Could not get shapes.", res.message));
+    LOG(LWARNING, ("Could not get shapes.", feedPath, res.message));
     return FeedStatus::NO_SHAPES;
   }
 
@@ -115,56 +126,75 @@ FeedStatus ReadFeed(gtfs::Feed & feed)
   // We try to parse required for json files and return error in case of invalid file content.
   if (auto res = feed.read_agencies(); res != gtfs::ResultCode::OK)
   {
-    LOG(LWARNING, ("Could not parse agencies.", res.message));
+    LOG(LWARNING, ("Could not parse agencies.", feedPath, res.message));
     return FeedStatus::CORRUPTED;
   }
 
   if (auto res = feed.read_routes(); res != gtfs::ResultCode::OK)
   {
-    LOG(LWARNING, ("Could not parse routes.", res.message));
+    LOG(LWARNING, ("Could not parse routes.", feedPath, res.message));
     return FeedStatus::CORRUPTED;
   }
 
   if (auto res = feed.read_trips(); res != gtfs::ResultCode::OK)
   {
-    LOG(LWARNING, ("Could not parse trips.", res.message));
+    LOG(LWARNING, ("Could not parse trips.", feedPath, res.message));
     return FeedStatus::CORRUPTED;
   }
 
   if (auto res = feed.read_stops(); res != gtfs::ResultCode::OK)
   {
-    LOG(LWARNING, ("Could not parse stops.", res.message));
+    LOG(LWARNING, ("Could not parse stops.", feedPath, res.message));
     return FeedStatus::CORRUPTED;
   }
 
   if (auto res = feed.read_stop_times(); res != gtfs::ResultCode::OK)
   {
-    LOG(LWARNING, ("Could not parse stop times.", res.message));
+    LOG(LWARNING, ("Could not parse stop times.", feedPath, res.message));
     return FeedStatus::CORRUPTED;
   }
 
   // We try to parse optional for json files and do not return error in case of invalid file
   // content, only log warning message.
   if (auto res = feed.read_calendar(); gtfs::ErrorParsingOptionalFile(res))
-    LOG(LINFO, ("Could not parse calendar.", res.message));
+    LOG(LINFO, ("Could not parse calendar.", feedPath, res.message));
 
   if (auto res = feed.read_calendar_dates(); gtfs::ErrorParsingOptionalFile(res))
-    LOG(LINFO, ("Could not parse calendar dates.", res.message));
+    LOG(LINFO, ("Could not parse calendar dates.", feedPath, res.message));
 
   if (auto res = feed.read_frequencies(); gtfs::ErrorParsingOptionalFile(res))
-    LOG(LINFO, ("Could not parse frequencies.", res.message));
+    LOG(LINFO, ("Could not parse frequencies.", feedPath, res.message));
 
   if (auto res = feed.read_transfers(); gtfs::ErrorParsingOptionalFile(res))
-    LOG(LINFO, ("Could not parse transfers.", res.message));
+    LOG(LINFO, ("Could not parse transfers.", feedPath, res.message));
 
   if (feed.read_feed_info() == gtfs::ResultCode::OK)
-    LOG(LINFO, ("Feed info is present."));
+    LOG(LINFO, ("Feed info is present.", feedPath));
 
   return FeedStatus::OK;
 }
 
+struct ReadFeedResult
+{
+  std::string m_path;
+  gtfs::Feed m_feed;
+  FeedStatus m_status;
+  double m_readSeconds;
+};
+
+ReadFeedResult ReadFeedFromPath(std::string feedPath)
+{
+  base::Timer timer;
+  ExtendPath(feedPath);
+  gtfs::Feed feed(feedPath);
+  auto const status = ReadFeed(feedPath, feed);
+  return {std::move(feedPath), std::move(feed), status, timer.ElapsedSeconds()};
+}
+
 // Reads GTFS feeds from directories in |FLAGS_path_gtfs_feeds|. Converts each feed to the WorldFeed
 // object and saves to the |FLAGS_path_json| path in the new transit line-by-line json format.
+// Feeds are read concurrently while conversion and merging are made in the order of feeds, so ids
+// and output are the same as for reading in one thread.
 bool ConvertFeeds(transit::IdGenerator & generator, transit::IdGenerator & generatorEdges,
                   transit::ColorPicker & colorPicker,
                   feature::CountriesFilesAffiliation & mwmMatcher)
@@ -185,10 +215,11 @@ bool ConvertFeeds(transit::IdGenerator & generator, transit::IdGenerator & gener
   size_t feedsTotal = gtfsFeeds.size();
   bool pass = true;
 
+  // Indexes of feeds to convert.
+  std::vector<size_t> feedIndexes;
   for (size_t i = 0; i < gtfsFeeds.size(); ++i)
   {
-    base::Timer feedTimer;
-    auto feedPath = gtfsFeeds[i];
+    auto const & feedPath = gtfsFeeds[i];
 
     if (SkipFeed(feedPath, pass))
     {
@@ -197,48 +228,69 @@ bool ConvertFeeds(transit::IdGenerator & generator, transit::IdGenerator & gener
       continue;
     }
 
-    bool stop = StopOnFeed(feedPath);
-    if (stop)
+    feedIndexes.push_back(i);
+
+    if (StopOnFeed(feedPath))
+    {
       feedsTotal -= (gtfsFeeds.size() - i - 1);
+      break;
+    }
+  }
+
+  size_t const threadsCount = FLAGS_threads_count != 0
+                                  ? static_cast<size_t>(FLAGS_threads_count)
+                                  : std::max(std::thread::hardware_concurrency(), 1U);
+  // Parsed feeds are big, so only a few of them are read ahead.
+  size_t const maxFeedsReadAhead = 2 * threadsCount;
+  LOG(LINFO, ("Reading feeds in", threadsCount, "threads"));
 
-    ExtendPath(feedPath);
-    LOG(LINFO, ("Handling feed", feedPath));
+  base::Timer totalTimer;
+  double readSeconds = 0.0;
+  double convertSeconds = 0.0;
+
+  base::thread_pool::computational::ThreadPool threadPool(threadsCount);
+  std::deque<std::future<ReadFeedResult>> readingFeeds;
+  size_t nextFeed = 0;
+
+  for (size_t handled = 0; handled < feedIndexes.size(); ++handled)
+  {
+    for (; nextFeed < feedIndexes.size() && readingFeeds.size() < maxFeedsReadAhead; ++nextFeed)
+      readingFeeds.push_back(threadPool.Submit(ReadFeedFromPath, gtfsFeeds[feedIndexes[nextFeed]]));
 
-    gtfs::Feed feed(feedPath);
+    auto result = readingFeeds.front().get();
+    readingFeeds.pop_front();
+    readSeconds += result.m_readSeconds;
 
-    if (auto const res = ReadFeed(feed); res != FeedStatus::OK)
+    LOG(LINFO, ("Handling feed", result.m_path, "read time", result.m_readSeconds, "s"));
+
+    if (result.m_status != FeedStatus::OK)
     {
-      if (res == FeedStatus::NO_SHAPES)
+      if (result.m_status == FeedStatus::NO_SHAPES)
         feedsWithNoShapesCount++;
       else
-        invalidFeeds.push_back(feedPath);
-
-      if (stop)
-        break;
+        invalidFeeds.push_back(result.m_path);
       continue;
     }
 
+    base::Timer feedTimer;
     transit::WorldFeed globalFeed(generator, generatorEdges, colorPicker, mwmMatcher);
 
-    if (!globalFeed.SetFeed(std::move(feed)))
+    if (!globalFeed.SetFeed(std::move(result.m_feed)))
     {
       LOG(LINFO, ("Error transforming feed for json representation."));
       ++feedsNotDumpedCount;
-      if (stop)
-        break;
+      convertSeconds += feedTimer.ElapsedSeconds();
       continue;
     }
 
-    bool const saved = globalFeed.Save(FLAGS_path_json, i == 0 /* overwrite */);
+    bool const saved = globalFeed.Save(FLAGS_path_json, feedIndexes[handled] == 0 /* overwrite */);
     if (saved)
       ++feedsDumped;
     else
       ++feedsNotDumpedCount;
 
-    LOG(LINFO, ("Merged:", saved ? "yes" : "no", "time", feedTimer.ElapsedSeconds(), "s"));
-
-    if (stop)
-      break;
+    convertSeconds += feedTimer.ElapsedSeconds();
+    LOG(LINFO, ("Merged:", saved ? "yes" : "no", "convert time", feedTimer.ElapsedSeconds(), "s"));
   }
 
   LOG(LINFO, ("Corrupted feeds paths:", invalidFeeds));
@@ -246,6 +298,8 @@ bool ConvertFeeds(transit::IdGenerator & generator, transit::IdGenerator & gener
   LOG(LINFO, ("Feeds with no shapes:", feedsWithNoShapesCount, "/", feedsTotal));
   LOG(LINFO, ("Feeds parsed but not dumped:", feedsNotDumpedCount, "/", feedsTotal));
   LOG(LINFO, ("Total dumped feeds:", feedsDumped, "/", feedsTotal));
+  LOG(LINFO, ("Feeds handled in", totalTimer.ElapsedSeconds(), "s, reading:", readSeconds,
+              "s in all threads, converting:", convertSeconds, "s"));
 
   return true;
 }
@@ -0,0 +1,172 @@
+#include "transit/experimental/transit_data.hpp"
+#include "transit/experimental/transit_timetable.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/file_name_utils.hpp"
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+DEFINE_string(path_json, "", "Directory with transit jsons of a single region made by gtfs_converter");
+DEFINE_uint64(departure_time, 0, "Optional. Unix time of the day to route on, now by default");
+DEFINE_uint64(queries, 1000, "Number of random stop to stop queries");
+DEFINE_uint64(seed, 0, "Seed for random queries");
+
+using namespace transit::experimental;
+
+namespace
+{
+uint32_t constexpr kInfinity = std::numeric_limits<uint32_t>::max();
+
+// Static shortest path over rides and transfers without waiting, as the frequency-based
+// transit graph sees the network. Used as a baseline for query latency.
+class StaticGraph
+{
+public:
+  StaticGraph(Timetable const & timetable, std::vector<Edge> const & edges)
+    : m_adjacency(timetable.GetStopsCount())
+  {
+    for (auto const & edge : edges)
+    {
+      auto const from = timetable.GetStopIndex(edge.GetStop1Id());
+      auto const to = timetable.GetStopIndex(edge.GetStop2Id());
+      if (from != Timetable::kInvalidIndex && to != Timetable::kInvalidIndex)
+        m_adjacency[from].emplace_back(to, edge.GetWeight());
+    }
+  }
+
+  uint32_t FindShortestPath(uint32_t source, uint32_t target)
+  {
+    using Item = std::pair<uint32_t, uint32_t>;
+    m_distances.assign(m_adjacency.size(), kInfinity);
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    m_distances[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty())
+    {
+      auto const [distance, stop] = queue.top();
+      queue.pop();
+      if (stop == target)
+        return distance;
+      if (distance != m_distances[stop])
+        continue;
+
+      for (auto const & [to, weight] : m_adjacency[stop])
+      {
+        if (distance + weight < m_distances[to])
+        {
+          m_distances[to] = distance + weight;
+          queue.emplace(m_distances[to], to);
+        }
+      }
+    }
+    return kInfinity;
+  }
+
+private:
+  std::vector<std::vector<std::pair<uint32_t, uint32_t>>> m_adjacency;
+  std::vector<uint32_t> m_distances;
+};
+
+void LogLatencies(std::string const & name, std::vector<double> & latenciesMs)
+{
+  if (latenciesMs.empty())
+    return;
+
+  std::sort(latenciesMs.begin(), latenciesMs.end());
+  auto const percentile = [&latenciesMs](double p) {
+    return latenciesMs[static_cast<size_t>(p * (latenciesMs.size() - 1))];
+  };
+  LOG(LINFO, (name, "queries:", latenciesMs.size(), "p50:", percentile(0.5),
+              "ms, p90:", percentile(0.9), "ms, p99:", percentile(0.99),
+              "ms, max:", latenciesMs.back(), "ms"));
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  gflags::SetUsageMessage("Benchmarks timetable based public transport routing on gtfs_converter output.");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  auto const toolName = base::FileNameFromFullPath(argv[0]);
+
+  if (FLAGS_path_json.empty() || !Platform::IsDirectory(FLAGS_path_json))
+  {
+    LOG(LWARNING, ("Directory with transit jsons must be specified."));
+    gflags::ShowUsageWithFlagsRestrict(argv[0], toolName.c_str());
+    return EXIT_FAILURE;
+  }
+
+  TransitData data;
+  data.DeserializeFromJson(FLAGS_path_json, {} /* mapping */);
+  if (data.IsEmpty())
+  {
+    LOG(LWARNING, ("No transit data in", FLAGS_path_json));
+    return EXIT_FAILURE;
+  }
+  data.Sort();
+
+  base::Timer timer;
+  std::vector<uint8_t> buffer;
+  MemWriter<decltype(buffer)> writer(buffer);
+  data.Serialize(writer);
+  auto const & timetable = data.GetTimetable();
+  LOG(LINFO, ("Section with timetable serialized in", timer.ElapsedSeconds(), "seconds, size:",
+              buffer.size(), "bytes, stops:", timetable.GetStopsCount(),
+              "patterns:", timetable.GetPatternsCount(), "of lines:", data.GetLines().size()));
+
+  time_t const departureTime =
+      FLAGS_departure_time == 0 ? std::time(nullptr) : static_cast<time_t>(FLAGS_departure_time);
+  timer.Reset();
+  auto const day = timetable.MakeDay(data.GetLines(), departureTime);
+  LOG(LINFO, ("Day expanded in", timer.ElapsedSeconds(), "seconds, trips:",
+              day.m_tripPatterns.size(), "connections:", day.m_connections.size()));
+
+  if (timetable.GetStopsCount() < 2)
+    return EXIT_SUCCESS;
+
+  std::mt19937 rng(static_cast<std::mt19937::result_type>(FLAGS_seed));
+  std::uniform_int_distribution<uint32_t> stopDistribution(
+      0, static_cast<uint32_t>(timetable.GetStopsCount() - 1));
+  std::uniform_int_distribution<uint32_t> timeDistribution(6 * 60 * 60, 20 * 60 * 60);
+
+  ConnectionScan scan(timetable, day);
+  StaticGraph graph(timetable, data.GetEdges());
+  std::vector<double> scanLatencies;
+  std::vector<double> staticLatencies;
+  size_t found = 0;
+  for (uint64_t i = 0; i < FLAGS_queries; ++i)
+  {
+    auto const source = stopDistribution(rng);
+    auto const target = stopDistribution(rng);
+    auto const startTime = timeDistribution(rng);
+
+    timer.Reset();
+    if (scan.FindEarliestArrival({{source, startTime}}, {{target, 0 /* time */}}))
+      ++found;
+    scanLatencies.push_back(timer.ElapsedSeconds() * 1000.0);
+
+    timer.Reset();
+    graph.FindShortestPath(source, target);
+    staticLatencies.push_back(timer.ElapsedSeconds() * 1000.0);
+  }
+
+  LOG(LINFO, ("Journeys found:", found, "of", FLAGS_queries));
+  LogLatencies("Connection scan", scanLatencies);
+  LogLatencies("Static Dijkstra", staticLatencies);
+  return EXIT_SUCCESS;
+}